@@ -1,3 +1,3 @@
 SOURCES = pcre.cpp
 CONFIG -= qt dylib
-LIBS += -lpcre16
+LIBS += -lpcre16 -lpcre
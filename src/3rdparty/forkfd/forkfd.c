@@ -43,7 +43,9 @@
 #include <unistd.h>
 
 #ifdef __linux__
+#  include <sched.h>
 #  define HAVE_WAIT4    1
+#  define HAVE_CLONE_VFORK  1
 #  if defined(__BIONIC__) || (defined(__GLIBC__) && (__GLIBC__ << 8) + __GLIBC_MINOR__ >= 0x207 && \
        (!defined(__UCLIBC__) || ((__UCLIBC_MAJOR__ << 16) + (__UCLIBC_MINOR__ << 8) + __UCLIBC_SUBLEVEL__ > 0x90201)))
 #    include <sys/eventfd.h>
@@ -722,6 +724,146 @@ err_free:
     freeInfo(header, info);
     return -1;
 }
+
+#ifdef HAVE_CLONE_VFORK
+#  define VFORKFD_CHILD_STACK_SIZE  32768
+
+struct vforkfd_child_data
+{
+    int (*childFn)(void *);
+    void *token;
+    sigset_t *oldmask;
+};
+
+static int vforkfd_child(void *arg)
+{
+    struct vforkfd_child_data *data = (struct vforkfd_child_data *)arg;
+    struct sigaction action;
+    int sig;
+
+    /*
+     * We share the parent's memory until we exec, so we must not run any of
+     * its signal handlers. Every signal is blocked right now; reset the
+     * caught ones to their default action (exec would have done that
+     * anyway) before we restore the original mask.
+     */
+    for (sig = 1; sig < NSIG; ++sig) {
+        if (sigaction(sig, NULL, &action) == -1)
+            continue;
+        if (action.sa_handler == SIG_IGN || action.sa_handler == SIG_DFL)
+            continue;
+        action.sa_handler = SIG_DFL;
+        action.sa_flags = 0;
+        sigaction(sig, &action, NULL);
+    }
+    pthread_sigmask(SIG_SETMASK, data->oldmask, NULL);
+
+    return data->childFn(data->token);
+}
+#endif
+
+/**
+ * @brief vforkfd is like forkfd, but runs a function in the child instead of
+ * returning to the caller
+ * @return a file descriptor, or -1 in case of failure
+ *
+ * vforkfd() starts a child process that runs @a childFn with @a token as its
+ * argument, then exits with the value returned by that function. It is meant
+ * for callers that exec(2) a new program from @a childFn.
+ *
+ * On Linux, the child is created with clone(2) using CLONE_VM and
+ * CLONE_VFORK: it runs on a separate stack in the parent's address space,
+ * so the cost of starting it does not depend on the amount of memory the
+ * parent has mapped, and the calling thread is suspended until the child
+ * has called exec(2) or exited. Therefore, @a childFn must not modify any
+ * memory that the parent uses and must only call async-signal-safe
+ * functions. On other systems, vforkfd() falls back to forkfd().
+ *
+ * The @a flags parameter and the returned file descriptor behave exactly as
+ * for forkfd().
+ */
+int vforkfd(int flags, pid_t *ppid, int (*childFn)(void *), void *token)
+{
+#ifdef HAVE_CLONE_VFORK
+    Header *header;
+    ProcessInfo *info;
+    struct pipe_payload payload;
+    struct vforkfd_child_data data;
+    sigset_t allsignals, oldmask;
+    pid_t pid;
+    int death_pipe[2];
+    int ret;
+    int saved_errno;
+    __attribute__((aligned(16))) char childStack[VFORKFD_CHILD_STACK_SIZE];
+
+    if (system_has_forkfd)
+        goto fallback;
+
+    (void) pthread_once(&forkfd_initialization, forkfd_initialize);
+
+    info = allocateInfo(&header);
+    if (info == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    /* create the pipe before we clone */
+    if (create_pipe(death_pipe, flags) == -1)
+        goto err_free; /* failed to create the pipes, pass errno */
+
+    data.childFn = childFn;
+    data.token = token;
+    data.oldmask = &oldmask;
+
+    /* no signal handler may run in the child before it has reset them */
+    sigfillset(&allsignals);
+    pthread_sigmask(SIG_SETMASK, &allsignals, &oldmask);
+
+    /* the stack grows down on every architecture Qt supports on Linux */
+    pid = clone(vforkfd_child, childStack + sizeof(childStack),
+                CLONE_VM | CLONE_VFORK | SIGCHLD, &data);
+    saved_errno = errno;
+    pthread_sigmask(SIG_SETMASK, &oldmask, NULL);
+
+    if (pid == -1) {
+        errno = saved_errno;
+        goto err_close; /* failed to clone, pass errno */
+    }
+    if (ppid)
+        *ppid = pid;
+
+    /*
+     * The child has already exec'ed or exited by now and the SIGCHLD handler
+     * may have missed it because it did not know the PID yet, so store it
+     * and check whether the child is already gone, like spawnfd() does.
+     */
+    info->deathPipe = death_pipe[1];
+    ffd_atomic_store(&info->pid, pid, FFD_ATOMIC_RELEASE);
+
+    if (tryReaping(pid, &payload))
+        notifyAndFreeInfo(header, info, &payload);
+
+    return death_pipe[0];
+
+err_close:
+    saved_errno = errno;
+    EINTR_LOOP(ret, close(death_pipe[0]));
+    EINTR_LOOP(ret, close(death_pipe[1]));
+    errno = saved_errno;
+err_free:
+    /* free the info pointer */
+    freeInfo(header, info);
+    return -1;
+
+fallback:
+#endif // HAVE_CLONE_VFORK
+    {
+        int fd = forkfd(flags, ppid);
+        if (fd == FFD_CHILD_PROCESS)
+            _exit(childFn(token));
+        return fd;
+    }
+}
 #endif // FORKFD_NO_FORKFD
 
 #if _POSIX_SPAWN > 0 && !defined(FORKFD_NO_SPAWNFD)
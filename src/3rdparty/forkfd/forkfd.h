@@ -48,6 +48,7 @@ struct forkfd_info {
 };
 
 int forkfd(int flags, pid_t *ppid);
+int vforkfd(int flags, pid_t *ppid, int (*childFn)(void *), void *token);
 int forkfd_wait(int ffd, forkfd_info *info, struct rusage *rusage);
 int forkfd_close(int ffd);
 
@@ -13,6 +13,8 @@ DEFINES += HAVE_CONFIG_H
 win32: DEFINES += PCRE_STATIC
 ios|qnx|winrt: DEFINES += PCRE_DISABLE_JIT
 
+# the 16-bit library matches QString subjects, the 8-bit one UTF-8 and
+# Latin-1 subjects; see pcre8_*.c for why those wrap pcre_*.c
 SOURCES += \
     $$PWD/pcre16_byte_order.c \
     $$PWD/pcre16_chartables.c \
@@ -35,7 +37,27 @@ SOURCES += \
     $$PWD/pcre16_utf16_utils.c \
     $$PWD/pcre16_valid_utf16.c \
     $$PWD/pcre16_version.c \
-    $$PWD/pcre16_xclass.c
+    $$PWD/pcre16_xclass.c \
+    $$PWD/pcre8_byte_order.c \
+    $$PWD/pcre8_chartables.c \
+    $$PWD/pcre8_compile.c \
+    $$PWD/pcre8_config.c \
+    $$PWD/pcre8_dfa_exec.c \
+    $$PWD/pcre8_exec.c \
+    $$PWD/pcre8_fullinfo.c \
+    $$PWD/pcre8_get.c \
+    $$PWD/pcre8_globals.c \
+    $$PWD/pcre8_jit_compile.c \
+    $$PWD/pcre8_maketables.c \
+    $$PWD/pcre8_newline.c \
+    $$PWD/pcre_ord2utf8.c \
+    $$PWD/pcre8_refcount.c \
+    $$PWD/pcre8_study.c \
+    $$PWD/pcre8_tables.c \
+    $$PWD/pcre8_ucd.c \
+    $$PWD/pcre_valid_utf8.c \
+    $$PWD/pcre8_version.c \
+    $$PWD/pcre8_xclass.c
 
 HEADERS += \
     $$PWD/config.h \
@@ -3,5 +3,5 @@ pcre {
     INCLUDEPATH += $$PWD/pcre
     LIBS_PRIVATE += -L$$QT_BUILD_TREE/lib -lqtpcre$$qtPlatformTargetSuffix()
 } else {
-    LIBS_PRIVATE += -lpcre16
+    LIBS_PRIVATE += -lpcre16 -lpcre
 }
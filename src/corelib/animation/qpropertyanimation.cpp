@@ -90,6 +90,7 @@
 #include "qpropertyanimation.h"
 #include "qanimationgroup.h"
 #include "qpropertyanimation_p.h"
+#include "private/qmetaobject_p.h"
 
 #include <QtCore/QMutex>
 
@@ -99,6 +100,8 @@ QT_BEGIN_NAMESPACE
 
 void QPropertyAnimationPrivate::updateMetaProperty()
 {
+    staticMetaCall = 0;
+    staticPropertyIndex = -1;
     if (!target || propertyName.isEmpty()) {
         propertyType = QVariant::Invalid;
         propertyIndex = -1;
@@ -117,8 +120,18 @@ void QPropertyAnimationPrivate::updateMetaProperty()
         propertyType = QVariant::Invalid;
         if (!targetValue->dynamicPropertyNames().contains(propertyName))
             qWarning("QPropertyAnimation: you're trying to animate a non-existing property %s of your QObject", propertyName.constData());
-    } else if (!targetValue->metaObject()->property(propertyIndex).isWritable()) {
-        qWarning("QPropertyAnimation: you're trying to animate the non-writable property %s of your QObject", propertyName.constData());
+    } else {
+        const QMetaProperty property = targetValue->metaObject()->property(propertyIndex);
+        if (!property.isWritable()) {
+            qWarning("QPropertyAnimation: you're trying to animate the non-writable property %s of your QObject", propertyName.constData());
+        } else if (!QObjectPrivate::get(targetValue)->metaObject) {
+            const QMetaObject *mo = property.enclosingMetaObject();
+            if (mo->d.static_metacall
+                && (QMetaObjectPrivate::get(mo)->flags & PropertyAccessInStaticMetaCall)) {
+                staticMetaCall = mo->d.static_metacall;
+                staticPropertyIndex = propertyIndex - mo->propertyOffset();
+            }
+        }
     }
 }
 
@@ -138,7 +151,11 @@ void QPropertyAnimationPrivate::updateProperty(const QVariant &newValue)
         int status = -1;
         int flags = 0;
         void *argv[] = { const_cast<void *>(newValue.constData()), const_cast<QVariant *>(&newValue), &status, &flags };
-        QMetaObject::metacall(targetValue, QMetaObject::WriteProperty, propertyIndex, argv);
+        //a dynamic meta-object installed after the animation started takes precedence
+        if (staticMetaCall && !QObjectPrivate::get(targetValue)->metaObject)
+            staticMetaCall(targetValue, QMetaObject::WriteProperty, staticPropertyIndex, argv);
+        else
+            QMetaObject::metacall(targetValue, QMetaObject::WriteProperty, propertyIndex, argv);
     } else {
         targetValue->setProperty(propertyName.constData(), newValue);
     }
@@ -64,7 +64,8 @@ class QPropertyAnimationPrivate : public QVariantAnimationPrivate
    Q_DECLARE_PUBLIC(QPropertyAnimation)
 public:
     QPropertyAnimationPrivate()
-        : targetValue(0), propertyType(0), propertyIndex(-1)
+        : targetValue(0), propertyType(0), propertyIndex(-1),
+          staticMetaCall(0), staticPropertyIndex(-1)
     {
     }
 
@@ -75,6 +76,10 @@ public:
     //for the QProperty
     int propertyType;
     int propertyIndex;
+    //when the class declaring the property handles it in its static
+    //metacall, writes go there directly instead of up the qt_metacall chain
+    QObjectPrivate::StaticMetaCallFunction staticMetaCall;
+    int staticPropertyIndex;
 
     QByteArray propertyName;
     void updateProperty(const QVariant &);
@@ -340,4 +340,34 @@ while (i.hasNext()) {
 //! [30]
 }
 
+{
+//! [31]
+QRegularExpressionSet set(QStringList() << "^ERROR\\b" << "timeout after \\d+ms" << "disk (full|quota)");
+for (const QString &line : lines) {
+    switch (set.firstMatchingIndex(line)) {
+    case 0:  // an error
+    case 1:  // a timeout
+    // ...
+    default: // nothing interesting
+        break;
+    }
+}
+//! [31]
+}
+
+{
+//! [32]
+QRegularExpression re("^(\\d+-\\d+-\\d+) (\\w+): (.*)$");
+while (!file.atEnd()) {
+    const QByteArray line = file.readLine();
+    QRegularExpressionMatch match = re.matchUtf8(line);
+    if (match.hasMatch()) {
+        QByteArray date = match.capturedBytes(1); // "2016-10-01"
+        QString message = match.captured(3);      // decoded from UTF-8
+        // ...
+    }
+}
+//! [32]
+}
+
 }
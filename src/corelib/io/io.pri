@@ -38,6 +38,7 @@ HEADERS +=  \
         io/qurl.h \
         io/qurl_p.h \
         io/qurlquery.h \
+        io/qurlview.h \
         io/qurltlds_p.h \
         io/qtldurl_p.h \
         io/qsettings.h \
@@ -85,7 +86,9 @@ SOURCES += \
         io/qurlidna.cpp \
         io/qurlquery.cpp \
         io/qurlrecode.cpp \
+        io/qurlview.cpp \
         io/qsettings.cpp \
+        io/qsettings_indexed.cpp \
         io/qfsfileengine.cpp \
         io/qfsfileengine_iterator.cpp \
         io/qfilesystemwatcher.cpp \
@@ -45,10 +45,13 @@
 #include <qdatetime.h>
 #include <qdebug.h>
 #include <qdir.h>
+#include <qdiriterator.h>
 #include <qfileinfo.h>
 #include <qset.h>
 #include <qtimer.h>
 
+#include <algorithm>
+
 #if defined(Q_OS_LINUX) || (defined(Q_OS_QNX) && !defined(QT_NO_INOTIFY))
 #define USE_INOTIFY
 #endif
@@ -85,24 +88,20 @@ QFileSystemWatcherEngine *QFileSystemWatcherPrivate::createNativeEngine(QObject
 }
 
 QFileSystemWatcherPrivate::QFileSystemWatcherPrivate()
-    : native(0), poller(0)
+    : native(0), poller(0), coalescingInterval(0)
 {
 }
 
 void QFileSystemWatcherPrivate::init()
 {
     Q_Q(QFileSystemWatcher);
+    qRegisterMetaType<QFileSystemWatcher::ChangeTypes>();
     native = createNativeEngine(q);
-    if (native) {
-        QObject::connect(native,
-                         SIGNAL(fileChanged(QString,bool)),
-                         q,
-                         SLOT(_q_fileChanged(QString,bool)));
-        QObject::connect(native,
-                         SIGNAL(directoryChanged(QString,bool)),
-                         q,
-                         SLOT(_q_directoryChanged(QString,bool)));
-    }
+    if (native)
+        connectEngine(native);
+
+    coalescingTimer.setSingleShot(true);
+    QObject::connect(&coalescingTimer, SIGNAL(timeout()), q, SLOT(_q_flushPendingChanges()));
 }
 
 void QFileSystemWatcherPrivate::initPollerEngine()
@@ -112,41 +111,241 @@ void QFileSystemWatcherPrivate::initPollerEngine()
 
     Q_Q(QFileSystemWatcher);
     poller = new QPollingFileSystemWatcherEngine(q); // that was a mouthful
-    QObject::connect(poller,
+    connectEngine(poller);
+}
+
+void QFileSystemWatcherPrivate::connectEngine(QFileSystemWatcherEngine *engine)
+{
+    Q_Q(QFileSystemWatcher);
+    QObject::connect(engine,
                      SIGNAL(fileChanged(QString,bool)),
                      q,
                      SLOT(_q_fileChanged(QString,bool)));
-    QObject::connect(poller,
+    QObject::connect(engine,
                      SIGNAL(directoryChanged(QString,bool)),
                      q,
                      SLOT(_q_directoryChanged(QString,bool)));
+    QObject::connect(engine,
+                     SIGNAL(pathChanged(QString,bool,QFileSystemWatcher::ChangeTypes)),
+                     q,
+                     SLOT(_q_pathChanged(QString,bool,QFileSystemWatcher::ChangeTypes)));
 }
 
-void QFileSystemWatcherPrivate::_q_fileChanged(const QString &path, bool removed)
+QFileSystemWatcherEngine *QFileSystemWatcherPrivate::engineForPaths()
 {
     Q_Q(QFileSystemWatcher);
-    if (!files.contains(path)) {
-        // the path was removed after a change was detected, but before we delivered the signal
-        return;
+    const QString on = q->objectName();
+
+    if (!on.startsWith(QLatin1String("_qt_autotest_force_engine_"))) {
+        // Normal runtime case - search intelligently for best engine
+        if (native)
+            return native;
+        initPollerEngine();
+        return poller;
     }
-    if (removed)
-        files.removeAll(path);
-    emit q->fileChanged(path, QFileSystemWatcher::QPrivateSignal());
+
+    // Autotest override case - use the explicitly selected engine only
+    const QStringRef forceName = on.midRef(26);
+    if (forceName == QLatin1String("poller")) {
+        qDebug() << "QFileSystemWatcher: skipping native engine, using only polling engine";
+        initPollerEngine();
+        return poller;
+    } else if (forceName == QLatin1String("native")) {
+        qDebug() << "QFileSystemWatcher: skipping polling engine, using only native engine";
+        return native;
+    }
+    return 0;
+}
+
+/*
+    The engines append what they watch to the lists; keep the sets in step.
+*/
+QStringList QFileSystemWatcherPrivate::addPathsToEngine(QFileSystemWatcherEngine *engine,
+                                                        const QStringList &paths)
+{
+    purgeRemovedPaths();
+    const int fileCount = files.size();
+    const int directoryCount = directories.size();
+    const QStringList notWatched = engine->addPaths(paths, &files, &directories);
+    for (int i = fileCount; i < files.size(); ++i)
+        watchedFiles.insert(files.at(i));
+    for (int i = directoryCount; i < directories.size(); ++i)
+        watchedDirectories.insert(directories.at(i));
+    return notWatched;
+}
+
+QStringList QFileSystemWatcherPrivate::removePathsFromEngine(QFileSystemWatcherEngine *engine,
+                                                             const QStringList &paths)
+{
+    purgeRemovedPaths();
+    const QStringList notRemoved = engine->removePaths(paths, &files, &directories);
+    if (notRemoved.size() == paths.size())
+        return notRemoved;
+    const QSet<QString> failed = notRemoved.toSet();
+    for (const QString &path : paths) {
+        if (!failed.contains(path)) {
+            watchedFiles.remove(path);
+            watchedDirectories.remove(path);
+        }
+    }
+    return notRemoved;
+}
+
+static void removeAllOf(QStringList *list, QSet<QString> *paths)
+{
+    if (paths->isEmpty())
+        return;
+    list->erase(std::remove_if(list->begin(), list->end(),
+                               [paths](const QString &path) { return paths->contains(path); }),
+                list->end());
+    paths->clear();
+}
+
+void QFileSystemWatcherPrivate::purgeRemovedPaths()
+{
+    removeAllOf(&files, &removedFiles);
+    removeAllOf(&directories, &removedDirectories);
+}
+
+void QFileSystemWatcherPrivate::_q_fileChanged(const QString &path, bool removed)
+{
+    queueChange(path, false, removed ? QFileSystemWatcher::Removed
+                                     : QFileSystemWatcher::ContentModified, false);
 }
 
 void QFileSystemWatcherPrivate::_q_directoryChanged(const QString &path, bool removed)
+{
+    // these engines don't say what changed, so an entry may have been added
+    queueChange(path, true, removed ? QFileSystemWatcher::Removed
+                                    : QFileSystemWatcher::ContentModified, !removed);
+}
+
+void QFileSystemWatcherPrivate::_q_pathChanged(const QString &path, bool isDirectory,
+                                               QFileSystemWatcher::ChangeTypes changes)
+{
+    queueChange(path, isDirectory, changes, changes & QFileSystemWatcher::EntryAdded);
+}
+
+void QFileSystemWatcherPrivate::queueChange(const QString &path, bool isDirectory,
+                                            QFileSystemWatcher::ChangeTypes changes, bool rescan)
+{
+    if (coalescingInterval <= 0) {
+        deliverChange(path, isDirectory, changes, rescan);
+        return;
+    }
+
+    QHash<QString, PendingChange>::iterator it = pendingChanges.find(path);
+    if (it == pendingChanges.end()) {
+        PendingChange change = { isDirectory, rescan, changes };
+        pendingChanges.insert(path, change);
+        pendingOrder.append(path);
+    } else {
+        it->changes |= changes;
+        it->rescan |= rescan;
+    }
+    if (!coalescingTimer.isActive())
+        coalescingTimer.start(coalescingInterval);
+}
+
+void QFileSystemWatcherPrivate::_q_flushPendingChanges()
+{
+    coalescingTimer.stop();
+
+    // a slot connected to one of our signals may add more changes
+    QHash<QString, PendingChange> changes;
+    QStringList order;
+    changes.swap(pendingChanges);
+    order.swap(pendingOrder);
+
+    for (const QString &path : qAsConst(order)) {
+        const PendingChange change = changes.value(path);
+        deliverChange(path, change.isDirectory, change.changes, change.rescan);
+    }
+}
+
+void QFileSystemWatcherPrivate::deliverChange(const QString &path, bool isDirectory,
+                                              QFileSystemWatcher::ChangeTypes changes, bool rescan)
 {
     Q_Q(QFileSystemWatcher);
-    if (!directories.contains(path)) {
-        // perhaps the path was removed after a change was detected, but before we delivered the signal
+    QSet<QString> &watched = isDirectory ? watchedDirectories : watchedFiles;
+    if (!watched.contains(path)) {
+        // the path was removed after a change was detected, but before we delivered the signal
         return;
     }
-    if (removed)
-        directories.removeAll(path);
-    emit q->directoryChanged(path, QFileSystemWatcher::QPrivateSignal());
+
+    if (changes & QFileSystemWatcher::Removed) {
+        watched.remove(path);
+        (isDirectory ? removedDirectories : removedFiles).insert(path);
+        if (isDirectory) {
+            recursiveRoots.remove(path);
+            recursiveDirectories.remove(path);
+        }
+    } else if (rescan && isDirectory && recursiveDirectories.contains(path)) {
+        addNewSubdirectories(path);
+    }
+
+    if (isDirectory)
+        emit q->directoryChanged(path, QFileSystemWatcher::QPrivateSignal());
+    else
+        emit q->fileChanged(path, QFileSystemWatcher::QPrivateSignal());
+    emit q->pathChanged(path, changes, QFileSystemWatcher::QPrivateSignal());
 }
 
+/*
+    Watches every directory in the trees rooted at \a roots that is not
+    watched yet, and returns the roots that could not be watched.
+*/
+QStringList QFileSystemWatcherPrivate::addDirectoryTrees(const QStringList &roots)
+{
+    QFileSystemWatcherEngine *engine = engineForPaths();
+    if (!engine)
+        return roots;
+
+    QStringList tree;
+    for (const QString &root : roots) {
+        if (!watchedDirectories.contains(root))
+            tree.append(root);
+        QDirIterator it(root, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks,
+                        QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            const QString dir = it.next();
+            if (!watchedDirectories.contains(dir))
+                tree.append(dir);
+        }
+    }
+
+    // one call into the engine for the whole set of trees
+    const QStringList notWatched = tree.isEmpty()
+            ? QStringList()
+            : addPathsToEngine(engine, tree);
+    const QSet<QString> failed = notWatched.toSet();
 
+    QStringList failedRoots;
+    for (const QString &dir : qAsConst(tree)) {
+        if (!failed.contains(dir))
+            recursiveDirectories.insert(dir);
+    }
+    for (const QString &root : roots) {
+        if (failed.contains(root))
+            failedRoots.append(root);
+        else
+            recursiveDirectories.insert(root);
+    }
+    return failedRoots;
+}
+
+void QFileSystemWatcherPrivate::addNewSubdirectories(const QString &directory)
+{
+    QStringList newDirectories;
+    QDirIterator it(directory, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+    while (it.hasNext()) {
+        const QString dir = it.next();
+        if (!recursiveDirectories.contains(dir))
+            newDirectories.append(dir);
+    }
+    if (!newDirectories.isEmpty())
+        addDirectoryTrees(newDirectories);
+}
 
 /*!
     \class QFileSystemWatcher
@@ -300,34 +499,10 @@ QStringList QFileSystemWatcher::addPaths(const QStringList &paths)
         return QStringList();
     }
 
-    QFileSystemWatcherEngine *engine = 0;
-
-    const QString on = objectName();
-
-    if (!on.startsWith(QLatin1String("_qt_autotest_force_engine_"))) {
-        // Normal runtime case - search intelligently for best engine
-        if(d->native) {
-            engine = d->native;
-        } else {
-            d_func()->initPollerEngine();
-            engine = d->poller;
-        }
-
-    } else {
-        // Autotest override case - use the explicitly selected engine only
-        const QStringRef forceName = on.midRef(26);
-        if(forceName == QLatin1String("poller")) {
-            qDebug() << "QFileSystemWatcher: skipping native engine, using only polling engine";
-            d_func()->initPollerEngine();
-            engine = d->poller;
-        } else if(forceName == QLatin1String("native")) {
-            qDebug() << "QFileSystemWatcher: skipping polling engine, using only native engine";
-            engine = d->native;
-        }
-    }
+    QFileSystemWatcherEngine *engine = d->engineForPaths();
 
     if(engine)
-        p = engine->addPaths(p, &d->files, &d->directories);
+        p = d->addPathsToEngine(engine, p);
 
     return p;
 }
@@ -382,14 +557,153 @@ QStringList QFileSystemWatcher::removePaths(const QStringList &paths)
         return QStringList();
     }
 
+    if (!d->recursiveDirectories.isEmpty()) {
+        // removing the root of a recursive watch also drops everything
+        // that was watched below it on its behalf
+        QStringList subdirectories;
+        for (const QString &path : qAsConst(p)) {
+            if (!d->recursiveRoots.remove(path))
+                continue;
+            const QString prefix = path + QLatin1Char('/');
+            QSet<QString>::iterator dir = d->recursiveDirectories.begin();
+            while (dir != d->recursiveDirectories.end()) {
+                if (dir->startsWith(prefix) && !d->recursiveRoots.contains(*dir)) {
+                    subdirectories.append(*dir);
+                    dir = d->recursiveDirectories.erase(dir);
+                } else {
+                    ++dir;
+                }
+            }
+        }
+        for (const QString &path : qAsConst(p))
+            d->recursiveDirectories.remove(path);
+
+        if (!subdirectories.isEmpty()) {
+            if (d->native)
+                subdirectories = d->removePathsFromEngine(d->native, subdirectories);
+            if (d->poller)
+                d->removePathsFromEngine(d->poller, subdirectories);
+        }
+    }
+
     if (d->native)
-        p = d->native->removePaths(p, &d->files, &d->directories);
+        p = d->removePathsFromEngine(d->native, p);
     if (d->poller)
-        p = d->poller->removePaths(p, &d->files, &d->directories);
+        p = d->removePathsFromEngine(d->poller, p);
 
     return p;
 }
 
+/*!
+    \since 5.8
+
+    Adds the directory \a directory and every directory below it to the
+    file system watcher. Directories that are created inside the tree
+    later on are watched as well, as soon as the directoryChanged() signal
+    for their parent is delivered.
+
+    Returns \c true if \a directory is being watched afterwards.
+
+    \sa addPathsRecursively(), addPath(), removePath()
+*/
+bool QFileSystemWatcher::addPathRecursively(const QString &directory)
+{
+    if (directory.isEmpty()) {
+        qWarning("QFileSystemWatcher::addPathRecursively: path is empty");
+        return true;
+    }
+
+    QStringList paths = addPathsRecursively(QStringList(directory));
+    return paths.isEmpty();
+}
+
+/*!
+    \since 5.8
+
+    Adds each directory in \a directories, and every directory below it,
+    to the file system watcher. All directories are handed to the
+    underlying engine in one batch. Directories that are created inside
+    the watched trees later on are watched as well.
+
+    Only directories are watched; the files they contain are reported
+    through the directoryChanged() signal of their parent directory.
+    Removing one of \a directories with removePath() or removePaths()
+    also stops watching the directories below it.
+
+    The return value is a list of the entries in \a directories that could
+    not be watched, either because they are not directories or because the
+    engine failed to watch them.
+
+    \sa addPathRecursively(), addPaths(), removePaths()
+*/
+QStringList QFileSystemWatcher::addPathsRecursively(const QStringList &directories)
+{
+    Q_D(QFileSystemWatcher);
+
+    QStringList roots;
+    QStringList failed;
+    roots.reserve(directories.size());
+    for (const QString &path : directories) {
+        if (path.isEmpty())
+            continue;
+        if (QFileInfo(path).isDir())
+            roots.append(path);
+        else
+            failed.append(path);
+    }
+
+    if (roots.isEmpty() && failed.isEmpty()) {
+        qWarning("QFileSystemWatcher::addPathsRecursively: list is empty");
+        return QStringList();
+    }
+
+    const QStringList failedRoots = d->addDirectoryTrees(roots);
+    for (const QString &root : qAsConst(roots)) {
+        if (!failedRoots.contains(root))
+            d->recursiveRoots.insert(root);
+    }
+    return failed + failedRoots;
+}
+
+/*!
+    \since 5.8
+
+    Sets the coalescing interval to \a msecs milliseconds.
+
+    When the interval is larger than zero, changes reported for a path are
+    not delivered immediately. Instead, all changes seen for the same path
+    within the interval are merged, and fileChanged() or directoryChanged()
+    is emitted once per path, followed by pathChanged() carrying the union
+    of the changes. This avoids flooding the event loop when a large number
+    of files is being modified in bursts.
+
+    The default interval is 0, meaning that every change is delivered as
+    soon as the engine reports it. Setting the interval to 0 delivers any
+    changes that are still pending.
+
+    \sa coalescingInterval(), pathChanged()
+*/
+void QFileSystemWatcher::setCoalescingInterval(int msecs)
+{
+    Q_D(QFileSystemWatcher);
+    d->coalescingInterval = qMax(0, msecs);
+    if (d->coalescingInterval == 0 && !d->pendingOrder.isEmpty())
+        d->_q_flushPendingChanges();
+}
+
+/*!
+    \since 5.8
+
+    Returns the coalescing interval in milliseconds.
+
+    \sa setCoalescingInterval()
+*/
+int QFileSystemWatcher::coalescingInterval() const
+{
+    Q_D(const QFileSystemWatcher);
+    return d->coalescingInterval;
+}
+
 /*!
     \fn void QFileSystemWatcher::fileChanged(const QString &path)
 
@@ -412,6 +726,39 @@ QStringList QFileSystemWatcher::removePaths(const QStringList &paths)
     \sa fileChanged()
 */
 
+/*!
+    \fn void QFileSystemWatcher::pathChanged(const QString &path, QFileSystemWatcher::ChangeTypes changes)
+    \since 5.8
+
+    This signal is emitted right after fileChanged() or directoryChanged()
+    for \a path. \a changes describes what happened to the path; if a
+    coalescing interval is set, it contains all the changes that were seen
+    for \a path during that interval.
+
+    Not every engine can tell the kinds of changes apart. Those that cannot
+    report any change other than a removal as ContentModified.
+
+    \sa setCoalescingInterval()
+*/
+
+/*!
+    \enum QFileSystemWatcher::ChangeType
+    \since 5.8
+
+    This enum describes the changes reported by the pathChanged() signal.
+
+    \value ContentModified     The contents of the file were modified, or the
+                                directory changed in an unspecified way.
+    \value AttributesChanged   The permissions, ownership or timestamps of the
+                                path changed.
+    \value EntryAdded          An entry was created in, or moved into, the
+                                directory.
+    \value EntryRemoved        An entry was deleted from, or moved out of, the
+                                directory.
+    \value Removed             The path itself was removed or renamed, and is
+                                no longer being watched.
+*/
+
 /*!
     \fn QStringList QFileSystemWatcher::directories() const
 
@@ -431,12 +778,14 @@ QStringList QFileSystemWatcher::removePaths(const QStringList &paths)
 QStringList QFileSystemWatcher::directories() const
 {
     Q_D(const QFileSystemWatcher);
+    const_cast<QFileSystemWatcherPrivate *>(d)->purgeRemovedPaths();
     return d->directories;
 }
 
 QStringList QFileSystemWatcher::files() const
 {
     Q_D(const QFileSystemWatcher);
+    const_cast<QFileSystemWatcherPrivate *>(d)->purgeRemovedPaths();
     return d->files;
 }
 
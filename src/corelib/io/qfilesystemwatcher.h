@@ -55,6 +55,16 @@ class Q_CORE_EXPORT QFileSystemWatcher : public QObject
     Q_DECLARE_PRIVATE(QFileSystemWatcher)
 
 public:
+    enum ChangeType {
+        ContentModified   = 0x01,
+        AttributesChanged = 0x02,
+        EntryAdded        = 0x04,
+        EntryRemoved      = 0x08,
+        Removed           = 0x10
+    };
+    Q_DECLARE_FLAGS(ChangeTypes, ChangeType)
+    Q_FLAG(ChangeTypes)
+
     QFileSystemWatcher(QObject *parent = Q_NULLPTR);
     QFileSystemWatcher(const QStringList &paths, QObject *parent = Q_NULLPTR);
     ~QFileSystemWatcher();
@@ -64,18 +74,29 @@ public:
     bool removePath(const QString &file);
     QStringList removePaths(const QStringList &files);
 
+    bool addPathRecursively(const QString &directory);
+    QStringList addPathsRecursively(const QStringList &directories);
+
+    void setCoalescingInterval(int msecs);
+    int coalescingInterval() const;
+
     QStringList files() const;
     QStringList directories() const;
 
 Q_SIGNALS:
     void fileChanged(const QString &path, QPrivateSignal);
     void directoryChanged(const QString &path, QPrivateSignal);
+    void pathChanged(const QString &path, QFileSystemWatcher::ChangeTypes changes, QPrivateSignal);
 
 private:
     Q_PRIVATE_SLOT(d_func(), void _q_fileChanged(const QString &path, bool removed))
     Q_PRIVATE_SLOT(d_func(), void _q_directoryChanged(const QString &path, bool removed))
+    Q_PRIVATE_SLOT(d_func(), void _q_pathChanged(const QString &path, bool isDirectory, QFileSystemWatcher::ChangeTypes changes))
+    Q_PRIVATE_SLOT(d_func(), void _q_flushPendingChanges())
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(QFileSystemWatcher::ChangeTypes)
+
 QT_END_NAMESPACE
 
 #endif // QT_NO_FILESYSTEMWATCHER
@@ -45,9 +45,12 @@
 #include "private/qcore_unix_p.h"
 #include "private/qsystemerror_p.h"
 
+#include <algorithm>
+
 #include <qdebug.h>
 #include <qfile.h>
 #include <qfileinfo.h>
+#include <qset.h>
 #include <qsocketnotifier.h>
 #include <qvarlengtharray.h>
 
@@ -262,19 +265,22 @@ QStringList QInotifyFileSystemWatcherEngine::addPaths(const QStringList &paths,
                                                       QStringList *files,
                                                       QStringList *directories)
 {
-    QStringList p = paths;
-    QMutableListIterator<QString> it(p);
-    while (it.hasNext()) {
-        QString path = it.next();
+    // This is called with very large lists (recursive watches, whole
+    // workspaces), so avoid anything that is linear in the number of
+    // watched paths per added path: look up known paths in the hash and
+    // collect the failures instead of removing the successes from a copy.
+    QStringList p;
+    pathToID.reserve(pathToID.size() + paths.size());
+    idToPath.reserve(idToPath.size() + paths.size());
+
+    for (const QString &path : paths) {
+        if (pathToID.contains(path)) {
+            p.append(path);
+            continue;
+        }
+
         QFileInfo fi(path);
         bool isDir = fi.isDir();
-        if (isDir) {
-            if (directories->contains(path))
-                continue;
-        } else {
-            if (files->contains(path))
-                continue;
-        }
 
         int wd = inotify_add_watch(inotifyFd,
                                    QFile::encodeName(path),
@@ -295,11 +301,10 @@ QStringList QInotifyFileSystemWatcherEngine::addPaths(const QStringList &paths,
                                        )));
         if (wd < 0) {
             qWarning().nospace() << "inotify_add_watch(" << path << ") failed: " << QSystemError(errno, QSystemError::NativeError).toString();
+            p.append(path);
             continue;
         }
 
-        it.remove();
-
         int id = isDir ? -wd : wd;
         if (id < 0) {
             directories->append(path);
@@ -314,34 +319,67 @@ QStringList QInotifyFileSystemWatcherEngine::addPaths(const QStringList &paths,
     return p;
 }
 
+static void removeAllOf(QStringList *list, const QSet<QString> &paths)
+{
+    if (paths.isEmpty())
+        return;
+    list->erase(std::remove_if(list->begin(), list->end(),
+                               [&paths](const QString &path) { return paths.contains(path); }),
+                list->end());
+}
+
 QStringList QInotifyFileSystemWatcherEngine::removePaths(const QStringList &paths,
                                                          QStringList *files,
                                                          QStringList *directories)
 {
-    QStringList p = paths;
-    QMutableListIterator<QString> it(p);
-    while (it.hasNext()) {
-        QString path = it.next();
+    QStringList p;
+    QSet<QString> removedFiles;
+    QSet<QString> removedDirectories;
+
+    for (const QString &path : paths) {
         int id = pathToID.take(path);
         QString x = idToPath.take(id);
-        if (x.isEmpty() || x != path)
+        if (x.isEmpty() || x != path) {
+            p.append(path);
             continue;
+        }
 
         int wd = id < 0 ? -id : id;
         // qDebug() << "removing watch for path" << path << "wd" << wd;
         inotify_rm_watch(inotifyFd, wd);
 
-        it.remove();
         if (id < 0) {
-            directories->removeAll(path);
+            removedDirectories.insert(path);
         } else {
-            files->removeAll(path);
+            removedFiles.insert(path);
         }
     }
 
+    // one pass over each list, however many paths were removed
+    removeAllOf(directories, removedDirectories);
+    removeAllOf(files, removedFiles);
+
     return p;
 }
 
+static QFileSystemWatcher::ChangeTypes changeTypesFromMask(quint32 mask)
+{
+    QFileSystemWatcher::ChangeTypes changes;
+    if (mask & IN_MODIFY)
+        changes |= QFileSystemWatcher::ContentModified;
+    if (mask & IN_ATTRIB)
+        changes |= QFileSystemWatcher::AttributesChanged;
+    if (mask & (IN_CREATE | IN_MOVED_TO))
+        changes |= QFileSystemWatcher::EntryAdded;
+    if (mask & (IN_DELETE | IN_MOVED_FROM))
+        changes |= QFileSystemWatcher::EntryRemoved;
+    if (mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT))
+        changes |= QFileSystemWatcher::Removed;
+    if (!changes)
+        changes = QFileSystemWatcher::ContentModified;
+    return changes;
+}
+
 void QInotifyFileSystemWatcherEngine::readFromInotify()
 {
     // qDebug() << "QInotifyFileSystemWatcherEngine::readFromInotify";
@@ -353,23 +391,30 @@ void QInotifyFileSystemWatcherEngine::readFromInotify()
     char *at = buffer.data();
     char * const end = at + buffSize;
 
-    QHash<int, inotify_event *> eventForId;
+    // merge all events for the same watch, but keep them in the order in
+    // which the watches were first reported
+    struct WatchEvent {
+        int wd;
+        quint32 mask;
+    };
+    QVarLengthArray<WatchEvent, 128> events;
+    QHash<int, int> eventForId;
     while (at < end) {
-        inotify_event *event = reinterpret_cast<inotify_event *>(at);
+        const inotify_event *event = reinterpret_cast<inotify_event *>(at);
 
-        if (eventForId.contains(event->wd))
-            eventForId[event->wd]->mask |= event->mask;
-        else
-            eventForId.insert(event->wd, event);
+        QHash<int, int>::const_iterator it = eventForId.constFind(event->wd);
+        if (it != eventForId.constEnd()) {
+            events[it.value()].mask |= event->mask;
+        } else {
+            eventForId.insert(event->wd, events.size());
+            WatchEvent e = { event->wd, event->mask };
+            events.append(e);
+        }
 
         at += sizeof(inotify_event) + event->len;
     }
 
-    QHash<int, inotify_event *>::const_iterator it = eventForId.constBegin();
-    while (it != eventForId.constEnd()) {
-        const inotify_event &event = **it;
-        ++it;
-
+    for (const WatchEvent &event : qAsConst(events)) {
         // qDebug() << "inotify event, wd" << event.wd << "mask" << hex << event.mask;
 
         int id = event.wd;
@@ -384,22 +429,15 @@ void QInotifyFileSystemWatcherEngine::readFromInotify()
 
         // qDebug() << "event for path" << path;
 
-        if ((event.mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT)) != 0) {
+        const QFileSystemWatcher::ChangeTypes changes = changeTypesFromMask(event.mask);
+        if (changes & QFileSystemWatcher::Removed) {
             pathToID.remove(path);
             idToPath.remove(id, getPathFromID(id));
             if (!idToPath.contains(id))
                 inotify_rm_watch(inotifyFd, event.wd);
-
-            if (id < 0)
-                emit directoryChanged(path, true);
-            else
-                emit fileChanged(path, true);
-        } else {
-            if (id < 0)
-                emit directoryChanged(path, false);
-            else
-                emit fileChanged(path, false);
         }
+
+        emit pathChanged(path, id < 0, changes);
     }
 }
 
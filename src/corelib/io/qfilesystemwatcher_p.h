@@ -58,6 +58,9 @@
 #include <private/qobject_p.h>
 
 #include <QtCore/qstringlist.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qset.h>
+#include <QtCore/qtimer.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -87,6 +90,9 @@ public:
 Q_SIGNALS:
     void fileChanged(const QString &path, bool removed);
     void directoryChanged(const QString &path, bool removed);
+    // engines that can tell what kind of change happened emit this
+    // instead of fileChanged()/directoryChanged()
+    void pathChanged(const QString &path, bool isDirectory, QFileSystemWatcher::ChangeTypes changes);
 };
 
 class QFileSystemWatcherPrivate : public QObjectPrivate
@@ -99,13 +105,48 @@ public:
     QFileSystemWatcherPrivate();
     void init();
     void initPollerEngine();
+    void connectEngine(QFileSystemWatcherEngine *engine);
+    QFileSystemWatcherEngine *engineForPaths();
+
+    QStringList addPathsToEngine(QFileSystemWatcherEngine *engine, const QStringList &paths);
+    QStringList removePathsFromEngine(QFileSystemWatcherEngine *engine, const QStringList &paths);
+    void purgeRemovedPaths();
+
+    QStringList addDirectoryTrees(const QStringList &roots);
+    void addNewSubdirectories(const QString &directory);
+    void queueChange(const QString &path, bool isDirectory, QFileSystemWatcher::ChangeTypes changes,
+                     bool rescan);
+    void deliverChange(const QString &path, bool isDirectory, QFileSystemWatcher::ChangeTypes changes,
+                       bool rescan);
 
     QFileSystemWatcherEngine *native, *poller;
     QStringList files, directories;
+    // the same paths, for lookups while changes are dispatched
+    QSet<QString> watchedFiles, watchedDirectories;
+    // paths reported as removed, dropped from files and directories in one
+    // pass before the lists are used again
+    QSet<QString> removedFiles, removedDirectories;
+
+    // directories added through addPathsRecursively(), and every directory
+    // below them that is being watched on their behalf
+    QSet<QString> recursiveRoots;
+    QSet<QString> recursiveDirectories;
+
+    struct PendingChange {
+        bool isDirectory;
+        bool rescan; // look for new subdirectories of a recursive watch
+        QFileSystemWatcher::ChangeTypes changes;
+    };
+    QHash<QString, PendingChange> pendingChanges;
+    QStringList pendingOrder;
+    QTimer coalescingTimer;
+    int coalescingInterval;
 
     // private slots
     void _q_fileChanged(const QString &path, bool removed);
     void _q_directoryChanged(const QString &path, bool removed);
+    void _q_pathChanged(const QString &path, bool isDirectory, QFileSystemWatcher::ChangeTypes changes);
+    void _q_flushPendingChanges();
 };
 
 
@@ -1992,6 +1992,11 @@ void QProcess::setProcessState(ProcessState state)
 
     \warning This function is called by QProcess on Unix and OS X
     only. On Windows and QNX, it is not called.
+
+    \note On Linux, QProcess starts the child process without copying the
+    parent's address space if this function is not reimplemented, which
+    makes starting processes from large applications considerably faster.
+    Reimplementing it forces QProcess to use \c fork().
 */
 void QProcess::setupChildProcess()
 {
@@ -115,6 +115,9 @@ QT_END_NAMESPACE
 #include <stdlib.h>
 #include <string.h>
 #include <forkfd.h>
+#ifdef __GXX_RTTI
+#  include <typeinfo>
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -363,6 +366,39 @@ static char **_q_dupEnvironment(const QProcessEnvironmentPrivate::Hash &environm
     return envp;
 }
 
+#if !defined(QPROCESS_USE_SPAWN)
+namespace {
+struct QProcessVforkChild
+{
+    QProcessPrivate *d;
+    const char *workingDirectory;
+    char **path;
+    char **argv;
+    char **envp;
+};
+}
+
+static int execChildAfterVfork(void *token)
+{
+    QProcessVforkChild *child = static_cast<QProcessVforkChild *>(token);
+    child->d->execChild(child->workingDirectory, child->path, child->argv, child->envp);
+    return -1;
+}
+
+// A reimplementation of QProcess::setupChildProcess() may run arbitrary code
+// in the child, which is only safe if the child has its own copy of our
+// memory. Without RTTI, we cannot tell whether it was reimplemented.
+static bool childNeedsOwnAddressSpace(const QProcess *process)
+{
+#ifdef __GXX_RTTI
+    return typeid(*process) != typeid(QProcess);
+#else
+    Q_UNUSED(process);
+    return true;
+#endif
+}
+#endif
+
 void QProcessPrivate::startProcess()
 {
     Q_Q(QProcess);
@@ -477,7 +513,15 @@ void QProcessPrivate::startProcess()
     Q_ASSUME(forkfd != FFD_CHILD_PROCESS);
 #else
     pid_t childPid;
-    forkfd = ::forkfd(FFD_CLOEXEC, &childPid);
+    if (childNeedsOwnAddressSpace(q)) {
+        forkfd = ::forkfd(FFD_CLOEXEC, &childPid);
+    } else {
+        // Nothing but our own code runs in the child, so it can share our
+        // memory until it execs: that way, starting it costs the same no
+        // matter how large this process is.
+        QProcessVforkChild child = { this, workingDirPtr, path, argv, envp };
+        forkfd = ::vforkfd(FFD_CLOEXEC, &childPid, execChildAfterVfork, &child);
+    }
 #endif
     int lastForkErrno = errno;
     if (forkfd != FFD_CHILD_PROCESS) {
@@ -768,7 +812,8 @@ report_errno:
     qt_safe_write(childStartedPipe[1], callthatfailed, strlen(callthatfailed));
     qt_safe_write(childStartedPipe[1], msg, strlen(msg));
     qt_safe_close(childStartedPipe[1]);
-    childStartedPipe[1] = -1;
+    // don't reset childStartedPipe[1]: after a vfork, this process shares
+    // the parent's memory, and the parent still has to close its end
 }
 #endif
 
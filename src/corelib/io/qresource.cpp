@@ -49,10 +49,15 @@
 #include "qdatetime.h"
 #include "qbytearray.h"
 #include "qstringlist.h"
+#include "qcache.h"
 #include <qshareddata.h>
 #include <qplatformdefs.h>
 #include "private/qabstractfileengine_p.h"
 
+#if !defined(QT_BOOTSTRAPPED) && !defined(QT_NO_COMPRESS)
+#include <zlib.h>
+#endif
+
 #ifdef Q_OS_UNIX
 # include "private/qcore_unix_p.h"
 #endif
@@ -98,22 +103,28 @@ class QResourceRoot
     enum Flags
     {
         Compressed = 0x01,
-        Directory = 0x02
+        Directory = 0x02,
+        Chunked = 0x04
     };
     const uchar *tree, *names, *payloads;
+    int version;
     inline int findOffset(int node) const { return node * 14; } //sizeof each tree element
     uint hash(int node) const;
     QString name(int node) const;
     short flags(int node) const;
+    // nodes using flags of a later format version can't be read
+    inline short knownFlags() const
+    { return version >= 0x02 ? (Compressed | Directory | Chunked) : (Compressed | Directory); }
 public:
     mutable QAtomicInt ref;
 
-    inline QResourceRoot(): tree(0), names(0), payloads(0) {}
-    inline QResourceRoot(const uchar *t, const uchar *n, const uchar *d) { setSource(t, n, d); }
-    virtual ~QResourceRoot() { }
+    inline QResourceRoot(): tree(0), names(0), payloads(0), version(0x01) {}
+    inline QResourceRoot(int v, const uchar *t, const uchar *n, const uchar *d) { setSource(v, t, n, d); }
+    virtual ~QResourceRoot();
     int findNode(const QString &path, const QLocale &locale=QLocale()) const;
     inline bool isContainer(int node) const { return flags(node) & Directory; }
     inline bool isCompressed(int node) const { return flags(node) & Compressed; }
+    inline bool isChunked(int node) const { return flags(node) & Chunked; }
     const uchar *data(int node, qint64 *size) const;
     QStringList children(int node) const;
     virtual QString mappingRoot() const { return QString(); }
@@ -126,7 +137,8 @@ public:
     virtual ResourceRootType type() const { return Resource_Builtin; }
 
 protected:
-    inline void setSource(const uchar *t, const uchar *n, const uchar *d) {
+    inline void setSource(int v, const uchar *t, const uchar *n, const uchar *d) {
+        version = v;
         tree = t;
         names = n;
         payloads = d;
@@ -228,6 +240,7 @@ public:
     QList<QResourceRoot*> related;
     uint container : 1;
     mutable uint compressed : 1;
+    mutable uint chunked : 1;
     mutable qint64 size;
     mutable const uchar *data;
     mutable QStringList children;
@@ -241,6 +254,7 @@ QResourcePrivate::clear()
 {
     absoluteFilePath.clear();
     compressed = 0;
+    chunked = 0;
     data = 0;
     size = 0;
     children.clear();
@@ -269,10 +283,12 @@ QResourcePrivate::load(const QString &file)
                 if(!container) {
                     data = res->data(node, &size);
                     compressed = res->isCompressed(node);
+                    chunked = res->isChunked(node);
                 } else {
                     data = 0;
                     size = 0;
                     compressed = 0;
+                    chunked = 0;
                 }
             } else if(res->isContainer(node) != container) {
                 qWarning("QResourceInfo: Resource [%s] has both data and children!", file.toLatin1().constData());
@@ -284,6 +300,7 @@ QResourcePrivate::load(const QString &file)
             data = 0;
             size = 0;
             compressed = 0;
+            chunked = 0;
             res->ref.ref();
             related.append(res);
         }
@@ -474,6 +491,12 @@ bool QResource::isValid() const
     Returns \c true if the resource represents a file and the data backing it
     is in a compressed format, false otherwise.
 
+    The data of a compressed resource is usually in the format written by
+    qCompress(). Large files compressed by rcc with the \c -chunk-size
+    option are instead stored as a table of chunks that are compressed
+    independently, which qUncompress() cannot read. Use QFile to read the
+    contents of compressed resources regardless of their layout.
+
     \sa data(), isFile()
 */
 
@@ -499,8 +522,9 @@ qint64 QResource::size() const
 
 /*!
     Returns direct access to a read only segment of data that this resource
-    represents. If the resource is compressed the data returns is
-    compressed and qUncompress() must be used to access the data. If the
+    represents. If the resource is compressed the data returned is
+    compressed. Unless the resource was compressed in chunks (see
+    isCompressed()), qUncompress() can be used to access the data. If the
     resource is a directory 0 is returned.
 
     \sa size(), isCompressed(), isFile()
@@ -583,6 +607,51 @@ QResource::searchPaths()
     return *resourceSearchPaths();
 }
 
+#if !defined(QT_BOOTSTRAPPED) && !defined(QT_NO_COMPRESS)
+// Uncompressed chunks of chunked resources, shared by all file engines so
+// that reopening a file does not uncompress the same chunks again.
+struct QResourceChunkKey
+{
+    const QResourceRoot *root;
+    const uchar *data;
+    int index;
+};
+
+static inline bool operator==(const QResourceChunkKey &lhs, const QResourceChunkKey &rhs)
+{
+    return lhs.root == rhs.root && lhs.data == rhs.data && lhs.index == rhs.index;
+}
+
+static inline uint qHash(const QResourceChunkKey &key, uint seed = 0) Q_DECL_NOTHROW
+{
+    return qHash(quintptr(key.data), seed) ^ uint(key.index);
+}
+
+struct QResourceChunkCache
+{
+    QResourceChunkCache() : chunks(4 * 1024 * 1024) { }
+    QMutex mutex;
+    QCache<QResourceChunkKey, QByteArray> chunks;
+};
+Q_GLOBAL_STATIC(QResourceChunkCache, resourceChunkCache)
+#endif
+
+QResourceRoot::~QResourceRoot()
+{
+#if !defined(QT_BOOTSTRAPPED) && !defined(QT_NO_COMPRESS)
+    // the memory of the root may be reused, forget the chunks that pointed to it
+    if (!resourceChunkCache.exists())
+        return;
+    QResourceChunkCache *cache = resourceChunkCache();
+    QMutexLocker lock(&cache->mutex);
+    const QList<QResourceChunkKey> keys = cache->chunks.keys();
+    for (const QResourceChunkKey &key : keys) {
+        if (key.root == this)
+            cache->chunks.remove(key);
+    }
+#endif
+}
+
 inline uint QResourceRoot::hash(int node) const
 {
     if(!node) //root
@@ -696,6 +765,8 @@ int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
                     const short flags = (tree[offset+0] << 8) +
                                         (tree[offset+1] << 0);
                     offset += 2;
+                    if (flags & ~knownFlags())
+                        return -1;
 
                     if(!splitter.hasNext()) {
                         if(!(flags & Directory)) {
@@ -797,8 +868,10 @@ QStringList QResourceRoot::children(int node) const
         const int child_off = (tree[offset+0] << 24) + (tree[offset+1] << 16) +
                               (tree[offset+2] << 8) + (tree[offset+3] << 0);
         ret.reserve(child_count);
-        for(int i = child_off; i < child_off+child_count; ++i)
-            ret << name(i);
+        for(int i = child_off; i < child_off+child_count; ++i) {
+            if (!(QResourceRoot::flags(i) & ~knownFlags()))
+                ret << name(i);
+        }
     }
     return ret;
 }
@@ -829,9 +902,9 @@ Q_CORE_EXPORT bool qRegisterResourceData(int version, const unsigned char *tree,
                                          const unsigned char *name, const unsigned char *data)
 {
     QMutexLocker lock(resourceMutex());
-    if(version == 0x01 && resourceList()) {
+    if ((version == 0x01 || version == 0x02) && resourceList()) {
         bool found = false;
-        QResourceRoot res(tree, name, data);
+        QResourceRoot res(version, tree, name, data);
         for(int i = 0; i < resourceList()->size(); ++i) {
             if(*resourceList()->at(i) == res) {
                 found = true;
@@ -839,7 +912,7 @@ Q_CORE_EXPORT bool qRegisterResourceData(int version, const unsigned char *tree,
             }
         }
         if(!found) {
-            QResourceRoot *root = new QResourceRoot(tree, name, data);
+            QResourceRoot *root = new QResourceRoot(version, tree, name, data);
             root->ref.ref();
             resourceList()->append(root);
         }
@@ -852,8 +925,8 @@ Q_CORE_EXPORT bool qUnregisterResourceData(int version, const unsigned char *tre
                                            const unsigned char *name, const unsigned char *data)
 {
     QMutexLocker lock(resourceMutex());
-    if(version == 0x01 && resourceList()) {
-        QResourceRoot res(tree, name, data);
+    if ((version == 0x01 || version == 0x02) && resourceList()) {
+        QResourceRoot res(version, tree, name, data);
         for(int i = 0; i < resourceList()->size(); ) {
             if(*resourceList()->at(i) == res) {
                 QResourceRoot *root = resourceList()->takeAt(i);
@@ -919,9 +992,9 @@ public:
         if (size >= 0 && (tree_offset >= size || data_offset >= size || name_offset >= size))
             return false;
 
-        if(version == 0x01) {
+        if (version == 0x01 || version == 0x02) {
             buffer = b;
-            setSource(b+tree_offset, b+name_offset, b+data_offset);
+            setSource(version, b+tree_offset, b+name_offset, b+data_offset);
             return true;
         }
         return false;
@@ -1194,13 +1267,202 @@ protected:
 private:
     uchar *map(qint64 offset, qint64 size, QFile::MemoryMapFlags flags);
     bool unmap(uchar *ptr);
+    void setResource(QResourcePrivate *rd);
+    qint64 uncompressedSize() const;
+    bool uncompress();
+    qint64 readChunks(char *data, qint64 len);
     qint64 offset;
     QResource resource;
+    QResourceRoot *root;
+    bool compressed;
+    bool chunked;
     QByteArray uncompressed;
+    QByteArray chunk;
+    int chunkIndex;
 protected:
-    QResourceFileEnginePrivate() : offset(0) { }
+    QResourceFileEnginePrivate()
+        : offset(0), root(0), compressed(false), chunked(false), chunkIndex(-1) { }
 };
 
+static inline quint32 resourceNumber4(const uchar *p)
+{
+    return (quint32(p[0]) << 24) | (quint32(p[1]) << 16) | (quint32(p[2]) << 8) | quint32(p[3]);
+}
+
+void QResourceFileEnginePrivate::setResource(QResourcePrivate *rd)
+{
+    rd->ensureInitialized();
+    root = rd->related.value(0);
+    compressed = rd->compressed && rd->size;
+    chunked = compressed && rd->chunked;
+    uncompressed.clear();
+    chunk.clear();
+    chunkIndex = -1;
+}
+
+// Compressed resources are only uncompressed when they are read; the size
+// of the uncompressed data is stored in front of the compressed data.
+qint64 QResourceFileEnginePrivate::uncompressedSize() const
+{
+    if (!compressed)
+        return resource.size();
+    if (!uncompressed.isNull())
+        return uncompressed.size();
+    if (resource.size() < 4)
+        return 0;
+    return resourceNumber4(resource.data());
+}
+
+bool QResourceFileEnginePrivate::uncompress()
+{
+    if (!uncompressed.isNull())
+        return true;
+#ifndef QT_NO_COMPRESS
+    if (!chunked) {
+        uncompressed = qUncompress(resource.data(), resource.size());
+        return !uncompressed.isNull();
+    }
+    QByteArray data(int(uncompressedSize()), Qt::Uninitialized);
+    const qint64 savedOffset = offset;
+    offset = 0;
+    const qint64 read = readChunks(data.data(), data.size());
+    offset = savedOffset;
+    if (read != data.size())
+        return false;
+    uncompressed = data;
+    chunk.clear();
+    chunkIndex = -1;
+    return true;
+#else
+    Q_ASSERT(!"QResourceFileEngine::open: Qt built without support for compression");
+    return false;
+#endif
+}
+
+/*
+    Chunked resources, written by rcc -chunk-size, consist of the
+    uncompressed size, the chunk size, a table with the offsets of the
+    chunks (relative to the end of the table) and the chunks, each of
+    which is a zlib stream. Only the chunks that overlap the range being
+    read are uncompressed.
+*/
+qint64 QResourceFileEnginePrivate::readChunks(char *data, qint64 len)
+{
+#ifndef QT_NO_COMPRESS
+    const uchar *blob = resource.data();
+    const qint64 blobSize = resource.size();
+    if (blobSize < 8)
+        return -1;
+    const quint32 totalSize = resourceNumber4(blob);
+    const quint32 chunkSize = resourceNumber4(blob + 4);
+    if (!chunkSize)
+        return -1;
+    const quint32 chunkCount = (totalSize + chunkSize - 1) / chunkSize;
+    const qint64 tableEnd = 8 + 4 * (qint64(chunkCount) + 1);
+    if (tableEnd > blobSize)
+        return -1;
+
+    qint64 done = 0;
+    while (done < len) {
+        const qint64 pos = offset + done;
+        const int index = int(pos / chunkSize);
+        if (index != chunkIndex) {
+            const QResourceChunkKey key = { root, blob, index };
+            QResourceChunkCache *cache = resourceChunkCache();
+            {
+                QMutexLocker lock(&cache->mutex);
+                if (const QByteArray *cached = cache->chunks.object(key))
+                    chunk = *cached;
+                else
+                    chunk.clear();
+            }
+            if (chunk.isNull()) {
+                const quint32 begin = resourceNumber4(blob + 8 + 4 * index);
+                const quint32 end = resourceNumber4(blob + 8 + 4 * (index + 1));
+                if (begin > end || tableEnd + end > blobSize)
+                    return -1;
+                const quint32 expected = qMin(chunkSize, totalSize - quint32(index) * chunkSize);
+                QByteArray result(int(expected), Qt::Uninitialized);
+                uLongf resultSize = expected;
+                if (::uncompress(reinterpret_cast<Bytef *>(result.data()), &resultSize,
+                                 blob + tableEnd + begin, end - begin) != Z_OK
+                    || resultSize != expected) {
+                    qWarning("QResourceFileEngine::read: Corrupt compressed data in %s",
+                             qPrintable(resource.fileName()));
+                    return -1;
+                }
+                chunk = result;
+                QMutexLocker lock(&cache->mutex);
+                cache->chunks.insert(key, new QByteArray(result), result.size());
+            }
+            chunkIndex = index;
+        }
+        const qint64 inChunk = pos - qint64(index) * chunkSize;
+        const qint64 n = qMin(len - done, qint64(chunk.size()) - inChunk);
+        memcpy(data + done, chunk.constData() + inChunk, n);
+        done += n;
+    }
+    return done;
+#else
+    Q_UNUSED(data);
+    Q_UNUSED(len);
+    return -1;
+#endif
+}
+
+/*
+    Sets \a adler32 to the Adler-32 checksum of the uncompressed contents
+    of the file. zlib streams end with the checksum of the data they hold,
+    so compressed files are not uncompressed for this; the checksums of
+    the chunks of chunked files are combined.
+*/
+bool QResourceFileEngine::contentChecksum(quint32 *adler32) const
+{
+#ifndef QT_NO_COMPRESS
+    Q_D(const QResourceFileEngine);
+    if (!d->resource.isValid() || d->resource.isDir())
+        return false;
+    const uchar *blob = d->resource.data();
+    const qint64 blobSize = d->resource.size();
+    if (!d->compressed) {
+        *adler32 = quint32(::adler32(::adler32(0, Z_NULL, 0), blob, uInt(blobSize)));
+        return true;
+    }
+    if (!d->chunked) {
+        // the uncompressed size, then a zlib stream of at least 6 bytes
+        if (blobSize < 10)
+            return false;
+        *adler32 = resourceNumber4(blob + blobSize - 4);
+        return true;
+    }
+
+    if (blobSize < 8)
+        return false;
+    const quint32 totalSize = resourceNumber4(blob);
+    const quint32 chunkSize = resourceNumber4(blob + 4);
+    if (!chunkSize)
+        return false;
+    const quint32 chunkCount = (totalSize + chunkSize - 1) / chunkSize;
+    const qint64 tableEnd = 8 + 4 * (qint64(chunkCount) + 1);
+    if (tableEnd > blobSize)
+        return false;
+    uLong checksum = ::adler32(0, Z_NULL, 0);
+    for (quint32 index = 0; index < chunkCount; ++index) {
+        const quint32 begin = resourceNumber4(blob + 8 + 4 * index);
+        const quint32 end = resourceNumber4(blob + 8 + 4 * (index + 1));
+        if (begin + 6 > end || tableEnd + end > blobSize)
+            return false;
+        const quint32 length = qMin(chunkSize, totalSize - index * chunkSize);
+        checksum = ::adler32_combine(checksum, resourceNumber4(blob + tableEnd + end - 4), length);
+    }
+    *adler32 = quint32(checksum);
+    return true;
+#else
+    Q_UNUSED(adler32);
+    return false;
+#endif
+}
+
 bool QResourceFileEngine::mkdir(const QString &, bool) const
 {
     return false;
@@ -1231,13 +1493,7 @@ QResourceFileEngine::QResourceFileEngine(const QString &file) :
 {
     Q_D(QResourceFileEngine);
     d->resource.setFileName(file);
-    if(d->resource.isCompressed() && d->resource.size()) {
-#ifndef QT_NO_COMPRESS
-        d->uncompressed = qUncompress(d->resource.data(), d->resource.size());
-#else
-        Q_ASSERT(!"QResourceFileEngine::open: Qt built without support for compression");
-#endif
-    }
+    d->setResource(d->resource.d_func());
 }
 
 QResourceFileEngine::~QResourceFileEngine()
@@ -1248,6 +1504,7 @@ void QResourceFileEngine::setFileName(const QString &file)
 {
     Q_D(QResourceFileEngine);
     d->resource.setFileName(file);
+    d->setResource(d->resource.d_func());
 }
 
 bool QResourceFileEngine::open(QIODevice::OpenMode flags)
@@ -1269,6 +1526,8 @@ bool QResourceFileEngine::close()
     Q_D(QResourceFileEngine);
     d->offset = 0;
     d->uncompressed.clear();
+    d->chunk.clear();
+    d->chunkIndex = -1;
     return true;
 }
 
@@ -1284,10 +1543,17 @@ qint64 QResourceFileEngine::read(char *data, qint64 len)
         len = size()-d->offset;
     if(len <= 0)
         return 0;
-    if(d->resource.isCompressed())
-        memcpy(data, d->uncompressed.constData()+d->offset, len);
-    else
+    if(!d->compressed) {
         memcpy(data, d->resource.data()+d->offset, len);
+    } else if(d->chunked && d->uncompressed.isNull()) {
+        len = d->readChunks(data, len);
+        if(len < 0)
+            return -1;
+    } else {
+        if(!d->uncompress())
+            return -1;
+        memcpy(data, d->uncompressed.constData()+d->offset, len);
+    }
     d->offset += len;
     return len;
 }
@@ -1322,9 +1588,7 @@ qint64 QResourceFileEngine::size() const
     Q_D(const QResourceFileEngine);
     if(!d->resource.isValid())
         return 0;
-    if(d->resource.isCompressed())
-        return d->uncompressed.size();
-    return d->resource.size();
+    return d->uncompressedSize();
 }
 
 qint64 QResourceFileEngine::pos() const
@@ -1478,10 +1742,18 @@ uchar *QResourceFileEnginePrivate::map(qint64 offset, qint64 size, QFile::Memory
 {
     Q_Q(QResourceFileEngine);
     Q_UNUSED(flags);
-    if (offset < 0 || size <= 0 || !resource.isValid() || offset + size > resource.size()) {
+    if (offset < 0 || size <= 0 || !resource.isValid() || offset + size > uncompressedSize()) {
         q->setError(QFile::UnspecifiedError, QString());
         return 0;
     }
+    if (compressed) {
+        // map the uncompressed data, not the compressed data backing the resource
+        if (!uncompress()) {
+            q->setError(QFile::UnspecifiedError, QString());
+            return 0;
+        }
+        return reinterpret_cast<uchar *>(uncompressed.data()) + offset;
+    }
     uchar *address = const_cast<uchar *>(resource.data());
     return (address + offset);
 }
@@ -110,6 +110,8 @@ public:
 
     bool extension(Extension extension, const ExtensionOption *option = 0, ExtensionReturn *output = 0) Q_DECL_OVERRIDE;
     bool supportsExtension(Extension extension) const Q_DECL_OVERRIDE;
+
+    bool contentChecksum(quint32 *adler32) const;
 };
 
 QT_END_NAMESPACE
@@ -295,6 +295,10 @@ after_loop:
 QSettingsPrivate *QSettingsPrivate::create(QSettings::Format format, QSettings::Scope scope,
                                            const QString &organization, const QString &application)
 {
+#ifndef QT_BOOTSTRAPPED
+    if (format == QSettings::IndexedFormat)
+        return new QIndexedSettingsPrivate(scope, organization, application);
+#endif
     return new QConfFileSettingsPrivate(format, scope, organization, application);
 }
 #endif
@@ -302,6 +306,10 @@ QSettingsPrivate *QSettingsPrivate::create(QSettings::Format format, QSettings::
 #if !defined(Q_OS_WIN)
 QSettingsPrivate *QSettingsPrivate::create(const QString &fileName, QSettings::Format format)
 {
+#ifndef QT_BOOTSTRAPPED
+    if (format == QSettings::IndexedFormat)
+        return new QIndexedSettingsPrivate(fileName);
+#endif
     return new QConfFileSettingsPrivate(fileName, format);
 }
 #endif
@@ -1130,6 +1138,11 @@ static QString getPath(QSettings::Format format, QSettings::Scope scope)
     return pathHash->value(pathHashKey(QSettings::IniFormat, scope));
 }
 
+QString QSettingsPrivate::settingsPath(QSettings::Format format, QSettings::Scope scope)
+{
+    return getPath(format, scope);
+}
+
 QConfFileSettingsPrivate::QConfFileSettingsPrivate(QSettings::Format format,
                                                    QSettings::Scope scope,
                                                    const QString &organization,
@@ -2421,6 +2434,10 @@ void QConfFileSettingsPrivate::ensureSectionParsed(QConfFile *confFile,
                             this works the same as specifying NativeFormat.
                             This enum value was added in Qt 5.7.
     \value IniFormat        Store the settings in INI files.
+    \value IndexedFormat    Store the settings in a binary file with a sorted,
+                            memory-mapped key index and a journal of pending
+                            changes. See \l{Indexed Format}.
+                            This enum value was added in Qt 5.8.
     \value InvalidFormat    Special value returned by registerFormat().
     \omitvalue CustomFormat1
     \omitvalue CustomFormat2
@@ -2485,6 +2502,25 @@ void QConfFileSettingsPrivate::ensureSectionParsed(QConfFile *confFile,
         potentially less compatible), call setIniCodec().
     \endlist
 
+    \target Indexed Format
+    IndexedFormat is meant for applications that store a large number
+    of settings. Its files use the \c .qsi extension and are located
+    in the same directories as INI files. Opening such a file only
+    maps it into memory: values are looked up with a binary search in
+    the key index and are only decoded when they are requested.
+    sync() appends the changes made since the last sync() to the end
+    of the file instead of rewriting it, and the file is rewritten
+    (compacted) only once these appended changes have grown large
+    compared to the rest of the file. Several processes can read and
+    update the same file concurrently.
+
+    Keys are always case sensitive in this format, and the file is
+    not meant to be edited by hand. If the file does not exist yet
+    but an INI file with the same name (with the \c .ini extension
+    instead of \c .qsi) does, the settings are imported from the INI
+    file, and written to the new file on the next sync(). The INI
+    file itself is left untouched.
+
     \sa registerFormat(), setPath()
 */
 
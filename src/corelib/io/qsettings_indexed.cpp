@@ -0,0 +1,953 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsettings.h"
+
+#if !defined(QT_NO_SETTINGS) && !defined(QT_BOOTSTRAPPED)
+
+#include "qsettings_p.h"
+#include "qdatastream.h"
+#include "qdatetime.h"
+#include "qdir.h"
+#include "qendian.h"
+#include "qfile.h"
+#include "qfileinfo.h"
+#include "qhash.h"
+#include "qlockfile.h"
+#include "qsavefile.h"
+#include "qtemporaryfile.h"
+
+#include <algorithm>
+#include <limits>
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    An IndexedFormat file starts with a snapshot of all settings, followed
+    by a journal of the changes made since the snapshot was written. All
+    numbers are stored in little-endian byte order.
+
+    The snapshot consists of a header, an index of fixed-size entries sorted
+    by key, the keys (in UTF-16) and the values (streamed with QDataStream):
+
+        0   "QSIX"
+        4   format version
+        8   QDataStream version of the values
+        12  generation, incremented whenever the file is rewritten
+        16  stamp, to tell apart files with the same generation
+        20  number of index entries
+        24  size of the snapshot, which is also where the journal starts
+        28  reserved
+        32  index entries: key offset, key length (in QChars),
+                           value offset, value length (in bytes)
+
+    The snapshot is never modified once written, so it can be memory mapped
+    and searched without parsing it. Each journal record consists of the
+    payload length, the operation, the checksum of the payload and the
+    payload itself: the key length and key for set and remove operations,
+    followed by the value for set operations. Journal records are only
+    appended while holding the lock file; a record that is incomplete or
+    fails the checksum ends the journal.
+
+    Once the journal has grown large compared to the snapshot, the file is
+    rewritten with a new snapshot and an empty journal. Other processes
+    notice this through the generation and stamp in the header, and reload
+    the file when they next sync.
+*/
+
+static const char indexedMagic[] = { 'Q', 'S', 'I', 'X' };
+
+enum {
+    IndexedFormatVersion = 1,
+    IndexedStreamVersion = QDataStream::Qt_5_6,
+    HeaderSize = 32,
+    EntrySize = 16,
+    RecordHeaderSize = 8,
+    MinCompactionSize = 64 * 1024
+};
+
+struct QIndexedSettingsHeader
+{
+    quint32 version;
+    quint32 streamVersion;
+    quint32 generation;
+    quint32 stamp;
+    quint32 count;
+    quint32 snapshotSize;
+};
+
+static inline quint32 readUInt32(const uchar *data)
+{
+    return qFromLittleEndian<quint32>(data);
+}
+
+static bool readHeader(QFile *file, QIndexedSettingsHeader *header)
+{
+    uchar data[HeaderSize];
+    if (file->read(reinterpret_cast<char *>(data), HeaderSize) != HeaderSize
+        || memcmp(data, indexedMagic, sizeof indexedMagic) != 0)
+        return false;
+
+    header->version = readUInt32(data + 4);
+    header->streamVersion = readUInt32(data + 8);
+    header->generation = readUInt32(data + 12);
+    header->stamp = readUInt32(data + 16);
+    header->count = readUInt32(data + 20);
+    header->snapshotSize = readUInt32(data + 24);
+
+    return header->version == IndexedFormatVersion
+            && header->snapshotSize >= HeaderSize
+            && header->snapshotSize <= file->size()
+            && quint64(header->count) * EntrySize <= header->snapshotSize - HeaderSize;
+}
+
+static void appendUInt32(QByteArray &out, quint32 value)
+{
+    uchar data[4];
+    qToLittleEndian(value, data);
+    out.append(reinterpret_cast<const char *>(data), 4);
+}
+
+static void appendKey(QByteArray &out, const QString &key)
+{
+    appendUInt32(out, key.size());
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    out.append(reinterpret_cast<const char *>(key.constData()), key.size() * 2);
+#else
+    for (QChar ch : key) {
+        uchar data[2];
+        qToLittleEndian(ch.unicode(), data);
+        out.append(reinterpret_cast<const char *>(data), 2);
+    }
+#endif
+}
+
+static QString readKey(const uchar *data, int length)
+{
+    QString key(length, Qt::Uninitialized);
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    memcpy(key.data(), data, length * 2);
+#else
+    for (int i = 0; i < length; ++i)
+        key[i] = QChar(qFromLittleEndian<quint16>(data + 2 * i));
+#endif
+    return key;
+}
+
+static QByteArray encodeValue(const QVariant &value, int streamVersion)
+{
+    QByteArray result;
+    QDataStream out(&result, QIODevice::WriteOnly);
+    out.setVersion(streamVersion);
+    out << value;
+    return result;
+}
+
+static QVariant decodeValue(const QByteArray &data, int streamVersion)
+{
+    QDataStream in(data);
+    in.setVersion(streamVersion);
+    QVariant result;
+    in >> result;
+    return result;
+}
+
+static void appendRecord(QByteArray &out, const QIndexedSettingsFile::Change &change,
+                         int streamVersion)
+{
+    QByteArray payload;
+    if (change.operation != QIndexedSettingsFile::ClearOperation)
+        appendKey(payload, change.key);
+    if (change.operation == QIndexedSettingsFile::SetOperation)
+        payload += encodeValue(change.value, streamVersion);
+
+    uchar header[RecordHeaderSize];
+    qToLittleEndian(quint32(payload.size()), header);
+    qToLittleEndian(quint16(change.operation), header + 4);
+    qToLittleEndian(qChecksum(payload.constData(), payload.size()), header + 6);
+    out.append(reinterpret_cast<const char *>(header), RecordHeaderSize);
+    out += payload;
+}
+
+static bool readRecord(const uchar *data, quint32 size, int operation, int streamVersion,
+                       QIndexedSettingsFile::Change *change)
+{
+    change->operation = QIndexedSettingsFile::Operation(operation);
+    switch (operation) {
+    case QIndexedSettingsFile::ClearOperation:
+        return size == 0;
+    case QIndexedSettingsFile::SetOperation:
+    case QIndexedSettingsFile::RemoveOperation:
+        break;
+    default:
+        return false;
+    }
+
+    if (size < 4)
+        return false;
+    const quint32 keyLength = readUInt32(data);
+    if (keyLength > (size - 4) / 2)
+        return false;
+    change->key = readKey(data + 4, keyLength);
+    if (operation == QIndexedSettingsFile::SetOperation) {
+        const quint32 offset = 4 + 2 * keyLength;
+        change->value = decodeValue(QByteArray::fromRawData(reinterpret_cast<const char *>(data) + offset,
+                                                            size - offset),
+                                    streamVersion);
+    }
+    return true;
+}
+
+bool QIndexedSettingsLayer::hides(const QString &key) const
+{
+    if (cleared)
+        return true;
+    if (removed.isEmpty())
+        return false;
+    if (removed.contains(key))
+        return true;
+
+    // removing a key also removes everything below it
+    for (int i = key.indexOf(QLatin1Char('/')); i != -1; i = key.indexOf(QLatin1Char('/'), i + 1)) {
+        if (removed.contains(QString::fromRawData(key.constData(), i)))
+            return true;
+    }
+    return false;
+}
+
+typedef QHash<QString, QIndexedSettingsFile *> IndexedSettingsFileHash;
+Q_GLOBAL_STATIC(IndexedSettingsFileHash, indexedSettingsFiles)
+static QBasicMutex indexedSettingsFilesMutex;
+
+QIndexedSettingsFile::QIndexedSettingsFile(const QString &fileName, bool _userPerms)
+    : name(fileName), ref(1), userPerms(_userPerms), map(Q_NULLPTR), snapshotSize(0),
+      journalEnd(0), count(0), streamVersion(IndexedStreamVersion), generation(0), stamp(0)
+{
+}
+
+QIndexedSettingsFile::~QIndexedSettingsFile()
+{
+    unload();
+}
+
+/*
+    QIndexedSettingsFile objects are explicitly shared within the
+    application, like QConfFile objects.
+*/
+QIndexedSettingsFile *QIndexedSettingsFile::fromName(const QString &fileName, bool userPerms)
+{
+    const QString absPath = QFileInfo(fileName).absoluteFilePath();
+
+    QMutexLocker locker(&indexedSettingsFilesMutex);
+    IndexedSettingsFileHash *files = indexedSettingsFiles();
+    QIndexedSettingsFile *file = files->value(absPath);
+    if (file) {
+        file->ref.ref();
+    } else {
+        file = new QIndexedSettingsFile(absPath, userPerms);
+        files->insert(absPath, file);
+    }
+    return file;
+}
+
+void QIndexedSettingsFile::release(QIndexedSettingsFile *file)
+{
+    QMutexLocker locker(&indexedSettingsFilesMutex);
+    if (!file->ref.deref()) {
+        if (IndexedSettingsFileHash *files = indexedSettingsFiles())
+            files->remove(file->name);
+        delete file;
+    }
+}
+
+int QIndexedSettingsFile::lowerBound(const QString &key) const
+{
+    int begin = 0;
+    int n = count;
+    while (n > 0) {
+        const int half = n >> 1;
+        const int middle = begin + half;
+        if (keyAt(middle) < key) {
+            begin = middle + 1;
+            n -= half + 1;
+        } else {
+            n = half;
+        }
+    }
+    return begin;
+}
+
+// The returned string refers to the mapped file; it must not outlive it.
+QString QIndexedSettingsFile::keyAt(int i) const
+{
+    const uchar *entry = map + HeaderSize + i * EntrySize;
+    const uchar *key = map + readUInt32(entry);
+    const int length = readUInt32(entry + 4);
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    return QString::fromRawData(reinterpret_cast<const QChar *>(key), length);
+#else
+    return readKey(key, length);
+#endif
+}
+
+QByteArray QIndexedSettingsFile::rawValueAt(int i) const
+{
+    const uchar *entry = map + HeaderSize + i * EntrySize;
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(map + readUInt32(entry + 8)),
+                                   readUInt32(entry + 12));
+}
+
+bool QIndexedSettingsFile::get(const QString &key, QVariant *value) const
+{
+    const QIndexedSettingsLayer *layers[] = { &pending, &journal };
+    for (const QIndexedSettingsLayer *layer : layers) {
+        QMap<QString, QVariant>::const_iterator it = layer->added.constFind(key);
+        if (it != layer->added.constEnd()) {
+            if (value)
+                *value = *it;
+            return true;
+        }
+        if (layer->hides(key))
+            return false;
+    }
+
+    const int i = lowerBound(key);
+    if (i == count || keyAt(i) != key)
+        return false;
+    if (value) {
+        // decoding is much more expensive than the lookup itself
+        QHash<int, QVariant>::const_iterator it = decodedValues.constFind(i);
+        if (it == decodedValues.constEnd())
+            it = decodedValues.insert(i, decodeValue(rawValueAt(i), streamVersion));
+        *value = *it;
+    }
+    return true;
+}
+
+void QIndexedSettingsFile::children(const QString &prefix, QSettingsPrivate::ChildSpec spec,
+                                    QStringList &result) const
+{
+    const int startPos = prefix.size();
+
+    if (!journal.cleared && !pending.cleared) {
+        for (int i = prefix.isEmpty() ? 0 : lowerBound(prefix); i < count; ++i) {
+            const QString key = keyAt(i);
+            if (!key.startsWith(prefix))
+                break;
+            if (!journal.hides(key) && !pending.hides(key))
+                QSettingsPrivate::processChild(key.midRef(startPos), spec, result);
+        }
+    }
+
+    QMap<QString, QVariant>::const_iterator j = journal.added.lowerBound(prefix);
+    while (j != journal.added.constEnd() && j.key().startsWith(prefix)) {
+        if (!pending.hides(j.key()))
+            QSettingsPrivate::processChild(j.key().midRef(startPos), spec, result);
+        ++j;
+    }
+
+    j = pending.added.lowerBound(prefix);
+    while (j != pending.added.constEnd() && j.key().startsWith(prefix)) {
+        QSettingsPrivate::processChild(j.key().midRef(startPos), spec, result);
+        ++j;
+    }
+}
+
+void QIndexedSettingsFile::apply(QIndexedSettingsLayer &layer, const Change &change)
+{
+    switch (change.operation) {
+    case SetOperation:
+        layer.added.insert(change.key, change.value);
+        break;
+    case RemoveOperation: {
+        const QString prefix = change.key + QLatin1Char('/');
+        QMap<QString, QVariant>::iterator i = layer.added.lowerBound(prefix);
+        while (i != layer.added.end() && i.key().startsWith(prefix))
+            i = layer.added.erase(i);
+        layer.added.remove(change.key);
+        layer.removed.insert(change.key);
+        break;
+    }
+    case ClearOperation:
+        layer.reset();
+        layer.cleared = true;
+        break;
+    }
+}
+
+void QIndexedSettingsFile::set(const QString &key, const QVariant &value)
+{
+    Change change = { SetOperation, key, value };
+    pendingChanges.append(change);
+    apply(pending, change);
+}
+
+void QIndexedSettingsFile::remove(const QString &key)
+{
+    Change change = { RemoveOperation, key, QVariant() };
+    pendingChanges.append(change);
+    apply(pending, change);
+}
+
+void QIndexedSettingsFile::clear()
+{
+    // nothing that was changed before matters anymore
+    Change change = { ClearOperation, QString(), QVariant() };
+    pendingChanges.clear();
+    pendingChanges.append(change);
+    apply(pending, change);
+}
+
+void QIndexedSettingsFile::unload()
+{
+    if (map && snapshotCopy.isNull())
+        file->unmap(const_cast<uchar *>(map));
+    file.reset();
+    snapshotCopy.clear();
+    decodedValues.clear();
+    map = Q_NULLPTR;
+    snapshotSize = 0;
+    journalEnd = 0;
+    count = 0;
+    streamVersion = IndexedStreamVersion;
+    generation = 0;
+    stamp = 0;
+    journal.reset();
+}
+
+QSettings::Status QIndexedSettingsFile::load(QFile *newFile)
+{
+    unload();
+    file.reset(newFile);
+
+    QIndexedSettingsHeader header;
+    if (!file->seek(0) || !readHeader(file.data(), &header)) {
+        unload();
+        return QSettings::FormatError;
+    }
+
+    map = file->map(0, header.snapshotSize);
+    if (!map) {
+        // not every file engine supports mapping
+        file->seek(0);
+        snapshotCopy = file->read(header.snapshotSize);
+        if (snapshotCopy.size() != qint64(header.snapshotSize)) {
+            unload();
+            return QSettings::AccessError;
+        }
+        map = reinterpret_cast<const uchar *>(snapshotCopy.constData());
+    }
+
+    // validate the index once, so that lookups don't need to
+    for (quint32 i = 0; i < header.count; ++i) {
+        const uchar *entry = map + HeaderSize + i * EntrySize;
+        const quint64 keyOffset = readUInt32(entry);
+        const quint64 keyEnd = keyOffset + 2 * quint64(readUInt32(entry + 4));
+        const quint64 valueEnd = quint64(readUInt32(entry + 8)) + readUInt32(entry + 12);
+        if ((keyOffset & 1) || keyEnd > header.snapshotSize || valueEnd > header.snapshotSize) {
+            unload();
+            return QSettings::FormatError;
+        }
+    }
+
+    snapshotSize = header.snapshotSize;
+    journalEnd = snapshotSize;
+    count = header.count;
+    streamVersion = header.streamVersion;
+    generation = header.generation;
+    stamp = header.stamp;
+    replayJournal();
+    return QSettings::NoError;
+}
+
+void QIndexedSettingsFile::replayJournal()
+{
+    if (!file->seek(journalEnd))
+        return;
+    const QByteArray records = file->readAll();
+    const uchar *data = reinterpret_cast<const uchar *>(records.constData());
+
+    qint64 pos = 0;
+    while (records.size() - pos >= RecordHeaderSize) {
+        const quint32 size = readUInt32(data + pos);
+        const int operation = qFromLittleEndian<quint16>(data + pos + 4);
+        const quint16 checksum = qFromLittleEndian<quint16>(data + pos + 6);
+        if (size > records.size() - pos - RecordHeaderSize)
+            break;
+
+        const uchar *payload = data + pos + RecordHeaderSize;
+        Change change;
+        if (qChecksum(reinterpret_cast<const char *>(payload), size) != checksum
+            || !readRecord(payload, size, operation, streamVersion, &change))
+            break;
+
+        apply(journal, change);
+        pos += RecordHeaderSize + size;
+    }
+    journalEnd += pos;
+}
+
+QSettings::Status QIndexedSettingsFile::refresh()
+{
+    QScopedPointer<QFile> current(new QFile(name));
+    if (!current->open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        if (current->exists())
+            return QSettings::AccessError;
+        // files that don't exist are treated as empty files
+        unload();
+        return QSettings::NoError;
+    }
+    if (current->size() == 0) {
+        unload();
+        return QSettings::NoError;
+    }
+
+    QIndexedSettingsHeader header;
+    if (!readHeader(current.data(), &header))
+        return QSettings::FormatError;
+
+    if (file && header.generation == generation && header.stamp == stamp) {
+        // same snapshot: only pick up the changes appended since
+        replayJournal();
+        return QSettings::NoError;
+    }
+    return load(current.take());
+}
+
+bool QIndexedSettingsFile::isWritable() const
+{
+    QFileInfo fileInfo(name);
+    if (fileInfo.exists()) {
+        QFile file(name);
+        return file.open(QFile::ReadWrite);
+    }
+
+    // Create the directories to the file.
+    QDir dir(fileInfo.absolutePath());
+    if (!dir.exists() && !dir.mkpath(dir.absolutePath()))
+        return false;
+
+    // we use a temporary file to avoid race conditions
+    QTemporaryFile file(name);
+    return file.open();
+}
+
+/*
+    Writes the pending changes to the file. The caller must hold the lock
+    file and have refreshed the file.
+*/
+QSettings::Status QIndexedSettingsFile::appendJournal()
+{
+    QByteArray records;
+    for (const Change &change : qAsConst(pendingChanges))
+        appendRecord(records, change, streamVersion);
+
+    QFile out(name);
+    if (!out.open(QIODevice::ReadWrite | QIODevice::Unbuffered))
+        return QSettings::AccessError;
+
+    // drop what is left of an earlier write that didn't complete
+    if (out.size() > journalEnd && !out.resize(journalEnd))
+        return QSettings::AccessError;
+    if (!out.seek(journalEnd) || out.write(records) != records.size() || !out.flush())
+        return QSettings::AccessError;
+
+    for (const Change &change : qAsConst(pendingChanges))
+        apply(journal, change);
+    journalEnd += records.size();
+    return QSettings::NoError;
+}
+
+/*
+    Rewrites the file as a snapshot of the current settings, with an empty
+    journal. The caller must hold the lock file and have refreshed the file.
+*/
+QSettings::Status QIndexedSettingsFile::writeSnapshot()
+{
+    QVector<QString> keys;
+    QVector<QByteArray> values;
+    keys.reserve(count + journal.added.size());
+    values.reserve(count + journal.added.size());
+
+    // merge the (sorted) snapshot and the (sorted) journal
+    int i = journal.cleared ? count : 0;
+    QMap<QString, QVariant>::const_iterator j = journal.added.constBegin();
+    while (i < count || j != journal.added.constEnd()) {
+        if (j == journal.added.constEnd() || (i < count && keyAt(i) < j.key())) {
+            const QString key = keyAt(i);
+            if (!journal.hides(key)) {
+                keys.append(key);
+                if (streamVersion == IndexedStreamVersion)
+                    values.append(rawValueAt(i));
+                else
+                    values.append(encodeValue(decodeValue(rawValueAt(i), streamVersion),
+                                              IndexedStreamVersion));
+            }
+            ++i;
+        } else {
+            if (i < count && keyAt(i) == j.key())
+                ++i;
+            keys.append(j.key());
+            values.append(encodeValue(j.value(), IndexedStreamVersion));
+            ++j;
+        }
+    }
+
+    const quint32 n = keys.size();
+    quint64 size = HeaderSize + quint64(n) * EntrySize;
+    for (quint32 k = 0; k < n; ++k)
+        size += 2 * keys.at(k).size() + values.at(k).size();
+    if (size > std::numeric_limits<quint32>::max())
+        return QSettings::AccessError;
+
+    QByteArray data;
+    data.reserve(int(size));
+
+    uchar header[HeaderSize];
+    memcpy(header, indexedMagic, sizeof indexedMagic);
+    qToLittleEndian(quint32(IndexedFormatVersion), header + 4);
+    qToLittleEndian(quint32(IndexedStreamVersion), header + 8);
+    qToLittleEndian(quint32(generation + 1), header + 12);
+    qToLittleEndian(quint32(QDateTime::currentMSecsSinceEpoch()), header + 16);
+    qToLittleEndian(n, header + 20);
+    qToLittleEndian(quint32(size), header + 24);
+    qToLittleEndian(quint32(0), header + 28);
+    data.append(reinterpret_cast<const char *>(header), HeaderSize);
+
+    // all keys come first, so that they are suitably aligned
+    quint32 keyOffset = HeaderSize + n * EntrySize;
+    quint32 valueOffset = keyOffset;
+    for (quint32 k = 0; k < n; ++k)
+        valueOffset += 2 * keys.at(k).size();
+
+    for (quint32 k = 0; k < n; ++k) {
+        const int keySize = keys.at(k).size();
+        const int valueSize = values.at(k).size();
+        uchar entry[EntrySize];
+        qToLittleEndian(keyOffset, entry);
+        qToLittleEndian(quint32(keySize), entry + 4);
+        qToLittleEndian(valueOffset, entry + 8);
+        qToLittleEndian(quint32(valueSize), entry + 12);
+        data.append(reinterpret_cast<const char *>(entry), EntrySize);
+        keyOffset += 2 * keySize;
+        valueOffset += valueSize;
+    }
+
+    for (const QString &key : qAsConst(keys)) {
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        data.append(reinterpret_cast<const char *>(key.constData()), 2 * key.size());
+#else
+        for (QChar c : key) {
+            uchar unit[2];
+            qToLittleEndian(c.unicode(), unit);
+            data.append(reinterpret_cast<const char *>(unit), 2);
+        }
+#endif
+    }
+    for (const QByteArray &value : qAsConst(values))
+        data.append(value);
+    Q_ASSERT(quint64(data.size()) == size);
+
+    // the keys may refer to the mapped file, so drop them before unmapping it
+    keys.clear();
+    values.clear();
+
+    const bool createFile = !QFileInfo::exists(name);
+    QSaveFile sf(name);
+    if (!sf.open(QIODevice::WriteOnly) || sf.write(data) != data.size() || !sf.commit())
+        return QSettings::AccessError;
+
+    // If we have created the file, apply the file perms
+    if (createFile) {
+        QFile::Permissions perms = QFileInfo(name).permissions() | QFile::ReadOwner | QFile::WriteOwner;
+        if (!userPerms)
+            perms |= QFile::ReadGroup | QFile::ReadOther;
+        QFile(name).setPermissions(perms);
+    }
+
+    QFile *newFile = new QFile(name);
+    if (!newFile->open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        delete newFile;
+        unload();
+        return QSettings::AccessError;
+    }
+    return load(newFile);
+}
+
+QSettings::Status QIndexedSettingsFile::sync()
+{
+    if (pendingChanges.isEmpty())
+        return refresh();
+
+    /*
+        Use a lockfile in order to protect us against other QSettings instances
+        trying to write the same settings at the same time. Readers don't need
+        it: the snapshot is never modified in place, and they ignore journal
+        records that are not complete yet.
+    */
+    QLockFile lockFile(name + QLatin1String(".lock"));
+    if (!isWritable() || !lockFile.lock())
+        return QSettings::AccessError;
+
+    QSettings::Status status = refresh();
+    if (status == QSettings::AccessError)
+        return status;
+    if (status == QSettings::FormatError)
+        unload(); // we can't make sense of the file, so replace it
+
+    QSettings::Status writeStatus;
+    if (file) {
+        writeStatus = appendJournal();
+    } else {
+        for (const Change &change : qAsConst(pendingChanges))
+            apply(journal, change);
+        writeStatus = writeSnapshot();
+        if (writeStatus != QSettings::NoError)
+            journal.reset();
+    }
+    if (writeStatus != QSettings::NoError)
+        return writeStatus;
+
+    pendingChanges.clear();
+    pending.reset();
+
+    // compact the file once rewriting it costs less than replaying the journal
+    const qint64 journalSize = journalEnd - snapshotSize;
+    if (journalSize >= MinCompactionSize && journalSize >= snapshotSize / 4) {
+        const QSettings::Status compactStatus = writeSnapshot();
+        if (compactStatus != QSettings::NoError)
+            status = compactStatus;
+    }
+    return status;
+}
+
+QIndexedSettingsPrivate::QIndexedSettingsPrivate(QSettings::Scope scope,
+                                                 const QString &organization,
+                                                 const QString &application)
+    : QSettingsPrivate(QSettings::IndexedFormat, scope, organization, application)
+{
+    for (int i = 0; i < NumConfFiles; ++i)
+        files[i] = Q_NULLPTR;
+
+    QString org = organization;
+    if (org.isEmpty()) {
+        setStatus(QSettings::AccessError);
+        org = QLatin1String("Unknown Organization");
+    }
+
+    const QLatin1String extension(".qsi");
+    QString appFile = org + QDir::separator() + application + extension;
+    QString orgFile = org + extension;
+
+    if (scope == QSettings::UserScope) {
+        QString userPath = settingsPath(QSettings::IndexedFormat, QSettings::UserScope);
+        if (!application.isEmpty())
+            files[F_User | F_Application] = QIndexedSettingsFile::fromName(userPath + appFile, true);
+        files[F_User | F_Organization] = QIndexedSettingsFile::fromName(userPath + orgFile, true);
+    }
+
+    QString systemPath = settingsPath(QSettings::IndexedFormat, QSettings::SystemScope);
+    if (!application.isEmpty())
+        files[F_System | F_Application] = QIndexedSettingsFile::fromName(systemPath + appFile, false);
+    files[F_System | F_Organization] = QIndexedSettingsFile::fromName(systemPath + orgFile, false);
+
+    for (int i = 0; i < NumConfFiles; ++i) {
+        if (files[i]) {
+            spec = i;
+            break;
+        }
+    }
+
+    initAccess();
+}
+
+QIndexedSettingsPrivate::QIndexedSettingsPrivate(const QString &fileName)
+    : QSettingsPrivate(QSettings::IndexedFormat)
+{
+    for (int i = 0; i < NumConfFiles; ++i)
+        files[i] = Q_NULLPTR;
+    files[0] = QIndexedSettingsFile::fromName(fileName, true);
+
+    initAccess();
+}
+
+QIndexedSettingsPrivate::~QIndexedSettingsPrivate()
+{
+    for (int i = 0; i < NumConfFiles; ++i) {
+        if (files[i])
+            QIndexedSettingsFile::release(files[i]);
+    }
+}
+
+void QIndexedSettingsPrivate::initAccess()
+{
+    for (int i = 0; i < NumConfFiles; ++i) {
+        if (QIndexedSettingsFile *file = files[i]) {
+            QMutexLocker locker(&file->mutex);
+            const QSettings::Status status = file->refresh();
+            if (status != QSettings::NoError)
+                setStatus(status);
+            else if (!file->exists() && file->pendingChanges.isEmpty())
+                importIniFile(file);
+        }
+    }
+}
+
+/*
+    Settings that were stored in an INI file before the application
+    switched to IndexedFormat are imported the first time they are
+    accessed. They are written to the new file on the next sync().
+*/
+void QIndexedSettingsPrivate::importIniFile(QIndexedSettingsFile *file)
+{
+    QString iniFileName = file->name;
+    if (!iniFileName.endsWith(QLatin1String(".qsi")))
+        return;
+    iniFileName.chop(4);
+    iniFileName += QLatin1String(".ini");
+    if (!QFileInfo::exists(iniFileName))
+        return;
+
+    QSettings ini(iniFileName, QSettings::IniFormat);
+    const QStringList keys = ini.allKeys();
+    for (const QString &key : keys)
+        file->set(key, ini.value(key));
+    if (!keys.isEmpty())
+        pendingChanges = true;
+}
+
+void QIndexedSettingsPrivate::remove(const QString &key)
+{
+    QIndexedSettingsFile *file = files[spec];
+    if (!file)
+        return;
+
+    QMutexLocker locker(&file->mutex);
+    file->remove(key);
+}
+
+void QIndexedSettingsPrivate::set(const QString &key, const QVariant &value)
+{
+    QIndexedSettingsFile *file = files[spec];
+    if (!file)
+        return;
+
+    QMutexLocker locker(&file->mutex);
+    file->set(key, value);
+}
+
+bool QIndexedSettingsPrivate::get(const QString &key, QVariant *value) const
+{
+    for (int i = 0; i < NumConfFiles; ++i) {
+        if (QIndexedSettingsFile *file = files[i]) {
+            QMutexLocker locker(&file->mutex);
+            if (file->get(key, value))
+                return true;
+            if (!fallbacks)
+                break;
+        }
+    }
+    return false;
+}
+
+QStringList QIndexedSettingsPrivate::children(const QString &prefix, ChildSpec spec) const
+{
+    QStringList result;
+    for (int i = 0; i < NumConfFiles; ++i) {
+        if (QIndexedSettingsFile *file = files[i]) {
+            QMutexLocker locker(&file->mutex);
+            file->children(prefix, spec, result);
+            if (!fallbacks)
+                break;
+        }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()),
+                 result.end());
+    return result;
+}
+
+void QIndexedSettingsPrivate::clear()
+{
+    QIndexedSettingsFile *file = files[spec];
+    if (!file)
+        return;
+
+    QMutexLocker locker(&file->mutex);
+    file->clear();
+}
+
+void QIndexedSettingsPrivate::sync()
+{
+    for (int i = 0; i < NumConfFiles; ++i) {
+        if (QIndexedSettingsFile *file = files[i]) {
+            QMutexLocker locker(&file->mutex);
+            const QSettings::Status status = file->sync();
+            if (status != QSettings::NoError)
+                setStatus(status);
+        }
+    }
+}
+
+void QIndexedSettingsPrivate::flush()
+{
+    sync();
+}
+
+QString QIndexedSettingsPrivate::fileName() const
+{
+    QIndexedSettingsFile *file = files[spec];
+    if (!file)
+        return QString();
+    return file->name;
+}
+
+bool QIndexedSettingsPrivate::isWritable() const
+{
+    QIndexedSettingsFile *file = files[spec];
+    if (!file)
+        return false;
+    return file->isWritable();
+}
+
+QT_END_NAMESPACE
+
+#endif // !QT_NO_SETTINGS && !QT_BOOTSTRAPPED
@@ -632,6 +632,10 @@ QSettingsPrivate *QSettingsPrivate::create(QSettings::Format format,
 #endif
     if (format == QSettings::NativeFormat) {
         return new QMacSettingsPrivate(scope, organization, application);
+#ifndef QT_BOOTSTRAPPED
+    } else if (format == QSettings::IndexedFormat) {
+        return new QIndexedSettingsPrivate(scope, organization, application);
+#endif
     } else {
         return new QConfFileSettingsPrivate(format, scope, organization, application);
     }
@@ -52,11 +52,14 @@
 //
 
 #include "QtCore/qdatetime.h"
+#include "QtCore/qhash.h"
 #include "QtCore/qmap.h"
 #include "QtCore/qmutex.h"
+#include "QtCore/qset.h"
 #include "QtCore/qiodevice.h"
 #include "QtCore/qstack.h"
 #include "QtCore/qstringlist.h"
+#include "QtCore/qvector.h"
 #ifndef QT_NO_QOBJECT
 #include "private/qobject_p.h"
 #endif
@@ -217,6 +220,7 @@ public:
     static QSettingsPrivate *create(QSettings::Format format, QSettings::Scope scope,
                                         const QString &organization, const QString &application);
     static QSettingsPrivate *create(const QString &fileName, QSettings::Format format);
+    static QString settingsPath(QSettings::Format format, QSettings::Scope scope);
 
     static void processChild(QStringRef key, ChildSpec spec, QStringList &result);
 
@@ -310,6 +314,120 @@ private:
     int nextPosition;
 };
 
+#ifndef QT_BOOTSTRAPPED
+class QFile;
+
+/*
+    One layer of changes on top of the key index of a QIndexedSettingsFile:
+    the keys that were set, the keys that were removed (together with
+    everything below them) and whether everything was cleared. A layer
+    hides the removed keys of the layers below it.
+*/
+struct QIndexedSettingsLayer
+{
+    QIndexedSettingsLayer() : cleared(false) {}
+
+    bool isEmpty() const { return !cleared && added.isEmpty() && removed.isEmpty(); }
+    void reset() { added.clear(); removed.clear(); cleared = false; }
+    bool hides(const QString &key) const;
+
+    QMap<QString, QVariant> added;
+    QSet<QString> removed;
+    bool cleared;
+};
+
+class Q_AUTOTEST_EXPORT QIndexedSettingsFile
+{
+public:
+    enum Operation { SetOperation = 1, RemoveOperation, ClearOperation };
+    struct Change
+    {
+        Operation operation;
+        QString key;
+        QVariant value;
+    };
+
+    ~QIndexedSettingsFile();
+
+    static QIndexedSettingsFile *fromName(const QString &name, bool userPerms);
+    static void release(QIndexedSettingsFile *file);
+
+    bool get(const QString &key, QVariant *value) const;
+    void children(const QString &prefix, QSettingsPrivate::ChildSpec spec,
+                  QStringList &result) const;
+
+    void set(const QString &key, const QVariant &value);
+    void remove(const QString &key);
+    void clear();
+
+    QSettings::Status refresh();
+    QSettings::Status sync();
+    bool isWritable() const;
+    bool exists() const { return !file.isNull(); }
+
+    QString name;
+    QVector<Change> pendingChanges;
+    QAtomicInt ref;
+    mutable QMutex mutex;
+    bool userPerms;
+
+private:
+    QIndexedSettingsFile(const QString &name, bool userPerms);
+    Q_DISABLE_COPY(QIndexedSettingsFile)
+
+    QSettings::Status load(QFile *newFile);
+    void unload();
+    void replayJournal();
+    QSettings::Status appendJournal();
+    QSettings::Status writeSnapshot();
+
+    int lowerBound(const QString &key) const;
+    QString keyAt(int i) const;
+    QByteArray rawValueAt(int i) const;
+    static void apply(QIndexedSettingsLayer &layer, const Change &change);
+
+    QScopedPointer<QFile> file;
+    QByteArray snapshotCopy;
+    const uchar *map;
+    qint64 snapshotSize;
+    qint64 journalEnd;
+    int count;
+    int streamVersion;
+    quint32 generation;
+    quint32 stamp;
+    mutable QHash<int, QVariant> decodedValues;
+    QIndexedSettingsLayer journal;
+    QIndexedSettingsLayer pending;
+};
+
+class QIndexedSettingsPrivate : public QSettingsPrivate
+{
+public:
+    QIndexedSettingsPrivate(QSettings::Scope scope,
+                            const QString &organization, const QString &application);
+    QIndexedSettingsPrivate(const QString &fileName);
+    ~QIndexedSettingsPrivate();
+
+    void remove(const QString &key) Q_DECL_OVERRIDE;
+    void set(const QString &key, const QVariant &value) Q_DECL_OVERRIDE;
+    bool get(const QString &key, QVariant *value) const Q_DECL_OVERRIDE;
+
+    QStringList children(const QString &prefix, ChildSpec spec) const Q_DECL_OVERRIDE;
+
+    void clear() Q_DECL_OVERRIDE;
+    void sync() Q_DECL_OVERRIDE;
+    void flush() Q_DECL_OVERRIDE;
+    bool isWritable() const Q_DECL_OVERRIDE;
+    QString fileName() const Q_DECL_OVERRIDE;
+
+private:
+    void initAccess();
+    void importIniFile(QIndexedSettingsFile *file);
+
+    QIndexedSettingsFile *files[NumConfFiles];
+};
+#endif // QT_BOOTSTRAPPED
+
 QT_END_NAMESPACE
 
 #endif // QSETTINGS_P_H
@@ -868,6 +868,10 @@ QSettingsPrivate *QSettingsPrivate::create(QSettings::Format format, QSettings::
         return new QWinSettingsPrivate(scope, organization, application, KEY_WOW64_32KEY);
     else if (format == QSettings::Registry64Format)
         return new QWinSettingsPrivate(scope, organization, application, KEY_WOW64_64KEY);
+#ifndef QT_BOOTSTRAPPED
+    else if (format == QSettings::IndexedFormat)
+        return new QIndexedSettingsPrivate(scope, organization, application);
+#endif
     else
         return new QConfFileSettingsPrivate(format, scope, organization, application);
 }
@@ -880,6 +884,10 @@ QSettingsPrivate *QSettingsPrivate::create(const QString &fileName, QSettings::F
         return new QWinSettingsPrivate(fileName, KEY_WOW64_32KEY);
     else if (format == QSettings::Registry64Format)
         return new QWinSettingsPrivate(fileName, KEY_WOW64_64KEY);
+#ifndef QT_BOOTSTRAPPED
+    else if (format == QSettings::IndexedFormat)
+        return new QIndexedSettingsPrivate(fileName);
+#endif
     else
         return new QConfFileSettingsPrivate(fileName, format);
 }
@@ -677,6 +677,8 @@ QSettingsPrivate *QSettingsPrivate::create(QSettings::Format format, QSettings::
 {
     if (format == QSettings::NativeFormat)
         return new QWinRTSettingsPrivate(scope, organization, application);
+    else if (format == QSettings::IndexedFormat)
+        return new QIndexedSettingsPrivate(scope, organization, application);
     else
         return new QConfFileSettingsPrivate(format, scope, organization, application);
 }
@@ -685,6 +687,8 @@ QSettingsPrivate *QSettingsPrivate::create(const QString &fileName, QSettings::F
 {
     if (format == QSettings::NativeFormat)
         return new QWinRTSettingsPrivate(fileName);
+    else if (format == QSettings::IndexedFormat)
+        return new QIndexedSettingsPrivate(fileName);
     else
         return new QConfFileSettingsPrivate(fileName, format);
 }
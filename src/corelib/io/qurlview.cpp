@@ -0,0 +1,610 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qurlview.h"
+
+#include "qvarlengtharray.h"
+#include "private/qtools_p.h"
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QUrlView
+    \inmodule QtCore
+    \since 5.8
+    \ingroup io
+    \ingroup network
+
+    \brief The QUrlView class splits an encoded URL into its components
+    without copying it.
+
+    \reentrant
+
+    QUrlView is meant for code that handles many URLs that arrive as
+    bytes, such as the request targets read by an HTTP server. Unlike
+    QUrl, it doesn't allocate memory, decode or validate the components
+    when it parses a URL: it only records where each component starts and
+    ends in the original data. The components are returned in their
+    encoded form, as QLatin1String objects that point into that data, and
+    decoded only on request with decoded(). The data must therefore stay
+    valid and unchanged for as long as the view and the strings returned
+    by it are used.
+
+    The URL is split following \l{RFC 3986} in the same way that QUrl
+    does:
+
+    \code
+        const QByteArray target = "http://user@example.com:8080/search?q=qt%20url&page=2#top";
+        QUrlView url(target);
+        url.scheme();       // "http"
+        url.userName();     // "user"
+        url.host();         // "example.com"
+        url.port();         // 8080
+        url.path();         // "/search"
+        url.query();        // "q=qt%20url&page=2"
+        url.fragment();     // "top"
+        QUrlView::decoded(url.queryItemValue(QLatin1String("q"))); // "qt url"
+    \endcode
+
+    The bytes of a URL that contains characters outside of US-ASCII (an
+    IRI) are interpreted as UTF-8 when decoded. The QLatin1String objects
+    returned by QUrlView hold those bytes unchanged, so they should be
+    compared only with ASCII strings.
+
+    The query can be iterated over with queryBegin() and queryEnd(), which
+    split it into key-value pairs at the same delimiters that QUrlQuery
+    uses by default, without creating a list of the pairs.
+
+    \sa QUrl, QUrlQuery
+*/
+
+/*!
+    \class QUrlView::QueryItem
+    \inmodule QtCore
+    \since 5.8
+
+    \brief The QueryItem class holds a key-value pair of the query of a
+    QUrlView.
+
+    Both the key and the value are in encoded form. hasValue is \c false
+    if the pair had no value delimiter at all (as in \c{"?key"}), which
+    QUrlQuery reports as a null value.
+*/
+
+/*!
+    \class QUrlView::QueryIterator
+    \inmodule QtCore
+    \since 5.8
+
+    \brief The QueryIterator class is a forward iterator over the key-value
+    pairs of the query of a QUrlView.
+
+    \sa QUrlView::queryBegin(), QUrlView::queryEnd()
+*/
+
+static inline bool isHexDigit(uchar c)
+{
+    return QtMiscUtils::fromHex(c) >= 0;
+}
+
+// RFC 3986 requires a letter first, but QUrl only rejects a digit there
+static inline bool isSchemeCharacter(uchar c, bool first)
+{
+    if ((c | 0x20) >= 'a' && (c | 0x20) <= 'z')
+        return true;
+    if (c >= '0' && c <= '9')
+        return !first;
+    return c == '+' || c == '-' || c == '.';
+}
+
+/*!
+    Constructs a null QUrlView.
+*/
+QUrlView::QUrlView() Q_DECL_NOTHROW
+    : m_data(Q_NULLPTR), m_size(0)
+{
+    parse();
+}
+
+/*!
+    Constructs a QUrlView of the \a size bytes of the encoded URL starting
+    at \a url. The data is not copied.
+*/
+QUrlView::QUrlView(const char *url, int size) Q_DECL_NOTHROW
+    : m_data(url), m_size(size)
+{
+    parse();
+}
+
+/*!
+    Constructs a QUrlView of the encoded URL held by \a url. The data is not
+    copied, so \a url must not be modified or destroyed while the view is in
+    use. For the same reason, temporary byte arrays are rejected at compile
+    time.
+*/
+QUrlView::QUrlView(const QByteArray &url) Q_DECL_NOTHROW
+    : m_data(url.constData()), m_size(url.size())
+{
+    parse();
+}
+
+/*!
+    \internal
+
+    Finds the components like QUrlPrivate::parse() does and validates
+    the encoding.
+*/
+void QUrlView::parse() Q_DECL_NOTHROW
+{
+    m_schemeEnd = -1;
+    m_authorityStart = -1;
+    m_userInfoEnd = -1;
+    m_passwordStart = -1;
+    m_hostStart = -1;
+    m_hostEnd = -1;
+    m_port = -1;
+    m_queryStart = -1;
+    m_queryEnd = -1;
+    m_fragmentStart = -1;
+    m_valid = true;
+
+    const uchar *data = reinterpret_cast<const uchar *>(m_data);
+    int colon = -1;
+    int question = -1;
+    for (int i = 0; i < m_size; ++i) {
+        const uchar c = data[i];
+        if (c <= ' ' || c == 0x7f) {
+            // controls and spaces must be encoded
+            m_valid = false;
+        } else if (c == '%') {
+            if (i + 2 >= m_size || !isHexDigit(data[i + 1]) || !isHexDigit(data[i + 2]))
+                m_valid = false;
+        } else if (m_fragmentStart < 0) {
+            if (c == '#')
+                m_fragmentStart = i + 1;
+            else if (question >= 0)
+                continue;
+            else if (c == ':' && colon < 0)
+                colon = i;
+            else if (c == '?')
+                question = i;
+        }
+    }
+
+    const int hierEnd = question >= 0 ? question : m_fragmentStart >= 0 ? m_fragmentStart - 1 : m_size;
+    if (question >= 0) {
+        m_queryStart = question + 1;
+        m_queryEnd = m_fragmentStart >= 0 ? m_fragmentStart - 1 : m_size;
+    }
+
+    // a scheme is only a scheme if it doesn't start with a digit and all of
+    // its characters are valid
+    int hierStart = 0;
+    if (colon >= 0) {
+        bool isScheme = colon > 0;
+        for (int i = 0; i < colon && isScheme; ++i)
+            isScheme = isSchemeCharacter(data[i], i == 0);
+        if (isScheme) {
+            m_schemeEnd = colon;
+            hierStart = colon + 1;
+        } else if (!memchr(data, '/', colon)) {
+            // QUrl rejects relative paths with a colon in the first segment
+            m_valid = false;
+        }
+    }
+
+    m_pathStart = hierStart;
+    if (hierEnd - hierStart >= 2 && data[hierStart] == '/' && data[hierStart + 1] == '/') {
+        m_authorityStart = hierStart + 2;
+        const void *slash = memchr(data + m_authorityStart, '/', hierEnd - m_authorityStart);
+        m_pathStart = slash ? int(static_cast<const uchar *>(slash) - data) : hierEnd;
+        parseAuthority();
+    }
+    m_pathEnd = hierEnd;
+}
+
+/*!
+    \internal
+
+    Splits the authority like QUrlPrivate::setAuthority() does.
+*/
+void QUrlView::parseAuthority() Q_DECL_NOTHROW
+{
+    const char *const authority = m_data + m_authorityStart;
+    const int length = m_pathStart - m_authorityStart;
+
+    m_hostStart = m_authorityStart;
+    const void *at = memchr(authority, '@', length);
+    if (at) {
+        m_userInfoEnd = int(static_cast<const char *>(at) - m_data);
+        const void *colon = memchr(authority, ':', m_userInfoEnd - m_authorityStart);
+        if (colon)
+            m_passwordStart = int(static_cast<const char *>(colon) - m_data) + 1;
+        m_hostStart = m_userInfoEnd + 1;
+    }
+
+    m_hostEnd = m_pathStart;
+    int colon = -1;
+    for (int i = m_pathStart - 1; i >= m_hostStart; --i) {
+        if (m_data[i] == ':') {
+            colon = i;
+            break;
+        }
+    }
+
+    if (m_hostStart < m_pathStart && m_data[m_hostStart] == '[') {
+        // an IP literal; the port colon must follow the closing bracket
+        const void *bracket = memchr(m_data + m_hostStart, ']', m_pathStart - m_hostStart);
+        if (!bracket) {
+            m_valid = false;
+            return;
+        }
+        const int closingBracket = int(static_cast<const char *>(bracket) - m_data);
+        if (colon < closingBracket)
+            colon = -1;
+        if (closingBracket + 1 != (colon < 0 ? m_pathStart : colon))
+            m_valid = false;
+    }
+
+    if (colon >= 0) {
+        m_hostEnd = colon;
+        uint port = colon + 1 == m_pathStart ? uint(-1) : 0; // no digits after the colon
+        for (int i = colon + 1; i < m_pathStart && port <= 0xffff; ++i) {
+            const uint digit = uint(m_data[i]) - '0';
+            if (digit > 9) {
+                port = uint(-1);
+                break;
+            }
+            port = port * 10 + digit;
+        }
+        if (port <= 0xffff)
+            m_port = int(port);
+        else
+            m_valid = false;
+    }
+
+    if (m_valid && m_hostStart < m_hostEnd && m_data[m_hostStart] == '[') {
+        // return the IP literal without its brackets, like QUrl::host()
+        ++m_hostStart;
+        --m_hostEnd;
+    }
+}
+
+/*!
+    \fn bool QUrlView::isNull() const
+
+    Returns \c true if this view was constructed with no data.
+*/
+
+/*!
+    \fn bool QUrlView::isEmpty() const
+
+    Returns \c true if the URL is empty.
+*/
+
+/*!
+    \fn bool QUrlView::isValid() const
+
+    Returns \c true if the URL is well-formed: it contains no spaces or
+    control characters, every percent sign starts a valid escape sequence,
+    the port is a number between 0 and 65535, IP literals in the host
+    are enclosed in brackets and, like QUrl requires, the first segment of a
+    relative path contains no colon.
+
+    Unlike QUrl::isValid(), this function doesn't check that the
+    individual components contain only the characters allowed by RFC 3986.
+*/
+
+/*!
+    \fn bool QUrlView::isRelative() const
+
+    Returns \c true if the URL has no scheme.
+*/
+
+/*!
+    \fn QLatin1String QUrlView::url() const
+
+    Returns the whole URL.
+*/
+
+/*!
+    \fn bool QUrlView::hasScheme() const
+
+    Returns \c true if the URL has a scheme.
+*/
+
+/*!
+    \fn QLatin1String QUrlView::scheme() const
+
+    Returns the scheme of the URL, without the trailing colon. Unlike
+    QUrl::scheme(), the scheme is not converted to lowercase.
+*/
+
+/*!
+    \fn bool QUrlView::hasAuthority() const
+
+    Returns \c true if the URL has an authority, that is, if the part
+    following the scheme starts with two slashes.
+*/
+
+/*!
+    \fn QLatin1String QUrlView::authority() const
+
+    Returns the encoded authority of the URL.
+*/
+
+/*!
+    \fn bool QUrlView::hasUserInfo() const
+
+    Returns \c true if the authority contains user information.
+*/
+
+/*!
+    \fn QLatin1String QUrlView::userInfo() const
+
+    Returns the encoded user information (the user name and password) of
+    the URL.
+*/
+
+/*!
+    Returns the encoded user name of the URL.
+*/
+QLatin1String QUrlView::userName() const Q_DECL_NOTHROW
+{
+    return section(m_authorityStart, m_passwordStart >= 0 ? m_passwordStart - 1 : m_userInfoEnd);
+}
+
+/*!
+    \fn bool QUrlView::hasPassword() const
+
+    Returns \c true if the user information contains a password.
+*/
+
+/*!
+    \fn QLatin1String QUrlView::password() const
+
+    Returns the encoded password of the URL.
+*/
+
+/*!
+    \fn QLatin1String QUrlView::host() const
+
+    Returns the encoded host of the URL. The brackets around IP literals
+    are removed. Unlike QUrl::host(), the host is not normalized.
+*/
+
+/*!
+    \fn int QUrlView::port(int defaultPort) const
+
+    Returns the port of the URL, or \a defaultPort if the URL doesn't
+    specify one.
+*/
+
+/*!
+    \fn QLatin1String QUrlView::path() const
+
+    Returns the encoded path of the URL.
+*/
+
+/*!
+    \fn bool QUrlView::hasQuery() const
+
+    Returns \c true if the URL has a query, even if it is empty.
+*/
+
+/*!
+    \fn QLatin1String QUrlView::query() const
+
+    Returns the encoded query of the URL, without the leading question
+    mark.
+*/
+
+/*!
+    Returns an iterator to the first key-value pair of the query.
+
+    \sa queryEnd()
+*/
+QUrlView::QueryIterator QUrlView::queryBegin() const Q_DECL_NOTHROW
+{
+    if (m_queryStart < 0)
+        return QueryIterator();
+    return QueryIterator(m_data + m_queryStart, m_data + m_queryEnd);
+}
+
+/*!
+    Returns an iterator past the last key-value pair of the query.
+
+    \sa queryBegin()
+*/
+QUrlView::QueryIterator QUrlView::queryEnd() const Q_DECL_NOTHROW
+{
+    if (m_queryStart < 0)
+        return QueryIterator();
+    return QueryIterator(m_data + m_queryEnd, m_data + m_queryEnd);
+}
+
+/*!
+    Returns \c true if the query contains a pair whose encoded key is \a key.
+*/
+bool QUrlView::hasQueryItem(QLatin1String key) const Q_DECL_NOTHROW
+{
+    for (QueryIterator it = queryBegin(), end = queryEnd(); it != end; ++it) {
+        if (it->key == key)
+            return true;
+    }
+    return false;
+}
+
+/*!
+    Returns the encoded value of the first pair in the query whose encoded
+    key is \a key, or a null string if there is no such pair.
+
+    \sa decoded()
+*/
+QLatin1String QUrlView::queryItemValue(QLatin1String key) const Q_DECL_NOTHROW
+{
+    for (QueryIterator it = queryBegin(), end = queryEnd(); it != end; ++it) {
+        if (it->key == key)
+            return it->value;
+    }
+    return QLatin1String();
+}
+
+/*!
+    \fn bool QUrlView::hasFragment() const
+
+    Returns \c true if the URL has a fragment, even if it is empty.
+*/
+
+/*!
+    \fn QLatin1String QUrlView::fragment() const
+
+    Returns the encoded fragment of the URL, without the leading hash
+    sign.
+*/
+
+/*!
+    Returns a QUrl for this URL, parsed in \a mode.
+*/
+QUrl QUrlView::toUrl(QUrl::ParsingMode mode) const
+{
+    return QUrl(QString::fromUtf8(m_data, m_size), mode);
+}
+
+/*!
+    Returns the encoded \a component, such as a path or a query value
+    returned by this class, with its percent-encoded sequences decoded
+    and its bytes interpreted as UTF-8.
+
+    Components that contain no percent-encoded sequences are converted
+    without a temporary buffer.
+
+    \sa decode(), QUrl::fromPercentEncoding()
+*/
+QString QUrlView::decoded(QLatin1String component)
+{
+    const char *data = component.data();
+    const int size = component.size();
+    if (!size || !memchr(data, '%', size))
+        return QString::fromUtf8(data, size);
+
+    QVarLengthArray<char, 256> buffer(size);
+    return QString::fromUtf8(buffer.constData(), decode(component, buffer.data()));
+}
+
+/*!
+    Writes \a component with its percent-encoded sequences decoded to \a
+    buffer, which must have room for at least \c{component.size()} bytes,
+    and returns the number of bytes written. Invalid sequences are copied
+    unchanged.
+
+    \sa decoded()
+*/
+int QUrlView::decode(QLatin1String component, char *buffer) Q_DECL_NOTHROW
+{
+    const char *in = component.data();
+    const char *const end = in + component.size();
+    char *out = buffer;
+    while (in != end) {
+        const char *percent = static_cast<const char *>(memchr(in, '%', end - in));
+        if (!percent)
+            percent = end;
+        memcpy(out, in, percent - in);
+        out += percent - in;
+        in = percent;
+        if (in == end)
+            break;
+
+        if (end - in >= 3 && isHexDigit(in[1]) && isHexDigit(in[2])) {
+            *out++ = char(QtMiscUtils::fromHex(in[1]) << 4 | QtMiscUtils::fromHex(in[2]));
+            in += 3;
+        } else {
+            *out++ = *in++;
+        }
+    }
+    return int(out - buffer);
+}
+
+/*!
+    \internal
+*/
+QUrlView::QueryIterator::QueryIterator(const char *begin, const char *end) Q_DECL_NOTHROW
+    : m_pos(begin), m_end(end), m_next(begin)
+{
+    m_item.hasValue = false;
+    if (m_pos != m_end)
+        parseItem();
+}
+
+/*!
+    \internal
+
+    Splits the pair at m_pos like QUrlQueryPrivate::setQuery() does.
+*/
+void QUrlView::QueryIterator::parseItem() Q_DECL_NOTHROW
+{
+    const char *pairEnd = static_cast<const char *>(memchr(m_pos, '&', m_end - m_pos));
+    if (!pairEnd)
+        pairEnd = m_end;
+    const char *delimiter = static_cast<const char *>(memchr(m_pos, '=', pairEnd - m_pos));
+
+    m_item.hasValue = delimiter != Q_NULLPTR;
+    if (delimiter) {
+        m_item.key = QLatin1String(m_pos, int(delimiter - m_pos));
+        m_item.value = QLatin1String(delimiter + 1, int(pairEnd - delimiter - 1));
+    } else {
+        m_item.key = QLatin1String(m_pos, int(pairEnd - m_pos));
+        m_item.value = QLatin1String();
+    }
+    m_next = pairEnd == m_end ? m_end : pairEnd + 1;
+}
+
+/*!
+    \internal
+*/
+void QUrlView::QueryIterator::advance() Q_DECL_NOTHROW
+{
+    m_pos = m_next;
+    if (m_pos != m_end)
+        parseItem();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,166 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QURLVIEW_H
+#define QURLVIEW_H
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qurl.h>
+
+#include <iterator>
+
+QT_BEGIN_NAMESPACE
+
+class Q_CORE_EXPORT QUrlView
+{
+public:
+    struct QueryItem
+    {
+        QLatin1String key;
+        QLatin1String value;
+        bool hasValue;
+    };
+
+    class QueryIterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef QueryItem value_type;
+        typedef qptrdiff difference_type;
+        typedef const QueryItem *pointer;
+        typedef const QueryItem &reference;
+
+        QueryIterator() Q_DECL_NOTHROW
+            : m_pos(Q_NULLPTR), m_end(Q_NULLPTR), m_next(Q_NULLPTR)
+        { m_item.hasValue = false; }
+
+        const QueryItem &operator*() const Q_DECL_NOTHROW { return m_item; }
+        const QueryItem *operator->() const Q_DECL_NOTHROW { return &m_item; }
+
+        QueryIterator &operator++() Q_DECL_NOTHROW { advance(); return *this; }
+        QueryIterator operator++(int) Q_DECL_NOTHROW { QueryIterator copy = *this; advance(); return copy; }
+
+        bool operator==(const QueryIterator &other) const Q_DECL_NOTHROW { return m_pos == other.m_pos; }
+        bool operator!=(const QueryIterator &other) const Q_DECL_NOTHROW { return m_pos != other.m_pos; }
+
+    private:
+        friend class QUrlView;
+        QueryIterator(const char *begin, const char *end) Q_DECL_NOTHROW;
+        void advance() Q_DECL_NOTHROW;
+        void parseItem() Q_DECL_NOTHROW;
+
+        const char *m_pos;
+        const char *m_end;
+        const char *m_next;
+        QueryItem m_item;
+    };
+
+    QUrlView() Q_DECL_NOTHROW;
+    QUrlView(const char *url, int size) Q_DECL_NOTHROW;
+    explicit QUrlView(const QByteArray &url) Q_DECL_NOTHROW;
+    // the view would dangle:
+    explicit QUrlView(const QByteArray &&) Q_DECL_EQ_DELETE;
+
+    bool isNull() const Q_DECL_NOTHROW { return !m_data; }
+    bool isEmpty() const Q_DECL_NOTHROW { return !m_size; }
+    bool isValid() const Q_DECL_NOTHROW { return m_valid; }
+    bool isRelative() const Q_DECL_NOTHROW { return m_schemeEnd < 0; }
+
+    QLatin1String url() const Q_DECL_NOTHROW { return QLatin1String(m_data, m_size); }
+
+    bool hasScheme() const Q_DECL_NOTHROW { return m_schemeEnd >= 0; }
+    QLatin1String scheme() const Q_DECL_NOTHROW { return section(0, m_schemeEnd); }
+
+    bool hasAuthority() const Q_DECL_NOTHROW { return m_authorityStart >= 0; }
+    QLatin1String authority() const Q_DECL_NOTHROW { return section(m_authorityStart, m_pathStart); }
+    bool hasUserInfo() const Q_DECL_NOTHROW { return m_userInfoEnd >= 0; }
+    QLatin1String userInfo() const Q_DECL_NOTHROW { return section(m_authorityStart, m_userInfoEnd); }
+    QLatin1String userName() const Q_DECL_NOTHROW;
+    bool hasPassword() const Q_DECL_NOTHROW { return m_passwordStart >= 0; }
+    QLatin1String password() const Q_DECL_NOTHROW { return section(m_passwordStart, m_userInfoEnd); }
+    QLatin1String host() const Q_DECL_NOTHROW { return section(m_hostStart, m_hostEnd); }
+    int port(int defaultPort = -1) const Q_DECL_NOTHROW { return m_port < 0 ? defaultPort : m_port; }
+
+    QLatin1String path() const Q_DECL_NOTHROW { return section(m_pathStart, m_pathEnd); }
+
+    bool hasQuery() const Q_DECL_NOTHROW { return m_queryStart >= 0; }
+    QLatin1String query() const Q_DECL_NOTHROW { return section(m_queryStart, m_queryEnd); }
+    QueryIterator queryBegin() const Q_DECL_NOTHROW;
+    QueryIterator queryEnd() const Q_DECL_NOTHROW;
+    bool hasQueryItem(QLatin1String key) const Q_DECL_NOTHROW;
+    QLatin1String queryItemValue(QLatin1String key) const Q_DECL_NOTHROW;
+
+    bool hasFragment() const Q_DECL_NOTHROW { return m_fragmentStart >= 0; }
+    QLatin1String fragment() const Q_DECL_NOTHROW { return section(m_fragmentStart, m_size); }
+
+    QUrl toUrl(QUrl::ParsingMode mode = QUrl::TolerantMode) const;
+
+    static QString decoded(QLatin1String component);
+    static int decode(QLatin1String component, char *buffer) Q_DECL_NOTHROW;
+
+private:
+    void parse() Q_DECL_NOTHROW;
+    void parseAuthority() Q_DECL_NOTHROW;
+    QLatin1String section(int from, int to) const Q_DECL_NOTHROW
+    { return (from | to) < 0 ? QLatin1String() : QLatin1String(m_data + from, to - from); }
+
+    const char *m_data;
+    int m_size;
+    int m_schemeEnd;
+    int m_authorityStart;
+    int m_userInfoEnd;
+    int m_passwordStart;
+    int m_hostStart;
+    int m_hostEnd;
+    int m_port;
+    int m_pathStart;
+    int m_pathEnd;
+    int m_queryStart;
+    int m_queryEnd;
+    int m_fragmentStart;
+    bool m_valid;
+};
+
+Q_DECLARE_TYPEINFO(QUrlView, Q_PRIMITIVE_TYPE);
+Q_DECLARE_TYPEINFO(QUrlView::QueryItem, Q_PRIMITIVE_TYPE);
+
+QT_END_NAMESPACE
+
+#endif // QURLVIEW_H
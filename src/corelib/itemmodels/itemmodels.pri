@@ -3,6 +3,7 @@
 HEADERS += \
     itemmodels/qabstractitemmodel.h \
     itemmodels/qabstractitemmodel_p.h \
+    itemmodels/qabstractmodelfetcher.h \
     itemmodels/qabstractproxymodel.h \
     itemmodels/qabstractproxymodel_p.h \
     itemmodels/qitemselectionmodel.h \
@@ -13,6 +14,7 @@ HEADERS += \
 
 SOURCES += \
     itemmodels/qabstractitemmodel.cpp \
+    itemmodels/qabstractmodelfetcher.cpp \
     itemmodels/qabstractproxymodel.cpp \
     itemmodels/qitemselectionmodel.cpp \
     itemmodels/qidentityproxymodel.cpp \
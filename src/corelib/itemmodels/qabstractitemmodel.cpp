@@ -48,6 +48,7 @@
 #include <qstack.h>
 #include <qbitarray.h>
 
+#include <algorithm>
 #include <limits.h>
 
 QT_BEGIN_NAMESPACE
@@ -64,6 +65,7 @@ QPersistentModelIndexData *QPersistentModelIndexData::create(const QModelIndex &
     } else {
         d = new QPersistentModelIndexData(index);
         indexes.insert(index, d);
+        model->d_func()->persistent.addUnclassified(d);
     }
     Q_ASSERT(d);
     return d;
@@ -507,8 +509,10 @@ void QAbstractItemModelPrivate::invalidatePersistentIndexes()
     for (QPersistentModelIndexData *data : qAsConst(persistent.indexes)) {
         data->index = QModelIndex();
         data->model = 0;
+        data->topLevelPosition = QPersistentModelIndexData::NotTopLevel;
     }
     persistent.indexes.clear();
+    persistent.clearTopLevel();
 }
 
 /*!
@@ -521,6 +525,7 @@ void QAbstractItemModelPrivate::invalidatePersistentIndex(const QModelIndex &ind
     if (it != persistent.indexes.cend()) {
         QPersistentModelIndexData *data = *it;
         persistent.indexes.erase(it);
+        persistent.removeFromTopLevel(data);
         data->index = QModelIndex();
         data->model = 0;
     }
@@ -600,6 +605,7 @@ void QAbstractItemModelPrivate::removePersistentIndexData(QPersistentModelIndexD
         // This assert may happen if the model use changePersistentIndex in a way that could result on two
         // QPersistentModelIndex pointing to the same index.
         Q_UNUSED(removed);
+        persistent.removeFromTopLevel(data);
     }
     // make sure our optimization still works
     for (int i = persistent.moved.count() - 1; i >= 0; --i) {
@@ -623,12 +629,18 @@ void QAbstractItemModelPrivate::rowsAboutToBeInserted(const QModelIndex &parent,
     Q_UNUSED(last);
     QVector<QPersistentModelIndexData *> persistent_moved;
     if (first < q->rowCount(parent)) {
-        for (QHash<QModelIndex, QPersistentModelIndexData *>::const_iterator it = persistent.indexes.constBegin();
-             it != persistent.indexes.constEnd(); ++it) {
-            QPersistentModelIndexData *data = *it;
-            const QModelIndex &index = data->index;
-            if (index.row() >= first && index.isValid() && index.parent() == parent) {
-                persistent_moved.append(data);
+        if (!parent.isValid()) {
+            for (int i = persistent.topLevelLowerBound(first); i < persistent.topLevel.size(); ++i) {
+                if (QPersistentModelIndexData *data = persistent.topLevel.at(i))
+                    persistent_moved.append(data);
+            }
+        } else if (persistent.hasNested()) {
+            for (QHash<QModelIndex, QPersistentModelIndexData *>::const_iterator it = persistent.indexes.constBegin();
+                 it != persistent.indexes.constEnd(); ++it) {
+                QPersistentModelIndexData *data = *it;
+                const QModelIndex &index = data->index;
+                if (!data->isTopLevel() && index.row() >= first && index.isValid() && index.parent() == parent)
+                    persistent_moved.append(data);
             }
         }
     }
@@ -640,18 +652,25 @@ void QAbstractItemModelPrivate::rowsInserted(const QModelIndex &parent,
 {
     QVector<QPersistentModelIndexData *> persistent_moved = persistent.moved.pop();
     int count = (last - first) + 1; // it is important to only use the delta, because the change could be nested
-    for (QVector<QPersistentModelIndexData *>::const_iterator it = persistent_moved.constBegin();
-         it != persistent_moved.constEnd(); ++it) {
+    // moving all top-level rows from first onwards keeps them in order
+    const bool inPlace = !parent.isValid() && persistent.isTopLevelTail(persistent_moved, first);
+    // the top-level indexes are in row order, move the last one first so that
+    // none is moved onto one which has not been moved yet
+    for (QVector<QPersistentModelIndexData *>::const_reverse_iterator it = persistent_moved.crbegin();
+         it != persistent_moved.crend(); ++it) {
         QPersistentModelIndexData *data = *it;
         QModelIndex old = data->index;
-        persistent.indexes.erase(persistent.indexes.constFind(old));
+        persistent.remove(data, inPlace);
         data->index = q_func()->index(old.row() + count, old.column(), parent);
         if (data->index.isValid()) {
-            persistent.insertMultiAtEnd(data->index, data);
+            persistent.insert(data, parent, inPlace);
         } else {
+            persistent.removeFromTopLevel(data);
             qWarning() << "QAbstractItemModel::endInsertRows:  Invalid index (" << old.row() + count << ',' << old.column() << ") in model" << q_func();
         }
     }
+    if (inPlace)
+        persistent.updateTopLevelRows(first, count);
 }
 
 void QAbstractItemModelPrivate::itemsAboutToBeMoved(const QModelIndex &srcParent, int srcFirst, int srcLast, const QModelIndex &destinationParent, int destinationChild, Qt::Orientation orientation)
@@ -660,17 +679,11 @@ void QAbstractItemModelPrivate::itemsAboutToBeMoved(const QModelIndex &srcParent
     QVector<QPersistentModelIndexData *> persistent_moved_in_source;
     QVector<QPersistentModelIndexData *> persistent_moved_in_destination;
 
-    QHash<QModelIndex, QPersistentModelIndexData *>::const_iterator it;
-    const QHash<QModelIndex, QPersistentModelIndexData *>::const_iterator begin = persistent.indexes.constBegin();
-    const QHash<QModelIndex, QPersistentModelIndexData *>::const_iterator end = persistent.indexes.constEnd();
-
     const bool sameParent = (srcParent == destinationParent);
     const bool movingUp = (srcFirst > destinationChild);
 
-    for ( it = begin; it != end; ++it) {
-        QPersistentModelIndexData *data = *it;
+    const auto classify = [&](QPersistentModelIndexData *data, const QModelIndex &parent) {
         const QModelIndex &index = data->index;
-        const QModelIndex &parent = index.parent();
         const bool isSourceIndex = (parent == srcParent);
         const bool isDestinationIndex = (parent == destinationParent);
 
@@ -681,31 +694,53 @@ void QAbstractItemModelPrivate::itemsAboutToBeMoved(const QModelIndex &srcParent
             childPosition = index.column();
 
         if (!index.isValid() || !(isSourceIndex || isDestinationIndex ) )
-            continue;
+            return;
 
         if (!sameParent && isDestinationIndex) {
             if (childPosition >= destinationChild)
                 persistent_moved_in_destination.append(data);
-            continue;
+            return;
         }
 
         if (sameParent && movingUp && childPosition < destinationChild)
-            continue;
+            return;
 
         if (sameParent && !movingUp && childPosition < srcFirst )
-            continue;
+            return;
 
         if (!sameParent && childPosition < srcFirst)
-            continue;
+            return;
 
         if (sameParent && (childPosition > srcLast) && (childPosition >= destinationChild ))
-            continue;
+            return;
 
         if ((childPosition <= srcLast) && (childPosition >= srcFirst)) {
             persistent_moved_explicitly.append(data);
         } else {
             persistent_moved_in_source.append(data);
         }
+    };
+
+    if (!srcParent.isValid() || !destinationParent.isValid()) {
+        // rows of the root before both the moved rows and the destination keep their place
+        int start = 0;
+        if (orientation == Qt::Vertical) {
+            start = srcParent.isValid() ? INT_MAX : srcFirst;
+            if (!destinationParent.isValid())
+                start = qMin(start, destinationChild);
+        }
+        for (int i = persistent.topLevelLowerBound(start); i < persistent.topLevel.size(); ++i) {
+            if (QPersistentModelIndexData *data = persistent.topLevel.at(i))
+                classify(data, QModelIndex());
+        }
+    }
+    if (persistent.hasNested() && (srcParent.isValid() || destinationParent.isValid())) {
+        for (QHash<QModelIndex, QPersistentModelIndexData *>::const_iterator it = persistent.indexes.constBegin();
+             it != persistent.indexes.constEnd(); ++it) {
+            QPersistentModelIndexData *data = *it;
+            if (!data->isTopLevel())
+                classify(data, data->index.parent());
+        }
     }
     persistent.moved.push(persistent_moved_explicitly);
     persistent.moved.push(persistent_moved_in_source);
@@ -737,10 +772,10 @@ void QAbstractItemModelPrivate::movePersistentIndexes(const QVector<QPersistentM
         else
             column += change;
 
-        persistent.indexes.erase(persistent.indexes.constFind(data->index));
+        persistent.remove(data);
         data->index = q_func()->index(row, column, parent);
         if (data->index.isValid()) {
-            persistent.insertMultiAtEnd(data->index, data);
+            persistent.insert(data, parent);
         } else {
             qWarning() << "QAbstractItemModel::endMoveRows:  Invalid index (" << row << "," << column << ") in model" << q_func();
         }
@@ -772,22 +807,38 @@ void QAbstractItemModelPrivate::rowsAboutToBeRemoved(const QModelIndex &parent,
     QVector<QPersistentModelIndexData *>  persistent_invalidated;
     // find the persistent indexes that are affected by the change, either by being in the removed subtree
     // or by being on the same level and below the removed rows
-    for (QHash<QModelIndex, QPersistentModelIndexData *>::const_iterator it = persistent.indexes.constBegin();
-         it != persistent.indexes.constEnd(); ++it) {
-        QPersistentModelIndexData *data = *it;
-        bool level_changed = false;
-        QModelIndex current = data->index;
-        while (current.isValid()) {
-            QModelIndex current_parent = current.parent();
-            if (current_parent == parent) { // on the same level as the change
-                if (!level_changed && current.row() > last) // below the removed rows
-                    persistent_moved.append(data);
-                else if (current.row() <= last && current.row() >= first) // in the removed subtree
-                    persistent_invalidated.append(data);
-                break;
+    if (!parent.isValid()) {
+        for (int i = persistent.topLevelLowerBound(first); i < persistent.topLevel.size(); ++i) {
+            QPersistentModelIndexData *data = persistent.topLevel.at(i);
+            if (!data)
+                continue;
+            if (persistent.topLevelRows.at(i) > last) // below the removed rows
+                persistent_moved.append(data);
+            else // in the removed subtree
+                persistent_invalidated.append(data);
+        }
+    }
+    // the children of the root are not part of any other subtree
+    if (persistent.hasNested()) {
+        for (QHash<QModelIndex, QPersistentModelIndexData *>::const_iterator it = persistent.indexes.constBegin();
+             it != persistent.indexes.constEnd(); ++it) {
+            QPersistentModelIndexData *data = *it;
+            if (data->isTopLevel())
+                continue;
+            bool level_changed = false;
+            QModelIndex current = data->index;
+            while (current.isValid()) {
+                QModelIndex current_parent = current.parent();
+                if (current_parent == parent) { // on the same level as the change
+                    if (!level_changed && current.row() > last) // below the removed rows
+                        persistent_moved.append(data);
+                    else if (current.row() <= last && current.row() >= first) // in the removed subtree
+                        persistent_invalidated.append(data);
+                    break;
+                }
+                current = current_parent;
+                level_changed = true;
             }
-            current = current_parent;
-            level_changed = true;
         }
     }
 
@@ -799,27 +850,32 @@ void QAbstractItemModelPrivate::rowsRemoved(const QModelIndex &parent,
                                             int first, int last)
 {
     QVector<QPersistentModelIndexData *> persistent_moved = persistent.moved.pop();
+    QVector<QPersistentModelIndexData *> persistent_invalidated = persistent.invalidated.pop();
+    for (QVector<QPersistentModelIndexData *>::const_iterator it = persistent_invalidated.constBegin();
+         it != persistent_invalidated.constEnd(); ++it) {
+        QPersistentModelIndexData *data = *it;
+        persistent.remove(data);
+        data->index = QModelIndex();
+        data->model = 0;
+    }
     int count = (last - first) + 1; // it is important to only use the delta, because the change could be nested
+    // moving all top-level rows after the removed ones keeps them in order
+    const bool inPlace = !parent.isValid() && persistent.isTopLevelTail(persistent_moved, first);
     for (QVector<QPersistentModelIndexData *>::const_iterator it = persistent_moved.constBegin();
          it != persistent_moved.constEnd(); ++it) {
         QPersistentModelIndexData *data = *it;
         QModelIndex old = data->index;
-        persistent.indexes.erase(persistent.indexes.constFind(old));
+        persistent.remove(data, inPlace);
         data->index = q_func()->index(old.row() - count, old.column(), parent);
         if (data->index.isValid()) {
-            persistent.insertMultiAtEnd(data->index, data);
+            persistent.insert(data, parent, inPlace);
         } else {
+            persistent.removeFromTopLevel(data);
             qWarning() << "QAbstractItemModel::endRemoveRows:  Invalid index (" << old.row() - count << ',' << old.column() << ") in model" << q_func();
         }
     }
-    QVector<QPersistentModelIndexData *> persistent_invalidated = persistent.invalidated.pop();
-    for (QVector<QPersistentModelIndexData *>::const_iterator it = persistent_invalidated.constBegin();
-         it != persistent_invalidated.constEnd(); ++it) {
-        QPersistentModelIndexData *data = *it;
-        persistent.indexes.erase(persistent.indexes.constFind(data->index));
-        data->index = QModelIndex();
-        data->model = 0;
-    }
+    if (inPlace)
+        persistent.updateTopLevelRows(first, -count);
 }
 
 void QAbstractItemModelPrivate::columnsAboutToBeInserted(const QModelIndex &parent,
@@ -829,12 +885,20 @@ void QAbstractItemModelPrivate::columnsAboutToBeInserted(const QModelIndex &pare
     Q_UNUSED(last);
     QVector<QPersistentModelIndexData *> persistent_moved;
     if (first < q->columnCount(parent)) {
-        for (QHash<QModelIndex, QPersistentModelIndexData *>::const_iterator it = persistent.indexes.constBegin();
-             it != persistent.indexes.constEnd(); ++it) {
-            QPersistentModelIndexData *data = *it;
-            const QModelIndex &index = data->index;
-            if (index.column() >= first && index.isValid() && index.parent() == parent)
-                persistent_moved.append(data);
+        if (!parent.isValid()) {
+            for (int i = persistent.topLevelLowerBound(0); i < persistent.topLevel.size(); ++i) {
+                QPersistentModelIndexData *data = persistent.topLevel.at(i);
+                if (data && data->index.column() >= first)
+                    persistent_moved.append(data);
+            }
+        } else if (persistent.hasNested()) {
+            for (QHash<QModelIndex, QPersistentModelIndexData *>::const_iterator it = persistent.indexes.constBegin();
+                 it != persistent.indexes.constEnd(); ++it) {
+                QPersistentModelIndexData *data = *it;
+                const QModelIndex &index = data->index;
+                if (!data->isTopLevel() && index.column() >= first && index.isValid() && index.parent() == parent)
+                    persistent_moved.append(data);
+            }
         }
     }
     persistent.moved.push(persistent_moved);
@@ -845,15 +909,18 @@ void QAbstractItemModelPrivate::columnsInserted(const QModelIndex &parent,
 {
     QVector<QPersistentModelIndexData *> persistent_moved = persistent.moved.pop();
     int count = (last - first) + 1; // it is important to only use the delta, because the change could be nested
+    // the rows of top-level indexes do not change
+    const bool inPlace = !parent.isValid();
     for (QVector<QPersistentModelIndexData *>::const_iterator it = persistent_moved.constBegin();
          it != persistent_moved.constEnd(); ++it) {
         QPersistentModelIndexData *data = *it;
         QModelIndex old = data->index;
-        persistent.indexes.erase(persistent.indexes.constFind(old));
+        persistent.remove(data, inPlace);
         data->index = q_func()->index(old.row(), old.column() + count, parent);
         if (data->index.isValid()) {
-            persistent.insertMultiAtEnd(data->index, data);
+            persistent.insert(data, parent, inPlace);
         } else {
+            persistent.removeFromTopLevel(data);
             qWarning() << "QAbstractItemModel::endInsertColumns:  Invalid index (" << old.row() << ',' << old.column() + count << ") in model" << q_func();
         }
      }
@@ -866,22 +933,39 @@ void QAbstractItemModelPrivate::columnsAboutToBeRemoved(const QModelIndex &paren
     QVector<QPersistentModelIndexData *> persistent_invalidated;
     // find the persistent indexes that are affected by the change, either by being in the removed subtree
     // or by being on the same level and to the right of the removed columns
-    for (QHash<QModelIndex, QPersistentModelIndexData *>::const_iterator it = persistent.indexes.constBegin();
-         it != persistent.indexes.constEnd(); ++it) {
-        QPersistentModelIndexData *data = *it;
-        bool level_changed = false;
-        QModelIndex current = data->index;
-        while (current.isValid()) {
-            QModelIndex current_parent = current.parent();
-            if (current_parent == parent) { // on the same level as the change
-                if (!level_changed && current.column() > last) // right of the removed columns
-                    persistent_moved.append(data);
-                else if (current.column() <= last && current.column() >= first) // in the removed subtree
-                    persistent_invalidated.append(data);
-                break;
+    if (!parent.isValid()) {
+        for (int i = persistent.topLevelLowerBound(0); i < persistent.topLevel.size(); ++i) {
+            QPersistentModelIndexData *data = persistent.topLevel.at(i);
+            if (!data)
+                continue;
+            const int column = data->index.column();
+            if (column > last) // right of the removed columns
+                persistent_moved.append(data);
+            else if (column >= first) // in the removed subtree
+                persistent_invalidated.append(data);
+        }
+    }
+    // the children of the root are not part of any other subtree
+    if (persistent.hasNested()) {
+        for (QHash<QModelIndex, QPersistentModelIndexData *>::const_iterator it = persistent.indexes.constBegin();
+             it != persistent.indexes.constEnd(); ++it) {
+            QPersistentModelIndexData *data = *it;
+            if (data->isTopLevel())
+                continue;
+            bool level_changed = false;
+            QModelIndex current = data->index;
+            while (current.isValid()) {
+                QModelIndex current_parent = current.parent();
+                if (current_parent == parent) { // on the same level as the change
+                    if (!level_changed && current.column() > last) // right of the removed columns
+                        persistent_moved.append(data);
+                    else if (current.column() <= last && current.column() >= first) // in the removed subtree
+                        persistent_invalidated.append(data);
+                    break;
+                }
+                current = current_parent;
+                level_changed = true;
             }
-            current = current_parent;
-            level_changed = true;
         }
     }
 
@@ -895,15 +979,18 @@ void QAbstractItemModelPrivate::columnsRemoved(const QModelIndex &parent,
 {
     QVector<QPersistentModelIndexData *> persistent_moved = persistent.moved.pop();
     int count = (last - first) + 1; // it is important to only use the delta, because the change could be nested
+    // the rows of top-level indexes do not change
+    const bool inPlace = !parent.isValid();
     for (QVector<QPersistentModelIndexData *>::const_iterator it = persistent_moved.constBegin();
          it != persistent_moved.constEnd(); ++it) {
         QPersistentModelIndexData *data = *it;
         QModelIndex old = data->index;
-        persistent.indexes.erase(persistent.indexes.constFind(old));
+        persistent.remove(data, inPlace);
         data->index = q_func()->index(old.row(), old.column() - count, parent);
         if (data->index.isValid()) {
-            persistent.insertMultiAtEnd(data->index, data);
+            persistent.insert(data, parent, inPlace);
         } else {
+            persistent.removeFromTopLevel(data);
             qWarning() << "QAbstractItemModel::endRemoveColumns:  Invalid index (" << old.row() << ',' << old.column() - count << ") in model" << q_func();
         }
     }
@@ -911,7 +998,7 @@ void QAbstractItemModelPrivate::columnsRemoved(const QModelIndex &parent,
     for (QVector<QPersistentModelIndexData *>::const_iterator it = persistent_invalidated.constBegin();
          it != persistent_invalidated.constEnd(); ++it) {
         QPersistentModelIndexData *data = *it;
-        persistent.indexes.erase(persistent.indexes.constFind(data->index));
+        persistent.remove(data);
         data->index = QModelIndex();
         data->model = 0;
     }
@@ -3201,11 +3288,14 @@ void QAbstractItemModel::changePersistentIndex(const QModelIndex &from, const QM
     if (it != d->persistent.indexes.cend()) {
         QPersistentModelIndexData *data = *it;
         d->persistent.indexes.erase(it);
+        d->persistent.removeFromTopLevel(data);
         data->index = to;
-        if (to.isValid())
+        if (to.isValid()) {
             d->persistent.insertMultiAtEnd(to, data);
-        else
+            d->persistent.addUnclassified(data);
+        } else {
             data->model = 0;
+        }
     }
 }
 
@@ -3235,6 +3325,7 @@ void QAbstractItemModel::changePersistentIndexList(const QModelIndexList &from,
         if (it != d->persistent.indexes.cend()) {
             QPersistentModelIndexData *data = *it;
             d->persistent.indexes.erase(it);
+            d->persistent.removeFromTopLevel(data);
             data->index = to.at(i);
             if (data->index.isValid())
                 toBeReinserted << data;
@@ -3247,6 +3338,7 @@ void QAbstractItemModel::changePersistentIndexList(const QModelIndexList &from,
          it != toBeReinserted.constEnd() ; ++it) {
         QPersistentModelIndexData *data = *it;
         d->persistent.insertMultiAtEnd(data->index, data);
+        d->persistent.addUnclassified(data);
     }
 }
 
@@ -3755,4 +3847,178 @@ void QAbstractItemModelPrivate::Persistent::insertMultiAtEnd(const QModelIndex&
     }
 }
 
+/*!
+    \internal
+
+    Adds \a data, whose index is a child of \a parent, to the persistent
+    indexes. If \a keepPosition is true, \a data was removed with
+    keepPosition and is still in the top level under its previous row.
+*/
+void QAbstractItemModelPrivate::Persistent::insert(QPersistentModelIndexData *data, const QModelIndex &parent, bool keepPosition)
+{
+    insertMultiAtEnd(data->index, data);
+    if (keepPosition || parent.isValid())
+        return;
+    const int row = data->index.row();
+    data->topLevelPosition = topLevel.size();
+    topLevel.append(data);
+    ++topLevelCount;
+    // persistent indexes are usually created in row order, e.g. for the ranges of a selection
+    if (topLevelSorted == data->topLevelPosition && (topLevelRows.isEmpty() || row >= topLevelRows.last())) {
+        topLevelRows.append(row);
+        ++topLevelSorted;
+    }
+}
+
+/*!
+    \internal
+
+    Removes \a data from the persistent indexes, before its index is changed.
+    If \a keepPosition is true, it is left in the top level.
+*/
+void QAbstractItemModelPrivate::Persistent::remove(QPersistentModelIndexData *data, bool keepPosition)
+{
+    indexes.erase(indexes.constFind(data->index));
+    if (!keepPosition)
+        removeFromTopLevel(data);
+}
+
+void QAbstractItemModelPrivate::Persistent::removeTopLevelEntry(QPersistentModelIndexData *data)
+{
+    topLevel[data->topLevelPosition] = 0;
+    --topLevelCount;
+    if (topLevelCount >= topLevel.size() / 2)
+        return;
+
+    // compact when most entries have been removed
+    int count = 0;
+    int sorted = 0;
+    for (int i = 0; i < topLevel.size(); ++i) {
+        QPersistentModelIndexData *entry = topLevel.at(i);
+        if (!entry)
+            continue;
+        if (i < topLevelSorted)
+            topLevelRows[sorted++] = topLevelRows.at(i);
+        entry->topLevelPosition = count;
+        topLevel[count++] = entry;
+    }
+    topLevel.resize(count);
+    topLevelRows.resize(sorted);
+    topLevelSorted = sorted;
+}
+
+/*!
+    \internal
+
+    Adds the indexes marked by addUnclassified() which have no parent to the
+    top level, out of order. This calls parent() once for each of them, and
+    not at all if there are none.
+*/
+void QAbstractItemModelPrivate::Persistent::classify()
+{
+    if (!unclassifiedCount)
+        return;
+    for (QPersistentModelIndexData *data : qAsConst(indexes)) {
+        if (data->topLevelPosition != QPersistentModelIndexData::Unclassified)
+            continue;
+        if (data->index.parent().isValid()) {
+            data->topLevelPosition = QPersistentModelIndexData::NotTopLevel;
+        } else {
+            data->topLevelPosition = topLevel.size();
+            topLevel.append(data);
+            ++topLevelCount;
+        }
+        if (!--unclassifiedCount)
+            break;
+    }
+}
+
+/*!
+    \internal
+
+    Returns the position of the first top-level entry whose row is not less
+    than \a row.
+*/
+int QAbstractItemModelPrivate::Persistent::topLevelLowerBound(int row)
+{
+    classify();
+    if (topLevelSorted < topLevel.size()) {
+        // merge the entries which were added out of order
+        QVector<QPersistentModelIndexData *> entries;
+        entries.reserve(topLevelCount);
+        int sorted = 0;
+        for (int i = 0; i < topLevel.size(); ++i) {
+            if (QPersistentModelIndexData *entry = topLevel.at(i)) {
+                entries.append(entry);
+                if (i < topLevelSorted)
+                    ++sorted;
+            }
+        }
+        const auto rowLessThan = [](const QPersistentModelIndexData *left, const QPersistentModelIndexData *right) {
+            return left->index.row() < right->index.row();
+        };
+        if (!std::is_sorted(entries.begin() + sorted, entries.end(), rowLessThan))
+            std::stable_sort(entries.begin() + sorted, entries.end(), rowLessThan);
+        std::inplace_merge(entries.begin(), entries.begin() + sorted, entries.end(), rowLessThan);
+        topLevel.swap(entries);
+        topLevelRows.resize(topLevel.size());
+        for (int i = 0; i < topLevel.size(); ++i) {
+            topLevel.at(i)->topLevelPosition = i;
+            topLevelRows[i] = topLevel.at(i)->index.row();
+        }
+        topLevelSorted = topLevel.size();
+    }
+    return int(std::lower_bound(topLevelRows.cbegin(), topLevelRows.cend(), row) - topLevelRows.cbegin());
+}
+
+/*!
+    \internal
+
+    Returns \c true if \a tail holds, in order, the top-level indexes in rows
+    from \a first onwards. Their rows can then be changed by the same amount
+    without reordering them, see updateTopLevelRows().
+*/
+bool QAbstractItemModelPrivate::Persistent::isTopLevelTail(const QVector<QPersistentModelIndexData *> &tail, int first)
+{
+    int i = topLevelLowerBound(first);
+    for (QPersistentModelIndexData *data : tail) {
+        while (i < topLevel.size() && !topLevel.at(i))
+            ++i;
+        if (i == topLevel.size() || topLevel.at(i) != data)
+            return false;
+        ++i;
+    }
+    while (i < topLevel.size() && !topLevel.at(i))
+        ++i;
+    return i == topLevel.size();
+}
+
+/*!
+    \internal
+
+    Updates the rows of the top-level entries from \a first onwards, after
+    their indexes have been moved by \a delta rows. Only the rows are
+    read, so the indexes themselves are not visited again.
+*/
+void QAbstractItemModelPrivate::Persistent::updateTopLevelRows(int first, int delta)
+{
+    const int start = topLevelLowerBound(first);
+    int *rows = topLevelRows.data();
+    int previous = start > 0 ? rows[start - 1] : 0;
+    for (int i = start; i < topLevelRows.size(); ++i) {
+        // removed entries may fall behind the previous one, keep the rows sorted
+        previous = qMax(previous, rows[i] + delta);
+        rows[i] = previous;
+    }
+}
+
+void QAbstractItemModelPrivate::Persistent::clearTopLevel()
+{
+    topLevel.clear();
+    topLevelRows.clear();
+    topLevelSorted = 0;
+    topLevelCount = 0;
+    unclassifiedCount = 0;
+}
+
 QT_END_NAMESPACE
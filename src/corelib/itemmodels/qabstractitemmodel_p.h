@@ -63,11 +63,16 @@ QT_BEGIN_NAMESPACE
 class QPersistentModelIndexData
 {
 public:
-    QPersistentModelIndexData() : model(0) {}
-    QPersistentModelIndexData(const QModelIndex &idx) : index(idx), model(idx.model()) {}
+    enum { NotTopLevel = -1, Unclassified = -2 };
+    QPersistentModelIndexData() : topLevelPosition(NotTopLevel), model(0) {}
+    QPersistentModelIndexData(const QModelIndex &idx) : index(idx), topLevelPosition(NotTopLevel), model(idx.model()) {}
     QModelIndex index;
     QAtomicInt ref;
+    // in QAbstractItemModelPrivate::Persistent::topLevel, NotTopLevel, or
+    // Unclassified if that has not been checked yet
+    int topLevelPosition;
     const QAbstractItemModel *model;
+    bool isTopLevel() const { return topLevelPosition >= 0; }
     static QPersistentModelIndexData *create(const QModelIndex &index);
     static void destroy(QPersistentModelIndexData *data);
 };
@@ -139,11 +144,48 @@ public:
     QStack<Change> changes;
 
     struct Persistent {
-        Persistent() {}
+        Persistent() : topLevelSorted(0), topLevelCount(0), unclassifiedCount(0) {}
         QHash<QModelIndex, QPersistentModelIndexData *> indexes;
+        // The children of the root. The root never moves, so the indexes
+        // affected by a change of the top level are found by a binary search
+        // instead of by visiting every persistent index. The first
+        // topLevelSorted entries are in row order, with their rows in
+        // topLevelRows; the ones added out of order follow and are merged on
+        // the next lookup. Removed entries are null until the next compaction.
+        // Indexes whose parent is not known when they are added, such as the
+        // ones created by QPersistentModelIndex, are only checked for a parent
+        // when a change needs to know, see classify().
+        QVector<QPersistentModelIndexData *> topLevel;
+        QVector<int> topLevelRows;
+        int topLevelSorted;
+        int topLevelCount;
+        int unclassifiedCount;
         QStack<QVector<QPersistentModelIndexData *> > moved;
         QStack<QVector<QPersistentModelIndexData *> > invalidated;
         void insertMultiAtEnd(const QModelIndex& key, QPersistentModelIndexData *data);
+        void insert(QPersistentModelIndexData *data, const QModelIndex &parent, bool keepPosition = false);
+        // marks data, which is in indexes already, as not checked for a parent
+        void addUnclassified(QPersistentModelIndexData *data)
+        {
+            data->topLevelPosition = QPersistentModelIndexData::Unclassified;
+            ++unclassifiedCount;
+        }
+        void remove(QPersistentModelIndexData *data, bool keepPosition = false);
+        void removeFromTopLevel(QPersistentModelIndexData *data)
+        {
+            if (data->isTopLevel())
+                removeTopLevelEntry(data);
+            else if (data->topLevelPosition == QPersistentModelIndexData::Unclassified)
+                --unclassifiedCount;
+            data->topLevelPosition = QPersistentModelIndexData::NotTopLevel;
+        }
+        void removeTopLevelEntry(QPersistentModelIndexData *data);
+        void classify();
+        int topLevelLowerBound(int row);
+        bool isTopLevelTail(const QVector<QPersistentModelIndexData *> &tail, int first);
+        void updateTopLevelRows(int first, int delta);
+        void clearTopLevel();
+        bool hasNested() { classify(); return indexes.size() > topLevelCount; }
     } persistent;
 
     Qt::DropActions supportedDragActions;
@@ -0,0 +1,519 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qabstractmodelfetcher.h"
+
+#ifndef QT_NO_THREAD
+
+#include <qbasictimer.h>
+#include <qcoreevent.h>
+#include <qelapsedtimer.h>
+#include <qmutex.h>
+#include <qrunnable.h>
+#include <qsharedpointer.h>
+#include <qthread.h>
+#include <qthreadpool.h>
+#include <qvector.h>
+#include <qwaitcondition.h>
+#include <private/qobject_p.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+// The part of a fetch which is shared with the loader thread. It must not
+// refer to the model, since the loader thread may release the last reference.
+struct QModelFetchJob
+{
+    explicit QModelFetchJob(const QVariant &argument)
+        : argument(argument), finished(false)
+    {}
+
+    const QVariant argument;
+    QAtomicInt canceled;
+
+    // protected by QAbstractModelFetcherPrivate::mutex
+    QVariantList rows;
+    bool finished;
+};
+
+typedef QSharedPointer<QModelFetchJob> QModelFetchJobPointer;
+
+// A fetch as seen by the thread of the fetcher, the only thread that
+// touches its parent
+struct QModelFetch
+{
+    QModelFetch() : root(false) {}
+    QModelFetch(const QModelIndex &parent, const QVariant &argument)
+        : job(new QModelFetchJob(argument)), parent(parent), root(!parent.isValid())
+    {}
+
+    bool isFor(const QModelIndex &index) const
+    {
+        return root ? !index.isValid() : (parent.isValid() && parent == index);
+    }
+
+    QModelFetchJobPointer job;
+    QPersistentModelIndex parent;
+    bool root;
+};
+
+class QAbstractModelFetcherPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QAbstractModelFetcher)
+
+public:
+    QAbstractModelFetcherPrivate()
+        : current(Q_NULLPTR), running(0), deliveryScheduled(false), updateInterval(0)
+    {}
+
+    void scheduleDelivery();
+    void deliver();
+    void _q_deliver();
+
+    QThreadPool pool;
+    QModelFetchJob *current; // only used in the loader thread
+
+    // the fetches which are queued, running or have rows to deliver, in the
+    // order of fetch(); only used in the thread of the fetcher
+    QVector<QModelFetch> fetches;
+
+    // protected by mutex
+    QMutex mutex;
+    QWaitCondition idle;
+    int running;
+    bool deliveryScheduled;
+
+    int updateInterval;
+    QBasicTimer deliveryTimer;
+    QElapsedTimer lastDelivery;
+};
+
+class QModelFetcherRunnable : public QRunnable
+{
+public:
+    QModelFetcherRunnable(QAbstractModelFetcher *fetcher, const QModelFetchJobPointer &job)
+        : fetcher(fetcher), job(job)
+    {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        QAbstractModelFetcherPrivate *d = fetcher->d_func();
+        if (!job->canceled.load()) {
+            d->current = job.data();
+            fetcher->fetchRows(job->argument);
+            d->current = Q_NULLPTR;
+        }
+
+        QMutexLocker locker(&d->mutex);
+        job->finished = true;
+        --d->running;
+        d->scheduleDelivery();
+        d->idle.wakeAll();
+    }
+
+private:
+    QAbstractModelFetcher *fetcher;
+    QModelFetchJobPointer job;
+};
+
+/*!
+    \internal
+
+    Must be called with the mutex locked.
+*/
+void QAbstractModelFetcherPrivate::scheduleDelivery()
+{
+    Q_Q(QAbstractModelFetcher);
+    if (!deliveryScheduled) {
+        deliveryScheduled = true;
+        QMetaObject::invokeMethod(q, "_q_deliver", Qt::QueuedConnection);
+    }
+}
+
+void QAbstractModelFetcherPrivate::_q_deliver()
+{
+    Q_Q(QAbstractModelFetcher);
+    if (updateInterval > 0 && lastDelivery.isValid()) {
+        const qint64 elapsed = lastDelivery.elapsed();
+        if (elapsed < updateInterval) {
+            // deliveryScheduled stays set, the timer delivers everything
+            // which arrives in the meantime
+            if (!deliveryTimer.isActive())
+                deliveryTimer.start(int(updateInterval - elapsed), q);
+            return;
+        }
+    }
+    deliver();
+}
+
+/*!
+    \internal
+
+    Emits the rows which have arrived since the last delivery, one signal per
+    job, and finished() for the jobs which are done.
+*/
+void QAbstractModelFetcherPrivate::deliver()
+{
+    Q_Q(QAbstractModelFetcher);
+    deliveryTimer.stop();
+    lastDelivery.start();
+
+    struct Delivery {
+        QModelFetch fetch;
+        QVariantList rows;
+        bool finished;
+    };
+    QVector<Delivery> deliveries;
+    deliveries.reserve(fetches.size());
+    {
+        QMutexLocker locker(&mutex);
+        deliveryScheduled = false;
+        for (const QModelFetch &fetch : qAsConst(fetches)) {
+            QModelFetchJob *job = fetch.job.data();
+            if (!job->rows.isEmpty() || job->finished) {
+                deliveries.append(Delivery{ fetch, job->rows, job->finished });
+                job->rows.clear();
+            }
+        }
+    }
+
+    // the parent of a fetch may have been removed from the model
+    const auto done = [](const QModelFetch &fetch) {
+        if (!fetch.root && !fetch.parent.isValid())
+            fetch.job->canceled.store(1);
+        return fetch.job->canceled.load() || fetch.job->finished;
+    };
+    fetches.erase(std::remove_if(fetches.begin(), fetches.end(), done), fetches.end());
+
+    // the slots may cancel fetches, or start new ones
+    for (const Delivery &delivery : qAsConst(deliveries)) {
+        const QModelFetch &fetch = delivery.fetch;
+        if (fetch.job->canceled.load())
+            continue;
+        if (!delivery.rows.isEmpty())
+            emit q->rowsFetched(fetch.parent, delivery.rows);
+        if (delivery.finished && !fetch.job->canceled.load())
+            emit q->finished(fetch.parent);
+    }
+}
+
+/*!
+    \class QAbstractModelFetcher
+    \inmodule QtCore
+    \since 5.8
+    \brief The QAbstractModelFetcher class loads the rows of an item model in
+    a worker thread.
+
+    \ingroup model-view
+
+    Models whose data comes from a slow source, such as a database, a network
+    connection or the file system, can use QAbstractModelFetcher to load their
+    rows without blocking the thread of the model. The rows are produced by
+    fetchRows(), which subclasses reimplement and which is called in a loader
+    thread. The rows are delivered to the model with the rowsFetched() signal,
+    in the thread of the fetcher.
+
+    All rows which arrive between two deliveries are delivered together, so
+    the model can insert them with a single beginInsertRows() and
+    endInsertRows(), and the views attached to it lay out their items once for
+    all of them. The updateInterval property limits how often rows are
+    delivered while a large amount of data streams in.
+
+    The fetcher is typically used from the model's implementation of
+    \l{QAbstractItemModel::}{canFetchMore()} and
+    \l{QAbstractItemModel::}{fetchMore()}:
+
+    \code
+    void RecordModel::fetchMore(const QModelIndex &parent)
+    {
+        m_fetcher->fetch(parent, recordId(parent));
+    }
+
+    bool RecordModel::canFetchMore(const QModelIndex &parent) const
+    {
+        return !isLoaded(parent) && !m_fetcher->isFetching(parent);
+    }
+
+    void RecordModel::appendRows(const QModelIndex &parent, const QVariantList &rows)
+    {
+        const int first = rowCount(parent);
+        beginInsertRows(parent, first, first + rows.size() - 1);
+        // store the rows
+        endInsertRows();
+    }
+    \endcode
+
+    The fetches are run one at a time, in the order in which they were
+    requested. fetchRows() must not access the model; everything it needs to
+    know about the parent should be passed as the argument of fetch(). It
+    reports rows with addRows(), as often as it likes, and should check
+    isCanceled() regularly so that cancel() and cancelAll() take effect.
+
+    If the parent of a fetch is removed from the model, the fetch is canceled
+    and its remaining rows are discarded.
+
+    \note Subclasses must call cancelAll() and waitForFinished() in their
+    destructor, so that fetchRows() is not running while the subclass is
+    destroyed.
+
+    \sa QAbstractItemModel::fetchMore(), QThreadPool
+*/
+
+/*!
+    \fn void QAbstractModelFetcher::rowsFetched(const QModelIndex &parent, const QVariantList &rows)
+
+    This signal is emitted with the \a rows that fetchRows() has reported
+    since the previous delivery for the fetch of the children of \a parent.
+*/
+
+/*!
+    \fn void QAbstractModelFetcher::finished(const QModelIndex &parent)
+
+    This signal is emitted after the last rows of the fetch of the children
+    of \a parent have been delivered. It is not emitted for canceled fetches.
+*/
+
+/*!
+    \fn void QAbstractModelFetcher::fetchRows(const QVariant &argument)
+
+    Reimplement this function to produce the rows of a fetch, and report them
+    with addRows(). The \a argument is the one that was passed to fetch().
+
+    This function is called in the loader thread of the fetcher. It must not
+    access the model, and should return early when isCanceled() returns \c true.
+*/
+
+/*!
+    Constructs a fetcher with the given \a parent.
+*/
+QAbstractModelFetcher::QAbstractModelFetcher(QObject *parent)
+    : QObject(*new QAbstractModelFetcherPrivate, parent)
+{
+    Q_D(QAbstractModelFetcher);
+    d->pool.setMaxThreadCount(1);
+}
+
+/*!
+    Destroys the fetcher, after canceling all fetches and waiting for
+    fetchRows() to return.
+*/
+QAbstractModelFetcher::~QAbstractModelFetcher()
+{
+    Q_D(QAbstractModelFetcher);
+    cancelAll();
+    d->pool.waitForDone();
+}
+
+/*!
+    Starts loading the children of \a parent. fetchRows() will be called with
+    \a argument in the loader thread once the previous fetches are done.
+
+    \sa isFetching(), cancel()
+*/
+void QAbstractModelFetcher::fetch(const QModelIndex &parent, const QVariant &argument)
+{
+    Q_D(QAbstractModelFetcher);
+    const QModelFetch fetch(parent, argument);
+    d->fetches.append(fetch);
+    {
+        QMutexLocker locker(&d->mutex);
+        ++d->running;
+    }
+    d->pool.start(new QModelFetcherRunnable(this, fetch.job));
+}
+
+/*!
+    Returns \c true if the children of \a parent are being loaded, or if some
+    of them have not been delivered yet.
+*/
+bool QAbstractModelFetcher::isFetching(const QModelIndex &parent) const
+{
+    Q_D(const QAbstractModelFetcher);
+    for (const QModelFetch &fetch : d->fetches) {
+        if (fetch.isFor(parent) && !fetch.job->canceled.load())
+            return true;
+    }
+    return false;
+}
+
+/*!
+    Returns \c true if any fetch is in progress.
+*/
+bool QAbstractModelFetcher::isActive() const
+{
+    Q_D(const QAbstractModelFetcher);
+    for (const QModelFetch &fetch : d->fetches) {
+        if (!fetch.job->canceled.load())
+            return true;
+    }
+    return false;
+}
+
+/*!
+    Cancels the fetches of the children of \a parent. The rows which have not
+    been delivered yet are discarded.
+
+    \sa cancelAll(), isCanceled()
+*/
+void QAbstractModelFetcher::cancel(const QModelIndex &parent)
+{
+    Q_D(QAbstractModelFetcher);
+    const auto matches = [&parent](const QModelFetch &fetch) {
+        if (!fetch.isFor(parent))
+            return false;
+        fetch.job->canceled.store(1);
+        return true;
+    };
+    d->fetches.erase(std::remove_if(d->fetches.begin(), d->fetches.end(), matches), d->fetches.end());
+}
+
+/*!
+    Cancels all fetches. The rows which have not been delivered yet are
+    discarded.
+
+    \sa cancel()
+*/
+void QAbstractModelFetcher::cancelAll()
+{
+    Q_D(QAbstractModelFetcher);
+    for (const QModelFetch &fetch : qAsConst(d->fetches))
+        fetch.job->canceled.store(1);
+    d->fetches.clear();
+}
+
+/*!
+    Waits until fetchRows() has returned for all fetches, or until \a msecs
+    milliseconds have passed. A negative value waits without a time limit.
+    Returns \c true if all fetches are done.
+
+    When called in the thread of the fetcher, the rows which have not been
+    delivered yet are delivered before this function returns.
+*/
+bool QAbstractModelFetcher::waitForFinished(int msecs)
+{
+    Q_D(QAbstractModelFetcher);
+    QElapsedTimer timer;
+    timer.start();
+    QMutexLocker locker(&d->mutex);
+    while (d->running > 0) {
+        if (msecs < 0) {
+            d->idle.wait(&d->mutex);
+        } else {
+            const qint64 remaining = msecs - timer.elapsed();
+            if (remaining <= 0 || !d->idle.wait(&d->mutex, remaining))
+                break;
+        }
+    }
+    const bool done = d->running == 0;
+    locker.unlock();
+
+    if (done && thread() == QThread::currentThread())
+        d->deliver();
+    return done;
+}
+
+/*!
+    \property QAbstractModelFetcher::updateInterval
+    \brief the minimum time in milliseconds between two deliveries of rows
+
+    Rows which arrive within this interval after a delivery are delivered
+    together once it has passed. The default value is 0, which delivers the
+    rows as soon as the event loop of the fetcher's thread gets to them.
+*/
+int QAbstractModelFetcher::updateInterval() const
+{
+    Q_D(const QAbstractModelFetcher);
+    return d->updateInterval;
+}
+
+void QAbstractModelFetcher::setUpdateInterval(int msecs)
+{
+    Q_D(QAbstractModelFetcher);
+    d->updateInterval = qMax(0, msecs);
+}
+
+/*!
+    Reports \a rows produced by fetchRows(). This function may only be called
+    from fetchRows().
+*/
+void QAbstractModelFetcher::addRows(const QVariantList &rows)
+{
+    Q_D(QAbstractModelFetcher);
+    QModelFetchJob *job = d->current;
+    if (!job || QThread::currentThread() == thread()) {
+        qWarning("QAbstractModelFetcher::addRows: Must be called from fetchRows()");
+        return;
+    }
+    if (rows.isEmpty() || job->canceled.load())
+        return;
+
+    QMutexLocker locker(&d->mutex);
+    job->rows += rows;
+    d->scheduleDelivery();
+}
+
+/*!
+    Returns \c true if the fetch for which fetchRows() is running has been
+    canceled. This function may only be called from fetchRows().
+*/
+bool QAbstractModelFetcher::isCanceled() const
+{
+    Q_D(const QAbstractModelFetcher);
+    const QModelFetchJob *job = d->current;
+    return job && job->canceled.load();
+}
+
+/*!
+    \reimp
+*/
+void QAbstractModelFetcher::timerEvent(QTimerEvent *event)
+{
+    Q_D(QAbstractModelFetcher);
+    if (event->timerId() == d->deliveryTimer.timerId())
+        d->deliver();
+    else
+        QObject::timerEvent(event);
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qabstractmodelfetcher.cpp"
+
+#endif // QT_NO_THREAD
@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QABSTRACTMODELFETCHER_H
+#define QABSTRACTMODELFETCHER_H
+
+#include <QtCore/qabstractitemmodel.h>
+#include <QtCore/qvariant.h>
+
+QT_BEGIN_NAMESPACE
+
+
+#ifndef QT_NO_THREAD
+
+class QAbstractModelFetcherPrivate;
+
+class Q_CORE_EXPORT QAbstractModelFetcher : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int updateInterval READ updateInterval WRITE setUpdateInterval)
+
+public:
+    explicit QAbstractModelFetcher(QObject *parent = Q_NULLPTR);
+    ~QAbstractModelFetcher();
+
+    void fetch(const QModelIndex &parent, const QVariant &argument = QVariant());
+    bool isFetching(const QModelIndex &parent) const;
+    bool isActive() const;
+
+    void cancel(const QModelIndex &parent);
+    void cancelAll();
+    bool waitForFinished(int msecs = -1);
+
+    int updateInterval() const;
+    void setUpdateInterval(int msecs);
+
+Q_SIGNALS:
+    void rowsFetched(const QModelIndex &parent, const QVariantList &rows);
+    void finished(const QModelIndex &parent);
+
+protected:
+    virtual void fetchRows(const QVariant &argument) = 0;
+    void addRows(const QVariantList &rows);
+    bool isCanceled() const;
+
+    void timerEvent(QTimerEvent *event) Q_DECL_OVERRIDE;
+
+private:
+    Q_DECLARE_PRIVATE(QAbstractModelFetcher)
+    Q_DISABLE_COPY(QAbstractModelFetcher)
+    Q_PRIVATE_SLOT(d_func(), void _q_deliver())
+    friend class QModelFetcherRunnable;
+};
+
+#endif // QT_NO_THREAD
+
+QT_END_NAMESPACE
+
+#endif // QABSTRACTMODELFETCHER_H
@@ -40,8 +40,11 @@
 #include "qitemselectionmodel.h"
 #include <private/qitemselectionmodel_p.h>
 #include <qdebug.h>
+#include <qscopedpointer.h>
+#include <qvarlengtharray.h>
 
 #include <algorithm>
+#include <limits.h>
 
 #ifndef QT_NO_ITEMVIEWS
 
@@ -493,6 +496,327 @@ static QVector<QPair<QPersistentModelIndex, uint> > qSelectionPersistentRowLengt
     return result;
 }
 
+namespace {
+// The geometry of a QItemSelectionRange, with the parent computed only once.
+// Comparing many ranges with each other through QItemSelectionRange would ask
+// the model for the parents of both ranges for every pair.
+struct QItemSelectionRect
+{
+    const QAbstractItemModel *model;
+    QModelIndex parent;
+    int top, left, bottom, right;
+    bool valid;
+
+    QItemSelectionRect() : model(Q_NULLPTR), top(0), left(0), bottom(-1), right(-1), valid(false) {}
+    explicit QItemSelectionRect(const QItemSelectionRange &range)
+        : model(range.model()), top(range.top()), left(range.left()),
+          bottom(range.bottom()), right(range.right()), valid(false)
+    {
+        if (range.topLeft().isValid() && range.bottomRight().isValid()) {
+            parent = range.topLeft().parent();
+            valid = parent == range.bottomRight().parent() && top <= bottom && left <= right;
+        }
+    }
+
+    bool sameParent(const QItemSelectionRect &other) const
+    { return model == other.model && parent == other.parent; }
+
+    bool intersects(const QItemSelectionRect &other) const
+    {
+        return valid && other.valid
+            && top <= other.bottom && other.top <= bottom
+            && left <= other.right && other.left <= right
+            && sameParent(other);
+    }
+
+    QItemSelectionRect intersected(const QItemSelectionRect &other) const
+    {
+        QItemSelectionRect result(*this);
+        result.top = qMax(top, other.top);
+        result.left = qMax(left, other.left);
+        result.bottom = qMin(bottom, other.bottom);
+        result.right = qMin(right, other.right);
+        return result;
+    }
+
+    QItemSelectionRange toRange() const
+    {
+        return QItemSelectionRange(model->index(top, left, parent),
+                                   model->index(bottom, right, parent));
+    }
+};
+} // namespace
+
+Q_DECLARE_TYPEINFO(QItemSelectionRect, Q_MOVABLE_TYPE);
+
+namespace {
+// Finds the rects intersecting a given rect in O(log n + k).
+// The rects are sorted by parent and top, and within each parent they form
+// an implicit binary search tree where every node stores the largest bottom
+// of its subtree, so subtrees ending above the searched rect are skipped.
+class QItemSelectionRectIndex
+{
+public:
+    explicit QItemSelectionRectIndex(const QVector<QItemSelectionRect> &rects)
+        : m_rects(rects)
+    {
+        m_order.reserve(rects.size());
+        for (int i = 0; i < rects.size(); ++i) {
+            if (rects.at(i).valid)
+                m_order.append(i);
+        }
+        std::sort(m_order.begin(), m_order.end(), [&rects](int lhs, int rhs) {
+            const QItemSelectionRect &l = rects.at(lhs);
+            const QItemSelectionRect &r = rects.at(rhs);
+            if (l.model != r.model)
+                return l.model < r.model;
+            if (l.parent != r.parent)
+                return l.parent < r.parent;
+            return l.top < r.top;
+        });
+        m_maxBottom.resize(m_order.size());
+        for (int first = 0; first < m_order.size();) {
+            int last = first + 1;
+            while (last < m_order.size() && rect(last).sameParent(rect(first)))
+                ++last;
+            build(first, last - 1);
+            first = last;
+        }
+    }
+
+    // Calls \a visit with the position in the indexed vector of every rect
+    // intersecting \a r, in increasing order.
+    template <typename Visitor>
+    void forEachIntersecting(const QItemSelectionRect &r, Visitor visit) const
+    {
+        if (!r.valid)
+            return;
+        const auto lessParent = [](const QItemSelectionRect &l, const QItemSelectionRect &r) {
+            return l.model != r.model ? l.model < r.model : l.parent < r.parent;
+        };
+        const auto first = std::lower_bound(m_order.cbegin(), m_order.cend(), r,
+                                            [&](int i, const QItemSelectionRect &value) {
+            return lessParent(m_rects.at(i), value);
+        });
+        const auto last = std::upper_bound(first, m_order.cend(), r,
+                                           [&](const QItemSelectionRect &value, int i) {
+            return lessParent(value, m_rects.at(i));
+        });
+        QVarLengthArray<int, 16> hits;
+        collect(r, first - m_order.cbegin(), last - m_order.cbegin() - 1, hits);
+        std::sort(hits.begin(), hits.end());
+        for (int hit : hits)
+            visit(hit);
+    }
+
+private:
+    const QItemSelectionRect &rect(int position) const { return m_rects.at(m_order.at(position)); }
+
+    int build(int lo, int hi)
+    {
+        if (lo > hi)
+            return INT_MIN;
+        const int mid = lo + (hi - lo) / 2;
+        const int maxBottom = qMax(rect(mid).bottom, qMax(build(lo, mid - 1), build(mid + 1, hi)));
+        m_maxBottom[mid] = maxBottom;
+        return maxBottom;
+    }
+
+    template <typename Container>
+    void collect(const QItemSelectionRect &r, int lo, int hi, Container &hits) const
+    {
+        while (lo <= hi) {
+            const int mid = lo + (hi - lo) / 2;
+            if (m_maxBottom.at(mid) < r.top)
+                return;
+            collect(r, lo, mid - 1, hits);
+            const QItemSelectionRect &candidate = rect(mid);
+            if (candidate.top > r.bottom)
+                return;
+            if (candidate.bottom >= r.top && candidate.left <= r.right && r.left <= candidate.right)
+                hits.append(m_order.at(mid));
+            lo = mid + 1;
+        }
+    }
+
+    const QVector<QItemSelectionRect> &m_rects;
+    QVector<int> m_order;
+    QVector<int> m_maxBottom;
+};
+} // namespace
+
+static QVector<QItemSelectionRect> qSelectionRects(const QItemSelection &selection)
+{
+    QVector<QItemSelectionRect> result;
+    result.reserve(selection.size());
+    for (const QItemSelectionRange &range : selection)
+        result.append(QItemSelectionRect(range));
+    return result;
+}
+
+static inline bool qSelectionOverlaps(const QItemSelectionRange &range, const QItemSelectionRect &rect)
+{
+    return range.top() <= rect.bottom && rect.top <= range.bottom()
+        && range.left() <= rect.right && rect.left <= range.right();
+}
+
+// Up to this many rects it is cheaper to compare them with every range, which
+// only needs the parent of ranges with overlapping rows and columns, than to
+// build an index. This is the common case of selecting a single range.
+static const int qSelectionScanLimit = 8;
+
+/*
+    Returns the intersections of the rects in \a lhs with the ranges in \a rhs,
+    ordered by \a lhs first.
+*/
+static QVector<QItemSelectionRect> qSelectionIntersections(const QVector<QItemSelectionRect> &lhs,
+                                                           const QItemSelection &rhs)
+{
+    QVector<QItemSelectionRect> result;
+    if (lhs.size() <= qSelectionScanLimit) {
+        for (const QItemSelectionRect &l : lhs) {
+            if (!l.valid)
+                continue;
+            for (const QItemSelectionRange &range : rhs) {
+                if (!qSelectionOverlaps(range, l))
+                    continue;
+                const QItemSelectionRect r(range);
+                if (l.intersects(r))
+                    result.append(r.intersected(l));
+            }
+        }
+        return result;
+    }
+
+    const QVector<QItemSelectionRect> rhsRects = qSelectionRects(rhs);
+    const QItemSelectionRectIndex index(rhsRects);
+    for (const QItemSelectionRect &l : lhs) {
+        index.forEachIntersecting(l, [&](int i) {
+            result.append(rhsRects.at(i).intersected(l));
+        });
+    }
+    return result;
+}
+
+/*
+    Removes the items covered by \a cuts from the ranges in \a selection,
+    with the same result as splitting them by each cut in turn, removing
+    the ranges that were split and appending their pieces: ranges which are
+    not affected keep their order, followed by the pieces in the order they
+    were created.
+*/
+static void qSelectionSubtract(QItemSelection *selection, const QVector<QItemSelectionRect> &cuts)
+{
+    QScopedPointer<QItemSelectionRectIndex> index;
+    if (cuts.size() > qSelectionScanLimit)
+        index.reset(new QItemSelectionRectIndex(cuts));
+
+    // The split ranges and their pieces, in the order the pieces are created.
+    // A piece can only intersect the cuts intersecting the range it is part of.
+    struct Part {
+        QItemSelectionRect rect;
+        int range;
+        bool removed;
+    };
+    QVector<Part> parts;
+    QVector<QVector<int> > partsByRange;
+    QVector<QVector<int> > rangesByCut(cuts.size());
+    QVarLengthArray<int, 16> hits;
+    int kept = 0;
+    for (int i = 0; i < selection->size(); ++i) {
+        const QItemSelectionRange &range = selection->at(i);
+        hits.clear();
+        QItemSelectionRect rect;
+        if (index) {
+            rect = QItemSelectionRect(range);
+            index->forEachIntersecting(rect, [&hits](int c) { hits.append(c); });
+        } else {
+            for (int c = 0; c < cuts.size(); ++c) {
+                if (!qSelectionOverlaps(range, cuts.at(c)))
+                    continue;
+                if (!rect.valid)
+                    rect = QItemSelectionRect(range);
+                if (rect.intersects(cuts.at(c)))
+                    hits.append(c);
+            }
+        }
+        if (hits.isEmpty()) {
+            if (kept != i)
+                (*selection)[kept] = range;
+            ++kept;
+            continue;
+        }
+        const int r = partsByRange.size();
+        partsByRange.append(QVector<int>(1, parts.size()));
+        parts.append(Part{ rect, r, false });
+        for (int c : qAsConst(hits))
+            rangesByCut[c].append(r);
+    }
+    selection->erase(selection->begin() + kept, selection->end());
+    if (parts.isEmpty())
+        return;
+
+    const int firstPiece = parts.size();
+    QVarLengthArray<int, 16> split;
+    for (int c = 0; c < cuts.size(); ++c) {
+        const QItemSelectionRect &cut = cuts.at(c);
+        split.clear();
+        for (int r : qAsConst(rangesByCut.at(c))) {
+            QVector<int> &rangeParts = partsByRange[r];
+            int live = 0;
+            for (int p : qAsConst(rangeParts)) {
+                if (parts.at(p).removed)
+                    continue;
+                rangeParts[live++] = p;
+                if (parts.at(p).rect.intersects(cut))
+                    split.append(p);
+            }
+            rangeParts.resize(live);
+        }
+        std::sort(split.begin(), split.end());
+
+        // same splitting as QItemSelection::split()
+        for (int p : qAsConst(split)) {
+            parts[p].removed = true;
+            QItemSelectionRect piece = parts.at(p).rect;
+            const int r = parts.at(p).range;
+            QItemSelectionRect part = piece;
+            if (cut.top > piece.top) {
+                part.bottom = cut.top - 1;
+                partsByRange[r].append(parts.size());
+                parts.append(Part{ part, r, false });
+                piece.top = cut.top;
+            }
+            if (cut.bottom < piece.bottom) {
+                part = piece;
+                part.top = cut.bottom + 1;
+                partsByRange[r].append(parts.size());
+                parts.append(Part{ part, r, false });
+                piece.bottom = cut.bottom;
+            }
+            if (cut.left > piece.left) {
+                part = piece;
+                part.right = cut.left - 1;
+                partsByRange[r].append(parts.size());
+                parts.append(Part{ part, r, false });
+                piece.left = cut.left;
+            }
+            if (cut.right < piece.right) {
+                part = piece;
+                part.left = cut.right + 1;
+                partsByRange[r].append(parts.size());
+                parts.append(Part{ part, r, false });
+            }
+        }
+    }
+
+    // every range in parts was split by its first cut
+    for (int p = firstPiece; p < parts.size(); ++p) {
+        if (!parts.at(p).removed)
+            selection->append(parts.at(p).rect.toRange());
+    }
+}
+
 /*!
     Merges the \a other selection with this QItemSelection using the
     \a command given. This method guarantees that no ranges are overlapping.
@@ -512,40 +836,22 @@ void QItemSelection::merge(const QItemSelection &other, QItemSelectionModel::Sel
         return;
 
     QItemSelection newSelection = other;
-    // Collect intersections
-    QItemSelection intersections;
     QItemSelection::iterator it = newSelection.begin();
     while (it != newSelection.end()) {
-        if (!(*it).isValid()) {
+        if (!(*it).isValid())
             it = newSelection.erase(it);
-            continue;
-        }
-        for (int t = 0; t < count(); ++t) {
-            if ((*it).intersects(at(t)))
-                intersections.append(at(t).intersected(*it));
-        }
-        ++it;
+        else
+            ++it;
     }
 
-    //  Split the old (and new) ranges using the intersections
-    for (int i = 0; i < intersections.count(); ++i) { // for each intersection
-        for (int t = 0; t < count();) { // splitt each old range
-            if (at(t).intersects(intersections.at(i))) {
-                split(at(t), intersections.at(i), this);
-                removeAt(t);
-            } else {
-                ++t;
-            }
-        }
+    // Collect intersections, and split the old (and new) ranges using them
+    const QVector<QItemSelectionRect> intersections =
+            qSelectionIntersections(qSelectionRects(newSelection), *this);
+    if (!intersections.isEmpty()) {
+        qSelectionSubtract(this, intersections);
         // only split newSelection if Toggle is specified
-        for (int n = 0; (command & QItemSelectionModel::Toggle) && n < newSelection.count();) {
-            if (newSelection.at(n).intersects(intersections.at(i))) {
-                split(newSelection.at(n), intersections.at(i), &newSelection);
-                newSelection.removeAt(n);
-            } else {
-                ++n;
-            }
-        }
+        if (command & QItemSelectionModel::Toggle)
+            qSelectionSubtract(&newSelection, intersections);
     }
     // do not add newSelection for Deselect
     if (!(command & QItemSelectionModel::Deselect))
@@ -1393,6 +1699,218 @@ QModelIndex QItemSelectionModel::currentIndex() const
     return static_cast<QModelIndex>(d_func()->currentIndex);
 }
 
+/*
+    Returns the index at \a position in every row (for Qt::Horizontal) or
+    column (for Qt::Vertical) for which isRowSelected() or isColumnSelected()
+    returns \c true, in the order in which the ranges of \a selection first
+    cover them.
+
+    The rows (or columns) of each parent are cut into bands in which the same
+    ranges are active, so the coverage of a line is only computed once per
+    band rather than once per line and range. Within a band, the lines are
+    checked the same way as in isRowSelected() and isColumnSelected(): against
+    the stored ranges followed by the current selection, which are not merged.
+*/
+static QModelIndexList qSelectedLines(const QItemSelectionModelPrivate *d, const QItemSelection &selection,
+                                      Qt::Orientation orientation, int position)
+{
+    QModelIndexList result;
+    const QAbstractItemModel *model = d->model;
+    if (!model)
+        return result;
+
+    const bool rows = orientation == Qt::Horizontal;
+    struct Line {
+        int first, last; // along the lines
+        int begin, end;  // across the lines
+    };
+    const auto toLine = [rows](const QItemSelectionRect &rect) {
+        return rows ? Line{ rect.top, rect.bottom, rect.left, rect.right }
+                    : Line{ rect.left, rect.right, rect.top, rect.bottom };
+    };
+
+    QItemSelection joined = d->ranges;
+    if (d->currentSelection.count())
+        joined += d->currentSelection;
+    const QVector<QItemSelectionRect> rects = qSelectionRects(joined);
+    QVector<Line> lines;
+    lines.reserve(rects.size());
+    QVector<int> order;
+    order.reserve(rects.size());
+    for (int i = 0; i < rects.size(); ++i) {
+        const QItemSelectionRect &rect = rects.at(i);
+        lines.append(toLine(rect));
+        if (rect.valid && (!rect.parent.isValid() || rect.parent.model() == model))
+            order.append(i);
+    }
+    std::sort(order.begin(), order.end(), [&](int lhs, int rhs) {
+        if (rects.at(lhs).parent != rects.at(rhs).parent)
+            return rects.at(lhs).parent < rects.at(rhs).parent;
+        return lines.at(lhs).first < lines.at(rhs).first;
+    });
+
+    // Lines which are not selected whatever they contain: those deselected
+    // by the current selection with the same parent, and while toggling,
+    // those in which it intersects a stored range with any parent.
+    struct Excluded {
+        QModelIndex parent;
+        bool anyParent;
+        int first, last;
+    };
+    QVector<Excluded> excluded;
+    if (d->currentSelection.count()) {
+        if (d->currentCommand & QItemSelectionModel::Deselect) {
+            for (const QItemSelectionRange &range : d->currentSelection) {
+                excluded.append(Excluded{ range.parent(), false,
+                                          rows ? range.top() : range.left(),
+                                          rows ? range.bottom() : range.right() });
+            }
+        }
+        if (d->currentCommand & QItemSelectionModel::Toggle) {
+            const QVector<QItemSelectionRect> intersections =
+                    qSelectionIntersections(qSelectionRects(d->currentSelection), d->ranges);
+            for (const QItemSelectionRect &rect : intersections) {
+                const Line line = toLine(rect);
+                excluded.append(Excluded{ QModelIndex(), true, line.first, line.last });
+            }
+        }
+    }
+
+    // The selected lines of each parent, as runs of first and last line.
+    struct Group {
+        QModelIndex parent;
+        QMap<int, int> runs;
+    };
+    QVector<Group> groups;
+
+    QVector<int> boundaries;
+    QVector<int> active;
+    QVector<int> sortedActive;
+    QVector<QPair<int, int> > skipped;
+    for (int groupBegin = 0; groupBegin < order.size();) {
+        const QModelIndex parent = rects.at(order.at(groupBegin)).parent;
+        int groupEnd = groupBegin + 1;
+        while (groupEnd < order.size() && rects.at(order.at(groupEnd)).parent == parent)
+            ++groupEnd;
+        const int crossCount = rows ? model->columnCount(parent) : model->rowCount(parent);
+        groups.append(Group{ parent, QMap<int, int>() });
+        QMap<int, int> &runs = groups.last().runs;
+
+        skipped.clear();
+        for (const Excluded &e : qAsConst(excluded)) {
+            if (e.anyParent || e.parent == parent)
+                skipped.append(qMakePair(e.first, e.last));
+        }
+        std::sort(skipped.begin(), skipped.end());
+        int nextSkipped = 0;
+
+        boundaries.clear();
+        for (int i = groupBegin; i < groupEnd; ++i) {
+            boundaries.append(lines.at(order.at(i)).first);
+            boundaries.append(lines.at(order.at(i)).last + 1);
+        }
+        std::sort(boundaries.begin(), boundaries.end());
+        boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+        active.clear();
+        int next = groupBegin;
+        for (int b = 0; b + 1 < boundaries.size(); ++b) {
+            const int first = boundaries.at(b);
+            const int last = boundaries.at(b + 1) - 1;
+            active.erase(std::remove_if(active.begin(), active.end(), [&](int i) {
+                return lines.at(i).last < first;
+            }), active.end());
+            while (next < groupEnd && lines.at(order.at(next)).first == first)
+                active.append(order.at(next++));
+            if (active.isEmpty() || crossCount <= 0)
+                continue;
+
+            sortedActive = active;
+            std::sort(sortedActive.begin(), sortedActive.end(), [&](int lhs, int rhs) {
+                return lines.at(lhs).begin < lines.at(rhs).begin;
+            });
+            int covered = 0;
+            for (int i : qAsConst(sortedActive)) {
+                if (lines.at(i).begin > covered)
+                    break;
+                covered = qMax(covered, lines.at(i).end + 1);
+            }
+            if (covered < crossCount)
+                continue;
+
+            // the ranges are tried in the order of the stored ranges
+            std::sort(active.begin(), active.end());
+            for (int line = first; line <= last; ++line) {
+                while (nextSkipped < skipped.size() && skipped.at(nextSkipped).second < line)
+                    ++nextSkipped;
+                bool selected = nextSkipped == skipped.size() || skipped.at(nextSkipped).first > line;
+                for (int cross = 0; selected && cross < crossCount; ++cross) {
+                    selected = false;
+                    for (int i : qAsConst(active)) {
+                        const Line &range = lines.at(i);
+                        if (cross < range.begin || cross > range.end)
+                            continue;
+                        if (rows) {
+                            for (int column = cross; !selected && column <= range.end; ++column)
+                                selected = model->index(line, column, parent).flags() & Qt::ItemIsSelectable;
+                        } else {
+                            const Qt::ItemFlags flags = model->index(cross, line, parent).flags();
+                            selected = (flags & Qt::ItemIsSelectable) && (flags & Qt::ItemIsEnabled);
+                        }
+                        if (selected) {
+                            cross = range.end;
+                            break;
+                        }
+                    }
+                }
+                if (!selected)
+                    continue;
+                if (!runs.isEmpty() && (runs.end() - 1).value() == line - 1)
+                    (runs.end() - 1).value() = line;
+                else
+                    runs.insert(line, line);
+            }
+        }
+        groupBegin = groupEnd;
+    }
+
+    // report each selected line with the first range of the selection covering it
+    for (const QItemSelectionRange &range : selection) {
+        const QItemSelectionRect rect(range);
+        if (!rect.valid)
+            continue;
+        const auto group = std::lower_bound(groups.begin(), groups.end(), rect.parent,
+                                            [](const Group &group, const QModelIndex &parent) {
+            return group.parent < parent;
+        });
+        if (group == groups.end() || group->parent != rect.parent)
+            continue;
+        const Line covered = toLine(rect);
+        QMap<int, int> &runs = group->runs;
+        QMap<int, int>::iterator run = runs.upperBound(covered.first);
+        if (run != runs.begin() && (run - 1).value() >= covered.first)
+            --run;
+        while (run != runs.end() && run.key() <= covered.last) {
+            const int runFirst = run.key();
+            const int runLast = run.value();
+            run = runs.erase(run);
+            const int first = qMax(runFirst, covered.first);
+            const int last = qMin(runLast, covered.last);
+            for (int line = first; line <= last; ++line) {
+                result.append(rows ? model->index(line, position, rect.parent)
+                                   : model->index(position, line, rect.parent));
+            }
+            if (runFirst < first)
+                runs.insert(runFirst, first - 1);
+            if (runLast > last) {
+                runs.insert(last + 1, runLast);
+                break;
+            }
+        }
+    }
+    return result;
+}
+
 /*!
     Returns \c true if the given model item \a index is selected.
 */
@@ -1406,7 +1924,7 @@ bool QItemSelectionModel::isSelected(const QModelIndex &index) const
     //  search model ranges
     QList<QItemSelectionRange>::const_iterator it = d->ranges.begin();
     for (; it != d->ranges.end(); ++it) {
-        if ((*it).isValid() && (*it).contains(index)) {
+        if ((*it).contains(index) && (*it).isValid()) {
             selected = true;
             break;
         }
@@ -1658,27 +2176,7 @@ QModelIndexList QItemSelectionModel::selectedIndexes() const
 
 QModelIndexList QItemSelectionModel::selectedRows(int column) const
 {
-    QModelIndexList indexes;
-    //the QSet contains pairs of parent modelIndex
-    //and row number
-    QSet< QPair<QModelIndex, int> > rowsSeen;
-
-    const QItemSelection ranges = selection();
-    for (int i = 0; i < ranges.count(); ++i) {
-        const QItemSelectionRange &range = ranges.at(i);
-        QModelIndex parent = range.parent();
-        for (int row = range.top(); row <= range.bottom(); row++) {
-            QPair<QModelIndex, int> rowDef = qMakePair(parent, row);
-            if (!rowsSeen.contains(rowDef)) {
-                rowsSeen << rowDef;
-                if (isRowSelected(row, parent)) {
-                    indexes.append(model()->index(row, column, parent));
-                }
-            }
-        }
-    }
-
-    return indexes;
+    return qSelectedLines(d_func(), selection(), Qt::Horizontal, column);
 }
 
 /*!
@@ -1690,27 +2188,7 @@ QModelIndexList QItemSelectionModel::selectedRows(int column) const
 
 QModelIndexList QItemSelectionModel::selectedColumns(int row) const
 {
-    QModelIndexList indexes;
-    //the QSet contains pairs of parent modelIndex
-    //and column number
-    QSet< QPair<QModelIndex, int> > columnsSeen;
-
-    const QItemSelection ranges = selection();
-    for (int i = 0; i < ranges.count(); ++i) {
-        const QItemSelectionRange &range = ranges.at(i);
-        QModelIndex parent = range.parent();
-        for (int column = range.left(); column <= range.right(); column++) {
-            QPair<QModelIndex, int> columnDef = qMakePair(parent, column);
-            if (!columnsSeen.contains(columnDef)) {
-                columnsSeen << columnDef;
-                if (isColumnSelected(column, parent)) {
-                    indexes.append(model()->index(row, column, parent));
-                }
-            }
-        }
-    }
-
-    return indexes;
+    return qSelectedLines(d_func(), selection(), Qt::Vertical, row);
 }
 
 /*!
@@ -1816,55 +2294,67 @@ void QItemSelectionModel::emitSelectionChanged(const QItemSelection &newSelectio
         return;
     }
 
-    QItemSelection deselected = oldSelection;
-    QItemSelection selected = newSelection;
-
-    // remove equal ranges
-    bool advance;
-    for (int o = 0; o < deselected.count(); ++o) {
-        advance = true;
-        for (int s = 0; s < selected.count() && o < deselected.count();) {
-            if (deselected.at(o) == selected.at(s)) {
-                deselected.removeAt(o);
-                selected.removeAt(s);
-                advance = false;
-            } else {
-                ++s;
+    // remove equal ranges, starting after those both selections begin with.
+    // Like the nested loops this replaces, an old range following one which
+    // was removed is only compared with the new ranges after the one removed
+    // with it, and an old range following one which was compared with all of
+    // them is skipped. The equal ranges left cancel out when they are split
+    // below; matching which ones are left keeps the order ranges are reported in.
+    const int size = qMin(oldSelection.size(), newSelection.size());
+    int common = 0;
+    while (common < size && oldSelection.at(common) == newSelection.at(common))
+        ++common;
+    typedef QPair<QPersistentModelIndex, QPersistentModelIndex> RangeKey;
+    QHash<RangeKey, QVector<int> > positions;
+    for (int s = common; s < newSelection.size(); ++s) {
+        const QItemSelectionRange &range = newSelection.at(s);
+        positions[qMakePair(range.topLeft(), range.bottomRight())].append(s);
+    }
+    QVector<bool> removed(newSelection.size());
+    const auto removeEqual = [&](const QItemSelectionRange &range, int from) {
+        const QHash<RangeKey, QVector<int> >::const_iterator it =
+                positions.constFind(qMakePair(range.topLeft(), range.bottomRight()));
+        if (it == positions.constEnd())
+            return -1;
+        for (auto s = std::lower_bound(it->cbegin(), it->cend(), from); s != it->cend(); ++s) {
+            if (!removed.at(*s)) {
+                removed[*s] = true;
+                return *s;
             }
         }
-        if (advance)
-            ++o;
+        return -1;
+    };
+    QItemSelection deselected;
+    int from = common;
+    bool advance = common == 0;
+    for (int o = common; o < oldSelection.size(); ++o) {
+        const QItemSelectionRange &range = oldSelection.at(o);
+        const int s = removeEqual(range, from);
+        if (s >= 0) {
+            from = s;
+            advance = false;
+            continue;
+        }
+        deselected.append(range);
+        if (advance && ++o < oldSelection.size())
+            deselected.append(oldSelection.at(o));
+        from = common;
+        advance = true;
+    }
+    QItemSelection selected;
+    for (int s = common; s < newSelection.size(); ++s) {
+        if (!removed.at(s))
+            selected.append(newSelection.at(s));
     }
 
     // find intersections
-    QItemSelection intersections;
-    for (int o = 0; o < deselected.count(); ++o) {
-        for (int s = 0; s < selected.count(); ++s) {
-            if (deselected.at(o).intersects(selected.at(s)))
-                intersections.append(deselected.at(o).intersected(selected.at(s)));
-        }
-    }
+    const QVector<QItemSelectionRect> intersections =
+            qSelectionIntersections(qSelectionRects(deselected), selected);
 
     // compare remaining ranges with intersections and split them to find deselected and selected
-    for (int i = 0; i < intersections.count(); ++i) {
-        // split deselected
-        for (int o = 0; o < deselected.count();) {
-            if (deselected.at(o).intersects(intersections.at(i))) {
-                QItemSelection::split(deselected.at(o), intersections.at(i), &deselected);
-                deselected.removeAt(o);
-            } else {
-                ++o;
-            }
-        }
-        // split selected
-        for (int s = 0; s < selected.count();) {
-            if (selected.at(s).intersects(intersections.at(i))) {
-                QItemSelection::split(selected.at(s), intersections.at(i), &selected);
-                selected.removeAt(s);
-            } else {
-                ++s;
-            }
-        }
+    if (!intersections.isEmpty()) {
+        qSelectionSubtract(&deselected, intersections);
+        qSelectionSubtract(&selected, intersections);
     }
 
     if (!selected.isEmpty() || !deselected.isEmpty())
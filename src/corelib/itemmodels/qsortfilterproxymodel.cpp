@@ -47,8 +47,14 @@
 #include <qdatetime.h>
 #include <qpair.h>
 #include <qstringlist.h>
+#ifndef QT_NO_THREAD
+#include <qthreadpool.h>
+#endif
 #include <private/qabstractitemmodel_p.h>
 #include <private/qabstractproxymodel_p.h>
+#ifndef QT_NO_THREAD
+#include <private/qparallelchunkjob_p.h>
+#endif
 
 #include <algorithm>
 
@@ -65,6 +71,21 @@ static inline QSet<int> qVectorToSet(const QVector<int> &vector)
     return set;
 }
 
+/*
+  Returns true if every string matched by \a narrower is also matched by
+  \a wider, as when the user types one more letter of a fixed string filter.
+*/
+static bool qIsNarrowingFilter(const QRegExp &wider, const QRegExp &narrower)
+{
+    if (wider.isEmpty()) // accepts everything
+        return true;
+    if (wider.patternSyntax() != QRegExp::FixedString || narrower.patternSyntax() != QRegExp::FixedString)
+        return false;
+    if (wider.caseSensitivity() == Qt::CaseSensitive && narrower.caseSensitivity() == Qt::CaseInsensitive)
+        return false;
+    return narrower.pattern().contains(wider.pattern(), wider.caseSensitivity());
+}
+
 class QSortFilterProxyModelLessThan
 {
 public:
@@ -140,6 +161,100 @@ private:
     int end;
 };
 
+#ifndef QT_NO_THREAD
+namespace {
+enum { QSortFilterProxyModelChunkSize = 1024 }; // rows per chunk, for the jobs going through rows
+
+/*
+  Sorts \a count rows in \a segments segments of about the same size (width == 0),
+  or merges pairs of adjacent runs of \a width already sorted segments.
+*/
+template <typename LessThan>
+class QSortFilterProxyModelSortJob : public QParallelChunkJob
+{
+public:
+    QSortFilterProxyModelSortJob(int *rows, int count, int segments, int width,
+                                 const LessThan &lessThan)
+        : QParallelChunkJob(width ? segments / (2 * width) : segments),
+          rows(rows), count(count), segments(segments), width(width), lessThan(lessThan)
+    {
+    }
+
+protected:
+    void processChunk(int chunk) Q_DECL_OVERRIDE
+    {
+        if (width == 0) {
+            std::stable_sort(rows + bound(chunk), rows + bound(chunk + 1), lessThan);
+        } else {
+            const int first = 2 * width * chunk;
+            std::inplace_merge(rows + bound(first), rows + bound(first + width),
+                               rows + bound(first + 2 * width), lessThan);
+        }
+    }
+
+private:
+    int bound(int segment) const { return int(qint64(count) * segment / segments); }
+
+    int * const rows;
+    const int count;
+    const int segments;
+    const int width;
+    const LessThan lessThan;
+};
+
+/*
+  Calls \a function for each index in [0, \a count).
+*/
+template <typename Function>
+class QSortFilterProxyModelRangeJob : public QParallelChunkJob
+{
+public:
+    QSortFilterProxyModelRangeJob(int count, const Function &function)
+        : QParallelChunkJob((count + QSortFilterProxyModelChunkSize - 1) / QSortFilterProxyModelChunkSize),
+          count(count), function(function)
+    {
+    }
+
+protected:
+    void processChunk(int chunk) Q_DECL_OVERRIDE
+    {
+        const int end = qMin(count, (chunk + 1) * int(QSortFilterProxyModelChunkSize));
+        for (int i = chunk * QSortFilterProxyModelChunkSize; i < end; ++i)
+            function(i);
+    }
+
+private:
+    const int count;
+    const Function function;
+};
+} // unnamed namespace
+
+template <typename Function>
+static void qParallelFor(int count, const Function &function)
+{
+    QSortFilterProxyModelRangeJob<Function> job(count, function);
+    job.execute(QThreadPool::globalInstance());
+}
+
+/*
+  Same result as std::stable_sort(): the segments are sorted in parallel and then
+  merged pairwise, the left run first on ties.
+*/
+template <typename LessThan>
+static void qParallelStableSort(QVector<int> &rows, const LessThan &lessThan)
+{
+    const int maxThreads = QThreadPool::globalInstance()->maxThreadCount();
+    int segments = 2;
+    while (segments < maxThreads)
+        segments *= 2;
+    int * const data = rows.data();
+    for (int width = 0; width < segments; width = width ? 2 * width : 1) {
+        QSortFilterProxyModelSortJob<LessThan> job(data, rows.size(), segments, width, lessThan);
+        job.execute(QThreadPool::globalInstance());
+    }
+}
+#endif // QT_NO_THREAD
+
 class QSortFilterProxyModelPrivate : public QAbstractProxyModelPrivate
 {
     Q_DECLARE_PUBLIC(QSortFilterProxyModel)
@@ -152,6 +267,9 @@ public:
         QVector<int> proxy_columns;
         QVector<QModelIndex> mapped_children;
         QHash<QModelIndex, Mapping *>::const_iterator map_iter;
+        // filterAcceptsRow() last gave the results of its default implementation,
+        // and no row filtered out has changed since
+        bool default_row_filter;
     };
 
     mutable QHash<QModelIndex, Mapping*> source_index_mapping;
@@ -168,8 +286,27 @@ public:
     int filter_role;
 
     bool dynamic_sortfilter;
+    bool parallel_sortfilter;
     QRowsRemoval itemsBeingRemoved;
 
+    // Where the default filterAcceptsRow() records its results (1 if the row
+    // was rejected, 2 if accepted), while filter_rows() is running
+    struct DefaultFilterResults {
+        QModelIndex source_parent;
+        char *results;
+        int count;
+    };
+    mutable const DefaultFilterResults *default_filter_results;
+
+    // The sort role data of the rows being sorted, so that the default
+    // lessThan() asks the source model only once per row
+    struct SortKeyCache {
+        QModelIndex source_parent;
+        QVector<QVariant> keys; // indexed by source row
+        bool prefetched;
+    };
+    mutable SortKeyCache *sort_key_cache;
+
     QModelIndexPairList saved_persistent_indexes;
 
     QHash<QModelIndex, Mapping *>::const_iterator create_mapping(
@@ -242,6 +379,18 @@ public:
 
     void _q_clearMapping();
 
+    bool filter_regexp_accepts_row(int source_row, const QModelIndex &source_parent) const;
+    bool filter_rows(const QModelIndex &source_parent, const QVector<int> *rows,
+                     QVector<char> &accepted) const;
+    QVariant sort_key(const QModelIndex &source_index) const;
+#ifndef QT_NO_THREAD
+    bool use_parallel_sortfilter(int count) const;
+    void apply_filtered_rows(
+        QVector<int> &source_to_proxy, QVector<int> &proxy_to_source,
+        const QVector<char> &accepted, const QVector<int> &source_items_insert,
+        const QModelIndex &source_parent);
+#endif
+
     void sort();
     bool update_source_sort_column();
     void sort_source_rows(QVector<int> &source_rows,
@@ -265,6 +414,8 @@ public:
         Qt::Orientation orient, bool emit_signal = true);
     void build_source_to_proxy_mapping(
         const QVector<int> &proxy_to_source, QVector<int> &source_to_proxy) const;
+    void update_source_to_proxy_mapping(
+        const QVector<int> &proxy_to_source, QVector<int> &source_to_proxy, int proxy_start) const;
     void source_items_inserted(const QModelIndex &source_parent,
                                int start, int end, Qt::Orientation orient);
     void source_items_about_to_be_removed(const QModelIndex &source_parent,
@@ -279,10 +430,11 @@ public:
     void update_persistent_indexes(const QModelIndexPairList &source_indexes);
 
     void filter_about_to_be_changed(const QModelIndex &source_parent = QModelIndex());
-    void filter_changed(const QModelIndex &source_parent = QModelIndex());
+    void filter_changed(const QModelIndex &source_parent = QModelIndex(), bool narrowing = false);
     QSet<int> handle_filter_changed(
         QVector<int> &source_to_proxy, QVector<int> &proxy_to_source,
-        const QModelIndex &source_parent, Qt::Orientation orient);
+        const QModelIndex &source_parent, Qt::Orientation orient, bool narrowing);
+    void update_filter_regexp(const QRegExp &regexp);
 
     void updateChildrenMapping(const QModelIndex &source_parent, Mapping *parent_mapping,
                                Qt::Orientation orient, int start, int end, int delta_item_count, bool remove);
@@ -292,6 +444,156 @@ public:
 
 typedef QHash<QModelIndex, QSortFilterProxyModelPrivate::Mapping *> IndexMap;
 
+/*!
+  \internal
+
+  Evaluates filterAcceptsRow() for the rows of \a source_parent listed in
+  \a rows, or for all of them if \a rows is null, and stores the results in
+  \a accepted, which is indexed by source row.
+
+  Returns \c true if filterAcceptsRow() returned what its default
+  implementation returns for each of these rows. A narrowing filter can then
+  only reject rows that are accepted now.
+*/
+bool QSortFilterProxyModelPrivate::filter_rows(const QModelIndex &source_parent,
+                                               const QVector<int> *rows,
+                                               QVector<char> &accepted) const
+{
+    Q_Q(const QSortFilterProxyModel);
+    const int source_count = accepted.size();
+    const int count = rows ? rows->size() : source_count;
+    const int * const row_list = rows ? rows->constData() : Q_NULLPTR;
+    char * const results = accepted.data();
+
+    QVector<char> default_results(source_count);
+    const DefaultFilterResults probe = { source_parent, default_results.data(), source_count };
+    const DefaultFilterResults * const outer_probe = default_filter_results;
+    default_filter_results = &probe;
+
+#ifndef QT_NO_THREAD
+    if (use_parallel_sortfilter(count)) {
+        // QString::contains() copies the regexp, which is only safe to do from
+        // several threads once the matching engine has been created
+        filter_regexp.indexIn(QString());
+        qParallelFor(count, [=](int i) {
+            const int row = row_list ? row_list[i] : i;
+            results[row] = q->filterAcceptsRow(row, source_parent);
+        });
+    } else
+#endif
+    {
+        for (int i = 0; i < count; ++i) {
+            const int row = row_list ? row_list[i] : i;
+            results[row] = q->filterAcceptsRow(row, source_parent);
+        }
+    }
+    default_filter_results = outer_probe;
+
+    for (int i = 0; i < count; ++i) {
+        const int row = row_list ? row_list[i] : i;
+        if (default_results.at(row) != (results[row] ? 2 : 1))
+            return false;
+    }
+    return true;
+}
+
+/*!
+  \internal
+
+  Returns the sort role data of \a source_index, from the cache while
+  sort_source_rows() is sorting the rows it belongs to.
+*/
+QVariant QSortFilterProxyModelPrivate::sort_key(const QModelIndex &source_index) const
+{
+    const QAbstractItemModel *source_model = source_index.model();
+    if (!source_model)
+        return QVariant();
+    SortKeyCache * const cache = sort_key_cache;
+    if (cache && source_model == model && source_index.column() == source_sort_column
+        && source_index.row() < cache->keys.size() && source_index.parent() == cache->source_parent) {
+        if (cache->prefetched) {
+            // the cache may be shared by several threads, only read it
+            const QVariant &key = cache->keys.at(source_index.row());
+            if (key.isValid())
+                return key;
+        } else {
+            QVariant &key = cache->keys[source_index.row()];
+            if (!key.isValid())
+                key = model->data(source_index, sort_role);
+            return key;
+        }
+    }
+    return source_model->data(source_index, sort_role);
+}
+
+#ifndef QT_NO_THREAD
+/*!
+  \internal
+
+  Returns \c true if \a count rows are filtered and sorted using the threads
+  of the global thread pool. With a single thread, the filter is still
+  evaluated for all rows before the result is applied in one go.
+*/
+bool QSortFilterProxyModelPrivate::use_parallel_sortfilter(int count) const
+{
+    return parallel_sortfilter && count >= 4 * QSortFilterProxyModelChunkSize;
+}
+
+/*!
+  \internal
+
+  Removes the rows of \a source_parent that are not \a accepted anymore and
+  merges the sorted \a source_items_insert into the mapping, with a single
+  layout change. Removing and inserting each interval of rows separately
+  rebuilds \a source_to_proxy every time, which is quadratic when a filter
+  change affects rows all over a large model.
+*/
+void QSortFilterProxyModelPrivate::apply_filtered_rows(
+    QVector<int> &source_to_proxy, QVector<int> &proxy_to_source,
+    const QVector<char> &accepted, const QVector<int> &source_items_insert,
+    const QModelIndex &source_parent)
+{
+    Q_Q(QSortFilterProxyModel);
+    QList<QPersistentModelIndex> parents;
+    if (source_parent.isValid())
+        parents << q->mapFromSource(source_parent);
+    emit q->layoutAboutToBeChanged(parents);
+    const QModelIndexPairList source_indexes = store_persistent_indexes();
+
+    QVector<int> source_items_keep;
+    source_items_keep.reserve(proxy_to_source.size());
+    for (int source_item : qAsConst(proxy_to_source)) {
+        if (accepted.at(source_item))
+            source_items_keep.append(source_item);
+    }
+
+    // New rows go after the equal rows already there, as in insert_source_items()
+    QVector<int> merged(source_items_keep.size() + source_items_insert.size());
+    if (source_sort_column >= 0 && dynamic_sortfilter) {
+        if (sort_order == Qt::AscendingOrder) {
+            QSortFilterProxyModelLessThan lt(source_sort_column, source_parent, model, q);
+            std::merge(source_items_keep.constBegin(), source_items_keep.constEnd(),
+                       source_items_insert.constBegin(), source_items_insert.constEnd(),
+                       merged.begin(), lt);
+        } else {
+            QSortFilterProxyModelGreaterThan gt(source_sort_column, source_parent, model, q);
+            std::merge(source_items_keep.constBegin(), source_items_keep.constEnd(),
+                       source_items_insert.constBegin(), source_items_insert.constEnd(),
+                       merged.begin(), gt);
+        }
+    } else {
+        std::merge(source_items_keep.constBegin(), source_items_keep.constEnd(),
+                   source_items_insert.constBegin(), source_items_insert.constEnd(),
+                   merged.begin());
+    }
+    proxy_to_source.swap(merged);
+    build_source_to_proxy_mapping(proxy_to_source, source_to_proxy);
+
+    update_persistent_indexes(source_indexes);
+    emit q->layoutChanged(parents);
+}
+#endif // QT_NO_THREAD
+
 void QSortFilterProxyModelPrivate::_q_sourceModelDestroyed()
 {
     QAbstractProxyModelPrivate::_q_sourceModelDestroyed();
@@ -337,9 +639,11 @@ IndexMap::const_iterator QSortFilterProxyModelPrivate::create_mapping(
     Mapping *m = new Mapping;
 
     int source_rows = model->rowCount(source_parent);
+    QVector<char> accepted(source_rows);
+    m->default_row_filter = filter_rows(source_parent, Q_NULLPTR, accepted);
     m->source_rows.reserve(source_rows);
     for (int i = 0; i < source_rows; ++i) {
-        if (q->filterAcceptsRow(i, source_parent))
+        if (accepted.at(i))
             m->source_rows.append(i);
     }
     int source_cols = model->columnCount(source_parent);
@@ -487,13 +791,51 @@ void QSortFilterProxyModelPrivate::sort_source_rows(
 {
     Q_Q(const QSortFilterProxyModel);
     if (source_sort_column >= 0) {
+#ifndef QT_NO_THREAD
+        const bool parallel = use_parallel_sortfilter(source_rows.size())
+            && QThreadPool::globalInstance()->maxThreadCount() > 1;
+#endif
+        // Let the default lessThan() fetch the sort role data only once per row,
+        // unless a few rows are sorted among many, as when rows get inserted
+        SortKeyCache cache;
+        SortKeyCache * const outer_cache = sort_key_cache;
+        const int source_count = model->rowCount(source_parent);
+        if (source_rows.size() > 2 && source_rows.size() * 4 >= source_count) {
+            cache.source_parent = source_parent;
+            cache.keys.resize(source_count);
+            cache.prefetched = false;
+#ifndef QT_NO_THREAD
+            if (parallel) {
+                QVariant * const keys = cache.keys.data();
+                const int * const rows = source_rows.constData();
+                qParallelFor(source_rows.size(), [=](int i) {
+                    const QModelIndex source_index = model->index(rows[i], source_sort_column, source_parent);
+                    keys[rows[i]] = model->data(source_index, sort_role);
+                });
+                cache.prefetched = true;
+            }
+#endif
+            sort_key_cache = &cache;
+        }
+
         if (sort_order == Qt::AscendingOrder) {
             QSortFilterProxyModelLessThan lt(source_sort_column, source_parent, model, q);
-            std::stable_sort(source_rows.begin(), source_rows.end(), lt);
+#ifndef QT_NO_THREAD
+            if (parallel)
+                qParallelStableSort(source_rows, lt);
+            else
+#endif
+                std::stable_sort(source_rows.begin(), source_rows.end(), lt);
         } else {
             QSortFilterProxyModelGreaterThan gt(source_sort_column, source_parent, model, q);
-            std::stable_sort(source_rows.begin(), source_rows.end(), gt);
+#ifndef QT_NO_THREAD
+            if (parallel)
+                qParallelStableSort(source_rows, gt);
+            else
+#endif
+                std::stable_sort(source_rows.begin(), source_rows.end(), gt);
         }
+        sort_key_cache = outer_cache;
     } else { // restore the source model order
         std::stable_sort(source_rows.begin(), source_rows.end());
     }
@@ -586,9 +928,12 @@ void QSortFilterProxyModelPrivate::remove_proxy_interval(
     }
 
     // Remove items from proxy-to-source mapping
+    for (int proxy_item = proxy_start; proxy_item <= proxy_end; ++proxy_item)
+        source_to_proxy[proxy_to_source.at(proxy_item)] = -1;
     proxy_to_source.remove(proxy_start, proxy_end - proxy_start + 1);
 
-    build_source_to_proxy_mapping(proxy_to_source, source_to_proxy);
+    // Only the items after the interval have moved
+    update_source_to_proxy_mapping(proxy_to_source, source_to_proxy, proxy_start);
 
     if (emit_signal) {
         if (orient == Qt::Vertical)
@@ -711,10 +1056,12 @@ void QSortFilterProxyModelPrivate::insert_source_items(
                 q->beginInsertColumns(proxy_parent, proxy_start, proxy_end);
         }
 
-        for (int i = 0; i < source_items.size(); ++i)
-            proxy_to_source.insert(proxy_start + i, source_items.at(i));
+        proxy_to_source.insert(proxy_start, source_items.size(), 0);
+        std::copy(source_items.constBegin(), source_items.constEnd(),
+                  proxy_to_source.begin() + proxy_start);
 
-        build_source_to_proxy_mapping(proxy_to_source, source_to_proxy);
+        // Only the items from the interval on have moved
+        update_source_to_proxy_mapping(proxy_to_source, source_to_proxy, proxy_start);
 
         if (emit_signal) {
             if (orient == Qt::Vertical)
@@ -1008,6 +1355,22 @@ void QSortFilterProxyModelPrivate::build_source_to_proxy_mapping(
         source_to_proxy[proxy_to_source.at(i)] = i;
 }
 
+/*!
+  \internal
+
+  Updates the source-to-proxy mapping of the items that moved to proxy
+  positions \a proxy_start and later. The mapping of the other items must
+  be up to date.
+*/
+void QSortFilterProxyModelPrivate::update_source_to_proxy_mapping(
+    const QVector<int> &proxy_to_source, QVector<int> &source_to_proxy, int proxy_start) const
+{
+    int proxy_count = proxy_to_source.size();
+    int *mapping = source_to_proxy.data();
+    for (int i = proxy_start; i < proxy_count; ++i)
+        mapping[proxy_to_source.at(i)] = i;
+}
+
 /*!
   \internal
 
@@ -1072,14 +1435,14 @@ void QSortFilterProxyModelPrivate::filter_about_to_be_changed(const QModelIndex
   Updates the proxy model (adds/removes rows) based on the
   new filter.
 */
-void QSortFilterProxyModelPrivate::filter_changed(const QModelIndex &source_parent)
+void QSortFilterProxyModelPrivate::filter_changed(const QModelIndex &source_parent, bool narrowing)
 {
     IndexMap::const_iterator it = source_index_mapping.constFind(source_parent);
     if (it == source_index_mapping.constEnd())
         return;
     Mapping *m = it.value();
-    QSet<int> rows_removed = handle_filter_changed(m->proxy_rows, m->source_rows, source_parent, Qt::Vertical);
-    QSet<int> columns_removed = handle_filter_changed(m->proxy_columns, m->source_columns, source_parent, Qt::Horizontal);
+    QSet<int> rows_removed = handle_filter_changed(m->proxy_rows, m->source_rows, source_parent, Qt::Vertical, narrowing);
+    QSet<int> columns_removed = handle_filter_changed(m->proxy_columns, m->source_columns, source_parent, Qt::Horizontal, false);
 
     // We need to iterate over a copy of m->mapped_children because otherwise it may be changed by other code, invalidating
     // the iterator it2.
@@ -1093,7 +1456,7 @@ void QSortFilterProxyModelPrivate::filter_changed(const QModelIndex &source_pare
             indexesToRemove.push_back(i);
             remove_from_mapping(source_child_index);
         } else {
-            filter_changed(source_child_index);
+            filter_changed(source_child_index, narrowing);
         }
     }
     QVector<int>::const_iterator removeIt = indexesToRemove.constEnd();
@@ -1110,36 +1473,92 @@ void QSortFilterProxyModelPrivate::filter_changed(const QModelIndex &source_pare
     }
 }
 
+/*!
+  \internal
+
+  Sets the filter to \a regexp. Only the rows that are accepted now are
+  tested again if \a regexp matches a subset of what the current filter
+  matches.
+*/
+void QSortFilterProxyModelPrivate::update_filter_regexp(const QRegExp &regexp)
+{
+    filter_about_to_be_changed();
+    const bool narrowing = qIsNarrowingFilter(filter_regexp, regexp);
+    filter_regexp = regexp;
+    filter_changed(QModelIndex(), narrowing);
+}
+
 /*!
   \internal
   returns the removed items indexes
 */
 QSet<int> QSortFilterProxyModelPrivate::handle_filter_changed(
     QVector<int> &source_to_proxy, QVector<int> &proxy_to_source,
-    const QModelIndex &source_parent, Qt::Orientation orient)
+    const QModelIndex &source_parent, Qt::Orientation orient, bool narrowing)
 {
     Q_Q(QSortFilterProxyModel);
-    // Figure out which mapped items to remove
     QVector<int> source_items_remove;
-    for (int i = 0; i < proxy_to_source.count(); ++i) {
-        const int source_item = proxy_to_source.at(i);
-        if ((orient == Qt::Vertical)
-            ? !q->filterAcceptsRow(source_item, source_parent)
-            : !q->filterAcceptsColumn(source_item, source_parent)) {
-            // This source item does not satisfy the filter, so it must be removed
-            source_items_remove.append(source_item);
-        }
-    }
-    // Figure out which non-mapped items to insert
     QVector<int> source_items_insert;
     int source_count = source_to_proxy.size();
-    for (int source_item = 0; source_item < source_count; ++source_item) {
-        if (source_to_proxy.at(source_item) == -1) {
-            if ((orient == Qt::Vertical)
-                ? q->filterAcceptsRow(source_item, source_parent)
-                : q->filterAcceptsColumn(source_item, source_parent)) {
-                // This source item satisfies the filter, so it must be added
-                source_items_insert.append(source_item);
+    if (orient == Qt::Vertical) {
+        Mapping *m = source_index_mapping.value(source_parent);
+        // A narrowing filter cannot accept the rows that are filtered out now,
+        // unless filterAcceptsRow() accepts rows its default implementation rejects
+        const bool mapped_rows_only = narrowing && m->default_row_filter;
+        QVector<char> accepted(source_count);
+        m->default_row_filter = filter_rows(source_parent,
+                                            mapped_rows_only ? &proxy_to_source : Q_NULLPTR,
+                                            accepted);
+        // Figure out which mapped rows to remove
+        for (int i = 0; i < proxy_to_source.count(); ++i) {
+            const int source_item = proxy_to_source.at(i);
+            if (!accepted.at(source_item))
+                source_items_remove.append(source_item);
+        }
+        // Figure out which non-mapped rows to insert
+        if (!mapped_rows_only) {
+            for (int source_item = 0; source_item < source_count; ++source_item) {
+                if (source_to_proxy.at(source_item) == -1 && accepted.at(source_item))
+                    source_items_insert.append(source_item);
+            }
+        }
+#ifndef QT_NO_THREAD
+        if (use_parallel_sortfilter(source_count)
+            && (!source_items_remove.isEmpty() || !source_items_insert.isEmpty())) {
+            // Rows that go away together with mapped children need the row removal
+            // signals, so that the persistent indexes of their children are invalidated
+            bool removes_mapped_children = false;
+            for (const QModelIndex &source_child : qAsConst(m->mapped_children)) {
+                const int source_item = source_child.row();
+                if (source_to_proxy.at(source_item) != -1 && !accepted.at(source_item)) {
+                    removes_mapped_children = true;
+                    break;
+                }
+            }
+            if (!removes_mapped_children) {
+                sort_source_rows(source_items_insert, source_parent);
+                apply_filtered_rows(source_to_proxy, proxy_to_source, accepted,
+                                    source_items_insert, source_parent);
+                return qVectorToSet(source_items_remove);
+            }
+        }
+#endif
+    } else {
+        // Figure out which mapped items to remove
+        for (int i = 0; i < proxy_to_source.count(); ++i) {
+            const int source_item = proxy_to_source.at(i);
+            if (!q->filterAcceptsColumn(source_item, source_parent)) {
+                // This source item does not satisfy the filter, so it must be removed
+                source_items_remove.append(source_item);
+            }
+        }
+        // Figure out which non-mapped items to insert
+        for (int source_item = 0; source_item < source_count; ++source_item) {
+            if (source_to_proxy.at(source_item) == -1) {
+                if (q->filterAcceptsColumn(source_item, source_parent)) {
+                    // This source item satisfies the filter, so it must be added
+                    source_items_insert.append(source_item);
+                }
             }
         }
     }
@@ -1198,6 +1617,8 @@ void QSortFilterProxyModelPrivate::_q_sourceDataChanged(const QModelIndex &sourc
         } else {
             if (m->proxy_rows.at(source_row) != -1)
                 source_rows_change.append(source_row);
+            else // not filtered again, a narrower filter may accept it now
+                m->default_row_filter = false;
         }
     }
 
@@ -1736,6 +2157,9 @@ QSortFilterProxyModel::QSortFilterProxyModel(QObject *parent)
     d->filter_column = 0;
     d->filter_role = Qt::DisplayRole;
     d->dynamic_sortfilter = true;
+    d->parallel_sortfilter = false;
+    d->default_filter_results = Q_NULLPTR;
+    d->sort_key_cache = Q_NULLPTR;
     connect(this, SIGNAL(modelReset()), this, SLOT(_q_clearMapping()));
 }
 
@@ -2326,9 +2750,7 @@ QRegExp QSortFilterProxyModel::filterRegExp() const
 void QSortFilterProxyModel::setFilterRegExp(const QRegExp &regExp)
 {
     Q_D(QSortFilterProxyModel);
-    d->filter_about_to_be_changed();
-    d->filter_regexp = regExp;
-    d->filter_changed();
+    d->update_filter_regexp(regExp);
 }
 
 /*!
@@ -2374,9 +2796,9 @@ void QSortFilterProxyModel::setFilterCaseSensitivity(Qt::CaseSensitivity cs)
     Q_D(QSortFilterProxyModel);
     if (cs == d->filter_regexp.caseSensitivity())
         return;
-    d->filter_about_to_be_changed();
-    d->filter_regexp.setCaseSensitivity(cs);
-    d->filter_changed();
+    QRegExp regexp(d->filter_regexp);
+    regexp.setCaseSensitivity(cs);
+    d->update_filter_regexp(regexp);
 }
 
 /*!
@@ -2440,10 +2862,10 @@ void QSortFilterProxyModel::setSortLocaleAware(bool on)
 void QSortFilterProxyModel::setFilterRegExp(const QString &pattern)
 {
     Q_D(QSortFilterProxyModel);
-    d->filter_about_to_be_changed();
-    d->filter_regexp.setPatternSyntax(QRegExp::RegExp);
-    d->filter_regexp.setPattern(pattern);
-    d->filter_changed();
+    QRegExp regexp(d->filter_regexp);
+    regexp.setPatternSyntax(QRegExp::RegExp);
+    regexp.setPattern(pattern);
+    d->update_filter_regexp(regexp);
 }
 
 /*!
@@ -2455,10 +2877,10 @@ void QSortFilterProxyModel::setFilterRegExp(const QString &pattern)
 void QSortFilterProxyModel::setFilterWildcard(const QString &pattern)
 {
     Q_D(QSortFilterProxyModel);
-    d->filter_about_to_be_changed();
-    d->filter_regexp.setPatternSyntax(QRegExp::Wildcard);
-    d->filter_regexp.setPattern(pattern);
-    d->filter_changed();
+    QRegExp regexp(d->filter_regexp);
+    regexp.setPatternSyntax(QRegExp::Wildcard);
+    regexp.setPattern(pattern);
+    d->update_filter_regexp(regexp);
 }
 
 /*!
@@ -2470,10 +2892,10 @@ void QSortFilterProxyModel::setFilterWildcard(const QString &pattern)
 void QSortFilterProxyModel::setFilterFixedString(const QString &pattern)
 {
     Q_D(QSortFilterProxyModel);
-    d->filter_about_to_be_changed();
-    d->filter_regexp.setPatternSyntax(QRegExp::FixedString);
-    d->filter_regexp.setPattern(pattern);
-    d->filter_changed();
+    QRegExp regexp(d->filter_regexp);
+    regexp.setPatternSyntax(QRegExp::FixedString);
+    regexp.setPattern(pattern);
+    d->update_filter_regexp(regexp);
 }
 
 /*!
@@ -2555,6 +2977,45 @@ void QSortFilterProxyModel::setFilterRole(int role)
     d->filter_changed();
 }
 
+/*!
+    \since 5.8
+    \property QSortFilterProxyModel::parallelSortFilter
+    \brief whether large models are filtered and sorted using several threads
+
+    When this property is true, the rows of large source models are filtered
+    and sorted by the threads of QThreadPool::globalInstance() together with
+    the calling thread. The sort order is the same as when sorting with a
+    single thread.
+
+    When the filter changes, it is evaluated for all rows before the proxy
+    model is updated. The rows that are filtered out or in are then applied in
+    a single layout change, announced with layoutAboutToBeChanged() and
+    layoutChanged(), instead of a pair of rowsAboutToBeRemoved() and
+    rowsRemoved() or rowsAboutToBeInserted() and rowsInserted() signals for
+    every range of rows. Persistent indexes to rows that are filtered out
+    become invalid.
+
+    Only enable this property if filterAcceptsRow() and lessThan() are
+    thread-safe. In particular, the source model's index() and data()
+    functions, for filterRole() and sortRole(), are then called from several
+    threads at the same time.
+
+    The default value is false.
+
+    \sa filterAcceptsRow(), lessThan(), QThreadPool::maxThreadCount()
+*/
+bool QSortFilterProxyModel::parallelSortFilter() const
+{
+    Q_D(const QSortFilterProxyModel);
+    return d->parallel_sortfilter;
+}
+
+void QSortFilterProxyModel::setParallelSortFilter(bool enable)
+{
+    Q_D(QSortFilterProxyModel);
+    d->parallel_sortfilter = enable;
+}
+
 /*!
     \obsolete
 
@@ -2650,8 +3111,8 @@ void QSortFilterProxyModel::invalidateFilter()
 bool QSortFilterProxyModel::lessThan(const QModelIndex &source_left, const QModelIndex &source_right) const
 {
     Q_D(const QSortFilterProxyModel);
-    QVariant l = (source_left.model() ? source_left.model()->data(source_left, d->sort_role) : QVariant());
-    QVariant r = (source_right.model() ? source_right.model()->data(source_right, d->sort_role) : QVariant());
+    QVariant l = d->sort_key(source_left);
+    QVariant r = d->sort_key(source_right);
     // Duplicated in QStandardItem::operator<()
     if (l.userType() == QVariant::Invalid)
         return false;
@@ -2705,23 +3166,33 @@ bool QSortFilterProxyModel::lessThan(const QModelIndex &source_left, const QMode
 bool QSortFilterProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
 {
     Q_D(const QSortFilterProxyModel);
-    if (d->filter_regexp.isEmpty())
+    const bool accepted = d->filter_regexp_accepts_row(source_row, source_parent);
+    if (const QSortFilterProxyModelPrivate::DefaultFilterResults *probe = d->default_filter_results) {
+        if (source_parent == probe->source_parent && uint(source_row) < uint(probe->count))
+            probe->results[source_row] = accepted ? 2 : 1;
+    }
+    return accepted;
+}
+
+bool QSortFilterProxyModelPrivate::filter_regexp_accepts_row(int source_row, const QModelIndex &source_parent) const
+{
+    if (filter_regexp.isEmpty())
         return true;
-    if (d->filter_column == -1) {
-        int column_count = d->model->columnCount(source_parent);
+    if (filter_column == -1) {
+        int column_count = model->columnCount(source_parent);
         for (int column = 0; column < column_count; ++column) {
-            QModelIndex source_index = d->model->index(source_row, column, source_parent);
-            QString key = d->model->data(source_index, d->filter_role).toString();
-            if (key.contains(d->filter_regexp))
+            QModelIndex source_index = model->index(source_row, column, source_parent);
+            QString key = model->data(source_index, filter_role).toString();
+            if (key.contains(filter_regexp))
                 return true;
         }
         return false;
     }
-    QModelIndex source_index = d->model->index(source_row, d->filter_column, source_parent);
+    QModelIndex source_index = model->index(source_row, filter_column, source_parent);
     if (!source_index.isValid()) // the column may not exist
         return true;
-    QString key = d->model->data(source_index, d->filter_role).toString();
-    return key.contains(d->filter_regexp);
+    QString key = model->data(source_index, filter_role).toString();
+    return key.contains(filter_regexp);
 }
 
 /*!
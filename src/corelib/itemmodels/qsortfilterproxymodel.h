@@ -67,6 +67,7 @@ class Q_CORE_EXPORT QSortFilterProxyModel : public QAbstractProxyModel
     Q_PROPERTY(bool isSortLocaleAware READ isSortLocaleAware WRITE setSortLocaleAware)
     Q_PROPERTY(int sortRole READ sortRole WRITE setSortRole)
     Q_PROPERTY(int filterRole READ filterRole WRITE setFilterRole)
+    Q_PROPERTY(bool parallelSortFilter READ parallelSortFilter WRITE setParallelSortFilter)
 
 public:
     explicit QSortFilterProxyModel(QObject *parent = Q_NULLPTR);
@@ -107,6 +108,9 @@ public:
     int filterRole() const;
     void setFilterRole(int role);
 
+    bool parallelSortFilter() const;
+    void setParallelSortFilter(bool enable);
+
 public Q_SLOTS:
     void setFilterRegExp(const QString &pattern);
     void setFilterWildcard(const QString &pattern);
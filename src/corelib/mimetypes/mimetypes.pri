@@ -22,4 +22,6 @@ SOURCES += \
 
 !contains(DEFINES, QT_NO_MIMETYPE) {
     RESOURCES += mimetypes/mimetypes.qrc
+    # QMimeEmbeddedProvider reads single <mime-type> elements of freedesktop.org.xml
+    QMAKE_RESOURCE_FLAGS += -chunk-size 65536
 }
@@ -87,7 +87,13 @@ QMimeProviderBase *QMimeDatabasePrivate::provider()
             m_provider = binaryProvider;
         } else {
             delete binaryProvider;
-            m_provider = new QMimeXMLProvider(this);
+            QMimeProviderBase *embeddedProvider = new QMimeEmbeddedProvider(this);
+            if (embeddedProvider->isValid()) {
+                m_provider = embeddedProvider;
+            } else {
+                delete embeddedProvider;
+                m_provider = new QMimeXMLProvider(this);
+            }
         }
     }
     return m_provider;
@@ -137,6 +143,17 @@ static inline bool isTextFile(const QByteArray &data)
     return true;
 }
 
+// The number of bytes of a device to pass to findByData(): as much as the
+// magic rules look at, but at least what isTextFile() looks at and at most
+// 16K (QIODEVICE_BUFFERSIZE in qiodevice_p.h).
+int QMimeDatabasePrivate::magicDataSize()
+{
+    const int extent = provider()->maxMagicExtent();
+    if (extent < 0)
+        return 16384;
+    return qBound(32, extent, 16384);
+}
+
 QMimeType QMimeDatabasePrivate::findByData(const QByteArray &data, int *accuracyPtr)
 {
     if (data.isEmpty()) {
@@ -181,9 +198,9 @@ QMimeType QMimeDatabasePrivate::mimeTypeForFileNameAndData(const QString &fileNa
     // Pass 2) Match on content, if we can read the data
     if (device->isOpen()) {
 
-        // Read 16K in one go (QIODEVICE_BUFFERSIZE in qiodevice_p.h).
+        // Read all the magic rules need in one go.
         // This is much faster than seeking back and forth into QIODevice.
-        const QByteArray data = device->peek(16384);
+        const QByteArray data = device->peek(magicDataSize());
 
         int magicAccuracy = 0;
         QMimeType candidateByData(findByData(data, &magicAccuracy));
@@ -379,13 +396,14 @@ QMimeType QMimeDatabase::mimeTypeForFile(const QFileInfo &fileInfo, MatchMode mo
     int priority = 0;
     switch (mode) {
     case MatchDefault:
-        file.open(QIODevice::ReadOnly); // isOpen() will be tested by method below
+        // Unbuffered, so that only the data needed for matching is read
+        file.open(QIODevice::ReadOnly | QIODevice::Unbuffered); // isOpen() will be tested by method below
         return d->mimeTypeForFileNameAndData(fileInfo.absoluteFilePath(), &file, &priority);
     case MatchExtension:
         locker.unlock();
         return mimeTypeForFile(fileInfo.absoluteFilePath(), mode);
     case MatchContent:
-        if (file.open(QIODevice::ReadOnly)) {
+        if (file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
             locker.unlock();
             return mimeTypeForData(&file);
         } else {
@@ -489,9 +507,9 @@ QMimeType QMimeDatabase::mimeTypeForData(QIODevice *device) const
     int accuracy = 0;
     const bool openedByUs = !device->isOpen() && device->open(QIODevice::ReadOnly);
     if (device->isOpen()) {
-        // Read 16K in one go (QIODEVICE_BUFFERSIZE in qiodevice_p.h).
+        // Read all the magic rules need in one go.
         // This is much faster than seeking back and forth into QIODevice.
-        const QByteArray data = device->peek(16384);
+        const QByteArray data = device->peek(d->magicDataSize());
         const QMimeType result = d->findByData(data, &accuracy);
         if (openedByUs)
             device->close();
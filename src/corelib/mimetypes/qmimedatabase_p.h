@@ -90,6 +90,7 @@ public:
     QMimeType mimeTypeForName(const QString &nameOrAlias);
     QMimeType mimeTypeForFileNameAndData(const QString &fileName, QIODevice *device, int *priorityPtr);
     QMimeType findByData(const QByteArray &data, int *priorityPtr);
+    int magicDataSize();
     QStringList mimeTypeForFileName(const QString &fileName, QString *foundSuffix = 0);
 
     mutable QMimeProviderBase *m_provider;
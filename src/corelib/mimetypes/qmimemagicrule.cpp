@@ -357,6 +357,37 @@ bool QMimeMagicRule::matches(const QByteArray &data) const
 
 }
 
+// Number of bytes at the start of the data that matches() looks at,
+// including the sub-rules
+int QMimeMagicRule::maxExtent() const
+{
+    int valueSize = 0;
+    switch (m_type) {
+    case String:
+        valueSize = m_pattern.size();
+        break;
+    case Byte:
+        valueSize = 1;
+        break;
+    case Big16:
+    case Host16:
+    case Little16:
+        valueSize = 2;
+        break;
+    case Big32:
+    case Host32:
+    case Little32:
+        valueSize = 4;
+        break;
+    default:
+        break;
+    }
+    int extent = m_endPos + valueSize;
+    for (const QMimeMagicRule &subMatch : m_subMatches)
+        extent = qMax(extent, subMatch.maxExtent());
+    return extent;
+}
+
 QT_END_NAMESPACE
 
 #endif // QT_NO_MIMETYPE
@@ -105,5 +105,14 @@ unsigned QMimeMagicRuleMatcher::priority() const
     return m_priority;
 }
 
+// Number of bytes at the start of the data that matches() looks at
+int QMimeMagicRuleMatcher::maxExtent() const
+{
+    int extent = 0;
+    for (const QMimeMagicRule &magicRule : m_list)
+        extent = qMax(extent, magicRule.maxExtent());
+    return extent;
+}
+
 QT_END_NAMESPACE
 #endif // QT_NO_MIMETYPE
@@ -80,6 +80,7 @@ public:
     QList<QMimeMagicRule> magicRules() const;
 
     bool matches(const QByteArray &data) const;
+    int maxExtent() const;
 
     unsigned priority() const;
 
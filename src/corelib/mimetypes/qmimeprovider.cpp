@@ -49,11 +49,14 @@
 #include <QXmlStreamReader>
 #include <QDir>
 #include <QFile>
+#include <QResource>
 #include <QByteArrayMatcher>
 #include <QDebug>
 #include <QDateTime>
 #include <QtEndian>
 
+#include <private/qresource_p.h>
+
 static void initResources()
 {
     Q_INIT_RESOURCE(mimetypes);
@@ -104,16 +107,17 @@ QMimeBinaryProvider::QMimeBinaryProvider(QMimeDatabasePrivate *db)
 struct QMimeBinaryProvider::CacheFile
 {
     CacheFile(const QString &fileName);
+    CacheFile(const uchar *cacheData, qint64 size);
     ~CacheFile();
 
     bool isValid() const { return m_valid; }
     inline quint16 getUint16(int offset) const
     {
-        return qFromBigEndian(*reinterpret_cast<quint16 *>(data + offset));
+        return qFromBigEndian<quint16>(data + offset);
     }
     inline quint32 getUint32(int offset) const
     {
-        return qFromBigEndian(*reinterpret_cast<quint32 *>(data + offset));
+        return qFromBigEndian<quint32>(data + offset);
     }
     inline const char *getCharStar(int offset) const
     {
@@ -122,8 +126,10 @@ struct QMimeBinaryProvider::CacheFile
     bool load();
     bool reload();
 
+    bool checkVersion();
+
     QFile file;
-    uchar *data;
+    const uchar *data;
     QDateTime m_mtime;
     bool m_valid;
 };
@@ -134,6 +140,14 @@ QMimeBinaryProvider::CacheFile::CacheFile(const QString &fileName)
     load();
 }
 
+// A cache that is not backed by a file, such as the one embedded in QtCore
+QMimeBinaryProvider::CacheFile::CacheFile(const uchar *cacheData, qint64 size)
+    : data(cacheData), m_valid(false)
+{
+    if (size >= 4)
+        checkVersion();
+}
+
 QMimeBinaryProvider::CacheFile::~CacheFile()
 {
 }
@@ -143,15 +157,20 @@ bool QMimeBinaryProvider::CacheFile::load()
     if (!file.open(QIODevice::ReadOnly))
         return false;
     data = file.map(0, file.size());
-    if (data) {
-        const int major = getUint16(0);
-        const int minor = getUint16(2);
-        m_valid = (major == 1 && minor >= 1 && minor <= 2);
-    }
+    if (data)
+        checkVersion();
     m_mtime = QFileInfo(file).lastModified();
     return m_valid;
 }
 
+bool QMimeBinaryProvider::CacheFile::checkVersion()
+{
+    const int major = getUint16(0);
+    const int minor = getUint16(2);
+    m_valid = (major == 1 && minor >= 1 && minor <= 2);
+    return m_valid;
+}
+
 bool QMimeBinaryProvider::CacheFile::reload()
 {
     //qDebug() << "reload!" << file->fileName();
@@ -187,7 +206,10 @@ enum {
     PosMagicListOffset = 24,
     // PosNamespaceListOffset = 28,
     PosIconsListOffset = 32,
-    PosGenericIconsListOffset = 36
+    PosGenericIconsListOffset = 36,
+    // Only in the embedded cache, see util/corelib/qmime-generatecache
+    PosMimeTypeListOffset = 40,
+    PosSourceChecksumOffset = 44
 };
 
 bool QMimeBinaryProvider::isValid()
@@ -428,6 +450,17 @@ QMimeType QMimeBinaryProvider::findByMagic(const QByteArray &data, int *accuracy
     return QMimeType();
 }
 
+int QMimeBinaryProvider::maxMagicExtent()
+{
+    checkCache();
+    int extent = 0;
+    for (CacheFile *cacheFile : qAsConst(m_cacheFiles)) {
+        const int magicListOffset = cacheFile->getUint32(PosMagicListOffset);
+        extent = qMax(extent, int(cacheFile->getUint32(magicListOffset + 4)));
+    }
+    return extent;
+}
+
 QStringList QMimeBinaryProvider::parents(const QString &mime)
 {
     checkCache();
@@ -556,6 +589,56 @@ QList<QMimeType> QMimeBinaryProvider::allMimeTypes()
     return result;
 }
 
+#ifndef QT_NO_XMLSTREAMREADER
+// Reads the comments and glob patterns from a <mime-type> element
+static void parseMimeTypeElement(QXmlStreamReader &xml, QMimeTypePrivate &data, const QString &file, QString *mainPattern)
+{
+    if (!xml.readNextStartElement() || xml.name() != QLatin1String("mime-type"))
+        return;
+    const QStringRef name = xml.attributes().value(QLatin1String("type"));
+    if (name.isEmpty())
+        return;
+    if (name != data.name) {
+        qWarning() << "Got name" << name << "in file" << file << "expected" << data.name;
+    }
+
+    while (xml.readNextStartElement()) {
+        const QStringRef tag = xml.name();
+        if (tag == QLatin1String("comment")) {
+            QString lang = xml.attributes().value(QLatin1String("xml:lang")).toString();
+            const QString text = xml.readElementText();
+            if (lang.isEmpty()) {
+                lang = QLatin1String("en_US");
+            }
+            data.localeComments.insert(lang, text);
+            continue; // we called readElementText, so we're at the EndElement already.
+        } else if (tag == QLatin1String("icon")) { // as written out by shared-mime-info >= 0.40
+            data.iconName = xml.attributes().value(QLatin1String("name")).toString();
+        } else if (tag == QLatin1String("glob-deleteall")) { // as written out by shared-mime-info >= 0.70
+            data.globPatterns.clear();
+        } else if (tag == QLatin1String("glob")) { // as written out by shared-mime-info >= 0.70
+            const QString pattern = xml.attributes().value(QLatin1String("pattern")).toString();
+            if (mainPattern->isEmpty() && pattern.startsWith(QLatin1Char('*'))) {
+                *mainPattern = pattern;
+            }
+            if (!data.globPatterns.contains(pattern))
+                data.globPatterns.append(pattern);
+        }
+        xml.skipCurrentElement();
+    }
+    Q_ASSERT(xml.hasError() || xml.name() == QLatin1String("mime-type"));
+}
+
+static void ensureMainPatternFirst(QMimeTypePrivate &data, const QString &mainPattern)
+{
+    if (!mainPattern.isEmpty() && (data.globPatterns.isEmpty() || data.globPatterns.first() != mainPattern)) {
+        // ensure it's first in the list of patterns
+        data.globPatterns.removeAll(mainPattern);
+        data.globPatterns.prepend(mainPattern);
+    }
+}
+#endif
+
 void QMimeBinaryProvider::loadMimeTypePrivate(QMimeTypePrivate &data)
 {
 #ifdef QT_NO_XMLSTREAMREADER
@@ -580,9 +663,7 @@ void QMimeBinaryProvider::loadMimeTypePrivate(QMimeTypePrivate &data)
         return;
     }
 
-    QString comment;
     QString mainPattern;
-    const QString preferredLanguage = QLocale::system().name();
 
     for (QStringList::const_reverse_iterator it = mimeFiles.crbegin(), end = mimeFiles.crend(); it != end; ++it) { // global first, then local.
         QFile qfile(*it);
@@ -590,53 +671,13 @@ void QMimeBinaryProvider::loadMimeTypePrivate(QMimeTypePrivate &data)
             continue;
 
         QXmlStreamReader xml(&qfile);
-        if (xml.readNextStartElement()) {
-            if (xml.name() != QLatin1String("mime-type")) {
-                continue;
-            }
-            const QStringRef name = xml.attributes().value(QLatin1String("type"));
-            if (name.isEmpty())
-                continue;
-            if (name != data.name) {
-                qWarning() << "Got name" << name << "in file" << file << "expected" << data.name;
-            }
-
-            while (xml.readNextStartElement()) {
-                const QStringRef tag = xml.name();
-                if (tag == QLatin1String("comment")) {
-                    QString lang = xml.attributes().value(QLatin1String("xml:lang")).toString();
-                    const QString text = xml.readElementText();
-                    if (lang.isEmpty()) {
-                        lang = QLatin1String("en_US");
-                    }
-                    data.localeComments.insert(lang, text);
-                    continue; // we called readElementText, so we're at the EndElement already.
-                } else if (tag == QLatin1String("icon")) { // as written out by shared-mime-info >= 0.40
-                    data.iconName = xml.attributes().value(QLatin1String("name")).toString();
-                } else if (tag == QLatin1String("glob-deleteall")) { // as written out by shared-mime-info >= 0.70
-                    data.globPatterns.clear();
-                } else if (tag == QLatin1String("glob")) { // as written out by shared-mime-info >= 0.70
-                    const QString pattern = xml.attributes().value(QLatin1String("pattern")).toString();
-                    if (mainPattern.isEmpty() && pattern.startsWith(QLatin1Char('*'))) {
-                        mainPattern = pattern;
-                    }
-                    if (!data.globPatterns.contains(pattern))
-                        data.globPatterns.append(pattern);
-                }
-                xml.skipCurrentElement();
-            }
-            Q_ASSERT(xml.name() == QLatin1String("mime-type"));
-        }
+        parseMimeTypeElement(xml, data, file, &mainPattern);
     }
 
     // Let's assume that shared-mime-info is at least version 0.70
     // Otherwise we would need 1) a version check, and 2) code for parsing patterns from the globs file.
 #if 1
-    if (!mainPattern.isEmpty() && (data.globPatterns.isEmpty() || data.globPatterns.first() != mainPattern)) {
-        // ensure it's first in the list of patterns
-        data.globPatterns.removeAll(mainPattern);
-        data.globPatterns.prepend(mainPattern);
-    }
+    ensureMainPatternFirst(data, mainPattern);
 #else
     const bool globsInXml = sharedMimeInfoVersion() >= QT_VERSION_CHECK(0, 70, 0);
     if (globsInXml) {
@@ -707,8 +748,128 @@ void QMimeBinaryProvider::loadGenericIcon(QMimeTypePrivate &data)
 
 ////
 
+static const char embeddedCacheFileName[] = ":/qt-project.org/qmime/mime.cache";
+static const char embeddedPackageFileName[] = ":/qt-project.org/qmime/freedesktop.org.xml";
+
+QMimeEmbeddedProvider::QMimeEmbeddedProvider(QMimeDatabasePrivate *db)
+    : QMimeBinaryProvider(db)
+{
+    initResources();
+}
+
+bool QMimeEmbeddedProvider::isValid()
+{
+    if (!qEnvironmentVariableIsEmpty("QT_NO_MIME_CACHE"))
+        return false;
+
+    // Packages installed without running update-mime-database are only seen by the XML provider
+    if (!QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QLatin1String("mime/packages"), QStandardPaths::LocateDirectory).isEmpty())
+        return false;
+
+    Q_ASSERT(m_cacheFiles.isEmpty()); // this method is only ever called once
+    // The cache is stored uncompressed, so it is used in place
+    const QResource resource(QString::fromLatin1(embeddedCacheFileName));
+    if (!resource.isValid() || resource.isCompressed() || resource.size() < PosSourceChecksumOffset + 4)
+        return false;
+    // A cache generated from another freedesktop.org.xml would be stale and point to
+    // the wrong elements. The checksum of the XML is read from its zlib streams.
+    quint32 packageChecksum;
+    if (!QResourceFileEngine(QString::fromLatin1(embeddedPackageFileName)).contentChecksum(&packageChecksum))
+        return false;
+    CacheFile *cacheFile = new CacheFile(resource.data(), resource.size());
+    if (!cacheFile->isValid() || cacheFile->getUint32(PosSourceChecksumOffset) != packageChecksum) {
+        qWarning("QMimeDatabase: The embedded MIME cache is out of date, regenerate it with util/corelib/qmime-generatecache");
+        delete cacheFile;
+        return false;
+    }
+    m_cacheFiles.append(cacheFile);
+    return true;
+}
+
+void QMimeEmbeddedProvider::checkCache()
+{
+    // The embedded cache never changes
+}
+
+// Binary search in the list of all MIME types, returns the offset of the entry
+int QMimeEmbeddedProvider::findMimeTypeEntry(const QString &name) const
+{
+    const CacheFile *cacheFile = m_cacheFiles.first();
+    const QByteArray input = name.toLatin1();
+    const int mimeTypeListOffset = cacheFile->getUint32(PosMimeTypeListOffset);
+    const int numEntries = cacheFile->getUint32(mimeTypeListOffset);
+    int begin = 0;
+    int end = numEntries - 1;
+    while (begin <= end) {
+        const int medium = (begin + end) / 2;
+        const int off = mimeTypeListOffset + 4 + 12 * medium;
+        const char *mimeType = cacheFile->getCharStar(cacheFile->getUint32(off));
+        const int cmp = qstrcmp(mimeType, input);
+        if (cmp < 0)
+            begin = medium + 1;
+        else if (cmp > 0)
+            end = medium - 1;
+        else
+            return off;
+    }
+    return -1;
+}
+
+QMimeType QMimeEmbeddedProvider::mimeTypeForName(const QString &name)
+{
+    if (findMimeTypeEntry(name) < 0)
+        return QMimeType(); // unknown mimetype
+    return mimeTypeForNameUnchecked(name);
+}
+
+void QMimeEmbeddedProvider::loadMimeTypeList()
+{
+    if (!m_mimetypeListLoaded) {
+        m_mimetypeListLoaded = true;
+        const CacheFile *cacheFile = m_cacheFiles.first();
+        const int mimeTypeListOffset = cacheFile->getUint32(PosMimeTypeListOffset);
+        const int numEntries = cacheFile->getUint32(mimeTypeListOffset);
+        m_mimetypeNames.reserve(numEntries);
+        for (int i = 0; i < numEntries; ++i) {
+            const int mimeOffset = cacheFile->getUint32(mimeTypeListOffset + 4 + 12 * i);
+            m_mimetypeNames.insert(QLatin1String(cacheFile->getCharStar(mimeOffset)));
+        }
+    }
+}
+
+void QMimeEmbeddedProvider::loadMimeTypePrivate(QMimeTypePrivate &data)
+{
+#ifdef QT_NO_XMLSTREAMREADER
+    qWarning() << "Cannot load mime type since QXmlStreamReader is not available.";
+    return;
+#else
+    if (data.loaded)
+        return;
+    data.loaded = true;
+
+    const int entryOffset = findMimeTypeEntry(data.name);
+    if (entryOffset < 0)
+        return;
+
+    // The cache has the position of the <mime-type> element in the embedded
+    // XML; reading it only uncompresses the chunks of the resource holding it.
+    const CacheFile *cacheFile = m_cacheFiles.first();
+    QFile package(QString::fromLatin1(embeddedPackageFileName));
+    if (!package.open(QIODevice::ReadOnly) || !package.seek(cacheFile->getUint32(entryOffset + 4)))
+        return;
+    const QByteArray element = package.read(cacheFile->getUint32(entryOffset + 8));
+
+    QString mainPattern;
+    QXmlStreamReader xml(element);
+    parseMimeTypeElement(xml, data, package.fileName(), &mainPattern);
+    ensureMainPatternFirst(data, mainPattern);
+#endif //QT_NO_XMLSTREAMREADER
+}
+
+////
+
 QMimeXMLProvider::QMimeXMLProvider(QMimeDatabasePrivate *db)
-    : QMimeProviderBase(db), m_loaded(false)
+    : QMimeProviderBase(db), m_loaded(false), m_maxMagicExtent(0)
 {
     initResources();
 }
@@ -785,6 +946,7 @@ void QMimeXMLProvider::ensureLoaded()
         m_parents.clear();
         m_mimeTypeGlobs.clear();
         m_magicMatchers.clear();
+        m_maxMagicExtent = 0;
 
         //qDebug() << "Loading" << m_allFiles;
 
@@ -872,6 +1034,13 @@ QList<QMimeType> QMimeXMLProvider::allMimeTypes()
 void QMimeXMLProvider::addMagicMatcher(const QMimeMagicRuleMatcher &matcher)
 {
     m_magicMatchers.append(matcher);
+    m_maxMagicExtent = qMax(m_maxMagicExtent, matcher.maxExtent());
+}
+
+int QMimeXMLProvider::maxMagicExtent()
+{
+    ensureLoaded();
+    return m_maxMagicExtent;
 }
 
 QT_END_NAMESPACE
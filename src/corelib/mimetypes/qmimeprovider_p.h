@@ -81,6 +81,7 @@ public:
     virtual void loadMimeTypePrivate(QMimeTypePrivate &) {}
     virtual void loadIcon(QMimeTypePrivate &) {}
     virtual void loadGenericIcon(QMimeTypePrivate &) {}
+    virtual int maxMagicExtent() { return -1; }
 
     QMimeDatabasePrivate *m_db;
 protected:
@@ -108,16 +109,13 @@ public:
     virtual void loadMimeTypePrivate(QMimeTypePrivate &) Q_DECL_OVERRIDE;
     virtual void loadIcon(QMimeTypePrivate &) Q_DECL_OVERRIDE;
     virtual void loadGenericIcon(QMimeTypePrivate &) Q_DECL_OVERRIDE;
+    virtual int maxMagicExtent() Q_DECL_OVERRIDE;
 
-private:
+protected:
     struct CacheFile;
 
-    void matchGlobList(QMimeGlobMatchResult &result, CacheFile *cacheFile, int offset, const QString &fileName);
-    bool matchSuffixTree(QMimeGlobMatchResult &result, CacheFile *cacheFile, int numEntries, int firstOffset, const QString &fileName, int charPos, bool caseSensitiveCheck);
-    bool matchMagicRule(CacheFile *cacheFile, int numMatchlets, int firstOffset, const QByteArray &data);
-    QString iconForMime(CacheFile *cacheFile, int posListOffset, const QByteArray &inputMime);
-    void loadMimeTypeList();
-    void checkCache();
+    virtual void loadMimeTypeList();
+    virtual void checkCache();
 
     class CacheFileList : public QList<CacheFile *>
     {
@@ -126,9 +124,39 @@ private:
         bool checkCacheChanged();
     };
     CacheFileList m_cacheFiles;
-    QStringList m_cacheFileNames;
     QSet<QString> m_mimetypeNames;
     bool m_mimetypeListLoaded;
+
+private:
+    void matchGlobList(QMimeGlobMatchResult &result, CacheFile *cacheFile, int offset, const QString &fileName);
+    bool matchSuffixTree(QMimeGlobMatchResult &result, CacheFile *cacheFile, int numEntries, int firstOffset, const QString &fileName, int charPos, bool caseSensitiveCheck);
+    bool matchMagicRule(CacheFile *cacheFile, int numMatchlets, int firstOffset, const QByteArray &data);
+    QString iconForMime(CacheFile *cacheFile, int posListOffset, const QByteArray &inputMime);
+
+    QStringList m_cacheFileNames;
+};
+
+/*
+   Reads the cache generated from freedesktop.org.xml and embedded in QtCore
+   (see util/corelib/qmime-generatecache), used when the system has no mime.cache.
+   Comments and glob patterns are parsed from the embedded XML on demand,
+   one <mime-type> element at a time.
+ */
+class QMimeEmbeddedProvider : public QMimeBinaryProvider
+{
+public:
+    QMimeEmbeddedProvider(QMimeDatabasePrivate *db);
+
+    virtual bool isValid() Q_DECL_OVERRIDE;
+    virtual QMimeType mimeTypeForName(const QString &name) Q_DECL_OVERRIDE;
+    virtual void loadMimeTypePrivate(QMimeTypePrivate &) Q_DECL_OVERRIDE;
+
+protected:
+    virtual void loadMimeTypeList() Q_DECL_OVERRIDE;
+    virtual void checkCache() Q_DECL_OVERRIDE;
+
+private:
+    int findMimeTypeEntry(const QString &name) const;
 };
 
 /*
@@ -147,6 +175,7 @@ public:
     virtual QStringList listAliases(const QString &name) Q_DECL_OVERRIDE;
     virtual QMimeType findByMagic(const QByteArray &data, int *accuracyPtr) Q_DECL_OVERRIDE;
     virtual QList<QMimeType> allMimeTypes() Q_DECL_OVERRIDE;
+    virtual int maxMagicExtent() Q_DECL_OVERRIDE;
 
     bool load(const QString &fileName, QString *errorMessage);
 
@@ -174,6 +203,7 @@ private:
     QMimeAllGlobPatterns m_mimeTypeGlobs;
 
     QList<QMimeMagicRuleMatcher> m_magicMatchers;
+    int m_maxMagicExtent;
     QStringList m_allFiles;
 };
 
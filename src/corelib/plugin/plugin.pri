@@ -8,6 +8,7 @@ HEADERS += \
 	plugin/qplugin.h \
 	plugin/quuid.h \
 	plugin/qfactoryloader_p.h \
+	plugin/qpluginmetadatacache_p.h \
 	plugin/qsystemlibrary_p.h \
         plugin/qelfparser_p.h \
         plugin/qmachparser_p.h
@@ -18,6 +19,7 @@ SOURCES += \
 	plugin/qfactoryloader.cpp \
 	plugin/quuid.cpp \
 	plugin/qlibrary.cpp \
+	plugin/qpluginmetadatacache.cpp \
         plugin/qelfparser_p.cpp \
         plugin/qmachparser.cpp
 
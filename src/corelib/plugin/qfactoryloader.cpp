@@ -49,6 +49,7 @@
 #include "qpluginloader.h"
 #include "private/qobject_p.h"
 #include "private/qcoreapplication_p.h"
+#include "qpluginmetadatacache_p.h"
 #include "qjsondocument.h"
 #include "qjsonvalue.h"
 #include "qjsonobject.h"
@@ -209,6 +210,9 @@ void QFactoryLoader::update()
                 library->release();
         }
     }
+
+    if (QPluginMetaDataCache *cache = QPluginMetaDataCache::instance())
+        cache->save();
 #else
     Q_D(QFactoryLoader);
     if (qt_debug_component()) {
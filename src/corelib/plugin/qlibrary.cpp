@@ -63,6 +63,7 @@
 #include <qjsonvalue.h>
 #include "qelfparser_p.h"
 #include "qmachparser_p.h"
+#include "qpluginmetadatacache_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -719,8 +720,18 @@ void QLibraryPrivate::updatePluginState()
 #endif
 
     if (!pHnd) {
-        // scan for the plugin metadata without loading
-        success = findPatternUnloaded(fileName, this);
+        // scan for the plugin metadata without loading, unless we did so before
+        QPluginMetaDataCache *cache = QPluginMetaDataCache::instance();
+        const QPluginMetaDataCache::Result cached = cache
+                ? cache->find(fileName, &metaData, &errorString)
+                : QPluginMetaDataCache::Miss;
+        if (cached != QPluginMetaDataCache::Miss) {
+            success = cached == QPluginMetaDataCache::Plugin;
+        } else {
+            success = findPatternUnloaded(fileName, this);
+            if (cache)
+                cache->insert(fileName, success ? metaData : QJsonObject(), errorString);
+        }
     } else {
         // library is already loaded (probably via QLibrary)
         // simply get the target function and call it.
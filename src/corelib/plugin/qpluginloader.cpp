@@ -93,6 +93,12 @@ QT_BEGIN_NAMESPACE
     every instance has called unload(). Right before the unloading
     happen, the root component will also be deleted.
 
+    To find out whether a file is a plugin, and which interface it
+    implements, Qt reads the metadata embedded in it without loading it.
+    The results are cached in a file in the user's cache directory, and
+    only files that changed since are read again. Setting the
+    \c QT_NO_PLUGIN_CACHE environment variable disables the cache.
+
     See \l{How to Create Qt Plugins} for more information about
     how to make your application extensible through plugins.
 
@@ -0,0 +1,308 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qplatformdefs.h"
+#include "qpluginmetadatacache_p.h"
+
+#ifndef QT_NO_LIBRARY
+
+#include <qdatastream.h>
+#include <qdatetime.h>
+#include <qfile.h>
+#include <qdebug.h>
+#include <qdir.h>
+#include <qfileinfo.h>
+#include <qjsondocument.h>
+#include <qsavefile.h>
+#include <qstandardpaths.h>
+#include <qsysinfo.h>
+
+QT_BEGIN_NAMESPACE
+
+bool qt_debug_component();
+
+/*
+    Finding out whether a file is a plugin requires opening it and locating
+    the metadata in it, which adds up when there are many plugins. The
+    results are therefore cached in a file, keyed by the canonical file
+    name of the library and validated against its size and time stamps.
+    Entries are added and updated as files are looked at, and entries for
+    files that no longer exist are dropped when the cache is saved.
+
+    Setting the QT_NO_PLUGIN_CACHE environment variable disables the cache.
+*/
+
+enum {
+    CacheMagic = 0x51504d43, // "QPMC"
+    CacheFormatVersion = 1
+};
+
+#ifdef QT_NO_DEBUG
+static const bool cacheIsDebug = false;
+#else
+static const bool cacheIsDebug = true;
+#endif
+
+struct QPluginMetaDataCacheHolder
+{
+    QPluginMetaDataCacheHolder() : cache(0), initialized(false) { }
+    ~QPluginMetaDataCacheHolder() { delete cache; }
+    QBasicMutex mutex;
+    QPluginMetaDataCache *cache;
+    bool initialized;
+};
+Q_GLOBAL_STATIC(QPluginMetaDataCacheHolder, pluginMetaDataCache)
+
+static QString defaultCacheFileName()
+{
+#ifndef QT_NO_STANDARDPATHS
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    if (dir.isEmpty())
+        return QString();
+    return dir + QLatin1String("/qtplugincache/metadata-" QT_VERSION_STR "-")
+            + QSysInfo::buildAbi() + QLatin1String(".cache");
+#else
+    return QString();
+#endif
+}
+
+/*
+    Returns the process-wide cache, or 0 if it is disabled.
+*/
+QPluginMetaDataCache *QPluginMetaDataCache::instance()
+{
+    QPluginMetaDataCacheHolder *holder = pluginMetaDataCache();
+    if (!holder)
+        return 0;
+    QMutexLocker locker(&holder->mutex);
+    if (!holder->initialized) {
+        holder->initialized = true;
+        if (!qEnvironmentVariableIsSet("QT_NO_PLUGIN_CACHE")) {
+            const QString fileName = defaultCacheFileName();
+            if (!fileName.isEmpty())
+                holder->cache = new QPluginMetaDataCache(fileName);
+        }
+    }
+    return holder->cache;
+}
+
+/*
+    Forgets the cache held in memory, so that the next call to instance()
+    reads the environment and the cache file again. For testing only; the
+    cache must not be in use.
+*/
+void QPluginMetaDataCache::reset()
+{
+    QPluginMetaDataCacheHolder *holder = pluginMetaDataCache();
+    if (!holder)
+        return;
+    QMutexLocker locker(&holder->mutex);
+    delete holder->cache;
+    holder->cache = 0;
+    holder->initialized = false;
+}
+
+QPluginMetaDataCache::QPluginMetaDataCache(const QString &cacheFile)
+    : cacheFile(cacheFile), loaded(false), dirty(false)
+{
+}
+
+void QPluginMetaDataCache::load()
+{
+    loaded = true;
+    QFile file(cacheFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_6);
+    quint32 magic, formatVersion;
+    bool debug;
+    qint32 count;
+    in >> magic >> formatVersion >> debug >> count;
+    if (in.status() != QDataStream::Ok || magic != quint32(CacheMagic)
+            || formatVersion != quint32(CacheFormatVersion) || debug != cacheIsDebug || count < 0) {
+        dirty = true; // rewrite it in the current format
+        return;
+    }
+
+    entries.reserve(count);
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString fileName;
+        Entry entry;
+        in >> fileName >> entry.size >> entry.stamp >> entry.metaData >> entry.errorString;
+        entries.insert(fileName, entry);
+    }
+    if (in.status() != QDataStream::Ok) {
+        if (qt_debug_component())
+            qWarning("QPluginMetaDataCache: ignoring corrupt cache %s", qPrintable(cacheFile));
+        entries.clear();
+        dirty = true;
+    }
+}
+
+/*
+    Identifies the state of a file on disk: besides the size, this is the
+    modification and status change time, with the resolution the file
+    system provides, and the inode on Unix.
+*/
+static bool fileStamp(const QString &fileName, qint64 *size, QByteArray *stamp)
+{
+#ifdef Q_OS_UNIX
+    QT_STATBUF st;
+    if (QT_STAT(QFile::encodeName(fileName).constData(), &st) != 0)
+        return false;
+    *size = st.st_size;
+    qint64 times[5] = { qint64(st.st_mtime), 0, qint64(st.st_ctime), 0, qint64(st.st_ino) };
+#  if defined(Q_OS_LINUX) || defined(Q_OS_ANDROID)
+    times[1] = st.st_mtim.tv_nsec;
+    times[3] = st.st_ctim.tv_nsec;
+#  elif defined(Q_OS_DARWIN)
+    times[1] = st.st_mtimespec.tv_nsec;
+    times[3] = st.st_ctimespec.tv_nsec;
+#  endif
+    *stamp = QByteArray(reinterpret_cast<const char *>(times), sizeof(times));
+#else
+    const QFileInfo info(fileName);
+    if (!info.exists())
+        return false;
+    *size = info.size();
+    *stamp = QByteArray::number(info.lastModified().toMSecsSinceEpoch());
+#endif
+    return true;
+}
+
+/*
+    Looks up the metadata of the library \a fileName. Returns Miss if the
+    library is not in the cache, or has changed since it was cached.
+*/
+QPluginMetaDataCache::Result QPluginMetaDataCache::find(const QString &fileName,
+                                                        QJsonObject *metaData,
+                                                        QString *errorString)
+{
+    QMutexLocker locker(&mutex);
+    if (!loaded)
+        load();
+
+    const QHash<QString, Entry>::iterator it = entries.find(fileName);
+    if (it == entries.end())
+        return Miss;
+
+    qint64 size;
+    QByteArray stamp;
+    if (!fileStamp(fileName, &size, &stamp) || size != it->size || stamp != it->stamp)
+        return Miss;
+
+    it->used = true;
+    if (it->metaData.isEmpty()) {
+        *errorString = it->errorString;
+        return NotAPlugin;
+    }
+    const QJsonDocument doc = QJsonDocument::fromBinaryData(it->metaData);
+    if (doc.isNull())
+        return Miss;
+    *metaData = doc.object();
+    return Plugin;
+}
+
+/*
+    Records the result of scanning the library \a fileName: its metadata,
+    or an empty \a metaData and the \a errorString if it is not a plugin.
+*/
+void QPluginMetaDataCache::insert(const QString &fileName, const QJsonObject &metaData,
+                                  const QString &errorString)
+{
+    Entry entry;
+    if (!fileStamp(fileName, &entry.size, &entry.stamp))
+        return;
+    if (!metaData.isEmpty())
+        entry.metaData = QJsonDocument(metaData).toBinaryData();
+    else
+        entry.errorString = errorString;
+    entry.used = true;
+
+    QMutexLocker locker(&mutex);
+    if (!loaded)
+        load();
+    entries.insert(fileName, entry);
+    dirty = true;
+}
+
+/*
+    Writes the cache back if it changed.
+*/
+void QPluginMetaDataCache::save()
+{
+    QMutexLocker locker(&mutex);
+    if (!dirty)
+        return;
+    dirty = false;
+
+    for (QHash<QString, Entry>::iterator it = entries.begin(); it != entries.end(); ) {
+        if (!it->used && !QFileInfo::exists(it.key()))
+            it = entries.erase(it);
+        else
+            ++it;
+    }
+
+    QDir().mkpath(QFileInfo(cacheFile).absolutePath());
+    QSaveFile file(cacheFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (qt_debug_component())
+            qWarning("QPluginMetaDataCache: cannot write %s: %s", qPrintable(cacheFile),
+                     qPrintable(file.errorString()));
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << quint32(CacheMagic) << quint32(CacheFormatVersion) << cacheIsDebug
+        << qint32(entries.size());
+    for (QHash<QString, Entry>::const_iterator it = entries.constBegin();
+         it != entries.constEnd(); ++it) {
+        out << it.key() << it->size << it->stamp << it->metaData << it->errorString;
+    }
+    if (!file.commit() && qt_debug_component())
+        qWarning("QPluginMetaDataCache: cannot write %s: %s", qPrintable(cacheFile),
+                 qPrintable(file.errorString()));
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_LIBRARY
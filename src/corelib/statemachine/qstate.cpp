@@ -546,6 +546,7 @@ bool QState::event(QEvent *e)
     if ((e->type() == QEvent::ChildAdded) || (e->type() == QEvent::ChildRemoved)) {
         d->childStatesListNeedsRefresh = true;
         d->transitionsListNeedsRefresh = true;
+        QStateMachinePrivate::invalidateStateTable(this);
         if ((e->type() == QEvent::ChildRemoved) && (static_cast<QChildEvent *>(e)->child() == d->initialState))
             d->initialState = 0;
     }
@@ -407,6 +407,8 @@ QStateMachinePrivate::QStateMachinePrivate()
 #ifndef QT_NO_ANIMATION
     animated = true;
 #endif
+    stateTableValid = false;
+    stateTableFlat = false;
 }
 
 QStateMachinePrivate::~QStateMachinePrivate()
@@ -424,6 +426,177 @@ QState *QStateMachinePrivate::rootState() const
     return const_cast<QStateMachine*>(q_func());
 }
 
+/*
+  Called by QState when its children change. Each machine above the state
+  flattens it into its state table, so all of them have to rebuild.
+*/
+void QStateMachinePrivate::invalidateStateTable(QState *changedState)
+{
+    for (QState *s = changedState; s != 0; s = s->parentState()) {
+        if (QStatePrivate::get(s)->isMachine)
+            QStateMachinePrivate::get(static_cast<QStateMachine *>(s))->stateTableValid = false;
+    }
+}
+
+/*
+  Lays out the states of the machine in document (pre-)order. This is the
+  order in which states are entered, the reverse is the order in which they
+  are exited, and the descendants of a state are the entries following it up
+  to and including its "last" index.
+
+  In a flat machine, with only atomic states below the root, the QObject
+  walks are a single step already and the table would only add hash
+  lookups; it is dropped, and stateIndex() reports every state as outside of
+  it, so the original comparators are used.
+*/
+void QStateMachinePrivate::updateStateTable() const
+{
+    stateTable.clear();
+    stateTableIndexes.clear();
+    addToStateTable(rootState(), -1);
+    stateTableFlat = true;
+    for (const StateTableEntry &entry : qAsConst(stateTable)) {
+        if (entry.depth > 1) {
+            stateTableFlat = false;
+            break;
+        }
+    }
+    if (stateTableFlat) {
+        stateTable.clear();
+        stateTableIndexes.clear();
+    }
+    stateTableValid = true;
+}
+
+void QStateMachinePrivate::addToStateTable(QAbstractState *state, int parent) const
+{
+    const int index = stateTable.size();
+    StateTableEntry entry;
+    entry.state = state;
+    entry.parent = parent;
+    entry.last = index;
+    entry.depth = parent < 0 ? 0 : stateTable.at(parent).depth + 1;
+    QState *group = toStandardState(state);
+    if (group)
+        entry.transitions = QStatePrivate::get(group)->transitions().toVector();
+    if (parent >= 0)
+        entry.transitions += stateTable.at(parent).transitions;
+    stateTable.append(entry);
+    stateTableIndexes.insert(state, index);
+
+    if (group) {
+        const auto childStates = QStatePrivate::get(group)->childStates();
+        for (QAbstractState *child : childStates)
+            addToStateTable(child, index);
+        stateTable[index].last = stateTable.size() - 1;
+    }
+}
+
+int QStateMachinePrivate::stateIndex(const QAbstractState *state) const
+{
+    if (!stateTableValid)
+        updateStateTable();
+    if (stateTableFlat)
+        return -1;
+    return stateTableIndexes.value(state, -1);
+}
+
+static inline bool isDescendantIndex(const QVector<QStateMachinePrivate::StateTableEntry> &table,
+                                     int index1, int index2)
+{
+    return index2 < index1 && index1 <= table.at(index2).last;
+}
+
+bool QStateMachinePrivate::isDescendantInTable(const QAbstractState *state1, const QAbstractState *state2) const
+{
+    const int index1 = stateIndex(state1);
+    const int index2 = index1 < 0 ? -1 : stateIndex(state2);
+    if (index2 < 0)
+        return isDescendant(state1, state2);
+    return isDescendantIndex(stateTable, index1, index2);
+}
+
+template <typename Iterator>
+void QStateMachinePrivate::sortInEntryOrder(Iterator begin, Iterator end) const
+{
+    QVarLengthArray<QPair<int, QAbstractState *>, 64> keyed;
+    for (Iterator it = begin; it != end; ++it) {
+        const int index = stateIndex(*it);
+        if (index < 0) {
+            std::sort(begin, end, stateEntryLessThan);
+            return;
+        }
+        keyed.append(qMakePair(index, *it));
+    }
+    std::sort(keyed.begin(), keyed.end());
+    for (const auto &k : qAsConst(keyed))
+        *begin++ = k.second;
+}
+
+template <typename Iterator>
+void QStateMachinePrivate::sortInExitOrder(Iterator begin, Iterator end) const
+{
+    QVarLengthArray<QPair<int, QAbstractState *>, 64> keyed;
+    for (Iterator it = begin; it != end; ++it) {
+        const int index = stateIndex(*it);
+        if (index < 0) {
+            std::sort(begin, end, stateExitLessThan);
+            return;
+        }
+        keyed.append(qMakePair(-index, *it));
+    }
+    std::sort(keyed.begin(), keyed.end());
+    for (const auto &k : qAsConst(keyed))
+        *begin++ = k.second;
+}
+
+namespace {
+struct TransitionOrderKey
+{
+    int depth;
+    int state;
+    int position;
+    QAbstractTransition *transition;
+
+    bool operator<(const TransitionOrderKey &other) const
+    {
+        // deeper sources first, then document order of the sources
+        if (depth != other.depth)
+            return depth > other.depth;
+        if (state != other.state)
+            return state < other.state;
+        return position < other.position;
+    }
+};
+}
+Q_DECLARE_TYPEINFO(TransitionOrderKey, Q_PRIMITIVE_TYPE);
+
+/*
+  Same order as transitionStateEntryLessThan(): the comparator puts
+  descendants before their ancestors and deeper sources before shallower
+  ones, so sorting on (depth, index) is equivalent.
+*/
+void QStateMachinePrivate::sortInTransitionOrder(QList<QAbstractTransition *> &transitions) const
+{
+    QVarLengthArray<TransitionOrderKey, 16> keyed;
+    for (QAbstractTransition *t : qAsConst(transitions)) {
+        QState *source = t->sourceState();
+        const int index = stateIndex(source);
+        if (index < 0) {
+            std::sort(transitions.begin(), transitions.end(), transitionStateEntryLessThan);
+            return;
+        }
+        const TransitionOrderKey key = {
+            stateTable.at(index).depth, index,
+            QStatePrivate::get(source)->transitions().indexOf(t), t
+        };
+        keyed.append(key);
+    }
+    std::sort(keyed.begin(), keyed.end());
+    for (int i = 0; i < keyed.size(); ++i)
+        transitions[i] = keyed.at(i).transition;
+}
+
 static QEvent *cloneEvent(QEvent *e)
 {
     switch (e->type()) {
@@ -525,6 +698,30 @@ QState *QStateMachinePrivate::findLCA(const QList<QAbstractState*> &states, bool
 {
     if (states.isEmpty())
         return 0;
+
+    QVarLengthArray<int, 16> indexes;
+    for (const QAbstractState *s : states) {
+        const int index = stateIndex(s);
+        if (index < 0)
+            break;
+        indexes.append(index);
+    }
+    if (indexes.size() == states.size()) {
+        for (int anc = stateTable.at(indexes.at(0)).parent; anc >= 0; anc = stateTable.at(anc).parent) {
+            if (onlyCompound && !isCompound(stateTable.at(anc).state))
+                continue;
+
+            bool ok = true;
+            for (int j = indexes.size() - 1; (j > 0) && ok; --j) {
+                if (!isDescendantIndex(stateTable, indexes.at(j), anc))
+                    ok = false;
+            }
+            if (ok)
+                return static_cast<QState *>(stateTable.at(anc).state);
+        }
+        return 0;
+    }
+
     QVector<QState*> ancestors = getProperAncestors(states.at(0), rootState()->parentState());
     for (int i = 0; i < ancestors.size(); ++i) {
         QState *anc = ancestors.at(i);
@@ -558,15 +755,43 @@ QList<QAbstractTransition*> QStateMachinePrivate::selectTransitions(QEvent *even
         if (isAtomic(s))
             configuration_sorted.append(s);
     }
-    std::sort(configuration_sorted.begin(), configuration_sorted.end(), stateEntryLessThan);
+    sortInEntryOrder(configuration_sorted.begin(), configuration_sorted.end());
 
     QList<QAbstractTransition*> enabledTransitions;
     const_cast<QStateMachine*>(q)->beginSelectTransitions(event);
+    QVector<QState*> rootAncestors;
+    bool rootAncestorsKnown = false;
     for (QAbstractState *state : qAsConst(configuration_sorted)) {
-        QVector<QState*> lst = getProperAncestors(state, Q_NULLPTR);
-        if (QState *grp = toStandardState(state))
-            lst.prepend(grp);
+        QVector<QState*> lst;
+        QVector<QAbstractTransition*> candidates;
+        const int index = stateIndex(state);
+        if (index >= 0) {
+            // The table already lists the transitions of the state and its
+            // ancestors within this machine; a copy keeps them alive should
+            // an event test change the machine.
+            candidates = stateTable.at(index).transitions;
+            if (!rootAncestorsKnown) {
+                rootAncestors = getProperAncestors(rootState(), Q_NULLPTR);
+                rootAncestorsKnown = true;
+            }
+            lst = rootAncestors;
+        } else {
+            lst = getProperAncestors(state, Q_NULLPTR);
+            if (QState *grp = toStandardState(state))
+                lst.prepend(grp);
+        }
         bool found = false;
+        for (int k = 0; k < candidates.size(); ++k) {
+            QAbstractTransition *t = candidates.at(k);
+            if (QAbstractTransitionPrivate::get(t)->callEventTest(event)) {
+#ifdef QSTATEMACHINE_DEBUG
+                qDebug() << q << ": selecting transition" << t;
+#endif
+                enabledTransitions.append(t);
+                found = true;
+                break;
+            }
+        }
         for (int j = 0; (j < lst.size()) && !found; ++j) {
             QState *s = lst.at(j);
             QList<QAbstractTransition*> transitions = QStatePrivate::get(s)->transitions();
@@ -627,7 +852,7 @@ void QStateMachinePrivate::removeConflictingTransitions(QList<QAbstractTransitio
 
     QList<QAbstractTransition*> filteredTransitions;
     filteredTransitions.reserve(enabledTransitions.size());
-    std::sort(enabledTransitions.begin(), enabledTransitions.end(), transitionStateEntryLessThan);
+    sortInTransitionOrder(enabledTransitions);
 
     for (QAbstractTransition *t1 : qAsConst(enabledTransitions)) {
         bool t1Preempted = false;
@@ -648,7 +873,7 @@ void QStateMachinePrivate::removeConflictingTransitions(QList<QAbstractTransitio
                 ++t2It;
             } else {
                 // Houston, we have a conflict. Check which transition can be removed.
-                if (isDescendant(t1->sourceState(), t2->sourceState())) {
+                if (isDescendantInTable(t1->sourceState(), t2->sourceState())) {
                     // t1 preempts t2, so we can remove t2
                     t2It = filteredTransitions.erase(t2It);
                 } else {
@@ -744,7 +969,7 @@ QList<QAbstractState*> QStateMachinePrivate::computeExitSet(const QList<QAbstrac
     Q_ASSERT(cache);
 
     QList<QAbstractState*> statesToExit_sorted = computeExitSet_Unordered(enabledTransitions, cache).toList();
-    std::sort(statesToExit_sorted.begin(), statesToExit_sorted.end(), stateExitLessThan);
+    sortInExitOrder(statesToExit_sorted.begin(), statesToExit_sorted.end());
     return statesToExit_sorted;
 }
 
@@ -788,7 +1013,7 @@ QSet<QAbstractState*> QStateMachinePrivate::computeExitSet_Unordered(QAbstractTr
     }
 
     for (QAbstractState* s : qAsConst(configuration)) {
-        if (isDescendant(s, domain))
+        if (isDescendantInTable(s, domain))
             statesToExit.insert(s);
     }
 
@@ -810,7 +1035,7 @@ void QStateMachinePrivate::exitStates(QEvent *event, const QList<QAbstractState*
                 for (it = configuration.constBegin(); it != configuration.constEnd(); ++it) {
                     QAbstractState *s0 = *it;
                     if (QHistoryStatePrivate::get(h)->historyType == QHistoryState::DeepHistory) {
-                        if (isAtomic(s0) && isDescendant(s0, s))
+                        if (isAtomic(s0) && isDescendantInTable(s0, s))
                             QHistoryStatePrivate::get(h)->configuration.append(s0);
                     } else if (s0->parentState() == s) {
                         QHistoryStatePrivate::get(h)->configuration.append(s0);
@@ -883,7 +1108,7 @@ QList<QAbstractState*> QStateMachinePrivate::computeEntrySet(const QList<QAbstra
     }
 
     QList<QAbstractState*> statesToEnter_sorted = statesToEnter.toList();
-    std::sort(statesToEnter_sorted.begin(), statesToEnter_sorted.end(), stateEntryLessThan);
+    sortInEntryOrder(statesToEnter_sorted.begin(), statesToEnter_sorted.end());
     return statesToEnter_sorted;
 }
 
@@ -921,7 +1146,7 @@ QAbstractState *QStateMachinePrivate::getTransitionDomain(QAbstractTransition *t
             if (isCompound(tSource)) {
                 bool allDescendants = true;
                 for (QAbstractState *s : effectiveTargetStates) {
-                    if (!isDescendant(s, tSource)) {
+                    if (!isDescendantInTable(s, tSource)) {
                         allDescendants = false;
                         break;
                     }
@@ -177,6 +177,28 @@ public:
     bool isCompound(const QAbstractState *s) const;
     bool isAtomic(const QAbstractState *s) const;
 
+    // The states of this machine flattened in document order, so that
+    // ordering and ancestry tests don't need to walk QObject parent chains.
+    // The table is built on first use and dropped on structural changes.
+    struct StateTableEntry {
+        QAbstractState *state;
+        int parent;
+        int last; // index of the last descendant
+        int depth;
+        // of the state and its ancestors, in the order selectTransitions() tries them
+        QVector<QAbstractTransition *> transitions;
+    };
+    static void invalidateStateTable(QState *changedState);
+    void updateStateTable() const;
+    void addToStateTable(QAbstractState *state, int parent) const;
+    int stateIndex(const QAbstractState *state) const;
+    bool isDescendantInTable(const QAbstractState *state1, const QAbstractState *state2) const;
+    template <typename Iterator>
+    void sortInEntryOrder(Iterator begin, Iterator end) const;
+    template <typename Iterator>
+    void sortInExitOrder(Iterator begin, Iterator end) const;
+    void sortInTransitionOrder(QList<QAbstractTransition *> &transitions) const;
+
     void goToState(QAbstractState *targetState);
 
     void registerTransitions(QAbstractState *state);
@@ -262,6 +284,11 @@ public:
     QSet<QAbstractState *> pendingErrorStates;
     QSet<QAbstractState *> pendingErrorStatesForDefaultEntry;
 
+    mutable QVector<StateTableEntry> stateTable;
+    mutable QHash<const QAbstractState *, int> stateTableIndexes;
+    mutable bool stateTableValid;
+    mutable bool stateTableFlat;
+
 #ifndef QT_NO_ANIMATION
     bool animated;
 
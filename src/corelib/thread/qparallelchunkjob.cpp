@@ -0,0 +1,203 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qparallelchunkjob_p.h"
+#include "qmutex.h"
+#include "qrunnable.h"
+#include "qsharedpointer.h"
+#include "qthreadpool.h"
+#include "qwaitcondition.h"
+
+#ifndef QT_NO_THREAD
+
+QT_BEGIN_NAMESPACE
+
+/*
+    The part of a job that its runnables share. It outlives the job, so
+    that runnables that the thread pool starts after execute() returned
+    find out that there is nothing left to do without touching the job.
+*/
+struct QParallelChunkJobHelpers
+{
+    explicit QParallelChunkJobHelpers(QParallelChunkJob *job)
+        : job(job), running(0)
+    {
+    }
+
+    QMutex mutex;
+    QWaitCondition finished;
+    QParallelChunkJob *job; // 0 once execute() takes no more helpers
+    int running;
+};
+
+class QParallelChunkJobRunnable : public QRunnable
+{
+public:
+    explicit QParallelChunkJobRunnable(const QSharedPointer<QParallelChunkJobHelpers> &helpers)
+        : helpers(helpers)
+    {
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        QParallelChunkJob *job;
+        {
+            QMutexLocker locker(&helpers->mutex);
+            job = helpers->job;
+            if (!job)
+                return;
+            ++helpers->running;
+        }
+
+        job->runInHelperThread();
+
+        QMutexLocker locker(&helpers->mutex);
+        if (--helpers->running == 0 && !helpers->job)
+            helpers->finished.wakeAll();
+    }
+
+private:
+    QSharedPointer<QParallelChunkJobHelpers> helpers;
+};
+
+/*!
+    \internal
+    \class QParallelChunkJob
+    \inmodule QtCore
+
+    \brief The QParallelChunkJob class splits work into chunks that are
+    processed by the calling thread together with the threads of a
+    QThreadPool.
+
+    Subclasses implement processChunk(). execute() runs the chunks and
+    returns once all of them are processed and no helper thread uses the
+    job anymore, so the job and whatever it refers to can live on the
+    caller's stack. The calling thread never waits for a helper that the
+    pool has not started yet: such a helper finds no job when it finally
+    runs and returns at once.
+*/
+
+/*!
+    \internal
+
+    Constructs a job of \a chunkCount chunks.
+*/
+QParallelChunkJob::QParallelChunkJob(int chunkCount)
+    : m_chunkCount(chunkCount)
+{
+}
+
+/*!
+    \internal
+*/
+QParallelChunkJob::~QParallelChunkJob()
+{
+}
+
+/*!
+    \internal
+
+    Processes all chunks of the job, using up to pool->maxThreadCount() - 1
+    threads of \a pool besides the calling thread.
+*/
+void QParallelChunkJob::execute(QThreadPool *pool)
+{
+    const int helperCount = qMin(m_chunkCount, pool->maxThreadCount()) - 1;
+    if (helperCount <= 0) {
+        run();
+        return;
+    }
+
+    QSharedPointer<QParallelChunkJobHelpers> helpers =
+        QSharedPointer<QParallelChunkJobHelpers>::create(this);
+    for (int i = 0; i < helperCount; ++i)
+        pool->start(new QParallelChunkJobRunnable(helpers));
+
+    run();
+
+    // all chunks are taken; wait for the helpers still processing theirs
+    QMutexLocker locker(&helpers->mutex);
+    helpers->job = Q_NULLPTR;
+    while (helpers->running > 0)
+        helpers->finished.wait(&helpers->mutex);
+}
+
+/*!
+    \internal
+
+    Takes the next chunk that no thread has taken yet and stores it in
+    \a chunk. Returns \c false if there is none left.
+*/
+bool QParallelChunkJob::takeChunk(int *chunk)
+{
+    *chunk = m_nextChunk.fetchAndAddRelaxed(1);
+    return *chunk < m_chunkCount;
+}
+
+/*!
+    \internal
+    \fn void QParallelChunkJob::processChunk(int chunk)
+
+    Processes \a chunk. Called by the calling thread of execute() and by
+    the default implementation of runInHelperThread().
+*/
+
+/*!
+    \internal
+
+    Processes chunks in a thread of the pool until none is left.
+    Reimplement this function to set up state that each helper thread
+    needs for itself.
+*/
+void QParallelChunkJob::runInHelperThread()
+{
+    run();
+}
+
+void QParallelChunkJob::run()
+{
+    int chunk;
+    while (takeChunk(&chunk))
+        processChunk(chunk);
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_THREAD
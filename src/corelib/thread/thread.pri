@@ -25,6 +25,7 @@ HEADERS += thread/qmutex_p.h \
            thread/qfutureinterface_p.h \
            thread/qfuturewatcher_p.h \
            thread/qorderedmutexlocker_p.h \
+           thread/qparallelchunkjob_p.h \
            thread/qreadwritelock_p.h \
            thread/qthread_p.h \
            thread/qthreadpool_p.h
@@ -38,6 +39,7 @@ SOURCES += thread/qatomic.cpp \
            thread/qreadwritelock.cpp \
            thread/qrunnable.cpp \
            thread/qmutexpool.cpp \
+           thread/qparallelchunkjob.cpp \
            thread/qsemaphore.cpp \
            thread/qthread.cpp \
            thread/qthreadpool.cpp \
@@ -49,6 +49,7 @@
 #include "qstringalgorithms_p.h"
 #include "qscopedpointer.h"
 #include "qbytearray_p.h"
+#include "qsimd_p.h"
 #include <qdatastream.h>
 #include <qmath.h>
 
@@ -2498,11 +2499,9 @@ int QByteArray::indexOf(char ch, int from) const
     if (from < 0)
         from = qMax(from + d->size, 0);
     if (from < d->size) {
-        const char *n = d->data() + from - 1;
-        const char *e = d->data() + d->size;
-        while (++n != e)
-        if (*n == ch)
-            return  n - d->data();
+        const char *n = static_cast<const char *>(memchr(d->data() + from, ch, d->size - from));
+        if (n)
+            return n - d->data();
     }
     return -1;
 }
@@ -2677,6 +2676,13 @@ int QByteArray::count(char ch) const
     int num = 0;
     const char *i = d->data() + d->size;
     const char *b = d->data();
+#ifdef __SSE2__
+    const __m128i mch = _mm_set1_epi8(ch);
+    for ( ; b + 16 <= i; b += 16) {
+        const __m128i data = _mm_loadu_si128((const __m128i *)b);
+        num += qPopulationCount(uint(_mm_movemask_epi8(_mm_cmpeq_epi8(data, mch))));
+    }
+#endif
     while (i != b)
         if (*--i == ch)
             ++num;
@@ -3451,8 +3457,32 @@ static qulonglong toIntegral_helper(const char *data, bool *ok, int base, qulong
     return QLocaleData::bytearrayToUnsLongLong(data, base, ok);
 }
 
+// Decimal numbers are parsed in place; like qstrtoll() we skip leading
+// whitespace and accept the number ending at a '\0'
+static bool toIntegral_fast(const char *data, int size, qlonglong *value)
+{
+    int i = 0;
+    while (i < size && ascii_isspace(data[i]))
+        ++i;
+    bool ok;
+    int processed;
+    *value = asciiToLongLong(data + i, size - i, ok, processed, TrailingJunkAllowed);
+    return ok && (i + processed == size || data[i + processed] == '\0');
+}
+
+static bool toIntegral_fast(const char *data, int size, qulonglong *value)
+{
+    int i = 0;
+    while (i < size && ascii_isspace(data[i]))
+        ++i;
+    bool ok;
+    int processed;
+    *value = asciiToULongLong(data + i, size - i, ok, processed, TrailingJunkAllowed);
+    return ok && (i + processed == size || data[i + processed] == '\0');
+}
+
 template <typename T> static inline
-T toIntegral_helper(const char *data, bool *ok, int base)
+T toIntegral_helper(const QByteArray &data, bool *ok, int base)
 {
     // ### Qt6: use std::conditional<std::is_unsigned<T>::value, qulonglong, qlonglong>::type
     const bool isUnsigned = T(0) < T(-1);
@@ -3465,8 +3495,18 @@ T toIntegral_helper(const char *data, bool *ok, int base)
     }
 #endif
 
-    // we select the right overload by the last, unused parameter
-    Int64 val = toIntegral_helper(data, ok, base, Int64());
+    Int64 val;
+    if (base == 10 && toIntegral_fast(data.constData(), data.size(), &val)) {
+        if (ok)
+            *ok = true;
+    } else {
+        // same as nulTerminated()
+        QByteArray nulled(data);
+        if (IS_RAW_DATA(nulled.data_ptr()))
+            nulled.detach();
+        // we select the right overload by the last, unused parameter
+        val = toIntegral_helper(nulled.constData(), ok, base, Int64());
+    }
     if (T(val) != val) {
         if (ok)
             *ok = false;
@@ -3497,7 +3537,7 @@ T toIntegral_helper(const char *data, bool *ok, int base)
 
 qlonglong QByteArray::toLongLong(bool *ok, int base) const
 {
-    return toIntegral_helper<qlonglong>(nulTerminated().constData(), ok, base);
+    return toIntegral_helper<qlonglong>(*this, ok, base);
 }
 
 /*!
@@ -3523,7 +3563,7 @@ qlonglong QByteArray::toLongLong(bool *ok, int base) const
 
 qulonglong QByteArray::toULongLong(bool *ok, int base) const
 {
-    return toIntegral_helper<qulonglong>(nulTerminated().constData(), ok, base);
+    return toIntegral_helper<qulonglong>(*this, ok, base);
 }
 
 /*!
@@ -3550,7 +3590,7 @@ qulonglong QByteArray::toULongLong(bool *ok, int base) const
 
 int QByteArray::toInt(bool *ok, int base) const
 {
-    return toIntegral_helper<int>(nulTerminated().constData(), ok, base);
+    return toIntegral_helper<int>(*this, ok, base);
 }
 
 /*!
@@ -3575,7 +3615,7 @@ int QByteArray::toInt(bool *ok, int base) const
 
 uint QByteArray::toUInt(bool *ok, int base) const
 {
-    return toIntegral_helper<uint>(nulTerminated().constData(), ok, base);
+    return toIntegral_helper<uint>(*this, ok, base);
 }
 
 /*!
@@ -3603,7 +3643,7 @@ uint QByteArray::toUInt(bool *ok, int base) const
 */
 long QByteArray::toLong(bool *ok, int base) const
 {
-    return toIntegral_helper<long>(nulTerminated().constData(), ok, base);
+    return toIntegral_helper<long>(*this, ok, base);
 }
 
 /*!
@@ -3629,7 +3669,7 @@ long QByteArray::toLong(bool *ok, int base) const
 */
 ulong QByteArray::toULong(bool *ok, int base) const
 {
-    return toIntegral_helper<ulong>(nulTerminated().constData(), ok, base);
+    return toIntegral_helper<ulong>(*this, ok, base);
 }
 
 /*!
@@ -3654,7 +3694,7 @@ ulong QByteArray::toULong(bool *ok, int base) const
 
 short QByteArray::toShort(bool *ok, int base) const
 {
-    return toIntegral_helper<short>(nulTerminated().constData(), ok, base);
+    return toIntegral_helper<short>(*this, ok, base);
 }
 
 /*!
@@ -3679,7 +3719,7 @@ short QByteArray::toShort(bool *ok, int base) const
 
 ushort QByteArray::toUShort(bool *ok, int base) const
 {
-    return toIntegral_helper<ushort>(nulTerminated().constData(), ok, base);
+    return toIntegral_helper<ushort>(*this, ok, base);
 }
 
 
@@ -3701,10 +3741,15 @@ ushort QByteArray::toUShort(bool *ok, int base) const
 
 double QByteArray::toDouble(bool *ok) const
 {
-    QByteArray nulled = nulTerminated();
     bool nonNullOk = false;
     int processed = 0;
+#if !defined(QT_NO_DOUBLECONVERSION) && !defined(QT_BOOTSTRAPPED)
+    // asciiToDouble() stays within the given range
+    double d = asciiToDouble(constData(), size(), nonNullOk, processed);
+#else
+    QByteArray nulled = nulTerminated();
     double d = asciiToDouble(nulled.constData(), nulled.length(), nonNullOk, processed);
+#endif
     if (ok)
         *ok = nonNullOk;
     return d;
@@ -3959,7 +4004,14 @@ QByteArray &QByteArray::setNum(double n, char f, int prec)
             break;
     }
 
-    *this = QLocaleData::c()->doubleToString(n, prec, form, -1, flags).toLatin1();
+    char buf[64];
+    const int length = doubleToAsciiString(n, form, prec, flags, buf, sizeof(buf));
+    if (length >= 0) {
+        clear();
+        append(buf, length);
+    } else {
+        *this = QLocaleData::c()->doubleToString(n, prec, form, -1, flags).toLatin1();
+    }
     return *this;
 }
 
@@ -39,7 +39,11 @@
 
 #include "qbytearraymatcher.h"
 
+#include <qalgorithms.h>
+#include <private/qsimd_p.h>
+
 #include <limits.h>
+#include <string.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -87,6 +91,69 @@ static inline int bm_find(const uchar *cc, int l, int index, const uchar *puc, u
     return -1; // not found
 }
 
+/*
+    Needles longer than this are searched for with Boyer-Moore, whose skips
+    then pay off; shorter ones with fl_find().
+*/
+enum { FirstLastMaxNeedleLength = 64 };
+
+/*
+    Searches for the needle \a puc (\a pl bytes, at least 2) in \a cc (\a
+    l bytes), starting at \a index, by comparing the first and the last
+    byte of the needle with several positions of the haystack at once; only
+    where both match, the rest of the needle is compared. This needs no
+    setup and, as the first and the last byte rarely match together by
+    chance, beats Boyer-Moore for short and medium needles.
+*/
+static int fl_find(const uchar *cc, int l, int index, const uchar *puc, uint pl)
+{
+    Q_ASSERT(pl >= 2);
+    if (index < 0 || uint(index) + pl > uint(l))
+        return -1;
+
+    const uint pl_minus_one = pl - 1;
+    const uchar first = puc[0];
+    const uchar last = puc[pl_minus_one];
+    const uchar *current = cc + index;
+    const uchar * const end = cc + l - pl_minus_one; // one past the last possible match
+
+#ifdef __SSE2__
+    const __m128i vfirst = _mm_set1_epi8(first);
+    const __m128i vlast = _mm_set1_epi8(last);
+
+    // we're going to read current[0..15] and current[pl - 1 .. pl + 14]
+    for ( ; current + 16 <= end; current += 16) {
+        const __m128i f = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)current), vfirst);
+        const __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(current + pl_minus_one)), vlast);
+        uint mask = _mm_movemask_epi8(_mm_and_si128(f, b));
+        while (mask) {
+            const uint i = qCountTrailingZeroBits(mask);
+            if (memcmp(current + i + 1, puc + 1, pl - 2) == 0)
+                return current + i - cc;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for ( ; current < end; ++current) {
+        if (*current == first && current[pl_minus_one] == last
+                && memcmp(current + 1, puc + 1, pl - 2) == 0) {
+            return current - cc;
+        }
+    }
+    return -1; // not found
+}
+
+/*
+    Searches with fl_find() or bm_find(), whichever is faster for the needle.
+*/
+static inline int qt_find(const uchar *cc, int l, int index, const uchar *puc, uint pl,
+                          const uchar *skiptable)
+{
+    if (pl >= 2 && pl <= FirstLastMaxNeedleLength)
+        return fl_find(cc, l, index, puc, pl);
+    return bm_find(cc, l, index, puc, pl, skiptable);
+}
+
 /*! \class QByteArrayMatcher
     \inmodule QtCore
     \brief The QByteArrayMatcher class holds a sequence of bytes that
@@ -200,7 +267,7 @@ int QByteArrayMatcher::indexIn(const QByteArray &ba, int from) const
 {
     if (from < 0)
         from = 0;
-    return bm_find(reinterpret_cast<const uchar *>(ba.constData()), ba.size(), from,
+    return qt_find(reinterpret_cast<const uchar *>(ba.constData()), ba.size(), from,
                    p.p, p.l, p.q_skiptable);
 }
 
@@ -215,7 +282,7 @@ int QByteArrayMatcher::indexIn(const char *str, int len, int from) const
 {
     if (from < 0)
         from = 0;
-    return bm_find(reinterpret_cast<const uchar *>(str), len, from,
+    return qt_find(reinterpret_cast<const uchar *>(str), len, from,
                    p.p, p.l, p.q_skiptable);
 }
 
@@ -236,11 +303,9 @@ static int findChar(const char *str, int len, char ch, int from)
     if (from < 0)
         from = qMax(from + len, 0);
     if (from < len) {
-        const uchar *n = s + from - 1;
-        const uchar *e = s + len;
-        while (++n != e)
-            if (*n == c)
-                return  n - s;
+        const uchar *n = static_cast<const uchar *>(memchr(s + from, c, len - from));
+        if (n)
+            return n - s;
     }
     return -1;
 }
@@ -286,6 +351,10 @@ int qFindByteArray(
     if (sl == 1)
         return findChar(haystack0, haystackLen, needle[0], from);
 
+    if (sl <= FirstLastMaxNeedleLength)
+        return fl_find(reinterpret_cast<const uchar *>(haystack0), haystackLen, from,
+                       reinterpret_cast<const uchar *>(needle), sl);
+
     /*
       We use the Boyer-Moore algorithm in cases where the overhead
       for the skip table should pay off, otherwise we use a simple
@@ -41,9 +41,18 @@
 #include "qcollator_p.h"
 #include "qstringlist.h"
 #include "qstring.h"
+#include "qvarlengtharray.h"
+#ifndef QT_NO_THREAD
+#include "qscopedpointer.h"
+#include "qthreadpool.h"
+#include "private/qparallelchunkjob_p.h"
+#endif
 
 #include "qdebug.h"
 
+#include <algorithm>
+#include <numeric>
+
 QT_BEGIN_NAMESPACE
 
 
@@ -64,7 +73,8 @@ QT_BEGIN_NAMESPACE
     and sort strings in a locale dependent fashion.
 
     A QCollator object can be used together with template based sorting algorithms such as std::sort
-    to sort a list of QStrings.
+    to sort a list of QStrings. Sorting many strings is faster with sort(), which computes the
+    collation of each string only once.
 
     In addition to the locale and collation strategy, several optional flags can be set that influence
     the result of the collation.
@@ -142,20 +152,35 @@ QCollator &QCollator::operator=(const QCollator &other)
     never fails.
 */
 
+/*!
+    \internal
+
+    Returns a new, initialized QCollatorPrivate with the same settings as \a d.
+ */
+static QCollatorPrivate *copyCollatorPrivate(const QCollatorPrivate *d)
+{
+    QCollatorPrivate *x = new QCollatorPrivate;
+    x->ref.store(1);
+    x->locale = d->locale;
+    x->caseSensitivity = d->caseSensitivity;
+    x->numericMode = d->numericMode;
+    x->ignorePunctuation = d->ignorePunctuation;
+    x->sortKeyCache.setMaxCost(d->sortKeyCache.maxCost());
+    x->collator = 0;
+    x->init();
+    return x;
+}
+
 /*!
     \internal
  */
 void QCollator::detach()
 {
     if (d->ref.load() != 1) {
-        QCollatorPrivate *x = new QCollatorPrivate;
-        x->ref.store(1);
-        x->locale = d->locale;
-        x->collator = 0;
+        QCollatorPrivate *x = copyCollatorPrivate(d);
         if (!d->ref.deref())
             delete d;
         d = x;
-        d->init();
     }
 }
 
@@ -170,6 +195,7 @@ void QCollator::setLocale(const QLocale &locale)
     detach();
     d->locale = locale;
     d->dirty = true;
+    d->sortKeyCache.clear();
 }
 
 /*!
@@ -195,6 +221,7 @@ void QCollator::setCaseSensitivity(Qt::CaseSensitivity cs)
     detach();
     d->caseSensitivity = cs;
     d->dirty = true;
+    d->sortKeyCache.clear();
 }
 
 /*!
@@ -233,6 +260,7 @@ void QCollator::setNumericMode(bool on)
     detach();
     d->numericMode = on;
     d->dirty = true;
+    d->sortKeyCache.clear();
 }
 
 /*!
@@ -266,6 +294,7 @@ void QCollator::setIgnorePunctuation(bool on)
     detach();
     d->ignorePunctuation = on;
     d->dirty = true;
+    d->sortKeyCache.clear();
 }
 
 /*!
@@ -312,15 +341,215 @@ bool QCollator::ignorePunctuation() const
 */
 
 /*!
-    \fn QCollatorSortKey QCollator::sortKey(const QString &string) const
-
     Returns a sortKey for \a string.
 
     Creating the sort key is usually somewhat slower, than using the compare()
     methods directly. But if the string is compared repeatedly (e.g. when sorting
     a whole list of strings), it's usually faster to create the sort keys for each
     string and then sort using the keys.
+
+    If a sort key cache has been enabled with setSortKeyCacheLimit(), the keys of
+    recently used strings are returned from the cache.
+
+    \sa sort()
+ */
+QCollatorSortKey QCollator::sortKey(const QString &string) const
+{
+    if (d->dirty)
+        d->init();
+
+    if (d->sortKeyCache.maxCost() <= 0)
+        return QCollatorSortKey(new QCollatorSortKeyPrivate(d->computeSortKey(string)));
+
+    QMutexLocker locker(&d->sortKeyCacheMutex);
+    if (const QCollatorSortKey *key = d->sortKeyCache.object(string))
+        return *key;
+    locker.unlock();
+
+    const QCollatorSortKey key(new QCollatorSortKeyPrivate(d->computeSortKey(string)));
+
+    locker.relock();
+    d->sortKeyCache.insert(string, new QCollatorSortKey(key));
+    return key;
+}
+
+/*!
+    \since 5.8
+
+    Sets the maximum number of sort keys that this collator caches to \a
+    limit. The cache holds the keys most recently returned by sortKey() or
+    computed by sort(), so that the collation of strings that are used
+    over and over again (for instance, the items of a model that gets
+    sorted repeatedly) is computed only once.
+
+    The cache is shared by the copies of a collator. Changing any setting
+    of the collator clears it. By default the limit is 0, that is, no keys
+    are cached.
+
+    \sa sortKeyCacheLimit(), sortKey()
+ */
+void QCollator::setSortKeyCacheLimit(int limit)
+{
+    limit = qMax(limit, 0);
+    if (d->sortKeyCache.maxCost() == limit)
+        return;
+
+    detach();
+    QMutexLocker locker(&d->sortKeyCacheMutex);
+    d->sortKeyCache.setMaxCost(limit);
+}
+
+/*!
+    \since 5.8
+
+    Returns the maximum number of sort keys that this collator caches.
+
+    \sa setSortKeyCacheLimit()
  */
+int QCollator::sortKeyCacheLimit() const
+{
+    return d->sortKeyCache.maxCost();
+}
+
+#ifndef QT_NO_THREAD
+namespace {
+/*
+    The sort keys of a list of strings, computed in chunks by the thread
+    calling QCollator::sort() and by the threads of the global thread pool.
+    The helper threads only use the job's own copy of the collator settings,
+    never the QCollator that sort() was called on.
+*/
+class QCollatorSortKeysJob : public QParallelChunkJob
+{
+public:
+    enum { ChunkSize = 1024 };
+
+    QCollatorSortKeysJob(const QCollatorPrivate *collator, const QStringList &strings,
+                         CollatorKeyType *keys, const char *done)
+        : QParallelChunkJob((strings.size() + ChunkSize - 1) / ChunkSize),
+          collator(collator), settings(copyCollatorPrivate(collator)),
+          strings(strings), keys(keys), done(done)
+    {
+    }
+
+protected:
+    void processChunk(int chunk) Q_DECL_OVERRIDE
+    {
+        computeKeys(chunk, collator);
+    }
+
+    void runInHelperThread() Q_DECL_OVERRIDE
+    {
+        if (!hasPendingChunks())
+            return;
+#if defined(QT_USE_ICU) || defined(Q_OS_OSX)
+        // these collators can't be used by several threads at the same time
+        QScopedPointer<QCollatorPrivate> copy(copyCollatorPrivate(settings.data()));
+        const QCollatorPrivate *d = copy.data();
+#else
+        const QCollatorPrivate *d = settings.data();
+#endif
+        int chunk;
+        while (takeChunk(&chunk))
+            computeKeys(chunk, d);
+    }
+
+private:
+    void computeKeys(int chunk, const QCollatorPrivate *d)
+    {
+        const int end = qMin(strings.size(), (chunk + 1) * int(ChunkSize));
+        for (int i = chunk * ChunkSize; i < end; ++i) {
+            if (!done[i])
+                keys[i] = d->computeSortKey(strings.at(i));
+        }
+    }
+
+    const QCollatorPrivate * const collator; // only used by the calling thread
+    const QScopedPointer<const QCollatorPrivate> settings;
+    const QStringList strings;
+    CollatorKeyType * const keys;
+    const char * const done;
+};
+} // unnamed namespace
+#endif // QT_NO_THREAD
+
+/*!
+    \since 5.8
+
+    Sorts \a list according to this collator.
+
+    The sort key of each string is computed only once, and the list is then
+    sorted by comparing the keys, which is much faster than comparing the
+    strings with compare() over and over again. For long lists, the keys are
+    computed in parallel by the threads of QThreadPool::globalInstance().
+
+    Strings that compare equal keep their relative order.
+
+    \sa sortKey(), compare()
+ */
+void QCollator::sort(QStringList &list) const
+{
+    const int count = list.size();
+    if (count < 2)
+        return;
+
+    if (d->dirty)
+        d->init();
+
+    QVector<CollatorKeyType> keyVector(count);
+    CollatorKeyType * const keys = keyVector.data();
+    QVarLengthArray<char, 1> done(count); // the keys found in the cache
+    memset(done.data(), 0, count);
+
+    const int cacheLimit = d->sortKeyCache.maxCost();
+    if (cacheLimit > 0) {
+        QMutexLocker locker(&d->sortKeyCacheMutex);
+        for (int i = 0; i < count; ++i) {
+            if (const QCollatorSortKey *key = d->sortKeyCache.object(list.at(i))) {
+                keys[i] = key->d->m_key;
+                done[i] = true;
+            }
+        }
+    }
+
+#ifndef QT_NO_THREAD
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int chunkCount = (count + QCollatorSortKeysJob::ChunkSize - 1) / QCollatorSortKeysJob::ChunkSize;
+    const int helpers = qMin(chunkCount, pool->maxThreadCount()) - 1;
+    if (chunkCount >= 4 && helpers > 0) {
+        QCollatorSortKeysJob job(d, list, keys, done.constData());
+        job.execute(pool);
+    } else
+#endif
+    {
+        for (int i = 0; i < count; ++i) {
+            if (!done[i])
+                keys[i] = d->computeSortKey(list.at(i));
+        }
+    }
+
+    if (cacheLimit > 0) {
+        // only the most recent keys would survive in the cache anyway
+        QMutexLocker locker(&d->sortKeyCacheMutex);
+        for (int i = qMax(0, count - cacheLimit); i < count; ++i) {
+            if (!done[i])
+                d->sortKeyCache.insert(list.at(i), new QCollatorSortKey(new QCollatorSortKeyPrivate(keys[i])));
+        }
+    }
+
+    QVector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [keys](int lhs, int rhs) {
+        const int result = QCollatorPrivate::compareSortKeys(keys[lhs], keys[rhs]);
+        return result < 0 || (result == 0 && lhs < rhs);
+    });
+
+    QStringList sorted;
+    sorted.reserve(count);
+    for (int i : qAsConst(order))
+        sorted.append(list.at(i));
+    list.swap(sorted);
+}
 
 /*!
     \class QCollatorSortKey
@@ -397,13 +626,15 @@ QCollatorSortKey& QCollatorSortKey::operator=(const QCollatorSortKey &other)
 */
 
 /*!
-    \fn int QCollatorSortKey::compare(const QCollatorSortKey &otherKey) const
-
     Compares the key to \a otherKey. Returns a negative value if the key
     is less than \a otherKey, 0 if the key is equal to \a otherKey or a
     positive value if the key is greater than \a otherKey.
 
     \sa operator<()
  */
+int QCollatorSortKey::compare(const QCollatorSortKey &otherKey) const
+{
+    return QCollatorPrivate::compareSortKeys(d->m_key, otherKey.d->m_key);
+}
 
 QT_END_NAMESPACE
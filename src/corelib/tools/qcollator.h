@@ -118,6 +118,11 @@ public:
 
     QCollatorSortKey sortKey(const QString &string) const;
 
+    void setSortKeyCacheLimit(int limit);
+    int sortKeyCacheLimit() const;
+
+    void sort(QStringList &list) const;
+
 private:
     QCollatorPrivate *d;
 
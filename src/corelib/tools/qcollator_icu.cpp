@@ -129,30 +129,27 @@ int QCollator::compare(const QStringRef &s1, const QStringRef &s2) const
     return QStringRef::compare(s1, s2, d->caseSensitivity);
 }
 
-QCollatorSortKey QCollator::sortKey(const QString &string) const
+CollatorKeyType QCollatorPrivate::computeSortKey(const QString &string) const
 {
-    if (d->dirty)
-        d->init();
-
-    if (d->collator) {
+    if (collator) {
         QByteArray result(16 + string.size() + (string.size() >> 2), Qt::Uninitialized);
-        int size = ucol_getSortKey(d->collator, (const UChar *)string.constData(),
+        int size = ucol_getSortKey(collator, (const UChar *)string.constData(),
                                    string.size(), (uint8_t *)result.data(), result.size());
         if (size > result.size()) {
             result.resize(size);
-            size = ucol_getSortKey(d->collator, (const UChar *)string.constData(),
+            size = ucol_getSortKey(collator, (const UChar *)string.constData(),
                                    string.size(), (uint8_t *)result.data(), result.size());
         }
         result.truncate(size);
-        return QCollatorSortKey(new QCollatorSortKeyPrivate(result));
+        return result;
     }
 
-    return QCollatorSortKey(new QCollatorSortKeyPrivate(QByteArray()));
+    return QByteArray();
 }
 
-int QCollatorSortKey::compare(const QCollatorSortKey &otherKey) const
+int QCollatorPrivate::compareSortKeys(const CollatorKeyType &key1, const CollatorKeyType &key2)
 {
-    return qstrcmp(d->m_key, otherKey.d->m_key);
+    return qstrcmp(key1, key2);
 }
 
 QT_END_NAMESPACE
@@ -111,31 +111,28 @@ int QCollator::compare(const QStringRef &s1, const QStringRef &s2) const
     return compare(s1.constData(), s1.size(), s2.constData(), s2.size());
 }
 
-QCollatorSortKey QCollator::sortKey(const QString &string) const
+CollatorKeyType QCollatorPrivate::computeSortKey(const QString &string) const
 {
-    if (d->dirty)
-        d->init();
-
     //Documentation recommends having it 5 times as big as the input
     QVector<UCCollationValue> ret(string.size() * 5);
     ItemCount actualSize;
-    int status = UCGetCollationKey(d->collator, reinterpret_cast<const UniChar *>(string.constData()), string.count(),
+    int status = UCGetCollationKey(collator, reinterpret_cast<const UniChar *>(string.constData()), string.count(),
                                    ret.size(), &actualSize, ret.data());
 
     ret.resize(actualSize+1);
     if (status == kUCOutputBufferTooSmall) {
-        UCGetCollationKey(d->collator, reinterpret_cast<const UniChar *>(string.constData()), string.count(),
+        UCGetCollationKey(collator, reinterpret_cast<const UniChar *>(string.constData()), string.count(),
                           ret.size(), &actualSize, ret.data());
     }
     ret[actualSize] = 0;
-    return QCollatorSortKey(new QCollatorSortKeyPrivate(ret));
+    return ret;
 }
 
-int QCollatorSortKey::compare(const QCollatorSortKey &key) const
+int QCollatorPrivate::compareSortKeys(const CollatorKeyType &key1, const CollatorKeyType &key2)
 {
     SInt32 order;
-    UCCompareCollationKeys(d->m_key.data(), d->m_key.size(),
-                           key.d->m_key.data(), key.d->m_key.size(),
+    UCCompareCollationKeys(key1.constData(), key1.size(),
+                           key2.constData(), key2.size(),
                            0, &order);
     return order;
 }
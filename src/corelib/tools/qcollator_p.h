@@ -54,6 +54,8 @@
 
 #include "qcollator.h"
 #include <QVector>
+#include <QCache>
+#include <QMutex>
 #ifdef QT_USE_ICU
 #include <unicode/ucol.h>
 #elif defined(Q_OS_OSX)
@@ -103,6 +105,11 @@ public:
 
     CollatorType collator;
 
+    // recently computed sort keys, see QCollator::setSortKeyCacheLimit();
+    // the mutex protects the cache, as copies of a QCollator share it
+    QMutex sortKeyCacheMutex;
+    QCache<QString, QCollatorSortKey> sortKeyCache;
+
     void clear() {
         cleanup();
         collator = 0;
@@ -111,13 +118,18 @@ public:
     void init();
     void cleanup();
 
+    // implemented by each backend; init() must have been called
+    CollatorKeyType computeSortKey(const QString &string) const;
+    static int compareSortKeys(const CollatorKeyType &key1, const CollatorKeyType &key2);
+
     QCollatorPrivate()
         : ref(1),
           caseSensitivity(Qt::CaseSensitive),
           numericMode(false),
           ignorePunctuation(false),
           dirty(true),
-          collator(0)
+          collator(0),
+          sortKeyCache(0)
     { cleanup(); }
 
     ~QCollatorPrivate() { cleanup(); }
@@ -95,27 +95,25 @@ int QCollator::compare(const QStringRef &s1, const QStringRef &s2) const
     return compare(s1.constData(), s1.size(), s2.constData(), s2.size());
 }
 
-QCollatorSortKey QCollator::sortKey(const QString &string) const
+CollatorKeyType QCollatorPrivate::computeSortKey(const QString &string) const
 {
-    if (d->dirty)
-        d->init();
-
     QVarLengthArray<wchar_t> original;
     stringToWCharArray(original, string);
-    QVector<wchar_t> result(string.size());
-    size_t size = std::wcsxfrm(result.data(), original.constData(), string.size());
-    if (size > uint(result.size())) {
+    QVector<wchar_t> result(string.size() + 1);
+    // the size returned by wcsxfrm doesn't include the terminating null
+    size_t size = std::wcsxfrm(result.data(), original.constData(), result.size());
+    if (size >= uint(result.size())) {
         result.resize(size+1);
-        size = std::wcsxfrm(result.data(), original.constData(), string.size());
+        size = std::wcsxfrm(result.data(), original.constData(), result.size());
     }
     result.resize(size+1);
     result[size] = 0;
-    return QCollatorSortKey(new QCollatorSortKeyPrivate(result));
+    return result;
 }
 
-int QCollatorSortKey::compare(const QCollatorSortKey &otherKey) const
+int QCollatorPrivate::compareSortKeys(const CollatorKeyType &key1, const CollatorKeyType &key2)
 {
-    return std::wcscmp(d->m_key.constData(), otherKey.d->m_key.constData());
+    return std::wcscmp(key1.constData(), key2.constData());
 }
 
 QT_END_NAMESPACE
@@ -118,27 +118,24 @@ int QCollator::compare(const QStringRef &s1, const QStringRef &s2) const
     return compare(s1.constData(), s1.size(), s2.constData(), s2.size());
 }
 
-QCollatorSortKey QCollator::sortKey(const QString &string) const
+CollatorKeyType QCollatorPrivate::computeSortKey(const QString &string) const
 {
-    if (d->dirty)
-        d->init();
-
 #ifndef USE_COMPARESTRINGEX
-    int size = LCMapStringW(d->localeID, LCMAP_SORTKEY | d->collator,
+    int size = LCMapStringW(localeID, LCMAP_SORTKEY | collator,
                            reinterpret_cast<const wchar_t*>(string.constData()), string.size(),
                            0, 0);
 #else
-    int size = LCMapStringEx(LPCWSTR(d->localeName.utf16()), LCMAP_SORTKEY | d->collator,
+    int size = LCMapStringEx(LPCWSTR(localeName.utf16()), LCMAP_SORTKEY | collator,
                            reinterpret_cast<LPCWSTR>(string.constData()), string.size(),
                            0, 0, NULL, NULL, 0);
 #endif
     QString ret(size, Qt::Uninitialized);
 #ifndef USE_COMPARESTRINGEX
-    int finalSize = LCMapStringW(d->localeID, LCMAP_SORTKEY | d->collator,
+    int finalSize = LCMapStringW(localeID, LCMAP_SORTKEY | collator,
                            reinterpret_cast<const wchar_t*>(string.constData()), string.size(),
                            reinterpret_cast<wchar_t*>(ret.data()), ret.size());
 #else
-    int finalSize = LCMapStringEx(LPCWSTR(d->localeName.utf16()), LCMAP_SORTKEY | d->collator,
+    int finalSize = LCMapStringEx(LPCWSTR(localeName.utf16()), LCMAP_SORTKEY | collator,
                            reinterpret_cast<LPCWSTR>(string.constData()), string.size(),
                            reinterpret_cast<LPWSTR>(ret.data()), ret.size(),
                            NULL, NULL, 0);
@@ -146,12 +143,12 @@ QCollatorSortKey QCollator::sortKey(const QString &string) const
     if (finalSize == 0) {
         qWarning() << "there were problems when generating the ::sortKey by LCMapStringW with error:" << GetLastError();
     }
-    return QCollatorSortKey(new QCollatorSortKeyPrivate(ret));
+    return ret;
 }
 
-int QCollatorSortKey::compare(const QCollatorSortKey &otherKey) const
+int QCollatorPrivate::compareSortKeys(const CollatorKeyType &key1, const CollatorKeyType &key2)
 {
-    return d->m_key.compare(otherKey.d->m_key);
+    return key1.compare(key2);
 }
 
 QT_END_NAMESPACE
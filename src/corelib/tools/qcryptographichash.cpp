@@ -40,6 +40,13 @@
 
 #include <qcryptographichash.h>
 #include <qiodevice.h>
+#ifndef QT_BOOTSTRAPPED
+#include <qfiledevice.h>
+#endif
+#include <qvarlengtharray.h>
+#include <private/qsimd_p.h>
+
+#include <algorithm>
 
 #include "../../3rdparty/sha1/sha1.cpp"
 
@@ -163,6 +170,457 @@ public:
     QByteArray result;
 };
 
+/*
+    Hardware accelerated block functions
+
+    The x86 SHA extensions compress SHA-1 and SHA-256 blocks in hardware.
+    The reference implementations are used when the processor doesn't
+    support them.
+*/
+#if QT_COMPILER_SUPPORTS_HERE(SSE4_1) && (!defined(Q_CC_MSVC) || Q_CC_MSVC >= 1900)
+#  define QCRYPTOGRAPHICHASH_SHA_NI
+#  if defined(Q_CC_GNU) && !defined(Q_CC_INTEL)
+     // the SHA instructions are used together with SSSE3 and SSE4.1 shuffles
+#    define QT_FUNCTION_TARGET_SHA_NI \
+        __attribute__((__target__(QT_FUNCTION_TARGET_STRING_SHA "," QT_FUNCTION_TARGET_STRING_SSE4_1)))
+#  else
+#    define QT_FUNCTION_TARGET_SHA_NI
+#  endif
+
+static inline bool hasShaNi()
+{
+    return qCpuHasFeature(SHA) && qCpuHasFeature(SSE4_1);
+}
+
+template <int Function>
+QT_FUNCTION_TARGET_SHA_NI
+static inline void sha1NiRounds(__m128i &abcd, __m128i &e, __m128i w)
+{
+    // e holds ABCD as it was before the previous four rounds
+    const __m128i x = _mm_sha1nexte_epu32(e, w);
+    e = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, x, Function);
+}
+
+QT_FUNCTION_TARGET_SHA_NI
+static inline __m128i sha1NiSchedule(__m128i w4, __m128i w3, __m128i w2, __m128i w1)
+{
+    // the next four message words from the previous sixteen
+    return _mm_sha1msg2_epu32(_mm_xor_si128(_mm_sha1msg1_epu32(w4, w3), w2), w1);
+}
+
+QT_FUNCTION_TARGET_SHA_NI
+static void sha1ProcessBlocksShaNi(Sha1State *state, const unsigned char *data, qint64 blocks)
+{
+    const __m128i byteSwap = _mm_set_epi64x(Q_INT64_C(0x0001020304050607), Q_INT64_C(0x08090a0b0c0d0e0f));
+    __m128i abcd = _mm_set_epi32(state->h0, state->h1, state->h2, state->h3);
+    __m128i e0 = _mm_set_epi32(state->h4, 0, 0, 0);
+
+    for ( ; blocks; --blocks, data += 64) {
+        const __m128i abcdSave = abcd;
+        const __m128i e0Save = e0;
+        const __m128i *block = reinterpret_cast<const __m128i *>(data);
+        __m128i w0 = _mm_shuffle_epi8(_mm_loadu_si128(block), byteSwap);
+        __m128i w1 = _mm_shuffle_epi8(_mm_loadu_si128(block + 1), byteSwap);
+        __m128i w2 = _mm_shuffle_epi8(_mm_loadu_si128(block + 2), byteSwap);
+        __m128i w3 = _mm_shuffle_epi8(_mm_loadu_si128(block + 3), byteSwap);
+
+        __m128i e = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, _mm_add_epi32(e0, w0), 0);
+        sha1NiRounds<0>(abcd, e, w1);
+        sha1NiRounds<0>(abcd, e, w2);
+        sha1NiRounds<0>(abcd, e, w3);
+        w0 = sha1NiSchedule(w0, w1, w2, w3); sha1NiRounds<0>(abcd, e, w0);
+        w1 = sha1NiSchedule(w1, w2, w3, w0); sha1NiRounds<1>(abcd, e, w1);
+        w2 = sha1NiSchedule(w2, w3, w0, w1); sha1NiRounds<1>(abcd, e, w2);
+        w3 = sha1NiSchedule(w3, w0, w1, w2); sha1NiRounds<1>(abcd, e, w3);
+        w0 = sha1NiSchedule(w0, w1, w2, w3); sha1NiRounds<1>(abcd, e, w0);
+        w1 = sha1NiSchedule(w1, w2, w3, w0); sha1NiRounds<1>(abcd, e, w1);
+        w2 = sha1NiSchedule(w2, w3, w0, w1); sha1NiRounds<2>(abcd, e, w2);
+        w3 = sha1NiSchedule(w3, w0, w1, w2); sha1NiRounds<2>(abcd, e, w3);
+        w0 = sha1NiSchedule(w0, w1, w2, w3); sha1NiRounds<2>(abcd, e, w0);
+        w1 = sha1NiSchedule(w1, w2, w3, w0); sha1NiRounds<2>(abcd, e, w1);
+        w2 = sha1NiSchedule(w2, w3, w0, w1); sha1NiRounds<2>(abcd, e, w2);
+        w3 = sha1NiSchedule(w3, w0, w1, w2); sha1NiRounds<3>(abcd, e, w3);
+        w0 = sha1NiSchedule(w0, w1, w2, w3); sha1NiRounds<3>(abcd, e, w0);
+        w1 = sha1NiSchedule(w1, w2, w3, w0); sha1NiRounds<3>(abcd, e, w1);
+        w2 = sha1NiSchedule(w2, w3, w0, w1); sha1NiRounds<3>(abcd, e, w2);
+        w3 = sha1NiSchedule(w3, w0, w1, w2); sha1NiRounds<3>(abcd, e, w3);
+
+        e0 = _mm_sha1nexte_epu32(e, e0Save);
+        abcd = _mm_add_epi32(abcd, abcdSave);
+    }
+
+    state->h0 = _mm_extract_epi32(abcd, 3);
+    state->h1 = _mm_extract_epi32(abcd, 2);
+    state->h2 = _mm_extract_epi32(abcd, 1);
+    state->h3 = _mm_extract_epi32(abcd, 0);
+    state->h4 = _mm_extract_epi32(e0, 3);
+}
+#endif // QCRYPTOGRAPHICHASH_SHA_NI
+
+/*
+    Adds \a length bytes of \a data to the SHA-1 \a state, compressing
+    complete blocks straight from \a data.
+*/
+static void sha1AddData(Sha1State *state, const unsigned char *data, qint64 length)
+{
+#ifdef QCRYPTOGRAPHICHASH_SHA_NI
+    if (length >= 64 && hasShaNi()) {
+        const qint64 rest = state->messageSize & 63;
+        if (rest) {
+            const qint64 head = 64 - rest;
+            sha1Update(state, data, head);
+            data += head;
+            length -= head;
+        }
+        const qint64 blocks = length / 64;
+        sha1ProcessBlocksShaNi(state, data, blocks);
+        state->messageSize += blocks * 64;
+        data += blocks * 64;
+        length -= blocks * 64;
+    }
+#endif
+    sha1Update(state, data, length);
+}
+
+#ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+static const quint32 sha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#ifdef QCRYPTOGRAPHICHASH_SHA_NI
+QT_FUNCTION_TARGET_SHA_NI
+static inline void sha256NiRounds(__m128i &abef, __m128i &cdgh, __m128i w, int group)
+{
+    const __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sha256K + 4 * group));
+    const __m128i x = _mm_add_epi32(w, k);
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, x);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(x, 0x0e));
+}
+
+QT_FUNCTION_TARGET_SHA_NI
+static inline __m128i sha256NiSchedule(__m128i w4, __m128i w3, __m128i w2, __m128i w1)
+{
+    // the next four message words from the previous sixteen
+    const __m128i x = _mm_add_epi32(_mm_sha256msg1_epu32(w4, w3), _mm_alignr_epi8(w1, w2, 4));
+    return _mm_sha256msg2_epu32(x, w1);
+}
+
+QT_FUNCTION_TARGET_SHA_NI
+static void sha256ProcessBlocksShaNi(quint32 *hash, const unsigned char *data, qint64 blocks)
+{
+    const __m128i byteSwap = _mm_set_epi64x(Q_INT64_C(0x0c0d0e0f08090a0b), Q_INT64_C(0x0405060700010203));
+
+    // the instructions work on the state words in the order ABEF and CDGH
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash)), 0xb1);
+    __m128i cdgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash + 4)), 0x1b);
+    __m128i abef = _mm_alignr_epi8(tmp, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, tmp, 0xf0);
+
+    for ( ; blocks; --blocks, data += 64) {
+        const __m128i abefSave = abef;
+        const __m128i cdghSave = cdgh;
+        const __m128i *block = reinterpret_cast<const __m128i *>(data);
+        __m128i w0 = _mm_shuffle_epi8(_mm_loadu_si128(block), byteSwap);
+        __m128i w1 = _mm_shuffle_epi8(_mm_loadu_si128(block + 1), byteSwap);
+        __m128i w2 = _mm_shuffle_epi8(_mm_loadu_si128(block + 2), byteSwap);
+        __m128i w3 = _mm_shuffle_epi8(_mm_loadu_si128(block + 3), byteSwap);
+
+        sha256NiRounds(abef, cdgh, w0, 0);
+        sha256NiRounds(abef, cdgh, w1, 1);
+        sha256NiRounds(abef, cdgh, w2, 2);
+        sha256NiRounds(abef, cdgh, w3, 3);
+        for (int group = 4; group < 16; group += 4) {
+            w0 = sha256NiSchedule(w0, w1, w2, w3);
+            sha256NiRounds(abef, cdgh, w0, group);
+            w1 = sha256NiSchedule(w1, w2, w3, w0);
+            sha256NiRounds(abef, cdgh, w1, group + 1);
+            w2 = sha256NiSchedule(w2, w3, w0, w1);
+            sha256NiRounds(abef, cdgh, w2, group + 2);
+            w3 = sha256NiSchedule(w3, w0, w1, w2);
+            sha256NiRounds(abef, cdgh, w3, group + 3);
+        }
+
+        abef = _mm_add_epi32(abef, abefSave);
+        cdgh = _mm_add_epi32(cdgh, cdghSave);
+    }
+
+    tmp = _mm_shuffle_epi32(abef, 0x1b);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(hash), _mm_blend_epi16(tmp, cdgh, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(hash + 4), _mm_alignr_epi8(cdgh, tmp, 8));
+}
+#endif // QCRYPTOGRAPHICHASH_SHA_NI
+
+/*
+    The reference SHA-2 implementations consume their input one byte at a
+    time. These functions feed complete blocks to the block functions
+    directly, and leave the rest to the reference code.
+*/
+static void sha224_256AddData(SHA256Context *context, const unsigned char *data, qint64 length)
+{
+    if (context->Message_Block_Index) {
+        const qint64 head = qMin<qint64>(length, SHA256_Message_Block_Size - context->Message_Block_Index);
+        SHA256Input(context, data, uint(head));
+        data += head;
+        length -= head;
+    }
+
+    const qint64 blocks = length / SHA256_Message_Block_Size;
+    if (blocks && !context->Computed && !context->Corrupted) {
+        const quint64 bits = (quint64(context->Length_High) << 32 | context->Length_Low)
+                + quint64(blocks) * SHA256_Message_Block_Size * 8;
+        context->Length_High = quint32(bits >> 32);
+        context->Length_Low = quint32(bits);
+#ifdef QCRYPTOGRAPHICHASH_SHA_NI
+        if (hasShaNi()) {
+            sha256ProcessBlocksShaNi(context->Intermediate_Hash, data, blocks);
+        } else
+#endif
+        {
+            for (qint64 i = 0; i < blocks; ++i) {
+                memcpy(context->Message_Block, data + i * SHA256_Message_Block_Size, SHA256_Message_Block_Size);
+                SHA224_256ProcessMessageBlock(context);
+            }
+        }
+        data += blocks * SHA256_Message_Block_Size;
+        length -= blocks * SHA256_Message_Block_Size;
+    }
+
+    while (length > 0) {
+        const uint chunk = uint(qMin<qint64>(length, SHA256_Message_Block_Size));
+        SHA256Input(context, data, chunk);
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+static void sha384_512AddData(SHA512Context *context, const unsigned char *data, qint64 length)
+{
+#ifndef USE_32BIT_ONLY
+    if (context->Message_Block_Index) {
+        const qint64 head = qMin<qint64>(length, SHA512_Message_Block_Size - context->Message_Block_Index);
+        SHA512Input(context, data, uint(head));
+        data += head;
+        length -= head;
+    }
+
+    const qint64 blocks = length / SHA512_Message_Block_Size;
+    if (blocks && !context->Computed && !context->Corrupted) {
+        const quint64 bits = quint64(blocks) * SHA512_Message_Block_Size * 8;
+        context->Length_Low += bits;
+        if (context->Length_Low < bits)
+            ++context->Length_High;
+        for (qint64 i = 0; i < blocks; ++i) {
+            memcpy(context->Message_Block, data + i * SHA512_Message_Block_Size, SHA512_Message_Block_Size);
+            SHA384_512ProcessMessageBlock(context);
+        }
+        data += blocks * SHA512_Message_Block_Size;
+        length -= blocks * SHA512_Message_Block_Size;
+    }
+#endif
+
+    while (length > 0) {
+        const uint chunk = uint(qMin<qint64>(length, SHA512_Message_Block_Size));
+        SHA512Input(context, data, chunk);
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+/*
+    Multi-buffer SHA-256: the eight 32-bit lanes of the AVX2 registers
+    compress one block of eight independent messages at a time.
+*/
+template <int N>
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i sha256Rotr(__m256i x)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, N), _mm256_slli_epi32(x, 32 - N));
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i sha256Add(__m256i a, __m256i b)
+{
+    return _mm256_add_epi32(a, b);
+}
+
+/*
+    Compresses one block of each of eight messages. \a state holds the
+    eight state words of the eight messages, word by word.
+*/
+QT_FUNCTION_TARGET(AVX2)
+static void sha256ProcessBlockAvx2x8(quint32 state[8][8], const unsigned char *const blocks[8])
+{
+    const __m256i byteSwap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                             12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    __m256i w[16];
+
+    // transpose the blocks, so that each register holds one word of all eight messages
+    for (int half = 0; half < 2; ++half) {
+        __m256i r[8];
+        for (int lane = 0; lane < 8; ++lane)
+            r[lane] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(blocks[lane]) + half);
+        const __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+        const __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+        const __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+        const __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+        const __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+        const __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+        const __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+        const __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+        const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+        const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+        const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+        const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+        const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+        const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+        const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+        const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+        __m256i *out = w + 8 * half;
+        out[0] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u0, u4, 0x20), byteSwap);
+        out[1] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u1, u5, 0x20), byteSwap);
+        out[2] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u2, u6, 0x20), byteSwap);
+        out[3] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u3, u7, 0x20), byteSwap);
+        out[4] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u0, u4, 0x31), byteSwap);
+        out[5] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u1, u5, 0x31), byteSwap);
+        out[6] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u2, u6, 0x31), byteSwap);
+        out[7] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u3, u7, 0x31), byteSwap);
+    }
+
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[0]));
+    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[1]));
+    __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[2]));
+    __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[3]));
+    __m256i e = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[4]));
+    __m256i f = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[5]));
+    __m256i g = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[6]));
+    __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[7]));
+
+    for (int t = 0; t < 64; ++t) {
+        if (t >= 16) {
+            const __m256i w15 = w[(t - 15) & 15];
+            const __m256i w2 = w[(t - 2) & 15];
+            const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(sha256Rotr<7>(w15), sha256Rotr<18>(w15)),
+                                                _mm256_srli_epi32(w15, 3));
+            const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(sha256Rotr<17>(w2), sha256Rotr<19>(w2)),
+                                                _mm256_srli_epi32(w2, 10));
+            w[t & 15] = sha256Add(sha256Add(w[t & 15], s0), sha256Add(w[(t - 7) & 15], s1));
+        }
+
+        const __m256i sigma1 = _mm256_xor_si256(_mm256_xor_si256(sha256Rotr<6>(e), sha256Rotr<11>(e)),
+                                                sha256Rotr<25>(e));
+        const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        const __m256i temp1 = sha256Add(sha256Add(sha256Add(h, sigma1), sha256Add(ch, w[t & 15])),
+                                        _mm256_set1_epi32(sha256K[t]));
+        const __m256i sigma0 = _mm256_xor_si256(_mm256_xor_si256(sha256Rotr<2>(a), sha256Rotr<13>(a)),
+                                                sha256Rotr<22>(a));
+        const __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        h = g;
+        g = f;
+        f = e;
+        e = sha256Add(d, temp1);
+        d = c;
+        c = b;
+        b = a;
+        a = sha256Add(temp1, sha256Add(sigma0, maj));
+    }
+
+    const __m256i result[8] = { a, b, c, d, e, f, g, h };
+    for (int i = 0; i < 8; ++i) {
+        __m256i *word = reinterpret_cast<__m256i *>(state[i]);
+        _mm256_storeu_si256(word, sha256Add(_mm256_loadu_si256(word), result[i]));
+    }
+}
+
+/*
+    Hashes \a count messages of \a data with SHA-224 or SHA-256, depending
+    on the initial \a hash value and the \a hashSize, into \a results.
+*/
+static void sha224_256HashMany(const QByteArrayList &data, QByteArrayList &results,
+                               const quint32 *initialHash, int hashSize)
+{
+    struct Lane {
+        const unsigned char *data;
+        qint64 fullBlocks;
+        qint64 blocks;
+        unsigned char tail[2 * SHA256_Message_Block_Size];
+
+        const unsigned char *block(qint64 i) const
+        {
+            return i < fullBlocks ? data + i * SHA256_Message_Block_Size
+                                  : tail + (i - fullBlocks) * SHA256_Message_Block_Size;
+        }
+    };
+
+    // batch messages of similar length, so that few lanes sit idle
+    const int count = data.size();
+    QVarLengthArray<int, 256> order(count);
+    for (int i = 0; i < count; ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&data](int lhs, int rhs) {
+        return data.at(lhs).size() > data.at(rhs).size();
+    });
+
+    for (int first = 0; first < count; first += 8) {
+        const int lanes = qMin(8, count - first);
+        Lane lane[8];
+        quint32 state[8][8];
+        for (int l = 0; l < lanes; ++l) {
+            const QByteArray &message = data.at(order[first + l]);
+            const qint64 length = message.size();
+            Lane &ln = lane[l];
+            ln.data = reinterpret_cast<const unsigned char *>(message.constData());
+            ln.fullBlocks = length / SHA256_Message_Block_Size;
+            const int rest = int(length % SHA256_Message_Block_Size);
+            const int tailSize = rest + 9 <= SHA256_Message_Block_Size ? SHA256_Message_Block_Size
+                                                                         : 2 * SHA256_Message_Block_Size;
+            memcpy(ln.tail, ln.data + ln.fullBlocks * SHA256_Message_Block_Size, rest);
+            ln.tail[rest] = 0x80;
+            memset(ln.tail + rest + 1, 0, tailSize - rest - 9);
+            qToBigEndian(quint64(length) * 8, ln.tail + tailSize - 8);
+            ln.blocks = ln.fullBlocks + tailSize / SHA256_Message_Block_Size;
+        }
+        // unused lanes repeat the first message, which has the most blocks
+        for (int l = lanes; l < 8; ++l) {
+            lane[l] = lane[0];
+            lane[l].blocks = 0;
+        }
+        for (int i = 0; i < 8; ++i) {
+            for (int l = 0; l < 8; ++l)
+                state[i][l] = initialHash[i];
+        }
+
+        for (qint64 i = 0; i < lane[0].blocks; ++i) {
+            const unsigned char *blocks[8];
+            for (int l = 0; l < 8; ++l) // finished lanes repeat their last block
+                blocks[l] = lane[l].block(qMin(i, qMax<qint64>(lane[l].blocks, 1) - 1));
+            sha256ProcessBlockAvx2x8(state, blocks);
+
+            for (int l = 0; l < lanes; ++l) {
+                if (lane[l].blocks != i + 1)
+                    continue;
+                QByteArray &result = results[order[first + l]];
+                result.resize(hashSize);
+                uchar *out = reinterpret_cast<uchar *>(result.data());
+                for (int j = 0; j < hashSize / 4; ++j)
+                    qToBigEndian(state[j][l], out + 4 * j);
+            }
+        }
+    }
+}
+#endif // AVX2
+#endif // QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+
 /*!
   \class QCryptographicHash
   \inmodule QtCore
@@ -271,7 +729,7 @@ void QCryptographicHash::addData(const char *data, int length)
 {
     switch (d->method) {
     case Sha1:
-        sha1Update(&d->sha1Context, (const unsigned char *)data, length);
+        sha1AddData(&d->sha1Context, (const unsigned char *)data, length);
         break;
 #ifdef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
     default:
@@ -286,16 +744,16 @@ void QCryptographicHash::addData(const char *data, int length)
         MD5Update(&d->md5Context, (const unsigned char *)data, length);
         break;
     case Sha224:
-        SHA224Input(&d->sha224Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha224_256AddData(&d->sha224Context, reinterpret_cast<const unsigned char *>(data), length);
         break;
     case Sha256:
-        SHA256Input(&d->sha256Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha224_256AddData(&d->sha256Context, reinterpret_cast<const unsigned char *>(data), length);
         break;
     case Sha384:
-        SHA384Input(&d->sha384Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha384_512AddData(&d->sha384Context, reinterpret_cast<const unsigned char *>(data), length);
         break;
     case Sha512:
-        SHA512Input(&d->sha512Context, reinterpret_cast<const unsigned char *>(data), length);
+        sha384_512AddData(&d->sha512Context, reinterpret_cast<const unsigned char *>(data), length);
         break;
     case Sha3_224:
         sha3Update(&d->sha3Context, reinterpret_cast<const BitSequence *>(data), length*8);
@@ -325,6 +783,12 @@ void QCryptographicHash::addData(const QByteArray &data)
 /*!
   Reads the data from the open QIODevice \a device until it ends
   and hashes it. Returns \c true if reading was successful.
+
+  Since Qt 5.8, devices are read in large chunks, and large resource
+  files (see \l{The Qt Resource System}) that are opened in binary mode
+  are hashed in place. Other files are always read: a file that another
+  process truncates while it is mapped into memory would crash the
+  application.
   \since 5.0
  */
 bool QCryptographicHash::addData(QIODevice* device)
@@ -335,11 +799,38 @@ bool QCryptographicHash::addData(QIODevice* device)
     if (!device->isOpen())
         return false;
 
-    char buffer[1024];
-    int length;
+#ifndef QT_BOOTSTRAPPED
+    // hash the file contents in place, without copying them. Only resources
+    // can't change underneath: accessing the mapped pages of a file that is
+    // truncated meanwhile raises SIGBUS.
+    QFileDevice *file = qobject_cast<QFileDevice *>(device);
+    if (file && !file->isSequential() && !(file->openMode() & QIODevice::Text)
+        && file->fileName().startsWith(QLatin1Char(':'))) {
+        enum { MinimumMapSize = 64 * 1024, MapChunkSize = 64 * 1024 * 1024 };
+        const qint64 size = file->size();
+        qint64 pos = file->pos();
+        if (size - pos >= MinimumMapSize) {
+            while (pos < size) {
+                const qint64 chunk = qMin(size - pos, qint64(MapChunkSize));
+                uchar *data = file->map(pos, chunk);
+                if (!data)
+                    break;
+                addData(reinterpret_cast<const char *>(data), int(chunk));
+                file->unmap(data);
+                pos += chunk;
+            }
+            if (!file->seek(pos))
+                return false;
+        }
+    }
+#endif
+
+    enum { ReadChunkSize = 64 * 1024 };
+    QByteArray buffer(ReadChunkSize, Qt::Uninitialized);
+    qint64 length;
 
-    while ((length = device->read(buffer,sizeof(buffer))) > 0)
-        addData(buffer,length);
+    while ((length = device->read(buffer.data(), buffer.size())) > 0)
+        addData(buffer.constData(), int(length));
 
     return device->atEnd();
 }
@@ -444,4 +935,59 @@ QByteArray QCryptographicHash::hash(const QByteArray &data, Algorithm method)
     return hash.result();
 }
 
+/*!
+  \since 5.8
+  \overload
+
+  Returns the hash of the data read from the open QIODevice \a device
+  until it ends, using \a method. Returns an empty QByteArray if the
+  data could not be read.
+
+  \sa addData(QIODevice *)
+*/
+QByteArray QCryptographicHash::hash(QIODevice *device, Algorithm method)
+{
+    QCryptographicHash hash(method);
+    if (!hash.addData(device))
+        return QByteArray();
+    return hash.result();
+}
+
+/*!
+  \since 5.8
+  \overload
+
+  Returns the hashes of each of the byte arrays in \a data using \a
+  method, in the same order.
+
+  This is faster than hashing the byte arrays one by one, especially
+  when there are many small ones: on x86 processors that support AVX2,
+  eight SHA-224 or SHA-256 hashes are computed at the same time.
+*/
+QByteArrayList QCryptographicHash::hash(const QByteArrayList &data, Algorithm method)
+{
+    QByteArrayList result;
+    result.reserve(data.size());
+
+#if !defined(QT_CRYPTOGRAPHICHASH_ONLY_SHA1) && QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if ((method == Sha224 || method == Sha256) && data.size() > 1 && qCpuHasFeature(AVX2)) {
+        for (int i = 0; i < data.size(); ++i)
+            result.append(QByteArray());
+        if (method == Sha224)
+            sha224_256HashMany(data, result, SHA224_H0, SHA224HashSize);
+        else
+            sha224_256HashMany(data, result, SHA256_H0, SHA256HashSize);
+        return result;
+    }
+#endif
+
+    QCryptographicHash hash(method);
+    for (const QByteArray &message : data) {
+        hash.reset();
+        hash.addData(message);
+        result.append(hash.result());
+    }
+    return result;
+}
+
 QT_END_NAMESPACE
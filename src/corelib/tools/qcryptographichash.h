@@ -42,6 +42,7 @@
 #define QCRYPTOGRAPHICHASH_H
 
 #include <QtCore/qbytearray.h>
+#include <QtCore/qbytearraylist.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -82,6 +83,8 @@ public:
     QByteArray result() const;
 
     static QByteArray hash(const QByteArray &data, Algorithm method);
+    static QByteArray hash(QIODevice *device, Algorithm method);
+    static QByteArrayList hash(const QByteArrayList &data, Algorithm method);
 private:
     Q_DISABLE_COPY(QCryptographicHash)
     QCryptographicHashPrivate *d;
@@ -243,6 +243,231 @@ static ParsedRfcDateTime rfcDateImpl(const QString &s)
 
     return result;
 }
+
+/*
+    Allocation-free parsers for the canonical shapes of Qt::ISODate and
+    Qt::RFC2822Date. They work on both QChar and Latin-1 (or any ASCII
+    compatible, such as UTF-8) data and only report success for input they
+    fully understand; everything else is left to the general parsers above,
+    so the results of both paths are always identical.
+*/
+static inline uint qt_charAt(const QChar *s, int i) { return s[i].unicode(); }
+static inline uint qt_charAt(const char *s, int i) { return uchar(s[i]); }
+
+template <typename Char>
+static inline bool qt_readDigits(const Char *s, int pos, int count, int *value)
+{
+    int v = 0;
+    for (int i = 0; i < count; ++i) {
+        const uint digit = qt_charAt(s, pos + i) - '0';
+        if (digit > 9)
+            return false;
+        v = v * 10 + int(digit);
+    }
+    *value = v;
+    return true;
+}
+
+template <typename Char>
+static inline bool qt_isSign(const Char *s, int i)
+{
+    const uint c = qt_charAt(s, i);
+    return c == '+' || c == '-';
+}
+
+template <typename Char>
+static inline bool qt_isBlank(const Char *s, int i)
+{
+    const uint c = qt_charAt(s, i);
+    return c == ' ' || c == '\t';
+}
+
+// Parses "YYYY-MM-DD[(T| )HH:mm[:ss[(.|,)fff]][Z|[+-]HH[[:]mm]]]"
+template <typename Char>
+static bool fastIsoDateTime(const Char *s, int size, QDateTime *result)
+{
+    int year, month, day;
+    if (size < 10 || qt_charAt(s, 4) != '-' || qt_charAt(s, 7) != '-'
+        || !qt_readDigits(s, 0, 4, &year) || !qt_readDigits(s, 5, 2, &month)
+        || !qt_readDigits(s, 8, 2, &day) || year <= 0) {
+        return false;
+    }
+    QDate date(year, month, day);
+    if (!date.isValid())
+        return false;
+    if (size == 10) {
+        *result = QDateTime(date);
+        return true;
+    }
+
+    const uint separator = qt_charAt(s, 10);
+    if (separator != 'T' && separator != 't' && separator != ' ')
+        return false;
+
+    Qt::TimeSpec spec = Qt::LocalTime;
+    int offset = 0;
+    int end = size;
+    if (qt_charAt(s, end - 1) == 'Z') {
+        spec = Qt::UTC;
+        --end;
+    } else {
+        // [+-]HH, [+-]HHmm or [+-]HH:mm, following at least "HH:mm"
+        int signPos = end - 3;
+        if (signPos >= 16 && !qt_isSign(s, signPos)) {
+            signPos = end - 5;
+            if (signPos >= 16 && !qt_isSign(s, signPos))
+                signPos = end - 6;
+        }
+        if (signPos >= 16 && qt_isSign(s, signPos)) {
+            int offsetHour;
+            int offsetMinute = 0;
+            bool ok = qt_readDigits(s, signPos + 1, 2, &offsetHour);
+            if (end - signPos == 5)
+                ok = ok && qt_readDigits(s, signPos + 3, 2, &offsetMinute);
+            else if (end - signPos == 6)
+                ok = ok && qt_charAt(s, signPos + 3) == ':' && qt_readDigits(s, signPos + 4, 2, &offsetMinute);
+            if (!ok || offsetMinute > 59)
+                return false;
+            offset = ((offsetHour * 60) + offsetMinute) * 60;
+            if (qt_charAt(s, signPos) == '-')
+                offset = -offset;
+            spec = Qt::OffsetFromUTC;
+            end = signPos;
+        }
+    }
+
+    // The time, starting at 11: "HH:mm", "HH:mm:ss" or "HH:mm:ss.fff..."
+    const int timeSize = end - 11;
+    int hour, minute, second = 0, msec = 0;
+    if (timeSize < 5 || qt_charAt(s, 13) != ':'
+        || !qt_readDigits(s, 11, 2, &hour) || !qt_readDigits(s, 14, 2, &minute)) {
+        return false;
+    }
+    if (timeSize > 5) {
+        if (timeSize < 8 || qt_charAt(s, 16) != ':' || !qt_readDigits(s, 17, 2, &second))
+            return false;
+        if (timeSize > 8) {
+            const uint point = qt_charAt(s, 19);
+            const int digits = end - 20;
+            if ((point != '.' && point != ',') || digits < 1)
+                return false;
+            // Only the first four digits are significant, see fromIsoTimeString()
+            const int significant = qMin(digits, 4);
+            int msecInt;
+            int ignored;
+            if (!qt_readDigits(s, 20, significant, &msecInt)
+                || (digits > significant && !qt_readDigits(s, 24, digits - significant, &ignored))) {
+                return false;
+            }
+            const double secondFraction(msecInt / (std::pow(double(10), significant)));
+            msec = qMin(qRound(secondFraction * 1000.0), 999);
+        }
+    }
+
+    if (hour == 24 && minute == 0 && second == 0 && msec == 0) {
+        hour = 0;
+        date = date.addDays(1);
+    }
+    const QTime time(hour, minute, second, msec);
+    if (!time.isValid())
+        return false;
+
+    *result = QDateTime(date, time, spec, offset);
+    return true;
+}
+
+// Parses "[Wdy,] DD Mon YYYY HH:mm[:ss] [[+-]hhmm]"
+template <typename Char>
+static bool fastRfcDateTime(const Char *s, int size, QDateTime *result)
+{
+    int i = 0;
+    if (i < size && qt_charAt(s, i) - 'A' < 26) {
+        ++i;
+        while (i < size && qt_charAt(s, i) - 'a' < 26)
+            ++i;
+        if (i == 1 || i == size || qt_charAt(s, i) != ',')
+            return false;
+        ++i;
+    }
+    while (i < size && qt_isBlank(s, i))
+        ++i;
+
+    int day;
+    int digits = 0;
+    while (digits < 2 && i + digits < size && qt_charAt(s, i + digits) - '0' < 10)
+        ++digits;
+    if (!digits || !qt_readDigits(s, i, digits, &day))
+        return false;
+    i += digits;
+
+    // Month names are exactly three letters, surrounded by blanks
+    if (i + 5 > size || !qt_isBlank(s, i))
+        return false;
+    while (i < size && qt_isBlank(s, i))
+        ++i;
+    if (i + 4 > size || !qt_isBlank(s, i + 3))
+        return false;
+    int month = 0;
+    for (int m = 0; m < 12; ++m) {
+        const char *name = qt_shortMonthNames[m];
+        if (qt_charAt(s, i) == uchar(name[0]) && qt_charAt(s, i + 1) == uchar(name[1])
+            && qt_charAt(s, i + 2) == uchar(name[2])) {
+            month = m + 1;
+            break;
+        }
+    }
+    if (!month)
+        return false;
+    i += 3;
+    while (i < size && qt_isBlank(s, i))
+        ++i;
+
+    int year;
+    if (i + 5 > size || !qt_readDigits(s, i, 4, &year) || !qt_isBlank(s, i + 4))
+        return false;
+    i += 4;
+    while (i < size && qt_isBlank(s, i))
+        ++i;
+
+    int hour, minute, second = 0;
+    if (i + 5 > size || qt_charAt(s, i + 2) != ':'
+        || !qt_readDigits(s, i, 2, &hour) || !qt_readDigits(s, i + 3, 2, &minute)) {
+        return false;
+    }
+    i += 5;
+    if (i < size && qt_charAt(s, i) == ':') {
+        if (i + 3 > size || !qt_readDigits(s, i + 1, 2, &second))
+            return false;
+        i += 3;
+    }
+
+    int offset = 0;
+    if (i < size) {
+        if (qt_charAt(s, i) != '+' && qt_charAt(s, i) != '-' && !qt_isBlank(s, i))
+            return false;
+        while (i < size && qt_isBlank(s, i))
+            ++i;
+        if (i < size) {
+            const uint sign = qt_charAt(s, i);
+            int hourOffset, minOffset;
+            if ((sign != '+' && sign != '-') || i + 5 != size
+                || !qt_readDigits(s, i + 1, 2, &hourOffset) || !qt_readDigits(s, i + 3, 2, &minOffset)) {
+                return false;
+            }
+            offset = (hourOffset * 60 + minOffset) * (sign == '+' ? 60 : -60);
+        }
+    }
+
+    const QDate date(year, month, day);
+    const QTime time(hour, minute, second);
+    if (!date.isValid() || !time.isValid())
+        return false;
+
+    QDateTime dateTime(date, time, Qt::UTC);
+    dateTime.setOffsetFromUtc(offset);
+    *result = dateTime;
+    return true;
+}
 #endif // QT_NO_DATESTRING
 
 // Return offset in [+-]HH:mm format
@@ -4394,16 +4619,24 @@ QDateTime QDateTime::fromString(const QString& string, Qt::DateFormat format)
     case Qt::DefaultLocaleLongDate:
         return QLocale().toDateTime(string, QLocale::LongFormat);
     case Qt::RFC2822Date: {
+        QDateTime dateTime;
+        if (fastRfcDateTime(string.constData(), string.size(), &dateTime))
+            return dateTime;
+
         const ParsedRfcDateTime rfc = rfcDateImpl(string);
 
         if (!rfc.date.isValid() || !rfc.time.isValid())
             return QDateTime();
 
-        QDateTime dateTime(rfc.date, rfc.time, Qt::UTC);
+        dateTime = QDateTime(rfc.date, rfc.time, Qt::UTC);
         dateTime.setOffsetFromUtc(rfc.utcOffset);
         return dateTime;
     }
     case Qt::ISODate: {
+        QDateTime dateTime;
+        if (fastIsoDateTime(string.constData(), string.size(), &dateTime))
+            return dateTime;
+
         const int size = string.size();
         if (size < 10)
             return QDateTime();
@@ -4697,6 +4930,338 @@ QDateTime QDateTime::fromString(const QString &string, const QString &format)
     return QDateTime(QDate(), QTime(-1, -1, -1));
 }
 
+/*!
+    \overload
+    \since 5.8
+
+    Returns the QDateTime represented by the Latin-1 \a string, using the
+    \a format given, or an invalid datetime if this is not possible.
+
+    Qt::ISODate (which also covers the RFC 3339 profile of ISO 8601) and
+    Qt::RFC2822Date strings are parsed directly from the Latin-1 data
+    without converting them to a QString first, which makes this overload
+    suitable for ingesting large amounts of timestamps from files or the
+    network. Since those formats are plain ASCII, UTF-8 encoded data can be
+    passed as well. The result is always the same as that of the QString
+    overload.
+*/
+QDateTime QDateTime::fromString(QLatin1String string, Qt::DateFormat format)
+{
+    QDateTime dateTime;
+    switch (format) {
+    case Qt::ISODate:
+        if (fastIsoDateTime(string.data(), string.size(), &dateTime))
+            return dateTime;
+        break;
+    case Qt::RFC2822Date:
+        if (fastRfcDateTime(string.data(), string.size(), &dateTime))
+            return dateTime;
+        break;
+    default:
+        break;
+    }
+    return fromString(QString(string), format);
+}
+
+#ifndef QT_BOOTSTRAPPED
+/*!
+    \class QDateTimeFormat
+    \inmodule QtCore
+    \since 5.8
+    \reentrant
+    \brief The QDateTimeFormat class parses date and time strings that follow
+    a fixed format.
+
+    \ingroup shared
+
+    QDateTimeFormat analyzes a format string, using the same expressions as
+    QDateTime::fromString(), once and can then parse any number of strings
+    following it. This is considerably faster than calling
+    QDateTime::fromString() for each string when the format is fixed, as is
+    common when reading logs or CSV data:
+
+    \code
+    const QDateTimeFormat format(QStringLiteral("dd.MM.yyyy hh:mm:ss.zzz"));
+    for (const QByteArray &line : lines)
+        timestamps << format.parse(QLatin1String(line.left(23)));
+    \endcode
+
+    Formats consisting of the numeric expressions (\c d, \c dd, \c M, \c MM,
+    \c yy, \c yyyy, \c h, \c hh, \c H, \c HH, \c m, \c mm, \c s, \c ss, \c z
+    and \c zzz) and literal text are compiled; isCompiled() tells whether
+    that is the case. Strings that the compiled form does not match, and all
+    strings for other formats, are handed to QDateTime::fromString(), so
+    parse() always returns the same result as that function.
+
+    \sa QDateTime::fromString()
+*/
+
+class QDateTimeFormatPrivate : public QSharedData
+{
+public:
+    struct Field {
+        QDateTimeParser::Section type;
+        int separatorPos;
+        int separatorSize;
+        int minDigits;
+        int maxDigits;
+        int minValue;
+        int maxValue;
+    };
+
+    explicit QDateTimeFormatPrivate(const QString &f);
+
+    template <typename Char>
+    bool parse(const Char *s, int size, QDateTime *result) const;
+
+    template <typename Char>
+    inline bool matchSeparator(const Char *s, int size, int pos, int separatorPos, int separatorSize) const
+    {
+        if (pos + separatorSize > size)
+            return false;
+        const QChar *separator = separators.constData() + separatorPos;
+        for (int i = 0; i < separatorSize; ++i) {
+            if (qt_charAt(s, pos + i) != separator[i].unicode())
+                return false;
+        }
+        return true;
+    }
+
+    QString format;
+    QString separators;
+    QVector<Field> fields;
+    int lastSeparatorPos;
+    int lastSeparatorSize;
+    bool compiled;
+};
+Q_DECLARE_TYPEINFO(QDateTimeFormatPrivate::Field, Q_PRIMITIVE_TYPE);
+
+QDateTimeFormatPrivate::QDateTimeFormatPrivate(const QString &f)
+    : format(f), lastSeparatorPos(0), lastSeparatorSize(0), compiled(false)
+{
+    QDateTimeParser parser(QVariant::DateTime, QDateTimeParser::FromString);
+    if (!parser.parseFormat(format) || parser.sectionNodes.isEmpty())
+        return;
+
+    // Reuse the sections and (unquoted) separators QDateTimeParser found, so
+    // that both agree on what the format means.
+    QDateTimeParser::Sections seen = QDateTimeParser::NoSection;
+    const int count = parser.sectionNodes.size();
+    fields.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const QDateTimeParser::SectionNode &node = parser.sectionNodes.at(i);
+        const QDateTimeParser::Sections type = (node.type & QDateTimeParser::YearSection2Digits)
+                ? QDateTimeParser::YearSection : node.type;
+        if (seen & type)
+            return; // conflicting sections are resolved by QDateTimeParser
+        seen |= type;
+
+        Field field;
+        field.type = node.type;
+        field.separatorPos = separators.size();
+        field.separatorSize = parser.separators.at(i).size();
+        separators += parser.separators.at(i);
+        field.maxDigits = parser.sectionMaxSize(i);
+        field.minDigits = (parser.fieldInfo(i) & QDateTimeParser::FixedWidth) ? field.maxDigits : 1;
+        field.minValue = parser.absoluteMin(i);
+        field.maxValue = parser.absoluteMax(i);
+        switch (node.type) {
+        case QDateTimeParser::DaySection:
+        case QDateTimeParser::MonthSection:
+            if (node.count > 2)
+                return; // names
+            break;
+        case QDateTimeParser::YearSection:
+            if (node.count != 4)
+                return;
+            break;
+        case QDateTimeParser::MSecSection:
+            // "z" scales partial input (so "5" means 500), only accept all three digits
+            field.minDigits = field.maxDigits;
+            break;
+        case QDateTimeParser::YearSection2Digits:
+        case QDateTimeParser::Hour24Section:
+        case QDateTimeParser::MinuteSection:
+        case QDateTimeParser::SecondSection:
+            break;
+        default:
+            return; // AM/PM and day of week names are locale dependent
+        }
+        fields.append(field);
+    }
+    lastSeparatorPos = separators.size();
+    lastSeparatorSize = parser.separators.last().size();
+    separators += parser.separators.last();
+    compiled = true;
+}
+
+template <typename Char>
+bool QDateTimeFormatPrivate::parse(const Char *s, int size, QDateTime *result) const
+{
+    int year = 1900;
+    int month = 1;
+    int day = 1;
+    int hour = 0;
+    int minute = 0;
+    int second = 0;
+    int msec = 0;
+
+    int pos = 0;
+    for (const Field &field : fields) {
+        if (!matchSeparator(s, size, pos, field.separatorPos, field.separatorSize))
+            return false;
+        pos += field.separatorSize;
+
+        // Numbers are greedy, but drop trailing digits that would be out of range
+        int digits = 0;
+        int value = 0;
+        while (digits < field.maxDigits && pos + digits < size) {
+            const uint digit = qt_charAt(s, pos + digits) - '0';
+            if (digit > 9)
+                break;
+            value = value * 10 + int(digit);
+            ++digits;
+        }
+        while (value > field.maxValue && digits > field.minDigits) {
+            value /= 10;
+            --digits;
+        }
+        if (digits < field.minDigits || value < field.minValue || value > field.maxValue)
+            return false;
+        pos += digits;
+
+        switch (field.type) {
+        case QDateTimeParser::YearSection: year = value; break;
+        case QDateTimeParser::YearSection2Digits: year = 1900 + value; break;
+        case QDateTimeParser::MonthSection: month = value; break;
+        case QDateTimeParser::DaySection: day = value; break;
+        case QDateTimeParser::Hour24Section: hour = value; break;
+        case QDateTimeParser::MinuteSection: minute = value; break;
+        case QDateTimeParser::SecondSection: second = value; break;
+        case QDateTimeParser::MSecSection: msec = value; break;
+        default: Q_UNREACHABLE();
+        }
+    }
+    if (pos + lastSeparatorSize != size
+        || !matchSeparator(s, size, pos, lastSeparatorPos, lastSeparatorSize)) {
+        return false;
+    }
+
+    // QDateTimeParser only accepts dates in the range of QDateTimeEdit
+    if (year < QDATETIMEEDIT_DATE_MIN.year() || year > QDATETIMEEDIT_DATE_MAX.year())
+        return false;
+    const QDate date(year, month, day);
+    if (!date.isValid())
+        return false;
+
+    *result = QDateTime(date, QTime(hour, minute, second, msec));
+    return true;
+}
+
+/*!
+    Constructs an empty format. Parsing with it always yields an invalid
+    QDateTime.
+*/
+QDateTimeFormat::QDateTimeFormat()
+{
+}
+
+/*!
+    Constructs a parser for strings following \a format, which uses the
+    expressions described in QDateTime::fromString().
+*/
+QDateTimeFormat::QDateTimeFormat(const QString &format)
+    : d(new QDateTimeFormatPrivate(format))
+{
+}
+
+/*!
+    Constructs a copy of \a other.
+*/
+QDateTimeFormat::QDateTimeFormat(const QDateTimeFormat &other)
+    : d(other.d)
+{
+}
+
+/*!
+    \fn QDateTimeFormat &QDateTimeFormat::operator=(QDateTimeFormat &&other)
+
+    Move-assigns \a other to this QDateTimeFormat instance.
+*/
+
+/*!
+    Assigns \a other to this format and returns a reference to it.
+*/
+QDateTimeFormat &QDateTimeFormat::operator=(const QDateTimeFormat &other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    Destroys the format.
+*/
+QDateTimeFormat::~QDateTimeFormat()
+{
+}
+
+/*!
+    \fn void QDateTimeFormat::swap(QDateTimeFormat &other)
+
+    Swaps this format with \a other. This operation is very fast and never
+    fails.
+*/
+
+/*!
+    Returns the format string this object was constructed with.
+*/
+QString QDateTimeFormat::format() const
+{
+    return d ? d->format : QString();
+}
+
+/*!
+    Returns \c true if the format could be compiled, that is, if parse()
+    can handle matching strings without falling back to
+    QDateTime::fromString().
+*/
+bool QDateTimeFormat::isCompiled() const
+{
+    return d && d->compiled;
+}
+
+/*!
+    Returns the QDateTime represented by \a string, or an invalid datetime if
+    \a string does not follow the format. The result is the same as that of
+    QDateTime::fromString(\a string, format()).
+*/
+QDateTime QDateTimeFormat::parse(const QString &string) const
+{
+    if (!d)
+        return QDateTime();
+    QDateTime dateTime;
+    if (d->compiled && d->parse(string.constData(), string.size(), &dateTime))
+        return dateTime;
+    return QDateTime::fromString(string, d->format);
+}
+
+/*!
+    \overload
+
+    Parses the Latin-1 \a string without converting it to a QString first,
+    unless it cannot be handled by the compiled format.
+*/
+QDateTime QDateTimeFormat::parse(QLatin1String string) const
+{
+    if (!d)
+        return QDateTime();
+    QDateTime dateTime;
+    if (d->compiled && d->parse(string.data(), string.size(), &dateTime))
+        return dateTime;
+    return QDateTime::fromString(QString(string), d->format);
+}
+#endif // QT_BOOTSTRAPPED
+
 #endif // QT_NO_DATESTRING
 /*!
     \fn QDateTime QDateTime::toLocalTime() const
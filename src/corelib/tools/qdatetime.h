@@ -305,6 +305,7 @@ public:
 #ifndef QT_NO_DATESTRING
     static QDateTime fromString(const QString &s, Qt::DateFormat f = Qt::TextDate);
     static QDateTime fromString(const QString &s, const QString &format);
+    static QDateTime fromString(QLatin1String s, Qt::DateFormat f = Qt::TextDate);
 #endif
     // ### Qt 6: use quint64 instead of uint
     static QDateTime fromTime_t(uint secsSince1Jan1970UTC);
@@ -350,6 +351,35 @@ private:
 };
 Q_DECLARE_SHARED(QDateTime)
 
+#if !defined(QT_NO_DATESTRING) && !defined(QT_BOOTSTRAPPED)
+class QDateTimeFormatPrivate;
+
+class Q_CORE_EXPORT QDateTimeFormat
+{
+public:
+    QDateTimeFormat();
+    explicit QDateTimeFormat(const QString &format);
+    QDateTimeFormat(const QDateTimeFormat &other);
+#ifdef Q_COMPILER_RVALUE_REFS
+    QDateTimeFormat &operator=(QDateTimeFormat &&other) Q_DECL_NOTHROW { swap(other); return *this; }
+#endif
+    QDateTimeFormat &operator=(const QDateTimeFormat &other);
+    ~QDateTimeFormat();
+
+    void swap(QDateTimeFormat &other) Q_DECL_NOTHROW { qSwap(d, other.d); }
+
+    QString format() const;
+    bool isCompiled() const;
+
+    QDateTime parse(const QString &string) const;
+    QDateTime parse(QLatin1String string) const;
+
+private:
+    QExplicitlySharedDataPointer<QDateTimeFormatPrivate> d;
+};
+Q_DECLARE_SHARED(QDateTimeFormat)
+#endif
+
 #ifndef QT_NO_DATASTREAM
 Q_CORE_EXPORT QDataStream &operator<<(QDataStream &, const QDate &);
 Q_CORE_EXPORT QDataStream &operator>>(QDataStream &, QDate &);
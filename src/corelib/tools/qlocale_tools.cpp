@@ -44,6 +44,7 @@
 #include "qstring.h"
 
 #include <private/qnumeric_p.h>
+#include "qendian.h"
 
 #include <ctype.h>
 #include <errno.h>
@@ -51,6 +52,7 @@
 #include <limits.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #if defined(Q_OS_LINUX) && !defined(__UCLIBC__)
@@ -277,10 +279,150 @@ void doubleToAscii(double d, QLocaleData::DoubleForm form, int precision, char *
         --length;
 }
 
+static inline bool asciiEquals(const char *num, int numLen, const char *str, int strLen)
+{
+    return numLen == strLen && memcmp(num, str, strLen) == 0;
+}
+
+static inline bool isAsciiDigit(char c)
+{
+    return uint(c - '0') < 10;
+}
+
+// True if all eight bytes of the little endian \a chunk are decimal digits
+static inline bool isEightDigits(quint64 chunk)
+{
+    return ((chunk & Q_UINT64_C(0xF0F0F0F0F0F0F0F0))
+            | (((chunk + Q_UINT64_C(0x0606060606060606)) & Q_UINT64_C(0xF0F0F0F0F0F0F0F0)) >> 4))
+            == Q_UINT64_C(0x3333333333333333);
+}
+
+// Converts eight little endian ASCII digits at once, two, four and then eight at a time
+static inline quint32 eightDigitsValue(quint64 chunk)
+{
+    chunk -= Q_UINT64_C(0x3030303030303030);
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & Q_UINT64_C(0x000000FF000000FF)) * (100 + (Q_UINT64_C(1000000) << 32)))
+             + (((chunk >> 16) & Q_UINT64_C(0x000000FF000000FF)) * (1 + (Q_UINT64_C(10000) << 32)))) >> 32;
+    return quint32(chunk);
+}
+
+/*
+    Reads up to 19 decimal digits starting at \a num into \a value, which
+    therefore cannot overflow. Returns the number of digits read; if that is
+    19 and more digits follow, the caller has to take the slow path.
+*/
+static int readDecimalDigits(const char *num, int numLen, quint64 *value)
+{
+    const int maxDigits = qMin(numLen, 19);
+    quint64 v = 0;
+    int i = 0;
+    while (i + 8 <= maxDigits) {
+        const quint64 chunk = qFromLittleEndian<quint64>(reinterpret_cast<const uchar *>(num + i));
+        if (!isEightDigits(chunk))
+            break;
+        v = v * 100000000 + eightDigitsValue(chunk);
+        i += 8;
+    }
+    while (i < maxDigits && isAsciiDigit(num[i])) {
+        v = v * 10 + uint(num[i] - '0');
+        ++i;
+    }
+    *value = v;
+    return i;
+}
+
+static inline bool isNumberChar(char c)
+{
+    return isAsciiDigit(c) || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-';
+}
+
+/*
+    Handles the common case of a number with few significant digits and a
+    small exponent without libdouble-conversion: if the mantissa is exactly
+    representable and so is the power of ten, a single multiplication or
+    division yields the correctly rounded result (Clinger's fast path).
+    Returns \c false if the input has to be parsed the slow way.
+*/
+static bool fastAsciiToDouble(const char *num, int numLen, TrailingJunkMode trailingJunkMode,
+                              double *result, int *processed)
+{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    static const double powersOf10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    int i = 0;
+    const bool negative = num[0] == '-';
+    if (negative || num[0] == '+')
+        ++i;
+
+    quint64 mantissa;
+    const int intDigits = readDecimalDigits(num + i, numLen - i, &mantissa);
+    if (intDigits == 0)
+        return false;
+    i += intDigits;
+    int digits = intDigits;
+    int exponent = 0;
+    if (i < numLen && num[i] == '.') {
+        ++i;
+        quint64 fraction;
+        const int fractionDigits = readDecimalDigits(num + i, numLen - i, &fraction);
+        if (fractionDigits == 0 || digits + fractionDigits > 19)
+            return false;
+        mantissa = mantissa * quint64(powersOf10[fractionDigits]) + fraction;
+        digits += fractionDigits;
+        exponent = -fractionDigits;
+        i += fractionDigits;
+    }
+    if (digits >= 19 || mantissa > (Q_UINT64_C(1) << 53))
+        return false;
+
+    if (i < numLen && (num[i] == 'e' || num[i] == 'E')) {
+        // the underflow check below takes any digit after an 'E' for a
+        // non-zero digit of the mantissa
+        if (mantissa == 0 && num[i] == 'E')
+            return false;
+        ++i;
+        const bool negativeExponent = i < numLen && num[i] == '-';
+        if (i < numLen && (num[i] == '-' || num[i] == '+'))
+            ++i;
+        quint64 e;
+        const int exponentDigits = readDecimalDigits(num + i, numLen - i, &e);
+        if (exponentDigits == 0 || exponentDigits > 3)
+            return false;
+        exponent += negativeExponent ? -int(e) : int(e);
+        i += exponentDigits;
+    }
+
+    if (i < numLen && (trailingJunkMode == TrailingJunkProhibited || isNumberChar(num[i])))
+        return false;
+    if (exponent < -22 || exponent > 22)
+        return false;
+
+    double d = double(mantissa);
+    if (exponent < 0)
+        d /= powersOf10[-exponent];
+    else
+        d *= powersOf10[exponent];
+    *result = negative ? -d : d;
+    *processed = i;
+    return true;
+#else
+    Q_UNUSED(num);
+    Q_UNUSED(numLen);
+    Q_UNUSED(trailingJunkMode);
+    Q_UNUSED(result);
+    Q_UNUSED(processed);
+    return false;
+#endif
+}
+
 double asciiToDouble(const char *num, int numLen, bool &ok, int &processed,
                      TrailingJunkMode trailingJunkMode)
 {
-    if (*num == '\0') {
+    if (numLen <= 0 || *num == '\0') {
         ok = false;
         processed = 0;
         return 0.0;
@@ -291,10 +433,10 @@ double asciiToDouble(const char *num, int numLen, bool &ok, int &processed,
     // We have to catch NaN before because we need NaN as marker for "garbage" in the
     // libdouble-conversion case and, in contrast to libdouble-conversion or sscanf, we don't allow
     // "-nan" or "+nan"
-    if (qstrcmp(num, "nan") == 0) {
+    if (asciiEquals(num, numLen, "nan", 3)) {
         processed = 3;
         return qt_snan();
-    } else if ((num[0] == '-' || num[0] == '+') && qstrcmp(num + 1, "nan") == 0) {
+    } else if ((num[0] == '-' || num[0] == '+') && asciiEquals(num + 1, numLen - 1, "nan", 3)) {
         processed = 0;
         ok = false;
         return 0.0;
@@ -302,18 +444,20 @@ double asciiToDouble(const char *num, int numLen, bool &ok, int &processed,
 
     // Infinity values are implementation defined in the sscanf case. In the libdouble-conversion
     // case we need infinity as overflow marker.
-    if (qstrcmp(num, "+inf") == 0) {
+    if (asciiEquals(num, numLen, "+inf", 4)) {
         processed = 4;
         return qt_inf();
-    } else if (qstrcmp(num, "inf") == 0) {
+    } else if (asciiEquals(num, numLen, "inf", 3)) {
         processed = 3;
         return qt_inf();
-    } else if (qstrcmp(num, "-inf") == 0) {
+    } else if (asciiEquals(num, numLen, "-inf", 4)) {
         processed = 4;
         return -qt_inf();
     }
 
     double d = 0.0;
+    if (fastAsciiToDouble(num, numLen, trailingJunkMode, &d, &processed))
+        return d;
 #if !defined(QT_NO_DOUBLECONVERSION) && !defined(QT_BOOTSTRAPPED)
     int conv_flags = (trailingJunkMode == TrailingJunkAllowed) ?
                 double_conversion::StringToDoubleConverter::ALLOW_TRAILING_JUNK :
@@ -333,6 +477,7 @@ double asciiToDouble(const char *num, int numLen, bool &ok, int &processed,
         }
     }
 #else
+    // sscanf needs a '\0' terminated string, callers make sure there is one
     if (qDoubleSscanf(num, QT_CLOCALE, "%lf%n", &d, &processed) < 1)
         processed = 0;
 
@@ -378,6 +523,182 @@ double asciiToDouble(const char *num, int numLen, bool &ok, int &processed,
     return d;
 }
 
+/*
+    Parses an optionally signed decimal integer of up to 19 digits from the
+    byte range \a num, \a numLen without looking beyond it. Unlike qstrtoll()
+    no whitespace is skipped. \a processed is set to the number of bytes
+    consumed; if \a ok is false, either no digits were found, the value does
+    not fit, or (with TrailingJunkProhibited) bytes remain after the number.
+*/
+qlonglong asciiToLongLong(const char *num, int numLen, bool &ok, int &processed,
+                          TrailingJunkMode trailingJunkMode)
+{
+    ok = false;
+    processed = 0;
+    if (numLen <= 0)
+        return 0;
+
+    int i = 0;
+    const bool negative = num[0] == '-';
+    if (negative || num[0] == '+')
+        ++i;
+    quint64 value;
+    const int digits = readDecimalDigits(num + i, numLen - i, &value);
+    i += digits;
+    if (digits == 0 || (i < numLen && isAsciiDigit(num[i]))
+        || (trailingJunkMode == TrailingJunkProhibited && i < numLen)) {
+        return 0;
+    }
+    if (value > quint64(std::numeric_limits<qlonglong>::max()) + (negative ? 1 : 0))
+        return 0;
+
+    ok = true;
+    processed = i;
+    return negative ? qlonglong(0 - value) : qlonglong(value);
+}
+
+/*
+    Like asciiToLongLong(), but for unsigned values; a leading '-' is
+    rejected. Values of 10^19 and above are reported as not fitting.
+*/
+qulonglong asciiToULongLong(const char *num, int numLen, bool &ok, int &processed,
+                            TrailingJunkMode trailingJunkMode)
+{
+    ok = false;
+    processed = 0;
+    if (numLen <= 0 || num[0] == '-')
+        return 0;
+
+    const int i = num[0] == '+' ? 1 : 0;
+    quint64 value;
+    const int digits = readDecimalDigits(num + i, numLen - i, &value);
+    const int end = i + digits;
+    if (digits == 0 || (end < numLen && isAsciiDigit(num[end]))
+        || (trailingJunkMode == TrailingJunkProhibited && end < numLen)) {
+        return 0;
+    }
+
+    ok = true;
+    processed = end;
+    return value;
+}
+
+/*
+    Formats \a d into \a buf like QLocaleData::c()->doubleToString(d, precision,
+    form, -1, flags) would, without any intermediate QString. Only the
+    ZeroPadExponent and CapitalEorX flags are supported. Returns the number of
+    characters written (no '\0' is appended), or -1 if the flags are not
+    supported or \a bufSize is too small, in which case the caller has to use
+    QLocaleData::doubleToString().
+*/
+int doubleToAsciiString(double d, QLocaleData::DoubleForm form, int precision, unsigned flags,
+                        char *buf, int bufSize)
+{
+    if (flags & ~(QLocaleData::ZeroPadExponent | QLocaleData::CapitalEorX))
+        return -1;
+    if (precision != QLocale::FloatingPointShortest && precision < 0)
+        precision = 6;
+
+    // Same digit buffer size as QLocaleData::doubleToString() uses
+    int digitsSize = 1;
+    if (precision == QLocale::FloatingPointShortest) {
+        digitsSize += QLocaleData::DoubleMaxSignificant;
+    } else if (form == QLocaleData::DFDecimal) {
+        if (d > (1 << 19) || d < -(1 << 19))
+            return -1;
+        digitsSize += 6 + precision;
+    } else {
+        digitsSize += qMax(2, precision) + 1;
+    }
+    char digits[64];
+    if (digitsSize > int(sizeof(digits)))
+        return -1;
+
+    bool negative = false;
+    int length = 0;
+    int decpt = 0;
+    doubleToAscii(d, form, precision, digits, digitsSize, negative, length, decpt);
+
+    const char exponential = (flags & QLocaleData::CapitalEorX) ? 'E' : 'e';
+    char *out = buf;
+    char *const end = buf + bufSize;
+#define CHECK_SPACE(n) do { if (end - out < (n)) return -1; } while (false)
+
+    if (qstrncmp(digits, "inf", 3) == 0 || qstrncmp(digits, "nan", 3) == 0) {
+        CHECK_SPACE(length + 1);
+        if (negative)
+            *out++ = '-';
+        for (int i = 0; i < length; ++i)
+            *out++ = (flags & QLocaleData::CapitalEorX) ? digits[i] - 'a' + 'A' : digits[i];
+        return int(out - buf);
+    }
+
+    if (isZero(d))
+        negative = false;
+    if (negative) {
+        CHECK_SPACE(1);
+        *out++ = '-';
+    }
+
+    bool useExponent = form == QLocaleData::DFExponent;
+    PrecisionMode mode = PMDecimalDigits;
+    if (form == QLocaleData::DFSignificantDigits) {
+        mode = PMChopTrailingZeros;
+        int cutoff = precision < 0 ? 6 : precision;
+        // Find out which representation is shorter, as in QLocaleData::doubleToString()
+        if (precision == QLocale::FloatingPointShortest && decpt > 0) {
+            cutoff = length + 4;
+            if (decpt <= 10)
+                ++cutoff;
+            else
+                cutoff += decpt > 100 ? 2 : 1;
+            if (length > decpt)
+                ++cutoff;
+        }
+        useExponent = decpt != length && (decpt <= -4 || decpt > cutoff);
+    }
+
+    if (useExponent) {
+        // d.ddd e[+-]xx, see exponentForm()
+        int count = length;
+        if (mode == PMDecimalDigits && count < precision + 1)
+            count = precision + 1;
+        CHECK_SPACE(count + 1 + 5);
+        *out++ = digits[0];
+        if (count > 1)
+            *out++ = '.';
+        for (int i = 1; i < count; ++i)
+            *out++ = i < length ? digits[i] : '0';
+        *out++ = exponential;
+        int exp = decpt - 1;
+        *out++ = exp < 0 ? '-' : '+';
+        exp = qAbs(exp);
+        if (exp >= 100)
+            *out++ = char('0' + exp / 100);
+        if (exp >= 10 || (flags & QLocaleData::ZeroPadExponent))
+            *out++ = char('0' + (exp / 10) % 10);
+        *out++ = char('0' + exp % 10);
+    } else {
+        // see decimalForm(): leading zeros, the digits, zeros up to the point and decimals
+        const int leadingZeros = decpt < 0 ? -decpt : 0;
+        const int point = qMax(decpt, 0);
+        int count = leadingZeros + qMax(length, point);
+        if (mode == PMDecimalDigits && count - point < precision)
+            count = point + precision;
+        CHECK_SPACE(count + 2);
+        if (point == 0)
+            *out++ = '0';
+        for (int i = 0; i < count; ++i) {
+            if (i == point)
+                *out++ = '.';
+            const int digit = i - leadingZeros;
+            *out++ = (digit >= 0 && digit < length) ? digits[digit] : '0';
+        }
+    }
+#undef CHECK_SPACE
+    return int(out - buf);
+}
+
 unsigned long long
 qstrtoull(const char * nptr, const char **endptr, int base, bool *ok)
 {
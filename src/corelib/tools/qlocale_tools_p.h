@@ -77,10 +77,16 @@ enum TrailingJunkMode {
     TrailingJunkAllowed
 };
 
-double asciiToDouble(const char *num, int numLen, bool &ok, int &processed,
-                     TrailingJunkMode trailingJunkMode = TrailingJunkProhibited);
+Q_CORE_EXPORT double asciiToDouble(const char *num, int numLen, bool &ok, int &processed,
+                                   TrailingJunkMode trailingJunkMode = TrailingJunkProhibited);
+Q_CORE_EXPORT qlonglong asciiToLongLong(const char *num, int numLen, bool &ok, int &processed,
+                                        TrailingJunkMode trailingJunkMode = TrailingJunkProhibited);
+Q_CORE_EXPORT qulonglong asciiToULongLong(const char *num, int numLen, bool &ok, int &processed,
+                                          TrailingJunkMode trailingJunkMode = TrailingJunkProhibited);
 void doubleToAscii(double d, QLocaleData::DoubleForm form, int precision, char *buf, int bufSize,
                    bool &sign, int &length, int &decpt);
+Q_CORE_EXPORT int doubleToAsciiString(double d, QLocaleData::DoubleForm form, int precision,
+                                      unsigned flags, char *buf, int bufSize);
 
 QString qulltoa(qulonglong l, int base, const QChar _zero);
 QString qlltoa(qlonglong l, int base, const QChar zero);
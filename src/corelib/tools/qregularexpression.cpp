@@ -53,6 +53,8 @@
 #include <QtCore/qglobal.h>
 #include <QtCore/qatomic.h>
 #include <QtCore/qdatastream.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qvarlengtharray.h>
 
 #include <pcre.h>
 
@@ -403,6 +405,31 @@ QT_BEGIN_NAMESPACE
     text) would have been \c{"abcabc"}; by matching only against the leading
     \c{"abc"} we instead get a partial match.
 
+    \section1 Matching Many Subjects
+
+    QRegularExpression objects constructed with the same pattern string and
+    the same pattern options share the compiled pattern, which is kept in a
+    process-wide cache; constructing the same regular expression over and
+    over again is therefore cheap.
+
+    When only checking whether a subject matches, use matches(), which does
+    not allocate any memory. The match() overload taking a pointer to a
+    QRegularExpressionMatch object reuses the memory held by that object, so
+    that it can be used for many subjects in a row. To match subjects against
+    many regular expressions, use QRegularExpressionSet.
+
+    \target matching encoded data
+    \section2 Matching Encoded Data
+
+    Data that is available as UTF-8 or Latin-1 encoded text, for instance
+    because it was read from a file or from a socket, can be matched without
+    converting it to a QString first, by using matchUtf8(), matchLatin1() or
+    their global and matches() counterparts. In that case all the offsets
+    are in bytes, and the captured data can be retrieved as bytes by using
+    QRegularExpressionMatch::capturedBytes():
+
+    \snippet code/src_corelib_tools_qregularexpression.cpp 32
+
     \section1 Error Handling
 
     It is possible for a QRegularExpression object to be invalid because of
@@ -639,6 +666,37 @@ QT_BEGIN_NAMESPACE
     \sa QRegularExpression, QRegularExpressionMatch
 */
 
+/*!
+    \class QRegularExpressionSet
+    \inmodule QtCore
+    \reentrant
+
+    \brief The QRegularExpressionSet class matches a string against many
+    regular expressions at once.
+
+    \since 5.8
+
+    \ingroup tools
+    \ingroup shared
+
+    \keyword regular expression set
+
+    A QRegularExpressionSet holds a list of QRegularExpression objects and
+    tells which of them match a given subject string. It is meant for
+    classifying many strings (for instance, the lines of a log file) against
+    many patterns:
+
+    \snippet code/src_corelib_tools_qregularexpression.cpp 31
+
+    When a regular expression is added to the set, its pattern is compiled and
+    optimized, and what PCRE found out about the characters a matching string
+    must contain is kept aside. Matching a subject then scans it once to
+    collect the characters it contains, and runs the regular expression engine
+    only on the patterns that could possibly match it.
+
+    \sa QRegularExpression
+*/
+
 
 /*!
     \enum QRegularExpression::PatternOption
@@ -835,6 +893,16 @@ struct QRegularExpressionPrivate : QSharedData
     };
 
     void optimizePattern(OptimizePatternOption option);
+    void optimizeOnUsage();
+
+    enum SubjectEncoding {
+        Utf16Subject,
+        Utf8Subject,
+        Latin1Subject
+    };
+
+    const pcre *compilePcre8Pattern(SubjectEncoding encoding);
+    void optimizePcre8Pattern(SubjectEncoding encoding);
 
     enum CheckSubjectStringOption {
         CheckSubjectString,
@@ -849,9 +917,31 @@ struct QRegularExpressionPrivate : QSharedData
                                             QRegularExpression::MatchOptions matchOptions,
                                             CheckSubjectStringOption checkSubjectStringOption = CheckSubjectString,
                                             const QRegularExpressionMatchPrivate *previous = 0) const;
+    QRegularExpressionMatchPrivate *doMatch(const QByteArray &subject,
+                                            SubjectEncoding subjectEncoding,
+                                            int offset,
+                                            QRegularExpression::MatchType matchType,
+                                            QRegularExpression::MatchOptions matchOptions) const;
+    void doMatch(QRegularExpressionMatchPrivate *priv,
+                 int offset,
+                 CheckSubjectStringOption checkSubjectStringOption = CheckSubjectString,
+                 const QRegularExpressionMatchPrivate *previous = 0) const;
+    bool hasMatch(const QString &subject,
+                  int subjectStart,
+                  int subjectLength,
+                  int offset,
+                  QRegularExpression::MatchOptions matchOptions,
+                  CheckSubjectStringOption checkSubjectStringOption = CheckSubjectString) const;
+    bool hasMatch(const QByteArray &subject,
+                  SubjectEncoding subjectEncoding,
+                  int offset,
+                  QRegularExpression::MatchOptions matchOptions) const;
 
     int captureIndexForName(const QString &name) const;
 
+    static QExplicitlySharedDataPointer<QRegularExpressionPrivate> sharedPrivate(const QString &pattern,
+                                                                                 QRegularExpression::PatternOptions patternOptions);
+
     // sizeof(QSharedData) == 4, so start our members with an enum
     QRegularExpression::PatternOptions patternOptions;
     QString pattern;
@@ -875,6 +965,28 @@ struct QRegularExpressionPrivate : QSharedData
     unsigned int usedCount;
     bool usingCrLfNewlines;
     bool isDirty;
+
+    // The pattern compiled by the 8-bit PCRE, for matching UTF-8 or Latin-1
+    // subjects. It gets compiled (and optimized) on demand, under the mutex;
+    // once set, the pointers don't change until the pattern gets cleaned.
+    // The 16-bit compiled pattern is still used for validating the pattern
+    // and for looking up the names of the capturing groups.
+    struct Pcre8Pattern
+    {
+        Pcre8Pattern() : usedCount(0), isCompiled(false) {}
+
+        QAtomicPointer<pcre> compiledPattern;
+        QAtomicPointer<pcre_extra> studyData;
+        unsigned int usedCount;
+        bool isCompiled;
+    };
+    Pcre8Pattern pcre8Patterns[2]; // for Utf8Subject and Latin1Subject
+
+    Pcre8Pattern &pcre8Pattern(SubjectEncoding encoding)
+    {
+        Q_ASSERT(encoding != Utf16Subject);
+        return pcre8Patterns[encoding == Utf8Subject ? 0 : 1];
+    }
 };
 
 struct QRegularExpressionMatchPrivate : QSharedData
@@ -887,19 +999,33 @@ struct QRegularExpressionMatchPrivate : QSharedData
                                    QRegularExpression::MatchOptions matchOptions,
                                    int capturingCount = 0);
 
+    void reset(const QRegularExpression &re,
+               const QString &subject,
+               int subjectStart,
+               int subjectLength,
+               QRegularExpression::MatchType matchType,
+               QRegularExpression::MatchOptions matchOptions);
+
     QRegularExpressionMatch nextMatch() const;
 
-    const QRegularExpression regularExpression;
-    const QString subject;
+    // Not const: a match object that is not shared with anyone else may be
+    // reset and filled again by QRegularExpression::match(QRegularExpressionMatch *, ...)
+    QRegularExpression regularExpression;
+    QString subject;
     // the capturedOffsets vector contains pairs of (start, end) positions
     // for each captured substring
     QVector<int> capturedOffsets;
 
-    const int subjectStart;
-    const int subjectLength;
+    int subjectStart;
+    int subjectLength;
 
-    const QRegularExpression::MatchType matchType;
-    const QRegularExpression::MatchOptions matchOptions;
+    QRegularExpression::MatchType matchType;
+    QRegularExpression::MatchOptions matchOptions;
+
+    // the subject, when matching UTF-8 or Latin-1 data; in that case,
+    // subject is null and all the offsets are in bytes
+    QByteArray subjectBytes;
+    QRegularExpressionPrivate::SubjectEncoding subjectEncoding;
 
     int capturedCount;
 
@@ -984,11 +1110,85 @@ void QRegularExpressionPrivate::cleanCompiledPattern()
     usedCount = 0;
     compiledPattern = 0;
     studyData.store(0);
+    for (Pcre8Pattern &p : pcre8Patterns) {
+        pcre_free(p.compiledPattern.load());
+        pcre_free_study(p.studyData.load());
+        p.compiledPattern.store(0);
+        p.studyData.store(0);
+        p.usedCount = 0;
+        p.isCompiled = false;
+    }
     usingCrLfNewlines = false;
     errorOffset = -1;
     capturingCount = 0;
 }
 
+/*
+    The process-wide cache of patterns. QRegularExpression objects constructed
+    with the same pattern string and pattern options share their
+    QRegularExpressionPrivate, exactly like copies of a QRegularExpression
+    object do; therefore the pattern gets compiled and optimized only once.
+*/
+struct QRegularExpressionCacheKey
+{
+    QRegularExpressionCacheKey(const QString &pattern, QRegularExpression::PatternOptions patternOptions)
+        : pattern(pattern), patternOptions(patternOptions) {}
+
+    QString pattern;
+    QRegularExpression::PatternOptions patternOptions;
+};
+
+static inline bool operator==(const QRegularExpressionCacheKey &key1, const QRegularExpressionCacheKey &key2)
+{
+    return key1.patternOptions == key2.patternOptions && key1.pattern == key2.pattern;
+}
+
+static inline uint qHash(const QRegularExpressionCacheKey &key, uint seed = 0) Q_DECL_NOTHROW
+{
+    QtPrivate::QHashCombine hash;
+    seed = hash(seed, key.pattern);
+    seed = hash(seed, key.patternOptions);
+    return seed;
+}
+
+// how many patterns the cache keeps alive
+static const int qt_qregularexpression_cache_size = 512;
+
+typedef QCache<QRegularExpressionCacheKey, QRegularExpression> QRegularExpressionCache;
+Q_GLOBAL_STATIC_WITH_ARGS(QRegularExpressionCache, globalRegularExpressionCache,
+                          (qt_qregularexpression_cache_size))
+static QBasicMutex globalRegularExpressionCacheMutex;
+
+/*!
+    \internal
+
+    Returns the private shared by all the QRegularExpression objects using
+    \a pattern and \a patternOptions, creating (and caching) it if necessary.
+*/
+QExplicitlySharedDataPointer<QRegularExpressionPrivate>
+QRegularExpressionPrivate::sharedPrivate(const QString &pattern, QRegularExpression::PatternOptions patternOptions)
+{
+    const QRegularExpressionCacheKey key(pattern, patternOptions);
+    QRegularExpressionCache *cache = globalRegularExpressionCache();
+
+    if (cache) {
+        QMutexLocker locker(&globalRegularExpressionCacheMutex);
+        if (const QRegularExpression *re = cache->object(key))
+            return re->d;
+    }
+
+    QExplicitlySharedDataPointer<QRegularExpressionPrivate> d(new QRegularExpressionPrivate);
+    d->pattern = pattern;
+    d->patternOptions = patternOptions;
+
+    if (cache) {
+        QMutexLocker locker(&globalRegularExpressionCacheMutex);
+        cache->insert(key, new QRegularExpression(*d.data()));
+    }
+
+    return d;
+}
+
 /*!
     \internal
 */
@@ -1184,6 +1384,185 @@ void QRegularExpressionPrivate::optimizePattern(OptimizePatternOption option)
     studyData.storeRelease(localStudyData);
 }
 
+/*!
+    \internal
+
+    Optimizes the pattern as requested by the pattern options; called every
+    time a match is performed.
+*/
+void QRegularExpressionPrivate::optimizeOnUsage()
+{
+    if (patternOptions & QRegularExpression::DontAutomaticallyOptimizeOption)
+        return;
+
+    const OptimizePatternOption optimizePatternOption =
+            (patternOptions & QRegularExpression::OptimizeOnFirstUsageOption)
+                ? ImmediateOptimizeOption
+                : LazyOptimizeOption;
+
+    // this is mutex protected
+    optimizePattern(optimizePatternOption);
+}
+
+/*
+    The 8-bit counterpart of QPcreJitStackPointer.
+*/
+class QPcre8JitStackPointer
+{
+    Q_DISABLE_COPY(QPcre8JitStackPointer)
+
+public:
+    QPcre8JitStackPointer()
+    {
+        stack = pcre_jit_stack_alloc(32*1024, 512*1024);
+    }
+    ~QPcre8JitStackPointer()
+    {
+        if (stack)
+            pcre_jit_stack_free(stack);
+    }
+
+    pcre_jit_stack *stack;
+};
+
+Q_GLOBAL_STATIC(QThreadStorage<QPcre8JitStackPointer *>, jitStacks8)
+
+/*!
+    \internal
+*/
+static pcre_jit_stack *qtPcre8Callback(void *)
+{
+    if (jitStacks8()->hasLocalData())
+        return jitStacks8()->localData()->stack;
+
+    return 0;
+}
+
+/*!
+    \internal
+
+    The 8-bit counterpart of pcre16SafeExec().
+*/
+static int pcre8SafeExec(const pcre *code, const pcre_extra *extra,
+                         const char *subject, int length,
+                         int startOffset, int options,
+                         int *ovector, int ovecsize)
+{
+    int result = pcre_exec(code, extra, subject, length,
+                           startOffset, options, ovector, ovecsize);
+
+    if (result == PCRE_ERROR_JIT_STACKLIMIT && !jitStacks8()->hasLocalData()) {
+        QPcre8JitStackPointer *p = new QPcre8JitStackPointer;
+        jitStacks8()->setLocalData(p);
+
+        result = pcre_exec(code, extra, subject, length,
+                           startOffset, options, ovector, ovecsize);
+    }
+
+    return result;
+}
+
+/*!
+    \internal
+
+    Returns the pattern compiled by the 8-bit PCRE for subjects using \a
+    encoding, compiling it on first use. Returns 0 if the pattern can't be
+    used for such subjects. The (16-bit) pattern must have been compiled
+    successfully already, so we only get here with valid patterns.
+
+    Without PCRE_UTF8 the 8-bit PCRE works on Latin-1 data, therefore a
+    pattern containing characters outside Latin-1 can't be used on Latin-1
+    subjects.
+*/
+const pcre *QRegularExpressionPrivate::compilePcre8Pattern(SubjectEncoding encoding)
+{
+    Q_ASSERT(compiledPattern);
+
+    Pcre8Pattern &p = pcre8Pattern(encoding);
+    if (const pcre *code = p.compiledPattern.loadAcquire())
+        return code;
+
+    QMutexLocker lock(&mutex);
+
+    if (p.isCompiled)
+        return p.compiledPattern.load();
+    p.isCompiled = true;
+
+    int options = convertToPcreOptions(patternOptions);
+    QByteArray encodedPattern;
+    if (encoding == Utf8Subject) {
+        options |= PCRE_UTF8;
+        encodedPattern = pattern.toUtf8();
+    } else {
+        for (const QChar c : pattern) {
+            if (c.unicode() > 0xff) {
+                qWarning("QRegularExpressionPrivate::compilePcre8Pattern(): the pattern '%s'\n"
+                         "    contains characters outside Latin-1 and can't be matched against Latin-1 data",
+                         qPrintable(pattern));
+                return 0;
+            }
+        }
+        encodedPattern = pattern.toLatin1();
+    }
+
+    int errorCode;
+    const char *errorString;
+    int errorOffset;
+    pcre *code = pcre_compile2(encodedPattern.constData(), options,
+                               &errorCode, &errorString, &errorOffset, 0);
+    if (!code) {
+        qWarning("QRegularExpressionPrivate::compilePcre8Pattern(): the pattern '%s'\n"
+                 "    can't be matched against %s data: %s",
+                 qPrintable(pattern), encoding == Utf8Subject ? "UTF-8" : "Latin-1", errorString);
+    }
+
+    p.compiledPattern.storeRelease(code);
+    return code;
+}
+
+/*!
+    \internal
+
+    The 8-bit counterpart of optimizeOnUsage() and optimizePattern(): the
+    pattern compiled for subjects using \a encoding gets optimized following
+    the same rules of the 16-bit one.
+*/
+void QRegularExpressionPrivate::optimizePcre8Pattern(SubjectEncoding encoding)
+{
+    if (patternOptions & QRegularExpression::DontAutomaticallyOptimizeOption)
+        return;
+
+    Pcre8Pattern &p = pcre8Pattern(encoding);
+    Q_ASSERT(p.compiledPattern.load());
+
+    QMutexLocker lock(&mutex);
+
+    if (p.studyData.load()) // already optimized
+        return;
+
+    if (!(patternOptions & QRegularExpression::OptimizeOnFirstUsageOption)
+            && ++p.usedCount != qt_qregularexpression_optimize_after_use_count) {
+        return;
+    }
+
+    static const bool enableJit = isJitEnabled();
+
+    int studyOptions = 0;
+    if (enableJit)
+        studyOptions |= (PCRE_STUDY_JIT_COMPILE | PCRE_STUDY_JIT_PARTIAL_SOFT_COMPILE | PCRE_STUDY_JIT_PARTIAL_HARD_COMPILE);
+
+    const char *err;
+    pcre_extra * const localStudyData = pcre_study(p.compiledPattern.load(), studyOptions, &err);
+
+    if (localStudyData && localStudyData->flags & PCRE_EXTRA_EXECUTABLE_JIT)
+        pcre_assign_jit_stack(localStudyData, qtPcre8Callback, 0);
+
+    if (!localStudyData && err)
+        qWarning("QRegularExpressionPrivate::optimizePcre8Pattern(): pcre_study failed: %s", err);
+
+    p.studyData.storeRelease(localStudyData);
+}
+
 /*!
     \internal
 
@@ -1268,48 +1647,99 @@ QRegularExpressionMatchPrivate *QRegularExpressionPrivate::doMatch(const QString
                                                                    CheckSubjectStringOption checkSubjectStringOption,
                                                                    const QRegularExpressionMatchPrivate *previous) const
 {
-    if (offset < 0)
-        offset += subjectLength;
+    QRegularExpression re(*const_cast<QRegularExpressionPrivate *>(this));
+    QRegularExpressionMatchPrivate *priv = new QRegularExpressionMatchPrivate(re, subject,
+                                                                              subjectStart, subjectLength,
+                                                                              matchType, matchOptions);
+    doMatch(priv, offset, checkSubjectStringOption, previous);
+    return priv;
+}
+
+/*!
+    \internal
+
+    Performs a match on the \a subject data, encoded as specified by \a
+    subjectEncoding (which must be either Utf8Subject or Latin1Subject). All
+    the offsets, including the matching \a offset, are in bytes.
+
+    Returns the QRegularExpressionMatchPrivate of the result.
+*/
+QRegularExpressionMatchPrivate *QRegularExpressionPrivate::doMatch(const QByteArray &subject,
+                                                                   SubjectEncoding subjectEncoding,
+                                                                   int offset,
+                                                                   QRegularExpression::MatchType matchType,
+                                                                   QRegularExpression::MatchOptions matchOptions) const
+{
+    Q_ASSERT(subjectEncoding != Utf16Subject);
 
     QRegularExpression re(*const_cast<QRegularExpressionPrivate *>(this));
+    QRegularExpressionMatchPrivate *priv = new QRegularExpressionMatchPrivate(re, QString(),
+                                                                              0, subject.size(),
+                                                                              matchType, matchOptions);
+    priv->subjectBytes = subject;
+    priv->subjectEncoding = subjectEncoding;
+    doMatch(priv, offset);
+    return priv;
+}
+
+/*!
+    \internal
+
+    Performs the match described by \a priv (which must have been reset
+    to a pristine state for this regular expression), storing the results
+    into \a priv itself.
+*/
+void QRegularExpressionPrivate::doMatch(QRegularExpressionMatchPrivate *priv,
+                                        int offset,
+                                        CheckSubjectStringOption checkSubjectStringOption,
+                                        const QRegularExpressionMatchPrivate *previous) const
+{
+    const int subjectLength = priv->subjectLength;
+    const QRegularExpression::MatchType matchType = priv->matchType;
+    const QRegularExpression::MatchOptions matchOptions = priv->matchOptions;
+    const SubjectEncoding subjectEncoding = priv->subjectEncoding;
+
+    if (offset < 0)
+        offset += subjectLength;
 
     if (offset < 0 || offset > subjectLength)
-        return new QRegularExpressionMatchPrivate(re, subject, subjectStart, subjectLength, matchType, matchOptions);
+        return;
 
     if (!compiledPattern) {
         qWarning("QRegularExpressionPrivate::doMatch(): called on an invalid QRegularExpression object");
-        return new QRegularExpressionMatchPrivate(re, subject, subjectStart, subjectLength, matchType, matchOptions);
+        return;
     }
 
     // skip optimizing and doing the actual matching if NoMatch type was requested
     if (matchType == QRegularExpression::NoMatch) {
-        QRegularExpressionMatchPrivate *priv = new QRegularExpressionMatchPrivate(re, subject,
-                                                                                  subjectStart, subjectLength,
-                                                                                  matchType, matchOptions);
         priv->isValid = true;
-        return priv;
+        return;
     }
 
-    // capturingCount doesn't include the implicit "0" capturing group
-    QRegularExpressionMatchPrivate *priv = new QRegularExpressionMatchPrivate(re, subject,
-                                                                              subjectStart, subjectLength,
-                                                                              matchType, matchOptions,
-                                                                              capturingCount + 1);
-
-    if (!(patternOptions & QRegularExpression::DontAutomaticallyOptimizeOption)) {
-        const OptimizePatternOption optimizePatternOption =
-                (patternOptions & QRegularExpression::OptimizeOnFirstUsageOption)
-                    ? ImmediateOptimizeOption
-                    : LazyOptimizeOption;
+    QRegularExpressionPrivate * const that = const_cast<QRegularExpressionPrivate *>(this);
 
-        // this is mutex protected
-        const_cast<QRegularExpressionPrivate *>(this)->optimizePattern(optimizePatternOption);
+    const pcre *compiledPcre8Pattern = 0;
+    if (subjectEncoding != Utf16Subject) {
+        compiledPcre8Pattern = that->compilePcre8Pattern(subjectEncoding);
+        if (!compiledPcre8Pattern)
+            return;
     }
 
+    // capturingCount doesn't include the implicit "0" capturing group
+    priv->capturedOffsets.resize((capturingCount + 1) * 3);
+
+    if (subjectEncoding == Utf16Subject)
+        that->optimizeOnUsage();
+    else
+        that->optimizePcre8Pattern(subjectEncoding);
+
     // work with a local copy of the study data, as we are running pcre_exec
     // potentially more than once, and we don't want to run call it
     // with different study data
     const pcre16_extra * const currentStudyData = studyData.loadAcquire();
+    const pcre_extra * const currentPcre8StudyData = subjectEncoding == Utf16Subject
+            ? 0
+            : that->pcre8Pattern(subjectEncoding).studyData.loadAcquire();
 
     int pcreOptions = convertToPcreOptions(matchOptions);
 
@@ -1318,6 +1748,7 @@ QRegularExpressionMatchPrivate *QRegularExpressionPrivate::doMatch(const QString
     else if (matchType == QRegularExpression::PartialPreferFirstMatch)
         pcreOptions |= PCRE_PARTIAL_HARD;
 
+    // PCRE_NO_UTF8_CHECK has the same value; Latin-1 doesn't get checked anyhow
     if (checkSubjectStringOption == DontCheckSubjectString
             || matchOptions & QRegularExpression::DontCheckSubjectStringMatchOption) {
         pcreOptions |= PCRE_NO_UTF16_CHECK;
@@ -1332,44 +1763,56 @@ QRegularExpressionMatchPrivate *QRegularExpressionPrivate::doMatch(const QString
     int * const captureOffsets = priv->capturedOffsets.data();
     const int captureOffsetsCount = priv->capturedOffsets.size();
 
-    const unsigned short * const subjectUtf16 = subject.utf16() + subjectStart;
+    const unsigned short * const subjectUtf16 = priv->subject.utf16() + priv->subjectStart;
+    const char * const subjectBytes = priv->subjectBytes.constData();
+
+    const auto exec = [&](int offset, int pcreOptions) {
+        if (subjectEncoding == Utf16Subject) {
+            return pcre16SafeExec(compiledPattern, currentStudyData,
+                                  subjectUtf16, subjectLength,
+                                  offset, pcreOptions,
+                                  captureOffsets, captureOffsetsCount);
+        }
+        return pcre8SafeExec(compiledPcre8Pattern, currentPcre8StudyData,
+                             subjectBytes, subjectLength,
+                             offset, pcreOptions,
+                             captureOffsets, captureOffsetsCount);
+    };
+    const auto unitAt = [&](int i) -> ushort {
+        return subjectEncoding == Utf16Subject ? subjectUtf16[i] : uchar(subjectBytes[i]);
+    };
 
     int result;
 
     if (!previousMatchWasEmpty) {
-        result = pcre16SafeExec(compiledPattern, currentStudyData,
-                                subjectUtf16, subjectLength,
-                                offset, pcreOptions,
-                                captureOffsets, captureOffsetsCount);
+        result = exec(offset, pcreOptions);
     } else {
-        result = pcre16SafeExec(compiledPattern, currentStudyData,
-                                subjectUtf16, subjectLength,
-                                offset, pcreOptions | PCRE_NOTEMPTY_ATSTART | PCRE_ANCHORED,
-                                captureOffsets, captureOffsetsCount);
+        result = exec(offset, pcreOptions | PCRE_NOTEMPTY_ATSTART | PCRE_ANCHORED);
 
         if (result == PCRE_ERROR_NOMATCH) {
             ++offset;
 
             if (usingCrLfNewlines
                     && offset < subjectLength
-                    && subjectUtf16[offset - 1] == QLatin1Char('\r')
-                    && subjectUtf16[offset] == QLatin1Char('\n')) {
-                ++offset;
-            } else if (offset < subjectLength
-                       && QChar::isLowSurrogate(subjectUtf16[offset])) {
+                    && unitAt(offset - 1) == '\r'
+                    && unitAt(offset) == '\n') {
                 ++offset;
+            } else if (subjectEncoding == Utf16Subject) {
+                if (offset < subjectLength && QChar::isLowSurrogate(subjectUtf16[offset]))
+                    ++offset;
+            } else if (subjectEncoding == Utf8Subject) {
+                // skip the continuation bytes of a multibyte sequence
+                while (offset < subjectLength && (uchar(subjectBytes[offset]) & 0xc0) == 0x80)
+                    ++offset;
             }
 
-            result = pcre16SafeExec(compiledPattern, currentStudyData,
-                                    subjectUtf16, subjectLength,
-                                    offset, pcreOptions,
-                                    captureOffsets, captureOffsetsCount);
+            result = exec(offset, pcreOptions);
         }
     }
 
 #ifdef QREGULAREXPRESSION_DEBUG
-    qDebug() << "Matching" <<  pattern << "against" << subject
-             << "starting at" << subjectStart << "len" << subjectLength
+    qDebug() << "Matching" <<  pattern << "against" << priv->subject
+             << "starting at" << priv->subjectStart << "len" << subjectLength
              << "offset" << offset
              << matchType << matchOptions << previousMatchWasEmpty
              << "result" << result;
@@ -1400,54 +1843,179 @@ QRegularExpressionMatchPrivate *QRegularExpressionPrivate::doMatch(const QString
             priv->capturedOffsets.clear();
         }
     }
-
-    return priv;
 }
 
 /*!
     \internal
+
+    Returns \c true if the regular expression matches the substring of \a
+    subject starting at \a subjectStart and \a subjectLength characters long,
+    starting at the position \a offset inside it. It's the equivalent of
+    doMatch() for a NormalMatch, but doesn't allocate anything.
 */
-QRegularExpressionMatchPrivate::QRegularExpressionMatchPrivate(const QRegularExpression &re,
-                                                               const QString &subject,
-                                                               int subjectStart,
-                                                               int subjectLength,
-                                                               QRegularExpression::MatchType matchType,
-                                                               QRegularExpression::MatchOptions matchOptions,
-                                                               int capturingCount)
-    : regularExpression(re), subject(subject),
-      subjectStart(subjectStart), subjectLength(subjectLength),
-      matchType(matchType), matchOptions(matchOptions),
-      capturedCount(0),
-      hasMatch(false), hasPartialMatch(false), isValid(false)
+bool QRegularExpressionPrivate::hasMatch(const QString &subject,
+                                         int subjectStart,
+                                         int subjectLength,
+                                         int offset,
+                                         QRegularExpression::MatchOptions matchOptions,
+                                         CheckSubjectStringOption checkSubjectStringOption) const
 {
-    Q_ASSERT(capturingCount >= 0);
-    if (capturingCount > 0) {
-        const int captureOffsetsCount = capturingCount * 3;
-        capturedOffsets.resize(captureOffsetsCount);
+    if (offset < 0)
+        offset += subjectLength;
+
+    if (offset < 0 || offset > subjectLength)
+        return false;
+
+    if (!compiledPattern) {
+        qWarning("QRegularExpressionPrivate::hasMatch(): called on an invalid QRegularExpression object");
+        return false;
     }
-}
 
+    const_cast<QRegularExpressionPrivate *>(this)->optimizeOnUsage();
+
+    const pcre16_extra * const currentStudyData = studyData.loadAcquire();
+
+    int pcreOptions = convertToPcreOptions(matchOptions);
+    if (checkSubjectStringOption == DontCheckSubjectString
+            || matchOptions & QRegularExpression::DontCheckSubjectStringMatchOption) {
+        pcreOptions |= PCRE_NO_UTF16_CHECK;
+    }
+
+    // PCRE allocates a vector of its own if the pattern contains
+    // backreferences and the one we pass is too small for them
+    QVarLengthArray<int, 3 * 16> captureOffsets((capturingCount + 1) * 3);
+
+    const int result = pcre16SafeExec(compiledPattern, currentStudyData,
+                                      subject.utf16() + subjectStart, subjectLength,
+                                      offset, pcreOptions,
+                                      captureOffsets.data(), captureOffsets.size());
+    return result > 0;
+}
 
 /*!
     \internal
+
+    The counterpart of hasMatch() for UTF-8 and Latin-1 \a subject data. The
+    \a offset is in bytes.
 */
-QRegularExpressionMatch QRegularExpressionMatchPrivate::nextMatch() const
+bool QRegularExpressionPrivate::hasMatch(const QByteArray &subject,
+                                         SubjectEncoding subjectEncoding,
+                                         int offset,
+                                         QRegularExpression::MatchOptions matchOptions) const
 {
-    Q_ASSERT(isValid);
-    Q_ASSERT(hasMatch || hasPartialMatch);
+    Q_ASSERT(subjectEncoding != Utf16Subject);
 
-    // Note the DontCheckSubjectString passed for the check of the subject string:
+    const int subjectLength = subject.size();
+    if (offset < 0)
+        offset += subjectLength;
+
+    if (offset < 0 || offset > subjectLength)
+        return false;
+
+    if (!compiledPattern) {
+        qWarning("QRegularExpressionPrivate::hasMatch(): called on an invalid QRegularExpression object");
+        return false;
+    }
+
+    QRegularExpressionPrivate * const that = const_cast<QRegularExpressionPrivate *>(this);
+    const pcre * const code = that->compilePcre8Pattern(subjectEncoding);
+    if (!code)
+        return false;
+
+    that->optimizePcre8Pattern(subjectEncoding);
+
+    const pcre_extra * const currentStudyData = that->pcre8Pattern(subjectEncoding).studyData.loadAcquire();
+
+    int pcreOptions = convertToPcreOptions(matchOptions);
+    if (matchOptions & QRegularExpression::DontCheckSubjectStringMatchOption)
+        pcreOptions |= PCRE_NO_UTF8_CHECK;
+
+    QVarLengthArray<int, 3 * 16> captureOffsets((capturingCount + 1) * 3);
+
+    const int result = pcre8SafeExec(code, currentStudyData,
+                                     subject.constData(), subjectLength,
+                                     offset, pcreOptions,
+                                     captureOffsets.data(), captureOffsets.size());
+    return result > 0;
+}
+
+/*!
+    \internal
+*/
+QRegularExpressionMatchPrivate::QRegularExpressionMatchPrivate(const QRegularExpression &re,
+                                                               const QString &subject,
+                                                               int subjectStart,
+                                                               int subjectLength,
+                                                               QRegularExpression::MatchType matchType,
+                                                               QRegularExpression::MatchOptions matchOptions,
+                                                               int capturingCount)
+    : regularExpression(re), subject(subject),
+      subjectStart(subjectStart), subjectLength(subjectLength),
+      matchType(matchType), matchOptions(matchOptions),
+      subjectEncoding(QRegularExpressionPrivate::Utf16Subject),
+      capturedCount(0),
+      hasMatch(false), hasPartialMatch(false), isValid(false)
+{
+    Q_ASSERT(capturingCount >= 0);
+    if (capturingCount > 0) {
+        const int captureOffsetsCount = capturingCount * 3;
+        capturedOffsets.resize(captureOffsetsCount);
+    }
+}
+
+/*!
+    \internal
+
+    Brings the object back to the state of a freshly constructed one, keeping
+    the memory allocated for the captured offsets.
+*/
+void QRegularExpressionMatchPrivate::reset(const QRegularExpression &re,
+                                           const QString &subject,
+                                           int subjectStart,
+                                           int subjectLength,
+                                           QRegularExpression::MatchType matchType,
+                                           QRegularExpression::MatchOptions matchOptions)
+{
+    regularExpression = re;
+    this->subject = subject;
+    capturedOffsets.clear();
+    this->subjectStart = subjectStart;
+    this->subjectLength = subjectLength;
+    this->matchType = matchType;
+    this->matchOptions = matchOptions;
+    subjectBytes.clear();
+    subjectEncoding = QRegularExpressionPrivate::Utf16Subject;
+    capturedCount = 0;
+    hasMatch = false;
+    hasPartialMatch = false;
+    isValid = false;
+}
+
+
+/*!
+    \internal
+*/
+QRegularExpressionMatch QRegularExpressionMatchPrivate::nextMatch() const
+{
+    Q_ASSERT(isValid);
+    Q_ASSERT(hasMatch || hasPartialMatch);
+
+    // Note the DontCheckSubjectString passed for the check of the subject string:
     // if we're advancing a match on the same subject,
     // then that subject was already checked at least once (when this object
     // was created, or when the object that created this one was created, etc.)
-    QRegularExpressionMatchPrivate *nextPrivate = regularExpression.d->doMatch(subject,
-                                                                               subjectStart,
-                                                                               subjectLength,
-                                                                               capturedOffsets.at(1),
-                                                                               matchType,
-                                                                               matchOptions,
-                                                                               QRegularExpressionPrivate::DontCheckSubjectString,
-                                                                               this);
+    QRegularExpressionMatchPrivate *nextPrivate = new QRegularExpressionMatchPrivate(regularExpression,
+                                                                                     subject,
+                                                                                     subjectStart,
+                                                                                     subjectLength,
+                                                                                     matchType,
+                                                                                     matchOptions);
+    nextPrivate->subjectBytes = subjectBytes;
+    nextPrivate->subjectEncoding = subjectEncoding;
+    regularExpression.d->doMatch(nextPrivate,
+                                 capturedOffsets.at(1),
+                                 QRegularExpressionPrivate::DontCheckSubjectString,
+                                 this);
     return QRegularExpressionMatch(*nextPrivate);
 }
 
@@ -1492,10 +2060,8 @@ QRegularExpression::QRegularExpression()
     \sa setPattern(), setPatternOptions()
 */
 QRegularExpression::QRegularExpression(const QString &pattern, PatternOptions options)
-    : d(new QRegularExpressionPrivate)
+    : d(QRegularExpressionPrivate::sharedPrivate(pattern, options))
 {
-    d->pattern = pattern;
-    d->patternOptions = options;
 }
 
 /*!
@@ -1550,9 +2116,7 @@ QString QRegularExpression::pattern() const
 */
 void QRegularExpression::setPattern(const QString &pattern)
 {
-    d.detach();
-    d->isDirty = true;
-    d->pattern = pattern;
+    d = QRegularExpressionPrivate::sharedPrivate(pattern, d->patternOptions);
 }
 
 /*!
@@ -1573,9 +2137,7 @@ QRegularExpression::PatternOptions QRegularExpression::patternOptions() const
 */
 void QRegularExpression::setPatternOptions(PatternOptions options)
 {
-    d.detach();
-    d->isDirty = true;
-    d->patternOptions = options;
+    d = QRegularExpressionPrivate::sharedPrivate(d->pattern, options);
 }
 
 /*!
@@ -1745,6 +2307,114 @@ QRegularExpressionMatch QRegularExpression::match(const QStringRef &subjectRef,
     return QRegularExpressionMatch(*priv);
 }
 
+/*!
+    \since 5.8
+    \overload
+
+    Attempts to match the regular expression against the given \a subject
+    string, starting at the position \a offset inside the subject, using a
+    match of type \a matchType and honoring the given \a matchOptions.
+
+    The results of the match are stored into \a result, which must not be
+    null. If \a result is not shared with any other QRegularExpressionMatch
+    object, the memory it holds is reused, so that matching many subjects
+    with the same \a result object does not allocate memory for every match.
+
+    Returns \c true if a complete match was found, \c false otherwise; this
+    is the same value returned by calling \c{result->hasMatch()}.
+
+    \sa matches(), QRegularExpressionMatch
+*/
+bool QRegularExpression::match(QRegularExpressionMatch *result,
+                               const QString &subject,
+                               int offset,
+                               MatchType matchType,
+                               MatchOptions matchOptions) const
+{
+    return match(result, QStringRef(&subject), offset, matchType, matchOptions);
+}
+
+/*!
+    \since 5.8
+    \overload
+
+    Attempts to match the regular expression against the given \a subjectRef
+    string reference, starting at the position \a offset inside the subject,
+    using a match of type \a matchType and honoring the given \a
+    matchOptions. The results are stored into \a result, reusing its memory
+    if possible.
+
+    Returns \c true if a complete match was found, \c false otherwise.
+*/
+bool QRegularExpression::match(QRegularExpressionMatch *result,
+                               const QStringRef &subjectRef,
+                               int offset,
+                               MatchType matchType,
+                               MatchOptions matchOptions) const
+{
+    Q_ASSERT(result);
+
+    d.data()->compilePattern();
+
+    const QString subject = subjectRef.string() ? *subjectRef.string() : QString();
+
+    QRegularExpressionMatchPrivate *priv;
+    if (result->d.constData()->ref.load() == 1) {
+        priv = result->d.data(); // does not detach
+        priv->reset(*this, subject, subjectRef.position(), subjectRef.length(), matchType, matchOptions);
+    } else {
+        priv = new QRegularExpressionMatchPrivate(*this, subject,
+                                                  subjectRef.position(), subjectRef.length(),
+                                                  matchType, matchOptions);
+        result->d = priv;
+    }
+
+    d->doMatch(priv, offset);
+    return priv->hasMatch;
+}
+
+/*!
+    \since 5.8
+
+    Returns \c true if the regular expression matches the given \a subject
+    string, starting at the position \a offset inside the subject and honoring
+    the given \a matchOptions; returns \c false otherwise (including when the
+    regular expression or the subject are invalid).
+
+    This is equivalent to \c{match(subject, offset, NormalMatch,
+    matchOptions).hasMatch()}, but no QRegularExpressionMatch object is
+    created and therefore no memory is allocated.
+
+    \sa match()
+*/
+bool QRegularExpression::matches(const QString &subject,
+                                 int offset,
+                                 MatchOptions matchOptions) const
+{
+    return matches(QStringRef(&subject), offset, matchOptions);
+}
+
+/*!
+    \since 5.8
+    \overload
+
+    Returns \c true if the regular expression matches the given \a
+    subjectRef string reference, starting at the position \a offset inside
+    the subject and honoring the given \a matchOptions.
+*/
+bool QRegularExpression::matches(const QStringRef &subjectRef,
+                                 int offset,
+                                 MatchOptions matchOptions) const
+{
+    d.data()->compilePattern();
+
+    if (!subjectRef.string())
+        return d->hasMatch(QString(), 0, 0, offset, matchOptions);
+
+    return d->hasMatch(*subjectRef.string(), subjectRef.position(), subjectRef.length(),
+                       offset, matchOptions);
+}
+
 /*!
     Attempts to perform a global match of the regular expression against the
     given \a subject string, starting at the position \a offset inside the
@@ -1798,6 +2468,156 @@ QRegularExpressionMatchIterator QRegularExpression::globalMatch(const QStringRef
     return QRegularExpressionMatchIterator(*priv);
 }
 
+/*!
+    \since 5.8
+
+    Attempts to match the regular expression against the given \a subject,
+    which holds UTF-8 encoded text, starting at the byte position \a offset
+    inside the subject, using a match of type \a matchType and honoring the
+    given \a matchOptions.
+
+    The subject is matched as it is, without converting it to a QString
+    first. All the offsets reported by the returned QRegularExpressionMatch
+    object, as well as \a offset, are in bytes; use
+    QRegularExpressionMatch::capturedBytes() to retrieve the captured data
+    without decoding it.
+
+    The subject is checked for UTF-8 validity, unless the
+    DontCheckSubjectStringMatchOption match option is given; invalid UTF-8
+    makes the match invalid.
+
+    \sa matchLatin1(), globalMatchUtf8(), matchesUtf8(), {Matching Encoded Data}
+*/
+QRegularExpressionMatch QRegularExpression::matchUtf8(const QByteArray &subject,
+                                                      int offset,
+                                                      MatchType matchType,
+                                                      MatchOptions matchOptions) const
+{
+    d.data()->compilePattern();
+
+    QRegularExpressionMatchPrivate *priv = d->doMatch(subject, QRegularExpressionPrivate::Utf8Subject,
+                                                      offset, matchType, matchOptions);
+    return QRegularExpressionMatch(*priv);
+}
+
+/*!
+    \since 5.8
+
+    Attempts to match the regular expression against the given \a subject,
+    which holds Latin-1 encoded text, starting at the byte position \a offset
+    inside the subject, using a match of type \a matchType and honoring the
+    given \a matchOptions.
+
+    The subject is matched as it is, without converting it to a QString
+    first; all the offsets are in bytes (which, for Latin-1, is the same as
+    characters). A pattern containing characters outside Latin-1 never
+    matches.
+
+    \note Case insensitive matching of non-ASCII characters is only
+    supported for UTF-8 subjects.
+
+    \sa matchUtf8(), globalMatchLatin1(), matchesLatin1(), {Matching Encoded Data}
+*/
+QRegularExpressionMatch QRegularExpression::matchLatin1(const QByteArray &subject,
+                                                        int offset,
+                                                        MatchType matchType,
+                                                        MatchOptions matchOptions) const
+{
+    d.data()->compilePattern();
+
+    QRegularExpressionMatchPrivate *priv = d->doMatch(subject, QRegularExpressionPrivate::Latin1Subject,
+                                                      offset, matchType, matchOptions);
+    return QRegularExpressionMatch(*priv);
+}
+
+/*!
+    \since 5.8
+
+    Attempts to perform a global match of the regular expression against the
+    given \a subject, which holds UTF-8 encoded text, starting at the byte
+    position \a offset inside the subject, using a match of type \a
+    matchType and honoring the given \a matchOptions.
+
+    \sa matchUtf8(), globalMatch()
+*/
+QRegularExpressionMatchIterator QRegularExpression::globalMatchUtf8(const QByteArray &subject,
+                                                                    int offset,
+                                                                    MatchType matchType,
+                                                                    MatchOptions matchOptions) const
+{
+    QRegularExpressionMatchIteratorPrivate *priv =
+            new QRegularExpressionMatchIteratorPrivate(*this,
+                                                       matchType,
+                                                       matchOptions,
+                                                       matchUtf8(subject, offset, matchType, matchOptions));
+
+    return QRegularExpressionMatchIterator(*priv);
+}
+
+/*!
+    \since 5.8
+
+    Attempts to perform a global match of the regular expression against the
+    given \a subject, which holds Latin-1 encoded text, starting at the byte
+    position \a offset inside the subject, using a match of type \a
+    matchType and honoring the given \a matchOptions.
+
+    \sa matchLatin1(), globalMatch()
+*/
+QRegularExpressionMatchIterator QRegularExpression::globalMatchLatin1(const QByteArray &subject,
+                                                                      int offset,
+                                                                      MatchType matchType,
+                                                                      MatchOptions matchOptions) const
+{
+    QRegularExpressionMatchIteratorPrivate *priv =
+            new QRegularExpressionMatchIteratorPrivate(*this,
+                                                       matchType,
+                                                       matchOptions,
+                                                       matchLatin1(subject, offset, matchType, matchOptions));
+
+    return QRegularExpressionMatchIterator(*priv);
+}
+
+/*!
+    \since 5.8
+
+    Returns \c true if the regular expression matches the given \a subject,
+    which holds UTF-8 encoded text, starting at the byte position \a offset
+    inside the subject and honoring the given \a matchOptions; returns \c
+    false otherwise.
+
+    Like matches(), this function does not allocate memory.
+
+    \sa matchUtf8(), matchesLatin1()
+*/
+bool QRegularExpression::matchesUtf8(const QByteArray &subject,
+                                     int offset,
+                                     MatchOptions matchOptions) const
+{
+    d.data()->compilePattern();
+
+    return d->hasMatch(subject, QRegularExpressionPrivate::Utf8Subject, offset, matchOptions);
+}
+
+/*!
+    \since 5.8
+
+    Returns \c true if the regular expression matches the given \a subject,
+    which holds Latin-1 encoded text, starting at the byte position \a offset
+    inside the subject and honoring the given \a matchOptions; returns \c
+    false otherwise.
+
+    \sa matchLatin1(), matchesUtf8()
+*/
+bool QRegularExpression::matchesLatin1(const QByteArray &subject,
+                                       int offset,
+                                       MatchOptions matchOptions) const
+{
+    d.data()->compilePattern();
+
+    return d->hasMatch(subject, QRegularExpressionPrivate::Latin1Subject, offset, matchOptions);
+}
+
 /*!
     \since 5.4
 
@@ -2047,8 +2867,11 @@ int QRegularExpressionMatch::lastCapturedIndex() const
     capturing group did not capture a string or doesn't exist, returns a null
     QString.
 
-    \sa capturedRef(), lastCapturedIndex(), capturedStart(), capturedEnd(),
-    capturedLength(), QString::isNull()
+    If the match was performed on UTF-8 or Latin-1 data, the captured bytes
+    are decoded accordingly.
+
+    \sa capturedRef(), capturedBytes(), lastCapturedIndex(), capturedStart(),
+    capturedEnd(), capturedLength(), QString::isNull()
 */
 QString QRegularExpressionMatch::captured(int nth) const
 {
@@ -2060,6 +2883,15 @@ QString QRegularExpressionMatch::captured(int nth) const
     if (start == -1) // didn't capture
         return QString();
 
+    switch (d->subjectEncoding) {
+    case QRegularExpressionPrivate::Utf16Subject:
+        break;
+    case QRegularExpressionPrivate::Utf8Subject:
+        return QString::fromUtf8(d->subjectBytes.constData() + start, capturedLength(nth));
+    case QRegularExpressionPrivate::Latin1Subject:
+        return QString::fromLatin1(d->subjectBytes.constData() + start, capturedLength(nth));
+    }
+
     return d->subject.mid(start + d->subjectStart, capturedLength(nth));
 }
 
@@ -2068,6 +2900,10 @@ QString QRegularExpressionMatch::captured(int nth) const
     If the \a nth capturing group did not capture a string or doesn't exist,
     returns a null QStringRef.
 
+    If the match was performed on UTF-8 or Latin-1 data, there is no string
+    to refer to and a null QStringRef is always returned; use captured() or
+    capturedBytes() instead.
+
     \sa captured(), lastCapturedIndex(), capturedStart(), capturedEnd(),
     capturedLength(), QStringRef::isNull()
 */
@@ -2076,6 +2912,9 @@ QStringRef QRegularExpressionMatch::capturedRef(int nth) const
     if (nth < 0 || nth > lastCapturedIndex())
         return QStringRef();
 
+    if (d->subjectEncoding != QRegularExpressionPrivate::Utf16Subject)
+        return QStringRef();
+
     int start = capturedStart(nth);
 
     if (start == -1) // didn't capture
@@ -2124,6 +2963,56 @@ QStringRef QRegularExpressionMatch::capturedRef(const QString &name) const
     return capturedRef(nth);
 }
 
+/*!
+    \since 5.8
+
+    Returns the bytes captured by the \a nth capturing group, if the match
+    was performed on UTF-8 or Latin-1 data (see
+    QRegularExpression::matchUtf8() and QRegularExpression::matchLatin1()).
+    The returned byte array shares no data with the subject.
+
+    Returns a null QByteArray if the \a nth capturing group did not capture
+    anything or doesn't exist, or if the match was performed on a QString.
+
+    \sa captured(), capturedStart(), capturedLength()
+*/
+QByteArray QRegularExpressionMatch::capturedBytes(int nth) const
+{
+    if (nth < 0 || nth > lastCapturedIndex())
+        return QByteArray();
+
+    if (d->subjectEncoding == QRegularExpressionPrivate::Utf16Subject)
+        return QByteArray();
+
+    int start = capturedStart(nth);
+
+    if (start == -1) // didn't capture
+        return QByteArray();
+
+    return d->subjectBytes.mid(start, capturedLength(nth));
+}
+
+/*!
+    \since 5.8
+    \overload
+
+    Returns the bytes captured by the capturing group named \a name, if the
+    match was performed on UTF-8 or Latin-1 data. Returns a null QByteArray
+    if the capturing group named \a name did not capture anything or doesn't
+    exist, or if the match was performed on a QString.
+*/
+QByteArray QRegularExpressionMatch::capturedBytes(const QString &name) const
+{
+    if (name.isEmpty()) {
+        qWarning("QRegularExpressionMatch::capturedBytes: empty capturing group name passed");
+        return QByteArray();
+    }
+    int nth = d->regularExpression.d->captureIndexForName(name);
+    if (nth == -1)
+        return QByteArray();
+    return capturedBytes(nth);
+}
+
 /*!
     Returns a list of all strings captured by capturing groups, in the order
     the groups themselves appear in the pattern string.
@@ -2441,6 +3330,400 @@ QRegularExpression::MatchOptions QRegularExpressionMatchIterator::matchOptions()
     return d->matchOptions;
 }
 
+/*!
+    \internal
+
+    For every regular expression in the set we keep what a subject string
+    must contain for the expression to possibly match it, as found by PCRE
+    when compiling and studying the pattern: the subject must be at least
+    minimumLength characters long, and must contain at least one of the
+    characters in startBits and one in requiredBits (when they are
+    available). Like PCRE does, all the characters above U+00FF are folded
+    into U+00FF.
+*/
+struct QRegularExpressionSetPrivate : QSharedData
+{
+    struct Entry {
+        QRegularExpression regularExpression;
+        int minimumLength;
+        bool isValid;
+        bool hasStartBits;
+        bool hasRequiredBits;
+        uchar startBits[32];
+        uchar requiredBits[32];
+    };
+
+    void append(const QRegularExpression &re);
+    int match(const QString &subject, int subjectStart, int subjectLength,
+              QRegularExpression::MatchOptions matchOptions,
+              QVector<int> *matchingIndexes) const;
+
+    QVector<Entry> entries;
+};
+
+Q_DECLARE_TYPEINFO(QRegularExpressionSetPrivate::Entry, Q_MOVABLE_TYPE);
+
+/*!
+    \internal
+
+    Sets in \a bits the character \a c (that PCRE reports as the first or
+    the last required character of a pattern) and, for letters, its other
+    case, since we can't know whether it has to be matched case-insensitively.
+    Returns \c false if that can't be done reliably.
+*/
+static bool addPrefilterCharacter(uchar *bits, quint32 c)
+{
+    if (c > 0x7f) // the other case may be outside Latin-1, or vice versa
+        return false;
+
+    memset(bits, 0, 32);
+    bits[c / 8] |= 1 << (c & 7);
+    if ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') {
+        c ^= 0x20;
+        bits[c / 8] |= 1 << (c & 7);
+    }
+    return true;
+}
+
+static inline bool intersects(const uchar *bits1, const uchar *bits2)
+{
+    uchar result = 0;
+    for (int i = 0; i < 32; ++i)
+        result |= bits1[i] & bits2[i];
+    return result != 0;
+}
+
+/*!
+    \internal
+*/
+void QRegularExpressionSetPrivate::append(const QRegularExpression &re)
+{
+    Entry entry;
+    entry.regularExpression = re;
+    entry.minimumLength = 0;
+    entry.isValid = re.isValid(); // will compile the pattern
+    entry.hasStartBits = false;
+    entry.hasRequiredBits = false;
+
+    if (entry.isValid) {
+        // studying the pattern gives us the table of the starting characters
+        if (!(re.patternOptions() & QRegularExpression::DontAutomaticallyOptimizeOption))
+            re.optimize();
+
+        const QRegularExpressionPrivate *d = re.d.constData();
+        const pcre16 *code = d->compiledPattern;
+        const pcre16_extra *extra = d->studyData.loadAcquire();
+
+        unsigned long int options;
+        pcre16_fullinfo(code, 0, PCRE_INFO_OPTIONS, &options);
+
+        // (*NO_START_OPT) disables the very optimizations we rely upon
+        if (!(options & PCRE_NO_START_OPTIMIZE)) {
+            int minimumLength;
+            if (extra && pcre16_fullinfo(code, extra, PCRE_INFO_MINLENGTH, &minimumLength) == 0)
+                entry.minimumLength = qMax(minimumLength, 0);
+
+            int firstCharacterFlags;
+            pcre16_fullinfo(code, 0, PCRE_INFO_FIRSTCHARACTERFLAGS, &firstCharacterFlags);
+            if (firstCharacterFlags == 1) {
+                quint32 c;
+                pcre16_fullinfo(code, 0, PCRE_INFO_FIRSTCHARACTER, &c);
+                entry.hasStartBits = addPrefilterCharacter(entry.startBits, c);
+            } else if (extra) {
+                const uchar *table = 0;
+                pcre16_fullinfo(code, extra, PCRE_INFO_FIRSTTABLE, &table);
+                if (table) {
+                    memcpy(entry.startBits, table, sizeof(entry.startBits));
+                    entry.hasStartBits = true;
+                }
+            }
+
+            int requiredCharacterFlags;
+            pcre16_fullinfo(code, 0, PCRE_INFO_REQUIREDCHARFLAGS, &requiredCharacterFlags);
+            if (requiredCharacterFlags) {
+                quint32 c;
+                pcre16_fullinfo(code, 0, PCRE_INFO_REQUIREDCHAR, &c);
+                entry.hasRequiredBits = addPrefilterCharacter(entry.requiredBits, c);
+            }
+        }
+    }
+
+    entries.append(entry);
+}
+
+/*!
+    \internal
+
+    Matches all the regular expressions against the substring of \a subject
+    starting at \a subjectStart and \a subjectLength characters long. If \a
+    matchingIndexes is null, stops at the first one that matches and returns its
+    index (or -1); otherwise, appends the indexes of all of them to \a
+    matchingIndexes and returns the first one.
+
+    The subject string is scanned only once to collect the characters it
+    contains (and to check its UTF-16 validity); then PCRE is run only on the
+    regular expressions whose prefilter is satisfied.
+*/
+int QRegularExpressionSetPrivate::match(const QString &subject, int subjectStart, int subjectLength,
+                                        QRegularExpression::MatchOptions matchOptions,
+                                        QVector<int> *matchingIndexes) const
+{
+    uchar subjectBits[32];
+    memset(subjectBits, 0, sizeof(subjectBits));
+
+    bool isValidUtf16 = true;
+    const ushort *p = subject.utf16() + subjectStart;
+    const ushort * const end = p + subjectLength;
+    for (; p != end; ++p) {
+        ushort c = *p;
+        if (Q_UNLIKELY(QChar::isSurrogate(c))) {
+            if (QChar::isHighSurrogate(c) && p + 1 != end && QChar::isLowSurrogate(p[1]))
+                ++p;
+            else
+                isValidUtf16 = false;
+        }
+        if (c > 0xff)
+            c = 0xff;
+        subjectBits[c / 8] |= 1 << (c & 7);
+    }
+
+    QRegularExpressionPrivate::CheckSubjectStringOption checkSubjectStringOption =
+            QRegularExpressionPrivate::DontCheckSubjectString;
+    if (!isValidUtf16) {
+        // PCRE would refuse the subject anyhow
+        if (!(matchOptions & QRegularExpression::DontCheckSubjectStringMatchOption))
+            return -1;
+        checkSubjectStringOption = QRegularExpressionPrivate::CheckSubjectString;
+    }
+
+    int first = -1;
+    for (int i = 0; i < entries.size(); ++i) {
+        const Entry &entry = entries.at(i);
+        if (!entry.isValid
+                || subjectLength < entry.minimumLength
+                || (entry.hasStartBits && !intersects(entry.startBits, subjectBits))
+                || (entry.hasRequiredBits && !intersects(entry.requiredBits, subjectBits))) {
+            continue;
+        }
+
+        if (!entry.regularExpression.d->hasMatch(subject, subjectStart, subjectLength, 0,
+                                                 matchOptions, checkSubjectStringOption)) {
+            continue;
+        }
+
+        if (first < 0)
+            first = i;
+        if (!matchingIndexes)
+            break;
+        matchingIndexes->append(i);
+    }
+
+    return first;
+}
+
+/*!
+    Constructs an empty set of regular expressions.
+*/
+QRegularExpressionSet::QRegularExpressionSet()
+    : d(new QRegularExpressionSetPrivate)
+{
+}
+
+/*!
+    Constructs a set containing the regular expressions in \a expressions.
+*/
+QRegularExpressionSet::QRegularExpressionSet(const QVector<QRegularExpression> &expressions)
+    : d(new QRegularExpressionSetPrivate)
+{
+    d->entries.reserve(expressions.size());
+    for (const QRegularExpression &re : expressions)
+        d->append(re);
+}
+
+/*!
+    Constructs a set containing a regular expression for each pattern in
+    \a patterns, all of them using the pattern options \a options.
+*/
+QRegularExpressionSet::QRegularExpressionSet(const QStringList &patterns,
+                                             QRegularExpression::PatternOptions options)
+    : d(new QRegularExpressionSetPrivate)
+{
+    d->entries.reserve(patterns.size());
+    for (const QString &pattern : patterns)
+        d->append(QRegularExpression(pattern, options));
+}
+
+/*!
+    Destroys the set.
+*/
+QRegularExpressionSet::~QRegularExpressionSet()
+{
+}
+
+/*!
+    Constructs a set as a copy of \a other.
+*/
+QRegularExpressionSet::QRegularExpressionSet(const QRegularExpressionSet &other)
+    : d(other.d)
+{
+}
+
+/*!
+    Assigns the set \a other to this object, and returns a reference to the
+    copy.
+*/
+QRegularExpressionSet &QRegularExpressionSet::operator=(const QRegularExpressionSet &other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    \fn QRegularExpressionSet &QRegularExpressionSet::operator=(QRegularExpressionSet &&other)
+
+    Move-assigns the set \a other to this object, and returns a reference
+    to the copy.
+*/
+
+/*!
+    \fn void QRegularExpressionSet::swap(QRegularExpressionSet &other)
+
+    Swaps the set \a other with this set. This operation is very fast and
+    never fails.
+*/
+
+/*!
+    Returns \c true if the set contains no regular expressions.
+*/
+bool QRegularExpressionSet::isEmpty() const
+{
+    return d->entries.isEmpty();
+}
+
+/*!
+    Returns the number of regular expressions in the set.
+*/
+int QRegularExpressionSet::size() const
+{
+    return d->entries.size();
+}
+
+/*!
+    Returns the regular expression at index position \a i in the set.
+    \a i must be a valid index position (0 <= \a i < size()).
+*/
+QRegularExpression QRegularExpressionSet::at(int i) const
+{
+    return d->entries.at(i).regularExpression;
+}
+
+/*!
+    Returns all the regular expressions in the set, in the order they
+    were added.
+*/
+QVector<QRegularExpression> QRegularExpressionSet::expressions() const
+{
+    QVector<QRegularExpression> result;
+    result.reserve(d->entries.size());
+    for (const QRegularExpressionSetPrivate::Entry &entry : d->entries)
+        result.append(entry.regularExpression);
+    return result;
+}
+
+/*!
+    Appends the regular expression \a re to the set. Its index is the size
+    of the set before the call.
+
+    The pattern of \a re is compiled and, unless its pattern options contain
+    QRegularExpression::DontAutomaticallyOptimizeOption, optimized
+    immediately.
+*/
+void QRegularExpressionSet::append(const QRegularExpression &re)
+{
+    d->append(re);
+}
+
+/*!
+    Removes all the regular expressions from the set.
+*/
+void QRegularExpressionSet::clear()
+{
+    d->entries.clear();
+}
+
+/*!
+    Returns \c true if all the regular expressions in the set are valid.
+    Invalid regular expressions never match.
+
+    \sa QRegularExpression::isValid()
+*/
+bool QRegularExpressionSet::isValid() const
+{
+    for (const QRegularExpressionSetPrivate::Entry &entry : d->entries) {
+        if (!entry.isValid)
+            return false;
+    }
+    return true;
+}
+
+/*!
+    Returns the index of the first regular expression in the set that
+    matches the \a subject string, honoring the given \a matchOptions; returns
+    -1 if none does.
+
+    \sa matchingIndexes(), QRegularExpression::matches()
+*/
+int QRegularExpressionSet::firstMatchingIndex(const QString &subject,
+                                              QRegularExpression::MatchOptions matchOptions) const
+{
+    return d->match(subject, 0, subject.length(), matchOptions, Q_NULLPTR);
+}
+
+/*!
+    \overload
+
+    Returns the index of the first regular expression in the set that
+    matches the \a subjectRef string reference, honoring the given \a
+    matchOptions; returns -1 if none does.
+*/
+int QRegularExpressionSet::firstMatchingIndex(const QStringRef &subjectRef,
+                                              QRegularExpression::MatchOptions matchOptions) const
+{
+    const QString subject = subjectRef.string() ? *subjectRef.string() : QString();
+    return d->match(subject, subjectRef.position(), subjectRef.length(), matchOptions, Q_NULLPTR);
+}
+
+/*!
+    Returns the indexes of all the regular expressions in the set that
+    match the \a subject string, honoring the given \a matchOptions, in
+    increasing order.
+
+    \sa firstMatchingIndex(), QRegularExpression::matches()
+*/
+QVector<int> QRegularExpressionSet::matchingIndexes(const QString &subject,
+                                                    QRegularExpression::MatchOptions matchOptions) const
+{
+    QVector<int> result;
+    d->match(subject, 0, subject.length(), matchOptions, &result);
+    return result;
+}
+
+/*!
+    \overload
+
+    Returns the indexes of all the regular expressions in the set that
+    match the \a subjectRef string reference, honoring the given \a
+    matchOptions, in increasing order.
+*/
+QVector<int> QRegularExpressionSet::matchingIndexes(const QStringRef &subjectRef,
+                                                    QRegularExpression::MatchOptions matchOptions) const
+{
+    const QString subject = subjectRef.string() ? *subjectRef.string() : QString();
+    QVector<int> result;
+    d->match(subject, subjectRef.position(), subjectRef.length(), matchOptions, &result);
+    return result;
+}
+
 #ifndef QT_NO_DATASTREAM
 /*!
     \relates QRegularExpression
@@ -49,12 +49,14 @@
 #include <QtCore/qstringlist.h>
 #include <QtCore/qshareddata.h>
 #include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
 
 QT_BEGIN_NAMESPACE
 
 class QRegularExpressionMatch;
 class QRegularExpressionMatchIterator;
 struct QRegularExpressionPrivate;
+struct QRegularExpressionSetPrivate;
 class QRegularExpression;
 
 Q_CORE_EXPORT uint qHash(const QRegularExpression &key, uint seed = 0) Q_DECL_NOTHROW;
@@ -136,6 +138,54 @@ public:
                                                 MatchType matchType       = NormalMatch,
                                                 MatchOptions matchOptions = NoMatchOption) const;
 
+    bool match(QRegularExpressionMatch *result,
+               const QString &subject,
+               int offset                = 0,
+               MatchType matchType       = NormalMatch,
+               MatchOptions matchOptions = NoMatchOption) const;
+
+    bool match(QRegularExpressionMatch *result,
+               const QStringRef &subjectRef,
+               int offset                = 0,
+               MatchType matchType       = NormalMatch,
+               MatchOptions matchOptions = NoMatchOption) const;
+
+    bool matches(const QString &subject,
+                 int offset                = 0,
+                 MatchOptions matchOptions = NoMatchOption) const;
+
+    bool matches(const QStringRef &subjectRef,
+                 int offset                = 0,
+                 MatchOptions matchOptions = NoMatchOption) const;
+
+    QRegularExpressionMatch matchUtf8(const QByteArray &subject,
+                                      int offset                = 0,
+                                      MatchType matchType       = NormalMatch,
+                                      MatchOptions matchOptions = NoMatchOption) const;
+
+    QRegularExpressionMatch matchLatin1(const QByteArray &subject,
+                                        int offset                = 0,
+                                        MatchType matchType       = NormalMatch,
+                                        MatchOptions matchOptions = NoMatchOption) const;
+
+    QRegularExpressionMatchIterator globalMatchUtf8(const QByteArray &subject,
+                                                    int offset                = 0,
+                                                    MatchType matchType       = NormalMatch,
+                                                    MatchOptions matchOptions = NoMatchOption) const;
+
+    QRegularExpressionMatchIterator globalMatchLatin1(const QByteArray &subject,
+                                                      int offset                = 0,
+                                                      MatchType matchType       = NormalMatch,
+                                                      MatchOptions matchOptions = NoMatchOption) const;
+
+    bool matchesUtf8(const QByteArray &subject,
+                     int offset                = 0,
+                     MatchOptions matchOptions = NoMatchOption) const;
+
+    bool matchesLatin1(const QByteArray &subject,
+                       int offset                = 0,
+                       MatchOptions matchOptions = NoMatchOption) const;
+
     void optimize() const;
 
     static QString escape(const QString &str);
@@ -148,6 +198,7 @@ private:
     friend class QRegularExpressionMatch;
     friend struct QRegularExpressionMatchPrivate;
     friend class QRegularExpressionMatchIterator;
+    friend struct QRegularExpressionSetPrivate;
     friend Q_CORE_EXPORT uint qHash(const QRegularExpression &key, uint seed) Q_DECL_NOTHROW;
 
     QRegularExpression(QRegularExpressionPrivate &dd);
@@ -201,6 +252,9 @@ public:
     QString captured(const QString &name) const;
     QStringRef capturedRef(const QString &name) const;
 
+    QByteArray capturedBytes(int nth = 0) const;
+    QByteArray capturedBytes(const QString &name) const;
+
     QStringList capturedTexts() const;
 
     int capturedStart(int nth = 0) const;
@@ -260,6 +314,47 @@ private:
 
 Q_DECLARE_SHARED(QRegularExpressionMatchIterator)
 
+class Q_CORE_EXPORT QRegularExpressionSet
+{
+public:
+    QRegularExpressionSet();
+    explicit QRegularExpressionSet(const QVector<QRegularExpression> &expressions);
+    explicit QRegularExpressionSet(const QStringList &patterns,
+                                   QRegularExpression::PatternOptions options = QRegularExpression::NoPatternOption);
+    ~QRegularExpressionSet();
+    QRegularExpressionSet(const QRegularExpressionSet &other);
+    QRegularExpressionSet &operator=(const QRegularExpressionSet &other);
+#ifdef Q_COMPILER_RVALUE_REFS
+    QRegularExpressionSet &operator=(QRegularExpressionSet &&other) Q_DECL_NOTHROW
+    { d.swap(other.d); return *this; }
+#endif
+    void swap(QRegularExpressionSet &other) Q_DECL_NOTHROW { d.swap(other.d); }
+
+    bool isEmpty() const;
+    int size() const;
+    QRegularExpression at(int i) const;
+    QVector<QRegularExpression> expressions() const;
+    void append(const QRegularExpression &re);
+    void clear();
+
+    bool isValid() const;
+
+    int firstMatchingIndex(const QString &subject,
+                           QRegularExpression::MatchOptions matchOptions = QRegularExpression::NoMatchOption) const;
+    int firstMatchingIndex(const QStringRef &subjectRef,
+                           QRegularExpression::MatchOptions matchOptions = QRegularExpression::NoMatchOption) const;
+
+    QVector<int> matchingIndexes(const QString &subject,
+                                 QRegularExpression::MatchOptions matchOptions = QRegularExpression::NoMatchOption) const;
+    QVector<int> matchingIndexes(const QStringRef &subjectRef,
+                                 QRegularExpression::MatchOptions matchOptions = QRegularExpression::NoMatchOption) const;
+
+private:
+    QSharedDataPointer<QRegularExpressionSetPrivate> d;
+};
+
+Q_DECLARE_SHARED(QRegularExpressionSet)
+
 QT_END_NAMESPACE
 
 #endif // QT_NO_REGULAREXPRESSION
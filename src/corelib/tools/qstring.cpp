@@ -3078,6 +3078,12 @@ int qFindString(
     if (sl == 1)
         return findChar(haystack0, haystackLen, needle0[0], from, cs);
 
+    if (sl <= FirstLastMaxNeedleLength
+            && fl_applicable(reinterpret_cast<const ushort *>(needle0), sl, cs)) {
+        return fl_find(reinterpret_cast<const ushort *>(haystack0), l, from,
+                       reinterpret_cast<const ushort *>(needle0), sl, cs);
+    }
+
     /*
         We use the Boyer-Moore algorithm in cases where the overhead
         for the skip table should pay off, otherwise we use a simple
@@ -6260,6 +6266,37 @@ qint64 QString::toLongLong(bool *ok, int base) const
     return toIntegral_helper<qlonglong>(constData(), size(), ok, base);
 }
 
+/*
+    Numbers in the C locale mostly consist of ASCII digits, signs, the decimal
+    point and the exponent only. For those QLocaleData::numberToCLocale() does
+    nothing but trim whitespace and lower-case 'E', so they can be narrowed
+    directly into \a out. Returns the length, or -1 if the general conversion
+    is needed.
+*/
+static int asciiNumberToCLocale(const QChar *data, int len, char *out, int outSize)
+{
+    int begin = 0;
+    while (begin < len && data[begin].unicode() < 128 && ascii_isspace(data[begin].unicode()))
+        ++begin;
+    while (len > begin && data[len - 1].unicode() < 128 && ascii_isspace(data[len - 1].unicode()))
+        --len;
+    const int size = len - begin;
+    if (size <= 0 || size >= outSize)
+        return -1;
+
+    for (int i = 0; i < size; ++i) {
+        const ushort c = data[begin + i].unicode();
+        if ((c >= '0' && c <= '9') || c == '+' || c == '-' || c == '.' || c == 'e')
+            out[i] = char(c);
+        else if (c == 'E')
+            out[i] = 'e';
+        else
+            return -1;
+    }
+    out[size] = '\0';
+    return size;
+}
+
 qlonglong QString::toIntegral_helper(const QChar *data, int len, bool *ok, int base)
 {
 #if defined(QT_CHECK_RANGE)
@@ -6269,6 +6306,19 @@ qlonglong QString::toIntegral_helper(const QChar *data, int len, bool *ok, int b
     }
 #endif
 
+    if (base == 10) {
+        char buf[64];
+        const int size = asciiNumberToCLocale(data, len, buf, sizeof(buf));
+        bool fastOk = false;
+        int processed;
+        const qlonglong value = size < 0 ? 0 : asciiToLongLong(buf, size, fastOk, processed);
+        if (fastOk) {
+            if (ok)
+                *ok = true;
+            return value;
+        }
+    }
+
     return QLocaleData::c()->stringToLongLong(data, len, base, ok, QLocale::RejectGroupSeparator);
 }
 
@@ -6309,6 +6359,19 @@ qulonglong QString::toIntegral_helper(const QChar *data, uint len, bool *ok, int
     }
 #endif
 
+    if (base == 10) {
+        char buf[64];
+        const int size = asciiNumberToCLocale(data, len, buf, sizeof(buf));
+        bool fastOk = false;
+        int processed;
+        const qulonglong value = size < 0 ? 0 : asciiToULongLong(buf, size, fastOk, processed);
+        if (fastOk) {
+            if (ok)
+                *ok = true;
+            return value;
+        }
+    }
+
     return QLocaleData::c()->stringToUnsLongLong(data, len, base, ok,
                                                  QLocale::RejectGroupSeparator);
 }
@@ -6511,6 +6574,16 @@ ushort QString::toUShort(bool *ok, int base) const
 
 double QString::toDouble(bool *ok) const
 {
+    char buf[64];
+    const int length = asciiNumberToCLocale(constData(), size(), buf, sizeof(buf));
+    if (length >= 0) {
+        bool nonNullOk = false;
+        int processed = 0;
+        const double d = asciiToDouble(buf, length, nonNullOk, processed);
+        if (ok)
+            *ok = nonNullOk;
+        return d;
+    }
     return QLocaleData::c()->stringToDouble(constData(), size(), ok, QLocale::RejectGroupSeparator);
 }
 
@@ -6743,6 +6816,10 @@ QString QString::number(double n, char f, int prec)
             break;
     }
 
+    char buf[64];
+    const int length = doubleToAsciiString(n, form, prec, flags, buf, sizeof(buf));
+    if (length >= 0)
+        return QString::fromLatin1(buf, length);
     return QLocaleData::c()->doubleToString(n, prec, form, -1, flags);
 }
 
@@ -10089,6 +10166,14 @@ static inline int qt_string_count(const QChar *unicode, int size, QChar ch,
     const ushort *b = reinterpret_cast<const ushort*>(unicode);
     const ushort *i = b + size;
     if (cs == Qt::CaseSensitive) {
+#ifdef __SSE2__
+        const __m128i mch = _mm_set1_epi16(c);
+        for ( ; b + 8 <= i; b += 8) {
+            const __m128i data = _mm_loadu_si128((const __m128i *)b);
+            // two bits per matching character
+            num += qPopulationCount(uint(_mm_movemask_epi8(_mm_cmpeq_epi16(data, mch)))) / 2;
+        }
+#endif
         while (i != b)
             if (*--i == c)
                 ++num;
@@ -120,6 +120,140 @@ static inline int bm_find(const ushort *uc, uint l, int index, const ushort *puc
     return -1; // not found
 }
 
+/*
+    Needles longer than this are searched for with Boyer-Moore, whose skips
+    then pay off; shorter ones with fl_find().
+*/
+enum { FirstLastMaxNeedleLength = 64 };
+
+/*
+    Returns true if fl_find() can search for the \a pl characters long
+    needle \a puc. For case insensitive searches, the first and the last
+    characters of the needle must be ASCII.
+*/
+static inline bool fl_applicable(const ushort *puc, uint pl, Qt::CaseSensitivity cs)
+{
+    if (pl < 2)
+        return false;
+    return cs == Qt::CaseSensitive || (puc[0] < 0x80 && puc[pl - 1] < 0x80);
+}
+
+/*
+    Returns true if \a c is a possible first (or last) character of a case
+    insensitive match for \a p, which is ASCII: the case folding of ASCII
+    characters doesn't leave ASCII, and a non-ASCII character may fold to an
+    ASCII one (e.g. U+212A KELVIN SIGN), so it can't be excluded without
+    folding it.
+*/
+static inline bool fl_ci_candidate(ushort c, ushort p)
+{
+    return c >= 0x80 || (c | 0x20) == (p | 0x20);
+}
+
+/*
+    Searches for the needle \a puc (\a pl characters) in \a uc (\a l
+    characters), starting at \a index, by comparing the first and the last
+    character of the needle with several positions of the haystack at
+    once; only where both match, the rest of the needle is compared. This
+    needs no setup and, as the first and the last character rarely match
+    together by chance, beats Boyer-Moore for short and medium needles.
+
+    fl_applicable() must be true for the needle.
+*/
+static int fl_find(const ushort *uc, uint l, int index, const ushort *puc, uint pl,
+                   Qt::CaseSensitivity cs)
+{
+    Q_ASSERT(fl_applicable(puc, pl, cs));
+    if (index < 0 || uint(index) + pl > l)
+        return -1;
+
+    const uint pl_minus_one = pl - 1;
+    const ushort first = puc[0];
+    const ushort last = puc[pl_minus_one];
+    const ushort *current = uc + index;
+    const ushort * const end = uc + l - pl_minus_one; // one past the last possible match
+
+    if (cs == Qt::CaseSensitive) {
+        const auto matchesAt = [=](const ushort *p) {
+            return memcmp(p + 1, puc + 1, (pl - 2) * sizeof(ushort)) == 0;
+        };
+#ifdef __SSE2__
+        const __m128i vfirst = _mm_set1_epi16(first);
+        const __m128i vlast = _mm_set1_epi16(last);
+
+        // we're going to read current[0..7] and current[pl - 1 .. pl + 6]
+        for ( ; current + 8 <= end; current += 8) {
+            const __m128i f = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i *)current), vfirst);
+            const __m128i b = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i *)(current + pl_minus_one)), vlast);
+            uint mask = _mm_movemask_epi8(_mm_and_si128(f, b));
+            while (mask) {
+                // two bits per character
+                const uint i = qCountTrailingZeroBits(mask) / 2;
+                if (matchesAt(current + i))
+                    return current + i - uc;
+                mask &= ~(3U << (i * 2));
+            }
+        }
+#endif
+        for ( ; current < end; ++current) {
+            if (*current == first && current[pl_minus_one] == last && matchesAt(current))
+                return current - uc;
+        }
+    } else {
+        const auto matchesAt = [=](const ushort *p) {
+            for (uint i = 0; i < pl; ++i) {
+                if (foldCase(p + i, uc) != foldCase(puc + i, puc))
+                    return false;
+            }
+            return true;
+        };
+#ifdef __SSE2__
+        const __m128i vfirst = _mm_set1_epi16(first | 0x20);
+        const __m128i vlast = _mm_set1_epi16(last | 0x20);
+        const __m128i v20 = _mm_set1_epi16(0x20);
+        const __m128i nonAsciiBits = _mm_set1_epi16(short(0xff80));
+        const __m128i zero = _mm_setzero_si128();
+
+        // lanes that are ASCII and don't fold to the needle character
+        const auto rejected = [=](__m128i data, __m128i p) {
+            const __m128i isAscii = _mm_cmpeq_epi16(_mm_and_si128(data, nonAsciiBits), zero);
+            const __m128i isEqual = _mm_cmpeq_epi16(_mm_or_si128(data, v20), p);
+            return _mm_andnot_si128(isEqual, isAscii);
+        };
+
+        for ( ; current + 8 <= end; current += 8) {
+            const __m128i f = rejected(_mm_loadu_si128((const __m128i *)current), vfirst);
+            const __m128i b = rejected(_mm_loadu_si128((const __m128i *)(current + pl_minus_one)), vlast);
+            uint mask = ~_mm_movemask_epi8(_mm_or_si128(f, b)) & 0xffff;
+            while (mask) {
+                const uint i = qCountTrailingZeroBits(mask) / 2;
+                if (matchesAt(current + i))
+                    return current + i - uc;
+                mask &= ~(3U << (i * 2));
+            }
+        }
+#endif
+        for ( ; current < end; ++current) {
+            if (fl_ci_candidate(*current, first) && fl_ci_candidate(current[pl_minus_one], last)
+                    && matchesAt(current)) {
+                return current - uc;
+            }
+        }
+    }
+    return -1; // not found
+}
+
+/*
+    Searches with fl_find() or bm_find(), whichever is faster for the needle.
+*/
+static inline int qt_find(const ushort *uc, uint l, int index, const ushort *puc, uint pl,
+                          const uchar *skiptable, Qt::CaseSensitivity cs)
+{
+    if (pl <= FirstLastMaxNeedleLength && fl_applicable(puc, pl, cs))
+        return fl_find(uc, l, index, puc, pl, cs);
+    return bm_find(uc, l, index, puc, pl, skiptable, cs);
+}
+
 /*!
     \class QStringMatcher
     \inmodule QtCore
@@ -269,7 +403,7 @@ int QStringMatcher::indexIn(const QString &str, int from) const
 {
     if (from < 0)
         from = 0;
-    return bm_find((const ushort *)str.unicode(), str.size(), from,
+    return qt_find((const ushort *)str.unicode(), str.size(), from,
                    (const ushort *)p.uc, p.len,
                    p.q_skiptable, q_cs);
 }
@@ -290,7 +424,7 @@ int QStringMatcher::indexIn(const QChar *str, int length, int from) const
 {
     if (from < 0)
         from = 0;
-    return bm_find((const ushort *)str, length, from,
+    return qt_find((const ushort *)str, length, from,
                    (const ushort *)p.uc, p.len,
                    p.q_skiptable, q_cs);
 }
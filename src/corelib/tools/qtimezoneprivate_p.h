@@ -55,6 +55,7 @@
 #include "qtimezone.h"
 #include "qlocale_p.h"
 #include "qvector.h"
+#include "qsharedpointer.h"
 
 #ifdef QT_USE_ICU
 #include <unicode/ucal.h>
@@ -289,6 +290,8 @@ Q_DECL_CONSTEXPR inline bool operator==(const QTzTransitionRule &lhs, const QTzT
 Q_DECL_CONSTEXPR inline bool operator!=(const QTzTransitionRule &lhs, const QTzTransitionRule &rhs) Q_DECL_NOTHROW
 { return !operator==(lhs, rhs); }
 
+struct QTzTimeZoneCacheEntry;
+
 class Q_AUTOTEST_EXPORT QTzTimeZonePrivate Q_DECL_FINAL : public QTimeZonePrivate
 {
 public:
@@ -334,13 +337,16 @@ private:
     void init(const QByteArray &ianaId);
 
     Data dataForTzTransition(QTzTransitionTime tran) const;
-    QVector<QTzTransitionTime> m_tranTimes;
-    QVector<QTzTransitionRule> m_tranRules;
-    QList<QByteArray> m_abbreviations;
+    int transitionIndex(qint64 atMSecsSinceEpoch) const;
+    QVector<Data> posixTransitions(qint64 atMSecsSinceEpoch) const;
+
+    // The parsed tz file, shared by all instances for the same zone
+    QSharedPointer<QTzTimeZoneCacheEntry> m_data;
+    // Index of the transition last looked up, most lookups are close to it
+    mutable QAtomicInt m_lastTransition;
 #ifdef QT_USE_ICU
     mutable QSharedDataPointer<QTimeZonePrivate> m_icu;
 #endif // QT_USE_ICU
-    QByteArray m_posixRule;
 };
 #endif // Q_OS_UNIX
 
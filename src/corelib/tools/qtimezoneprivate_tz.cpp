@@ -44,10 +44,12 @@
 #include <QtCore/QHash>
 #include <QtCore/QDataStream>
 #include <QtCore/QDateTime>
+#include <QtCore/QMutex>
 
 #include <qdebug.h>
 
 #include <algorithm>
+#include <limits>
 
 QT_BEGIN_NAMESPACE
 
@@ -520,120 +522,93 @@ static QVector<QTimeZonePrivate::Data> calculatePosixTransitions(const QByteArra
     return result;
 }
 
-// Create the system default time zone
-QTzTimeZonePrivate::QTzTimeZonePrivate()
-#ifdef QT_USE_ICU
-    : m_icu(0)
-#endif // QT_USE_ICU
-{
-    init(systemTimeZoneId());
-}
-
-// Create a named time zone
-QTzTimeZonePrivate::QTzTimeZonePrivate(const QByteArray &ianaId)
-#ifdef QT_USE_ICU
-    : m_icu(0)
-#endif // QT_USE_ICU
+/*
+    Parsed tz files are shared by all QTzTimeZonePrivate instances of the
+    same zone, so that creating a QTimeZone does not read the file again.
+*/
+struct QTzTimeZoneCacheEntry
 {
-    init(ianaId);
-}
+    QTzTimeZoneCacheEntry() : hasDaylightTime(false) { }
 
-QTzTimeZonePrivate::QTzTimeZonePrivate(const QTzTimeZonePrivate &other)
-                  : QTimeZonePrivate(other), m_tranTimes(other.m_tranTimes),
-                    m_tranRules(other.m_tranRules), m_abbreviations(other.m_abbreviations),
-#ifdef QT_USE_ICU
-                    m_icu(other.m_icu),
-#endif // QT_USE_ICU
-                    m_posixRule(other.m_posixRule)
-{
-}
+    QVector<QTzTransitionTime> tranTimes;
+    QVector<QTzTransitionRule> tranRules;
+    QVector<QString> abbreviations;
+    QByteArray posixRule;
+    bool hasDaylightTime;
 
-QTzTimeZonePrivate::~QTzTimeZonePrivate()
-{
-}
+    // Transitions calculated from the POSIX rule, by year
+    QMutex posixMutex;
+    QHash<int, QVector<QTimeZonePrivate::Data> > posixTransitions;
+};
 
-QTimeZonePrivate *QTzTimeZonePrivate::clone()
+struct QTzTimeZoneCache
 {
-    return new QTzTimeZonePrivate(*this);
-}
+    QMutex mutex;
+    QHash<QByteArray, QSharedPointer<QTzTimeZoneCacheEntry> > zones;
+};
+Q_GLOBAL_STATIC(QTzTimeZoneCache, tzZoneCache)
 
-void QTzTimeZonePrivate::init(const QByteArray &ianaId)
+static QSharedPointer<QTzTimeZoneCacheEntry> parseTzFile(QIODevice *tzif)
 {
-    QFile tzif;
-    if (ianaId.isEmpty()) {
-        // Open system tz
-        tzif.setFileName(QStringLiteral("/etc/localtime"));
-        if (!tzif.open(QIODevice::ReadOnly))
-            return;
-    } else {
-        // Open named tz, try modern path first, if fails try legacy path
-        tzif.setFileName(QLatin1String("/usr/share/zoneinfo/") + QString::fromLocal8Bit(ianaId));
-        if (!tzif.open(QIODevice::ReadOnly)) {
-            tzif.setFileName(QLatin1String("/usr/lib/zoneinfo/") + QString::fromLocal8Bit(ianaId));
-            if (!tzif.open(QIODevice::ReadOnly))
-                return;
-        }
-    }
-
-    QDataStream ds(&tzif);
+    QDataStream ds(tzif);
 
     // Parse the old version block of data
     bool ok = false;
     QTzHeader hdr = parseTzHeader(ds, &ok);
     if (!ok || ds.status() != QDataStream::Ok)
-        return;
+        return QSharedPointer<QTzTimeZoneCacheEntry>();
+    QSharedPointer<QTzTimeZoneCacheEntry> zone = QSharedPointer<QTzTimeZoneCacheEntry>::create();
     QVector<QTzTransition> tranList = parseTzTransitions(ds, hdr.tzh_timecnt, false);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return QSharedPointer<QTzTimeZoneCacheEntry>();
     QVector<QTzType> typeList = parseTzTypes(ds, hdr.tzh_typecnt);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return QSharedPointer<QTzTimeZoneCacheEntry>();
     QMap<int, QByteArray> abbrevMap = parseTzAbbreviations(ds, hdr.tzh_charcnt, typeList);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return QSharedPointer<QTzTimeZoneCacheEntry>();
     parseTzLeapSeconds(ds, hdr.tzh_leapcnt, false);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return QSharedPointer<QTzTimeZoneCacheEntry>();
     typeList = parseTzIndicators(ds, typeList, hdr.tzh_ttisstdcnt, hdr.tzh_ttisgmtcnt);
     if (ds.status() != QDataStream::Ok)
-        return;
+        return QSharedPointer<QTzTimeZoneCacheEntry>();
 
     // If version 2 then parse the second block of data
     if (hdr.tzh_version == '2' || hdr.tzh_version == '3') {
         ok = false;
         QTzHeader hdr2 = parseTzHeader(ds, &ok);
         if (!ok || ds.status() != QDataStream::Ok)
-            return;
+            return QSharedPointer<QTzTimeZoneCacheEntry>();
         tranList = parseTzTransitions(ds, hdr2.tzh_timecnt, true);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return QSharedPointer<QTzTimeZoneCacheEntry>();
         typeList = parseTzTypes(ds, hdr2.tzh_typecnt);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return QSharedPointer<QTzTimeZoneCacheEntry>();
         abbrevMap = parseTzAbbreviations(ds, hdr2.tzh_charcnt, typeList);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return QSharedPointer<QTzTimeZoneCacheEntry>();
         parseTzLeapSeconds(ds, hdr2.tzh_leapcnt, true);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return QSharedPointer<QTzTimeZoneCacheEntry>();
         typeList = parseTzIndicators(ds, typeList, hdr2.tzh_ttisstdcnt, hdr2.tzh_ttisgmtcnt);
         if (ds.status() != QDataStream::Ok)
-            return;
-        m_posixRule = parseTzPosixRule(ds);
+            return QSharedPointer<QTzTimeZoneCacheEntry>();
+        zone->posixRule = parseTzPosixRule(ds);
         if (ds.status() != QDataStream::Ok)
-            return;
+            return QSharedPointer<QTzTimeZoneCacheEntry>();
     }
 
     // Translate the TZ file into internal format
 
     // Translate the array index based tz_abbrind into list index
     const int size = abbrevMap.size();
-    m_abbreviations.clear();
-    m_abbreviations.reserve(size);
+    zone->abbreviations.reserve(size);
     QVector<int> abbrindList;
     abbrindList.reserve(size);
     for (auto it = abbrevMap.cbegin(), end = abbrevMap.cend(); it != end; ++it) {
-        m_abbreviations.append(it.value());
+        zone->abbreviations.append(QString::fromUtf8(it.value()));
         abbrindList.append(it.key());
     }
     for (int i = 0; i < typeList.size(); ++i)
@@ -650,7 +625,7 @@ void QTzTimeZonePrivate::init(const QByteArray &ianaId)
     }
 
     // Now for each transition time calculate our rule and save them
-    m_tranTimes.reserve(tranList.count());
+    zone->tranTimes.reserve(tranList.count());
     for (const QTzTransition &tz_tran : qAsConst(tranList)) {
         QTzTransitionTime tran;
         QTzTransitionRule rule;
@@ -663,10 +638,12 @@ void QTzTimeZonePrivate::init(const QByteArray &ianaId)
         rule.dstOffset = tz_type.tz_gmtoff - utcOffset;
         rule.abbreviationIndex = tz_type.tz_abbrind;
         // If the rule already exist then use that, otherwise add it
-        int ruleIndex = m_tranRules.indexOf(rule);
+        int ruleIndex = zone->tranRules.indexOf(rule);
         if (ruleIndex == -1) {
-            m_tranRules.append(rule);
-            tran.ruleIndex = m_tranRules.size() - 1;
+            zone->tranRules.append(rule);
+            tran.ruleIndex = zone->tranRules.size() - 1;
+            if (rule.dstOffset != 0)
+                zone->hasDaylightTime = true;
         } else {
             tran.ruleIndex = ruleIndex;
         }
@@ -679,7 +656,79 @@ void QTzTimeZonePrivate::init(const QByteArray &ianaId)
         else
             tran.atMSecsSinceEpoch = tz_tran.tz_time * 1000;
 
-        m_tranTimes.append(tran);
+        zone->tranTimes.append(tran);
+    }
+    return zone;
+}
+
+// Create the system default time zone
+QTzTimeZonePrivate::QTzTimeZonePrivate()
+    : m_lastTransition(0)
+#ifdef QT_USE_ICU
+    , m_icu(0)
+#endif // QT_USE_ICU
+{
+    init(systemTimeZoneId());
+}
+
+// Create a named time zone
+QTzTimeZonePrivate::QTzTimeZonePrivate(const QByteArray &ianaId)
+    : m_lastTransition(0)
+#ifdef QT_USE_ICU
+    , m_icu(0)
+#endif // QT_USE_ICU
+{
+    init(ianaId);
+}
+
+QTzTimeZonePrivate::QTzTimeZonePrivate(const QTzTimeZonePrivate &other)
+                  : QTimeZonePrivate(other), m_data(other.m_data),
+                    m_lastTransition(other.m_lastTransition.load())
+#ifdef QT_USE_ICU
+                    , m_icu(other.m_icu)
+#endif // QT_USE_ICU
+{
+}
+
+QTzTimeZonePrivate::~QTzTimeZonePrivate()
+{
+}
+
+QTimeZonePrivate *QTzTimeZonePrivate::clone()
+{
+    return new QTzTimeZonePrivate(*this);
+}
+
+void QTzTimeZonePrivate::init(const QByteArray &ianaId)
+{
+    // The system zone is not shared, /etc/localtime may change at any time
+    QTzTimeZoneCache *cache = ianaId.isEmpty() ? 0 : tzZoneCache();
+    if (cache) {
+        QMutexLocker locker(&cache->mutex);
+        m_data = cache->zones.value(ianaId);
+    }
+
+    if (!m_data) {
+        QFile tzif;
+        if (ianaId.isEmpty()) {
+            // Open system tz
+            tzif.setFileName(QStringLiteral("/etc/localtime"));
+        } else {
+            // Open named tz, try modern path first, if fails try legacy path
+            tzif.setFileName(QLatin1String("/usr/share/zoneinfo/") + QString::fromLocal8Bit(ianaId));
+            if (!tzif.open(QIODevice::ReadOnly))
+                tzif.setFileName(QLatin1String("/usr/lib/zoneinfo/") + QString::fromLocal8Bit(ianaId));
+        }
+        if (tzif.isOpen() || tzif.open(QIODevice::ReadOnly))
+            m_data = parseTzFile(&tzif);
+        if (!m_data) {
+            m_data = QSharedPointer<QTzTimeZoneCacheEntry>::create();
+            return;
+        }
+        if (cache) {
+            QMutexLocker locker(&cache->mutex);
+            cache->zones.insert(ianaId, m_data);
+        }
     }
 
     if (ianaId.isEmpty())
@@ -765,9 +814,10 @@ QString QTzTimeZonePrivate::displayName(QTimeZone::TimeType timeType,
     }
 
     // Otherwise is strange sequence, so work backwards through trans looking for first match, if any
-    for (int i = m_tranTimes.size() - 1; i >= 0; --i) {
-        if (m_tranTimes.at(i).atMSecsSinceEpoch <= currentMSecs) {
-            tran = dataForTzTransition(m_tranTimes.at(i));
+    const QVector<QTzTransitionTime> &tranTimes = m_data->tranTimes;
+    for (int i = tranTimes.size() - 1; i >= 0; --i) {
+        if (tranTimes.at(i).atMSecsSinceEpoch <= currentMSecs) {
+            tran = dataForTzTransition(tranTimes.at(i));
             if ((timeType == QTimeZone::DaylightTime && tran.daylightTimeOffset != 0)
                 || (timeType == QTimeZone::StandardTime && tran.daylightTimeOffset == 0)) {
                 return tran.abbreviation;
@@ -802,12 +852,7 @@ int QTzTimeZonePrivate::daylightTimeOffset(qint64 atMSecsSinceEpoch) const
 
 bool QTzTimeZonePrivate::hasDaylightTime() const
 {
-    // TODO Perhaps cache as frequently accessed?
-    for (const QTzTransitionRule &rule : m_tranRules) {
-        if (rule.dstOffset != 0)
-            return true;
-    }
-    return false;
+    return m_data->hasDaylightTime;
 }
 
 bool QTzTimeZonePrivate::isDaylightTime(qint64 atMSecsSinceEpoch) const
@@ -819,23 +864,63 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::dataForTzTransition(QTzTransitionTime
 {
     QTimeZonePrivate::Data data;
     data.atMSecsSinceEpoch = tran.atMSecsSinceEpoch;
-    QTzTransitionRule rule = m_tranRules.at(tran.ruleIndex);
+    const QTzTransitionRule rule = m_data->tranRules.at(tran.ruleIndex);
     data.standardTimeOffset = rule.stdOffset;
     data.daylightTimeOffset = rule.dstOffset;
     data.offsetFromUtc = rule.stdOffset + rule.dstOffset;
-    data.abbreviation = QString::fromUtf8(m_abbreviations.at(rule.abbreviationIndex));
+    data.abbreviation = m_data->abbreviations.at(rule.abbreviationIndex);
     return data;
 }
 
+// Returns the index of the last transition at or before the given time, or -1
+int QTzTimeZonePrivate::transitionIndex(qint64 atMSecsSinceEpoch) const
+{
+    const QVector<QTzTransitionTime> &tranTimes = m_data->tranTimes;
+    const int size = tranTimes.size();
+    const int last = m_lastTransition.load();
+    if (last >= 0 && last < size && tranTimes.at(last).atMSecsSinceEpoch <= atMSecsSinceEpoch
+        && (last + 1 == size || atMSecsSinceEpoch < tranTimes.at(last + 1).atMSecsSinceEpoch)) {
+        return last;
+    }
+
+    const auto it = std::upper_bound(tranTimes.cbegin(), tranTimes.cend(), atMSecsSinceEpoch,
+                                     [](qint64 msecs, const QTzTransitionTime &tran) {
+                                         return msecs < tran.atMSecsSinceEpoch;
+                                     });
+    const int index = int(it - tranTimes.cbegin()) - 1;
+    m_lastTransition.store(index);
+    return index;
+}
+
+// Returns the transitions from the POSIX rule around the year of the given time
+QVector<QTimeZonePrivate::Data> QTzTimeZonePrivate::posixTransitions(qint64 atMSecsSinceEpoch) const
+{
+    const int year = QDateTime::fromMSecsSinceEpoch(atMSecsSinceEpoch, Qt::UTC).date().year();
+    {
+        QMutexLocker locker(&m_data->posixMutex);
+        const auto it = m_data->posixTransitions.constFind(year);
+        if (it != m_data->posixTransitions.cend())
+            return it.value();
+    }
+
+    const int lastMSecs = (m_data->tranTimes.size() > 0) ? m_data->tranTimes.last().atMSecsSinceEpoch : 0;
+    const QVector<QTimeZonePrivate::Data> result = calculatePosixTransitions(m_data->posixRule, year - 1,
+                                                                             year + 1, lastMSecs);
+    QMutexLocker locker(&m_data->posixMutex);
+    if (m_data->posixTransitions.size() >= 1024)
+        m_data->posixTransitions.clear();
+    m_data->posixTransitions.insert(year, result);
+    return result;
+}
+
 QTimeZonePrivate::Data QTzTimeZonePrivate::data(qint64 forMSecsSinceEpoch) const
 {
+    const QVector<QTzTransitionTime> &tranTimes = m_data->tranTimes;
+
     // If the required time is after the last transition and we have a POSIX rule then use it
-    if (m_tranTimes.size() > 0 && m_tranTimes.last().atMSecsSinceEpoch < forMSecsSinceEpoch
-        &&!m_posixRule.isEmpty() && forMSecsSinceEpoch >= 0) {
-        const int year = QDateTime::fromMSecsSinceEpoch(forMSecsSinceEpoch, Qt::UTC).date().year();
-        const int lastMSecs = (m_tranTimes.size() > 0) ? m_tranTimes.last().atMSecsSinceEpoch : 0;
-        QVector<QTimeZonePrivate::Data> posixTrans = calculatePosixTransitions(m_posixRule, year - 1,
-                                                                               year + 1, lastMSecs);
+    if (tranTimes.size() > 0 && tranTimes.last().atMSecsSinceEpoch < forMSecsSinceEpoch
+        && !m_data->posixRule.isEmpty() && forMSecsSinceEpoch >= 0) {
+        const QVector<QTimeZonePrivate::Data> posixTrans = posixTransitions(forMSecsSinceEpoch);
         for (int i = posixTrans.size() - 1; i >= 0; --i) {
             if (posixTrans.at(i).atMSecsSinceEpoch <= forMSecsSinceEpoch) {
                 QTimeZonePrivate::Data data;
@@ -846,18 +931,11 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::data(qint64 forMSecsSinceEpoch) const
         }
     }
 
-    // Otherwise if we can find a valid tran then use its rule
-    for (int i = m_tranTimes.size() - 1; i >= 0; --i) {
-        if (m_tranTimes.at(i).atMSecsSinceEpoch <= forMSecsSinceEpoch) {
-            Data data = dataForTzTransition(m_tranTimes.at(i));
-            data.atMSecsSinceEpoch = forMSecsSinceEpoch;
-            return data;
-        }
-    }
-
-    // Otherwise use the earliest transition we have
-    if (m_tranTimes.size() > 0) {
-        Data data = dataForTzTransition(m_tranTimes.at(0));
+    // Otherwise if we can find a valid tran then use its rule,
+    // otherwise use the earliest transition we have
+    if (tranTimes.size() > 0) {
+        const int index = transitionIndex(forMSecsSinceEpoch);
+        Data data = dataForTzTransition(tranTimes.at(qMax(index, 0)));
         data.atMSecsSinceEpoch = forMSecsSinceEpoch;
         return data;
     }
@@ -873,13 +951,12 @@ bool QTzTimeZonePrivate::hasTransitions() const
 
 QTimeZonePrivate::Data QTzTimeZonePrivate::nextTransition(qint64 afterMSecsSinceEpoch) const
 {
+    const QVector<QTzTransitionTime> &tranTimes = m_data->tranTimes;
+
     // If the required time is after the last transition and we have a POSIX rule then use it
-    if (m_tranTimes.size() > 0 && m_tranTimes.last().atMSecsSinceEpoch < afterMSecsSinceEpoch
-        &&!m_posixRule.isEmpty() && afterMSecsSinceEpoch >= 0) {
-        const int year = QDateTime::fromMSecsSinceEpoch(afterMSecsSinceEpoch, Qt::UTC).date().year();
-        const int lastMSecs = (m_tranTimes.size() > 0) ? m_tranTimes.last().atMSecsSinceEpoch : 0;
-        QVector<QTimeZonePrivate::Data> posixTrans = calculatePosixTransitions(m_posixRule, year - 1,
-                                                                               year + 1, lastMSecs);
+    if (tranTimes.size() > 0 && tranTimes.last().atMSecsSinceEpoch < afterMSecsSinceEpoch
+        && !m_data->posixRule.isEmpty() && afterMSecsSinceEpoch >= 0) {
+        const QVector<QTimeZonePrivate::Data> posixTrans = posixTransitions(afterMSecsSinceEpoch);
         for (int i = 0; i < posixTrans.size(); ++i) {
             if (posixTrans.at(i).atMSecsSinceEpoch > afterMSecsSinceEpoch)
                 return posixTrans.at(i);
@@ -887,11 +964,9 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::nextTransition(qint64 afterMSecsSince
     }
 
     // Otherwise if we can find a valid tran then use its rule
-    for (int i = 0; i < m_tranTimes.size(); ++i) {
-        if (m_tranTimes.at(i).atMSecsSinceEpoch > afterMSecsSinceEpoch) {
-            return dataForTzTransition(m_tranTimes.at(i));
-        }
-    }
+    const int index = transitionIndex(afterMSecsSinceEpoch) + 1;
+    if (index < tranTimes.size())
+        return dataForTzTransition(tranTimes.at(index));
 
     // Otherwise we have no rule, or there is no next transition, so return invalid data
     return invalidData();
@@ -899,13 +974,12 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::nextTransition(qint64 afterMSecsSince
 
 QTimeZonePrivate::Data QTzTimeZonePrivate::previousTransition(qint64 beforeMSecsSinceEpoch) const
 {
+    const QVector<QTzTransitionTime> &tranTimes = m_data->tranTimes;
+
     // If the required time is after the last transition and we have a POSIX rule then use it
-    if (m_tranTimes.size() > 0 && m_tranTimes.last().atMSecsSinceEpoch < beforeMSecsSinceEpoch
-        &&!m_posixRule.isEmpty() && beforeMSecsSinceEpoch > 0) {
-        const int year = QDateTime::fromMSecsSinceEpoch(beforeMSecsSinceEpoch, Qt::UTC).date().year();
-        const int lastMSecs = (m_tranTimes.size() > 0) ? m_tranTimes.last().atMSecsSinceEpoch : 0;
-        QVector<QTimeZonePrivate::Data> posixTrans = calculatePosixTransitions(m_posixRule, year - 1,
-                                                                               year + 1, lastMSecs);
+    if (tranTimes.size() > 0 && tranTimes.last().atMSecsSinceEpoch < beforeMSecsSinceEpoch
+        && !m_data->posixRule.isEmpty() && beforeMSecsSinceEpoch > 0) {
+        const QVector<QTimeZonePrivate::Data> posixTrans = posixTransitions(beforeMSecsSinceEpoch);
         for (int i = posixTrans.size() - 1; i >= 0; --i) {
             if (posixTrans.at(i).atMSecsSinceEpoch < beforeMSecsSinceEpoch)
                 return posixTrans.at(i);
@@ -913,10 +987,10 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::previousTransition(qint64 beforeMSecs
     }
 
     // Otherwise if we can find a valid tran then use its rule
-    for (int i = m_tranTimes.size() - 1; i >= 0; --i) {
-        if (m_tranTimes.at(i).atMSecsSinceEpoch < beforeMSecsSinceEpoch) {
-            return dataForTzTransition(m_tranTimes.at(i));
-        }
+    if (beforeMSecsSinceEpoch != std::numeric_limits<qint64>::min()) {
+        const int index = transitionIndex(beforeMSecsSinceEpoch - 1);
+        if (index >= 0)
+            return dataForTzTransition(tranTimes.at(index));
     }
 
     // Otherwise we have no rule, so return invalid data
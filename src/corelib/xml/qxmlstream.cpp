@@ -48,6 +48,7 @@
 #include <qtextcodec.h>
 #include <qstack.h>
 #include <qbuffer.h>
+#include <private/qsimd_p.h>
 #ifndef QT_BOOTSTRAPPED
 #include <qcoreapplication.h>
 #else
@@ -371,6 +372,13 @@ QXmlStreamEntityResolver *QXmlStreamReader::entityResolver() const
   \l{QStringRef::toString()}{toString()} on any of those objects
   returns an equivalent real QString object.
 
+  Applications that read many small documents, such as messages
+  received over a network, should reuse one reader and call clear()
+  before adding the next document with addData() or setDevice(). The
+  reader then keeps the buffers it has allocated. Since QXmlStreamReader
+  is reentrant, documents can be read in parallel by giving each thread
+  its own reader.
+
 */
 
 
@@ -497,6 +505,10 @@ void QXmlStreamReader::addData(const QByteArray &data)
         qWarning("QXmlStreamReader: addData() with device()");
         return;
     }
+    if (d->dataBufferPos) {
+        d->dataBuffer.remove(0, d->dataBufferPos);
+        d->dataBufferPos = 0;
+    }
     d->dataBuffer += data;
 }
 
@@ -530,7 +542,9 @@ void QXmlStreamReader::addData(const char *data)
 
 /*!
     Removes any device() or data from the reader and resets its
-    internal state to the initial state.
+    internal state to the initial state. Entities and namespaces
+    declared by the previous document are forgotten, but the buffers
+    the reader has allocated are kept for the next document.
 
     \sa addData()
  */
@@ -569,7 +583,7 @@ bool QXmlStreamReader::atEnd() const
         if (d->device)
             return d->device->atEnd();
         else
-            return !d->dataBuffer.size();
+            return d->dataBufferPos == d->dataBuffer.size();
     }
     return (d->atEnd || d->type == QXmlStreamReader::Invalid);
 }
@@ -795,12 +809,8 @@ QXmlStreamReaderPrivate::QXmlStreamReaderPrivate(QXmlStreamReader *q)
     state_stack = 0;
     reallocateStack();
     entityResolver = 0;
+    entityParser = 0;
     init();
-    entityHash.insert(QLatin1String("lt"), Entity::createLiteral(QLatin1String("<")));
-    entityHash.insert(QLatin1String("gt"), Entity::createLiteral(QLatin1String(">")));
-    entityHash.insert(QLatin1String("amp"), Entity::createLiteral(QLatin1String("&")));
-    entityHash.insert(QLatin1String("apos"), Entity::createLiteral(QLatin1String("'")));
-    entityHash.insert(QLatin1String("quot"), Entity::createLiteral(QLatin1String("\"")));
 }
 
 void QXmlStreamReaderPrivate::init()
@@ -818,14 +828,20 @@ void QXmlStreamReaderPrivate::init()
     state_stack[tos] = 0;
     putStack.clear();
     putStack.reserve(32);
-    textBuffer.clear();
+    textBuffer.resize(0); // keeps the capacity when the reader is reused
     textBuffer.reserve(256);
     tagStack.clear();
+    namespaceDeclarations.resize(1); // the xml prefix
+    entityHash.clear();
+    parameterEntityHash.clear();
+    entityReferenceStack.clear();
+    entityDeclarations.clear();
     tagsDone = false;
     attributes.clear();
     attributes.reserve(16);
     lineNumber = lastLineStart = characterOffset = 0;
     readBufferPos = 0;
+    dataBufferPos = 0;
     nbytesread = 0;
 #ifndef QT_NO_TEXTCODEC
     codec = QTextCodec::codecForMib(106); // utf8
@@ -834,7 +850,6 @@ void QXmlStreamReaderPrivate::init()
 #endif
     attributeStack.clear();
     attributeStack.reserve(16);
-    entityParser = 0;
     hasCheckedStartDocument = false;
     normalizeLiterals = false;
     hasSeenTag = false;
@@ -847,7 +862,8 @@ void QXmlStreamReaderPrivate::init()
     namespaceProcessing = true;
     rawReadBuffer.clear();
     dataBuffer.clear();
-    readBuffer.clear();
+    dataBufferPos = 0;
+    readBuffer.resize(0);
     tagStackStringStorageSize = initialTagStackStringStorageSize;
 
     type = QXmlStreamReader::NoToken;
@@ -952,6 +968,69 @@ inline uint QXmlStreamReaderPrivate::peekChar()
     return c;
 }
 
+/*!
+  \internal
+
+  Returns the number of characters at the start of [\a ptr, \a end) which
+  are neither control characters (including tab and line breaks), nor
+  0xfffe or 0xffff, nor one of the delimiters \a d1 to \a d4. The fastScan
+  functions append such runs to the text buffer in one go instead of
+  switching over every character.
+ */
+static inline int plainTextLength(const ushort *ptr, const ushort *end,
+                                  ushort d1, ushort d2, ushort d3, ushort d4)
+{
+    const ushort *start = ptr;
+#ifdef __SSE2__
+    const __m128i lastControl = _mm_set1_epi16(0x1f);
+    const __m128i lastValid = _mm_set1_epi16(short(0xfffd));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i delimiter1 = _mm_set1_epi16(short(d1));
+    const __m128i delimiter2 = _mm_set1_epi16(short(d2));
+    const __m128i delimiter3 = _mm_set1_epi16(short(d3));
+    const __m128i delimiter4 = _mm_set1_epi16(short(d4));
+    for ( ; end - ptr >= 8; ptr += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        // saturated subtractions compare unsigned: zero if data <= 0x1f, resp. data <= 0xfffd
+        const __m128i control = _mm_cmpeq_epi16(_mm_subs_epu16(data, lastControl), zero);
+        const __m128i valid = _mm_cmpeq_epi16(_mm_subs_epu16(data, lastValid), zero);
+        const __m128i delimiters = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(data, delimiter1),
+                                                             _mm_cmpeq_epi16(data, delimiter2)),
+                                                _mm_or_si128(_mm_cmpeq_epi16(data, delimiter3),
+                                                             _mm_cmpeq_epi16(data, delimiter4)));
+        const uint mask = (_mm_movemask_epi8(_mm_or_si128(control, delimiters))
+                           | ~_mm_movemask_epi8(valid)) & 0xffff;
+        if (mask)
+            return int(ptr - start) + qCountTrailingZeroBits(mask) / 2;
+    }
+#endif
+    for ( ; ptr != end; ++ptr) {
+        const ushort c = *ptr;
+        if (c < 0x20 || c > 0xfffd || c == d1 || c == d2 || c == d3 || c == d4)
+            break;
+    }
+    return int(ptr - start);
+}
+
+/*!
+  \internal
+
+  Appends the plain characters at the current read position to the text
+  buffer, see plainTextLength(). Returns the number of characters appended.
+ */
+static inline int appendPlainText(QString &textBuffer, const QString &readBuffer,
+                                  int &readBufferPos,
+                                  ushort d1, ushort d2, ushort d3, ushort d4)
+{
+    const ushort *ptr = reinterpret_cast<const ushort *>(readBuffer.constData()) + readBufferPos;
+    const int length = plainTextLength(ptr, ptr + (readBuffer.size() - readBufferPos), d1, d2, d3, d4);
+    if (length) {
+        textBuffer.append(reinterpret_cast<const QChar *>(ptr), length);
+        readBufferPos += length;
+    }
+    return length;
+}
+
 /*!
   \internal
 
@@ -970,7 +1049,12 @@ bool QXmlStreamReaderPrivate::scanUntil(const char *str, short tokenToInject)
     int oldLineNumber = lineNumber;
 
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    for (;;) {
+        if (putStack.isEmpty())
+            appendPlainText(textBuffer, readBuffer, readBufferPos, ushort(*str), 0, 0, 0);
+        if ((c = getChar()) == StreamEOF)
+            break;
+
         /* First, we do the validation & normalization. */
         switch (c) {
         case '\r':
@@ -1146,7 +1230,12 @@ inline int QXmlStreamReaderPrivate::fastScanLiteralContent()
 {
     int n = 0;
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    for (;;) {
+        if (putStack.isEmpty())
+            n += appendPlainText(textBuffer, readBuffer, readBufferPos, '&', '<', '\"', '\'');
+        if ((c = getChar()) == StreamEOF)
+            break;
+
         switch (ushort(c)) {
         case 0xfffe:
         case 0xffff:
@@ -1225,7 +1314,23 @@ inline int QXmlStreamReaderPrivate::fastScanContentCharList()
 {
     int n = 0;
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    for (;;) {
+        if (putStack.isEmpty()) {
+            const int length = appendPlainText(textBuffer, readBuffer, readBufferPos, '&', '<', ']', 0);
+            if (isWhitespace) {
+                const QChar *text = textBuffer.constData() + textBuffer.size() - length;
+                for (int i = 0; i < length; ++i) {
+                    if (text[i] != QLatin1Char(' ')) {
+                        isWhitespace = false;
+                        break;
+                    }
+                }
+            }
+            n += length;
+        }
+        if ((c = getChar()) == StreamEOF)
+            break;
+
         switch (ushort(c)) {
         case 0xfffe:
         case 0xffff:
@@ -1475,13 +1580,22 @@ uint QXmlStreamReaderPrivate::getChar_helper()
         rawReadBuffer.resize(BUFFER_SIZE);
         int nbytesreadOrMinus1 = device->read(rawReadBuffer.data() + nbytesread, BUFFER_SIZE - nbytesread);
         nbytesread += qMax(nbytesreadOrMinus1, 0);
+    } else if (dataBuffer.size() - dataBufferPos > BUFFER_SIZE) {
+        // decode large documents piecewise, so that the decoded text stays in the cache
+        rawReadBuffer.resize(nbytesread);
+        rawReadBuffer.append(dataBuffer.constData() + dataBufferPos, BUFFER_SIZE);
+        nbytesread = rawReadBuffer.size();
+        dataBufferPos += BUFFER_SIZE;
     } else {
         if (nbytesread)
-            rawReadBuffer += dataBuffer;
+            rawReadBuffer += dataBuffer.mid(dataBufferPos);
+        else if (dataBufferPos)
+            rawReadBuffer = dataBuffer.mid(dataBufferPos);
         else
             rawReadBuffer = dataBuffer;
         nbytesread = rawReadBuffer.size();
         dataBuffer.clear();
+        dataBufferPos = 0;
     }
     if (!nbytesread) {
         atEnd = true;
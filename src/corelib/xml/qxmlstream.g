@@ -253,6 +253,7 @@ public:
 
     QByteArray rawReadBuffer;
     QByteArray dataBuffer;
+    int dataBufferPos;
     uchar firstByte;
     qint64 nbytesread;
     QString readBuffer;
@@ -273,6 +274,28 @@ public:
     };
     QHash<QString, Entity> entityHash;
     QHash<QString, Entity> parameterEntityHash;
+    // the replacement texts of lt, gt, amp, apos and quot, null for other names
+    static inline QString predefinedEntity(const QStringRef &name) {
+        switch (name.size()) {
+        case 2:
+            if (name == QLatin1String("lt"))
+                return QStringLiteral("<");
+            if (name == QLatin1String("gt"))
+                return QStringLiteral(">");
+            break;
+        case 3:
+            if (name == QLatin1String("amp"))
+                return QStringLiteral("&");
+            break;
+        case 4:
+            if (name == QLatin1String("apos"))
+                return QStringLiteral("'");
+            if (name == QLatin1String("quot"))
+                return QStringLiteral("\"");
+            break;
+        }
+        return QString();
+    }
     QXmlStreamSimpleStack<Entity *>entityReferenceStack;
     inline bool referenceEntity(Entity &entity) {
         if (entity.isCurrentlyReferenced) {
@@ -1614,6 +1637,13 @@ entity_ref ::= AMPERSAND name SEMICOLON;
 /.
         case $rule_number: {
             sym(1).len += sym(2).len + 1;
+            const QString predefined = predefinedEntity(symString(2));
+            if (!predefined.isNull()) {
+                putStringLiteral(predefined);
+                textBuffer.chop(2 + sym(2).len);
+                clearSym();
+                break;
+            }
             QString reference = symString(2).toString();
             if (entityHash.contains(reference)) {
                 Entity &entity = entityHash[reference];
@@ -1687,6 +1717,13 @@ entity_ref_in_attribute_value ::= AMPERSAND name SEMICOLON;
 /.
         case $rule_number: {
             sym(1).len += sym(2).len + 1;
+            const QString predefined = predefinedEntity(symString(2));
+            if (!predefined.isNull()) {
+                putStringLiteral(predefined);
+                textBuffer.chop(2 + sym(2).len);
+                clearSym();
+                break;
+            }
             QString reference = symString(2).toString();
             if (entityHash.contains(reference)) {
                 Entity &entity = entityHash[reference];
@@ -748,6 +748,7 @@ public:
 
     QByteArray rawReadBuffer;
     QByteArray dataBuffer;
+    int dataBufferPos;
     uchar firstByte;
     qint64 nbytesread;
     QString readBuffer;
@@ -768,6 +769,28 @@ public:
     };
     QHash<QString, Entity> entityHash;
     QHash<QString, Entity> parameterEntityHash;
+    // the replacement texts of lt, gt, amp, apos and quot, null for other names
+    static inline QString predefinedEntity(const QStringRef &name) {
+        switch (name.size()) {
+        case 2:
+            if (name == QLatin1String("lt"))
+                return QStringLiteral("<");
+            if (name == QLatin1String("gt"))
+                return QStringLiteral(">");
+            break;
+        case 3:
+            if (name == QLatin1String("amp"))
+                return QStringLiteral("&");
+            break;
+        case 4:
+            if (name == QLatin1String("apos"))
+                return QStringLiteral("'");
+            if (name == QLatin1String("quot"))
+                return QStringLiteral("\"");
+            break;
+        }
+        return QString();
+    }
     QXmlStreamSimpleStack<Entity *>entityReferenceStack;
     inline bool referenceEntity(Entity &entity) {
         if (entity.isCurrentlyReferenced) {
@@ -1790,6 +1813,13 @@ bool QXmlStreamReaderPrivate::parse()
 
         case 240: {
             sym(1).len += sym(2).len + 1;
+            const QString predefined = predefinedEntity(symString(2));
+            if (!predefined.isNull()) {
+                putStringLiteral(predefined);
+                textBuffer.chop(2 + sym(2).len);
+                clearSym();
+                break;
+            }
             QString reference = symString(2).toString();
             if (entityHash.contains(reference)) {
                 Entity &entity = entityHash[reference];
@@ -1852,6 +1882,13 @@ bool QXmlStreamReaderPrivate::parse()
 
         case 243: {
             sym(1).len += sym(2).len + 1;
+            const QString predefined = predefinedEntity(symString(2));
+            if (!predefined.isNull()) {
+                putStringLiteral(predefined);
+                textBuffer.chop(2 + sym(2).len);
+                clearSym();
+                break;
+            }
             QString reference = symString(2).toString();
             if (entityHash.contains(reference)) {
                 Entity &entity = entityHash[reference];
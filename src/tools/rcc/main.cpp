@@ -135,6 +135,9 @@ int runRcc(int argc, char *argv[])
     QCommandLineOption thresholdOption(QStringLiteral("threshold"), QStringLiteral("Threshold to consider compressing files."), QStringLiteral("level"));
     parser.addOption(thresholdOption);
 
+    QCommandLineOption chunkSizeOption(QStringLiteral("chunk-size"), QStringLiteral("Compress files larger than <size> bytes in chunks of that size, which are uncompressed on demand."), QStringLiteral("size"));
+    parser.addOption(chunkSizeOption);
+
     QCommandLineOption binaryOption(QStringLiteral("binary"), QStringLiteral("Output a binary file for use as a dynamic resource."));
     parser.addOption(binaryOption);
 
@@ -175,6 +178,8 @@ int runRcc(int argc, char *argv[])
         library.setCompressLevel(-2);
     if (parser.isSet(thresholdOption))
         library.setCompressThreshold(parser.value(thresholdOption).toInt());
+    if (parser.isSet(chunkSizeOption))
+        library.setCompressChunkSize(parser.value(chunkSizeOption).toInt());
     if (parser.isSet(binaryOption))
         library.setFormat(RCCResourceLibrary::Binary);
     if (parser.isSet(passOption)) {
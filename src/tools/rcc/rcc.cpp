@@ -90,7 +90,8 @@ public:
     {
         NoFlags = 0x00,
         Compressed = 0x01,
-        Directory = 0x02
+        Directory = 0x02,
+        Chunked = 0x04
     };
 
     RCCFileInfo(const QString &name = QString(), const QFileInfo &fileInfo = QFileInfo(),
@@ -205,6 +206,43 @@ void RCCFileInfo::writeDataInfo(RCCResourceLibrary &lib)
         lib.writeChar('\n');
 }
 
+#ifndef QT_NO_COMPRESS
+static void appendNumber4(QByteArray &out, quint32 number)
+{
+    out.append(char(number >> 24));
+    out.append(char(number >> 16));
+    out.append(char(number >> 8));
+    out.append(char(number));
+}
+
+/*
+    Compresses data in chunks of chunkSize bytes that can be
+    uncompressed independently, so that QResource can uncompress only the
+    parts of a large file that are actually read. The result starts with
+    the uncompressed size, the chunk size and a table with the offsets of
+    the chunks, relative to the end of the table (plus the end of the last
+    chunk). Each chunk is a zlib stream.
+*/
+static QByteArray compressChunks(const QByteArray &data, int chunkSize, int level)
+{
+    const int chunkCount = (data.size() + chunkSize - 1) / chunkSize;
+    QByteArray header;
+    QByteArray chunks;
+    appendNumber4(header, data.size());
+    appendNumber4(header, chunkSize);
+    for (int i = 0; i < chunkCount; ++i) {
+        appendNumber4(header, chunks.size());
+        const int size = qMin(chunkSize, data.size() - i * chunkSize);
+        const QByteArray chunk = qCompress(reinterpret_cast<const uchar *>(data.constData()) + i * chunkSize,
+                                           size, level);
+        // drop the uncompressed size qCompress() prepends; we know it already
+        chunks.append(chunk.constData() + 4, chunk.size() - 4);
+    }
+    appendNumber4(header, chunks.size());
+    return header + chunks;
+}
+#endif // QT_NO_COMPRESS
+
 qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib, qint64 offset,
     QString *errorMessage)
 {
@@ -227,13 +265,18 @@ qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib, qint64 offset,
 #ifndef QT_NO_COMPRESS
     // Check if compression is useful for this file
     if (m_compressLevel != 0 && data.size() != 0) {
-        QByteArray compressed =
-            qCompress(reinterpret_cast<uchar *>(data.data()), data.size(), m_compressLevel);
+        const int chunkSize = lib.m_compressChunkSize;
+        const bool chunked = chunkSize > 0 && data.size() > chunkSize;
+        QByteArray compressed = chunked
+            ? compressChunks(data, chunkSize, m_compressLevel)
+            : qCompress(reinterpret_cast<uchar *>(data.data()), data.size(), m_compressLevel);
 
         int compressRatio = int(100.0 * (data.size() - compressed.size()) / data.size());
         if (compressRatio >= m_compressThreshold) {
             data = compressed;
             m_flags |= Compressed;
+            if (chunked)
+                m_flags |= Chunked;
         }
     }
 #endif // QT_NO_COMPRESS
@@ -341,6 +384,7 @@ RCCResourceLibrary::RCCResourceLibrary()
     m_verbose(false),
     m_compressLevel(CONSTANT_COMPRESSLEVEL_DEFAULT),
     m_compressThreshold(CONSTANT_COMPRESSTHRESHOLD_DEFAULT),
+    m_compressChunkSize(0),
     m_treeOffset(0),
     m_namesOffset(0),
     m_dataOffset(0),
@@ -1078,7 +1122,9 @@ bool RCCResourceLibrary::writeInitializer()
         if (m_root) {
             writeString("    ");
             writeAddNamespaceFunction("qRegisterResourceData");
-            writeString("\n        (0x01, qt_resource_struct, "
+            writeString("\n        (0x0");
+            writeByteArray(QByteArray::number(formatVersion()));
+            writeString(", qt_resource_struct, "
                        "qt_resource_name, qt_resource_data);\n");
         }
         writeString("    return 1;\n");
@@ -1099,7 +1145,9 @@ bool RCCResourceLibrary::writeInitializer()
         if (m_root) {
             writeString("    ");
             writeAddNamespaceFunction("qUnregisterResourceData");
-            writeString("\n       (0x01, qt_resource_struct, "
+            writeString("\n       (0x0");
+            writeByteArray(QByteArray::number(formatVersion()));
+            writeString(", qt_resource_struct, "
                       "qt_resource_name, qt_resource_data);\n");
         }
         writeString("    return 1;\n");
@@ -1116,10 +1164,10 @@ bool RCCResourceLibrary::writeInitializer()
     } else if (m_format == Binary) {
         int i = 4;
         char *p = m_out.data();
-        p[i++] = 0; // 0x01
+        p[i++] = 0; // 0x01, or 0x02 with chunked files
         p[i++] = 0;
         p[i++] = 0;
-        p[i++] = 1;
+        p[i++] = formatVersion();
 
         p[i++] = (m_treeOffset >> 24) & 0xff;
         p[i++] = (m_treeOffset >> 16) & 0xff;
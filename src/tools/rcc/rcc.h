@@ -83,6 +83,9 @@ public:
     void setCompressThreshold(int t) { m_compressThreshold = t; }
     int compressThreshold() const { return m_compressThreshold; }
 
+    void setCompressChunkSize(int size) { m_compressChunkSize = size; }
+    int compressChunkSize() const { return m_compressChunkSize; }
+
     void setResourceRoot(const QString &root) { m_resourceRoot = root; }
     QString resourceRoot() const { return m_resourceRoot; }
 
@@ -115,6 +118,8 @@ private:
     bool writeInitializer();
     void writeMangleNamespaceFunction(const QByteArray &name);
     void writeAddNamespaceFunction(const QByteArray &name);
+    // chunked files use a node flag that older QtCore versions don't know
+    int formatVersion() const { return m_compressChunkSize > 0 ? 2 : 1; }
     void writeHex(quint8 number);
     void writeNumber2(quint16 number);
     void writeNumber4(quint32 number);
@@ -132,6 +137,7 @@ private:
     bool m_verbose;
     int m_compressLevel;
     int m_compressThreshold;
+    int m_compressChunkSize;
     int m_treeOffset;
     int m_namesOffset;
     int m_dataOffset;
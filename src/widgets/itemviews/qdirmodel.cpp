@@ -1262,10 +1262,13 @@ void QDirModelPrivate::restorePersistentIndexes()
         if (idx != data->index || data->model == 0) {
             //data->model may be equal to 0 if the model is getting destroyed
             persistent.indexes.remove(data->index);
+            persistent.removeFromTopLevel(data);
             data->index = idx;
             data->model = q;
-            if (idx.isValid())
+            if (idx.isValid()) {
                 persistent.indexes.insert(idx, data);
+                persistent.addUnclassified(data);
+            }
         }
     }
     savedPersistent.clear();
@@ -55,6 +55,7 @@
 #include "private/qxml_p.h"
 #include <qvariant.h>
 #include <qmap.h>
+#include <qset.h>
 #include <qshareddata.h>
 #include <qdebug.h>
 #include <stdio.h>
@@ -188,9 +189,12 @@ public:
     virtual void save(QTextStream&, int, int) const;
 
     void setLocation(int lineNumber, int columnNumber);
+    void shareNames(QDomDocumentPrivate *doc);
 
     // Variables
     QAtomicInt ref;
+    bool createdWithDom1Interface : 1;
+    bool hasParent                : 1;
     QDomNodePrivate* prev;
     QDomNodePrivate* next;
     QDomNodePrivate* ownerNode; // either the node's parent or the node's owner document
@@ -201,8 +205,6 @@ public:
     QString value;
     QString prefix; // set this only for ElementNode and AttributeNode
     QString namespaceURI; // set this only for ElementNode and AttributeNode
-    bool createdWithDom1Interface : 1;
-    bool hasParent                : 1;
 
     int lineNumber;
     int columnNumber;
@@ -522,6 +524,8 @@ public:
 
     QDomNodePrivate* importNode(QDomNodePrivate* importedNode, bool deep);
 
+    QString sharedName(const QString &name);
+
     // Reimplemented from QDomNodePrivate
     QDomNodePrivate* cloneNode(bool deep = true) Q_DECL_OVERRIDE;
     QDomNode::NodeType nodeType() const Q_DECL_OVERRIDE { return QDomNode::DocumentNode; }
@@ -561,6 +565,13 @@ public:
        stored timestamp.
     */
     long nodeListTime;
+
+    /* \internal
+       The element and attribute names, prefixes and namespace URIs used in
+       this document. Nodes take their names from this table, so that a name
+       is stored once per document rather than once per node.
+    */
+    QSet<QString> nameTable;
 };
 
 /**************************************************************
@@ -1909,6 +1920,21 @@ void QDomNodePrivate::setLocation(int lineNumber, int columnNumber)
     this->columnNumber = columnNumber;
 }
 
+/*!
+  \internal
+
+  Replaces the name, prefix and namespace URI with the copies from the
+  name table of \a doc, the document that owns this node.
+ */
+void QDomNodePrivate::shareNames(QDomDocumentPrivate *doc)
+{
+    if (!doc)
+        return;
+    name = doc->sharedName(name);
+    prefix = doc->sharedName(prefix);
+    namespaceURI = doc->sharedName(namespaceURI);
+}
+
 /**************************************************************
  *
  * QDomNode
@@ -3770,7 +3796,7 @@ QString QDomDocumentType::internalSubset() const
 QDomDocumentFragmentPrivate::QDomDocumentFragmentPrivate(QDomDocumentPrivate* doc, QDomNodePrivate* parent)
     : QDomNodePrivate(doc, parent)
 {
-    name = QLatin1String("#document-fragment");
+    name = QStringLiteral("#document-fragment");
 }
 
 QDomDocumentFragmentPrivate::QDomDocumentFragmentPrivate(QDomNodePrivate* n, bool deep)
@@ -3872,7 +3898,7 @@ QDomCharacterDataPrivate::QDomCharacterDataPrivate(QDomDocumentPrivate* d, QDomN
     : QDomNodePrivate(d, p)
 {
     value = data;
-    name = QLatin1String("#character-data");
+    name = QStringLiteral("#character-data");
 }
 
 QDomCharacterDataPrivate::QDomCharacterDataPrivate(QDomCharacterDataPrivate* n, bool deep)
@@ -4091,6 +4117,7 @@ QDomAttrPrivate::QDomAttrPrivate(QDomDocumentPrivate* d, QDomNodePrivate* parent
 {
     name = name_;
     m_specified = false;
+    shareNames(d);
 }
 
 QDomAttrPrivate::QDomAttrPrivate(QDomDocumentPrivate* d, QDomNodePrivate* p, const QString& nsURI, const QString& qName)
@@ -4100,6 +4127,7 @@ QDomAttrPrivate::QDomAttrPrivate(QDomDocumentPrivate* d, QDomNodePrivate* p, con
     namespaceURI = nsURI;
     createdWithDom1Interface = false;
     m_specified = false;
+    shareNames(d);
 }
 
 QDomAttrPrivate::QDomAttrPrivate(QDomAttrPrivate* n, bool deep)
@@ -4395,6 +4423,7 @@ QDomElementPrivate::QDomElementPrivate(QDomDocumentPrivate* d, QDomNodePrivate*
 {
     name = tagname;
     m_attr = new QDomNamedNodeMapPrivate(this);
+    shareNames(d);
 }
 
 QDomElementPrivate::QDomElementPrivate(QDomDocumentPrivate* d, QDomNodePrivate* p,
@@ -4405,6 +4434,7 @@ QDomElementPrivate::QDomElementPrivate(QDomDocumentPrivate* d, QDomNodePrivate*
     namespaceURI = nsURI;
     createdWithDom1Interface = false;
     m_attr = new QDomNamedNodeMapPrivate(this);
+    shareNames(d);
 }
 
 QDomElementPrivate::QDomElementPrivate(QDomElementPrivate* n, bool deep) :
@@ -5160,7 +5190,7 @@ QString QDomElement::text() const
 QDomTextPrivate::QDomTextPrivate(QDomDocumentPrivate* d, QDomNodePrivate* parent, const QString& val)
     : QDomCharacterDataPrivate(d, parent, val)
 {
-    name = QLatin1String("#text");
+    name = QStringLiteral("#text");
 }
 
 QDomTextPrivate::QDomTextPrivate(QDomTextPrivate* n, bool deep)
@@ -5296,7 +5326,7 @@ QDomText QDomText::splitText(int offset)
 QDomCommentPrivate::QDomCommentPrivate(QDomDocumentPrivate* d, QDomNodePrivate* parent, const QString& val)
     : QDomCharacterDataPrivate(d, parent, val)
 {
-    name = QLatin1String("#comment");
+    name = QStringLiteral("#comment");
 }
 
 QDomCommentPrivate::QDomCommentPrivate(QDomCommentPrivate* n, bool deep)
@@ -5409,7 +5439,7 @@ QDomCDATASectionPrivate::QDomCDATASectionPrivate(QDomDocumentPrivate* d, QDomNod
                                                     const QString& val)
     : QDomTextPrivate(d, parent, val)
 {
-    name = QLatin1String("#cdata-section");
+    name = QStringLiteral("#cdata-section");
 }
 
 QDomCDATASectionPrivate::QDomCDATASectionPrivate(QDomCDATASectionPrivate* n, bool deep)
@@ -6147,7 +6177,7 @@ QDomDocumentPrivate::QDomDocumentPrivate()
     type = new QDomDocumentTypePrivate(this, this);
     type->ref.deref();
 
-    name = QLatin1String("#document");
+    name = QStringLiteral("#document");
 }
 
 QDomDocumentPrivate::QDomDocumentPrivate(const QString& aname)
@@ -6159,7 +6189,7 @@ QDomDocumentPrivate::QDomDocumentPrivate(const QString& aname)
     type->ref.deref();
     type->name = aname;
 
-    name = QLatin1String("#document");
+    name = QStringLiteral("#document");
 }
 
 QDomDocumentPrivate::QDomDocumentPrivate(QDomDocumentTypePrivate* dt)
@@ -6174,7 +6204,7 @@ QDomDocumentPrivate::QDomDocumentPrivate(QDomDocumentTypePrivate* dt)
         type->ref.deref();
     }
 
-    name = QLatin1String("#document");
+    name = QStringLiteral("#document");
 }
 
 QDomDocumentPrivate::QDomDocumentPrivate(QDomDocumentPrivate* n, bool deep)
@@ -6195,6 +6225,21 @@ void QDomDocumentPrivate::clear()
     impl.reset();
     type.reset();
     QDomNodePrivate::clear();
+    nameTable.clear();
+}
+
+/*!
+  \internal
+
+  Returns the copy of \a name stored in the document's name table, adding
+  \a name to the table if needed. Null and empty strings are returned as
+  they are, since the difference between them matters for prefixes.
+ */
+QString QDomDocumentPrivate::sharedName(const QString &name)
+{
+    if (name.isEmpty())
+        return name;
+    return *nameTable.insert(name);
 }
 
 static void initializeReader(QXmlSimpleReader &reader, bool namespaceProcessing)
@@ -115,6 +115,7 @@ private slots:
     void totalDuration();
     void zeroLoopCount();
     void recursiveAnimations();
+    void inheritedProperties();
 };
 
 void tst_QPropertyAnimation::initTestCase()
@@ -1313,6 +1314,40 @@ void tst_QPropertyAnimation::recursiveAnimations()
     QCOMPARE(o.y(), qreal(4000));
 }
 
+class DerivedAnimationObject : public AnimationObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QRect rect READ rect WRITE setRect)
+public:
+    QRect rect() const { return r; }
+    void setRect(const QRect &rect) { r = rect; }
+
+    QRect r;
+};
+
+void tst_QPropertyAnimation::inheritedProperties()
+{
+    // the writes go to the class declaring the property
+    DerivedAnimationObject o;
+    QParallelAnimationGroup group;
+    QPropertyAnimation *value = new QPropertyAnimation(&o, "value", &group);
+    value->setStartValue(0);
+    value->setEndValue(100);
+    QPropertyAnimation *realValue = new QPropertyAnimation(&o, "realValue", &group);
+    realValue->setStartValue(0.);
+    realValue->setEndValue(1.);
+    QPropertyAnimation *rect = new QPropertyAnimation(&o, "rect", &group);
+    rect->setStartValue(QRect(0, 0, 0, 0));
+    rect->setEndValue(QRect(0, 0, 100, 100));
+
+    group.start();
+    group.pause();
+    group.setCurrentTime(125);
+    QCOMPARE(o.value(), 50);
+    QCOMPARE(o.realValue(), 0.5);
+    QCOMPARE(o.rect(), QRect(0, 0, 50, 50));
+    QCOMPARE(o.property("rect").toRect(), QRect(0, 0, 50, 50));
+}
 
 QTEST_MAIN(tst_QPropertyAnimation)
 #include "tst_qpropertyanimation.moc"
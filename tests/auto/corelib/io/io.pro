@@ -33,6 +33,7 @@ SUBDIRS=\
     qurl \
     qurlinternal \
     qurlquery \
+    qurlview \
     qwinoverlappedionotifier \
 
 !win32|wince* {
@@ -34,6 +34,7 @@
 #include <QElapsedTimer>
 #include <QTextStream>
 #include <QDir>
+#include <QSignalSpy>
 
 /* All tests need to run in temporary directories not used
  * by the application to avoid non-deterministic failures on Windows
@@ -73,6 +74,10 @@ private slots:
 
     void signalsEmittedAfterFileMoved();
 
+    void addPathsRecursively();
+    void watchNewSubdirectory();
+    void coalesceChanges();
+
 private:
     QString m_tempDirPattern;
 #endif // QT_NO_FILESYSTEMWATCHER
@@ -759,6 +764,110 @@ void tst_QFileSystemWatcher::signalsEmittedAfterFileMoved()
     QVERIFY2(changedSpy.count() <= fileCount, changedSpy.receivedFilesMessage());
     QTRY_COMPARE(changedSpy.count(), fileCount);
 }
+
+void tst_QFileSystemWatcher::addPathsRecursively()
+{
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY2(temporaryDirectory.isValid(), qPrintable(temporaryDirectory.errorString()));
+
+    QDir testDir(temporaryDirectory.path());
+    QVERIFY(testDir.mkpath("a/b/c"));
+    QVERIFY(testDir.mkpath("d"));
+    QFile file(testDir.filePath("a/file.txt"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+
+    QFileSystemWatcher watcher;
+    QVERIFY(watcher.addPathRecursively(testDir.path()));
+    QStringList directories = watcher.directories();
+    directories.sort();
+    QStringList expected;
+    expected << testDir.path() << testDir.filePath("a") << testDir.filePath("a/b")
+             << testDir.filePath("a/b/c") << testDir.filePath("d");
+    expected.sort();
+    QCOMPARE(directories, expected);
+    QVERIFY(watcher.files().isEmpty());
+
+    // files are not directories
+    QCOMPARE(watcher.addPathsRecursively(QStringList(file.fileName())), QStringList(file.fileName()));
+
+    // removing the root stops watching the whole tree
+    QVERIFY(watcher.removePath(testDir.path()));
+    QVERIFY(watcher.directories().isEmpty());
+
+    QTest::ignoreMessage(QtWarningMsg, "QFileSystemWatcher::addPathRecursively: path is empty");
+    QVERIFY(watcher.addPathRecursively(QString()));
+}
+
+void tst_QFileSystemWatcher::watchNewSubdirectory()
+{
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY2(temporaryDirectory.isValid(), qPrintable(temporaryDirectory.errorString()));
+
+    QDir testDir(temporaryDirectory.path());
+    QFileSystemWatcher watcher;
+    watcher.setObjectName(QLatin1String("_qt_autotest_force_engine_native"));
+    QVERIFY(watcher.addPathRecursively(testDir.path()));
+
+    FileSystemWatcherSpy changedSpy(&watcher, FileSystemWatcherSpy::SpyOnDirectoryChanged);
+    QVERIFY(testDir.mkdir("new"));
+    QTRY_VERIFY(watcher.directories().contains(testDir.filePath("new")));
+
+    // changes inside the new directory are reported as well
+    changedSpy.clear();
+    QFile file(testDir.filePath("new/file.txt"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+    QTRY_VERIFY2(changedSpy.count() > 0, changedSpy.receivedFilesMessage());
+}
+
+void tst_QFileSystemWatcher::coalesceChanges()
+{
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY2(temporaryDirectory.isValid(), qPrintable(temporaryDirectory.errorString()));
+
+    QFile testFile(temporaryDirectory.path() + QLatin1String("/testfile.txt"));
+    QVERIFY(testFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    testFile.close();
+
+    QFileSystemWatcher watcher;
+    watcher.setObjectName(QLatin1String("_qt_autotest_force_engine_native"));
+    QCOMPARE(watcher.coalescingInterval(), 0);
+    watcher.setCoalescingInterval(500);
+    QCOMPARE(watcher.coalescingInterval(), 500);
+    QVERIFY(watcher.addPath(testFile.fileName()));
+
+    QSignalSpy fileChangedSpy(&watcher, &QFileSystemWatcher::fileChanged);
+    QSignalSpy pathChangedSpy(&watcher, &QFileSystemWatcher::pathChanged);
+
+    for (int i = 0; i < 10; ++i) {
+        QVERIFY(testFile.open(QIODevice::WriteOnly | QIODevice::Append));
+        testFile.write(QByteArray("hello"));
+        testFile.close();
+        QCoreApplication::processEvents();
+    }
+    QVERIFY(testFile.setPermissions(QFile::ReadOwner | QFile::WriteOwner | QFile::ReadUser));
+
+    QTRY_COMPARE(pathChangedSpy.count(), 1);
+    QCOMPARE(fileChangedSpy.count(), 1);
+    QCOMPARE(pathChangedSpy.at(0).at(0).toString(), testFile.fileName());
+    const QFileSystemWatcher::ChangeTypes changes =
+            pathChangedSpy.at(0).at(1).value<QFileSystemWatcher::ChangeTypes>();
+    QVERIFY(changes & QFileSystemWatcher::ContentModified);
+    QVERIFY(!(changes & QFileSystemWatcher::Removed));
+
+    // removing the file is reported once, together with everything else
+    // that happened in the same interval
+    QVERIFY(testFile.open(QIODevice::WriteOnly | QIODevice::Append));
+    testFile.write(QByteArray("bye"));
+    testFile.close();
+    QVERIFY(testFile.remove());
+    QTRY_COMPARE(pathChangedSpy.count(), 2);
+    QCOMPARE(fileChangedSpy.count(), 2);
+    QVERIFY(pathChangedSpy.at(1).at(1).value<QFileSystemWatcher::ChangeTypes>()
+            & QFileSystemWatcher::Removed);
+    QVERIFY(watcher.files().isEmpty());
+}
 #endif // QT_NO_FILESYSTEMWATCHER
 
 QTEST_MAIN(tst_QFileSystemWatcher)
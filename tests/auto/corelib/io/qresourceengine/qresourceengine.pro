@@ -8,14 +8,17 @@ RESOURCES += testqrc/test.qrc
 runtime_resource.target = runtime_resource.rcc
 runtime_resource.depends = $$PWD/testqrc/test.qrc
 runtime_resource.commands = $$QMAKE_RCC -root /runtime_resource/ -binary $${runtime_resource.depends} -o $${runtime_resource.target}
-QMAKE_EXTRA_TARGETS = runtime_resource
-PRE_TARGETDEPS += $${runtime_resource.target}
-QMAKE_DISTCLEAN += $${runtime_resource.target}
+chunked_resource.target = chunked_resource.rcc
+chunked_resource.depends = $$PWD/testqrc/test.qrc
+chunked_resource.commands = $$QMAKE_RCC -root /chunked_resource/ -binary -chunk-size 4096 $${chunked_resource.depends} -o $${chunked_resource.target}
+QMAKE_EXTRA_TARGETS = runtime_resource chunked_resource
+PRE_TARGETDEPS += $${runtime_resource.target} $${chunked_resource.target}
+QMAKE_DISTCLEAN += $${runtime_resource.target} $${chunked_resource.target}
 
 TESTDATA += \
     parentdir.txt \
     testqrc/*
-GENERATED_TESTDATA = $${runtime_resource.target}
+GENERATED_TESTDATA = $${runtime_resource.target} $${chunked_resource.target}
 
 android:!android-no-sdk {
     RESOURCES += android_testdata.qrc
@@ -55,6 +55,7 @@ private slots:
     void searchPath();
     void doubleSlashInRoot();
     void setLocale();
+    void chunkedCompression();
 
 private:
     const QString m_runtimeResourceRcc;
@@ -489,6 +490,68 @@ void tst_QResourceEngine::setLocale()
     QLocale::setDefault(QLocale::system());
 }
 
+void tst_QResourceEngine::chunkedCompression()
+{
+    const QString rccFile = QFINDTESTDATA("chunked_resource.rcc");
+    QVERIFY(!rccFile.isEmpty());
+    QVERIFY(QResource::registerResource(rccFile));
+
+    QFile original(QFINDTESTDATA("testqrc/aliasdir/compressme.txt"));
+    QVERIFY(original.open(QIODevice::ReadOnly));
+    const QByteArray expected = original.readAll();
+    QVERIFY(expected.size() > 4096);
+
+    const QString fileName = QStringLiteral(":/chunked_resource/aliasdir/aliasdir.txt");
+    {
+        QResource resource(fileName, QLocale("de_CH"));
+        QVERIFY(resource.isValid());
+        QVERIFY(resource.isCompressed());
+    }
+
+    QLocale::setDefault(QLocale("de_CH"));
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.size(), qint64(expected.size()));
+        QCOMPARE(file.readAll(), expected);
+
+        // reads that start and end in the middle of chunks
+        QVERIFY(file.seek(4000));
+        QCOMPARE(file.read(10000), expected.mid(4000, 10000));
+        QVERIFY(file.seek(expected.size() - 100));
+        QCOMPARE(file.read(1000), expected.right(100));
+        QVERIFY(file.atEnd());
+
+        uchar *mapped = file.map(5000, 3000);
+        QVERIFY(mapped);
+        QCOMPARE(QByteArray(reinterpret_cast<const char *>(mapped), 3000), expected.mid(5000, 3000));
+        QVERIFY(file.unmap(mapped));
+        QVERIFY(!file.map(expected.size() - 10, 20));
+
+        // reopening must not lose the size of the uncompressed data
+        file.close();
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.size(), qint64(expected.size()));
+        QCOMPARE(file.readAll(), expected);
+    }
+    QLocale::setDefault(QLocale::system());
+
+    QVERIFY(QResource::unregisterResource(rccFile));
+
+    // chunked files need format version 2; older roots must not expose them
+    QFile rcc(rccFile);
+    QVERIFY(rcc.open(QIODevice::ReadOnly));
+    QByteArray data = rcc.readAll();
+    QCOMPARE(data.at(7), char(2));
+    data[7] = 1;
+    const uchar *buffer = reinterpret_cast<const uchar *>(data.constData());
+    QVERIFY(QResource::registerResource(buffer, QStringLiteral("/old_format")));
+    QVERIFY(QResource(QStringLiteral(":/old_format/chunked_resource/search_file.txt")).isValid());
+    QVERIFY(!QResource(QStringLiteral(":/old_format/chunked_resource/aliasdir/aliasdir.txt"),
+                       QLocale("de_CH")).isValid());
+    QVERIFY(QResource::unregisterResource(buffer, QStringLiteral("/old_format")));
+}
+
 QTEST_MAIN(tst_QResourceEngine)
 
 #include "tst_qresourceengine.moc"
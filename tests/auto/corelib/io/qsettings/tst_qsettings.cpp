@@ -158,6 +158,10 @@ private slots:
     void testByteArray();
     void iniCodec();
     void bom();
+    void indexedFormat();
+    void indexedFormatJournal();
+    void indexedFormatDamagedJournal();
+    void indexedFormatMigration();
 
 private:
     void cleanupTestFiles();
@@ -678,6 +682,206 @@ void tst_QSettings::bom()
     QVERIFY(allkeys.contains("section2/foo2"));
 }
 
+void tst_QSettings::indexedFormat()
+{
+    const QString fileName = settingsPath("indexed.qsi");
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QCOMPARE(settings.format(), QSettings::IndexedFormat);
+        QCOMPARE(settings.status(), QSettings::NoError);
+        settings.setValue("alpha", 1);
+        settings.setValue("beta/gamma", QStringList() << "a" << "b");
+        settings.setValue("beta/delta", QByteArray("\0\1\2", 3));
+        settings.setValue("beta/Delta", QDateTime(QDate(2016, 10, 1), QTime(12, 0)));
+        settings.beginWriteArray("array");
+        for (int i = 0; i < 3; ++i) {
+            settings.setArrayIndex(i);
+            settings.setValue("value", i * 10);
+        }
+        settings.endArray();
+        settings.setValue("removed/a", 1);
+        settings.setValue("removed/b/c", 2);
+        settings.remove("removed");
+        settings.sync();
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QVERIFY(QFile::exists(fileName));
+    }
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QCOMPARE(settings.value("alpha").toInt(), 1);
+        QCOMPARE(settings.value("beta/gamma").toStringList(), QStringList() << "a" << "b");
+        QCOMPARE(settings.value("beta/delta").toByteArray(), QByteArray("\0\1\2", 3));
+        QCOMPARE(settings.value("beta/Delta").toDateTime(), QDateTime(QDate(2016, 10, 1), QTime(12, 0)));
+        QVERIFY(!settings.contains("removed/a"));
+        QVERIFY(!settings.contains("removed/b/c"));
+        QCOMPARE(settings.childKeys(), QStringList() << "alpha");
+        QCOMPARE(settings.childGroups(), QStringList() << "array" << "beta");
+        QCOMPARE(settings.allKeys().count(), 8);
+
+        QCOMPARE(settings.beginReadArray("array"), 3);
+        for (int i = 0; i < 3; ++i) {
+            settings.setArrayIndex(i);
+            QCOMPARE(settings.value("value").toInt(), i * 10);
+        }
+        settings.endArray();
+
+        settings.beginGroup("beta");
+        QCOMPARE(settings.childKeys(), QStringList() << "Delta" << "delta" << "gamma");
+        settings.remove("");
+        settings.endGroup();
+        QCOMPARE(settings.childGroups(), QStringList() << "array");
+    }
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QVERIFY(!settings.contains("beta/gamma"));
+        QCOMPARE(settings.value("alpha").toInt(), 1);
+        settings.clear();
+        QVERIFY(settings.allKeys().isEmpty());
+        settings.setValue("omega", 42);
+    }
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QCOMPARE(settings.allKeys(), QStringList() << "omega");
+    }
+}
+
+void tst_QSettings::indexedFormatJournal()
+{
+    const QString fileName = settingsPath("journal.qsi");
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        for (int i = 0; i < 1000; ++i)
+            settings.setValue(QString::fromLatin1("group%1/key%2").arg(i % 10).arg(i), i);
+    }
+    const qint64 snapshotSize = QFileInfo(fileName).size();
+
+    // small updates are appended to the file
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        settings.setValue("group1/key1", "one");
+        settings.remove("group2");
+    }
+    qint64 size = QFileInfo(fileName).size();
+    QVERIFY(size > snapshotSize);
+    QVERIFY(size < snapshotSize + 100);
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QCOMPARE(settings.value("group1/key1").toString(), QString("one"));
+        QVERIFY(!settings.contains("group2/key2"));
+        QCOMPARE(settings.allKeys().count(), 900);
+    }
+
+    // once they add up, the file is compacted
+    const QString large(100, QLatin1Char('x'));
+    int round = 0;
+    for (; round < 1000; ++round) {
+        {
+            QSettings settings(fileName, QSettings::IndexedFormat);
+            settings.setValue("group3/key3", large + QString::number(round));
+        }
+        const qint64 newSize = QFileInfo(fileName).size();
+        if (newSize < size)
+            break;
+        size = newSize;
+    }
+    QVERIFY(round < 1000);
+    QVERIFY(QFileInfo(fileName).size() < snapshotSize + 1000);
+
+    QSettings settings(fileName, QSettings::IndexedFormat);
+    QCOMPARE(settings.value("group3/key3").toString(), large + QString::number(round));
+    QCOMPARE(settings.value("group1/key1").toString(), QString("one"));
+    QCOMPARE(settings.value("group9/key9").toInt(), 9);
+    QCOMPARE(settings.allKeys().count(), 900);
+}
+
+void tst_QSettings::indexedFormatDamagedJournal()
+{
+    const QString fileName = settingsPath("damaged.qsi");
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        settings.setValue("a", 1);
+    }
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        settings.setValue("b", 2);
+    }
+
+    // simulate a write that was interrupted
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::Append));
+        QVERIFY(file.write("\x40\0\0\0\1\0", 6) == 6);
+    }
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QCOMPARE(settings.value("a").toInt(), 1);
+        QCOMPARE(settings.value("b").toInt(), 2);
+        settings.setValue("c", 3);
+    }
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QCOMPARE(settings.allKeys(), QStringList() << "a" << "b" << "c");
+    }
+
+    // files that aren't in this format are reported, and replaced on write
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        QVERIFY(file.write("[General]\na=1\n") > 0);
+    }
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QCOMPARE(settings.status(), QSettings::FormatError);
+        QVERIFY(settings.allKeys().isEmpty());
+        settings.setValue("d", 4);
+    }
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QCOMPARE(settings.allKeys(), QStringList() << "d");
+    }
+}
+
+void tst_QSettings::indexedFormatMigration()
+{
+    {
+        QSettings ini(QSettings::IniFormat, QSettings::UserScope, "software.org", "KillerAPP");
+        ini.setValue("alpha/beta", 1);
+        ini.setValue("gamma", QStringList() << "x" << "y");
+    }
+
+    const QString iniFileName = settingsPath("__user__") + QDir::separator()
+            + "software.org" + QDir::separator() + "KillerAPP.ini";
+    QVERIFY(QFile::exists(iniFileName));
+    const QDateTime iniModified = QFileInfo(iniFileName).lastModified();
+
+    QString indexedFileName;
+    {
+        QSettings settings(QSettings::IndexedFormat, QSettings::UserScope, "software.org", "KillerAPP");
+        indexedFileName = settings.fileName();
+        QVERIFY(indexedFileName.endsWith("KillerAPP.qsi"));
+        QCOMPARE(settings.value("alpha/beta").toInt(), 1);
+        QCOMPARE(settings.value("gamma").toStringList(), QStringList() << "x" << "y");
+        settings.setValue("delta", 2);
+    }
+    QVERIFY(QFile::exists(indexedFileName));
+    QCOMPARE(QFileInfo(iniFileName).lastModified(), iniModified);
+
+    // once the file exists, the INI file is not looked at anymore
+    {
+        QSettings ini(QSettings::IniFormat, QSettings::UserScope, "software.org", "KillerAPP");
+        ini.setValue("epsilon", 3);
+    }
+    {
+        QSettings settings(QSettings::IndexedFormat, QSettings::UserScope, "software.org", "KillerAPP");
+        QCOMPARE(settings.value("delta").toInt(), 2);
+        QCOMPARE(settings.value("alpha/beta").toInt(), 1);
+        QVERIFY(!settings.contains("epsilon"));
+    }
+}
+
 void tst_QSettings::testErrorHandling_data()
 {
     QTest::addColumn<int>("filePerms"); // -1 means file should not exist
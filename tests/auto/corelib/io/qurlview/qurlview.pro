@@ -0,0 +1,4 @@
+QT = core testlib
+TARGET = tst_qurlview
+CONFIG += testcase
+SOURCES += tst_qurlview.cpp
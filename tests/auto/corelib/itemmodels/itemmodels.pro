@@ -1,6 +1,7 @@
 TEMPLATE=subdirs
 
 SUBDIRS = qabstractitemmodel \
+    qabstractmodelfetcher \
     qstringlistmodel \
 
 qtHaveModule(gui): SUBDIRS += \
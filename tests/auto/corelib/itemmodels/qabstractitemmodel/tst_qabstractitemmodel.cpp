@@ -70,6 +70,8 @@ private slots:
     void reset();
 
     void complexChangesWithPersistent();
+    void persistentIndexesAcrossLevels();
+    void persistentIndexesAfterEdits();
 
     void testMoveSameParentUp_data();
     void testMoveSameParentUp();
@@ -961,6 +963,120 @@ void tst_QAbstractItemModel::complexChangesWithPersistent()
         QVERIFY(e[i] == model.index(2, i-2 , QModelIndex()));
 }
 
+static bool comparePersistentData(const QList<QPersistentModelIndex> &persistent, const QStringList &expected)
+{
+    for (int i = 0; i < persistent.count(); ++i) {
+        if (persistent.at(i).data().toString() != expected.at(i)) {
+            qWarning() << "persistent index" << i << "holds" << persistent.at(i).data() << "instead of" << expected.at(i);
+            return false;
+        }
+    }
+    return true;
+}
+
+void tst_QAbstractItemModel::persistentIndexesAcrossLevels()
+{
+    // persistent indexes of both top-level items and children of an item
+    QList<QPersistentModelIndex> persistentList;
+    QStringList expected;
+    const QModelIndex parent = m_model->index(5, 0);
+    for (int row = 0; row < 10; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            persistentList << m_model->index(row, column) << m_model->index(row, column, parent);
+            expected << m_model->index(row, column).data().toString()
+                     << m_model->index(row, column, parent).data().toString();
+        }
+    }
+    const QPersistentModelIndex persistentParent = parent;
+
+    ModelInsertCommand *insertCommand = new ModelInsertCommand(m_model, this);
+    insertCommand->setNumCols(4);
+    insertCommand->setStartRow(2);
+    insertCommand->setEndRow(4);
+    insertCommand->doCommand();
+    QCOMPARE(persistentParent.row(), 8);
+    QVERIFY(comparePersistentData(persistentList, expected));
+
+    insertCommand = new ModelInsertCommand(m_model, this);
+    insertCommand->setAncestorRowNumbers(QList<int>() << persistentParent.row());
+    insertCommand->setNumCols(4);
+    insertCommand->setStartRow(0);
+    insertCommand->setEndRow(1);
+    insertCommand->doCommand();
+    QVERIFY(comparePersistentData(persistentList, expected));
+
+    // top-level rows moving past the parent
+    ModelMoveCommand *moveCommand = new ModelMoveCommand(m_model, this);
+    moveCommand->setNumCols(4);
+    moveCommand->setStartRow(0);
+    moveCommand->setEndRow(1);
+    moveCommand->setDestRow(10);
+    moveCommand->doCommand();
+    QCOMPARE(persistentParent.row(), 6);
+    QVERIFY(comparePersistentData(persistentList, expected));
+
+    // children moving to the top level
+    moveCommand = new ModelMoveCommand(m_model, this);
+    moveCommand->setAncestorRowNumbers(QList<int>() << persistentParent.row());
+    moveCommand->setNumCols(4);
+    moveCommand->setStartRow(2);
+    moveCommand->setEndRow(5);
+    moveCommand->setDestAncestors(QList<int>());
+    moveCommand->setDestRow(1);
+    moveCommand->doCommand();
+    QCOMPARE(persistentParent.row(), 10);
+    QCOMPARE(m_model->rowCount(persistentParent), 8);
+    QVERIFY(comparePersistentData(persistentList, expected));
+
+    // top-level rows moving into the parent
+    moveCommand = new ModelMoveCommand(m_model, this);
+    moveCommand->setNumCols(4);
+    moveCommand->setStartRow(1);
+    moveCommand->setEndRow(3);
+    moveCommand->setDestAncestors(QList<int>() << persistentParent.row());
+    moveCommand->setDestRow(0);
+    moveCommand->doCommand();
+    QCOMPARE(persistentParent.row(), 7);
+    QCOMPARE(m_model->rowCount(persistentParent), 11);
+    QVERIFY(comparePersistentData(persistentList, expected));
+}
+
+void tst_QAbstractItemModel::persistentIndexesAfterEdits()
+{
+    QStringList strings;
+    for (int i = 0; i < 200; ++i)
+        strings << QString::number(i);
+    QStringListModel model(strings);
+
+    QList<QPersistentModelIndex> persistentList;
+    for (int row = 0; row < model.rowCount(); ++row)
+        persistentList << model.index(row, 0);
+    QStringList expected = strings;
+
+    qsrand(42);
+    for (int i = 0; i < 100; ++i) {
+        const int row = qrand() % model.rowCount();
+        const int count = 1 + qrand() % 5;
+        if (i % 3 == 2) {
+            model.removeRows(row, qMin(count, model.rowCount() - row));
+            for (int j = 0; j < persistentList.count(); ++j) {
+                if (!persistentList.at(j).isValid())
+                    expected[j].clear();
+            }
+        } else {
+            model.insertRows(row, count);
+        }
+        QVERIFY(comparePersistentData(persistentList, expected));
+        for (const QPersistentModelIndex &index : qAsConst(persistentList)) {
+            if (index.isValid())
+                QCOMPARE(model.index(index.row(), 0), QModelIndex(index));
+        }
+    }
+    const QStringList remaining = model.stringList();
+    for (int j = 0; j < persistentList.count(); ++j)
+        QCOMPARE(persistentList.at(j).isValid(), remaining.contains(strings.at(j)));
+}
+
 void tst_QAbstractItemModel::testMoveSameParentDown_data()
 {
     QTest::addColumn<int>("startRow");
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qabstractmodelfetcher
+QT = core testlib
+SOURCES += tst_qabstractmodelfetcher.cpp
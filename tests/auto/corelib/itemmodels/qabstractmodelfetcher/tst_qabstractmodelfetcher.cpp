@@ -0,0 +1,243 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <qabstractmodelfetcher.h>
+#include <qsemaphore.h>
+#include <qstringlistmodel.h>
+
+// Produces the numbers [first, first + count) in chunks. When a gate is set,
+// it waits for the gate after the first chunk.
+class NumberFetcher : public QAbstractModelFetcher
+{
+public:
+    NumberFetcher() : gate(Q_NULLPTR) {}
+    ~NumberFetcher()
+    {
+        cancelAll();
+        waitForFinished();
+    }
+
+    static QVariant argument(int first, int count, int chunk)
+    {
+        return QVariantList() << first << count << chunk;
+    }
+
+    QSemaphore *gate;
+
+protected:
+    void fetchRows(const QVariant &argument) Q_DECL_OVERRIDE
+    {
+        const QVariantList arguments = argument.toList();
+        const int first = arguments.at(0).toInt();
+        const int count = arguments.at(1).toInt();
+        const int chunk = arguments.at(2).toInt();
+        for (int i = 0; i < count && !isCanceled(); i += chunk) {
+            QVariantList rows;
+            for (int j = i; j < qMin(count, i + chunk); ++j)
+                rows.append(first + j);
+            addRows(rows);
+            if (gate && i == 0)
+                gate->acquire();
+        }
+    }
+};
+
+class tst_QAbstractModelFetcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fetch();
+    void coalesce();
+    void order();
+    void cancel();
+    void parentRemoved();
+    void updateInterval();
+};
+
+static QVariantList numbers(int first, int count)
+{
+    QVariantList result;
+    for (int i = 0; i < count; ++i)
+        result.append(first + i);
+    return result;
+}
+
+void tst_QAbstractModelFetcher::fetch()
+{
+    NumberFetcher fetcher;
+    QSignalSpy rowsSpy(&fetcher, &QAbstractModelFetcher::rowsFetched);
+    QSignalSpy finishedSpy(&fetcher, &QAbstractModelFetcher::finished);
+
+    QVERIFY(!fetcher.isActive());
+    fetcher.fetch(QModelIndex(), NumberFetcher::argument(0, 1000, 10));
+    QVERIFY(fetcher.isActive());
+    QVERIFY(fetcher.isFetching(QModelIndex()));
+
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QVERIFY(!fetcher.isActive());
+    QVERIFY(!fetcher.isFetching(QModelIndex()));
+    QVERIFY(!finishedSpy.at(0).at(0).value<QModelIndex>().isValid());
+
+    QVariantList rows;
+    for (const QList<QVariant> &arguments : qAsConst(rowsSpy)) {
+        QVERIFY(!arguments.at(0).value<QModelIndex>().isValid());
+        rows += arguments.at(1).toList();
+    }
+    QCOMPARE(rows, numbers(0, 1000));
+}
+
+void tst_QAbstractModelFetcher::coalesce()
+{
+    NumberFetcher fetcher;
+    QSignalSpy rowsSpy(&fetcher, &QAbstractModelFetcher::rowsFetched);
+    QSignalSpy finishedSpy(&fetcher, &QAbstractModelFetcher::finished);
+
+    // all chunks arrive before the event loop runs
+    fetcher.fetch(QModelIndex(), NumberFetcher::argument(0, 1000, 10));
+    QVERIFY(fetcher.waitForFinished());
+    QCOMPARE(rowsSpy.count(), 1);
+    QCOMPARE(rowsSpy.at(0).at(1).toList(), numbers(0, 1000));
+    QCOMPARE(finishedSpy.count(), 1);
+
+    // nothing is left for the queued delivery
+    QCoreApplication::processEvents();
+    QCOMPARE(rowsSpy.count(), 1);
+    QCOMPARE(finishedSpy.count(), 1);
+}
+
+void tst_QAbstractModelFetcher::order()
+{
+    QStringListModel model(QStringList() << "a" << "b" << "c");
+    NumberFetcher fetcher;
+    QSignalSpy rowsSpy(&fetcher, &QAbstractModelFetcher::rowsFetched);
+    QSignalSpy finishedSpy(&fetcher, &QAbstractModelFetcher::finished);
+
+    fetcher.fetch(model.index(2, 0), NumberFetcher::argument(0, 5, 5));
+    fetcher.fetch(model.index(0, 0), NumberFetcher::argument(100, 5, 5));
+    QVERIFY(fetcher.isFetching(model.index(0, 0)));
+    QVERIFY(!fetcher.isFetching(model.index(1, 0)));
+    QVERIFY(!fetcher.isFetching(QModelIndex()));
+    QVERIFY(fetcher.waitForFinished());
+
+    QCOMPARE(rowsSpy.count(), 2);
+    QCOMPARE(rowsSpy.at(0).at(0).value<QModelIndex>(), model.index(2, 0));
+    QCOMPARE(rowsSpy.at(0).at(1).toList(), numbers(0, 5));
+    QCOMPARE(rowsSpy.at(1).at(0).value<QModelIndex>(), model.index(0, 0));
+    QCOMPARE(rowsSpy.at(1).at(1).toList(), numbers(100, 5));
+    QCOMPARE(finishedSpy.count(), 2);
+    QCOMPARE(finishedSpy.at(0).at(0).value<QModelIndex>(), model.index(2, 0));
+    QCOMPARE(finishedSpy.at(1).at(0).value<QModelIndex>(), model.index(0, 0));
+}
+
+void tst_QAbstractModelFetcher::cancel()
+{
+    QStringListModel model(QStringList() << "a" << "b");
+    QSemaphore gate;
+    NumberFetcher fetcher;
+    fetcher.gate = &gate;
+    QSignalSpy rowsSpy(&fetcher, &QAbstractModelFetcher::rowsFetched);
+    QSignalSpy finishedSpy(&fetcher, &QAbstractModelFetcher::finished);
+
+    fetcher.fetch(model.index(0, 0), NumberFetcher::argument(0, 100, 10));
+    fetcher.fetch(model.index(1, 0), NumberFetcher::argument(0, 100, 10));
+    fetcher.cancel(model.index(0, 0));
+    QVERIFY(!fetcher.isFetching(model.index(0, 0)));
+    QVERIFY(fetcher.isFetching(model.index(1, 0)));
+    gate.release(2);
+    QVERIFY(fetcher.waitForFinished());
+    QCOMPARE(rowsSpy.count(), 1);
+    QCOMPARE(rowsSpy.at(0).at(0).value<QModelIndex>(), model.index(1, 0));
+    QCOMPARE(rowsSpy.at(0).at(1).toList(), numbers(0, 100));
+    QCOMPARE(finishedSpy.count(), 1);
+    // the canceled fetch may not have started
+    gate.tryAcquire(gate.available());
+
+    // canceling stops a running fetch
+    rowsSpy.clear();
+    finishedSpy.clear();
+    fetcher.fetch(QModelIndex(), NumberFetcher::argument(0, 100, 10));
+    QTRY_COMPARE(rowsSpy.count(), 1);
+    fetcher.cancelAll();
+    QVERIFY(!fetcher.isActive());
+    gate.release();
+    QVERIFY(fetcher.waitForFinished());
+    QCoreApplication::processEvents();
+    QCOMPARE(rowsSpy.count(), 1);
+    QCOMPARE(rowsSpy.at(0).at(1).toList(), numbers(0, 10));
+    QCOMPARE(finishedSpy.count(), 0);
+}
+
+void tst_QAbstractModelFetcher::parentRemoved()
+{
+    QStringListModel model(QStringList() << "a" << "b" << "c");
+    QSemaphore gate;
+    NumberFetcher fetcher;
+    fetcher.gate = &gate;
+    QSignalSpy rowsSpy(&fetcher, &QAbstractModelFetcher::rowsFetched);
+    QSignalSpy finishedSpy(&fetcher, &QAbstractModelFetcher::finished);
+
+    fetcher.fetch(model.index(1, 0), NumberFetcher::argument(0, 100, 10));
+    model.removeRows(1, 1);
+    gate.release();
+    QVERIFY(fetcher.waitForFinished());
+    QCOMPARE(rowsSpy.count(), 0);
+    QCOMPARE(finishedSpy.count(), 0);
+    QVERIFY(!fetcher.isActive());
+}
+
+void tst_QAbstractModelFetcher::updateInterval()
+{
+    NumberFetcher fetcher;
+    QCOMPARE(fetcher.updateInterval(), 0);
+    fetcher.setUpdateInterval(-5);
+    QCOMPARE(fetcher.updateInterval(), 0);
+    fetcher.setUpdateInterval(200);
+    QCOMPARE(fetcher.updateInterval(), 200);
+
+    QSemaphore gate;
+    fetcher.gate = &gate;
+    QSignalSpy rowsSpy(&fetcher, &QAbstractModelFetcher::rowsFetched);
+    QSignalSpy finishedSpy(&fetcher, &QAbstractModelFetcher::finished);
+
+    QElapsedTimer timer;
+    timer.start();
+    fetcher.fetch(QModelIndex(), NumberFetcher::argument(0, 100, 10));
+    QTRY_COMPARE(rowsSpy.count(), 1);
+    gate.release();
+    // the rest arrives within the interval and is delivered at once
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QCOMPARE(rowsSpy.count(), 2);
+    QVERIFY(timer.elapsed() >= 200);
+    QCOMPARE(rowsSpy.at(1).at(1).toList(), numbers(10, 90));
+}
+
+QTEST_MAIN(tst_QAbstractModelFetcher)
+#include "tst_qabstractmodelfetcher.moc"
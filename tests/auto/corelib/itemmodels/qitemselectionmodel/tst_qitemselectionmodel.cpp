@@ -92,6 +92,11 @@ private slots:
     void QTBUG48402_data();
     void QTBUG48402();
 
+    void mergeManyRanges();
+    void selectedLinesOrder();
+    void selectedLinesUnselectable();
+    void mergeOrder();
+
 private:
     QAbstractItemModel *model;
     QItemSelectionModel *selection;
@@ -2848,5 +2853,285 @@ void tst_QItemSelectionModel::QTBUG48402()
     QCOMPARE(QItemSelectionRange(helper.tl, helper.br), QItemSelectionRange(dtl, dbr));
 }
 
+static QItemSelection randomSelection(const QAbstractItemModel *model, int maxRanges)
+{
+    QItemSelection result;
+    const int rows = model->rowCount();
+    const int columns = model->columnCount();
+    const int count = 1 + qrand() % maxRanges;
+    for (int i = 0; i < count; ++i) {
+        const int top = qrand() % rows;
+        const int left = qrand() % columns;
+        const int bottom = qMin(rows - 1, top + qrand() % 4);
+        const int right = qMin(columns - 1, left + qrand() % 3);
+        result.select(model->index(top, left), model->index(bottom, right));
+    }
+    return result;
+}
+
+static QSet<QPersistentModelIndex> selectedSet(const QModelIndexList &indexes)
+{
+    QSet<QPersistentModelIndex> result;
+    for (const QModelIndex &index : indexes)
+        result.insert(index);
+    return result;
+}
+
+void tst_QItemSelectionModel::mergeManyRanges()
+{
+    QStandardItemModel model(40, 12);
+    qsrand(4404);
+
+    QVector<QBitArray> expected(model.rowCount(), QBitArray(model.columnCount()));
+    QItemSelection selection;
+    const QItemSelectionModel::SelectionFlag commands[] = {
+        QItemSelectionModel::Select, QItemSelectionModel::Deselect, QItemSelectionModel::Toggle
+    };
+    for (int step = 0; step < 300; ++step) {
+        // enough ranges on both sides to exercise the indexed intersection search
+        const QItemSelection other = randomSelection(&model, 60);
+        const QItemSelectionModel::SelectionFlag command = commands[qrand() % 3];
+        selection.merge(other, command);
+
+        for (int row = 0; row < model.rowCount(); ++row) {
+            for (int column = 0; column < model.columnCount(); ++column) {
+                const bool inOther = other.contains(model.index(row, column));
+                if (command == QItemSelectionModel::Select)
+                    expected[row][column] = expected[row][column] || inOther;
+                else if (command == QItemSelectionModel::Deselect)
+                    expected[row][column] = expected[row][column] && !inOther;
+                else
+                    expected[row][column] = expected[row][column] != inOther;
+            }
+        }
+        for (int row = 0; row < model.rowCount(); ++row) {
+            for (int column = 0; column < model.columnCount(); ++column)
+                QCOMPARE(selection.contains(model.index(row, column)), bool(expected[row][column]));
+        }
+    }
+}
+
+void tst_QItemSelectionModel::selectedLinesOrder()
+{
+    QStandardItemModel model(30, 8);
+    qsrand(4406);
+    for (int row = 0; row < model.rowCount(); ++row) {
+        for (int column = 0; column < model.columnCount(); ++column) {
+            QStandardItem *item = new QStandardItem;
+            if (qrand() % 12 == 0)
+                item->setSelectable(false);
+            else if (qrand() % 24 == 0)
+                item->setEnabled(false);
+            model.setItem(row, column, item);
+        }
+    }
+
+    QItemSelectionModel selectionModel(&model);
+    QSignalSpy spy(&selectionModel, &QItemSelectionModel::selectionChanged);
+    qsrand(4405);
+    const QItemSelectionModel::SelectionFlags commands[] = {
+        QItemSelectionModel::Select, QItemSelectionModel::Deselect, QItemSelectionModel::Toggle,
+        QItemSelectionModel::Select | QItemSelectionModel::Rows,
+        QItemSelectionModel::Select | QItemSelectionModel::Columns,
+        QItemSelectionModel::Toggle | QItemSelectionModel::Current,
+        QItemSelectionModel::Deselect | QItemSelectionModel::Current
+    };
+    for (int step = 0; step < 200; ++step) {
+        const QSet<QPersistentModelIndex> before = selectedSet(selectionModel.selectedIndexes());
+        spy.clear();
+        if (step % 50 == 0)
+            selectionModel.select(QItemSelection(model.index(0, 0), model.index(29, 7)),
+                                  QItemSelectionModel::Select);
+        else
+            selectionModel.select(randomSelection(&model, 8), commands[qrand() % 7]);
+        const QSet<QPersistentModelIndex> after = selectedSet(selectionModel.selectedIndexes());
+
+        QSet<QPersistentModelIndex> selected;
+        QSet<QPersistentModelIndex> deselected;
+        if (!spy.isEmpty()) {
+            QCOMPARE(spy.count(), 1);
+            selected = selectedSet(spy.at(0).at(0).value<QItemSelection>().indexes());
+            deselected = selectedSet(spy.at(0).at(1).value<QItemSelection>().indexes());
+        }
+        QCOMPARE(selected, after - before);
+        QCOMPARE(deselected, before - after);
+
+        // the rows and columns are reported in the order in which the ranges cover them
+        const QItemSelection ranges = selectionModel.selection();
+        QModelIndexList expectedRows;
+        QModelIndexList expectedColumns;
+        QSet<QPair<QModelIndex, int> > rowsSeen;
+        QSet<QPair<QModelIndex, int> > columnsSeen;
+        for (const QItemSelectionRange &range : ranges) {
+            for (int row = range.top(); row <= range.bottom(); ++row) {
+                if (!rowsSeen.contains(qMakePair(range.parent(), row))) {
+                    rowsSeen.insert(qMakePair(range.parent(), row));
+                    if (selectionModel.isRowSelected(row, range.parent()))
+                        expectedRows.append(model.index(row, 1, range.parent()));
+                }
+            }
+            for (int column = range.left(); column <= range.right(); ++column) {
+                if (!columnsSeen.contains(qMakePair(range.parent(), column))) {
+                    columnsSeen.insert(qMakePair(range.parent(), column));
+                    if (selectionModel.isColumnSelected(column, range.parent()))
+                        expectedColumns.append(model.index(2, column, range.parent()));
+                }
+            }
+        }
+        QCOMPARE(selectionModel.selectedRows(1), expectedRows);
+        QCOMPARE(selectionModel.selectedColumns(2), expectedColumns);
+    }
+}
+
+void tst_QItemSelectionModel::selectedLinesUnselectable()
+{
+    QStandardItemModel model(30, 3);
+    for (int row = 0; row < model.rowCount(); ++row) {
+        for (int column = 0; column < model.columnCount(); ++column)
+            model.setItem(row, column, new QStandardItem);
+    }
+    model.item(10, 2)->setSelectable(false);
+
+    // The last selection is kept apart from the stored ranges, which are only
+    // split when merging them for selection(). Row 10 is not selected as
+    // column 2 is only covered by its unselectable item, although the piece
+    // of the selection covering columns 1 and 2 contains a selectable one.
+    QItemSelectionModel selectionModel(&model);
+    selectionModel.select(QItemSelection(model.index(10, 0), model.index(11, 1)), QItemSelectionModel::Select);
+    selectionModel.select(QItemSelection(model.index(8, 1), model.index(10, 2)), QItemSelectionModel::Select);
+    QVERIFY(!selectionModel.isRowSelected(10, QModelIndex()));
+    QCOMPARE(selectionModel.selectedRows(), QModelIndexList());
+
+    // once stored, the ranges are split and the piece does select row 10
+    selectionModel.select(QItemSelection(model.index(8, 0), model.index(9, 0)), QItemSelectionModel::Select);
+    QVERIFY(selectionModel.isRowSelected(10, QModelIndex()));
+    QCOMPARE(selectionModel.selectedRows(),
+             QModelIndexList() << model.index(10, 0) << model.index(8, 0) << model.index(9, 0));
+}
+
+// The loops QItemSelection::merge() and QItemSelectionModel::emitSelectionChanged()
+// used to run over every pair of ranges, to compare the order of the ranges with.
+static void referenceSplit(QItemSelection *selection, const QItemSelection &intersections)
+{
+    for (const QItemSelectionRange &intersection : intersections) {
+        for (int t = 0; t < selection->count();) {
+            if (selection->at(t).intersects(intersection)) {
+                QItemSelection::split(selection->at(t), intersection, selection);
+                selection->removeAt(t);
+            } else {
+                ++t;
+            }
+        }
+    }
+}
+
+static QItemSelection referenceMerge(const QItemSelection &selection, const QItemSelection &other,
+                                     QItemSelectionModel::SelectionFlags command)
+{
+    QItemSelection result = selection;
+    QItemSelection newSelection;
+    for (const QItemSelectionRange &range : other) {
+        if (range.isValid())
+            newSelection.append(range);
+    }
+    QItemSelection intersections;
+    for (const QItemSelectionRange &range : qAsConst(newSelection)) {
+        for (const QItemSelectionRange &existing : qAsConst(result)) {
+            if (range.intersects(existing))
+                intersections.append(existing.intersected(range));
+        }
+    }
+    referenceSplit(&result, intersections);
+    if (command & QItemSelectionModel::Toggle)
+        referenceSplit(&newSelection, intersections);
+    if (!(command & QItemSelectionModel::Deselect))
+        result += newSelection;
+    return result;
+}
+
+static void referenceChanges(const QItemSelection &newSelection, const QItemSelection &oldSelection,
+                             QItemSelection *selected, QItemSelection *deselected)
+{
+    *deselected = oldSelection;
+    *selected = newSelection;
+    bool advance;
+    for (int o = 0; o < deselected->count(); ++o) {
+        advance = true;
+        for (int s = 0; s < selected->count() && o < deselected->count();) {
+            if (deselected->at(o) == selected->at(s)) {
+                deselected->removeAt(o);
+                selected->removeAt(s);
+                advance = false;
+            } else {
+                ++s;
+            }
+        }
+        if (advance)
+            ++o;
+    }
+    QItemSelection intersections;
+    for (const QItemSelectionRange &o : qAsConst(*deselected)) {
+        for (const QItemSelectionRange &s : qAsConst(*selected)) {
+            if (o.intersects(s))
+                intersections.append(o.intersected(s));
+        }
+    }
+    referenceSplit(deselected, intersections);
+    referenceSplit(selected, intersections);
+}
+
+class EmittingSelectionModel : public QItemSelectionModel
+{
+public:
+    explicit EmittingSelectionModel(QAbstractItemModel *model) : QItemSelectionModel(model) {}
+    using QItemSelectionModel::emitSelectionChanged;
+};
+
+void tst_QItemSelectionModel::mergeOrder()
+{
+    QStandardItemModel model(20, 6);
+    EmittingSelectionModel selectionModel(&model);
+    QSignalSpy spy(&selectionModel, &QItemSelectionModel::selectionChanged);
+    qsrand(4407);
+
+    const QItemSelectionModel::SelectionFlag commands[] = {
+        QItemSelectionModel::Select, QItemSelectionModel::Deselect, QItemSelectionModel::Toggle
+    };
+    QItemSelection selection;
+    for (int step = 0; step < 300; ++step) {
+        // few ranges are split by the intersections in turn, many are indexed
+        const QItemSelection other = randomSelection(&model, step % 2 ? 4 : 30);
+        const QItemSelectionModel::SelectionFlag command = commands[qrand() % 3];
+        const QItemSelection expected = referenceMerge(selection, other, command);
+        QItemSelection merged = selection;
+        merged.merge(other, command);
+        QCOMPARE(merged, expected);
+
+        // with ranges in common, repeated and overlapping
+        QItemSelection newSelection = merged;
+        for (int i = 0; i < newSelection.size(); ++i) {
+            if (qrand() % 3 == 0)
+                newSelection.removeAt(i);
+            else if (qrand() % 8 == 0)
+                newSelection.insert(qrand() % newSelection.size(), newSelection.at(i));
+        }
+        newSelection += randomSelection(&model, 6);
+        std::swap(newSelection[qrand() % newSelection.size()], newSelection[qrand() % newSelection.size()]);
+        QItemSelection expectedSelected;
+        QItemSelection expectedDeselected;
+        referenceChanges(newSelection, merged, &expectedSelected, &expectedDeselected);
+        spy.clear();
+        selectionModel.emitSelectionChanged(newSelection, merged);
+        if (expectedSelected.isEmpty() && expectedDeselected.isEmpty() && newSelection != merged) {
+            QVERIFY(spy.isEmpty());
+        } else if (newSelection != merged) {
+            QCOMPARE(spy.count(), 1);
+            QCOMPARE(spy.at(0).at(0).value<QItemSelection>(), expectedSelected);
+            QCOMPARE(spy.at(0).at(1).value<QItemSelection>(), expectedDeselected);
+        }
+        selection = merged;
+    }
+}
+
 QTEST_MAIN(tst_QItemSelectionModel)
 #include "tst_qitemselectionmodel.moc"
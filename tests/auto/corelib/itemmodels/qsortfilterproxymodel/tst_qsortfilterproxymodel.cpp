@@ -143,6 +143,13 @@ private slots:
     void noMapAfterSourceDelete();
     void forwardDropApi();
     void canDropMimeData();
+    void parallelSortFilter_data();
+    void parallelSortFilter();
+    void narrowingFilter();
+    void narrowingFilterReimplemented();
+    void narrowingFilterNotDynamic();
+    void sortKeyCache();
+    void insertIntoSortedOrder();
 
 protected:
     void buildHierarchy(const QStringList &data, QAbstractItemModel *model);
@@ -4123,5 +4130,262 @@ void tst_QSortFilterProxyModel::resortingDoesNotBreakTreeModels()
     QCOMPARE(proxy.rowCount(pi1), 1);
 }
 
+// A read-only model whose data() can be called from several threads
+class ConstStringListModel : public QAbstractListModel
+{
+public:
+    explicit ConstStringListModel(const QStringList &strings) : strings(strings) {}
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE
+    {
+        return parent.isValid() ? 0 : strings.size();
+    }
+
+    QVariant data(const QModelIndex &index, int role) const Q_DECL_OVERRIDE
+    {
+        if (role != Qt::DisplayRole)
+            return QVariant();
+        return strings.at(index.row());
+    }
+
+private:
+    const QStringList strings;
+};
+
+static QStringList proxyContents(const QSortFilterProxyModel &proxy)
+{
+    QStringList result;
+    for (int row = 0; row < proxy.rowCount(); ++row)
+        result << QString::number(proxy.mapToSource(proxy.index(row, 0)).row());
+    return result;
+}
+
+void tst_QSortFilterProxyModel::parallelSortFilter_data()
+{
+    QTest::addColumn<int>("sortColumn");
+    QTest::addColumn<Qt::SortOrder>("sortOrder");
+
+    QTest::newRow("unsorted") << -1 << Qt::AscendingOrder;
+    QTest::newRow("ascending") << 0 << Qt::AscendingOrder;
+    QTest::newRow("descending") << 0 << Qt::DescendingOrder;
+}
+
+void tst_QSortFilterProxyModel::parallelSortFilter()
+{
+    QFETCH(int, sortColumn);
+    QFETCH(Qt::SortOrder, sortOrder);
+
+    // many duplicates, so that the stability of the sort matters
+    QStringList strings;
+    for (int i = 0; i < 50000; ++i)
+        strings << QString::number((i * 7919) % 1000);
+    ConstStringListModel model(strings);
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int maxThreadCount = pool->maxThreadCount();
+    pool->setMaxThreadCount(4);
+
+    QSortFilterProxyModel sequential;
+    sequential.setSourceModel(&model);
+    QSortFilterProxyModel parallel;
+    QVERIFY(!parallel.parallelSortFilter());
+    parallel.setParallelSortFilter(true);
+    QVERIFY(parallel.parallelSortFilter());
+    parallel.setSourceModel(&model);
+
+    sequential.sort(sortColumn, sortOrder);
+    parallel.sort(sortColumn, sortOrder);
+    QCOMPARE(parallel.rowCount(), strings.size());
+    QCOMPARE(proxyContents(parallel), proxyContents(sequential));
+
+    // narrowing, widening and replacing the filter
+    const char *patterns[] = { "1", "12", "2", "", "^9" };
+    for (const char *pattern : patterns) {
+        sequential.setFilterRegExp(QLatin1String(pattern));
+        parallel.setFilterRegExp(QLatin1String(pattern));
+        QCOMPARE(parallel.rowCount(), sequential.rowCount());
+        QCOMPARE(proxyContents(parallel), proxyContents(sequential));
+    }
+
+    // a mapping created from scratch
+    parallel.invalidate();
+    QCOMPARE(proxyContents(parallel), proxyContents(sequential));
+
+    pool->setMaxThreadCount(maxThreadCount);
+}
+
+class CountingFilterProxyModel : public QSortFilterProxyModel
+{
+public:
+    CountingFilterProxyModel() : calls(0), inverted(false) {}
+
+    mutable int calls;
+    bool inverted;
+
+protected:
+    bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const Q_DECL_OVERRIDE
+    {
+        ++calls;
+        return QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent) != inverted;
+    }
+};
+
+static QStringList numberStrings(int count)
+{
+    QStringList strings;
+    for (int i = 0; i < count; ++i)
+        strings << QString::number(i);
+    return strings;
+}
+
+static QStringList proxyStrings(const QAbstractItemModel &proxy)
+{
+    QStringList result;
+    for (int row = 0; row < proxy.rowCount(); ++row)
+        result << proxy.index(row, 0).data().toString();
+    return result;
+}
+
+void tst_QSortFilterProxyModel::narrowingFilter()
+{
+    QStringListModel model(numberStrings(1000));
+    CountingFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    QCOMPARE(proxy.rowCount(), 1000);
+
+    proxy.calls = 0;
+    proxy.setFilterFixedString(QStringLiteral("1"));
+    QCOMPARE(proxy.calls, 1000);
+    const int accepted = proxy.rowCount();
+    QCOMPARE(accepted, 1000 - 9 * 9 * 9); // all but the numbers without any 1
+
+    // typing ahead only tests the rows that are shown
+    proxy.calls = 0;
+    proxy.setFilterFixedString(QStringLiteral("12"));
+    QCOMPARE(proxy.calls, accepted);
+    QCOMPARE(proxyStrings(proxy), model.stringList().filter(QStringLiteral("12")));
+
+    // as does making the filter case sensitive
+    proxy.setFilterCaseSensitivity(Qt::CaseInsensitive);
+    proxy.calls = 0;
+    proxy.setFilterCaseSensitivity(Qt::CaseSensitive);
+    QCOMPARE(proxy.calls, proxy.rowCount());
+
+    // deleting a letter tests all rows again
+    proxy.calls = 0;
+    proxy.setFilterFixedString(QStringLiteral("2"));
+    QCOMPARE(proxy.calls, 1000);
+    QCOMPARE(proxyStrings(proxy), model.stringList().filter(QStringLiteral("2")));
+
+    // a regular expression is not analyzed
+    proxy.calls = 0;
+    proxy.setFilterRegExp(QStringLiteral("2$"));
+    QCOMPARE(proxy.calls, 1000);
+}
+
+void tst_QSortFilterProxyModel::narrowingFilterReimplemented()
+{
+    QStringListModel model(numberStrings(1000));
+    CountingFilterProxyModel proxy;
+    proxy.inverted = true;
+    proxy.setSourceModel(&model);
+    proxy.setFilterFixedString(QStringLiteral("1"));
+    QCOMPARE(proxy.rowCount(), 9 * 9 * 9);
+
+    // rows that are filtered out now may come back
+    proxy.calls = 0;
+    proxy.setFilterFixedString(QStringLiteral("12"));
+    QCOMPARE(proxy.calls, 1000);
+    QCOMPARE(proxy.rowCount(), 1000 - model.stringList().filter(QStringLiteral("12")).size());
+}
+
+void tst_QSortFilterProxyModel::narrowingFilterNotDynamic()
+{
+    QStringListModel model(QStringList() << "1" << "a" << "12x" << "b");
+    QSortFilterProxyModel proxy;
+    proxy.setDynamicSortFilter(false);
+    proxy.setSourceModel(&model);
+    proxy.setFilterFixedString(QStringLiteral("1"));
+    QCOMPARE(proxyStrings(proxy), QStringList() << "1" << "12x");
+
+    // the proxy doesn't filter the changed row, the next filter has to
+    QVERIFY(model.setData(model.index(1, 0), QStringLiteral("123")));
+    QCOMPARE(proxyStrings(proxy), QStringList() << "1" << "12x");
+    proxy.setFilterFixedString(QStringLiteral("12"));
+    QCOMPARE(proxyStrings(proxy), QStringList() << "123" << "12x");
+}
+
+class DataCountingModel : public QStringListModel
+{
+public:
+    explicit DataCountingModel(const QStringList &strings) : QStringListModel(strings), userRoleCalls(0) {}
+
+    QVariant data(const QModelIndex &index, int role) const Q_DECL_OVERRIDE
+    {
+        if (role != Qt::UserRole)
+            return QStringListModel::data(index, role);
+        ++userRoleCalls;
+        return QStringListModel::data(index, Qt::DisplayRole);
+    }
+
+    mutable int userRoleCalls;
+};
+
+void tst_QSortFilterProxyModel::sortKeyCache()
+{
+    QStringList strings = numberStrings(1000);
+    std::reverse(strings.begin(), strings.end());
+    DataCountingModel model(strings);
+    QSortFilterProxyModel proxy;
+    proxy.setSortRole(Qt::UserRole);
+    proxy.setSourceModel(&model);
+
+    proxy.sort(0);
+    QCOMPARE(model.userRoleCalls, 1000);
+    QStringList sorted = strings;
+    sorted.sort();
+    QCOMPARE(proxyStrings(proxy), sorted);
+
+    model.userRoleCalls = 0;
+    proxy.sort(0, Qt::DescendingOrder);
+    QCOMPARE(model.userRoleCalls, 1000);
+    std::reverse(sorted.begin(), sorted.end());
+    QCOMPARE(proxyStrings(proxy), sorted);
+}
+
+void tst_QSortFilterProxyModel::insertIntoSortedOrder()
+{
+    QStringListModel model;
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.setFilterFixedString(QStringLiteral("7"));
+    proxy.sort(0);
+    ModelTest modelTest(&proxy);
+
+    QStringList expected;
+    QSignalSpy insertSpy(&proxy, &QAbstractItemModel::rowsInserted);
+    quint32 seed = 42;
+    for (int batch = 0; batch < 50; ++batch) {
+        const int count = 1 + batch % 7;
+        const int row = model.rowCount() ? int(seed % model.rowCount()) : 0;
+        model.insertRows(row, count);
+        for (int i = 0; i < count; ++i) {
+            seed = seed * 1664525 + 1013904223;
+            const QString string = QString::number(seed % 1000);
+            model.setData(model.index(row + i, 0), string);
+            if (string.contains(QLatin1Char('7')))
+                expected << string;
+        }
+    }
+    QVERIFY(!insertSpy.isEmpty());
+    expected.sort();
+    QCOMPARE(proxyStrings(proxy), expected);
+
+    for (int proxyRow = 0; proxyRow < proxy.rowCount(); ++proxyRow) {
+        const QModelIndex sourceIndex = proxy.mapToSource(proxy.index(proxyRow, 0));
+        QCOMPARE(proxy.mapFromSource(sourceIndex).row(), proxyRow);
+    }
+}
+
 QTEST_MAIN(tst_QSortFilterProxyModel)
 #include "tst_qsortfilterproxymodel.moc"
@@ -2,7 +2,8 @@ TEMPLATE=subdirs
 
 SUBDIRS = \
     qmimetype \
-    qmimedatabase
+    qmimedatabase \
+    qmimeembeddedcache
 
 !contains(QT_CONFIG, private_tests): SUBDIRS -= \
     qmimetype
@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_qmimeembeddedcache
+QT = core testlib
+
+SOURCES = tst_qmimeembeddedcache.cpp
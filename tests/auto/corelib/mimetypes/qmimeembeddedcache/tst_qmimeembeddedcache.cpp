@@ -0,0 +1,248 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QMimeDatabase>
+#include <QXmlStreamReader>
+
+// Without a system mime.cache or MIME packages, QMimeDatabase uses the cache
+// embedded in QtCore; check it against the embedded freedesktop.org.xml.
+
+struct MimeTypeData
+{
+    QString comment;
+    QStringList globPatterns;
+    QStringList aliases;
+    QStringList parents;
+    QString genericIconName;
+};
+
+static QStringList warnings;
+
+static void recordWarnings(QtMsgType type, const QMessageLogContext &, const QString &message)
+{
+    if (type != QtDebugMsg)
+        warnings.append(message);
+}
+
+class tst_QMimeEmbeddedCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void allMimeTypes();
+    void mimeTypeForName_data();
+    void mimeTypeForName();
+    void mimeTypeForFileName_data();
+    void mimeTypeForFileName();
+    void mimeTypeForData_data();
+    void mimeTypeForData();
+    void mimeTypeForFile();
+
+private:
+    QTemporaryDir m_temporaryDir;
+    QMap<QString, MimeTypeData> m_mimeTypes;
+};
+
+void tst_QMimeEmbeddedCache::initTestCase()
+{
+    QVERIFY2(m_temporaryDir.isValid(), qPrintable(m_temporaryDir.errorString()));
+    QStandardPaths::setTestModeEnabled(true);
+    const QString localMimeDir = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QLatin1String("/mime");
+    if (QDir(localMimeDir).exists())
+        QVERIFY(QDir(localMimeDir).removeRecursively());
+    qputenv("XDG_DATA_DIRS", QFile::encodeName(m_temporaryDir.path()));
+    qunsetenv("QT_NO_MIME_CACHE");
+
+    QFile package(QStringLiteral(":/qt-project.org/qmime/freedesktop.org.xml"));
+    QVERIFY(package.open(QIODevice::ReadOnly));
+    QXmlStreamReader xml(&package);
+    QVERIFY(xml.readNextStartElement());
+    while (xml.readNextStartElement()) {
+        QCOMPARE(xml.name().toString(), QStringLiteral("mime-type"));
+        MimeTypeData &data = m_mimeTypes[xml.attributes().value(QLatin1String("type")).toString()];
+        while (xml.readNextStartElement()) {
+            const QStringRef tag = xml.name();
+            const QXmlStreamAttributes attributes = xml.attributes();
+            if (tag == QLatin1String("comment")) {
+                const bool english = attributes.value(QLatin1String("xml:lang")).isEmpty();
+                const QString text = xml.readElementText();
+                if (english)
+                    data.comment = text;
+                continue;
+            } else if (tag == QLatin1String("glob")) {
+                data.globPatterns.append(attributes.value(QLatin1String("pattern")).toString());
+            } else if (tag == QLatin1String("alias")) {
+                data.aliases.append(attributes.value(QLatin1String("type")).toString());
+            } else if (tag == QLatin1String("sub-class-of")) {
+                data.parents.append(attributes.value(QLatin1String("type")).toString());
+            } else if (tag == QLatin1String("generic-icon")) {
+                data.genericIconName = attributes.value(QLatin1String("name")).toString();
+            }
+            xml.skipCurrentElement();
+        }
+    }
+    QVERIFY2(!xml.hasError(), qPrintable(xml.errorString()));
+    QVERIFY(m_mimeTypes.count() > 500);
+
+    // a cache that doesn't match the XML is rejected with a warning
+    const QtMessageHandler oldHandler = qInstallMessageHandler(recordWarnings);
+    QMimeDatabase().mimeTypeForName(QStringLiteral("text/plain"));
+    qInstallMessageHandler(oldHandler);
+    QVERIFY2(warnings.isEmpty(), qPrintable(warnings.join(QLatin1Char('\n'))));
+}
+
+void tst_QMimeEmbeddedCache::allMimeTypes()
+{
+    QMimeDatabase db;
+    const QList<QMimeType> all = db.allMimeTypes();
+    QCOMPARE(all.count(), m_mimeTypes.count());
+    for (const QMimeType &mime : all)
+        QVERIFY2(m_mimeTypes.contains(mime.name()), qPrintable(mime.name()));
+}
+
+void tst_QMimeEmbeddedCache::mimeTypeForName_data()
+{
+    QTest::addColumn<QString>("name");
+    for (auto it = m_mimeTypes.cbegin(), end = m_mimeTypes.cend(); it != end; ++it)
+        QTest::newRow(it.key().toLatin1().constData()) << it.key();
+}
+
+void tst_QMimeEmbeddedCache::mimeTypeForName()
+{
+    QFETCH(QString, name);
+    const MimeTypeData &expected = m_mimeTypes[name];
+
+    QMimeDatabase db;
+    const QMimeType mime = db.mimeTypeForName(name);
+    QVERIFY(mime.isValid());
+    QCOMPARE(mime.name(), name);
+
+    QStringList globPatterns = mime.globPatterns();
+    globPatterns.sort();
+    QStringList expectedGlobPatterns = expected.globPatterns;
+    expectedGlobPatterns.sort();
+    QCOMPARE(globPatterns, expectedGlobPatterns);
+
+    QStringList aliases = mime.aliases();
+    aliases.sort();
+    QStringList expectedAliases = expected.aliases;
+    expectedAliases.removeDuplicates();
+    expectedAliases.sort();
+    QCOMPARE(aliases, expectedAliases);
+    for (const QString &alias : qAsConst(expected.aliases))
+        QCOMPARE(db.mimeTypeForName(alias).name(), name);
+
+    if (!expected.parents.isEmpty())
+        QCOMPARE(mime.parentMimeTypes(), expected.parents);
+    if (!expected.genericIconName.isEmpty())
+        QCOMPARE(mime.genericIconName(), expected.genericIconName);
+
+    const QString systemLocale = QLocale::system().name();
+    if (systemLocale == QLatin1String("C") || systemLocale.startsWith(QLatin1String("en")))
+        QCOMPARE(mime.comment(), expected.comment);
+}
+
+void tst_QMimeEmbeddedCache::mimeTypeForFileName_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<QString>("name");
+    for (auto it = m_mimeTypes.cbegin(), end = m_mimeTypes.cend(); it != end; ++it) {
+        for (const QString &pattern : it.value().globPatterns) {
+            if (pattern.contains(QLatin1Char('[')) || pattern.contains(QLatin1Char('?')))
+                continue;
+            QString fileName = pattern;
+            fileName.replace(QLatin1Char('*'), QLatin1String("file"));
+            QTest::newRow((it.key() + QLatin1Char(' ') + pattern).toLatin1().constData()) << fileName << it.key();
+        }
+    }
+}
+
+void tst_QMimeEmbeddedCache::mimeTypeForFileName()
+{
+    QFETCH(QString, fileName);
+    QFETCH(QString, name);
+
+    QMimeDatabase db;
+    QStringList names;
+    const QList<QMimeType> mimes = db.mimeTypesForFileName(fileName);
+    for (const QMimeType &mime : mimes)
+        names.append(mime.name());
+    QVERIFY2(names.contains(name), qPrintable(names.join(QLatin1Char(' '))));
+}
+
+void tst_QMimeEmbeddedCache::mimeTypeForData_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QString>("name");
+
+    QTest::newRow("png") << QByteArray("\x89PNG\r\n\x1a\n\0\0\0\rIHDR", 16) << "image/png";
+    QTest::newRow("gif") << QByteArray("GIF89a\x01\0\x01\0", 10) << "image/gif";
+    QTest::newRow("jpeg") << QByteArray("\xff\xd8\xff\xe0\0\x10JFIF\0", 11) << "image/jpeg";
+    QTest::newRow("pdf") << QByteArray("%PDF-1.4\n%\xe2\xe3\xcf\xd3\n") << "application/pdf";
+    QTest::newRow("gzip") << QByteArray("\x1f\x8b\x08\0\0\0\0\0", 8) << "application/x-gzip";
+    QTest::newRow("elf") << (QByteArray("\x7f" "ELF\x02\x01\x01\0", 8) + QByteArray(8, '\0') + QByteArray("\x03\0", 2)) << "application/x-sharedlib";
+    QTest::newRow("shell") << QByteArray("#!/bin/sh\necho hello\n") << "application/x-shellscript";
+    QTest::newRow("xml") << QByteArray("<?xml version=\"1.0\"?>\n<root/>\n") << "application/xml";
+    QTest::newRow("html") << QByteArray("<!DOCTYPE html>\n<html><body></body></html>\n") << "text/html";
+    QTest::newRow("text") << QByteArray("Just some text\n") << "text/plain";
+    QTest::newRow("binary") << QByteArray("\x01\x02\x03\x04\x05", 5) << "application/octet-stream";
+    QTest::newRow("empty") << QByteArray() << "application/x-zerosize";
+}
+
+void tst_QMimeEmbeddedCache::mimeTypeForData()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QString, name);
+
+    QMimeDatabase db;
+    QCOMPARE(db.mimeTypeForData(data).name(), name);
+
+    QBuffer buffer(&data);
+    QCOMPARE(db.mimeTypeForData(&buffer).name(), name);
+}
+
+void tst_QMimeEmbeddedCache::mimeTypeForFile()
+{
+    // Content matching of files only reads the start of the file
+    QTemporaryFile file(m_temporaryDir.path() + QLatin1String("/XXXXXX"));
+    QVERIFY(file.open());
+    file.write(QByteArray("%PDF-1.4\n"));
+    file.write(QByteArray(1024 * 1024, 'x'));
+    file.close();
+
+    QMimeDatabase db;
+    QCOMPARE(db.mimeTypeForFile(file.fileName()).name(), QStringLiteral("application/pdf"));
+    QCOMPARE(db.mimeTypeForFile(file.fileName(), QMimeDatabase::MatchContent).name(), QStringLiteral("application/pdf"));
+    QCOMPARE(db.mimeTypeForFile(file.fileName() + QLatin1String(".txt")).name(), QStringLiteral("text/plain"));
+}
+
+QTEST_GUILESS_MAIN(tst_QMimeEmbeddedCache)
+#include "tst_qmimeembeddedcache.moc"
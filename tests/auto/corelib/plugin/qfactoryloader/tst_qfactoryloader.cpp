@@ -29,7 +29,11 @@
 #include <QtTest/qtest.h>
 #include <QtCore/qdir.h>
 #include <QtCore/qfileinfo.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qstandardpaths.h>
+#include <QtCore/qtemporarydir.h>
 #include <private/qfactoryloader_p.h>
+#include <private/qpluginmetadatacache_p.h>
 #include "plugin1/plugininterface1.h"
 #include "plugin2/plugininterface2.h"
 
@@ -46,6 +50,7 @@ public slots:
 
 private slots:
     void usingTwoFactoriesFromSameDir();
+    void metaDataCache();
 };
 
 static const char binFolderC[] = "bin";
@@ -80,5 +85,77 @@ void tst_QFactoryLoader::usingTwoFactoriesFromSameDir()
     QCOMPARE(plugin2->pluginName(), QLatin1String("Plugin2 ok"));
 }
 
+void tst_QFactoryLoader::metaDataCache()
+{
+#ifdef QT_NO_LIBRARY
+    QSKIP("This test requires plugins to be loaded dynamically");
+#else
+    const QDir binDir(QFINDTESTDATA(binFolderC));
+    const QStringList plugin1 = binDir.entryList(QStringList(QStringLiteral("*plugin1*")), QDir::Files);
+    const QStringList plugin2 = binDir.entryList(QStringList(QStringLiteral("*plugin2*")), QDir::Files);
+    QVERIFY(!plugin1.isEmpty());
+    QVERIFY(!plugin2.isEmpty());
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(QDir(dir.path()).mkdir(QStringLiteral("cached")));
+    const QString pluginFile = dir.path() + QLatin1String("/cached/") + plugin1.first();
+    QVERIFY(QFile::copy(binDir.filePath(plugin1.first()), pluginFile));
+
+    const QStringList libraryPaths = QCoreApplication::libraryPaths();
+    QCoreApplication::setLibraryPaths(QStringList(dir.path()));
+    QStandardPaths::setTestModeEnabled(true);
+    QPluginMetaDataCache::reset();
+    QPluginMetaDataCache *cache = QPluginMetaDataCache::instance();
+    QVERIFY(cache);
+    const QString cacheFile = cache->cacheFileName();
+    QFile::remove(cacheFile);
+
+    {
+        QFactoryLoader loader(PluginInterface1_iid, QStringLiteral("/cached"));
+        QCOMPARE(loader.metaData().size(), 1);
+    }
+    QVERIFY(QFile::exists(cacheFile));
+
+    // read the metadata back from the cache file
+    QPluginMetaDataCache::reset();
+    {
+        QJsonObject metaData;
+        QString errorString;
+        QCOMPARE(QPluginMetaDataCache::instance()->find(QFileInfo(pluginFile).canonicalFilePath(),
+                                                        &metaData, &errorString),
+                 QPluginMetaDataCache::Plugin);
+        QCOMPARE(metaData.value(QStringLiteral("IID")).toString(), QStringLiteral(PluginInterface1_iid));
+    }
+    {
+        QFactoryLoader loader(PluginInterface1_iid, QStringLiteral("/cached"));
+        QCOMPARE(loader.metaData().size(), 1);
+        QCOMPARE(loader.metaData().first().value(QStringLiteral("IID")).toString(),
+                 QStringLiteral(PluginInterface1_iid));
+    }
+
+    // a changed file must be scanned again; pad it, the plugins may have the same size
+    QVERIFY(QFile::remove(pluginFile));
+    QVERIFY(QFile::copy(binDir.filePath(plugin2.first()), pluginFile));
+    {
+        QFile file(pluginFile);
+        QVERIFY(file.open(QIODevice::Append));
+        QCOMPARE(file.write(QByteArray(16, '\0')), qint64(16));
+    }
+    QPluginMetaDataCache::reset();
+    {
+        QFactoryLoader loader1(PluginInterface1_iid, QStringLiteral("/cached"));
+        QCOMPARE(loader1.metaData().size(), 0);
+        QFactoryLoader loader2(PluginInterface2_iid, QStringLiteral("/cached"));
+        QCOMPARE(loader2.metaData().size(), 1);
+    }
+
+    QFile::remove(cacheFile);
+    QPluginMetaDataCache::reset();
+    QStandardPaths::setTestModeEnabled(false);
+    QCoreApplication::setLibraryPaths(libraryPaths);
+#endif
+}
+
 QTEST_MAIN(tst_QFactoryLoader)
 #include "tst_qfactoryloader.moc"
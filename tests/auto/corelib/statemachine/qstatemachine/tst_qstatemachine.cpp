@@ -251,6 +251,7 @@ private slots:
     void qtbug_46059();
     void qtbug_46703();
     void postEventFromBeginSelectTransitions();
+    void changeStructureWhileRunning();
 };
 
 class TestState : public QState
@@ -6658,5 +6659,44 @@ void tst_QStateMachine::postEventFromBeginSelectTransitions()
     QVERIFY(machine.isRunning());
 }
 
+void tst_QStateMachine::changeStructureWhileRunning()
+{
+    QStateMachine machine;
+    QState a(&machine);
+    QState b(&machine);
+    machine.setInitialState(&a);
+    a.addTransition(new EventTransition(QEvent::User, &b));
+
+    machine.start();
+    QTRY_COMPARE(machine.configuration().contains(&a), true);
+    machine.postEvent(new QEvent(QEvent::User));
+    QTRY_COMPARE(machine.configuration().contains(&b), true);
+
+    // States and transitions added to a running machine are used right away.
+    QState *c = new QState(&machine);
+    QState *c1 = new QState(c);
+    c->setInitialState(c1);
+    b.addTransition(new EventTransition(QEvent::Type(QEvent::User + 1), c));
+    machine.postEvent(new QEvent(QEvent::Type(QEvent::User + 1)));
+    QTRY_COMPARE(machine.configuration().contains(c1), true);
+    QCOMPARE(machine.configuration().contains(c), true);
+    QCOMPARE(machine.configuration().contains(&b), false);
+
+    // A transition on an ancestor of the active states.
+    c->addTransition(new EventTransition(QEvent::Type(QEvent::User + 2), &a));
+    machine.postEvent(new QEvent(QEvent::Type(QEvent::User + 2)));
+    QTRY_COMPARE(machine.configuration().contains(&a), true);
+    QCOMPARE(machine.configuration().contains(c), false);
+
+    // Removed states are no longer part of the machine.
+    delete c;
+    a.addTransition(new EventTransition(QEvent::Type(QEvent::User + 3), &b));
+    machine.postEvent(new QEvent(QEvent::Type(QEvent::User + 3)));
+    QTRY_COMPARE(machine.configuration().contains(&b), true);
+    QCOMPARE(machine.configuration().size(), 1);
+
+    QVERIFY(machine.isRunning());
+}
+
 QTEST_MAIN(tst_QStateMachine)
 #include "tst_qstatemachine.moc"
@@ -32,6 +32,7 @@
 #include <qbytearray.h>
 #include <qfile.h>
 #include <qhash.h>
+#include <qlocale.h>
 #include <limits.h>
 #include <private/qtools_p.h>
 #if defined(Q_OS_WINCE)
@@ -103,8 +104,13 @@ private slots:
     void toULong();
     void toULongLong_data();
     void toULongLong();
+    void toLongLong_data();
+    void toLongLong();
+    void toDouble_data();
+    void toDouble();
 
     void number();
+    void numberDouble();
     void toInt_data();
     void toInt();
     void qAllocMore();
@@ -1249,6 +1255,49 @@ void tst_QByteArray::number()
              QString(QByteArray("-9223372036854775808")));
 }
 
+void tst_QByteArray::numberDouble()
+{
+    QVector<double> values;
+    values << 0.0 << -0.0 << 1.0 << -1.5 << 0.1 << 1e22 << 1e23 << 9007199254740992.0
+           << 123456789.125 << 0.000000000931322574615478515625 << 1e-7 << 999999.5
+           << 4.9406564584124654e-324 << 2.2250738585072014e-308 << 1.7976931348623157e308
+           << qInf() << -qInf() << qQNaN();
+    qsrand(3300);
+    for (int i = 0; i < 500; ++i) {
+        quint64 bits = 0;
+        for (int j = 0; j < 4; ++j)
+            bits = bits << 16 | quint64(qrand() & 0xffff);
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        if (qIsFinite(d))
+            values << d;
+        values << qrand() / double(1 << (qrand() % 20)) << (qrand() % 100000) / 1000.0;
+    }
+
+    // QLocale formats the numbers without the fast path
+    const QLocale c = QLocale::c();
+    const char formats[] = { 'e', 'E', 'f', 'g', 'G' };
+    const int precisions[] = { 0, 1, 6, 15, 16, 17, 20, QLocale::FloatingPointShortest };
+    for (double value : qAsConst(values)) {
+        for (char format : formats) {
+            for (int precision : precisions) {
+                const QByteArray expected = c.toString(value, format, precision).toLatin1();
+                QByteArray number = QByteArray::number(value, format, precision);
+                QCOMPARE(number, expected);
+                QCOMPARE(number.setNum(value, format, precision), expected);
+            }
+        }
+        if (!qIsFinite(value))
+            continue;
+
+        bool ok;
+        QVERIFY2(QByteArray::number(value, 'g', 17).toDouble(&ok) == value, QByteArray::number(value, 'g', 17));
+        QVERIFY(ok);
+        QVERIFY(QByteArray::number(value, 'e', QLocale::FloatingPointShortest).toDouble(&ok) == value);
+        QVERIFY(ok);
+    }
+}
+
 // defined later
 extern const char globalChar;
 
@@ -1331,6 +1380,21 @@ void tst_QByteArray::toULongLong_data()
     QTest::newRow("default") << QByteArray() << 10 << (qulonglong)0 << false;
     QTest::newRow("out of base bound") << QByteArray("c") << 10 << (qulonglong)0 << false;
 
+    // decimal numbers are parsed eight digits at a time
+    QTest::newRow("8 digits") << QByteArray("12345678") << 10 << Q_UINT64_C(12345678) << true;
+    QTest::newRow("9 digits") << QByteArray("123456789") << 10 << Q_UINT64_C(123456789) << true;
+    QTest::newRow("16 digits") << QByteArray("9876543210987654") << 10 << Q_UINT64_C(9876543210987654) << true;
+    QTest::newRow("ULLONG_MAX") << QByteArray("18446744073709551615") << 10
+                                << Q_UINT64_C(18446744073709551615) << true;
+    QTest::newRow("ULLONG_MAX+1") << QByteArray("18446744073709551616") << 10 << (qulonglong)0 << false;
+    QTest::newRow("20 digits overflow") << QByteArray("99999999999999999999") << 10 << (qulonglong)0 << false;
+    QTest::newRow("21 digits") << QByteArray("100000000000000000000") << 10 << (qulonglong)0 << false;
+    QTest::newRow("leading zeros") << QByteArray("000000000000000000000018446744073709551615") << 10
+                                   << Q_UINT64_C(18446744073709551615) << true;
+    QTest::newRow("junk after 8 digits") << QByteArray("12345678x") << 10 << (qulonglong)0 << false;
+    QTest::newRow("embedded NUL") << QByteArray("4294967296\0" "1", 12) << 10 << Q_UINT64_C(4294967296) << true;
+    QTest::newRow("raw") << QByteArray::fromRawData("184467440737095516159", 20) << 10
+                         << Q_UINT64_C(18446744073709551615) << true;
 }
 
 void tst_QByteArray::toULongLong()
@@ -1346,6 +1410,124 @@ void tst_QByteArray::toULongLong()
     QCOMPARE(b, ok);
 }
 
+void tst_QByteArray::toLongLong_data()
+{
+    QTest::addColumn<QByteArray>("str");
+    QTest::addColumn<qlonglong>("result");
+    QTest::addColumn<bool>("ok");
+
+    const qlonglong llongMax = Q_INT64_C(9223372036854775807);
+    const qlonglong llongMin = -llongMax - 1;
+    QTest::newRow("default") << QByteArray() << Q_INT64_C(0) << false;
+    QTest::newRow("empty") << QByteArray("") << Q_INT64_C(0) << false;
+    QTest::newRow("sign only") << QByteArray("-") << Q_INT64_C(0) << false;
+    QTest::newRow("zero") << QByteArray("0") << Q_INT64_C(0) << true;
+    QTest::newRow("minus zero") << QByteArray("-0") << Q_INT64_C(0) << true;
+    QTest::newRow("7 digits") << QByteArray("-1234567") << Q_INT64_C(-1234567) << true;
+    QTest::newRow("8 digits") << QByteArray("+12345678") << Q_INT64_C(12345678) << true;
+    QTest::newRow("17 digits") << QByteArray("12345678901234567") << Q_INT64_C(12345678901234567) << true;
+    QTest::newRow("LLONG_MAX") << QByteArray("9223372036854775807") << llongMax << true;
+    QTest::newRow("LLONG_MAX+1") << QByteArray("9223372036854775808") << Q_INT64_C(0) << false;
+    QTest::newRow("LLONG_MIN") << QByteArray("-9223372036854775808") << llongMin << true;
+    QTest::newRow("LLONG_MIN-1") << QByteArray("-9223372036854775809") << Q_INT64_C(0) << false;
+    QTest::newRow("19 digits overflow") << QByteArray("9999999999999999999") << Q_INT64_C(0) << false;
+    QTest::newRow("20 digits") << QByteArray("-10000000000000000000") << Q_INT64_C(0) << false;
+    QTest::newRow("leading zeros") << QByteArray("-0000000000000000000009223372036854775808") << llongMin << true;
+    QTest::newRow("leading space") << QByteArray(" \t42") << Q_INT64_C(42) << true;
+    QTest::newRow("trailing space") << QByteArray("42 ") << Q_INT64_C(0) << false;
+    QTest::newRow("junk") << QByteArray("123456789a") << Q_INT64_C(0) << false;
+    QTest::newRow("fraction") << QByteArray("1.0") << Q_INT64_C(0) << false;
+
+    // the number ends at the NUL, as with a '\0' terminated string
+    QTest::newRow("embedded NUL") << QByteArray("12\0" "34", 5) << Q_INT64_C(12) << true;
+    QTest::newRow("embedded NUL after 8 digits") << QByteArray("-123456789\0" "x", 12)
+                                                 << Q_INT64_C(-123456789) << true;
+    QTest::newRow("NUL only") << QByteArray("\0" "1", 2) << Q_INT64_C(0) << false;
+
+    // not terminated, followed by digits
+    QTest::newRow("raw1") << QByteArray::fromRawData("1234", 2) << Q_INT64_C(12) << true;
+    QTest::newRow("raw2") << QByteArray::fromRawData("-98765432109", 9) << Q_INT64_C(-98765432) << true;
+    QTest::newRow("raw LLONG_MIN") << QByteArray::fromRawData("-92233720368547758080", 20) << llongMin << true;
+}
+
+void tst_QByteArray::toLongLong()
+{
+    QFETCH(QByteArray, str);
+    QFETCH(qlonglong, result);
+    QFETCH(bool, ok);
+
+    bool b;
+    QCOMPARE(str.toLongLong(0), result);
+    QCOMPARE(str.toLongLong(&b), result);
+    QCOMPARE(b, ok);
+
+    // the same number through the generic parser, unless base 0 would read it as octal
+    const QByteArray digits = str.trimmed();
+    if (!digits.startsWith('0') && !digits.startsWith("-0") && !digits.startsWith("+0")) {
+        QCOMPARE(str.toLongLong(&b, 0), result);
+        QCOMPARE(b, ok);
+    }
+
+    const int i = str.toInt(&b);
+    QCOMPARE(b, ok && result >= INT_MIN && result <= INT_MAX);
+    QCOMPARE(qlonglong(i), b ? result : Q_INT64_C(0));
+}
+
+void tst_QByteArray::toDouble_data()
+{
+    QTest::addColumn<QByteArray>("str");
+    QTest::addColumn<double>("result");
+    QTest::addColumn<bool>("ok");
+
+    QTest::newRow("default") << QByteArray() << 0.0 << false;
+    QTest::newRow("empty") << QByteArray("") << 0.0 << false;
+    QTest::newRow("integer") << QByteArray("-42") << -42.0 << true;
+    QTest::newRow("fraction") << QByteArray("0.1") << 0.1 << true;
+    QTest::newRow("exponent") << QByteArray("1.5E3") << 1500.0 << true;
+    QTest::newRow("leading space") << QByteArray(" 1.5") << 0.0 << false;
+    QTest::newRow("trailing space") << QByteArray("1.5 ") << 0.0 << false;
+    QTest::newRow("junk") << QByteArray("1.5x") << 0.0 << false;
+    QTest::newRow("nan") << QByteArray("-nan") << 0.0 << false;
+
+    // an exact mantissa and power of ten are multiplied directly
+    QTest::newRow("2^53") << QByteArray("9007199254740992") << 9007199254740992.0 << true;
+    QTest::newRow("2^53+1") << QByteArray("9007199254740993") << 9007199254740992.0 << true;
+    QTest::newRow("2^53+3") << QByteArray("9007199254740995") << 9007199254740996.0 << true;
+    QTest::newRow("19 digits") << QByteArray("1234567890123456789") << 1234567890123456789.0 << true;
+    QTest::newRow("1e22") << QByteArray("1e22") << 1e22 << true;
+    QTest::newRow("1e23") << QByteArray("1e23") << 1e23 << true;
+    QTest::newRow("1e-22") << QByteArray("1e-22") << 1e-22 << true;
+    QTest::newRow("1e-23") << QByteArray("1e-23") << 1e-23 << true;
+    QTest::newRow("12.5e-22") << QByteArray("12.5e-22") << 12.5e-22 << true;
+    QTest::newRow("12.5e21") << QByteArray("12.5e21") << 12.5e21 << true;
+    QTest::newRow("0.000001e22") << QByteArray("0.000001e22") << 1e16 << true;
+    QTest::newRow("exponent 3 digits") << QByteArray("1e-300") << 1e-300 << true;
+    QTest::newRow("overflow") << QByteArray("1e309") << qInf() << false;
+    QTest::newRow("underflow") << QByteArray("1e-400") << 0.0 << false;
+
+    // any digit after an upper case 'E' is taken as a sign of underflow
+    QTest::newRow("0e5") << QByteArray("0e5") << 0.0 << true;
+    QTest::newRow("0E5") << QByteArray("0E5") << 0.0 << false;
+    QTest::newRow("0E0") << QByteArray("0E0") << 0.0 << true;
+
+    QTest::newRow("embedded NUL") << QByteArray("1.5\0" "7", 5) << 0.0 << false;
+    QTest::newRow("raw1") << QByteArray::fromRawData("1.5e3", 3) << 1.5 << true;
+    QTest::newRow("raw2") << QByteArray::fromRawData("2.25", 1) << 2.0 << true;
+    QTest::newRow("raw3") << QByteArray::fromRawData("1e220", 4) << 1e22 << true;
+}
+
+void tst_QByteArray::toDouble()
+{
+    QFETCH(QByteArray, str);
+    QFETCH(double, result);
+    QFETCH(bool, ok);
+
+    bool b;
+    const double d = str.toDouble(&b);
+    QCOMPARE(b, ok);
+    QVERIFY2(d == result, QByteArray::number(d, 'g', 17));
+}
+
 // global function defined in qbytearray.cpp
 void tst_QByteArray::qAllocMore()
 {
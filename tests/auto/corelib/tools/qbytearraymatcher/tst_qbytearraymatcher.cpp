@@ -43,6 +43,8 @@ class tst_QByteArrayMatcher : public QObject
 private slots:
     void interface();
     void indexIn();
+    void indexInAgainstNaive_data();
+    void indexInAgainstNaive();
 };
 
 static QByteArrayMatcher matcher1;
@@ -112,5 +114,62 @@ void tst_QByteArrayMatcher::indexIn()
     QCOMPARE(matcher.indexIn(haystack, 2), 5);
 }
 
+void tst_QByteArrayMatcher::indexInAgainstNaive_data()
+{
+    QTest::addColumn<int>("needleLength");
+
+    // around the widths of the vectorized loops and the Boyer-Moore threshold
+    for (int length : { 1, 2, 3, 15, 16, 17, 31, 32, 33, 64, 65, 100 })
+        QTest::newRow(QByteArray::number(length).constData()) << length;
+}
+
+static int naiveIndexOf(const QByteArray &haystack, const QByteArray &needle, int from)
+{
+    for (int i = from; i + needle.size() <= haystack.size(); ++i) {
+        if (memcmp(haystack.constData() + i, needle.constData(), needle.size()) == 0)
+            return i;
+    }
+    return -1;
+}
+
+void tst_QByteArrayMatcher::indexInAgainstNaive()
+{
+    QFETCH(int, needleLength);
+
+    quint32 seed = 42 + needleLength;
+    const auto random = [&seed](int bound) {
+        seed = seed * 1103515245 + 12345;
+        return int((seed >> 16) % bound);
+    };
+
+    for (int round = 0; round < 200; ++round) {
+        // few distinct bytes, so that partial matches are frequent
+        const int alphabetSize = round % 2 ? 2 : 4;
+        QByteArray needle;
+        for (int i = 0; i < needleLength; ++i)
+            needle += char(0x7f + random(alphabetSize));
+        QByteArray haystack;
+        const int haystackLength = random(600);
+        for (int i = 0; i < haystackLength; ++i)
+            haystack += char(0x7f + random(alphabetSize));
+        if (haystackLength > needleLength && random(2))
+            haystack.replace(random(haystackLength - needleLength), needleLength, needle);
+        const int from = random(40);
+
+        const QByteArrayMatcher matcher(needle);
+        const int expected = naiveIndexOf(haystack, needle, from);
+        QCOMPARE(matcher.indexIn(haystack, from), expected);
+        QCOMPARE(matcher.indexIn(haystack.constData(), haystack.size(), from), expected);
+        QCOMPARE(haystack.indexOf(needle, from), expected);
+
+        int count = 0;
+        for (int i = naiveIndexOf(haystack, needle, 0); i != -1; i = naiveIndexOf(haystack, needle, i + 1))
+            ++count;
+        QCOMPARE(haystack.count(needle), count);
+        if (needleLength == 1)
+            QCOMPARE(haystack.count(needle.at(0)), count);
+    }
+}
+
 QTEST_APPLESS_MAIN(tst_QByteArrayMatcher)
 #include "tst_qbytearraymatcher.moc"
@@ -44,6 +44,10 @@ private Q_SLOTS:
     void compare();
 
     void state();
+
+    void sort_data();
+    void sort();
+    void sortKeyCache();
 };
 
 #ifdef Q_COMPILER_RVALUE_REFS
@@ -200,6 +204,85 @@ void tst_QCollator::state()
     QCOMPARE(c.ignorePunctuation(), true);
     QCOMPARE(c.locale(), QLocale(QLocale::Norwegian));
 
+    // detaching keeps the settings
+    QCollator copy(c);
+    copy.setLocale(QLocale::German);
+    QCOMPARE(copy.caseSensitivity(), Qt::CaseInsensitive);
+    QCOMPARE(copy.numericMode(), true);
+    QCOMPARE(copy.ignorePunctuation(), true);
+    QCOMPARE(c.locale(), QLocale(QLocale::Norwegian));
+}
+
+void tst_QCollator::sort_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("caseInsensitive");
+
+    QTest::newRow("empty") << 0 << false;
+    QTest::newRow("one") << 1 << false;
+    QTest::newRow("small") << 100 << false;
+    QTest::newRow("small-ci") << 100 << true;
+    QTest::newRow("large") << 50000 << false;
+    QTest::newRow("large-ci") << 50000 << true;
+}
+
+void tst_QCollator::sort()
+{
+    QFETCH(int, count);
+    QFETCH(bool, caseInsensitive);
+
+    static const char * const words[] = {
+        "apple", "Apple", "banana", "Cherry", "cherry", "date", "Elder", "fig", "grape", "10", "9"
+    };
+    const int wordCount = int(sizeof words / sizeof *words);
+
+    QStringList list;
+    for (int i = 0; i < count; ++i) {
+        list << QString::fromLatin1(words[(i * 7) % wordCount])
+                + QString::number((i * 7919) % (count / 3 + 1));
+    }
+
+    QCollator collator;
+    collator.setCaseSensitivity(caseInsensitive ? Qt::CaseInsensitive : Qt::CaseSensitive);
+
+    QStringList expected = list;
+    std::stable_sort(expected.begin(), expected.end(), collator);
+
+    collator.sort(list);
+    QCOMPARE(list, expected);
+}
+
+void tst_QCollator::sortKeyCache()
+{
+    QCollator collator;
+    QCOMPARE(collator.sortKeyCacheLimit(), 0);
+    collator.setSortKeyCacheLimit(-1);
+    QCOMPARE(collator.sortKeyCacheLimit(), 0);
+
+    collator.setSortKeyCacheLimit(2);
+    QCOMPARE(collator.sortKeyCacheLimit(), 2);
+
+    const QString a = QStringLiteral("a");
+    const QString b = QStringLiteral("b");
+    const QString c = QStringLiteral("c");
+    const QCollatorSortKey keyA = collator.sortKey(a);
+    const QCollatorSortKey keyB = collator.sortKey(b);
+    QCOMPARE(collator.sortKey(a).compare(keyA), 0);
+    QVERIFY(keyA < keyB);
+    QVERIFY(collator.sortKey(c).compare(keyB) > 0);
+    QCOMPARE(collator.sortKey(a).compare(keyA), 0);
+
+    QStringList list;
+    list << c << b << a << QStringLiteral("d");
+    collator.sort(list);
+    QCOMPARE(list, QStringList() << a << b << c << QStringLiteral("d"));
+
+    // copies share the limit
+    QCollator copy(collator);
+    QCOMPARE(copy.sortKeyCacheLimit(), 2);
+    copy.setCaseSensitivity(Qt::CaseInsensitive);
+    QCOMPARE(copy.sortKeyCacheLimit(), 2);
+    QCOMPARE(collator.caseSensitivity(), Qt::CaseSensitive);
 }
 
 QTEST_APPLESS_MAIN(tst_QCollator)
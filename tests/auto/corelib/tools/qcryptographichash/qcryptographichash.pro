@@ -2,6 +2,7 @@ CONFIG += testcase
 TARGET = tst_qcryptographichash
 QT = core testlib
 SOURCES = tst_qcryptographichash.cpp
+RESOURCES += resources.qrc
 
 TESTDATA += data/*
 
@@ -42,6 +42,13 @@ private slots:
     void sha3();
     void files_data();
     void files();
+    void chunkedInput_data();
+    void chunkedInput();
+    void hashDevice();
+    void hashResource_data();
+    void hashResource();
+    void hashMany_data();
+    void hashMany();
 };
 
 void tst_QCryptographicHash::repeated_result_data()
@@ -253,6 +260,174 @@ void tst_QCryptographicHash::files()
     }
 }
 
+void tst_QCryptographicHash::chunkedInput_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+    QTest::addColumn<int>("chunkSize");
+    QTest::addColumn<QByteArray>("expected");
+
+    // hashes of a million repetitions of "a"
+    const struct {
+        const char *name;
+        QCryptographicHash::Algorithm algorithm;
+        const char *hash;
+    } algorithms[] = {
+        { "sha1", QCryptographicHash::Sha1,
+          "34aa973cd4c4daa4f61eeb2bdbad27316534016f" },
+        { "sha224", QCryptographicHash::Sha224,
+          "20794655980c91d8bbb4c1ea97618a4bf03f42581948b2ee4ee7ad67" },
+        { "sha256", QCryptographicHash::Sha256,
+          "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" },
+        { "sha384", QCryptographicHash::Sha384,
+          "9d0e1809716474cb086e834e310a4a1ced149e9c00f248527972cec5704c2a5b07b8b3dc38ecc4ebae97ddd87f3d8985" },
+        { "sha512", QCryptographicHash::Sha512,
+          "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973eb"
+          "de0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b" }
+    };
+    const int chunkSizes[] = { 1000000, 1, 7, 64, 65, 128, 1000, 100003 };
+
+    for (const auto &algorithm : algorithms) {
+        for (int chunkSize : chunkSizes) {
+            QTest::newRow((QByteArray(algorithm.name) + '-' + QByteArray::number(chunkSize)).constData())
+                    << algorithm.algorithm << chunkSize << QByteArray(algorithm.hash);
+        }
+    }
+}
+
+void tst_QCryptographicHash::chunkedInput()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+    QFETCH(int, chunkSize);
+    QFETCH(QByteArray, expected);
+
+    const QByteArray as(1000000, 'a');
+    QCryptographicHash hash(algorithm);
+    for (int i = 0; i < as.size(); i += chunkSize)
+        hash.addData(as.constData() + i, qMin(chunkSize, as.size() - i));
+    QCOMPARE(hash.result().toHex(), expected);
+}
+
+void tst_QCryptographicHash::hashDevice()
+{
+    QByteArray data(300000, Qt::Uninitialized);
+    for (int i = 0; i < data.size(); ++i)
+        data[i] = char(i * 7 + (i >> 8));
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(data), qint64(data.size()));
+
+    // read in chunks; files on disk are never mapped
+    QVERIFY(file.seek(17));
+    QCOMPARE(QCryptographicHash::hash(&file, QCryptographicHash::Sha256),
+             QCryptographicHash::hash(data.mid(17), QCryptographicHash::Sha256));
+    QVERIFY(file.atEnd());
+
+    // less than one chunk
+    QVERIFY(file.seek(data.size() - 1000));
+    QCOMPARE(QCryptographicHash::hash(&file, QCryptographicHash::Sha1),
+             QCryptographicHash::hash(data.right(1000), QCryptographicHash::Sha1));
+    QVERIFY(file.atEnd());
+
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QCOMPARE(QCryptographicHash::hash(&buffer, QCryptographicHash::Md5),
+             QCryptographicHash::hash(data, QCryptographicHash::Md5));
+
+    QBuffer closed(&data);
+    QCOMPARE(QCryptographicHash::hash(&closed, QCryptographicHash::Md5), QByteArray());
+}
+
+void tst_QCryptographicHash::hashResource_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<bool>("compressed");
+
+    QTest::newRow("uncompressed") << QString::fromLatin1(":/uncompressed.txt") << false;
+    QTest::newRow("compressed") << QString::fromLatin1(":/compressed.txt") << true;
+}
+
+void tst_QCryptographicHash::hashResource()
+{
+    QFETCH(QString, fileName);
+    QFETCH(bool, compressed);
+
+    QCOMPARE(QResource(fileName).isCompressed(), compressed);
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray data = file.readAll();
+    // large enough to be hashed in place
+    QVERIFY(data.size() > 64 * 1024 + 1000);
+    QVERIFY(file.map(0, file.size()));
+
+    QVERIFY(file.seek(0));
+    QCOMPARE(QCryptographicHash::hash(&file, QCryptographicHash::Sha256),
+             QCryptographicHash::hash(data, QCryptographicHash::Sha256));
+    QVERIFY(file.atEnd());
+
+    QVERIFY(file.seek(1000));
+    QCOMPARE(QCryptographicHash::hash(&file, QCryptographicHash::Md5),
+             QCryptographicHash::hash(data.mid(1000), QCryptographicHash::Md5));
+    QVERIFY(file.atEnd());
+
+    // too little is left to be mapped
+    QVERIFY(file.seek(data.size() - 1000));
+    QCOMPARE(QCryptographicHash::hash(&file, QCryptographicHash::Sha1),
+             QCryptographicHash::hash(data.right(1000), QCryptographicHash::Sha1));
+    QVERIFY(file.atEnd());
+
+    // a file that has just been opened
+    QFile same(fileName);
+    QVERIFY(same.open(QIODevice::ReadOnly));
+    QCryptographicHash hash(QCryptographicHash::Sha512);
+    QVERIFY(hash.addData(&same));
+    QCOMPARE(hash.result(), QCryptographicHash::hash(data, QCryptographicHash::Sha512));
+}
+
+void tst_QCryptographicHash::hashMany_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+
+    QTest::newRow("md5") << QCryptographicHash::Md5;
+    QTest::newRow("sha1") << QCryptographicHash::Sha1;
+    QTest::newRow("sha224") << QCryptographicHash::Sha224;
+    QTest::newRow("sha256") << QCryptographicHash::Sha256;
+    QTest::newRow("sha512") << QCryptographicHash::Sha512;
+    QTest::newRow("sha3_256") << QCryptographicHash::Sha3_256;
+}
+
+void tst_QCryptographicHash::hashMany()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+
+    QCOMPARE(QCryptographicHash::hash(QByteArrayList(), algorithm), QByteArrayList());
+
+    // lengths around the block and padding boundaries, in mixed order
+    QByteArrayList data;
+    for (int length = 0; length <= 200; ++length) {
+        QByteArray message(length, Qt::Uninitialized);
+        for (int i = 0; i < length; ++i)
+            message[i] = char(length * 31 + i);
+        if (length % 2)
+            data.append(message);
+        else
+            data.prepend(message);
+    }
+    data.insert(100, QByteArray(100000, 'x'));
+
+    const QByteArrayList hashes = QCryptographicHash::hash(data, algorithm);
+    QCOMPARE(hashes.size(), data.size());
+    for (int i = 0; i < data.size(); ++i)
+        QCOMPARE(hashes.at(i), QCryptographicHash::hash(data.at(i), algorithm));
+
+    // fewer messages than lanes
+    const QByteArrayList few = data.mid(10, 3);
+    const QByteArrayList fewHashes = QCryptographicHash::hash(few, algorithm);
+    QCOMPARE(fewHashes.size(), 3);
+    for (int i = 0; i < few.size(); ++i)
+        QCOMPARE(fewHashes.at(i), QCryptographicHash::hash(few.at(i), algorithm));
+}
 
 QTEST_MAIN(tst_QCryptographicHash)
 #include "tst_qcryptographichash.moc"
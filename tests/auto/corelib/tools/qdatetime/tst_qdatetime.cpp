@@ -119,6 +119,8 @@ private slots:
     void fromStringDateFormat();
     void fromStringStringFormat_data();
     void fromStringStringFormat();
+    void dateTimeFormat_data();
+    void dateTimeFormat();
 #ifdef Q_OS_WIN
     void fromString_LOCALE_ILDATE();
 #endif
@@ -2259,6 +2261,15 @@ void tst_QDateTime::fromStringDateFormat()
 
     QDateTime dateTime = QDateTime::fromString(dateTimeStr, dateFormat);
     QCOMPARE(dateTime, expected);
+
+    const QByteArray latin1 = dateTimeStr.toLatin1();
+    if (QString::fromLatin1(latin1) == dateTimeStr) {
+        const QDateTime fromLatin1 = QDateTime::fromString(QLatin1String(latin1), dateFormat);
+        QCOMPARE(fromLatin1, dateTime);
+        QCOMPARE(fromLatin1.isValid(), dateTime.isValid());
+        QCOMPARE(fromLatin1.timeSpec(), dateTime.timeSpec());
+        QCOMPARE(fromLatin1.offsetFromUtc(), dateTime.offsetFromUtc());
+    }
 }
 
 void tst_QDateTime::fromStringStringFormat_data()
@@ -2308,6 +2319,65 @@ void tst_QDateTime::fromStringStringFormat()
     QDateTime dt = QDateTime::fromString(string, format);
 
     QCOMPARE(dt, expected);
+
+    const QDateTimeFormat dateTimeFormat(format);
+    QCOMPARE(dateTimeFormat.format(), format);
+    QCOMPARE(dateTimeFormat.parse(string), expected);
+    const QByteArray latin1 = string.toLatin1();
+    if (QString::fromLatin1(latin1) == string)
+        QCOMPARE(dateTimeFormat.parse(QLatin1String(latin1)), expected);
+}
+
+void tst_QDateTime::dateTimeFormat_data()
+{
+    QTest::addColumn<QString>("format");
+    QTest::addColumn<bool>("compiled");
+    QTest::addColumn<QString>("string");
+    QTest::addColumn<QDateTime>("expected");
+
+    QTest::newRow("iso-like") << QString("yyyy-MM-dd hh:mm:ss.zzz") << true
+                              << QString("2016-02-29 13:04:05.067")
+                              << QDateTime(QDate(2016, 2, 29), QTime(13, 4, 5, 67));
+    QTest::newRow("short-year") << QString("d.M.yy") << true << QString("1.2.03")
+                                << QDateTime(QDate(1903, 2, 1), QTime());
+    QTest::newRow("greedy") << QString("dMyyyy") << true << QString("13122004")
+                            << QDateTime(QDate(2004, 12, 13), QTime());
+    QTest::newRow("greedy-out-of-range") << QString("dMyyyy") << true << QString("351200")
+                                         << QDateTime(QDate(1200, 5, 3), QTime());
+    QTest::newRow("quoted") << QString("'Time:' HH'h'mm") << true << QString("Time: 07h30")
+                            << QDateTime(QDate(1900, 1, 1), QTime(7, 30));
+    QTest::newRow("invalid-day") << QString("dd.MM.yyyy") << true << QString("29.02.2015")
+                                 << invalidDateTime();
+    QTest::newRow("trailing") << QString("dd.MM.yyyy") << true << QString("28.02.2015 ")
+                              << invalidDateTime();
+    QTest::newRow("short-msec") << QString("ss.zzz") << true << QString("12.5")
+                                << QDateTime::fromString(QString("12.5"), QString("ss.zzz"));
+    QTest::newRow("month-name") << QString("dd MMM yyyy") << false
+                                << QString("10 ") + QDate::shortMonthName(10) + QString(" 2010")
+                                << QDateTime(QDate(2010, 10, 10), QTime());
+    QTest::newRow("ampm") << QString("hh:mm AP") << false << QString("02:30 PM")
+                          << QDateTime(QDate(1900, 1, 1), QTime(14, 30));
+    QTest::newRow("repeated") << QString("yyyy yy") << false << QString("2004 04")
+                              << QDateTime::fromString(QString("2004 04"), QString("yyyy yy"));
+}
+
+void tst_QDateTime::dateTimeFormat()
+{
+    QFETCH(QString, format);
+    QFETCH(bool, compiled);
+    QFETCH(QString, string);
+    QFETCH(QDateTime, expected);
+
+    const QDateTimeFormat dateTimeFormat(format);
+    QCOMPARE(dateTimeFormat.isCompiled(), compiled);
+    QCOMPARE(dateTimeFormat.parse(string), expected);
+    QCOMPARE(dateTimeFormat.parse(string), QDateTime::fromString(string, format));
+    QCOMPARE(dateTimeFormat.parse(QLatin1String(string.toLatin1())), expected);
+
+    const QDateTimeFormat copy = dateTimeFormat;
+    QCOMPARE(copy.format(), format);
+    QCOMPARE(copy.parse(string), expected);
+    QVERIFY(!QDateTimeFormat().parse(string).isValid());
 }
 
 #ifdef Q_OS_WIN
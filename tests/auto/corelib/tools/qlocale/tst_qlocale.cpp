@@ -918,6 +918,15 @@ void tst_QLocale::strtod_data()
     QTest::newRow("0x3.945e-6")        << QString("0x3.945e-6")        << 0.0 << 1 << true;
     QTest::newRow("0x12456789012")     << QString("0x12456789012")     << 0.0 << 1 << true;
     QTest::newRow("0x1.2456789012e10") << QString("0x1.2456789012e10") << 0.0 << 1 << true;
+
+    QTest::newRow("2^53")   << QString("9007199254740992") << 9007199254740992.0 << 16 << true;
+    QTest::newRow("2^53+1") << QString("9007199254740993") << 9007199254740992.0 << 16 << true;
+    QTest::newRow("1e22")   << QString("1e22")  << 1e22  << 4 << true;
+    QTest::newRow("1e23")   << QString("1e23")  << 1e23  << 4 << true;
+    QTest::newRow("1e-22")  << QString("1e-22") << 1e-22 << 5 << true;
+    QTest::newRow("1e-23")  << QString("1e-23") << 1e-23 << 5 << true;
+    QTest::newRow("0e5")    << QString("0e5")   << 0.0   << 3 << true;
+    QTest::newRow("0E5")    << QString("0E5")   << 0.0   << 3 << false;
 }
 
 void tst_QLocale::strtod()
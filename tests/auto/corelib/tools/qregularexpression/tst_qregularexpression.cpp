@@ -167,6 +167,7 @@ void consistencyCheck(const QRegularExpressionMatch &match)
                 int length = match.capturedLength(i);
                 QString captured = match.captured(i);
                 QStringRef capturedRef = match.capturedRef(i);
+                QByteArray capturedBytes = match.capturedBytes(i);
 
                 if (!captured.isNull()) {
                     QVERIFY(startPos >= 0);
@@ -174,7 +175,14 @@ void consistencyCheck(const QRegularExpressionMatch &match)
                     QVERIFY(length >= 0);
                     QVERIFY(endPos >= startPos);
                     QVERIFY((endPos - startPos) == length);
-                    QVERIFY(captured == capturedRef);
+                    if (capturedRef.isNull()) {
+                        // matched on UTF-8 or Latin-1 data
+                        QVERIFY(!capturedBytes.isNull());
+                        QVERIFY(capturedBytes.size() == length);
+                    } else {
+                        QVERIFY(captured == capturedRef);
+                        QVERIFY(capturedBytes.isNull());
+                    }
                 } else {
                     QVERIFY(startPos == -1);
                     QVERIFY(endPos == -1);
@@ -303,6 +311,142 @@ static void testMatch(const QRegularExpression &regexp,
                             result);
 }
 
+template<typename Subject>
+static void testReusedMatchImpl(const QRegularExpression &regexp,
+                                const Subject &subject,
+                                int offset,
+                                QRegularExpression::MatchType matchType,
+                                QRegularExpression::MatchOptions matchOptions,
+                                const Match &result)
+{
+    QRegularExpressionMatch m;
+    // fill the object with something else first
+    regexp.match(&m, QStringLiteral("a completely unrelated subject"));
+
+    const bool hasMatch = regexp.match(&m, subject, offset, matchType, matchOptions);
+    consistencyCheck(m);
+    QVERIFY(m == result);
+    QCOMPARE(hasMatch, m.hasMatch());
+    QCOMPARE(m.regularExpression(), regexp);
+    QCOMPARE(m.matchType(), matchType);
+    QCOMPARE(m.matchOptions(), matchOptions);
+
+    // a shared object must not be modified
+    const QRegularExpressionMatch copy = m;
+    regexp.match(&m, subject, offset, QRegularExpression::NoMatch, matchOptions);
+    QVERIFY(copy == result);
+    QCOMPARE(copy.matchType(), matchType);
+    QCOMPARE(m.matchType(), QRegularExpression::NoMatch);
+
+    if (matchType == QRegularExpression::NormalMatch && result.isValid)
+        QCOMPARE(regexp.matches(subject, offset, matchOptions), result.hasMatch);
+}
+
+static void testReusedMatch(const QRegularExpression &regexp,
+                            const QString &subject,
+                            int offset,
+                            QRegularExpression::MatchType matchType,
+                            QRegularExpression::MatchOptions matchOptions,
+                            const Match &result)
+{
+    testReusedMatchImpl(regexp, subject, offset, matchType, matchOptions, result);
+    testReusedMatchImpl(regexp, QStringRef(&subject, 0, subject.length()), offset, matchType, matchOptions, result);
+}
+
+static bool isValidUtf16(const QString &string)
+{
+    for (int i = 0; i < string.size(); ++i) {
+        const QChar c = string.at(i);
+        if (c.isHighSurrogate()) {
+            if (i + 1 == string.size() || !string.at(i + 1).isLowSurrogate())
+                return false;
+            ++i;
+        } else if (c.isLowSurrogate()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool isAscii(const QString &string)
+{
+    for (const QChar c : string) {
+        if (c.unicode() > 0x7f)
+            return false;
+    }
+    return true;
+}
+
+typedef QRegularExpressionMatch (QRegularExpression::*QREMatchBytesPMF)(const QByteArray &, int, QRegularExpression::MatchType, QRegularExpression::MatchOptions) const;
+
+// Matches the UTF-8 (and, if possible, the Latin-1) encoded subject, and
+// checks that the results are the ones of matching the QString subject,
+// with the offsets converted to bytes.
+static void testEncodedMatch(const QRegularExpression &regexp,
+                             const QString &subject,
+                             int offset,
+                             QRegularExpression::MatchType matchType,
+                             QRegularExpression::MatchOptions matchOptions,
+                             const Match &result)
+{
+    if (!regexp.isValid() || !isValidUtf16(subject))
+        return;
+
+    if (offset < 0)
+        offset += subject.size();
+    if (offset < 0 || offset > subject.size()) {
+        QVERIFY(!regexp.matchUtf8(subject.toUtf8(), subject.toUtf8().size() + 1, matchType, matchOptions).isValid());
+        return;
+    }
+    if (offset > 0 && offset < subject.size() && subject.at(offset).isLowSurrogate())
+        return;
+
+    const bool testLatin1 = isAscii(regexp.pattern()) && isAscii(subject);
+    const QRegularExpressionMatch reference = regexp.match(subject, offset, matchType, matchOptions);
+
+    const struct {
+        QREMatchBytesPMF matchingMethod;
+        QByteArray (*encode)(const QString &);
+    } encodings[] = {
+        { &QRegularExpression::matchUtf8, [](const QString &s) { return s.toUtf8(); } },
+        { &QRegularExpression::matchLatin1, [](const QString &s) { return s.toLatin1(); } }
+    };
+
+    for (const auto &encoding : encodings) {
+        if (encoding.matchingMethod == &QRegularExpression::matchLatin1 && !testLatin1)
+            continue;
+
+        const auto byteOffset = [&](int utf16Offset) {
+            return encoding.encode(subject.left(utf16Offset)).size();
+        };
+
+        const QByteArray bytes = encoding.encode(subject);
+        const QRegularExpressionMatch m = (regexp.*encoding.matchingMethod)(bytes, byteOffset(offset), matchType, matchOptions);
+        consistencyCheck(m);
+        QVERIFY(m == result);
+        QCOMPARE(m.regularExpression(), regexp);
+        QCOMPARE(m.matchType(), matchType);
+        QCOMPARE(m.lastCapturedIndex(), reference.lastCapturedIndex());
+        for (int i = 0; i <= m.lastCapturedIndex(); ++i) {
+            if (reference.capturedStart(i) == -1) {
+                QCOMPARE(m.capturedStart(i), -1);
+                QVERIFY(m.capturedBytes(i).isNull());
+            } else {
+                QCOMPARE(m.capturedStart(i), byteOffset(reference.capturedStart(i)));
+                QCOMPARE(m.capturedEnd(i), byteOffset(reference.capturedEnd(i)));
+                QCOMPARE(m.capturedBytes(i), encoding.encode(reference.captured(i)));
+            }
+            QVERIFY(m.capturedRef(i).isNull());
+        }
+    }
+
+    if (matchType == QRegularExpression::NormalMatch && result.isValid) {
+        QCOMPARE(regexp.matchesUtf8(subject.toUtf8(), subject.left(offset).toUtf8().size(), matchOptions), result.hasMatch);
+        if (testLatin1)
+            QCOMPARE(regexp.matchesLatin1(subject.toLatin1(), offset, matchOptions), result.hasMatch);
+    }
+}
+
 typedef QRegularExpressionMatch (QRegularExpression::*QREMatchStringPMF)(const QString &, int, QRegularExpression::MatchType, QRegularExpression::MatchOptions) const;
 typedef QRegularExpressionMatch (QRegularExpression::*QREMatchStringRefPMF)(const QStringRef &, int, QRegularExpression::MatchType, QRegularExpression::MatchOptions) const;
 typedef QRegularExpressionMatchIterator (QRegularExpression::*QREGlobalMatchStringPMF)(const QString &, int, QRegularExpression::MatchType, QRegularExpression::MatchOptions) const;
@@ -836,6 +980,8 @@ void tst_QRegularExpression::normalMatch()
                                        QRegularExpression::NormalMatch,
                                        matchOptions,
                                        match);
+    testReusedMatch(regexp, subject, offset, QRegularExpression::NormalMatch, matchOptions, match);
+    testEncodedMatch(regexp, subject, offset, QRegularExpression::NormalMatch, matchOptions, match);
 }
 
 void tst_QRegularExpression::partialMatch_data()
@@ -1108,6 +1254,8 @@ void tst_QRegularExpression::partialMatch()
                                        matchType,
                                        matchOptions,
                                        match);
+    testReusedMatch(regexp, subject, offset, matchType, matchOptions, match);
+    testEncodedMatch(regexp, subject, offset, matchType, matchOptions, match);
 }
 
 void tst_QRegularExpression::globalMatch_data()
@@ -1385,6 +1533,19 @@ void tst_QRegularExpression::globalMatch()
                                                matchType,
                                                matchOptions,
                                                matchList);
+
+    if (regexp.isValid() && isValidUtf16(subject) && offset >= 0 && offset <= subject.size()) {
+        const QByteArray utf8 = subject.toUtf8();
+        const int utf8Offset = subject.left(offset).toUtf8().size();
+        const QRegularExpressionMatchIterator i = regexp.globalMatchUtf8(utf8, utf8Offset, matchType, matchOptions);
+        consistencyCheck(i);
+        QVERIFY(i == matchList);
+        if (isAscii(regexp.pattern()) && isAscii(subject)) {
+            const QRegularExpressionMatchIterator j = regexp.globalMatchLatin1(subject.toLatin1(), offset, matchType, matchOptions);
+            consistencyCheck(j);
+            QVERIFY(j == matchList);
+        }
+    }
 }
 
 void tst_QRegularExpression::serialize_data()
@@ -2061,3 +2222,239 @@ void tst_QRegularExpression::QStringAndQStringRefEquivalence()
         }
     }
 }
+
+void tst_QRegularExpression::sharedPatterns()
+{
+    QRegularExpression re1(QStringLiteral("(\\d+)-(\\d+)"));
+    QRegularExpression re2(QStringLiteral("(\\d+)-(\\d+)"));
+    QRegularExpression re3(QStringLiteral("(\\d+)-(\\d+)"), QRegularExpression::CaseInsensitiveOption);
+    QCOMPARE(re1, re2);
+    QVERIFY(re1 != re3);
+    QCOMPARE(re1.captureCount(), 2);
+    QCOMPARE(re2.captureCount(), 2);
+    QCOMPARE(re3.captureCount(), 2);
+
+    // changing one object must not affect the others
+    re2.setPattern(QStringLiteral("(\\d+)"));
+    QCOMPARE(re2.captureCount(), 1);
+    QCOMPARE(re1.captureCount(), 2);
+    QCOMPARE(re1.match(QStringLiteral("12-34")).captured(2), QStringLiteral("34"));
+
+    re2.setPattern(re1.pattern());
+    QCOMPARE(re2, re1);
+    re2.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+    QCOMPARE(re2, re3);
+    QCOMPARE(re1.patternOptions(), QRegularExpression::NoPatternOption);
+
+    // an invalid pattern stays invalid
+    QRegularExpression invalid1(QStringLiteral("a("));
+    QRegularExpression invalid2(QStringLiteral("a("));
+    QVERIFY(!invalid1.isValid());
+    QVERIFY(!invalid2.isValid());
+    QCOMPARE(invalid2.errorString(), invalid1.errorString());
+    QCOMPARE(invalid2.patternErrorOffset(), invalid1.patternErrorOffset());
+}
+
+void tst_QRegularExpression::matchReuse()
+{
+    const QRegularExpression re(QStringLiteral("(?<key>\\w+)=(?<value>\\d*)"));
+    const QStringList subjects = QStringList()
+            << QStringLiteral("width=42")
+            << QStringLiteral("nothing here")
+            << QStringLiteral("a= b=7")
+            << QStringLiteral("height=");
+
+    QRegularExpressionMatch reused;
+    for (const QString &subject : subjects) {
+        const QRegularExpressionMatch expected = re.match(subject);
+        QCOMPARE(re.match(&reused, subject), expected.hasMatch());
+        consistencyCheck(reused);
+        QCOMPARE(reused.hasMatch(), expected.hasMatch());
+        QCOMPARE(reused.capturedTexts(), expected.capturedTexts());
+        QCOMPARE(reused.captured("key"), expected.captured("key"));
+        QCOMPARE(reused.capturedStart("value"), expected.capturedStart("value"));
+        QCOMPARE(re.matches(subject), expected.hasMatch());
+    }
+
+    // offsets, and a string reference
+    const QString subject = QStringLiteral("x=1 y=2");
+    QVERIFY(re.match(&reused, subject, 3));
+    QCOMPARE(reused.captured(), QStringLiteral("y=2"));
+    QVERIFY(re.match(&reused, subject.midRef(0, 3)));
+    QCOMPARE(reused.captured(), QStringLiteral("x=1"));
+    QVERIFY(!re.match(&reused, subject.midRef(0, 3), 2));
+    QVERIFY(!re.matches(subject, 8));
+    QVERIFY(re.matches(subject, -3));
+    QVERIFY(!re.matches(subject.midRef(1, 3)));
+
+    // results of a global match can be advanced from a reused object
+    QVERIFY(re.match(&reused, subject));
+    QRegularExpressionMatchIterator i = re.globalMatch(subject);
+    QVERIFY(i.hasNext());
+    QCOMPARE(i.next().captured(), reused.captured());
+    QCOMPARE(i.next().captured(), QStringLiteral("y=2"));
+
+    // invalid subject strings
+    const QChar badUtf16[] = { QChar('a'), QChar(0xD800), QChar('=') };
+    const QString bad(badUtf16, 3);
+    QVERIFY(!QRegularExpression(QStringLiteral("a")).matches(bad));
+    QVERIFY(!re.match(&reused, bad));
+    QVERIFY(!reused.isValid());
+}
+
+void tst_QRegularExpression::regularExpressionSet_data()
+{
+    QTest::addColumn<QString>("subject");
+
+    QTest::newRow("empty") << QString();
+    QTest::newRow("error") << QStringLiteral("ERROR: disk full");
+    QTest::newRow("error-lowercase") << QStringLiteral("error: Disk Quota exceeded");
+    QTest::newRow("timeout") << QStringLiteral("request timeout after 1500ms");
+    QTest::newRow("timeout-no-digits") << QStringLiteral("request timeout after ms");
+    QTest::newRow("digits") << QStringLiteral("12345");
+    QTest::newRow("multiline") << QStringLiteral("first line\nERROR on the second");
+    QTest::newRow("latin1") << QString::fromUtf8("caf\xc3\xa9 CAF\xc3\x89");
+    QTest::newRow("non-latin1") << QString::fromUtf8("\xce\xbc\xce\x9c \xc5\xb8 \xe2\x84\xaa");
+    QTest::newRow("surrogates") << QString::fromUtf8("\xf0\x9f\x98\x80 smile");
+    QTest::newRow("spaces") << QStringLiteral("   ");
+    QTest::newRow("kelvin") << QString::fromUtf8("\xe2\x84\xaaelvin");
+}
+
+void tst_QRegularExpression::regularExpressionSet()
+{
+    QFETCH(QString, subject);
+
+    const QVector<QRegularExpression> expressions = QVector<QRegularExpression>()
+            << QRegularExpression(QStringLiteral("^ERROR\\b"))
+            << QRegularExpression(QStringLiteral("^ERROR\\b"), QRegularExpression::MultilineOption)
+            << QRegularExpression(QStringLiteral("error"), QRegularExpression::CaseInsensitiveOption)
+            << QRegularExpression(QStringLiteral("(?i)disk (full|quota)"))
+            << QRegularExpression(QStringLiteral("timeout after \\d+ms"))
+            << QRegularExpression(QStringLiteral("[0-9]{5}"))
+            << QRegularExpression(QStringLiteral("(?:foo|bar|\\d)x?$"))
+            << QRegularExpression(QStringLiteral("x*"))
+            << QRegularExpression(QString::fromUtf8("caf\xc3\xa9"), QRegularExpression::CaseInsensitiveOption)
+            << QRegularExpression(QString::fromUtf8("\xc2\xb5"), QRegularExpression::CaseInsensitiveOption)
+            << QRegularExpression(QString::fromUtf8("\xc3\xbf"), QRegularExpression::CaseInsensitiveOption)
+            << QRegularExpression(QStringLiteral("kelvin"), QRegularExpression::CaseInsensitiveOption
+                                                            | QRegularExpression::UseUnicodePropertiesOption)
+            << QRegularExpression(QStringLiteral("\\x{1F600}"))
+            << QRegularExpression(QStringLiteral("(*NO_START_OPT)smile"))
+            << QRegularExpression(QStringLiteral("\\s+"), QRegularExpression::DontAutomaticallyOptimizeOption)
+            << QRegularExpression(QStringLiteral("unbalanced("));
+
+    QRegularExpressionSet set;
+    QVERIFY(set.isEmpty());
+    QVERIFY(set.isValid());
+    QCOMPARE(set.firstMatchingIndex(subject), -1);
+    for (const QRegularExpression &re : expressions)
+        set.append(re);
+    QCOMPARE(set.size(), expressions.size());
+    QCOMPARE(set.expressions(), expressions);
+    QVERIFY(!set.isValid());
+
+    QVector<int> expected;
+    for (int i = 0; i < expressions.size(); ++i) {
+        // an invalid regular expression never matches
+        if (expressions.at(i).isValid() && expressions.at(i).match(subject).hasMatch())
+            expected.append(i);
+    }
+
+    QCOMPARE(set.matchingIndexes(subject), expected);
+    QCOMPARE(set.firstMatchingIndex(subject), expected.isEmpty() ? -1 : expected.first());
+
+    // the same subject inside a larger string
+    const QString padded = QLatin1String("\n") + subject + QLatin1String("\n");
+    const QStringRef subjectRef = padded.midRef(1, subject.length());
+    QCOMPARE(set.matchingIndexes(subjectRef), expected);
+    QCOMPARE(set.firstMatchingIndex(subjectRef), expected.isEmpty() ? -1 : expected.first());
+
+    // sets built from patterns
+    QStringList patterns;
+    for (const QRegularExpression &re : expressions)
+        patterns << re.pattern();
+    const QRegularExpressionSet caseInsensitiveSet(patterns, QRegularExpression::CaseInsensitiveOption);
+    expected.clear();
+    for (int i = 0; i < patterns.size(); ++i) {
+        const QRegularExpression re(patterns.at(i), QRegularExpression::CaseInsensitiveOption);
+        if (re.isValid() && re.matches(subject))
+            expected.append(i);
+    }
+    QCOMPARE(caseInsensitiveSet.matchingIndexes(subject), expected);
+
+    QRegularExpressionSet copy = set;
+    copy.clear();
+    QVERIFY(copy.isEmpty());
+    QCOMPARE(set.size(), expressions.size());
+}
+
+void tst_QRegularExpression::encodedSubjects()
+{
+    // "ü€😀" is 2 + 3 + 4 bytes in UTF-8
+    const QByteArray utf8 = QString::fromUtf8("\xc3\xbc\xe2\x82\xac\xf0\x9f\x98\x80").toUtf8();
+
+    {
+        // empty matches advance by whole characters
+        QRegularExpression re("");
+        QRegularExpressionMatchIterator i = re.globalMatchUtf8(utf8);
+        QList<int> offsets;
+        while (i.hasNext())
+            offsets << i.next().capturedStart();
+        QCOMPARE(offsets, QList<int>() << 0 << 2 << 5 << 9);
+    }
+    {
+        QRegularExpression re("(?<euro>\\x{20ac})(.)");
+        if (forceOptimize)
+            re.optimize();
+        QRegularExpressionMatch m = re.matchUtf8(utf8);
+        QVERIFY(m.hasMatch());
+        QCOMPARE(m.capturedStart("euro"), 2);
+        QCOMPARE(m.capturedEnd("euro"), 5);
+        QCOMPARE(m.capturedBytes("euro"), QByteArray("\xe2\x82\xac"));
+        QCOMPARE(m.captured(2), QString::fromUtf8("\xf0\x9f\x98\x80"));
+        QCOMPARE(m.capturedLength(2), 4);
+        QVERIFY(m.capturedRef(1).isNull());
+
+        // a QString subject doesn't have bytes
+        m = re.match(QString::fromUtf8(utf8));
+        QVERIFY(m.hasMatch());
+        QVERIFY(m.capturedBytes(1).isNull());
+        QCOMPARE(m.capturedRef(1).toString(), QString(QChar(0x20ac)));
+    }
+    {
+        QRegularExpression re("\\w+", QRegularExpression::CaseInsensitiveOption | QRegularExpression::UseUnicodePropertiesOption);
+        QRegularExpressionMatch m = re.matchUtf8(QByteArray("  \xc3\x9c" "ber "));
+        QCOMPARE(m.capturedBytes(), QByteArray("\xc3\x9c" "ber"));
+        QVERIFY(QRegularExpression("\xc3\xbc", QRegularExpression::CaseInsensitiveOption).matchesUtf8("\xc3\x9c"));
+    }
+    {
+        // invalid UTF-8 gives an invalid match, unless the check is skipped
+        QRegularExpression re("a");
+        QVERIFY(!re.matchUtf8("\xff" "a").isValid());
+        QVERIFY(!re.matchesUtf8("\xff" "a"));
+        QVERIFY(re.matchUtf8("a\xc3\xbc", 0, QRegularExpression::NormalMatch,
+                             QRegularExpression::DontCheckSubjectStringMatchOption).hasMatch());
+    }
+    {
+        QRegularExpression re(QString::fromLatin1("gr\xfc\xdf(e)"));
+        const QByteArray latin1 = QByteArray("viele Gr\xfc\xdf" "e, gr\xfc\xdf" "e");
+        QRegularExpressionMatch m = re.matchLatin1(latin1);
+        QVERIFY(m.hasMatch());
+        QCOMPARE(m.capturedStart(), 13);
+        QCOMPARE(m.capturedStart(1), 17);
+        QCOMPARE(m.captured(), QString::fromLatin1("gr\xfc\xdf" "e"));
+        QCOMPARE(m.capturedBytes(), QByteArray("gr\xfc\xdf" "e"));
+        QVERIFY(re.matchesLatin1(latin1));
+        QVERIFY(!re.matchesLatin1(latin1, 15));
+        QVERIFY(!re.matchesUtf8(latin1, 0, QRegularExpression::DontCheckSubjectStringMatchOption));
+        QVERIFY(re.matchesUtf8(QString::fromLatin1(latin1).toUtf8()));
+    }
+    {
+        // a pattern with characters outside Latin-1 can't match Latin-1 data
+        QRegularExpression re(QString(QChar(0x20ac)));
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("contains characters outside Latin-1"));
+        QVERIFY(!re.matchLatin1("\x80").isValid());
+        QVERIFY(!re.matchesLatin1("\x80"));
+        QVERIFY(re.matchesUtf8("\xe2\x82\xac"));
+    }
+}
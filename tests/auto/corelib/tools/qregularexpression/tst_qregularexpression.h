@@ -68,6 +68,11 @@ private slots:
     void JOptionUsage_data();
     void JOptionUsage();
     void QStringAndQStringRefEquivalence();
+    void sharedPatterns();
+    void matchReuse();
+    void regularExpressionSet_data();
+    void regularExpressionSet();
+    void encodedSubjects();
 
 private:
     void provideRegularExpressions();
@@ -3518,6 +3518,22 @@ void tst_QString::toULongLong()
     QCOMPARE( str.toULongLong( 0 ), Q_UINT64_C(0) );
     QCOMPARE( str.toULongLong( &ok ), Q_UINT64_C(0) );
     QVERIFY( !ok );
+
+    str = "99999999999999999999"; // 20 digits
+    QCOMPARE( str.toULongLong( &ok ), Q_UINT64_C(0) );
+    QVERIFY( !ok );
+
+    str = "100000000000000000000"; // 21 digits
+    QCOMPARE( str.toULongLong( &ok ), Q_UINT64_C(0) );
+    QVERIFY( !ok );
+
+    str = "00000000000000000000018446744073709551615";
+    QCOMPARE( str.toULongLong( &ok ), Q_UINT64_C(18446744073709551615) );
+    QVERIFY( ok );
+
+    str = " 12345678 ";
+    QCOMPARE( str.toULongLong( &ok ), Q_UINT64_C(12345678) );
+    QVERIFY( ok );
 }
 
 void tst_QString::toLongLong()
@@ -3566,6 +3582,26 @@ void tst_QString::toLongLong()
             }
         }
     }
+
+    str = "9223372036854775808"; // LLONG_MAX + 1
+    QCOMPARE( str.toLongLong( &ok ), Q_INT64_C(0) );
+    QVERIFY( !ok );
+
+    str = "-9223372036854775809"; // LLONG_MIN - 1
+    QCOMPARE( str.toLongLong( &ok ), Q_INT64_C(0) );
+    QVERIFY( !ok );
+
+    str = "-10000000000000000000"; // 20 digits
+    QCOMPARE( str.toLongLong( &ok ), Q_INT64_C(0) );
+    QVERIFY( !ok );
+
+    str = "-0000000000000000000009223372036854775808";
+    QCOMPARE( str.toLongLong( &ok ), -Q_INT64_C(9223372036854775807) - Q_INT64_C(1) );
+    QVERIFY( ok );
+
+    str = "+123456789";
+    QCOMPARE( str.toLongLong( &ok ), Q_INT64_C(123456789) );
+    QVERIFY( ok );
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -3612,6 +3648,16 @@ void tst_QString::toDouble_data()
     QTest::newRow( "wrong05" ) << QString("abc") << 0.0 << false;
     QTest::newRow( "wrong06" ) << QString() << 0.0 << false;
     QTest::newRow( "wrong07" ) << QString("") << 0.0 << false;
+
+    QTest::newRow( "exact00" ) << QString("9007199254740992") << 9007199254740992.0 << true;
+    QTest::newRow( "exact01" ) << QString("9007199254740993") << 9007199254740992.0 << true;
+    QTest::newRow( "exact02" ) << QString("1e22") << 1e22 << true;
+    QTest::newRow( "exact03" ) << QString("1e23") << 1e23 << true;
+    QTest::newRow( "exact04" ) << QString("1e-22") << 1e-22 << true;
+    QTest::newRow( "exact05" ) << QString("1e-23") << 1e-23 << true;
+    QTest::newRow( "exact06" ) << QString("-1.5E3") << -1500.0 << true;
+    QTest::newRow( "exact07" ) << QString("0E5") << 0.0 << true;
+    QTest::newRow( "exact08" ) << QString("1234567890123456789") << 1234567890123456789.0 << true;
 }
 
 void tst_QString::toDouble()
@@ -3626,6 +3672,12 @@ void tst_QString::toDouble()
     } else {
         QVERIFY( !ok );
     }
+
+    // same result as the locale code path
+    bool localeOk;
+    const double localeD = QLocale::c().toDouble( str, &localeOk );
+    QCOMPARE( ok, localeOk );
+    QVERIFY( d == localeD || (qIsNaN(d) && qIsNaN(localeD)) );
 }
 
 void tst_QString::setNum()
@@ -4758,6 +4810,30 @@ void tst_QString::number()
     QCOMPARE( QString::number(12.05, 'f', 1), QString("12.1") );
     QCOMPARE( QString::number(12.5, 'f', 0), QString("13") );
 #endif
+
+    // same output as the locale code path, and the shortest form round-trips;
+    // unlike QLocale, QString::number() does not pad the exponent
+    QLocale c = QLocale::c();
+    c.setNumberOptions(c.numberOptions() | QLocale::OmitLeadingZeroInExponent);
+    const double values[] = { 0.0, -0.0, 0.1, -1.5, 1e22, 1e23, 9007199254740992.0, 123456789.125,
+                              4.9406564584124654e-324, 1.7976931348623157e308, qInf(), qQNaN() };
+    const char formats[] = { 'e', 'E', 'f', 'g', 'G' };
+    const int precisions[] = { 0, 1, 6, 17, QLocale::FloatingPointShortest };
+    for (double value : values) {
+        for (char format : formats) {
+            for (int precision : precisions) {
+                const QString expected = c.toString(value, format, precision);
+                QString str;
+                QCOMPARE( QString::number(value, format, precision), expected );
+                QCOMPARE( str.setNum(value, format, precision), expected );
+            }
+        }
+        if (qIsFinite(value)) {
+            bool ok;
+            QVERIFY( QString::number(value, 'g', QLocale::FloatingPointShortest).toDouble(&ok) == value );
+            QVERIFY( ok );
+        }
+    }
 }
 
 void tst_QString::capacity_data()
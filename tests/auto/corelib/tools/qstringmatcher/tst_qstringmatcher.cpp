@@ -41,6 +41,8 @@ private slots:
     void setCaseSensitivity_data();
     void setCaseSensitivity();
     void assignOperator();
+    void indexInAgainstNaive_data();
+    void indexInAgainstNaive();
 };
 
 void tst_QStringMatcher::qstringmatcher()
@@ -133,6 +135,73 @@ void tst_QStringMatcher::assignOperator()
     QCOMPARE(m2.indexIn(hayStack), 3);
 }
 
+void tst_QStringMatcher::indexInAgainstNaive_data()
+{
+    QTest::addColumn<int>("needleLength");
+    QTest::addColumn<bool>("caseSensitive");
+
+    // around the widths of the vectorized loops and the Boyer-Moore threshold
+    for (int length : { 2, 3, 7, 8, 9, 15, 16, 17, 33, 64, 65, 100 }) {
+        const QByteArray suffix = QByteArray::number(length);
+        QTest::newRow(("sensitive-" + suffix).constData()) << length << true;
+        QTest::newRow(("insensitive-" + suffix).constData()) << length << false;
+    }
+}
+
+static int naiveIndexOf(const QString &haystack, const QString &needle, int from, Qt::CaseSensitivity cs)
+{
+    for (int i = from; i + needle.size() <= haystack.size(); ++i) {
+        if (haystack.midRef(i, needle.size()).compare(needle, cs) == 0)
+            return i;
+    }
+    return -1;
+}
+
+void tst_QStringMatcher::indexInAgainstNaive()
+{
+    QFETCH(int, needleLength);
+    QFETCH(bool, caseSensitive);
+    const Qt::CaseSensitivity cs = caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    // few distinct characters, so that partial matches are frequent; the
+    // non-ASCII ones fold to ASCII (KELVIN SIGN) or are in Latin-1
+    const QChar alphabet[] = { 'a', 'A', 'b', 'k', 'K', QChar(0x212a), QChar(0xe4), QChar(0xc4) };
+    const int alphabetSize = sizeof(alphabet) / sizeof(alphabet[0]);
+    quint32 seed = 42 + needleLength;
+    const auto random = [&seed](int bound) {
+        seed = seed * 1103515245 + 12345;
+        return int((seed >> 16) % bound);
+    };
+
+    for (int round = 0; round < 200; ++round) {
+        QString needle;
+        for (int i = 0; i < needleLength; ++i)
+            needle += alphabet[random(round % 2 ? 3 : alphabetSize)];
+        QString haystack;
+        const int haystackLength = random(300);
+        for (int i = 0; i < haystackLength; ++i)
+            haystack += alphabet[random(round % 2 ? 3 : alphabetSize)];
+        // plant the needle, possibly with a different case
+        if (haystackLength > needleLength && random(2)) {
+            const QString planted = random(2) ? needle.toUpper() : needle;
+            haystack.replace(random(haystackLength - needleLength), needleLength, planted);
+        }
+        const int from = random(20);
+
+        const QStringMatcher matcher(needle, cs);
+        const int expected = naiveIndexOf(haystack, needle, from, cs);
+        QCOMPARE(matcher.indexIn(haystack, from), expected);
+        QCOMPARE(matcher.indexIn(haystack.constData(), haystack.size(), from), expected);
+        QCOMPARE(haystack.indexOf(needle, from, cs), expected);
+        QCOMPARE(haystack.contains(needle, cs), naiveIndexOf(haystack, needle, 0, cs) != -1);
+
+        int count = 0;
+        for (int i = naiveIndexOf(haystack, needle, 0, cs); i != -1; i = naiveIndexOf(haystack, needle, i + 1, cs))
+            ++count;
+        QCOMPARE(haystack.count(needle, cs), count);
+    }
+}
+
 QTEST_MAIN(tst_QStringMatcher)
 #include "tst_qstringmatcher.moc"
 
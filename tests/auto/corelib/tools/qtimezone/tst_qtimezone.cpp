@@ -53,6 +53,7 @@ private slots:
     void utcTest();
     void icuTest();
     void tzTest();
+    void tzTransitionLookup();
     void macTest();
     void winTest();
 
@@ -839,6 +840,38 @@ void tst_QTimeZone::tzTest()
 #endif // Q_OS_UNIX
 }
 
+void tst_QTimeZone::tzTransitionLookup()
+{
+#if defined QT_BUILD_INTERNAL && defined Q_OS_UNIX && !defined Q_OS_MAC
+    const qint64 start = QDateTime(QDate(1900, 1, 1), QTime(0, 0, 0), Qt::UTC).toMSecsSinceEpoch();
+    const qint64 end = QDateTime(QDate(2030, 1, 1), QTime(0, 0, 0), Qt::UTC).toMSecsSinceEpoch();
+    QTzTimeZonePrivate tzp("Europe/Berlin");
+    QVERIFY(tzp.isValid());
+    const QTimeZonePrivate::DataList transitions = tzp.transitions(start, end);
+    QVERIFY(transitions.size() > 100);
+
+    // A second instance shares the parsed zone, look up the transitions out of order
+    QTzTimeZonePrivate tzp2("Europe/Berlin");
+    QVERIFY(tzp2.isValid());
+    for (int step : { 1, 7, -3, 13 }) {
+        for (int n = 0; n < transitions.size(); ++n) {
+            const int i = int((qint64(n) * (step + transitions.size())) % transitions.size());
+            const QTimeZonePrivate::Data &tran = transitions.at(i);
+            QCOMPARE(tzp2.data(tran.atMSecsSinceEpoch).offsetFromUtc, tran.offsetFromUtc);
+            QCOMPARE(tzp2.data(tran.atMSecsSinceEpoch).abbreviation, tran.abbreviation);
+            QCOMPARE(tzp2.nextTransition(tran.atMSecsSinceEpoch - 1).atMSecsSinceEpoch,
+                     tran.atMSecsSinceEpoch);
+            QCOMPARE(tzp2.previousTransition(tran.atMSecsSinceEpoch + 1).atMSecsSinceEpoch,
+                     tran.atMSecsSinceEpoch);
+            if (i > 0) {
+                QCOMPARE(tzp2.data(tran.atMSecsSinceEpoch - 1).offsetFromUtc,
+                         transitions.at(i - 1).offsetFromUtc);
+            }
+        }
+    }
+#endif // Q_OS_UNIX
+}
+
 void tst_QTimeZone::macTest()
 {
 #if defined(QT_BUILD_INTERNAL) && defined (Q_OS_MAC)
@@ -553,10 +553,15 @@ private slots:
     void garbageInXMLPrologDefaultCodec() const;
     void garbageInXMLPrologUTF8Explicitly() const;
     void clear() const;
+    void clearForgetsDeclarations() const;
     void checkCommentIndentation() const;
     void checkCommentIndentation_data() const;
     void crashInXmlStreamReader() const;
     void hasError() const;
+    void readChunkedByteArray_data() const;
+    void readChunkedByteArray() const;
+    void readIncrementally_data() const;
+    void readIncrementally() const;
 
 private:
     static QByteArray readFile(const QString &filename);
@@ -1429,6 +1434,44 @@ void tst_QXmlStream::clear() const
     QCOMPARE(reader.tokenType(), QXmlStreamReader::EndDocument);
 }
 
+void tst_QXmlStream::clearForgetsDeclarations() const
+{
+    QXmlStreamReader reader;
+
+    // an entity declared by one document
+    reader.addData("<!DOCTYPE a [<!ENTITY e \"entity\">]><a>&e;</a>");
+    while (!reader.atEnd())
+        reader.readNext();
+    QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+
+    // is not known to the next one
+    reader.clear();
+    reader.addData("<a>&e;</a>");
+    while (!reader.atEnd())
+        reader.readNext();
+    QVERIFY(reader.hasError());
+
+    // and neither is a namespace declared by an unfinished document
+    reader.clear();
+    reader.addData("<a xmlns:p=\"urn:p\"><p:b>");
+    while (reader.readNext() != QXmlStreamReader::StartElement || reader.name() != QLatin1String("b")) {}
+    QCOMPARE(reader.namespaceUri().toString(), QString("urn:p"));
+    reader.clear();
+    reader.addData("<p:c/>");
+    while (!reader.atEnd())
+        reader.readNext();
+    QVERIFY(reader.hasError());
+
+    // the predefined entities are always available
+    reader.clear();
+    reader.addData("<a b=\"&lt;&amp;&gt;&apos;&quot;\">&lt;&amp;&gt;&apos;&quot;</a>");
+    QCOMPARE(reader.readNext(), QXmlStreamReader::StartDocument);
+    QCOMPARE(reader.readNext(), QXmlStreamReader::StartElement);
+    QCOMPARE(reader.attributes().value("b").toString(), QString("<&>'\""));
+    QCOMPARE(reader.readElementText(), QString("<&>'\""));
+    QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+}
+
 void tst_QXmlStream::checkCommentIndentation_data() const
 {
 
@@ -1575,5 +1618,202 @@ void tst_QXmlStream::hasError() const
 
 }
 
+static QString tokenString(const QXmlStreamReader &reader)
+{
+    QString result = reader.tokenString();
+    switch (reader.tokenType()) {
+    case QXmlStreamReader::StartDocument:
+        result += QLatin1Char(' ');
+        result += reader.documentEncoding();
+        break;
+    case QXmlStreamReader::StartElement:
+        result += QLatin1Char(' ');
+        result += reader.name();
+        for (const QXmlStreamAttribute &attribute : reader.attributes()) {
+            result += QLatin1Char(' ');
+            result += attribute.name();
+            result += QLatin1Char('=');
+            result += attribute.value();
+        }
+        break;
+    case QXmlStreamReader::EndElement:
+        result += QLatin1Char(' ');
+        result += reader.name();
+        break;
+    case QXmlStreamReader::Characters:
+        if (reader.isCDATA())
+            result += QLatin1String(" CDATA");
+        result += QLatin1Char(' ');
+        result += reader.text();
+        break;
+    case QXmlStreamReader::Comment:
+        result += QLatin1Char(' ');
+        result += reader.text();
+        break;
+    case QXmlStreamReader::ProcessingInstruction:
+        result += QLatin1Char(' ');
+        result += reader.processingInstructionTarget();
+        result += QLatin1Char(' ');
+        result += reader.processingInstructionData();
+        break;
+    default:
+        break;
+    }
+    return result;
+}
+
+// The text of a document is split into Characters tokens where the data
+// added so far ends, join them to compare with a document read at once.
+static void appendToken(QStringList &tokens, const QXmlStreamReader &reader)
+{
+    const QString token = tokenString(reader);
+    if (reader.isCharacters() && !reader.isCDATA() && !tokens.isEmpty()
+        && tokens.last().startsWith(QLatin1String("Characters ")) && !tokens.last().startsWith(QLatin1String("Characters CDATA "))) {
+        tokens.last() += reader.text();
+    } else {
+        tokens.append(token);
+    }
+}
+
+static QStringList readTokens(QXmlStreamReader &reader)
+{
+    QStringList tokens;
+    while (!reader.atEnd()) {
+        reader.readNext();
+        if (reader.hasError())
+            tokens.append(reader.errorString());
+        else
+            appendToken(tokens, reader);
+    }
+    return tokens;
+}
+
+// Character data which the reader scans in bulk, with every delimiter, line
+// break and multibyte sequence of it crossing the 8 KB chunks a QByteArray
+// is decoded in for some padding.
+static QString chunkedUnit(bool unicode)
+{
+    QString unit = QString::fromUtf8("<e a=\"x&amp;y&lt;\xc3\xa9\r\nz\" b='\"]]>'>t\xc3\xa9xt &amp; &#x20AC; \r\n"
+                                     "l\rine ]]&gt; <![CDATA[c]]d]]]>\xc3\xa9<!--c\xc3\xa9 -\r\n-->"
+                                     "<?pi d\xc3\xa9\r\n?>");
+    if (unicode)
+        unit += QString::fromUtf8("\xe2\x82\xac\xf0\x9d\x84\x9e<![CDATA[\xf0\x9d\x84\x9e]]>");
+    unit += QLatin1String("</e>\r\n");
+    return unit;
+}
+
+static QByteArray chunkedDocument(const QByteArray &encoding, int padding, int units)
+{
+    const bool unicode = encoding.startsWith("UTF");
+    QString document = QLatin1String("<?xml version=\"1.0\" encoding=\"") + QLatin1String(encoding)
+                     + QLatin1String("\"?>\n<root") + QString(padding, QLatin1Char(' ')) + QLatin1Char('>');
+    for (int i = 0; i < units; ++i)
+        document += chunkedUnit(unicode);
+    document += QLatin1String("</root>\n");
+    return QTextCodec::codecForName(encoding)->fromUnicode(document);
+}
+
+static QStringList expectedChunkedTokens(const QByteArray &encoding, int units)
+{
+    // small enough to be decoded in one piece
+    QXmlStreamReader reader(chunkedDocument(encoding, 0, 1));
+    const QStringList tokens = readTokens(reader);
+    const int first = tokens.indexOf(QStringLiteral("StartElement root")) + 1;
+    const int last = tokens.lastIndexOf(QStringLiteral("EndElement root"));
+    Q_ASSERT(first > 0 && last > first);
+
+    QStringList expected = tokens.mid(0, first);
+    for (int i = 0; i < units; ++i)
+        expected += tokens.mid(first, last - first);
+    expected += tokens.mid(last);
+    return expected;
+}
+
+void tst_QXmlStream::readChunkedByteArray_data() const
+{
+    QTest::addColumn<QByteArray>("encoding");
+
+    QTest::newRow("UTF-8") << QByteArray("UTF-8");
+    QTest::newRow("ISO-8859-1") << QByteArray("ISO-8859-1");
+    QTest::newRow("UTF-16") << QByteArray("UTF-16");
+}
+
+void tst_QXmlStream::readChunkedByteArray() const
+{
+    QFETCH(QByteArray, encoding);
+
+    const int unitSize = QTextCodec::codecForName(encoding)->fromUnicode(chunkedUnit(encoding.startsWith("UTF"))).size();
+    const int units = 3 * 8192 / unitSize;
+    const QStringList expected = expectedChunkedTokens(encoding, units);
+    QVERIFY(expected.size() > units);
+
+    for (int padding = 0; padding < unitSize + 4; ++padding) {
+        const QByteArray document = chunkedDocument(encoding, padding, units);
+        QVERIFY(document.size() > 2 * 8192);
+
+        QXmlStreamReader reader(document);
+        QCOMPARE(readTokens(reader), expected);
+        QVERIFY(!reader.hasError());
+
+        // the same chunks through a device
+        QBuffer buffer;
+        buffer.setData(document);
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+        QXmlStreamReader deviceReader(&buffer);
+        QCOMPARE(readTokens(deviceReader), expected);
+    }
+}
+
+void tst_QXmlStream::readIncrementally_data() const
+{
+    QTest::addColumn<QByteArray>("encoding");
+    QTest::addColumn<int>("pieceSize");
+    QTest::addColumn<int>("tokensPerPiece");
+
+    QTest::newRow("UTF-8, small pieces, read all") << QByteArray("UTF-8") << 1001 << -1;
+    QTest::newRow("UTF-8, large pieces, read all") << QByteArray("UTF-8") << 9001 << -1;
+    QTest::newRow("UTF-8, small pieces, read some") << QByteArray("UTF-8") << 1001 << 3;
+    QTest::newRow("UTF-8, large pieces, read some") << QByteArray("UTF-8") << 20001 << 40;
+    QTest::newRow("ISO-8859-1, large pieces, read some") << QByteArray("ISO-8859-1") << 9001 << 25;
+}
+
+void tst_QXmlStream::readIncrementally() const
+{
+    QFETCH(QByteArray, encoding);
+    QFETCH(int, pieceSize);
+    QFETCH(int, tokensPerPiece);
+
+    const int units = 8 * 8192 / chunkedUnit(true).toUtf8().size();
+    const QByteArray document = chunkedDocument(encoding, 7, units);
+    const QStringList expected = expectedChunkedTokens(encoding, units);
+
+    QXmlStreamReader reader;
+    QStringList tokens;
+    for (int pos = 0; pos < document.size(); pos += pieceSize) {
+        reader.addData(document.mid(pos, pieceSize));
+        // leave data unread before adding more, unless this is the last piece
+        const bool last = pos + pieceSize >= document.size();
+        for (int i = 0; last || tokensPerPiece < 0 || i < tokensPerPiece; ++i) {
+            reader.readNext();
+            if (reader.hasError()) {
+                QCOMPARE(reader.error(), QXmlStreamReader::PrematureEndOfDocumentError);
+                QVERIFY(reader.atEnd());
+                break;
+            }
+            QVERIFY(!reader.atEnd() || reader.isEndDocument());
+            appendToken(tokens, reader);
+            if (reader.isEndDocument())
+                break;
+        }
+    }
+    while (!reader.atEnd()) {
+        reader.readNext();
+        QVERIFY(!reader.hasError());
+        appendToken(tokens, reader);
+    }
+    QVERIFY(reader.isEndDocument());
+    QCOMPARE(tokens, expected);
+}
+
 #include "tst_qxmlstream.moc"
 // vim: et:ts=4:sw=4:sts=4
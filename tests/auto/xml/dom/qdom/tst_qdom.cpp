@@ -115,6 +115,7 @@ private slots:
     void DTDNotationDecl();
     void DTDEntityDecl();
     void QTBUG49113_dontCrashWithNegativeIndex() const;
+    void sharedNames() const;
 
     void cleanupTestCase() const;
 
@@ -1983,5 +1984,43 @@ void tst_QDom::QTBUG49113_dontCrashWithNegativeIndex() const
     QVERIFY(node.isNull());
 }
 
+void tst_QDom::sharedNames() const
+{
+    const QString xml("<root xmlns='urn:a' xmlns:b='urn:b'>"
+                      "<item b:id='1'/><b:item b:id='2'/><item/>"
+                      "</root>");
+    QDomElement first;
+    QDomElement second;
+    QDomElement third;
+    {
+        QDomDocument doc;
+        QVERIFY(doc.setContent(xml, true));
+        first = doc.documentElement().firstChildElement();
+        second = first.nextSiblingElement();
+        third = second.nextSiblingElement();
+
+        // The default namespace gives an empty prefix, no namespace a null one
+        QVERIFY(first.prefix().isEmpty());
+        QVERIFY(!first.prefix().isNull());
+        QCOMPARE(second.prefix(), QString("b"));
+        QCOMPARE(first.attributeNodeNS("urn:b", "id").prefix(), QString("b"));
+
+        QDomDocument plain;
+        QVERIFY(plain.setContent(xml, false));
+        QVERIFY(plain.documentElement().firstChildElement().prefix().isNull());
+
+        first.setPrefix("c");
+        QCOMPARE(first.prefix(), QString("c"));
+        QVERIFY(third.prefix().isEmpty());
+        QCOMPARE(first.localName(), QString("item"));
+        QCOMPARE(third.localName(), QString("item"));
+    }
+
+    // The nodes keep their names when the document is gone
+    QCOMPARE(second.tagName(), QString("item"));
+    QCOMPARE(second.namespaceURI(), QString("urn:b"));
+    QCOMPARE(third.namespaceURI(), QString("urn:a"));
+}
+
 QTEST_MAIN(tst_QDom)
 #include "tst_qdom.moc"
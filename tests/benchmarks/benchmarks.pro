@@ -7,6 +7,7 @@ SUBDIRS = \
 qtHaveModule(dbus): SUBDIRS += dbus
 qtHaveModule(network): SUBDIRS += network
 qtHaveModule(gui): SUBDIRS += gui
+qtHaveModule(xml): SUBDIRS += xml
 
 check-trusted.CONFIG += recursive
 QMAKE_EXTRA_TARGETS += check-trusted
@@ -1,11 +1,14 @@
 TEMPLATE = subdirs
 SUBDIRS = \
         io \
+        itemmodels \
         json \
         mimetypes \
         kernel \
+        statemachine \
         thread \
         tools \
+        xml \
         codecs \
         plugin
 
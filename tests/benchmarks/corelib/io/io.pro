@@ -4,8 +4,11 @@ SUBDIRS = \
         qdiriterator \
         qfile \
         qfileinfo \
+        qfilesystemwatcher \
         qiodevice \
         qprocess \
+        qresourceengine \
+        qsettings \
         qtemporaryfile \
         qtextstream
 
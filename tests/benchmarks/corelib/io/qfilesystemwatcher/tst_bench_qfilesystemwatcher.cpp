@@ -0,0 +1,163 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QFileSystemWatcher>
+#include <QtCore/QTemporaryDir>
+
+class tst_QFileSystemWatcher : public QObject
+{
+    Q_OBJECT
+
+#ifndef QT_NO_FILESYSTEMWATCHER
+private slots:
+    void initTestCase();
+
+    void addPaths_data();
+    void addPaths();
+    void addPathsRecursively();
+    void removePaths_data() { addPaths_data(); }
+    void removePaths();
+    void dispatch_data();
+    void dispatch();
+
+private:
+    QStringList createFiles(int count);
+
+    QTemporaryDir tempDir;
+    QStringList directories;
+#endif // QT_NO_FILESYSTEMWATCHER
+};
+
+#ifndef QT_NO_FILESYSTEMWATCHER
+static const int filesPerDirectory = 100;
+static const int maxFileCount = 10000;
+
+void tst_QFileSystemWatcher::initTestCase()
+{
+    QVERIFY2(tempDir.isValid(), qPrintable(tempDir.errorString()));
+
+    QDir dir(tempDir.path());
+    for (int i = 0; i < maxFileCount / filesPerDirectory; ++i) {
+        const QString name = QString::number(i);
+        QVERIFY(dir.mkdir(name));
+        directories.append(dir.filePath(name));
+        for (int j = 0; j < filesPerDirectory; ++j) {
+            QFile file(dir.filePath(name + QLatin1Char('/') + QString::number(j)));
+            QVERIFY(file.open(QIODevice::WriteOnly));
+        }
+    }
+}
+
+QStringList tst_QFileSystemWatcher::createFiles(int count)
+{
+    QStringList files;
+    files.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        files.append(directories.at(i / filesPerDirectory) + QLatin1Char('/')
+                     + QString::number(i % filesPerDirectory));
+    }
+    return files;
+}
+
+void tst_QFileSystemWatcher::addPaths_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << maxFileCount;
+}
+
+void tst_QFileSystemWatcher::addPaths()
+{
+    QFETCH(int, count);
+    const QStringList files = createFiles(count);
+
+    QBENCHMARK {
+        QFileSystemWatcher watcher;
+        QVERIFY(watcher.addPaths(files).isEmpty());
+    }
+}
+
+void tst_QFileSystemWatcher::addPathsRecursively()
+{
+    QBENCHMARK {
+        QFileSystemWatcher watcher;
+        QVERIFY(watcher.addPathRecursively(tempDir.path()));
+    }
+}
+
+void tst_QFileSystemWatcher::removePaths()
+{
+    QFETCH(int, count);
+    const QStringList files = createFiles(count);
+
+    QFileSystemWatcher watcher;
+    QBENCHMARK {
+        QVERIFY(watcher.addPaths(files).isEmpty());
+        QVERIFY(watcher.removePaths(files).isEmpty());
+    }
+}
+
+void tst_QFileSystemWatcher::dispatch_data()
+{
+    QTest::addColumn<int>("coalescingInterval");
+    QTest::newRow("immediate") << 0;
+    QTest::newRow("coalesced") << 10;
+}
+
+void tst_QFileSystemWatcher::dispatch()
+{
+    QFETCH(int, coalescingInterval);
+    const QStringList files = createFiles(1000);
+
+    QFileSystemWatcher watcher;
+    watcher.setCoalescingInterval(coalescingInterval);
+    QVERIFY(watcher.addPaths(files).isEmpty());
+
+    QSet<QString> changed;
+    connect(&watcher, &QFileSystemWatcher::fileChanged,
+            [&changed](const QString &path) { changed.insert(path); });
+
+    // touch every file a few times and wait until each of them was reported
+    QBENCHMARK {
+        changed.clear();
+        for (int round = 0; round < 3; ++round) {
+            for (const QString &path : files) {
+                QFile file(path);
+                QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+                file.write("x", 1);
+            }
+        }
+        QTRY_COMPARE(changed.size(), files.size());
+    }
+}
+#endif // QT_NO_FILESYSTEMWATCHER
+
+QTEST_MAIN(tst_QFileSystemWatcher)
+#include "tst_bench_qfilesystemwatcher.moc"
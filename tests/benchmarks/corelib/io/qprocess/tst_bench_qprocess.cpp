@@ -37,6 +37,8 @@ class tst_QProcess : public QObject
 private slots:
 
     void echoTest_performance();
+    void startLatency_data();
+    void startLatency();
 
 #endif // QT_NO_PROCESS
 };
@@ -88,6 +90,54 @@ void tst_QProcess::echoTest_performance()
     QVERIFY(process.waitForFinished());
 }
 
+#ifdef Q_OS_UNIX
+// reimplementing setupChildProcess() makes QProcess fall back to fork()
+class ForkingProcess : public QProcess
+{
+protected:
+    void setupChildProcess() Q_DECL_OVERRIDE {}
+};
+#endif
+
+void tst_QProcess::startLatency_data()
+{
+    QTest::addColumn<int>("parentMegabytes");
+    QTest::addColumn<bool>("forceFork");
+
+    const int sizes[] = { 0, 256, 1024 };
+    for (int size : sizes) {
+        const QByteArray name = QByteArray::number(size) + "MB";
+        QTest::newRow(name) << size << false;
+#ifdef Q_OS_UNIX
+        QTest::newRow(name + "-fork") << size << true;
+#endif
+    }
+}
+
+void tst_QProcess::startLatency()
+{
+    QFETCH(int, parentMegabytes);
+    QFETCH(bool, forceFork);
+
+    // make the parent large: every page is touched so it is really mapped
+    QByteArray ballast(parentMegabytes * 1024 * 1024, 'x');
+    QVERIFY(ballast.size() == parentMegabytes * 1024 * 1024);
+
+    QBENCHMARK {
+        QScopedPointer<QProcess> process(new QProcess);
+#ifdef Q_OS_UNIX
+        if (forceFork)
+            process.reset(new ForkingProcess);
+#else
+        Q_UNUSED(forceFork);
+#endif
+        process->start("testProcessLoopback/testProcessLoopback");
+        QVERIFY(process->waitForStarted());
+        process->closeWriteChannel();
+        QVERIFY(process->waitForFinished());
+    }
+}
+
 #endif // QT_NO_PROCESS && Q_OS_WINCE
 
 QTEST_MAIN(tst_QProcess)
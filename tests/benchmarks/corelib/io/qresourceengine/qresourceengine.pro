@@ -0,0 +1,5 @@
+TEMPLATE = app
+TARGET = tst_bench_qresourceengine
+QT = core testlib
+
+SOURCES += tst_bench_qresourceengine.cpp
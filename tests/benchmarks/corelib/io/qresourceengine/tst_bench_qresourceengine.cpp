@@ -0,0 +1,151 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/QLibraryInfo>
+#include <QtCore/QProcess>
+#include <QtCore/QResource>
+#include <QtCore/QTemporaryDir>
+
+static const int fileSize = 8 * 1024 * 1024;
+static const int readSize = 4096;
+
+class tst_QResourceEngine : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void openAndReadHead_data() { columns(); }
+    void openAndReadHead();
+    void randomRead_data() { columns(); }
+    void randomRead();
+    void readAll_data() { columns(); }
+    void readAll();
+
+private:
+    void columns();
+    bool runRcc(const QStringList &arguments);
+
+    QTemporaryDir dir;
+    QStringList rccFiles;
+};
+
+bool tst_QResourceEngine::runRcc(const QStringList &arguments)
+{
+    QProcess rcc;
+    rcc.setWorkingDirectory(dir.path());
+    rcc.start(QLibraryInfo::location(QLibraryInfo::BinariesPath) + QLatin1String("/rcc"), arguments);
+    return rcc.waitForFinished(60000) && rcc.exitStatus() == QProcess::NormalExit && rcc.exitCode() == 0;
+}
+
+void tst_QResourceEngine::initTestCase()
+{
+    QVERIFY(dir.isValid());
+
+    // text that compresses well, but not trivially
+    QFile data(dir.path() + QLatin1String("/data.txt"));
+    QVERIFY(data.open(QIODevice::WriteOnly));
+    QByteArray line;
+    for (int i = 0; data.size() < fileSize; ++i) {
+        line = QByteArray::number(i) + ": " + QByteArray::number(quint64(i) * 2654435761u, 36) + " lorem ipsum dolor sit amet\n";
+        data.write(line);
+    }
+    data.close();
+
+    QFile qrc(dir.path() + QLatin1String("/data.qrc"));
+    QVERIFY(qrc.open(QIODevice::WriteOnly));
+    qrc.write("<RCC><qresource prefix=\"/\"><file>data.txt</file></qresource></RCC>\n");
+    qrc.close();
+
+    QVERIFY(runRcc(QStringList() << "-binary" << "-root" << "/zlib/" << "data.qrc" << "-o" << "zlib.rcc"));
+    QVERIFY(runRcc(QStringList() << "-binary" << "-root" << "/chunked/" << "-chunk-size" << "65536"
+                                 << "data.qrc" << "-o" << "chunked.rcc"));
+    rccFiles << dir.path() + QLatin1String("/zlib.rcc") << dir.path() + QLatin1String("/chunked.rcc");
+    for (const QString &rccFile : qAsConst(rccFiles))
+        QVERIFY(QResource::registerResource(rccFile));
+    QVERIFY(QResource(":/zlib/data.txt").isCompressed());
+    QVERIFY(QResource(":/chunked/data.txt").isCompressed());
+}
+
+void tst_QResourceEngine::cleanupTestCase()
+{
+    for (const QString &rccFile : qAsConst(rccFiles))
+        QResource::unregisterResource(rccFile);
+}
+
+void tst_QResourceEngine::columns()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::newRow("zlib") << QString(":/zlib/data.txt");
+    QTest::newRow("chunked") << QString(":/chunked/data.txt");
+}
+
+void tst_QResourceEngine::openAndReadHead()
+{
+    QFETCH(QString, fileName);
+    char buffer[readSize];
+    QBENCHMARK {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.read(buffer, readSize), qint64(readSize));
+    }
+}
+
+void tst_QResourceEngine::randomRead()
+{
+    QFETCH(QString, fileName);
+    char buffer[readSize];
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    quint32 seed = 1;
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i) {
+            seed = seed * 1103515245 + 12345;
+            QVERIFY(file.seek(seed % (fileSize - readSize)));
+            QCOMPARE(file.read(buffer, readSize), qint64(readSize));
+        }
+    }
+}
+
+void tst_QResourceEngine::readAll()
+{
+    QFETCH(QString, fileName);
+    QBENCHMARK {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QVERIFY(file.readAll().size() >= fileSize);
+    }
+}
+
+QTEST_MAIN(tst_QResourceEngine)
+
+#include "tst_bench_qresourceengine.moc"
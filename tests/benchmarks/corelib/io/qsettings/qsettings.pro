@@ -0,0 +1,5 @@
+TEMPLATE = app
+TARGET = tst_bench_qsettings
+QT = core testlib
+
+SOURCES += tst_bench_qsettings.cpp
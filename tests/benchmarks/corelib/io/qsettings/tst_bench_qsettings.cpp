@@ -0,0 +1,143 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QSettings>
+#include <QtCore/QTemporaryDir>
+
+class tst_QSettings : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void coldStart_data();
+    void coldStart();
+    void lookup_data() { coldStart_data(); }
+    void lookup();
+    void sync_data() { coldStart_data(); }
+    void sync();
+
+private:
+    QString fileName(QSettings::Format format, int keyCount) const;
+
+    QTemporaryDir tempDir;
+};
+
+Q_DECLARE_METATYPE(QSettings::Format)
+
+static const int keyCounts[] = { 1000, 100000 };
+
+static QString keyName(int i)
+{
+    return QString::fromLatin1("group%1/subgroup%2/key%3").arg(i % 100).arg(i % 7).arg(i);
+}
+
+QString tst_QSettings::fileName(QSettings::Format format, int keyCount) const
+{
+    return tempDir.path() + QLatin1Char('/') + QString::number(keyCount)
+            + (format == QSettings::IniFormat ? QLatin1String(".ini") : QLatin1String(".qsi"));
+}
+
+void tst_QSettings::initTestCase()
+{
+    QVERIFY2(tempDir.isValid(), qPrintable(tempDir.errorString()));
+
+    for (int keyCount : keyCounts) {
+        for (QSettings::Format format : { QSettings::IniFormat, QSettings::IndexedFormat }) {
+            QSettings settings(fileName(format, keyCount), format);
+            for (int i = 0; i < keyCount; ++i)
+                settings.setValue(keyName(i), QString::fromLatin1("value %1").arg(i));
+            settings.sync();
+            QCOMPARE(settings.status(), QSettings::NoError);
+        }
+    }
+}
+
+void tst_QSettings::coldStart_data()
+{
+    QTest::addColumn<QSettings::Format>("format");
+    QTest::addColumn<int>("keyCount");
+
+    for (int keyCount : keyCounts) {
+        QTest::newRow(qPrintable(QString::fromLatin1("ini-%1").arg(keyCount)))
+                << QSettings::IniFormat << keyCount;
+        QTest::newRow(qPrintable(QString::fromLatin1("indexed-%1").arg(keyCount)))
+                << QSettings::IndexedFormat << keyCount;
+    }
+}
+
+// open the file and read a single value
+void tst_QSettings::coldStart()
+{
+    QFETCH(QSettings::Format, format);
+    QFETCH(int, keyCount);
+
+    const QString name = fileName(format, keyCount);
+    const QString key = keyName(keyCount / 2);
+    QBENCHMARK {
+        QSettings settings(name, format);
+        QVERIFY(settings.contains(key));
+    }
+}
+
+void tst_QSettings::lookup()
+{
+    QFETCH(QSettings::Format, format);
+    QFETCH(int, keyCount);
+
+    QSettings settings(fileName(format, keyCount), format);
+    QStringList keys;
+    for (int i = 0; i < 1000; ++i)
+        keys.append(keyName((i * 7919) % keyCount));
+
+    QBENCHMARK {
+        for (const QString &key : qAsConst(keys))
+            settings.value(key);
+    }
+}
+
+// change a single value and write it to disk
+void tst_QSettings::sync()
+{
+    QFETCH(QSettings::Format, format);
+    QFETCH(int, keyCount);
+
+    QSettings settings(fileName(format, keyCount), format);
+    int i = 0;
+    QBENCHMARK {
+        settings.setValue(keyName(0), ++i);
+        settings.sync();
+    }
+    QCOMPARE(settings.status(), QSettings::NoError);
+}
+
+QTEST_MAIN(tst_QSettings)
+
+#include "tst_bench_qsettings.moc"
@@ -27,6 +27,8 @@
 ****************************************************************************/
 
 #include <qurl.h>
+#include <qurlquery.h>
+#include <qurlview.h>
 #include <qtest.h>
 
 class tst_qurl: public QObject
@@ -48,6 +50,14 @@ private slots:
     void equality_data();
     void equality();
     void qmlPropertyWriteUseCase();
+    void parseUtf8_data();
+    void parseUtf8();
+    void parseUtf8View_data() { parseUtf8_data(); }
+    void parseUtf8View();
+    void queryItemValue_data() { parseUtf8_data(); }
+    void queryItemValue();
+    void queryItemValueView_data() { parseUtf8_data(); }
+    void queryItemValueView();
 
 private:
     void generateFirstRunData();
@@ -203,6 +213,56 @@ void tst_qurl::qmlPropertyWriteUseCase()
     }
 }
 
+void tst_qurl::parseUtf8_data()
+{
+    // request targets and URLs as an HTTP server receives them
+    QTest::addColumn<QByteArray>("url");
+
+    QTest::newRow("path") << QByteArray("/index.html");
+    QTest::newRow("path-query") << QByteArray("/search?q=qt%20url&page=2&lang=en");
+    QTest::newRow("absolute") << QByteArray("http://user@www.example.com:8080/api/v1/items/42?fields=name,price&page=2#top");
+    QTest::newRow("long-query") << QByteArray("/api/items?sort=desc&limit=50&offset=100&filter=category%3Dbooks"
+                                              "&token=0123456789abcdef0123456789abcdef&session=abcdef&page=2");
+}
+
+void tst_qurl::parseUtf8()
+{
+    QFETCH(QByteArray, url);
+    QBENCHMARK {
+        QUrl parsed(QString::fromUtf8(url));
+        parsed.path();
+        parsed.query();
+    }
+}
+
+void tst_qurl::parseUtf8View()
+{
+    QFETCH(QByteArray, url);
+    QBENCHMARK {
+        QUrlView view(url);
+        view.path();
+        view.query();
+    }
+}
+
+void tst_qurl::queryItemValue()
+{
+    QFETCH(QByteArray, url);
+    QBENCHMARK {
+        QUrlQuery query(QUrl(QString::fromUtf8(url)));
+        query.queryItemValue(QStringLiteral("page"));
+    }
+}
+
+void tst_qurl::queryItemValueView()
+{
+    QFETCH(QByteArray, url);
+    QBENCHMARK {
+        QUrlView view(url);
+        QUrlView::decoded(view.queryItemValue(QLatin1String("page")));
+    }
+}
+
 QTEST_MAIN(tst_qurl)
 
 #include "main.moc"
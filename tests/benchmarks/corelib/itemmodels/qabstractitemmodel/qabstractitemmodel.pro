@@ -0,0 +1,4 @@
+TARGET = tst_bench_qabstractitemmodel
+QT = core testlib
+SOURCES += tst_bench_qabstractitemmodel.cpp
+CONFIG += release
@@ -0,0 +1,164 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/qabstractitemmodel.h>
+
+// A model with top-level rows, the first of which has children
+class TreeModel : public QAbstractItemModel
+{
+public:
+    TreeModel(int rows, int children)
+        : rows(rows), children(children)
+    {}
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE
+    {
+        if (row < 0 || row >= rowCount(parent) || column != 0)
+            return QModelIndex();
+        return createIndex(row, column, quintptr(parent.isValid() ? 1 : 0));
+    }
+
+    QModelIndex parent(const QModelIndex &child) const Q_DECL_OVERRIDE
+    {
+        return child.internalId() == 1 ? createIndex(0, 0, quintptr(0)) : QModelIndex();
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE
+    {
+        if (!parent.isValid())
+            return rows;
+        return (parent.internalId() == 0 && parent.row() == 0) ? children : 0;
+    }
+
+    int columnCount(const QModelIndex & = QModelIndex()) const Q_DECL_OVERRIDE
+    {
+        return 1;
+    }
+
+    QVariant data(const QModelIndex &, int) const Q_DECL_OVERRIDE
+    {
+        return QVariant();
+    }
+
+    bool insertRows(int row, int count, const QModelIndex &parent = QModelIndex()) Q_DECL_OVERRIDE
+    {
+        beginInsertRows(parent, row, row + count - 1);
+        (parent.isValid() ? children : rows) += count;
+        endInsertRows();
+        return true;
+    }
+
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) Q_DECL_OVERRIDE
+    {
+        beginRemoveRows(parent, row, row + count - 1);
+        (parent.isValid() ? children : rows) -= count;
+        endRemoveRows();
+        return true;
+    }
+
+private:
+    int rows;
+    int children;
+};
+
+class tst_QAbstractItemModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void createPersistentIndexes_data();
+    void createPersistentIndexes();
+    void insertRemoveRows_data();
+    void insertRemoveRows();
+};
+
+void tst_QAbstractItemModel::createPersistentIndexes_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("100000") << 100000;
+}
+
+void tst_QAbstractItemModel::createPersistentIndexes()
+{
+    QFETCH(int, count);
+
+    TreeModel model(count, 0);
+    QBENCHMARK {
+        QVector<QPersistentModelIndex> persistent;
+        persistent.reserve(count);
+        for (int row = 0; row < count; ++row)
+            persistent.append(model.index(row, 0));
+    }
+}
+
+void tst_QAbstractItemModel::insertRemoveRows_data()
+{
+    QTest::addColumn<int>("topLevel");
+    QTest::addColumn<int>("children");
+    QTest::addColumn<int>("position");
+
+    const int count = 100000;
+    for (int persistent : { 1000, count }) {
+        const QByteArray name = QByteArray::number(persistent) + " top-level persistent indexes, ";
+        QTest::newRow(QByteArray(name + "at the start").constData()) << persistent << 0 << 0;
+        QTest::newRow(QByteArray(name + "in the middle").constData()) << persistent << 0 << count / 2;
+        QTest::newRow(QByteArray(name + "at the end").constData()) << persistent << 0 << count;
+    }
+    // changes of the top level do not move children
+    QTest::newRow("100000 child persistent indexes, in the middle") << 0 << count << count / 2;
+}
+
+void tst_QAbstractItemModel::insertRemoveRows()
+{
+    QFETCH(int, topLevel);
+    QFETCH(int, children);
+    QFETCH(int, position);
+
+    TreeModel model(100000, children);
+    QVector<QPersistentModelIndex> persistent;
+    persistent.reserve(topLevel + children);
+    // spread the persistent indexes over the model, like the ranges of a large selection
+    for (int i = 0; i < topLevel; ++i)
+        persistent.append(model.index(int(qint64(i) * model.rowCount() / topLevel), 0));
+    const QModelIndex parent = model.index(0, 0);
+    for (int row = 0; row < children; ++row)
+        persistent.append(model.index(row, 0, parent));
+
+    QBENCHMARK {
+        model.insertRows(position, 1);
+        model.removeRows(position, 1);
+    }
+}
+
+QTEST_MAIN(tst_QAbstractItemModel)
+
+#include "tst_bench_qabstractitemmodel.moc"
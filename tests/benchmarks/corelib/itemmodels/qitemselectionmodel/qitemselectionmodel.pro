@@ -0,0 +1,4 @@
+TARGET = tst_bench_qitemselectionmodel
+QT = core testlib
+SOURCES += tst_bench_qitemselectionmodel.cpp
+CONFIG += release
@@ -0,0 +1,195 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/qabstractitemmodel.h>
+#include <QtCore/qitemselectionmodel.h>
+
+class TableModel : public QAbstractTableModel
+{
+public:
+    TableModel(int rows, int columns)
+        : rows(rows), columns(columns)
+    {}
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE
+    {
+        return parent.isValid() ? 0 : rows;
+    }
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE
+    {
+        return parent.isValid() ? 0 : columns;
+    }
+
+    QVariant data(const QModelIndex &, int) const Q_DECL_OVERRIDE
+    {
+        return QVariant();
+    }
+
+private:
+    int rows;
+    int columns;
+};
+
+class tst_QItemSelectionModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void toggleAfterSelectAll_data();
+    void toggleAfterSelectAll();
+    void isSelected_data();
+    void isSelected();
+    void selectedRows_data();
+    void selectedRows();
+    void mergeDisjointRows_data();
+    void mergeDisjointRows();
+
+private:
+    static void selectAllAndToggle(QItemSelectionModel *selectionModel, int toggles);
+};
+
+// Selects everything, then toggles single items spread over the table, like
+// Ctrl+A followed by Ctrl+clicks.
+void tst_QItemSelectionModel::selectAllAndToggle(QItemSelectionModel *selectionModel, int toggles)
+{
+    const QAbstractItemModel *model = selectionModel->model();
+    const int rows = model->rowCount();
+    selectionModel->select(QItemSelection(model->index(0, 0),
+                                          model->index(rows - 1, model->columnCount() - 1)),
+                           QItemSelectionModel::Select);
+    for (int i = 0; i < toggles; ++i)
+        selectionModel->select(model->index(qint64(rows) * i / toggles, i % model->columnCount()),
+                               QItemSelectionModel::Toggle);
+}
+
+void tst_QItemSelectionModel::toggleAfterSelectAll_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("toggles");
+
+    QTest::newRow("1000000 rows, 100 toggles") << 1000000 << 100;
+    QTest::newRow("1000000 rows, 1000 toggles") << 1000000 << 1000;
+}
+
+void tst_QItemSelectionModel::toggleAfterSelectAll()
+{
+    QFETCH(int, rows);
+    QFETCH(int, toggles);
+
+    TableModel model(rows, 4);
+    QBENCHMARK {
+        QItemSelectionModel selectionModel(&model);
+        selectAllAndToggle(&selectionModel, toggles);
+    }
+}
+
+void tst_QItemSelectionModel::isSelected_data()
+{
+    toggleAfterSelectAll_data();
+}
+
+void tst_QItemSelectionModel::isSelected()
+{
+    QFETCH(int, rows);
+    QFETCH(int, toggles);
+
+    TableModel model(rows, 4);
+    QItemSelectionModel selectionModel(&model);
+    selectAllAndToggle(&selectionModel, toggles);
+
+    // a screenful of items
+    int selected = 0;
+    QBENCHMARK {
+        for (int row = 5000; row < 5050; ++row) {
+            for (int column = 0; column < 4; ++column)
+                selected += selectionModel.isSelected(model.index(row, column));
+        }
+    }
+    QVERIFY(selected > 0);
+}
+
+void tst_QItemSelectionModel::selectedRows_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("toggles");
+
+    QTest::newRow("100000 rows, 0 toggles") << 100000 << 0;
+    QTest::newRow("100000 rows, 100 toggles") << 100000 << 100;
+}
+
+void tst_QItemSelectionModel::selectedRows()
+{
+    QFETCH(int, rows);
+    QFETCH(int, toggles);
+
+    TableModel model(rows, 4);
+    QItemSelectionModel selectionModel(&model);
+    selectAllAndToggle(&selectionModel, toggles);
+
+    QModelIndexList result;
+    QBENCHMARK {
+        result = selectionModel.selectedRows();
+    }
+    QCOMPARE(result.size(), rows - toggles);
+}
+
+void tst_QItemSelectionModel::mergeDisjointRows_data()
+{
+    QTest::addColumn<int>("rows");
+
+    QTest::newRow("2000 rows") << 2000;
+    QTest::newRow("10000 rows") << 10000;
+}
+
+// Toggles every other row into a selection of every third row
+void tst_QItemSelectionModel::mergeDisjointRows()
+{
+    QFETCH(int, rows);
+
+    TableModel model(rows, 4);
+    QItemSelection everyThird;
+    QItemSelection everyOther;
+    for (int row = 0; row < rows; ++row) {
+        if (row % 3 == 0)
+            everyThird.select(model.index(row, 0), model.index(row, 3));
+        if (row % 2 == 0)
+            everyOther.select(model.index(row, 0), model.index(row, 3));
+    }
+
+    QBENCHMARK {
+        QItemSelection selection = everyThird;
+        selection.merge(everyOther, QItemSelectionModel::Toggle);
+    }
+}
+
+QTEST_MAIN(tst_QItemSelectionModel)
+
+#include "tst_bench_qitemselectionmodel.moc"
@@ -0,0 +1,4 @@
+TARGET = tst_bench_qsortfilterproxymodel
+QT = core testlib
+SOURCES += tst_bench_qsortfilterproxymodel.cpp
+CONFIG += release
@@ -0,0 +1,233 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/qabstractitemmodel.h>
+#include <QtCore/qsortfilterproxymodel.h>
+#include <QtCore/qthreadpool.h>
+
+// A log model, whose data() may be called from several threads while no
+// lines are appended
+class LogModel : public QAbstractListModel
+{
+public:
+    explicit LogModel(int count)
+        : seed(0x9e3779b9)
+    {
+        lines.reserve(count);
+        for (int i = 0; i < count; ++i)
+            lines.append(nextLine());
+    }
+
+    void append(int count)
+    {
+        beginInsertRows(QModelIndex(), lines.size(), lines.size() + count - 1);
+        for (int i = 0; i < count; ++i)
+            lines.append(nextLine());
+        endInsertRows();
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE
+    {
+        return parent.isValid() ? 0 : lines.size();
+    }
+
+    QVariant data(const QModelIndex &index, int role) const Q_DECL_OVERRIDE
+    {
+        if (role != Qt::DisplayRole)
+            return QVariant();
+        return lines.at(index.row());
+    }
+
+private:
+    QString nextLine()
+    {
+        static const char * const modules[] = { "network", "render", "input", "storage", "audio" };
+        seed = seed * 1664525 + 1013904223;
+        return QString::fromLatin1("[%1] request %2 took %3 ms (#%4)")
+                .arg(QLatin1String(modules[(seed >> 16) % 5]))
+                .arg(seed % 100000)
+                .arg((seed >> 8) % 1000)
+                .arg(lines.size());
+    }
+
+    QVector<QString> lines;
+    quint32 seed;
+};
+
+class tst_QSortFilterProxyModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void filter_data();
+    void filter();
+    void sort_data();
+    void sort();
+    void typeAhead_data();
+    void typeAhead();
+    void streamingInserts_data();
+    void streamingInserts();
+
+private:
+    LogModel *logModel(int count);
+
+    QMap<int, QSharedPointer<LogModel> > models;
+};
+
+LogModel *tst_QSortFilterProxyModel::logModel(int count)
+{
+    QSharedPointer<LogModel> &model = models[count];
+    if (!model)
+        model.reset(new LogModel(count));
+    return model.data();
+}
+
+static void addRow(int count, bool parallel)
+{
+    QByteArray name = QByteArray::number(count) + " rows, ";
+    if (parallel)
+        name += "parallel, " + QByteArray::number(QThreadPool::globalInstance()->maxThreadCount()) + " threads";
+    else
+        name += "sequential";
+    QTest::newRow(name.constData()) << count << parallel;
+}
+
+void tst_QSortFilterProxyModel::filter_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("parallel");
+
+    // the sequential mode removes and inserts each range of rows separately,
+    // which takes too long with a million rows
+    addRow(10000, false);
+    addRow(10000, true);
+    addRow(1000000, true);
+}
+
+// the keystrokes of a user typing a filter, then deleting it again
+static const char * const filterSteps[] = { "n", "ne", "net", "netw", "net", "ne", "n", "" };
+
+void tst_QSortFilterProxyModel::filter()
+{
+    QFETCH(int, count);
+    QFETCH(bool, parallel);
+
+    QSortFilterProxyModel proxy;
+    proxy.setParallelSortFilter(parallel);
+    proxy.setSourceModel(logModel(count));
+    QCOMPARE(proxy.rowCount(), count);
+
+    QBENCHMARK {
+        for (const char *step : filterSteps)
+            proxy.setFilterFixedString(QLatin1String(step));
+    }
+    QCOMPARE(proxy.rowCount(), count);
+}
+
+void tst_QSortFilterProxyModel::sort_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("parallel");
+
+    addRow(1000000, false);
+    addRow(1000000, true);
+}
+
+void tst_QSortFilterProxyModel::sort()
+{
+    QFETCH(int, count);
+    QFETCH(bool, parallel);
+
+    QSortFilterProxyModel proxy;
+    proxy.setParallelSortFilter(parallel);
+    proxy.setSourceModel(logModel(count));
+
+    QBENCHMARK {
+        proxy.sort(0, Qt::DescendingOrder);
+        proxy.sort(0, Qt::AscendingOrder);
+    }
+    QCOMPARE(proxy.rowCount(), count);
+}
+
+void tst_QSortFilterProxyModel::typeAhead_data()
+{
+    filter_data();
+}
+
+void tst_QSortFilterProxyModel::typeAhead()
+{
+    QFETCH(int, count);
+    QFETCH(bool, parallel);
+
+    LogModel *model = logModel(count);
+    QBENCHMARK {
+        QSortFilterProxyModel proxy;
+        proxy.setParallelSortFilter(parallel);
+        proxy.setSourceModel(model);
+        QCOMPARE(proxy.rowCount(), count);
+        // each letter narrows the filter
+        for (const char *step : { "s", "st", "sto", "stor", "stora", "storag", "storage" })
+            proxy.setFilterFixedString(QLatin1String(step));
+    }
+}
+
+void tst_QSortFilterProxyModel::streamingInserts_data()
+{
+    QTest::addColumn<bool>("sorted");
+    QTest::addColumn<int>("batchSize");
+
+    QTest::newRow("unsorted, 1 row at a time") << false << 1;
+    QTest::newRow("sorted, 1 row at a time") << true << 1;
+    QTest::newRow("sorted, 100 rows at a time") << true << 100;
+}
+
+void tst_QSortFilterProxyModel::streamingInserts()
+{
+    QFETCH(bool, sorted);
+    QFETCH(int, batchSize);
+
+    LogModel model(100000);
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.setFilterFixedString(QStringLiteral("network"));
+    if (sorted)
+        proxy.sort(0);
+    const int rowCount = proxy.rowCount();
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; i += batchSize)
+            model.append(batchSize);
+    }
+    QVERIFY(proxy.rowCount() > rowCount);
+}
+
+QTEST_MAIN(tst_QSortFilterProxyModel)
+
+#include "tst_bench_qsortfilterproxymodel.moc"
@@ -27,6 +27,7 @@
 ****************************************************************************/
 
 #include <QtTest/QtTest>
+#include <QMimeDatabase>
 
 class tst_QMimeDatabase: public QObject
 {
@@ -34,9 +35,33 @@ class tst_QMimeDatabase: public QObject
     Q_OBJECT
 
 private slots:
+    void initTestCase();
     void inheritsPerformance();
+    void firstUse_data();
+    void firstUse();
+    void mimeTypeForName();
+    void mimeTypeForFileName();
+    void mimeTypeForData();
+    void mimeTypeForFile();
+
+private:
+    QTemporaryDir m_temporaryDir;
 };
 
+static void useMimeDatabase()
+{
+    QMimeDatabase db;
+    db.mimeTypeForFile(QStringLiteral("file.txt"), QMimeDatabase::MatchExtension).comment();
+}
+
+void tst_QMimeDatabase::initTestCase()
+{
+    // No system mime.cache or packages: use the cache embedded in QtCore
+    QVERIFY(m_temporaryDir.isValid());
+    QStandardPaths::setTestModeEnabled(true);
+    qputenv("XDG_DATA_DIRS", QFile::encodeName(m_temporaryDir.path()));
+}
+
 void tst_QMimeDatabase::inheritsPerformance()
 {
     // Check performance of inherits().
@@ -70,5 +95,90 @@ void tst_QMimeDatabase::inheritsPerformance()
     // parsing XML, and then keeps being around 4.5 MB for all the in-memory hashes.
 }
 
-QTEST_MAIN(tst_QMimeDatabase)
+void tst_QMimeDatabase::firstUse_data()
+{
+    QTest::addColumn<bool>("xml");
+    QTest::newRow("embedded cache") << false;
+    QTest::newRow("xml") << true;
+}
+
+void tst_QMimeDatabase::firstUse()
+{
+    // The provider is set up once per process, so measure a whole process
+    // whose only work is a lookup.
+    QFETCH(bool, xml);
+#ifdef QT_NO_PROCESS
+    QSKIP("No qprocess support", SkipAll);
+#else
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    if (xml)
+        environment.insert(QStringLiteral("QT_NO_MIME_CACHE"), QStringLiteral("1"));
+    QBENCHMARK {
+        QProcess process;
+        process.setProcessEnvironment(environment);
+        process.start(QCoreApplication::applicationFilePath(), QStringList(QStringLiteral("--use-mime-database")));
+        QVERIFY(process.waitForFinished());
+        QCOMPARE(process.exitCode(), 0);
+    }
+#endif
+}
+
+void tst_QMimeDatabase::mimeTypeForName()
+{
+    QMimeDatabase db;
+    QBENCHMARK {
+        QVERIFY(db.mimeTypeForName(QStringLiteral("text/x-chdr")).isValid());
+        QVERIFY(db.mimeTypeForName(QStringLiteral("application/x-gzip")).isValid());
+        QVERIFY(!db.mimeTypeForName(QStringLiteral("application/x-does-not-exist")).isValid());
+    }
+}
+
+void tst_QMimeDatabase::mimeTypeForFileName()
+{
+    const QStringList fileNames = QStringList()
+            << QStringLiteral("main.cpp") << QStringLiteral("image.PNG") << QStringLiteral("archive.tar.gz")
+            << QStringLiteral("Makefile") << QStringLiteral("README") << QStringLiteral("unknown.extension");
+    QMimeDatabase db;
+    QBENCHMARK {
+        for (const QString &fileName : fileNames)
+            db.mimeTypeForFile(fileName, QMimeDatabase::MatchExtension);
+    }
+}
+
+void tst_QMimeDatabase::mimeTypeForData()
+{
+    const QByteArray png("\x89PNG\r\n\x1a\n\0\0\0\rIHDR", 16);
+    const QByteArray text(4096, 'x');
+    QMimeDatabase db;
+    QBENCHMARK {
+        QCOMPARE(db.mimeTypeForData(png).name(), QStringLiteral("image/png"));
+        QCOMPARE(db.mimeTypeForData(text).name(), QStringLiteral("text/plain"));
+    }
+}
+
+void tst_QMimeDatabase::mimeTypeForFile()
+{
+    // Without a known extension the start of the file is read
+    const QString fileName = m_temporaryDir.path() + QLatin1String("/data");
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QByteArray(1024 * 1024, 'x'));
+    file.close();
+    QMimeDatabase db;
+    QBENCHMARK {
+        QCOMPARE(db.mimeTypeForFile(fileName).name(), QStringLiteral("text/plain"));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    if (argc > 1 && !qstrcmp(argv[1], "--use-mime-database")) {
+        useMimeDatabase();
+        return 0;
+    }
+    tst_QMimeDatabase tc;
+    return QTest::qExec(&tc, argc, argv);
+}
+
 #include "main.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+TARGET = ../tst_bench_qfactoryloader
+QT = core-private testlib
+
+SOURCES += ../tst_bench_qfactoryloader.cpp
+HEADERS += ../plugin/plugininterface.h
+DEFINES += PLUGIN_DIR=\\\"$$OUT_PWD/../bin\\\"
@@ -0,0 +1,121 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/QTemporaryDir>
+#include <private/qfactoryloader_p.h>
+#include <private/qpluginmetadatacache_p.h>
+
+#include "../plugin/plugininterface.h"
+
+// Applications that look for plugins scan every library in the plugin
+// directories for metadata when they start; this measures that scan.
+static const int pluginCount = 200;
+
+class tst_QFactoryLoader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void startup_data();
+    void startup();
+
+private:
+    QTemporaryDir dir;
+    QStringList libraryPaths;
+};
+
+void tst_QFactoryLoader::initTestCase()
+{
+#ifdef QT_NO_LIBRARY
+    QSKIP("This benchmark requires plugins to be loaded dynamically");
+#endif
+    QVERIFY(dir.isValid());
+    const QDir pluginDir(QStringLiteral(PLUGIN_DIR));
+    const QStringList plugins = pluginDir.entryList(QStringList(QStringLiteral("*benchplugin*")), QDir::Files);
+    QVERIFY(!plugins.isEmpty());
+    const QFileInfo plugin(pluginDir.filePath(plugins.first()));
+
+    QVERIFY(QDir(dir.path()).mkdir(QStringLiteral("benchplugins")));
+    for (int i = 0; i < pluginCount; ++i) {
+        const QString copy = QStringLiteral("%1/benchplugins/%2%3.%4")
+                .arg(dir.path(), plugin.completeBaseName()).arg(i).arg(plugin.suffix());
+        QVERIFY(QFile::copy(plugin.filePath(), copy));
+    }
+
+    libraryPaths = QCoreApplication::libraryPaths();
+    QCoreApplication::setLibraryPaths(QStringList(dir.path()));
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void tst_QFactoryLoader::cleanupTestCase()
+{
+    if (QPluginMetaDataCache *cache = QPluginMetaDataCache::instance())
+        QFile::remove(cache->cacheFileName());
+    QPluginMetaDataCache::reset();
+    QStandardPaths::setTestModeEnabled(false);
+    QCoreApplication::setLibraryPaths(libraryPaths);
+}
+
+void tst_QFactoryLoader::startup_data()
+{
+    QTest::addColumn<bool>("cached");
+    QTest::newRow("scan") << false;
+    QTest::newRow("cache") << true;
+}
+
+void tst_QFactoryLoader::startup()
+{
+    QFETCH(bool, cached);
+    if (cached)
+        qunsetenv("QT_NO_PLUGIN_CACHE");
+    else
+        qputenv("QT_NO_PLUGIN_CACHE", "1");
+    QPluginMetaDataCache::reset();
+    if (cached) {
+        // fill the cache file
+        QFactoryLoader loader(BenchPluginInterface_iid, QStringLiteral("/benchplugins"));
+        QCOMPARE(loader.metaData().size(), pluginCount);
+    }
+
+    QBENCHMARK {
+        // start from the cache file, as a new process would
+        QPluginMetaDataCache::reset();
+        QFactoryLoader loader(BenchPluginInterface_iid, QStringLiteral("/benchplugins"));
+        QCOMPARE(loader.metaData().size(), pluginCount);
+    }
+    qunsetenv("QT_NO_PLUGIN_CACHE");
+}
+
+QTEST_MAIN(tst_QFactoryLoader)
+
+#include "tst_bench_qfactoryloader.moc"
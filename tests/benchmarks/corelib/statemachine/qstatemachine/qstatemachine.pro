@@ -0,0 +1,4 @@
+TARGET = tst_bench_qstatemachine
+QT = core testlib
+SOURCES += tst_bench_qstatemachine.cpp
+CONFIG += release
@@ -0,0 +1,136 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/qabstracttransition.h>
+#include <QtCore/qstate.h>
+#include <QtCore/qstatemachine.h>
+
+class ValueEvent : public QEvent
+{
+public:
+    enum { Type = QEvent::User + 1 };
+    explicit ValueEvent(int value) : QEvent(QEvent::Type(Type)), value(value) {}
+    int value;
+};
+
+class ValueTransition : public QAbstractTransition
+{
+public:
+    ValueTransition(int value, QState *source, QAbstractState *target)
+        : QAbstractTransition(source), value(value)
+    { setTargetState(target); }
+
+protected:
+    bool eventTest(QEvent *e) Q_DECL_OVERRIDE
+    { return e->type() == ValueEvent::Type && static_cast<ValueEvent *>(e)->value == value; }
+    void onTransition(QEvent *) Q_DECL_OVERRIDE {}
+
+private:
+    int value;
+};
+
+class tst_QStateMachine : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void events_data();
+    void events();
+};
+
+// Adds a ring of states to parent: state i moves on to state i + 1 on event value i.
+// Each state of the ring has depth levels of nested child states.
+static void addRing(QState *parent, int size, int depth)
+{
+    QVector<QState *> ring;
+    for (int i = 0; i < size; ++i) {
+        QState *state = new QState(parent);
+        QState *inner = state;
+        for (int level = 0; level < depth; ++level) {
+            QState *child = new QState(inner);
+            new QState(inner); // a sibling that is never entered
+            inner->setInitialState(child);
+            inner = child;
+        }
+        ring.append(state);
+    }
+    for (int i = 0; i < size; ++i)
+        new ValueTransition(i, ring.at(i), ring.at((i + 1) % size));
+    parent->setInitialState(ring.first());
+}
+
+void tst_QStateMachine::events_data()
+{
+    QTest::addColumn<int>("regions");
+    QTest::addColumn<int>("depth");
+    QTest::addColumn<bool>("matching");
+
+    QTest::newRow("flat") << 1 << 0 << true;
+    QTest::newRow("nested") << 1 << 4 << true;
+    QTest::newRow("parallel") << 4 << 2 << true;
+    QTest::newRow("nested, ignored events") << 1 << 4 << false;
+    QTest::newRow("parallel, ignored events") << 4 << 2 << false;
+}
+
+// Posts 10000 events to a running machine and processes them
+void tst_QStateMachine::events()
+{
+    QFETCH(int, regions);
+    QFETCH(int, depth);
+    QFETCH(bool, matching);
+
+    const int ringSize = 8;
+    QStateMachine machine;
+    QState *top = new QState(regions > 1 ? QState::ParallelStates : QState::ExclusiveStates, &machine);
+    if (regions > 1) {
+        for (int i = 0; i < regions; ++i)
+            addRing(new QState(top), ringSize, depth);
+    } else {
+        addRing(top, ringSize, depth);
+    }
+    machine.setInitialState(top);
+    machine.start();
+    QCoreApplication::processEvents();
+    QVERIFY(machine.isRunning());
+
+    int value = 0;
+    QBENCHMARK {
+        for (int i = 0; i < 10000; ++i) {
+            machine.postEvent(new ValueEvent(matching ? value : -1));
+            value = (value + 1) % ringSize;
+        }
+        QCoreApplication::processEvents();
+    }
+    QCOMPARE(machine.configuration().size(), 1 + regions * (depth + 1) + (regions > 1 ? regions : 0));
+}
+
+QTEST_MAIN(tst_QStateMachine)
+
+#include "tst_bench_qstatemachine.moc"
@@ -30,6 +30,7 @@
 #include <QIODevice>
 #include <QFile>
 #include <QString>
+#include <QByteArrayMatcher>
 
 #include <qtest.h>
 
@@ -48,6 +49,12 @@ private slots:
     void latin1Uppercasing_xlate_checked();
     void latin1Uppercasing_category();
     void latin1Uppercasing_bitcheck();
+
+    void indexOf_data();
+    void indexOf();
+    void indexIn_data() { indexOf_data(); }
+    void indexIn();
+    void countChar();
 };
 
 void tst_qbytearray::initTestCase()
@@ -259,6 +266,57 @@ void tst_qbytearray::latin1Uppercasing_bitcheck()
 }
 
 
+// searches for the last needleLength bytes of a few copies of this file, plus a tail
+void tst_qbytearray::indexOf_data()
+{
+    QTest::addColumn<QByteArray>("haystack");
+    QTest::addColumn<QByteArray>("needle");
+
+    QByteArray haystack;
+    for (int i = 0; i < 10; ++i)
+        haystack += sourcecode;
+    // this file is ASCII, so the needle can only be found at the end
+    for (int i = 0; i < 128; ++i)
+        haystack += char(0x80 + i * 7 % 128);
+
+    for (int length : { 2, 4, 8, 16, 32, 64, 128 })
+        QTest::newRow(QByteArray::number(length).constData()) << haystack << haystack.right(length);
+}
+
+void tst_qbytearray::indexOf()
+{
+    QFETCH(QByteArray, haystack);
+    QFETCH(QByteArray, needle);
+
+    int result = -1;
+    QBENCHMARK {
+        result = haystack.indexOf(needle);
+    }
+    QCOMPARE(result, haystack.size() - needle.size());
+}
+
+void tst_qbytearray::indexIn()
+{
+    QFETCH(QByteArray, haystack);
+    QFETCH(QByteArray, needle);
+
+    const QByteArrayMatcher matcher(needle);
+    int result = -1;
+    QBENCHMARK {
+        result = matcher.indexIn(haystack);
+    }
+    QCOMPARE(result, haystack.size() - needle.size());
+}
+
+void tst_qbytearray::countChar()
+{
+    int result = 0;
+    QBENCHMARK {
+        result = sourcecode.count('\n');
+    }
+    QVERIFY(result > 0);
+}
+
 QTEST_MAIN(tst_qbytearray)
 
 #include "main.moc"
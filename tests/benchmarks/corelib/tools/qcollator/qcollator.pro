@@ -0,0 +1,4 @@
+TARGET = tst_bench_qcollator
+QT = core testlib
+SOURCES += tst_bench_qcollator.cpp
+CONFIG += release
@@ -0,0 +1,150 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/qcollator.h>
+#include <QtCore/qstringlist.h>
+
+#include <algorithm>
+#include <vector>
+
+class tst_QCollator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void stdSortCompare_data() { data(); }
+    void stdSortCompare();
+    void stdSortSortKeys_data() { data(); }
+    void stdSortSortKeys();
+    void sort_data() { data(); }
+    void sort();
+    void sortCached_data() { data(); }
+    void sortCached();
+
+private:
+    void data();
+};
+
+static QStringList localizedStrings(int count)
+{
+    // words with accented letters and mixed case, to exercise the collation
+    static const char * const syllables[] = {
+        "ab", "\xc3\xa4r", "Be", "c\xc3\xa9", "d\xc3\xb6", "en", "F\xc3\xa5", "gi",
+        "h\xc3\xbc", "ja", "K\xc3\xb8", "lo", "m\xc3\xa6", "n\xc3\xb1", "Or", "p\xc3\xa8",
+        "\xc3\x85s", "tu", "v\xc3\xad", "\xc3\x9f", "zy", "ch", "\xc3\xa7a", "\xc3\xb4t"
+    };
+    const uint syllableCount = sizeof syllables / sizeof *syllables;
+
+    QStringList result;
+    result.reserve(count);
+    quint32 seed = 0x9e3779b9;
+    for (int i = 0; i < count; ++i) {
+        seed = seed * 1664525 + 1013904223;
+        const int length = 2 + (seed >> 28) % 4;
+        QByteArray word;
+        for (int j = 0; j < length; ++j) {
+            seed = seed * 1664525 + 1013904223;
+            word += syllables[(seed >> 16) % syllableCount];
+        }
+        result.append(QString::fromUtf8(word));
+    }
+    return result;
+}
+
+void tst_QCollator::data()
+{
+    QTest::addColumn<QStringList>("strings");
+
+    QTest::newRow("1000") << localizedStrings(1000);
+    QTest::newRow("100000") << localizedStrings(100000);
+    QTest::newRow("1000000") << localizedStrings(1000000);
+}
+
+void tst_QCollator::stdSortCompare()
+{
+    QFETCH(QStringList, strings);
+    const QCollator collator;
+
+    QBENCHMARK {
+        QStringList list = strings;
+        std::sort(list.begin(), list.end(), collator);
+    }
+}
+
+void tst_QCollator::stdSortSortKeys()
+{
+    QFETCH(QStringList, strings);
+    const QCollator collator;
+
+    QBENCHMARK {
+        std::vector<QCollatorSortKey> keys;
+        keys.reserve(strings.size());
+        for (const QString &string : qAsConst(strings))
+            keys.push_back(collator.sortKey(string));
+        QVector<int> order(strings.size());
+        for (int i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&keys](int lhs, int rhs) {
+            return keys.at(lhs) < keys.at(rhs);
+        });
+        QStringList list;
+        list.reserve(order.size());
+        for (int i : qAsConst(order))
+            list.append(strings.at(i));
+    }
+}
+
+void tst_QCollator::sort()
+{
+    QFETCH(QStringList, strings);
+    const QCollator collator;
+
+    QBENCHMARK {
+        QStringList list = strings;
+        collator.sort(list);
+    }
+}
+
+void tst_QCollator::sortCached()
+{
+    QFETCH(QStringList, strings);
+    QCollator collator;
+    collator.setSortKeyCacheLimit(strings.size());
+
+    // the keys of all strings are cached after the first run
+    QBENCHMARK {
+        QStringList list = strings;
+        collator.sort(list);
+    }
+}
+
+QTEST_MAIN(tst_QCollator)
+
+#include "tst_bench_qcollator.moc"
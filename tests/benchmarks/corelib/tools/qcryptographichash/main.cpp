@@ -30,6 +30,7 @@
 #include <QCryptographicHash>
 #include <QFile>
 #include <QString>
+#include <QTemporaryFile>
 #include <QtTest>
 
 #include <time.h>
@@ -58,6 +59,12 @@ private Q_SLOTS:
     void addData();
     void addDataChunked_data() { hash_data(); }
     void addDataChunked();
+    void hashOneByOne_data();
+    void hashOneByOne();
+    void hashMany_data() { hashOneByOne_data(); }
+    void hashMany();
+    void hashFile_data();
+    void hashFile();
 };
 
 const int MaxCryptoAlgorithm = QCryptographicHash::Sha3_512;
@@ -168,6 +175,83 @@ void tst_bench_QCryptographicHash::addDataChunked()
     }
 }
 
+void tst_bench_QCryptographicHash::hashOneByOne_data()
+{
+    QTest::addColumn<int>("algorithm");
+    QTest::addColumn<QByteArrayList>("data");
+
+    // many independent small messages, like the chunks of an artifact store
+    static const int messageSizes[] = { 32, 64, 256, 1024 };
+    static const int algorithms[] = {
+        QCryptographicHash::Md5, QCryptographicHash::Sha1,
+        QCryptographicHash::Sha224, QCryptographicHash::Sha256
+    };
+    for (int size : messageSizes) {
+        QByteArrayList data;
+        for (int i = 0; i < 1024; ++i) {
+            const int offset = (i * 61) % (MaxBlockSize - size);
+            data.append(QByteArray::fromRawData(blockOfData.constData() + offset, size));
+        }
+        for (int algo : algorithms)
+            QTest::newRow(algoname(algo) + QByteArray::number(size) + "x1024") << algo << data;
+    }
+}
+
+void tst_bench_QCryptographicHash::hashOneByOne()
+{
+    QFETCH(int, algorithm);
+    QFETCH(QByteArrayList, data);
+
+    QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    QBENCHMARK {
+        for (const QByteArray &message : qAsConst(data))
+            QCryptographicHash::hash(message, algo);
+    }
+}
+
+void tst_bench_QCryptographicHash::hashMany()
+{
+    QFETCH(int, algorithm);
+    QFETCH(QByteArrayList, data);
+
+    QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    QBENCHMARK {
+        QCryptographicHash::hash(data, algo);
+    }
+}
+
+void tst_bench_QCryptographicHash::hashFile_data()
+{
+    QTest::addColumn<int>("algorithm");
+    QTest::addColumn<bool>("readAll");
+
+    static const int algorithms[] = { QCryptographicHash::Sha1, QCryptographicHash::Sha256 };
+    for (int algo : algorithms) {
+        QTest::newRow(algoname(algo) + QByteArray("readAll")) << algo << true;
+        QTest::newRow(algoname(algo) + QByteArray("device")) << algo << false;
+    }
+}
+
+void tst_bench_QCryptographicHash::hashFile()
+{
+    QFETCH(int, algorithm);
+    QFETCH(bool, readAll);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    for (int i = 0; i < 256; ++i) // 16 MB
+        QCOMPARE(file.write(blockOfData), qint64(blockOfData.size()));
+
+    QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    QBENCHMARK {
+        file.seek(0);
+        if (readAll)
+            QCryptographicHash::hash(file.readAll(), algo);
+        else
+            QCryptographicHash::hash(&file, algo);
+    }
+}
+
 QTEST_APPLESS_MAIN(tst_bench_QCryptographicHash)
 
 #include "main.moc"
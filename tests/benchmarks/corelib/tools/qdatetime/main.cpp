@@ -95,9 +95,19 @@ private Q_SLOTS:
     void fromString();
     void fromStringText();
     void fromStringIso();
+    void fromStringIsoOffset();
+    void fromStringIsoLatin1();
+    void fromStringRfc();
+    void fromStringRfcLatin1();
+    void fromStringFormat();
+    void fromStringCompiledFormat();
+    void fromStringCompiledFormatLatin1();
     void fromMSecsSinceEpoch();
     void fromMSecsSinceEpochUtc();
     void fromMSecsSinceEpochTz();
+    void toTimeZone();
+    void toTimeZone2050();
+    void createTimeZone();
 };
 
 void tst_QDateTime::create()
@@ -573,6 +583,72 @@ void tst_QDateTime::fromStringIso()
     }
 }
 
+void tst_QDateTime::fromStringIsoOffset()
+{
+    QString input = "2010-01-01T13:28:34.999+05:30";
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            QDateTime::fromString(input, Qt::ISODate);
+    }
+}
+
+void tst_QDateTime::fromStringIsoLatin1()
+{
+    QByteArray input = "2010-01-01T13:28:34.999Z";
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            QDateTime::fromString(QLatin1String(input), Qt::ISODate);
+    }
+}
+
+void tst_QDateTime::fromStringRfc()
+{
+    QString input = "Fri, 01 Jan 2010 13:28:34 +0100";
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            QDateTime::fromString(input, Qt::RFC2822Date);
+    }
+}
+
+void tst_QDateTime::fromStringRfcLatin1()
+{
+    QByteArray input = "Fri, 01 Jan 2010 13:28:34 +0100";
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            QDateTime::fromString(QLatin1String(input), Qt::RFC2822Date);
+    }
+}
+
+void tst_QDateTime::fromStringFormat()
+{
+    QString format = "dd.MM.yyyy hh:mm:ss.zzz";
+    QString input = "01.01.2010 13:12:11.999";
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            QDateTime::fromString(input, format);
+    }
+}
+
+void tst_QDateTime::fromStringCompiledFormat()
+{
+    QDateTimeFormat format(QStringLiteral("dd.MM.yyyy hh:mm:ss.zzz"));
+    QString input = "01.01.2010 13:12:11.999";
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            format.parse(input);
+    }
+}
+
+void tst_QDateTime::fromStringCompiledFormatLatin1()
+{
+    QDateTimeFormat format(QStringLiteral("dd.MM.yyyy hh:mm:ss.zzz"));
+    QByteArray input = "01.01.2010 13:12:11.999";
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            format.parse(QLatin1String(input));
+    }
+}
+
 void tst_QDateTime::fromMSecsSinceEpoch()
 {
     QBENCHMARK {
@@ -598,6 +674,38 @@ void tst_QDateTime::fromMSecsSinceEpochTz()
     }
 }
 
+void tst_QDateTime::toTimeZone()
+{
+    QTimeZone cet = QTimeZone("Europe/Oslo");
+    QList<QDateTime> list;
+    for (int jd = JULIAN_DAY_2010; jd < JULIAN_DAY_2020; ++jd)
+        list.append(QDateTime::fromMSecsSinceEpoch(jd * MSECS_PER_DAY + 3600000 * (jd % 24), Qt::UTC));
+    QBENCHMARK {
+        foreach (const QDateTime &test, list)
+            QDateTime result = test.toTimeZone(cet);
+    }
+}
+
+void tst_QDateTime::toTimeZone2050()
+{
+    QTimeZone cet = QTimeZone("Europe/Oslo");
+    QList<QDateTime> list;
+    for (int jd = JULIAN_DAY_2050; jd < JULIAN_DAY_2060; ++jd)
+        list.append(QDateTime::fromMSecsSinceEpoch(jd * MSECS_PER_DAY + 3600000 * (jd % 24), Qt::UTC));
+    QBENCHMARK {
+        foreach (const QDateTime &test, list)
+            QDateTime result = test.toTimeZone(cet);
+    }
+}
+
+void tst_QDateTime::createTimeZone()
+{
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i)
+            QTimeZone cet = QTimeZone("Europe/Oslo");
+    }
+}
+
 QTEST_MAIN(tst_QDateTime)
 
 #include "main.moc"
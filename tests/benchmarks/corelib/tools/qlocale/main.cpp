@@ -28,6 +28,7 @@
 
 #include <QLocale>
 #include <QTest>
+#include <private/qlocale_tools_p.h>
 
 class tst_QLocale : public QObject
 {
@@ -37,8 +38,26 @@ private Q_SLOTS:
     void toUpper_QLocale_1();
     void toUpper_QLocale_2();
     void toUpper_QString();
+
+    void toDouble_data();
+    void toDouble();
+    void toLongLong_data();
+    void toLongLong();
+    void toString_data();
+    void toString();
 };
 
+// The public conversions and the allocation-free helpers beneath them
+enum NumberApi { QLocaleApi, QStringApi, QByteArrayApi, AsciiApi };
+Q_DECLARE_METATYPE(NumberApi)
+
+static const char *const apiNames[] = { "QLocale", "QString", "QByteArray", "ascii" };
+
+static QByteArray rowName(int api, const char *name)
+{
+    return QByteArray(apiNames[api]) + ':' + name;
+}
+
 static QString data()
 {
     return QStringLiteral("/qt-5/qtbase/tests/benchmarks/corelib/tools/qlocale");
@@ -65,6 +84,123 @@ void tst_QLocale::toUpper_QString()
     QBENCHMARK { LOOP(s.toUpper()) }
 }
 
+void tst_QLocale::toDouble_data()
+{
+    QTest::addColumn<NumberApi>("api");
+    QTest::addColumn<QByteArray>("number");
+
+    for (int api = QLocaleApi; api <= AsciiApi; ++api) {
+        QTest::newRow(rowName(api, "integer")) << NumberApi(api) << QByteArray("1234567");
+        QTest::newRow(rowName(api, "decimal")) << NumberApi(api) << QByteArray("-12345.6789");
+        QTest::newRow(rowName(api, "exponent")) << NumberApi(api) << QByteArray("6.02214e23");
+        QTest::newRow(rowName(api, "17 digits")) << NumberApi(api) << QByteArray("0.30000000000000004");
+    }
+}
+
+void tst_QLocale::toDouble()
+{
+    QFETCH(NumberApi, api);
+    QFETCH(QByteArray, number);
+    const QString string = QString::fromLatin1(number);
+    const QLocale c = QLocale::c();
+    bool ok;
+    int processed;
+
+    switch (api) {
+    case QLocaleApi:
+        QBENCHMARK { LOOP(c.toDouble(string)) }
+        break;
+    case QStringApi:
+        QBENCHMARK { LOOP(string.toDouble()) }
+        break;
+    case QByteArrayApi:
+        QBENCHMARK { LOOP(number.toDouble()) }
+        break;
+    case AsciiApi:
+        QBENCHMARK { LOOP(asciiToDouble(number.constData(), number.size(), ok, processed)) }
+        break;
+    }
+}
+
+void tst_QLocale::toLongLong_data()
+{
+    QTest::addColumn<NumberApi>("api");
+    QTest::addColumn<QByteArray>("number");
+
+    for (int api = QLocaleApi; api <= AsciiApi; ++api) {
+        QTest::newRow(rowName(api, "short")) << NumberApi(api) << QByteArray("42");
+        QTest::newRow(rowName(api, "long")) << NumberApi(api) << QByteArray("-1234567890123456");
+    }
+}
+
+void tst_QLocale::toLongLong()
+{
+    QFETCH(NumberApi, api);
+    QFETCH(QByteArray, number);
+    const QString string = QString::fromLatin1(number);
+    const QLocale c = QLocale::c();
+    bool ok;
+    int processed;
+
+    switch (api) {
+    case QLocaleApi:
+        QBENCHMARK { LOOP(c.toLongLong(string)) }
+        break;
+    case QStringApi:
+        QBENCHMARK { LOOP(string.toLongLong()) }
+        break;
+    case QByteArrayApi:
+        QBENCHMARK { LOOP(number.toLongLong()) }
+        break;
+    case AsciiApi:
+        QBENCHMARK { LOOP(asciiToLongLong(number.constData(), number.size(), ok, processed)) }
+        break;
+    }
+}
+
+void tst_QLocale::toString_data()
+{
+    QTest::addColumn<NumberApi>("api");
+    QTest::addColumn<double>("number");
+    QTest::addColumn<char>("format");
+    QTest::addColumn<int>("precision");
+
+    for (int api = QLocaleApi; api <= AsciiApi; ++api) {
+        QTest::newRow(rowName(api, "shortest")) << NumberApi(api) << 0.1 + 0.2 << 'g'
+                                                << int(QLocale::FloatingPointShortest);
+        QTest::newRow(rowName(api, "g6")) << NumberApi(api) << 1234.5678 << 'g' << 6;
+        QTest::newRow(rowName(api, "e3")) << NumberApi(api) << 6.02214e23 << 'e' << 3;
+        QTest::newRow(rowName(api, "f2")) << NumberApi(api) << -1234.5678 << 'f' << 2;
+    }
+}
+
+void tst_QLocale::toString()
+{
+    QFETCH(NumberApi, api);
+    QFETCH(double, number);
+    QFETCH(char, format);
+    QFETCH(int, precision);
+    const QLocale c = QLocale::c();
+    const QLocaleData::DoubleForm form = format == 'e' ? QLocaleData::DFExponent
+            : format == 'f' ? QLocaleData::DFDecimal : QLocaleData::DFSignificantDigits;
+    char buf[64];
+
+    switch (api) {
+    case QLocaleApi:
+        QBENCHMARK { LOOP(c.toString(number, format, precision)) }
+        break;
+    case QStringApi:
+        QBENCHMARK { LOOP(QString::number(number, format, precision)) }
+        break;
+    case QByteArrayApi:
+        QBENCHMARK { LOOP(QByteArray::number(number, format, precision)) }
+        break;
+    case AsciiApi:
+        QBENCHMARK { LOOP(doubleToAsciiString(number, form, precision, 0, buf, sizeof(buf))) }
+        break;
+    }
+}
+
 QTEST_MAIN(tst_QLocale)
 
 #include "main.moc"
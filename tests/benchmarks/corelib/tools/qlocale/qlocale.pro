@@ -1,4 +1,4 @@
 TARGET = tst_bench_qlocale
-QT = core testlib
+QT = core-private testlib
 
 SOURCES += main.cpp
@@ -0,0 +1,304 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QRegularExpression>
+#include <QStringList>
+#include <QVector>
+#include <qtest.h>
+
+class tst_QRegularExpression : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_QRegularExpression();
+
+private slots:
+    void constructAndMatch();
+    void match_data();
+    void match();
+    void matchReused_data() { match_data(); }
+    void matchReused();
+    void matches_data() { match_data(); }
+    void matches();
+
+    void matchUtf8Converted_data() { match_data(); }
+    void matchUtf8Converted();
+    void matchUtf8_data() { match_data(); }
+    void matchUtf8();
+    void matchesUtf8Converted_data() { match_data(); }
+    void matchesUtf8Converted();
+    void matchesUtf8_data() { match_data(); }
+    void matchesUtf8();
+
+    void classifyOneByOne();
+    void classifyWithMatches();
+    void classifyWithSet();
+    void classifyAllWithSet();
+
+private:
+    QStringList patterns;
+    QStringList lines;
+    QVector<QByteArray> utf8Lines;
+};
+
+static const char *const components[] = {
+    "network", "storage", "scheduler", "auth", "cache", "database", "http", "ui"
+};
+static const char *const levels[] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+
+// ~500 patterns and a few thousand lines, shaped like what a log classifier sees
+tst_QRegularExpression::tst_QRegularExpression()
+{
+    for (int i = 0; i < 500; ++i) {
+        const char *component = components[i % 8];
+        switch (i % 5) {
+        case 0:
+            patterns << QString::fromLatin1("^%1 %2: request %3 failed").arg(levels[i % 4]).arg(component).arg(i);
+            break;
+        case 1:
+            patterns << QString::fromLatin1("%1\\[\\d+\\]: timeout after (\\d+)ms \\(code %2\\)").arg(component).arg(i);
+            break;
+        case 2:
+            patterns << QString::fromLatin1("(?i)%1 (quota|limit) %2 exceeded").arg(component).arg(i);
+            break;
+        case 3:
+            patterns << QString::fromLatin1("user=(\\w+) action=%1_%2\\b").arg(component).arg(i);
+            break;
+        case 4:
+            patterns << QString::fromLatin1("#%1-[0-9a-f]{8}$").arg(i);
+            break;
+        }
+    }
+
+    for (int i = 0; i < 2000; ++i) {
+        const char *component = components[(i * 7) % 8];
+        const int code = (i * 37) % 600;
+        switch (i % 4) {
+        case 0:
+            lines << QString::fromLatin1("%1 %2: request %3 failed").arg(levels[i % 4]).arg(component).arg(code);
+            break;
+        case 1:
+            lines << QString::fromLatin1("%1[%2]: timeout after %3ms (code %4)").arg(component).arg(i).arg(i * 3).arg(code);
+            break;
+        case 2:
+            lines << QString::fromLatin1("2016-10-%1 12:00:%2 all good, nothing to see here").arg(i % 28 + 1).arg(i % 60);
+            break;
+        case 3:
+            lines << QString::fromLatin1("user=john action=%1_%2 ok").arg(component).arg(code);
+            break;
+        }
+    }
+
+    utf8Lines.reserve(lines.size());
+    for (const QString &line : qAsConst(lines))
+        utf8Lines << line.toUtf8();
+}
+
+void tst_QRegularExpression::constructAndMatch()
+{
+    const QString subject = lines.first();
+    QBENCHMARK {
+        for (const QString &pattern : patterns)
+            QRegularExpression(pattern).match(subject);
+    }
+}
+
+void tst_QRegularExpression::match_data()
+{
+    QTest::addColumn<QString>("pattern");
+
+    QTest::newRow("literal") << "all good";
+    QTest::newRow("captures") << "user=(\\w+) action=(\\w+)_(\\d+)";
+    QTest::newRow("no match") << "^FATAL \\w+:";
+}
+
+void tst_QRegularExpression::match()
+{
+    QFETCH(QString, pattern);
+    const QRegularExpression re(pattern);
+    re.optimize();
+
+    QBENCHMARK {
+        for (const QString &line : lines)
+            re.match(line).hasMatch();
+    }
+}
+
+void tst_QRegularExpression::matchReused()
+{
+    QFETCH(QString, pattern);
+    const QRegularExpression re(pattern);
+    re.optimize();
+
+    QRegularExpressionMatch match;
+    QBENCHMARK {
+        for (const QString &line : lines)
+            re.match(&match, line);
+    }
+}
+
+void tst_QRegularExpression::matches()
+{
+    QFETCH(QString, pattern);
+    const QRegularExpression re(pattern);
+    re.optimize();
+
+    QBENCHMARK {
+        for (const QString &line : lines)
+            re.matches(line);
+    }
+}
+
+// what had to be done to match data read from a file or a socket
+void tst_QRegularExpression::matchUtf8Converted()
+{
+    QFETCH(QString, pattern);
+    const QRegularExpression re(pattern);
+    re.optimize();
+
+    QBENCHMARK {
+        for (const QByteArray &line : qAsConst(utf8Lines))
+            re.match(QString::fromUtf8(line)).captured();
+    }
+}
+
+void tst_QRegularExpression::matchUtf8()
+{
+    QFETCH(QString, pattern);
+    const QRegularExpression re(pattern);
+    re.optimize();
+
+    QBENCHMARK {
+        for (const QByteArray &line : qAsConst(utf8Lines))
+            re.matchUtf8(line).capturedBytes();
+    }
+}
+
+void tst_QRegularExpression::matchesUtf8Converted()
+{
+    QFETCH(QString, pattern);
+    const QRegularExpression re(pattern);
+    re.optimize();
+
+    QBENCHMARK {
+        for (const QByteArray &line : qAsConst(utf8Lines))
+            re.matches(QString::fromUtf8(line));
+    }
+}
+
+void tst_QRegularExpression::matchesUtf8()
+{
+    QFETCH(QString, pattern);
+    const QRegularExpression re(pattern);
+    re.optimize();
+
+    QBENCHMARK {
+        for (const QByteArray &line : qAsConst(utf8Lines))
+            re.matchesUtf8(line);
+    }
+}
+
+void tst_QRegularExpression::classifyOneByOne()
+{
+    QVector<QRegularExpression> expressions;
+    for (const QString &pattern : patterns) {
+        expressions << QRegularExpression(pattern);
+        expressions.last().optimize();
+    }
+
+    int matched = 0;
+    QBENCHMARK {
+        matched = 0;
+        for (const QString &line : lines) {
+            for (const QRegularExpression &re : expressions) {
+                if (re.match(line).hasMatch()) {
+                    ++matched;
+                    break;
+                }
+            }
+        }
+    }
+    QVERIFY(matched > 0);
+}
+
+void tst_QRegularExpression::classifyWithMatches()
+{
+    QVector<QRegularExpression> expressions;
+    for (const QString &pattern : patterns) {
+        expressions << QRegularExpression(pattern);
+        expressions.last().optimize();
+    }
+
+    int matched = 0;
+    QBENCHMARK {
+        matched = 0;
+        for (const QString &line : lines) {
+            for (const QRegularExpression &re : expressions) {
+                if (re.matches(line)) {
+                    ++matched;
+                    break;
+                }
+            }
+        }
+    }
+    QVERIFY(matched > 0);
+}
+
+void tst_QRegularExpression::classifyWithSet()
+{
+    const QRegularExpressionSet set(patterns);
+
+    int matched = 0;
+    QBENCHMARK {
+        matched = 0;
+        for (const QString &line : lines) {
+            if (set.firstMatchingIndex(line) >= 0)
+                ++matched;
+        }
+    }
+    QVERIFY(matched > 0);
+}
+
+void tst_QRegularExpression::classifyAllWithSet()
+{
+    const QRegularExpressionSet set(patterns);
+
+    int matched = 0;
+    QBENCHMARK {
+        matched = 0;
+        for (const QString &line : lines)
+            matched += set.matchingIndexes(line).size();
+    }
+    QVERIFY(matched > 0);
+}
+
+QTEST_MAIN(tst_QRegularExpression)
+
+#include "main.moc"
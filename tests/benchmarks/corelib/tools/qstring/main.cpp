@@ -26,6 +26,7 @@
 **
 ****************************************************************************/
 #include <QStringList>
+#include <QStringMatcher>
 #include <QFile>
 #include <QtTest/QtTest>
 
@@ -49,6 +50,15 @@ private slots:
     void toCaseFolded_data();
     void toCaseFolded();
 
+    void indexOf_data();
+    void indexOf();
+    void indexOf_qt58_data() { indexOf_data(); }
+    void indexOf_qt58();
+    void indexIn_data() { indexOf_data(); }
+    void indexIn();
+    void count_data() { indexOf_data(); }
+    void count();
+
 private:
     void section_data_impl(bool includeRegExOnly = true);
     template <typename RX> void section_impl();
@@ -188,6 +198,161 @@ void tst_QString::toCaseFolded()
     }
 }
 
+// a long text, whose last needleLength characters are searched for
+void tst_QString::indexOf_data()
+{
+    QTest::addColumn<QString>("haystack");
+    QTest::addColumn<QString>("needle");
+    QTest::addColumn<bool>("caseSensitive");
+
+    static const char *const words[] = {
+        "the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog", "and",
+        "then", "some", "more", "text", "to", "search", "through", "matcher"
+    };
+    QString haystack;
+    for (uint i = 0; haystack.size() < 100000; i = i * 7 + 3)
+        haystack += QLatin1String(words[i % (sizeof(words) / sizeof(words[0]))]) + QLatin1Char(' ');
+    haystack += QLatin1String("Where Did The Needle Go, Nobody Knows It: It Was Lost Between The Words"
+                              " of a very long sentence, one of many in this haystack!");
+
+    for (int length : { 2, 4, 8, 16, 32, 64, 128 }) {
+        const QString needle = haystack.right(length).toLower();
+        const QByteArray tag = QByteArray::number(length);
+        QTest::newRow(("sensitive-" + tag).constData()) << haystack << haystack.right(length) << true;
+        QTest::newRow(("insensitive-" + tag).constData()) << haystack << needle << false;
+    }
+}
+
+void tst_QString::indexOf()
+{
+    QFETCH(QString, haystack);
+    QFETCH(QString, needle);
+    QFETCH(bool, caseSensitive);
+    const Qt::CaseSensitivity cs = caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    int result = -1;
+    QBENCHMARK {
+        result = haystack.indexOf(needle, 0, cs);
+    }
+    QCOMPARE(result, haystack.size() - needle.size());
+}
+
+// the following was copied from qstring.cpp and qstringmatcher.cpp (Qt 5.8),
+// case sensitive only
+namespace Qt58 {
+static int bm_find(const ushort *uc, uint l, int index, const ushort *puc, uint pl)
+{
+    uchar skiptable[256];
+    int sl = qMin(pl, 255u);
+    memset(skiptable, sl, sizeof(skiptable));
+    for (const ushort *c = puc + pl - sl; sl--; ++c)
+        skiptable[*c & 0xff] = sl;
+
+    const uint pl_minus_one = pl - 1;
+    const ushort *current = uc + index + pl_minus_one;
+    const ushort *end = uc + l;
+    while (current < end) {
+        uint skip = skiptable[*current & 0xff];
+        if (!skip) {
+            while (skip < pl) {
+                if (*(current - skip) != puc[pl_minus_one-skip])
+                    break;
+                skip++;
+            }
+            if (skip > pl_minus_one)
+                return (current - uc) - pl_minus_one;
+            if (skiptable[*(current - skip) & 0xff] == pl)
+                skip = pl - skip;
+            else
+                skip = 1;
+        }
+        if (current > end - skip)
+            break;
+        current += skip;
+    }
+    return -1;
+}
+
+#define REHASH(a) \
+    if (sl_minus_1 < (int)sizeof(int) * CHAR_BIT)       \
+        hashHaystack -= (a) << sl_minus_1; \
+    hashHaystack <<= 1
+
+static int qFindString(const QChar *haystack0, int l, int from, const QChar *needle0, int sl)
+{
+    if (l > 500 && sl > 5)
+        return bm_find((const ushort *)haystack0, l, from, (const ushort *)needle0, sl);
+
+    const ushort *needle = (const ushort *)needle0;
+    const ushort *haystack = (const ushort *)haystack0 + from;
+    const ushort *end = (const ushort *)haystack0 + (l-sl);
+    const int sl_minus_1 = sl-1;
+    int hashNeedle = 0, hashHaystack = 0, idx;
+
+    for (idx = 0; idx < sl; ++idx) {
+        hashNeedle = ((hashNeedle<<1) + needle[idx]);
+        hashHaystack = ((hashHaystack<<1) + haystack[idx]);
+    }
+    hashHaystack -= haystack[sl_minus_1];
+
+    while (haystack <= end) {
+        hashHaystack += haystack[sl_minus_1];
+        if (hashHaystack == hashNeedle
+             && memcmp(needle, haystack, sl * sizeof(ushort)) == 0)
+            return haystack - (const ushort *)haystack0;
+
+        REHASH(*haystack);
+        ++haystack;
+    }
+    return -1;
+}
+#undef REHASH
+} // namespace Qt58
+
+void tst_QString::indexOf_qt58()
+{
+    QFETCH(QString, haystack);
+    QFETCH(QString, needle);
+    QFETCH(bool, caseSensitive);
+    if (!caseSensitive)
+        QSKIP("The copy of the old implementation is case sensitive only");
+
+    int result = -1;
+    QBENCHMARK {
+        result = Qt58::qFindString(haystack.constData(), haystack.size(), 0,
+                                   needle.constData(), needle.size());
+    }
+    QCOMPARE(result, haystack.size() - needle.size());
+}
+
+void tst_QString::indexIn()
+{
+    QFETCH(QString, haystack);
+    QFETCH(QString, needle);
+    QFETCH(bool, caseSensitive);
+
+    const QStringMatcher matcher(needle, caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive);
+    int result = -1;
+    QBENCHMARK {
+        result = matcher.indexIn(haystack);
+    }
+    QCOMPARE(result, haystack.size() - needle.size());
+}
+
+void tst_QString::count()
+{
+    QFETCH(QString, haystack);
+    QFETCH(QString, needle);
+    QFETCH(bool, caseSensitive);
+    const Qt::CaseSensitivity cs = caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    int result = 0;
+    QBENCHMARK {
+        result = haystack.count(needle, cs);
+    }
+    QVERIFY(result > 0);
+}
+
 QTEST_APPLESS_MAIN(tst_QString)
 
 #include "main.moc"
@@ -3,6 +3,7 @@ SUBDIRS = \
         containers-associative \
         containers-sequential \
         qbytearray \
+        qcollator \
         qcontiguouscache \
         qcryptographichash \
         qdatetime \
@@ -11,6 +12,7 @@ SUBDIRS = \
         qmap \
         qrect \
         qregexp \
+        qregularexpression \
         qringbuffer \
         qstack \
         qstring \
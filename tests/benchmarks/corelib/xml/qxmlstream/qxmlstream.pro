@@ -0,0 +1,4 @@
+TARGET = tst_bench_qxmlstream
+QT = core testlib
+SOURCES += tst_bench_qxmlstream.cpp
+CONFIG += release
@@ -0,0 +1,226 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/qbuffer.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qxmlstream.h>
+
+class tst_QXmlStream : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void read_data();
+    void read();
+    void smallDocuments_data();
+    void smallDocuments();
+
+private:
+    QByteArray textDocument;
+    QByteArray attributeDocument;
+    QByteArray cdataDocument;
+    QVector<QByteArray> messages;
+};
+
+static qint64 readMessages(QXmlStreamReader *reader, const QByteArray *begin, const QByteArray *end)
+{
+    qint64 elements = 0;
+    for (const QByteArray *message = begin; message != end; ++message) {
+        reader->clear();
+        reader->addData(*message);
+        while (!reader->atEnd()) {
+            if (reader->readNext() == QXmlStreamReader::StartElement)
+                ++elements;
+        }
+        if (reader->hasError())
+            return -1;
+    }
+    return elements;
+}
+
+class MessageReader : public QRunnable
+{
+public:
+    MessageReader(const QByteArray *begin, const QByteArray *end)
+        : begin(begin), end(end), elements(0) { setAutoDelete(false); }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        QXmlStreamReader reader;
+        elements = readMessages(&reader, begin, end);
+    }
+
+    const QByteArray *begin;
+    const QByteArray *end;
+    qint64 elements;
+};
+
+// Builds documents of roughly 16 MB each
+void tst_QXmlStream::initTestCase()
+{
+    const QByteArray sentence = "The quick brown fox jumps over the lazy dog, "
+                                "and the five boxing wizards jump quickly. ";
+    const QByteArray text = sentence.repeated(3);
+
+    textDocument = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<feed>\n";
+    attributeDocument = textDocument;
+    cdataDocument = textDocument;
+    for (int i = 0; textDocument.size() < 16 * 1024 * 1024; ++i) {
+        const QByteArray id = QByteArray::number(i);
+        textDocument += "  <entry id=\"" + id + "\">\n    <title>Entry " + id
+                      + "</title>\n    <summary>" + text + "</summary>\n"
+                        "    <content>" + text + text + "&amp;" + text + "</content>\n  </entry>\n";
+    }
+    for (int i = 0; attributeDocument.size() < 16 * 1024 * 1024; ++i) {
+        const QByteArray id = QByteArray::number(i);
+        attributeDocument += "  <entry id=\"" + id + "\" title=\"" + sentence
+                           + "\" author=\"Some Author Name\" href=\"http://www.example.com/feed/entries/"
+                           + id + "\" summary=\"" + sentence + sentence + "\"/>\n";
+    }
+    for (int i = 0; cdataDocument.size() < 16 * 1024 * 1024; ++i) {
+        cdataDocument += "  <!-- entry " + QByteArray::number(i) + ": " + sentence + " -->\n"
+                         "  <script><![CDATA[if (a < b && c > d) { " + text + " }]]></script>\n";
+    }
+    for (int i = 0; i < 20000; ++i) {
+        const QByteArray id = QByteArray::number(i);
+        messages.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                        "<message xmlns=\"urn:example:messages\" id=\"" + id + "\">\n"
+                        "  <from>sender" + id + "@example.com</from>\n"
+                        "  <to>receiver@example.com</to>\n"
+                        "  <subject>Order " + id + " &amp; invoice</subject>\n"
+                        "  <body>Your order &lt;" + id + "&gt; has been shipped.</body>\n"
+                        "</message>\n");
+    }
+    textDocument += "</feed>\n";
+    attributeDocument += "</feed>\n";
+    cdataDocument += "</feed>\n";
+}
+
+void tst_QXmlStream::read_data()
+{
+    QTest::addColumn<QByteArray>("document");
+    QTest::addColumn<bool>("fromDevice");
+
+    QTest::newRow("text, QByteArray") << textDocument << false;
+    QTest::newRow("text, QIODevice") << textDocument << true;
+    QTest::newRow("attributes, QByteArray") << attributeDocument << false;
+    QTest::newRow("attributes, QIODevice") << attributeDocument << true;
+    QTest::newRow("comments and CDATA, QByteArray") << cdataDocument << false;
+    QTest::newRow("comments and CDATA, QIODevice") << cdataDocument << true;
+}
+
+void tst_QXmlStream::read()
+{
+    QFETCH(QByteArray, document);
+    QFETCH(bool, fromDevice);
+
+    qint64 characters = 0;
+    QBENCHMARK {
+        QBuffer buffer(&document);
+        buffer.open(QIODevice::ReadOnly);
+        QXmlStreamReader reader;
+        if (fromDevice)
+            reader.setDevice(&buffer);
+        else
+            reader.addData(document);
+        characters = 0;
+        while (!reader.atEnd()) {
+            switch (reader.readNext()) {
+            case QXmlStreamReader::StartElement:
+                for (const QXmlStreamAttribute &attribute : reader.attributes())
+                    characters += attribute.value().size();
+                break;
+            case QXmlStreamReader::Characters:
+            case QXmlStreamReader::Comment:
+                characters += reader.text().size();
+                break;
+            default:
+                break;
+            }
+        }
+        QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+    }
+    QVERIFY(characters > 0);
+}
+
+void tst_QXmlStream::smallDocuments_data()
+{
+    QTest::addColumn<int>("mode");
+
+    QTest::newRow("new reader per document") << 0;
+    QTest::newRow("reused reader") << 1;
+    QTest::newRow("reused reader per thread") << 2;
+}
+
+// Reads 20000 messages of about 300 bytes each
+void tst_QXmlStream::smallDocuments()
+{
+    QFETCH(int, mode);
+
+    const QByteArray *begin = messages.constData();
+    const QByteArray *end = begin + messages.size();
+    qint64 elements = 0;
+    QBENCHMARK {
+        if (mode == 0) {
+            elements = 0;
+            for (const QByteArray *message = begin; message != end; ++message) {
+                QXmlStreamReader reader;
+                const qint64 n = readMessages(&reader, message, message + 1);
+                QVERIFY(n > 0);
+                elements += n;
+            }
+        } else if (mode == 1) {
+            QXmlStreamReader reader;
+            elements = readMessages(&reader, begin, end);
+        } else {
+            const int threadCount = qMax(2, QThread::idealThreadCount());
+            const int chunk = (messages.size() + threadCount - 1) / threadCount;
+            QVector<MessageReader *> readers;
+            for (const QByteArray *first = begin; first < end; first += chunk) {
+                readers.append(new MessageReader(first, qMin(first + chunk, end)));
+                QThreadPool::globalInstance()->start(readers.last());
+            }
+            QThreadPool::globalInstance()->waitForDone();
+            elements = 0;
+            for (MessageReader *reader : qAsConst(readers)) {
+                QVERIFY(reader->elements > 0);
+                elements += reader->elements;
+            }
+            qDeleteAll(readers);
+        }
+    }
+    QCOMPARE(elements, qint64(messages.size()) * 5);
+}
+
+QTEST_MAIN(tst_QXmlStream)
+
+#include "tst_bench_qxmlstream.moc"
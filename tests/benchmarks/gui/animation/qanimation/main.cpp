@@ -51,6 +51,9 @@ private slots:
     void floatAnimation_data() { data(); }
     void floatAnimation();
 
+    void manyTargets_data();
+    void manyTargets();
+
 private:
     void data();
 };
@@ -171,7 +174,51 @@ void tst_qanimation::floatAnimation()
     }
 }
 
+void tst_qanimation::manyTargets_data()
+{
+    QTest::addColumn<bool>("animateRect");
+    QTest::addColumn<bool>("animateOpacity");
+    QTest::newRow("rect") << true << false;
+    QTest::newRow("opacity") << false << true;
+    QTest::newRow("rect and opacity") << true << true;
+}
 
+void tst_qanimation::manyTargets()
+{
+    //a dashboard-like load: one frame updates lots of small animations
+    QFETCH(bool, animateRect);
+    QFETCH(bool, animateOpacity);
+    const int targetCount = 1000;
+    const int frameCount = 100;
+
+    QVector<DummyObject *> targets;
+    QParallelAnimationGroup group;
+    for (int i = 0; i < targetCount; ++i) {
+        DummyObject *dummy = new DummyObject;
+        targets.append(dummy);
+        if (animateRect) {
+            QPropertyAnimation *anim = new QPropertyAnimation(dummy, "rect", &group);
+            anim->setDuration(frameCount);
+            anim->setStartValue(QRect(0, 0, 0, 0));
+            anim->setEndValue(QRect(i, i, ITERATION_COUNT, ITERATION_COUNT));
+        }
+        if (animateOpacity) {
+            QPropertyAnimation *anim = new QPropertyAnimation(dummy, "opacity", &group);
+            anim->setDuration(frameCount);
+            anim->setStartValue(0.f);
+            anim->setEndValue(1.f);
+        }
+    }
+    group.start();
+
+    QBENCHMARK {
+        for (int i = 0; i < frameCount; ++i)
+            group.setCurrentTime(i);
+    }
+
+    group.stop();
+    qDeleteAll(targets);
+}
 
 QTEST_MAIN(tst_qanimation)
 
@@ -0,0 +1,6 @@
+QT += widgets testlib
+
+TEMPLATE = app
+TARGET = tst_bench_qabstractitemview
+
+SOURCES += tst_bench_qabstractitemview.cpp
@@ -0,0 +1,211 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <qtest.h>
+#include <QListView>
+#include <QTableView>
+#include <QTreeView>
+#include <QHeaderView>
+#include <QAbstractModelFetcher>
+#include <QThread>
+
+// A flat model which receives its rows in chunks, like a model populated
+// from a network or database stream.
+class StreamModel : public QAbstractTableModel
+{
+public:
+    explicit StreamModel(int columns)
+        : rows(0), columns(columns)
+    {}
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE
+    {
+        return parent.isValid() ? 0 : rows;
+    }
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE
+    {
+        return parent.isValid() ? 0 : columns;
+    }
+
+    QVariant data(const QModelIndex &index, int role) const Q_DECL_OVERRIDE
+    {
+        if (role == Qt::DisplayRole)
+            return index.row();
+        return QVariant();
+    }
+
+    void appendRows(int count)
+    {
+        beginInsertRows(QModelIndex(), rows, rows + count - 1);
+        rows += count;
+        endInsertRows();
+    }
+
+private:
+    int rows;
+    int columns;
+};
+
+// Produces the rows of StreamModel in chunks, in the loader thread
+class StreamFetcher : public QAbstractModelFetcher
+{
+public:
+    ~StreamFetcher()
+    {
+        cancelAll();
+        waitForFinished();
+    }
+
+protected:
+    void fetchRows(const QVariant &argument) Q_DECL_OVERRIDE
+    {
+        const QVariantList arguments = argument.toList();
+        const int rows = arguments.at(0).toInt();
+        const int chunk = arguments.at(1).toInt();
+        for (int i = 0; i < rows && !isCanceled(); i += chunk) {
+            QVariantList values;
+            for (int j = 0; j < chunk; ++j)
+                values.append(i + j);
+            addRows(values);
+            QThread::yieldCurrentThread();
+        }
+    }
+};
+
+static QAbstractItemView *createView(const QString &view)
+{
+    if (view == QLatin1String("QListView"))
+        return new QListView;
+    if (view == QLatin1String("QTableView"))
+        return new QTableView;
+    return new QTreeView;
+}
+
+class tst_QAbstractItemView : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void streamingInserts_data();
+    void streamingInserts();
+    void fetchedInserts_data();
+    void fetchedInserts();
+};
+
+void tst_QAbstractItemView::streamingInserts_data()
+{
+    QTest::addColumn<QString>("view");
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("chunk");
+
+    const char *views[] = { "QListView", "QTableView", "QTreeView" };
+    for (const char *view : views) {
+        QTest::newRow(QByteArray(view).append(", 20000 rows, chunks of 100").constData())
+            << QString::fromLatin1(view) << 20000 << 100;
+        QTest::newRow(QByteArray(view).append(", 20000 rows, chunks of 5000").constData())
+            << QString::fromLatin1(view) << 20000 << 5000;
+    }
+}
+
+// The time to process the inserts, including the delayed layouts of the view
+void tst_QAbstractItemView::streamingInserts()
+{
+    QFETCH(QString, view);
+    QFETCH(int, rows);
+    QFETCH(int, chunk);
+
+    QBENCHMARK {
+        StreamModel model(3);
+        QScopedPointer<QAbstractItemView> itemView(createView(view));
+        itemView->resize(400, 300);
+        itemView->setModel(&model);
+        itemView->show();
+        QCoreApplication::processEvents();
+
+        // each chunk arrives in its own event loop iteration
+        for (int inserted = 0; inserted < rows; inserted += chunk) {
+            model.appendRows(chunk);
+            QCoreApplication::processEvents();
+        }
+        QCOMPARE(model.rowCount(), rows);
+    }
+}
+
+void tst_QAbstractItemView::fetchedInserts_data()
+{
+    QTest::addColumn<QString>("view");
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("chunk");
+    QTest::addColumn<int>("updateInterval");
+
+    const char *views[] = { "QListView", "QTableView", "QTreeView" };
+    for (const char *view : views) {
+        QTest::newRow(QByteArray(view).append(", 20000 rows, chunks of 100, interval 0").constData())
+            << QString::fromLatin1(view) << 20000 << 100 << 0;
+        QTest::newRow(QByteArray(view).append(", 20000 rows, chunks of 100, interval 100").constData())
+            << QString::fromLatin1(view) << 20000 << 100 << 100;
+    }
+}
+
+// The same stream as streamingInserts(), produced in a loader thread: the
+// chunks arriving between two deliveries are inserted together.
+void tst_QAbstractItemView::fetchedInserts()
+{
+    QFETCH(QString, view);
+    QFETCH(int, rows);
+    QFETCH(int, chunk);
+    QFETCH(int, updateInterval);
+
+    QBENCHMARK {
+        StreamModel model(3);
+        StreamFetcher fetcher;
+        fetcher.setUpdateInterval(updateInterval);
+        connect(&fetcher, &QAbstractModelFetcher::rowsFetched,
+                [&model](const QModelIndex &, const QVariantList &values) {
+            model.appendRows(values.size());
+        });
+        QScopedPointer<QAbstractItemView> itemView(createView(view));
+        itemView->resize(400, 300);
+        itemView->setModel(&model);
+        itemView->show();
+        QCoreApplication::processEvents();
+
+        QEventLoop loop;
+        connect(&fetcher, &QAbstractModelFetcher::finished, &loop, &QEventLoop::quit);
+        fetcher.fetch(QModelIndex(), QVariantList() << rows << chunk);
+        loop.exec();
+        QCoreApplication::processEvents();
+        QCOMPARE(model.rowCount(), rows);
+    }
+}
+
+QTEST_MAIN(tst_QAbstractItemView)
+
+#include "tst_bench_qabstractitemview.moc"
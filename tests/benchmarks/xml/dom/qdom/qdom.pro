@@ -0,0 +1,4 @@
+TARGET = tst_bench_qdom
+QT = core xml testlib
+SOURCES += tst_bench_qdom.cpp
+CONFIG += release
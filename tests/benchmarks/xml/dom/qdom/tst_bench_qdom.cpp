@@ -0,0 +1,169 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtXml/qdom.h>
+
+#if defined(__GLIBC__)
+#  include <malloc.h>
+#endif
+
+class tst_QDom : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void setContent_data();
+    void setContent();
+    void memoryUsage_data();
+    void memoryUsage();
+    void traverse_data();
+    void traverse();
+
+private:
+    QByteArray recordDocument;
+    QByteArray textDocument;
+};
+
+#if defined(__GLIBC__)
+static qint64 allocatedBytes()
+{
+#  if __GLIBC_PREREQ(2, 33)
+    return qint64(mallinfo2().uordblks);
+#  else
+    return qint64(mallinfo().uordblks);
+#  endif
+}
+#endif
+
+static int countNodes(const QDomNode &node)
+{
+    int count = 1;
+    if (node.isElement())
+        count += node.attributes().count();
+    for (QDomNode child = node.firstChild(); !child.isNull(); child = child.nextSibling())
+        count += countNodes(child);
+    return count;
+}
+
+// Builds documents of roughly 8 MB each
+void tst_QDom::initTestCase()
+{
+    const QByteArray sentence = "The quick brown fox jumps over the lazy dog. ";
+
+    recordDocument = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                     "<db:records xmlns:db=\"http://www.example.com/schemas/database/2016\""
+                     " xmlns:meta=\"http://www.example.com/schemas/metadata/2016\">\n";
+    for (int i = 0; recordDocument.size() < 8 * 1024 * 1024; ++i) {
+        const QByteArray id = QByteArray::number(i);
+        recordDocument += "  <db:record db:id=\"" + id + "\" meta:state=\"active\">\n"
+                          "    <db:field db:name=\"name\" db:type=\"string\">Record " + id + "</db:field>\n"
+                          "    <db:field db:name=\"count\" db:type=\"int\">" + id + "</db:field>\n"
+                          "    <meta:modified>2016-10-01</meta:modified>\n"
+                          "  </db:record>\n";
+    }
+    recordDocument += "</db:records>\n";
+
+    textDocument = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<book>\n";
+    for (int i = 0; textDocument.size() < 8 * 1024 * 1024; ++i) {
+        textDocument += "  <chapter>\n    <title>Chapter " + QByteArray::number(i) + "</title>\n";
+        for (int j = 0; j < 5; ++j)
+            textDocument += "    <para>" + sentence.repeated(j + 2) + "<em>" + sentence + "</em></para>\n";
+        textDocument += "  </chapter>\n";
+    }
+    textDocument += "</book>\n";
+}
+
+void tst_QDom::setContent_data()
+{
+    QTest::addColumn<QByteArray>("document");
+    QTest::addColumn<bool>("namespaceProcessing");
+
+    QTest::newRow("records") << recordDocument << false;
+    QTest::newRow("records, namespace processing") << recordDocument << true;
+    QTest::newRow("text") << textDocument << false;
+}
+
+void tst_QDom::setContent()
+{
+    QFETCH(QByteArray, document);
+    QFETCH(bool, namespaceProcessing);
+
+    QBENCHMARK {
+        QDomDocument doc;
+        QVERIFY(doc.setContent(document, namespaceProcessing));
+    }
+}
+
+void tst_QDom::memoryUsage_data()
+{
+    setContent_data();
+}
+
+void tst_QDom::memoryUsage()
+{
+#if defined(__GLIBC__)
+    QFETCH(QByteArray, document);
+    QFETCH(bool, namespaceProcessing);
+
+    const qint64 before = allocatedBytes();
+    QDomDocument doc;
+    QVERIFY(doc.setContent(document, namespaceProcessing));
+    const qint64 used = allocatedBytes() - before;
+    const int nodes = countNodes(doc);
+    qDebug("%d nodes, %lld bytes per node", nodes, used / nodes);
+    QTest::setBenchmarkResult(used, QTest::BytesAllocated);
+#else
+    QSKIP("Needs the GNU C library to measure heap usage");
+#endif
+}
+
+void tst_QDom::traverse_data()
+{
+    setContent_data();
+}
+
+void tst_QDom::traverse()
+{
+    QFETCH(QByteArray, document);
+    QFETCH(bool, namespaceProcessing);
+
+    QDomDocument doc;
+    QVERIFY(doc.setContent(document, namespaceProcessing));
+    int count = 0;
+    QBENCHMARK {
+        count = countNodes(doc);
+    }
+    QVERIFY(count > 0);
+}
+
+QTEST_MAIN(tst_QDom)
+
+#include "tst_bench_qdom.moc"
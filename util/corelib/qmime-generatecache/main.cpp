@@ -0,0 +1,634 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the utils of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtCore>
+
+#include <algorithm>
+#include <ctype.h>
+#include <map>
+
+// Writes a cache in the format of shared-mime-info's mime.cache
+// (see the shared-mime-info specification), generated from a single
+// MIME type package such as freedesktop.org.xml. QMimeDatabase embeds
+// the result in QtCore and uses it when the system has no mime.cache.
+//
+// Two Qt specific fields follow the standard header: the offset of a
+// list of all MIME types with the position of their <mime-type> element
+// in the package file (which update-mime-database would have split into
+// separate files for the comments and the glob patterns), and the Adler-32
+// checksum of the package file the cache was generated from.
+
+enum {
+    HeaderSize = 48,
+    PosAliasListOffset = 4,
+    PosParentListOffset = 8,
+    PosLiteralListOffset = 12,
+    PosReverseSuffixTreeOffset = 16,
+    PosGlobListOffset = 20,
+    PosMagicListOffset = 24,
+    PosNamespaceListOffset = 28,
+    PosIconsListOffset = 32,
+    PosGenericIconsListOffset = 36,
+    PosMimeTypeListOffset = 40,
+    PosSourceChecksumOffset = 44
+};
+
+struct Matchlet
+{
+    quint32 rangeStart;
+    quint32 rangeLength;
+    quint32 wordSize;
+    quint32 valueLength;
+    quint32 valueOffset;
+    quint32 maskOffset;
+    QVector<Matchlet> children;
+};
+
+struct Match
+{
+    quint32 priority;
+    QByteArray mimeType;
+    QVector<Matchlet> matchlets;
+};
+
+struct Glob
+{
+    QByteArray pattern;
+    QByteArray mimeType;
+    quint32 flagsAndWeight;
+};
+
+struct SuffixNode
+{
+    QVector<Glob> leaves;
+    std::map<uint, SuffixNode> children;
+};
+
+struct MimeTypeEntry
+{
+    QByteArray name;
+    quint32 elementOffset;
+    quint32 elementLength;
+};
+
+class CacheGenerator
+{
+public:
+    CacheGenerator() : m_maxExtent(0) {}
+
+    bool parse(const QByteArray &package);
+    QByteArray write() const;
+    QString errorString() const { return m_errorString; }
+
+private:
+    bool parseMimeType(const QByteArray &element, quint32 offset);
+    bool parseMatch(QXmlStreamReader &reader, QVector<Matchlet> *matchlets);
+    void addGlob(const QByteArray &mimeType, const QString &pattern, int weight, bool caseSensitive);
+    quint32 string(const QByteArray &str);
+    bool error(const QString &message);
+
+    QByteArray m_pool;
+    QHash<QByteArray, quint32> m_strings;
+
+    QVector<MimeTypeEntry> m_mimeTypes;
+    QVector<QPair<QByteArray, QByteArray> > m_aliases;
+    std::map<QByteArray, QVector<QByteArray> > m_parents;
+    QVector<Glob> m_literals;
+    QVector<Glob> m_globs;
+    SuffixNode m_suffixTree;
+    QVector<Match> m_matches;
+    quint32 m_maxExtent;
+    QVector<QVector<QByteArray> > m_namespaces;
+    std::map<QByteArray, QByteArray> m_icons;
+    std::map<QByteArray, QByteArray> m_genericIcons;
+    QString m_errorString;
+};
+
+bool CacheGenerator::error(const QString &message)
+{
+    m_errorString = message;
+    return false;
+}
+
+// All strings (and magic values and masks) are stored right after the
+// header, so their final offset is known as soon as they are added.
+quint32 CacheGenerator::string(const QByteArray &str)
+{
+    QHash<QByteArray, quint32>::const_iterator it = m_strings.constFind(str);
+    if (it != m_strings.constEnd())
+        return it.value();
+    const quint32 offset = HeaderSize + m_pool.size();
+    m_pool += str;
+    m_pool += '\0';
+    m_strings.insert(str, offset);
+    return offset;
+}
+
+bool CacheGenerator::parse(const QByteArray &package)
+{
+    // Each <mime-type> element is parsed on its own, which gives us its
+    // exact byte range in the package for the runtime to parse again.
+    static const char startTag[] = "<mime-type ";
+    static const char endTag[] = "</mime-type>";
+    int pos = package.indexOf(startTag);
+    while (pos != -1) {
+        const int end = package.indexOf(endTag, pos);
+        if (end == -1)
+            return error(QStringLiteral("Unterminated <mime-type> element at offset %1").arg(pos));
+        const int length = end + int(sizeof(endTag)) - 1 - pos;
+        if (!parseMimeType(package.mid(pos, length), pos))
+            return false;
+        pos = package.indexOf(startTag, pos + length);
+    }
+    if (m_mimeTypes.isEmpty())
+        return error(QStringLiteral("No MIME types found"));
+    return true;
+}
+
+bool CacheGenerator::parseMimeType(const QByteArray &element, quint32 offset)
+{
+    QXmlStreamReader reader(element);
+    if (!reader.readNextStartElement() || reader.name() != QLatin1String("mime-type"))
+        return error(QStringLiteral("Expected <mime-type> at offset %1").arg(offset));
+    const QByteArray name = reader.attributes().value(QLatin1String("type")).toLatin1();
+    if (name.isEmpty())
+        return error(QStringLiteral("Missing 'type' attribute at offset %1").arg(offset));
+    const MimeTypeEntry entry = { name, offset, quint32(element.size()) };
+    m_mimeTypes.append(entry);
+    string(name);
+
+    while (reader.readNextStartElement()) {
+        const QStringRef tag = reader.name();
+        const QXmlStreamAttributes atts = reader.attributes();
+        if (tag == QLatin1String("glob")) {
+            addGlob(name, atts.value(QLatin1String("pattern")).toString(),
+                    atts.value(QLatin1String("weight")).toInt(),
+                    atts.value(QLatin1String("case-sensitive")) == QLatin1String("true"));
+        } else if (tag == QLatin1String("sub-class-of")) {
+            const QByteArray parent = atts.value(QLatin1String("type")).toLatin1();
+            m_parents[name].append(parent);
+            string(parent);
+        } else if (tag == QLatin1String("alias")) {
+            const QByteArray alias = atts.value(QLatin1String("type")).toLatin1();
+            m_aliases.append(qMakePair(alias, name));
+            string(alias);
+        } else if (tag == QLatin1String("icon")) {
+            m_icons[name] = atts.value(QLatin1String("name")).toLatin1();
+            string(m_icons[name]);
+        } else if (tag == QLatin1String("generic-icon")) {
+            m_genericIcons[name] = atts.value(QLatin1String("name")).toLatin1();
+            string(m_genericIcons[name]);
+        } else if (tag == QLatin1String("root-XML")) {
+            QVector<QByteArray> ns;
+            ns << atts.value(QLatin1String("namespaceURI")).toUtf8()
+               << atts.value(QLatin1String("localName")).toUtf8()
+               << name;
+            for (const QByteArray &str : qAsConst(ns))
+                string(str);
+            m_namespaces.append(ns);
+        } else if (tag == QLatin1String("magic")) {
+            Match match;
+            match.priority = 50;
+            if (atts.hasAttribute(QLatin1String("priority")))
+                match.priority = atts.value(QLatin1String("priority")).toUInt();
+            match.mimeType = name;
+            while (reader.readNextStartElement()) {
+                if (reader.name() != QLatin1String("match"))
+                    return error(QStringLiteral("Unexpected <%1> in <magic> of %2").arg(reader.name().toString(), QString::fromLatin1(name)));
+                if (!parseMatch(reader, &match.matchlets))
+                    return error(QStringLiteral("%1 in <magic> of %2").arg(m_errorString, QString::fromLatin1(name)));
+            }
+            m_matches.append(match);
+            continue; // at the end of <magic> already
+        }
+        reader.skipCurrentElement();
+    }
+    if (reader.hasError())
+        return error(QStringLiteral("%1 in %2").arg(reader.errorString(), QString::fromLatin1(name)));
+    return true;
+}
+
+// Same escapes as QMimeMagicRule
+static QByteArray makePattern(const QByteArray &value)
+{
+    QByteArray pattern;
+    const char *p = value.constData();
+    const char *e = p + value.size();
+    for ( ; p < e; ++p) {
+        if (*p == '\\' && ++p < e) {
+            if (*p == 'x') {
+                char c = 0;
+                for (int i = 0; i < 2 && p + 1 < e && isxdigit(uchar(p[1])); ++i) {
+                    ++p;
+                    c = (c << 4) + (isdigit(uchar(*p)) ? *p - '0' : (tolower(uchar(*p)) - 'a' + 10));
+                }
+                pattern += c;
+            } else if (*p >= '0' && *p <= '7') {
+                char c = *p - '0';
+                if (p + 1 < e && p[1] >= '0' && p[1] <= '7') {
+                    c = (c << 3) + *(++p) - '0';
+                    if (p + 1 < e && p[1] >= '0' && p[1] <= '7' && p[-1] <= '3')
+                        c = (c << 3) + *(++p) - '0';
+                }
+                pattern += c;
+            } else if (*p == 'n') {
+                pattern += '\n';
+            } else if (*p == 'r') {
+                pattern += '\r';
+            } else if (*p == 't') {
+                pattern += '\t';
+            } else {
+                pattern += *p;
+            }
+        } else {
+            pattern += *p;
+        }
+    }
+    return pattern;
+}
+
+// Numbers are stored in the byte order they have in the data, the "host"
+// types in big endian with their word size, as update-mime-database does.
+static QByteArray numberBytes(quint32 number, int size, bool littleEndian)
+{
+    QByteArray result(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i) {
+        const int shift = 8 * (littleEndian ? i : size - 1 - i);
+        result[i] = char((number >> shift) & 0xff);
+    }
+    return result;
+}
+
+bool CacheGenerator::parseMatch(QXmlStreamReader &reader, QVector<Matchlet> *matchlets)
+{
+    const QXmlStreamAttributes atts = reader.attributes();
+    const QString type = atts.value(QLatin1String("type")).toString();
+    const QByteArray value = atts.value(QLatin1String("value")).toUtf8();
+    const QByteArray mask = atts.value(QLatin1String("mask")).toLatin1();
+    const QString offsets = atts.value(QLatin1String("offset")).toString();
+
+    bool ok = true;
+    bool endOk = true;
+    const int colon = offsets.indexOf(QLatin1Char(':'));
+    const quint32 start = offsets.leftRef(colon).toUInt(&ok);
+    const quint32 end = colon == -1 ? start : offsets.midRef(colon + 1).toUInt(&endOk);
+    if (!ok || !endOk || end < start)
+        return error(QStringLiteral("Invalid offset \"%1\"").arg(offsets));
+
+    QByteArray valueBytes;
+    QByteArray maskBytes;
+    quint32 wordSize = 1;
+    if (type == QLatin1String("string")) {
+        valueBytes = makePattern(value);
+        if (!mask.isEmpty()) {
+            if (!mask.startsWith("0x"))
+                return error(QStringLiteral("Invalid mask \"%1\"").arg(QString::fromLatin1(mask)));
+            maskBytes = QByteArray::fromHex(mask.mid(2));
+            if (maskBytes.size() != valueBytes.size())
+                return error(QStringLiteral("Invalid mask size \"%1\"").arg(QString::fromLatin1(mask)));
+        }
+    } else {
+        int size;
+        bool littleEndian = false;
+        if (type == QLatin1String("byte")) {
+            size = 1;
+        } else if (type == QLatin1String("big16") || type == QLatin1String("little16") || type == QLatin1String("host16")) {
+            size = 2;
+        } else if (type == QLatin1String("big32") || type == QLatin1String("little32") || type == QLatin1String("host32")) {
+            size = 4;
+        } else {
+            return error(QStringLiteral("Unsupported type \"%1\"").arg(type));
+        }
+        if (type.startsWith(QLatin1String("little")))
+            littleEndian = true;
+        else if (type.startsWith(QLatin1String("host")))
+            wordSize = size;
+        const quint32 number = value.toUInt(&ok, 0);
+        if (!ok || (size < 4 && number >> (8 * size)))
+            return error(QStringLiteral("Invalid value \"%1\"").arg(QString::fromLatin1(value)));
+        valueBytes = numberBytes(number, size, littleEndian);
+        if (!mask.isEmpty()) {
+            const quint32 maskNumber = mask.toUInt(&ok, 0);
+            if (!ok)
+                return error(QStringLiteral("Invalid mask \"%1\"").arg(QString::fromLatin1(mask)));
+            maskBytes = numberBytes(maskNumber, size, littleEndian);
+        }
+    }
+    if (valueBytes.isEmpty())
+        return error(QStringLiteral("Empty value"));
+
+    Matchlet matchlet;
+    matchlet.rangeStart = start;
+    matchlet.rangeLength = end - start + 1;
+    matchlet.wordSize = wordSize;
+    matchlet.valueLength = valueBytes.size();
+    matchlet.valueOffset = string(valueBytes);
+    matchlet.maskOffset = maskBytes.isEmpty() ? 0 : string(maskBytes);
+    m_maxExtent = qMax(m_maxExtent, end + matchlet.valueLength);
+
+    while (reader.readNextStartElement()) {
+        if (reader.name() != QLatin1String("match"))
+            return error(QStringLiteral("Unexpected <%1>").arg(reader.name().toString()));
+        if (!parseMatch(reader, &matchlet.children))
+            return false;
+    }
+    matchlets->append(matchlet);
+    return true;
+}
+
+void CacheGenerator::addGlob(const QByteArray &mimeType, const QString &pattern, int weight, bool caseSensitive)
+{
+    if (pattern.isEmpty())
+        return;
+    Glob glob;
+    glob.pattern = (caseSensitive ? pattern : pattern.toLower()).toUtf8();
+    glob.mimeType = mimeType;
+    glob.flagsAndWeight = (weight > 0 ? weight : 50) | (caseSensitive ? 0x100 : 0);
+
+    const QString suffix = pattern.mid(1);
+    const auto isWildcard = [](QChar c) {
+        return c == QLatin1Char('*') || c == QLatin1Char('?') || c == QLatin1Char('[');
+    };
+    if (std::none_of(pattern.cbegin(), pattern.cend(), isWildcard)) {
+        string(glob.pattern);
+        m_literals.append(glob);
+    } else if (pattern.startsWith(QLatin1Char('*')) && !suffix.isEmpty()
+               && std::none_of(suffix.cbegin(), suffix.cend(), isWildcard)) {
+        // The reverse suffix tree is walked from the last character of
+        // the file name, with the leaves (character 0) sorted first.
+        const QVector<uint> ucs4 = (caseSensitive ? suffix : suffix.toLower()).toUcs4();
+        SuffixNode *node = &m_suffixTree;
+        for (int i = ucs4.size() - 1; i >= 0; --i)
+            node = &node->children[ucs4.at(i)];
+        node->leaves.append(glob);
+    } else {
+        string(glob.pattern);
+        m_globs.append(glob);
+    }
+}
+
+class CacheBuffer
+{
+public:
+    explicit CacheBuffer(const QByteArray &data) : m_data(data) {}
+
+    quint32 allocate(int size)
+    {
+        const quint32 offset = m_data.size();
+        m_data.append(size, '\0');
+        return offset;
+    }
+    void setUint32(quint32 offset, quint32 value)
+    {
+        qToBigEndian(value, reinterpret_cast<uchar *>(m_data.data() + offset));
+    }
+    quint32 appendUint32(quint32 value)
+    {
+        const quint32 offset = allocate(4);
+        setUint32(offset, value);
+        return offset;
+    }
+    QByteArray data() const { return m_data; }
+
+private:
+    QByteArray m_data;
+};
+
+class CacheWriter
+{
+public:
+    CacheWriter(const QByteArray &stringPool, const QHash<QByteArray, quint32> &strings)
+        : m_buffer(stringPool), m_strings(strings) {}
+
+    CacheBuffer &buffer() { return m_buffer; }
+    quint32 string(const QByteArray &str) const
+    {
+        Q_ASSERT(m_strings.contains(str));
+        return m_strings.value(str);
+    }
+    quint32 writeGlobList(const QVector<Glob> &globs);
+    quint32 writeSuffixEntries(const SuffixNode &node);
+    quint32 writeMatchlets(const QVector<Matchlet> &matchlets);
+    quint32 writeStringPairs(const std::map<QByteArray, QByteArray> &pairs);
+
+private:
+    CacheBuffer m_buffer;
+    const QHash<QByteArray, quint32> &m_strings;
+};
+
+quint32 CacheWriter::writeGlobList(const QVector<Glob> &globs)
+{
+    const quint32 offset = m_buffer.appendUint32(globs.size());
+    for (const Glob &glob : globs) {
+        m_buffer.appendUint32(string(glob.pattern));
+        m_buffer.appendUint32(string(glob.mimeType));
+        m_buffer.appendUint32(glob.flagsAndWeight);
+    }
+    return offset;
+}
+
+quint32 CacheWriter::writeSuffixEntries(const SuffixNode &node)
+{
+    const quint32 offset = m_buffer.allocate(12 * (node.leaves.size() + int(node.children.size())));
+    quint32 entry = offset;
+    for (const Glob &leaf : node.leaves) {
+        m_buffer.setUint32(entry, 0);
+        m_buffer.setUint32(entry + 4, string(leaf.mimeType));
+        m_buffer.setUint32(entry + 8, leaf.flagsAndWeight);
+        entry += 12;
+    }
+    for (const auto &child : node.children) {
+        m_buffer.setUint32(entry, child.first);
+        m_buffer.setUint32(entry + 4, child.second.leaves.size() + quint32(child.second.children.size()));
+        m_buffer.setUint32(entry + 8, writeSuffixEntries(child.second));
+        entry += 12;
+    }
+    return offset;
+}
+
+quint32 CacheWriter::writeMatchlets(const QVector<Matchlet> &matchlets)
+{
+    const quint32 offset = m_buffer.allocate(32 * matchlets.size());
+    for (int i = 0; i < matchlets.size(); ++i) {
+        const Matchlet &matchlet = matchlets.at(i);
+        const quint32 entry = offset + 32 * i;
+        m_buffer.setUint32(entry, matchlet.rangeStart);
+        m_buffer.setUint32(entry + 4, matchlet.rangeLength);
+        m_buffer.setUint32(entry + 8, matchlet.wordSize);
+        m_buffer.setUint32(entry + 12, matchlet.valueLength);
+        m_buffer.setUint32(entry + 16, matchlet.valueOffset);
+        m_buffer.setUint32(entry + 20, matchlet.maskOffset);
+        m_buffer.setUint32(entry + 24, matchlet.children.size());
+        m_buffer.setUint32(entry + 28, matchlet.children.isEmpty() ? 0 : writeMatchlets(matchlet.children));
+    }
+    return offset;
+}
+
+quint32 CacheWriter::writeStringPairs(const std::map<QByteArray, QByteArray> &pairs)
+{
+    const quint32 offset = m_buffer.appendUint32(quint32(pairs.size()));
+    for (const auto &pair : pairs) {
+        m_buffer.appendUint32(string(pair.first));
+        m_buffer.appendUint32(string(pair.second));
+    }
+    return offset;
+}
+
+QByteArray CacheGenerator::write() const
+{
+    QByteArray pool = m_pool;
+    pool.append((4 - pool.size() % 4) % 4, '\0');
+    CacheWriter writer(QByteArray(HeaderSize, '\0') + pool, m_strings);
+    CacheBuffer &buffer = writer.buffer();
+
+    buffer.setUint32(0, (1 << 16) | 2); // version 1.2
+
+    std::map<QByteArray, QByteArray> aliases;
+    for (const auto &alias : m_aliases)
+        aliases[alias.first] = alias.second;
+    buffer.setUint32(PosAliasListOffset, writer.writeStringPairs(aliases));
+
+    const quint32 parentListOffset = buffer.appendUint32(quint32(m_parents.size()));
+    buffer.allocate(8 * int(m_parents.size()));
+    quint32 entry = parentListOffset + 4;
+    for (const auto &parents : m_parents) {
+        buffer.setUint32(entry, writer.string(parents.first));
+        const quint32 parentsOffset = buffer.appendUint32(parents.second.size());
+        for (const QByteArray &parent : parents.second)
+            buffer.appendUint32(writer.string(parent));
+        buffer.setUint32(entry + 4, parentsOffset);
+        entry += 8;
+    }
+    buffer.setUint32(PosParentListOffset, parentListOffset);
+
+    buffer.setUint32(PosLiteralListOffset, writer.writeGlobList(m_literals));
+
+    const quint32 suffixTreeOffset = buffer.allocate(8);
+    buffer.setUint32(suffixTreeOffset, quint32(m_suffixTree.children.size()));
+    buffer.setUint32(suffixTreeOffset + 4, writer.writeSuffixEntries(m_suffixTree));
+    buffer.setUint32(PosReverseSuffixTreeOffset, suffixTreeOffset);
+
+    buffer.setUint32(PosGlobListOffset, writer.writeGlobList(m_globs));
+
+    // Highest priority first; the runtime returns the first match
+    QVector<Match> matches = m_matches;
+    std::stable_sort(matches.begin(), matches.end(), [](const Match &lhs, const Match &rhs) {
+        return lhs.priority > rhs.priority;
+    });
+    const quint32 magicListOffset = buffer.allocate(12);
+    const quint32 firstMatchOffset = buffer.allocate(16 * matches.size());
+    for (int i = 0; i < matches.size(); ++i) {
+        const Match &match = matches.at(i);
+        const quint32 entry = firstMatchOffset + 16 * i;
+        buffer.setUint32(entry, match.priority);
+        buffer.setUint32(entry + 4, writer.string(match.mimeType));
+        buffer.setUint32(entry + 8, match.matchlets.size());
+        buffer.setUint32(entry + 12, writer.writeMatchlets(match.matchlets));
+    }
+    buffer.setUint32(magicListOffset, matches.size());
+    buffer.setUint32(magicListOffset + 4, m_maxExtent);
+    buffer.setUint32(magicListOffset + 8, firstMatchOffset);
+    buffer.setUint32(PosMagicListOffset, magicListOffset);
+
+    QVector<QVector<QByteArray> > namespaces = m_namespaces;
+    std::sort(namespaces.begin(), namespaces.end());
+    const quint32 namespaceListOffset = buffer.appendUint32(namespaces.size());
+    for (const QVector<QByteArray> &ns : qAsConst(namespaces)) {
+        for (const QByteArray &str : ns)
+            buffer.appendUint32(writer.string(str));
+    }
+    buffer.setUint32(PosNamespaceListOffset, namespaceListOffset);
+
+    buffer.setUint32(PosIconsListOffset, writer.writeStringPairs(m_icons));
+    buffer.setUint32(PosGenericIconsListOffset, writer.writeStringPairs(m_genericIcons));
+
+    QVector<MimeTypeEntry> mimeTypes = m_mimeTypes;
+    std::sort(mimeTypes.begin(), mimeTypes.end(), [](const MimeTypeEntry &lhs, const MimeTypeEntry &rhs) {
+        return lhs.name < rhs.name;
+    });
+    const quint32 mimeTypeListOffset = buffer.appendUint32(mimeTypes.size());
+    for (const MimeTypeEntry &mimeType : qAsConst(mimeTypes)) {
+        buffer.appendUint32(writer.string(mimeType.name));
+        buffer.appendUint32(mimeType.elementOffset);
+        buffer.appendUint32(mimeType.elementLength);
+    }
+    buffer.setUint32(PosMimeTypeListOffset, mimeTypeListOffset);
+
+    return buffer.data();
+}
+
+// The checksum zlib stores in its streams, so that QtCore can compare it to
+// the embedded package file without uncompressing it.
+static quint32 adler32(const QByteArray &data)
+{
+    const quint32 base = 65521;
+    quint32 a = 1;
+    quint32 b = 0;
+    for (int i = 0; i < data.size(); ++i) {
+        a = (a + uchar(data.at(i))) % base;
+        b = (b + a) % base;
+    }
+    return (b << 16) | a;
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    if (argc < 3) {
+        printf("\nusage: %s packageFile outputFile\n\n", argv[0]);
+        printf("Generates the MIME type cache embedded in QtCore from a shared-mime-info\n");
+        printf("package file. To update it, run\n\n");
+        printf("       %s src/corelib/mimetypes/mime/packages/freedesktop.org.xml \\\n", argv[0]);
+        printf("           src/corelib/mimetypes/mime/mime.cache\n\n");
+        printf("in your Qt repo after updating freedesktop.org.xml.\n\n");
+        return 1;
+    }
+
+    QFile package(QFile::decodeName(argv[1]));
+    if (!package.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "Cannot open %s: %s\n", argv[1], qPrintable(package.errorString()));
+        return 1;
+    }
+    const QByteArray packageData = package.readAll();
+
+    CacheGenerator generator;
+    if (!generator.parse(packageData)) {
+        fprintf(stderr, "Error parsing %s: %s\n", argv[1], qPrintable(generator.errorString()));
+        return 1;
+    }
+    QByteArray cache = generator.write();
+    qToBigEndian(adler32(packageData), reinterpret_cast<uchar *>(cache.data() + PosSourceChecksumOffset));
+
+    QFile output(QFile::decodeName(argv[2]));
+    if (!output.open(QIODevice::WriteOnly) || output.write(cache) != cache.size()) {
+        fprintf(stderr, "Cannot write %s: %s\n", argv[2], qPrintable(output.errorString()));
+        return 1;
+    }
+    return 0;
+}
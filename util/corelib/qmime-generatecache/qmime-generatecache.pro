@@ -0,0 +1,3 @@
+QT = core
+
+SOURCES += main.cpp